@@ -0,0 +1,84 @@
+/**
+ * @file bench.h
+ * @brief Benchmark harness for the storage stack
+ *
+ * - 微基准: CRC16吞吐, Job队列入队/出队, Seqlock读写扩展性, Eep读/编程/擦除
+ * - 宏基准: 16/64/255个Block配置下的端到端 ReadAll/WriteAll
+ * - 结果以JSON输出 (make bench -> build/bench/results.json), 便于版本间回归比较
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+/**
+ * @brief Named extra values per result (retries, bytes, ...)
+ */
+#define BENCH_MAX_EXTRA 4U
+
+/**
+ * @brief One measurement
+ */
+typedef struct {
+    const char *suite;              /**< Suite name ("crc16", "job_queue", ...) */
+    char name[48];                  /**< Case within the suite ("table/4096") */
+    uint32_t threads;               /**< Threads doing the measured work */
+    uint64_t ops;                   /**< Operations measured */
+    uint64_t elapsed_ns;            /**< Wall time for all ops */
+    uint64_t bytes;                 /**< Bytes processed (0 if not a throughput case) */
+    uint32_t extra_count;
+    const char *extra_key[BENCH_MAX_EXTRA];
+    double extra_value[BENCH_MAX_EXTRA];
+} Bench_Result_t;
+
+/**
+ * @brief Host monotonic time in nanoseconds
+ */
+uint64_t Bench_NowNs(void);
+
+/**
+ * @brief Scale an iteration count (divided by 10 in quick mode, never 0)
+ */
+uint64_t Bench_Iterations(uint64_t full);
+
+/**
+ * @brief Measurement window for time-boxed cases, in milliseconds
+ */
+uint32_t Bench_WindowMs(void);
+
+/**
+ * @brief Start a result record
+ *
+ * @param result Record to initialize
+ * @param suite Suite name (string literal)
+ * @param name printf-style case name
+ */
+void Bench_Begin(Bench_Result_t *result, const char *suite, const char *name, ...)
+    __attribute__((format(printf, 3, 4)));
+
+/**
+ * @brief Attach a named value to a result (ignored past BENCH_MAX_EXTRA)
+ */
+void Bench_Extra(Bench_Result_t *result, const char *key, double value);
+
+/**
+ * @brief Append a finished result to the report
+ */
+void Bench_Report(const Bench_Result_t *result);
+
+/**
+ * @brief Keep a computed value alive so the compiler cannot drop the work
+ */
+void Bench_Consume(uint64_t value);
+
+/**
+ * @brief Suites (bench_<suite>.c)
+ */
+void Bench_Crc16(void);
+void Bench_JobQueue(void);
+void Bench_Seqlock(void);
+void Bench_Eep(void);
+void Bench_NvmMulti(void);
+
+#endif /* BENCH_H */
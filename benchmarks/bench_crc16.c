@@ -0,0 +1,60 @@
+/**
+ * @file bench_crc16.c
+ * @brief Crc16_Calculate throughput per engine and buffer size
+ */
+
+#include "bench.h"
+#include "crc16.h"
+#include <string.h>
+
+#define CRC_BENCH_MAX_SIZE   65536U
+#define CRC_BENCH_BYTES      (64U * 1024U * 1024U)   /**< Bytes hashed per case */
+
+static const uint32_t g_sizes[] = { 8U, 64U, 256U, 1024U, 4096U, CRC_BENCH_MAX_SIZE };
+
+static const struct {
+    Crc16_EngineType engine;
+    const char *name;
+} g_engines[] = {
+    { CRC16_ENGINE_TABLE,  "table" },
+    { CRC16_ENGINE_SLICE8, "slice8" },
+    { CRC16_ENGINE_CLMUL,  "clmul" },
+};
+
+static uint8_t g_buffer[CRC_BENCH_MAX_SIZE];
+
+void Bench_Crc16(void)
+{
+    Crc16_EngineType saved = Crc16_GetEngine();
+
+    for (uint32_t i = 0; i < CRC_BENCH_MAX_SIZE; i++) {
+        g_buffer[i] = (uint8_t)(i * 31U + 7U);
+    }
+
+    for (uint32_t e = 0; e < sizeof(g_engines) / sizeof(g_engines[0]); e++) {
+        if (Crc16_SetEngine(g_engines[e].engine) != E_OK) {
+            continue;   /* Not supported on this host */
+        }
+        for (uint32_t s = 0; s < sizeof(g_sizes) / sizeof(g_sizes[0]); s++) {
+            uint32_t size = g_sizes[s];
+            uint64_t ops = Bench_Iterations(CRC_BENCH_BYTES / size);
+            uint64_t acc = 0;
+            Bench_Result_t r;
+
+            Bench_Begin(&r, "crc16", "%s/%u", g_engines[e].name, size);
+            uint64_t t0 = Bench_NowNs();
+            for (uint64_t i = 0; i < ops; i++) {
+                /* Feed the previous CRC back so calls cannot be hoisted */
+                g_buffer[0] = (uint8_t)acc;
+                acc += Crc16_Calculate(g_buffer, size);
+            }
+            r.elapsed_ns = Bench_NowNs() - t0;
+            r.ops = ops;
+            r.bytes = ops * size;
+            Bench_Consume(acc);
+            Bench_Report(&r);
+        }
+    }
+
+    Crc16_SetEngine(saved);
+}
@@ -0,0 +1,97 @@
+/**
+ * @file bench_eep.c
+ * @brief Eep_Read / Eep_Write / Eep_Erase cost (flat backend, timing off)
+ *
+ * - read/<bytes>: 按地址轮转读取
+ * - program/256: 整个器件逐页编程 (页已擦除)
+ * - erase/1024: 编程后逐块擦除 (已擦除块的跳过路径不计入)
+ */
+
+#include "bench.h"
+#include "eeprom_driver.h"
+#include <string.h>
+
+#define EEP_BENCH_CAPACITY   (64U * 1024U)
+#define EEP_BENCH_PAGE       256U
+#define EEP_BENCH_BLOCK      1024U
+#define EEP_BENCH_READ_OPS   2000000U
+#define EEP_BENCH_ROUNDS     200U
+
+static const uint32_t g_read_sizes[] = { 16U, 256U, 1024U };
+
+void Bench_Eep(void)
+{
+    static uint8_t buffer[EEP_BENCH_BLOCK];
+    Eeprom_ConfigType cfg = {
+        .capacity_bytes = EEP_BENCH_CAPACITY,
+        .page_size = EEP_BENCH_PAGE,
+        .block_size = EEP_BENCH_BLOCK,
+        .read_delay_us = 50,
+        .write_delay_ms = 2,
+        .erase_delay_ms = 3,
+        .endurance_cycles = 0xFFFFFFFFU,
+        .virtual_storage = NULL,
+        .backend = NULL
+    };
+    Bench_Result_t r;
+    uint64_t acc = 0;
+
+    if (Eep_Init(&cfg) != E_OK) {
+        return;
+    }
+    Eep_SetTimingMode(EEP_TIMING_OFF);
+    memset(buffer, 0x5A, sizeof(buffer));
+
+    for (uint32_t s = 0; s < sizeof(g_read_sizes) / sizeof(g_read_sizes[0]); s++) {
+        uint32_t size = g_read_sizes[s];
+        uint64_t ops = Bench_Iterations(EEP_BENCH_READ_OPS);
+        uint32_t address = 0;
+
+        Bench_Begin(&r, "eep", "read/%u", size);
+        uint64_t t0 = Bench_NowNs();
+        for (uint64_t i = 0; i < ops; i++) {
+            Eep_Read(address, buffer, size);
+            acc += buffer[0];
+            address = (address + size) % EEP_BENCH_CAPACITY;
+        }
+        r.elapsed_ns = Bench_NowNs() - t0;
+        r.ops = ops;
+        r.bytes = ops * size;
+        Bench_Report(&r);
+    }
+
+    /* Program every page, then erase every block, and repeat */
+    uint64_t rounds = Bench_Iterations(EEP_BENCH_ROUNDS);
+    uint64_t program_ns = 0;
+    uint64_t erase_ns = 0;
+    uint64_t failures = 0;
+
+    for (uint64_t n = 0; n < rounds; n++) {
+        uint64_t t0 = Bench_NowNs();
+        for (uint32_t a = 0; a < EEP_BENCH_CAPACITY; a += EEP_BENCH_PAGE) {
+            failures += (Eep_Write(a, buffer, EEP_BENCH_PAGE) != E_OK);
+        }
+        uint64_t t1 = Bench_NowNs();
+        for (uint32_t a = 0; a < EEP_BENCH_CAPACITY; a += EEP_BENCH_BLOCK) {
+            failures += (Eep_Erase(a) != E_OK);
+        }
+        program_ns += t1 - t0;
+        erase_ns += Bench_NowNs() - t1;
+    }
+
+    Bench_Begin(&r, "eep", "program/%u", EEP_BENCH_PAGE);
+    r.elapsed_ns = program_ns;
+    r.ops = rounds * (EEP_BENCH_CAPACITY / EEP_BENCH_PAGE);
+    r.bytes = rounds * EEP_BENCH_CAPACITY;
+    Bench_Extra(&r, "failures", (double)failures);
+    Bench_Report(&r);
+
+    Bench_Begin(&r, "eep", "erase/%u", EEP_BENCH_BLOCK);
+    r.elapsed_ns = erase_ns;
+    r.ops = rounds * (EEP_BENCH_CAPACITY / EEP_BENCH_BLOCK);
+    r.bytes = rounds * EEP_BENCH_CAPACITY;
+    Bench_Report(&r);
+
+    Bench_Consume(acc);
+    Eep_Destroy();
+}
@@ -0,0 +1,98 @@
+/**
+ * @file bench_job_queue.c
+ * @brief NvM job queue enqueue/dequeue cost at varying queue depths
+ *
+ * - steady/<depth>: 队列保持在depth个作业, 每次操作 = 出队1个 + 入队1个
+ * - fill_drain/<depth>: 从空入队到depth再全部出队, 每次操作 = 1次入队或出队
+ * 优先级伪随机分布在0..255, 覆盖位图查找的不同层级
+ */
+
+#include "bench.h"
+#include "nvm_jobqueue.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define JQ_BENCH_OPS 4000000U   /**< Queue operations per case */
+
+static const uint16_t g_depths[] = { 1U, 8U, 32U, 256U, 4096U };
+
+static uint32_t g_rng = 0x9E3779B9U;
+
+static uint32_t next_random(void)
+{
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+}
+
+static void make_job(NvM_Job_t *job)
+{
+    uint32_t r = next_random();
+
+    job->job_type = (r & 1U) ? NVM_JOB_WRITE : NVM_JOB_READ;
+    job->block_id = (uint8_t)((r >> 1) % 255U);
+    job->priority = (uint8_t)(r >> 9);
+}
+
+void Bench_JobQueue(void)
+{
+    static NvM_JobQueueType queue;
+    NvM_JobQueueNode_t *pool = malloc(sizeof(NvM_JobQueueNode_t) * 4096U);
+    NvM_Job_t job;
+
+    if (pool == NULL) {
+        return;
+    }
+    memset(&job, 0, sizeof(job));
+
+    for (uint32_t d = 0; d < sizeof(g_depths) / sizeof(g_depths[0]); d++) {
+        uint16_t depth = g_depths[d];
+        uint64_t ops = Bench_Iterations(JQ_BENCH_OPS);
+        uint64_t acc = 0;
+        Bench_Result_t r;
+
+        /* Steady state: one dequeue plus one enqueue per op */
+        NvM_JobQueue_InstanceInit(&queue, pool, depth);
+        for (uint16_t i = 0; i < depth; i++) {
+            make_job(&job);
+            NvM_JobQueue_InstanceEnqueue(&queue, &job);
+        }
+
+        Bench_Begin(&r, "job_queue", "steady/%u", depth);
+        uint64_t t0 = Bench_NowNs();
+        for (uint64_t i = 0; i < ops; i++) {
+            NvM_JobQueue_InstanceDequeue(&queue, &job);
+            acc += job.block_id;
+            make_job(&job);
+            NvM_JobQueue_InstanceEnqueue(&queue, &job);
+        }
+        r.elapsed_ns = Bench_NowNs() - t0;
+        r.ops = ops;
+        Bench_Report(&r);
+
+        /* Fill to depth, drain to empty */
+        uint64_t rounds = (ops + (2U * depth) - 1U) / (2U * depth);
+        NvM_JobQueue_InstanceReset(&queue);
+
+        Bench_Begin(&r, "job_queue", "fill_drain/%u", depth);
+        t0 = Bench_NowNs();
+        for (uint64_t n = 0; n < rounds; n++) {
+            for (uint16_t i = 0; i < depth; i++) {
+                make_job(&job);
+                NvM_JobQueue_InstanceEnqueue(&queue, &job);
+            }
+            for (uint16_t i = 0; i < depth; i++) {
+                NvM_JobQueue_InstanceDequeue(&queue, &job);
+                acc += job.block_id;
+            }
+        }
+        r.elapsed_ns = Bench_NowNs() - t0;
+        r.ops = rounds * 2U * depth;
+        Bench_Report(&r);
+
+        Bench_Consume(acc);
+    }
+
+    free(pool);
+}
@@ -0,0 +1,233 @@
+/**
+ * @file bench_main.c
+ * @brief Benchmark driver: runs the suites and writes the JSON report
+ *
+ * 用法: eepsim_bench [-o file] [-s suite]... [-q] [-l]
+ * - -o: JSON输出文件 (默认stdout); 进度信息写到stderr
+ * - -s: 只运行指定套件 (可重复)
+ * - -q: 快速模式, 迭代次数与时间窗口缩小到1/10 (冒烟检查, 结果不用于比较)
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "bench.h"
+#include "logging.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_MAX_RESULTS 256U
+#define BENCH_MAX_SELECTED 8U
+
+typedef struct {
+    const char *name;
+    void (*run)(void);
+} Bench_Suite_t;
+
+static const Bench_Suite_t g_suites[] = {
+    { "crc16",     Bench_Crc16 },
+    { "job_queue", Bench_JobQueue },
+    { "seqlock",   Bench_Seqlock },
+    { "eep",       Bench_Eep },
+    { "nvm_multi", Bench_NvmMulti },
+};
+
+#define BENCH_SUITE_COUNT (sizeof(g_suites) / sizeof(g_suites[0]))
+
+static Bench_Result_t g_results[BENCH_MAX_RESULTS];
+static uint32_t g_result_count = 0;
+static int g_quick = 0;
+static volatile uint64_t g_sink;
+
+uint64_t Bench_NowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t Bench_Iterations(uint64_t full)
+{
+    uint64_t n = g_quick ? full / 10U : full;
+    return (n == 0U) ? 1U : n;
+}
+
+uint32_t Bench_WindowMs(void)
+{
+    return g_quick ? 20U : 200U;
+}
+
+void Bench_Begin(Bench_Result_t *result, const char *suite, const char *name, ...)
+{
+    va_list args;
+
+    memset(result, 0, sizeof(*result));
+    result->suite = suite;
+    result->threads = 1U;
+
+    va_start(args, name);
+    vsnprintf(result->name, sizeof(result->name), name, args);
+    va_end(args);
+}
+
+void Bench_Extra(Bench_Result_t *result, const char *key, double value)
+{
+    if (result->extra_count < BENCH_MAX_EXTRA) {
+        result->extra_key[result->extra_count] = key;
+        result->extra_value[result->extra_count] = value;
+        result->extra_count++;
+    }
+}
+
+void Bench_Report(const Bench_Result_t *result)
+{
+    double ns_per_op = (result->ops > 0U) ? (double)result->elapsed_ns / (double)result->ops : 0.0;
+
+    if (g_result_count < BENCH_MAX_RESULTS) {
+        g_results[g_result_count++] = *result;
+    }
+    fprintf(stderr, "  %-10s %-28s %2u thr %12.1f ns/op\n",
+            result->suite, result->name, result->threads, ns_per_op);
+}
+
+void Bench_Consume(uint64_t value)
+{
+    g_sink += value;
+}
+
+static void write_report(FILE *out, double total_s)
+{
+    char stamp[32];
+    time_t now = time(NULL);
+    struct tm tm_utc;
+
+    gmtime_r(&now, &tm_utc);
+    strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", &tm_utc);
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"schema\": 1,\n");
+    fprintf(out, "  \"timestamp\": \"%s\",\n", stamp);
+    fprintf(out, "  \"host\": {\"cpus\": %ld, \"compiler\": \"%s\"},\n",
+            sysconf(_SC_NPROCESSORS_ONLN), __VERSION__);
+    fprintf(out, "  \"build\": {\"fault_inj\": %s, \"metrics\": %s, \"log_min_level\": %d},\n",
+#ifdef FAULT_INJ_DISABLED
+            "false",
+#else
+            "true",
+#endif
+#ifdef METRICS_DISABLED
+            "false",
+#else
+            "true",
+#endif
+            LOG_MIN_LEVEL);
+    fprintf(out, "  \"quick\": %s,\n", g_quick ? "true" : "false");
+    fprintf(out, "  \"duration_s\": %.3f,\n", total_s);
+    fprintf(out, "  \"results\": [");
+
+    for (uint32_t i = 0; i < g_result_count; i++) {
+        const Bench_Result_t *r = &g_results[i];
+        double seconds = (double)r->elapsed_ns / 1e9;
+        double ns_per_op = (r->ops > 0U) ? (double)r->elapsed_ns / (double)r->ops : 0.0;
+        double ops_per_s = (seconds > 0.0) ? (double)r->ops / seconds : 0.0;
+
+        fprintf(out, "%s\n    {\"suite\": \"%s\", \"name\": \"%s\", \"threads\": %u, "
+                "\"ops\": %llu, \"elapsed_ns\": %llu, \"ns_per_op\": %.2f, \"ops_per_s\": %.1f",
+                (i == 0U) ? "" : ",", r->suite, r->name, r->threads,
+                (unsigned long long)r->ops, (unsigned long long)r->elapsed_ns,
+                ns_per_op, ops_per_s);
+        if (r->bytes > 0U) {
+            fprintf(out, ", \"bytes\": %llu, \"mb_per_s\": %.2f", (unsigned long long)r->bytes,
+                    (seconds > 0.0) ? (double)r->bytes / seconds / 1e6 : 0.0);
+        }
+        for (uint32_t e = 0; e < r->extra_count; e++) {
+            fprintf(out, ", \"%s\": %.6g", r->extra_key[e], r->extra_value[e]);
+        }
+        fprintf(out, "}");
+    }
+    fprintf(out, "\n  ]\n}\n");
+}
+
+static int suite_selected(const char *name, const char *const *selected, uint32_t count)
+{
+    if (count == 0U) {
+        return 1;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (strcmp(selected[i], name) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [-o file] [-s suite]... [-q] [-l]\n", prog);
+    fprintf(stderr, "  -o file   Write the JSON report to file (default: stdout)\n");
+    fprintf(stderr, "  -s suite  Run only this suite (repeatable)\n");
+    fprintf(stderr, "  -q        Quick mode (1/10 iterations; smoke check only)\n");
+    fprintf(stderr, "  -l        List suites\n");
+}
+
+int main(int argc, char **argv)
+{
+    const char *output = NULL;
+    const char *selected[BENCH_MAX_SELECTED];
+    uint32_t selected_count = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "o:s:qlh")) != -1) {
+        switch (opt) {
+            case 'o':
+                output = optarg;
+                break;
+            case 's':
+                if (selected_count < BENCH_MAX_SELECTED) {
+                    selected[selected_count++] = optarg;
+                }
+                break;
+            case 'q':
+                g_quick = 1;
+                break;
+            case 'l':
+                for (uint32_t i = 0; i < BENCH_SUITE_COUNT; i++) {
+                    printf("%s\n", g_suites[i].name);
+                }
+                return 0;
+            default:
+                usage(argv[0]);
+                return (opt == 'h') ? 0 : 2;
+        }
+    }
+
+    /* Module logging would dominate the measured paths */
+    Log_SetLevel(LOG_LEVEL_FATAL);
+
+    uint64_t start_ns = Bench_NowNs();
+    for (uint32_t i = 0; i < BENCH_SUITE_COUNT; i++) {
+        if (suite_selected(g_suites[i].name, selected, selected_count)) {
+            fprintf(stderr, "[%s]\n", g_suites[i].name);
+            g_suites[i].run();
+        }
+    }
+    double total_s = (double)(Bench_NowNs() - start_ns) / 1e9;
+
+    FILE *out = stdout;
+    if (output != NULL) {
+        out = fopen(output, "w");
+        if (out == NULL) {
+            perror(output);
+            return 1;
+        }
+    }
+    write_report(out, total_s);
+    if (out != stdout) {
+        fclose(out);
+        fprintf(stderr, "Wrote %u results to %s\n", g_result_count, output);
+    }
+    return 0;
+}
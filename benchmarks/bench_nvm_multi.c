@@ -0,0 +1,135 @@
+/**
+ * @file bench_nvm_multi.c
+ * @brief End-to-end NvM_WriteAll / NvM_ReadAll for 16, 64 and 255 blocks
+ *
+ * - 每个Block 256字节, CRC16, Native, 各占一个1KB槽位
+ * - 每轮修改全部RAM镜像后 WriteAll (所有Block均为脏), 再 ReadAll
+ * - ops = 处理的Block数; 额外报告每轮虚拟时间 (EEP_TIMING_VIRTUAL)
+ * 255 = NVM_MAX_BLOCKS (Block ID 255 保留给 ReadAll/WriteAll)
+ */
+
+#include "bench.h"
+#include "nvm.h"
+#include "eeprom_driver.h"
+#include "os_scheduler.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define NVM_BENCH_BLOCK_SIZE  256U
+#define NVM_BENCH_SLOT_SIZE   1024U
+#define NVM_BENCH_ROUNDS      20U
+#define NVM_BENCH_MAX_CALLS   100000U   /**< MainFunction calls before a pass is abandoned */
+
+static const uint32_t g_block_counts[] = { 16U, 64U, 255U };
+
+/**
+ * @brief Run NvM_MainFunction until the multi-block job has been processed
+ *
+ * @return FALSE if it did not finish
+ */
+static boolean run_pass(void)
+{
+    NvM_Diagnostics_t diag;
+    uint32_t done_before;
+
+    NvM_GetDiagnostics(&diag);
+    done_before = diag.total_jobs_processed;
+
+    for (uint32_t i = 0; i < NVM_BENCH_MAX_CALLS; i++) {
+        NvM_MainFunction();
+        NvM_GetDiagnostics(&diag);
+        if (diag.total_jobs_processed != done_before) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static void bench_config(uint32_t blocks)
+{
+    uint8_t *mirrors = malloc((size_t)blocks * NVM_BENCH_BLOCK_SIZE);
+    Eeprom_ConfigType cfg = {
+        .capacity_bytes = blocks * NVM_BENCH_SLOT_SIZE,
+        .page_size = 256,
+        .block_size = NVM_BENCH_SLOT_SIZE,
+        .read_delay_us = 50,
+        .write_delay_ms = 2,
+        .erase_delay_ms = 3,
+        .endurance_cycles = 0xFFFFFFFFU,
+        .virtual_storage = NULL,
+        .backend = NULL
+    };
+
+    if (mirrors == NULL) {
+        return;
+    }
+
+    NvM_Init();
+    OsScheduler_Init(16);
+    Eep_Init(&cfg);
+    Eep_SetTimingMode(EEP_TIMING_VIRTUAL);
+
+    for (uint32_t b = 0; b < blocks; b++) {
+        NvM_BlockConfig_t block = {
+            .block_id = (uint8_t)b,
+            .block_size = NVM_BENCH_BLOCK_SIZE,
+            .block_type = NVM_BLOCK_NATIVE,
+            .crc_type = NVM_CRC16,
+            .priority = 10,
+            .ram_mirror_ptr = &mirrors[b * NVM_BENCH_BLOCK_SIZE],
+            .eeprom_offset = b * NVM_BENCH_SLOT_SIZE
+        };
+        NvM_RegisterBlock(&block);
+    }
+
+    uint64_t rounds = Bench_Iterations(NVM_BENCH_ROUNDS);
+    uint64_t write_ns = 0;
+    uint64_t read_ns = 0;
+    uint64_t write_virtual_ms = 0;
+    uint64_t read_virtual_ms = 0;
+    uint64_t failures = 0;
+
+    for (uint64_t n = 0; n < rounds; n++) {
+        memset(mirrors, (int)(n + 1U), (size_t)blocks * NVM_BENCH_BLOCK_SIZE);
+
+        uint32_t v0 = OsScheduler_GetVirtualTimeMs();
+        uint64_t t0 = Bench_NowNs();
+        failures += (NvM_WriteAll() != E_OK || !run_pass());
+        uint64_t t1 = Bench_NowNs();
+        uint32_t v1 = OsScheduler_GetVirtualTimeMs();
+        failures += (NvM_ReadAll() != E_OK || !run_pass());
+        uint64_t t2 = Bench_NowNs();
+
+        write_ns += t1 - t0;
+        read_ns += t2 - t1;
+        write_virtual_ms += v1 - v0;
+        read_virtual_ms += OsScheduler_GetVirtualTimeMs() - v1;
+    }
+
+    Bench_Result_t r;
+    Bench_Begin(&r, "nvm_multi", "write_all/%u", blocks);
+    r.elapsed_ns = write_ns;
+    r.ops = rounds * blocks;
+    r.bytes = r.ops * NVM_BENCH_BLOCK_SIZE;
+    Bench_Extra(&r, "virtual_ms_per_pass", (double)write_virtual_ms / (double)rounds);
+    Bench_Extra(&r, "failures", (double)failures);
+    Bench_Report(&r);
+
+    Bench_Begin(&r, "nvm_multi", "read_all/%u", blocks);
+    r.elapsed_ns = read_ns;
+    r.ops = rounds * blocks;
+    r.bytes = r.ops * NVM_BENCH_BLOCK_SIZE;
+    Bench_Extra(&r, "virtual_ms_per_pass", (double)read_virtual_ms / (double)rounds);
+    Bench_Report(&r);
+
+    Eep_SetTimingMode(EEP_TIMING_OFF);
+    Eep_Destroy();
+    free(mirrors);
+}
+
+void Bench_NvmMulti(void)
+{
+    for (uint32_t i = 0; i < sizeof(g_block_counts) / sizeof(g_block_counts[0]); i++) {
+        bench_config(g_block_counts[i]);
+    }
+}
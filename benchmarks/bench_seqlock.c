@@ -0,0 +1,136 @@
+/**
+ * @file bench_seqlock.c
+ * @brief Seqlock RAM mirror read/write scaling with thread count
+ *
+ * - read/<n>: n个读线程, 无写者
+ * - read_write/<n>: n个读线程 + 1个写线程持续写入; 报告读重试次数
+ * 每个用例运行 Bench_WindowMs 毫秒; ops为所有读线程的读次数之和
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "bench.h"
+#include "nvm.h"
+#include "ram_mirror_seqlock.h"
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <unistd.h>
+
+#define SEQ_BENCH_BLOCK_ID   1U
+#define SEQ_BENCH_BLOCK_SIZE 256U
+#define SEQ_BENCH_MAX_READERS 8U
+
+static const uint32_t g_reader_counts[] = { 1U, 2U, 4U, 8U };
+
+static uint32_t g_run;          /**< 0 = waiting, 1 = measuring, 2 = stop */
+
+typedef struct {
+    uint64_t ops;
+    uint64_t failed;
+} __attribute__((aligned(64))) SeqBench_Worker_t;
+
+static SeqBench_Worker_t g_workers[SEQ_BENCH_MAX_READERS + 1U];
+
+static void wait_for_start(void)
+{
+    while (__atomic_load_n(&g_run, __ATOMIC_ACQUIRE) == 0U) {
+        sched_yield();
+    }
+}
+
+static void *reader(void *arg)
+{
+    SeqBench_Worker_t *w = (SeqBench_Worker_t *)arg;
+    uint8_t buffer[SEQ_BENCH_BLOCK_SIZE];
+    uint64_t ops = 0;
+    uint64_t failed = 0;
+
+    wait_for_start();
+    while (__atomic_load_n(&g_run, __ATOMIC_RELAXED) == 1U) {
+        if (RamMirror_SeqlockRead(SEQ_BENCH_BLOCK_ID, buffer, SEQ_BENCH_BLOCK_SIZE)) {
+            ops++;
+        } else {
+            failed++;
+        }
+    }
+    w->ops = ops;
+    w->failed = failed;
+    return NULL;
+}
+
+static void *writer(void *arg)
+{
+    SeqBench_Worker_t *w = (SeqBench_Worker_t *)arg;
+    uint8_t pattern[SEQ_BENCH_BLOCK_SIZE];
+    uint64_t ops = 0;
+
+    wait_for_start();
+    while (__atomic_load_n(&g_run, __ATOMIC_RELAXED) == 1U) {
+        memset(pattern, (int)(ops & 0xFFU), sizeof(pattern));
+        if (RamMirror_SeqlockWrite(SEQ_BENCH_BLOCK_ID, pattern, SEQ_BENCH_BLOCK_SIZE) == E_OK) {
+            ops++;
+        }
+    }
+    w->ops = ops;
+    return NULL;
+}
+
+static void run_case(uint32_t readers, boolean with_writer)
+{
+    pthread_t threads[SEQ_BENCH_MAX_READERS + 1U];
+    uint32_t count = 0;
+    SeqlockStats_t stats;
+    Bench_Result_t r;
+
+    RamMirror_SeqlockInit(RamMirror_GetSeqlockMirror(SEQ_BENCH_BLOCK_ID), SEQ_BENCH_BLOCK_ID);
+    memset(g_workers, 0, sizeof(g_workers));
+    __atomic_store_n(&g_run, 0U, __ATOMIC_RELEASE);
+
+    for (uint32_t i = 0; i < readers; i++) {
+        pthread_create(&threads[count++], NULL, reader, &g_workers[i]);
+    }
+    if (with_writer) {
+        pthread_create(&threads[count++], NULL, writer, &g_workers[SEQ_BENCH_MAX_READERS]);
+    }
+
+    uint64_t t0 = Bench_NowNs();
+    __atomic_store_n(&g_run, 1U, __ATOMIC_RELEASE);
+    usleep(Bench_WindowMs() * 1000U);
+    __atomic_store_n(&g_run, 2U, __ATOMIC_RELEASE);
+    uint64_t elapsed = Bench_NowNs() - t0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    Bench_Begin(&r, "seqlock", with_writer ? "read_write/%u" : "read/%u", readers);
+    r.threads = readers;
+    r.elapsed_ns = elapsed;
+    uint64_t failed = 0;
+    for (uint32_t i = 0; i < readers; i++) {
+        r.ops += g_workers[i].ops;
+        failed += g_workers[i].failed;
+    }
+    /* Per-thread latency: wall time over each reader's share */
+    Bench_Extra(&r, "ns_per_read_per_thread",
+                (r.ops > 0U) ? (double)elapsed * readers / (double)r.ops : 0.0);
+    if (with_writer) {
+        Bench_Extra(&r, "writes", (double)g_workers[SEQ_BENCH_MAX_READERS].ops);
+        if (RamMirror_GetSeqlockStats(SEQ_BENCH_BLOCK_ID, &stats) == E_OK) {
+            Bench_Extra(&r, "read_retries", (double)stats.read_retries);
+        }
+        Bench_Extra(&r, "read_failures", (double)failed);
+    }
+    Bench_Report(&r);
+}
+
+void Bench_Seqlock(void)
+{
+    for (uint32_t i = 0; i < sizeof(g_reader_counts) / sizeof(g_reader_counts[0]); i++) {
+        run_case(g_reader_counts[i], FALSE);
+    }
+    for (uint32_t i = 0; i < sizeof(g_reader_counts) / sizeof(g_reader_counts[0]); i++) {
+        run_case(g_reader_counts[i], TRUE);
+    }
+}
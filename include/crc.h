@@ -0,0 +1,111 @@
+/**
+ * @file crc.h
+ * @brief CRC engine interface (CRC8 / CRC16 / CRC32)
+ *
+ * REQ-数据完整性: design/04-数据完整性方案.md
+ * - CRC8:  SAE J1850 (poly 0x1D, init 0xFF, xorout 0xFF)
+ * - CRC16: CCITT (poly 0x1021, init 0xFFFF), see crc16.h
+ * - CRC32: CRC-32C Castagnoli (poly 0x1EDC6F41, reflected, init/xorout 0xFFFFFFFF)
+ *
+ * Each NvM_CrcType_t maps to a descriptor in a function-pointer table,
+ * so callers can resolve the engine once and avoid per-call dispatch.
+ */
+
+#ifndef CRC_H
+#define CRC_H
+
+#include "nvm.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Largest stored CRC size in bytes (CRC32)
+ */
+#define CRC_MAX_SIZE 4U
+
+/**
+ * @brief Generic CRC function (result zero-extended to 32 bits)
+ */
+typedef uint32_t (*Crc_CalculateFunc_t)(const uint8_t *data, uint32_t length);
+
+/**
+ * @brief CRC engine descriptor
+ */
+typedef struct Crc_Descriptor_s {
+    NvM_CrcType_t crc_type;          /**< CRC type this entry serves */
+    uint8_t crc_size;                /**< Stored CRC size in bytes (0 = none) */
+    Crc_CalculateFunc_t calculate;   /**< CRC function (NULL for NVM_CRC_NONE) */
+} Crc_Descriptor_t;
+
+/**
+ * @brief Calculate CRC-8 SAE J1850
+ *
+ * @param data Data buffer
+ * @param length Data length
+ * @return CRC-8 value
+ */
+uint8_t CRC_CalculateCRC8(const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Calculate CRC-16 CCITT (same as Crc16_Calculate)
+ *
+ * @param data Data buffer
+ * @param length Data length
+ * @return CRC-16 value
+ */
+uint16_t CRC_CalculateCRC16(const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Calculate CRC-32C (Castagnoli)
+ *
+ * Uses the SSE4.2 / ARMv8 crc32c instruction when the host supports it.
+ *
+ * @param data Data buffer
+ * @param length Data length
+ * @return CRC-32C value
+ */
+uint32_t CRC_CalculateCRC32(const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Get the descriptor for a CRC type
+ *
+ * @param crc_type CRC type
+ * @return Descriptor, or NULL if crc_type is out of range
+ */
+const Crc_Descriptor_t* CRC_GetDescriptor(NvM_CrcType_t crc_type);
+
+/**
+ * @brief Get the stored CRC size for a CRC type
+ *
+ * @param crc_type CRC type
+ * @return Size in bytes (0 for NVM_CRC_NONE or invalid types)
+ */
+uint8_t CRC_GetSize(NvM_CrcType_t crc_type);
+
+/**
+ * @brief Serialize a CRC value (little-endian, crc_size bytes)
+ *
+ * @param desc CRC descriptor
+ * @param crc CRC value
+ * @param dst Destination buffer (at least desc->crc_size bytes)
+ */
+void CRC_Store(const Crc_Descriptor_t *desc, uint32_t crc, uint8_t *dst);
+
+/**
+ * @brief Deserialize a stored CRC value (little-endian, crc_size bytes)
+ *
+ * @param desc CRC descriptor
+ * @param src Source buffer (at least desc->crc_size bytes)
+ * @return CRC value
+ */
+uint32_t CRC_Load(const Crc_Descriptor_t *desc, const uint8_t *src);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CRC_H */
@@ -10,6 +10,7 @@
 #ifndef CRC16_H
 #define CRC16_H
 
+#include "common_types.h"
 #include <stdint.h>
 #include <stddef.h>
 
@@ -17,6 +18,18 @@
 extern "C" {
 #endif
 
+/**
+ * @brief CRC-16 calculation engines
+ *
+ * All engines produce identical results; they differ only in speed.
+ */
+typedef enum {
+    CRC16_ENGINE_AUTO = 0,     /**< Fastest engine supported by the host */
+    CRC16_ENGINE_TABLE = 1,    /**< Byte-wise table lookup (reference) */
+    CRC16_ENGINE_SLICE8 = 2,   /**< Slice-by-8, 8 bytes per iteration */
+    CRC16_ENGINE_CLMUL = 3     /**< Carry-less multiply (PCLMULQDQ/PMULL) */
+} Crc16_EngineType;
+
 /**
  * @brief Calculate CRC-16 CCITT
  *
@@ -42,6 +55,34 @@ uint16_t Crc16_Calculate(const uint8_t *data, uint32_t length);
  */
 uint16_t Crc16_CalculateExtended(const uint8_t *data, uint32_t length, uint16_t init_crc);
 
+/**
+ * @brief Calculate CRC-16 CCITT with the byte-wise reference kernel
+ *
+ * Bypasses engine selection and fault injection. Intended for verifying
+ * the accelerated engines.
+ *
+ * @param data Data buffer
+ * @param length Data length
+ * @param init_crc Initial CRC value
+ * @return CRC-16 value
+ */
+uint16_t Crc16_CalculateReference(const uint8_t *data, uint32_t length, uint16_t init_crc);
+
+/**
+ * @brief Select the CRC-16 engine
+ *
+ * @param engine Engine to use (CRC16_ENGINE_AUTO = CPU-detected default)
+ * @return E_OK on success, E_NOT_OK if the engine is not supported by the host
+ */
+Std_ReturnType Crc16_SetEngine(Crc16_EngineType engine);
+
+/**
+ * @brief Get the active CRC-16 engine
+ *
+ * @return Active engine (never CRC16_ENGINE_AUTO)
+ */
+Crc16_EngineType Crc16_GetEngine(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,6 +6,8 @@
  * - 参数化配置: 容量、页大小、块大小、延时
  * - 寿命跟踪: 擦写计数、磨损均衡
  * - 延时模拟: 读/写/擦除操作延时
+ * - 位清除编程: 具备能力的器件可在已编程单元上只做1→0编程, 无需擦除
+ * - 片上ECC: 具备能力的器件按8字节字做SECDED, 读时就地纠正单比特错误
  */
 
 #ifndef EEPROM_DRIVER_H
@@ -19,6 +21,50 @@
 extern "C" {
 #endif
 
+struct Eeprom_ConfigType_s;
+
+/**
+ * @brief Device capability flags (Eeprom_ConfigType.capabilities)
+ */
+#define EEP_CAP_BIT_CLEAR 0x0001U   /**< Cells can be programmed 1→0 without an erase */
+#define EEP_CAP_ECC       0x0002U   /**< SECDED check byte per data word (spare area) */
+
+/**
+ * @brief Data bytes covered by one ECC check byte (EEP_CAP_ECC)
+ *
+ * The page size must be a multiple of it. Eep_Read corrects single-bit
+ * errors per word before returning; a double-bit error is counted and the
+ * data returned as sensed, for the caller's CRC to reject.
+ */
+#define EEP_ECC_WORD_SIZE 8U
+
+/**
+ * @brief Storage backend operations
+ *
+ * Eep_Read/Eep_Write/Eep_Erase perform validation, fault injection and
+ * accounting, then delegate the raw byte storage to a backend. All
+ * addresses and lengths are already range-checked and aligned.
+ */
+typedef struct {
+    const char *name;                                      /**< Backend name (diagnostics) */
+    Std_ReturnType (*init)(struct Eeprom_ConfigType_s *config, void **ctx);
+    void (*destroy)(void *ctx);
+    void (*read)(void *ctx, uint32_t address, uint8_t *dst, uint32_t length);
+    Std_ReturnType (*write)(void *ctx, uint32_t address, const uint8_t *src, uint32_t length);
+    Std_ReturnType (*erase)(void *ctx, uint32_t address, uint32_t length);
+    boolean (*is_blank)(void *ctx, uint32_t address, uint32_t length);
+    boolean (*compare)(void *ctx, uint32_t address, const uint8_t *expected, uint32_t length);
+    uint32_t (*resident_bytes)(void *ctx);                 /**< Host memory backing the image */
+    /* Optional (NULL = not supported) */
+    boolean (*is_programmable)(void *ctx, uint32_t address, const uint8_t *src,
+                               uint32_t length);           /**< Only 1→0 transitions needed */
+    uint32_t* (*erase_counts)(void *ctx);                  /**< Backend-owned per-block erase counters */
+    Std_ReturnType (*snapshot)(void *ctx);                 /**< Freeze current image as restore point */
+    Std_ReturnType (*restore)(void *ctx);                  /**< Discard changes since last snapshot */
+    const uint8_t* (*view)(void *ctx, uint32_t address,
+                           uint32_t *length);              /**< Stored bytes in place (NULL = erased), length trimmed to the run */
+} Eep_BackendOps_t;
+
 /**
  * @brief EEPROM configuration parameters
  *
@@ -27,7 +73,7 @@ extern "C" {
  * - 50µs read, 2ms write, 3ms erase delays
  * - 100K cycles endurance
  */
-typedef struct {
+typedef struct Eeprom_ConfigType_s {
     uint32_t capacity_bytes;       /**< Total capacity in bytes */
     uint32_t page_size;            /**< Page size in bytes (write alignment) */
     uint32_t block_size;           /**< Block size in bytes (erase alignment) */
@@ -35,7 +81,10 @@ typedef struct {
     uint32_t write_delay_ms;       /**< Write delay per page (milliseconds) */
     uint32_t erase_delay_ms;       /**< Erase delay per block (milliseconds) */
     uint32_t endurance_cycles;     /**< Endurance in erase/write cycles */
-    uint8_t  *virtual_storage;     /**< Simulated EEPROM storage */
+    uint8_t  *virtual_storage;     /**< Simulated EEPROM storage (flat) or read-only base image (sparse) */
+    const Eep_BackendOps_t *backend; /**< Storage backend (NULL = flat array, or mmap if image_path set) */
+    const char *image_path;        /**< Persistent image file for the mmap backend (NULL = none) */
+    uint32_t capabilities;         /**< EEP_CAP_* device features */
 } Eeprom_ConfigType;
 
 /**
@@ -49,8 +98,43 @@ typedef struct {
     uint32_t crc_error_count;      /**< CRC error count */
     uint32_t total_bytes_read;     /**< Total bytes read */
     uint32_t total_bytes_written;  /**< Total bytes written */
+    uint32_t resident_bytes;       /**< Host memory used by the storage backend */
+    uint32_t skipped_erase_count;  /**< Erases of already-erased blocks (no backend work) */
+    uint32_t skipped_blank_check_count; /**< Programs whose blank check hit the erased bitmap */
+    uint32_t total_verify_count;   /**< Eep_Verify compares */
+    uint32_t verify_mismatch_count; /**< Compares that found different content */
+    uint32_t bit_clear_write_count; /**< Programs over non-blank pages (bit-clear mode) */
+    uint32_t ecc_corrected_count;  /**< Words whose single-bit error ECC corrected on read */
+    uint32_t ecc_uncorrectable_count; /**< Words read with an uncorrectable (double-bit) error */
 } Eeprom_DiagInfoType;
 
+/**
+ * @brief EEPROM instance: configuration, storage image, counters, ECC and timing state
+ */
+typedef struct Eep_Context Eep_Context_t;
+
+/**
+ * @brief Create an uninitialized device context (call Eep_Init with it bound)
+ *
+ * @return NULL if out of memory
+ */
+Eep_Context_t* Eep_CreateContext(void);
+
+/**
+ * @brief Destroy a context and its storage (must not be bound on any thread)
+ */
+void Eep_DestroyContext(Eep_Context_t *ctx);
+
+/**
+ * @brief Make a context current for the calling thread
+ *
+ * Every Eep call on the thread then uses it; MemIf device 0 follows.
+ *
+ * @param ctx Context, NULL for the default context
+ * @return The previous binding (NULL = default context)
+ */
+Eep_Context_t* Eep_BindContext(Eep_Context_t *ctx);
+
 /**
  * @brief Initialize EEPROM driver
  *
@@ -82,7 +166,7 @@ Std_ReturnType Eep_Read(uint32_t address, uint8_t *data_buffer, uint32_t length)
  * @param length Number of bytes to write (must be multiple of page size)
  * @return E_OK on success, E_NOT_OK on failure
  *
- * REQ-写操作: 必须页对齐，目标页必须为空(0xFF)
+ * REQ-写操作: 必须页对齐，目标页必须为空(0xFF) (位清除模式: 或只需1→0转换)
  * 延时: (length / page_size) × write_delay_ms
  */
 Std_ReturnType Eep_Write(uint32_t address, const uint8_t *data_buffer, uint32_t length);
@@ -98,6 +182,89 @@ Std_ReturnType Eep_Write(uint32_t address, const uint8_t *data_buffer, uint32_t
  */
 Std_ReturnType Eep_Erase(uint32_t address);
 
+/**
+ * @brief One segment of a vectored access
+ *
+ * As with POSIX iovec the buffer is not const: Eep_WriteV only reads it.
+ */
+typedef struct {
+    uint32_t address;              /**< Byte offset of the segment */
+    void *buffer;                  /**< Destination (ReadV) or source (WriteV) */
+    uint32_t length;               /**< Segment length in bytes */
+} Eep_IoVec_t;
+
+/**
+ * @brief Read several segments as one device operation
+ *
+ * All segments are validated before any is read. Diagnostics count one
+ * read of the total length and the latency is charged once.
+ *
+ * @param iov Segments (any address, any length)
+ * @param count Number of segments
+ * @return E_OK if every segment was read
+ *
+ * REQ-读操作: 分散读取, 一次命令开销
+ */
+Std_ReturnType Eep_ReadV(const Eep_IoVec_t *iov, uint32_t count);
+
+/**
+ * @brief Program several segments as one device operation
+ *
+ * Every segment obeys the Eep_Write rules (page-aligned address and
+ * length, erased or bit-clear programmable target); they are all checked
+ * before the first page is programmed, so a refused vector changes
+ * nothing. A power loss during programming leaves the later segments
+ * unprogrammed.
+ *
+ * @param iov Segments in programming order
+ * @param count Number of segments
+ * @return E_OK if every segment was programmed
+ *
+ * REQ-写操作: 聚合编程, 一次命令开销
+ */
+Std_ReturnType Eep_WriteV(const Eep_IoVec_t *iov, uint32_t count);
+
+/**
+ * @brief Program acceptance rule of Eep_Write
+ */
+typedef enum {
+    EEP_PROGRAM_BLANK = 0,     /**< Target pages must be erased (default) */
+    EEP_PROGRAM_BIT_CLEAR = 1  /**< Also accept pages where (old & new) == new */
+} Eep_ProgramMode_t;
+
+/**
+ * @brief Select the program acceptance rule
+ *
+ * EEP_PROGRAM_BIT_CLEAR needs a device with EEP_CAP_BIT_CLEAR and a
+ * backend with is_programmable. A refused program changes nothing and
+ * costs no device time. Reset to EEP_PROGRAM_BLANK by Eep_Init.
+ *
+ * @param mode Acceptance rule
+ * @return E_OK on success, E_NOT_OK if not initialized, the mode is
+ *         unknown or the device cannot program 1→0 in place
+ *
+ * REQ-写操作: 位清除模式下, 只需1→0转换的页无需先擦除
+ */
+Std_ReturnType Eep_SetProgramMode(Eep_ProgramMode_t mode);
+
+/**
+ * @brief Current program acceptance rule
+ */
+Eep_ProgramMode_t Eep_GetProgramMode(void);
+
+/**
+ * @brief Compare EEPROM content with expected data (write verification)
+ *
+ * @param address Byte offset to compare from
+ * @param expected_data Data the range should hold
+ * @param length Number of bytes to compare
+ * @return E_OK if the content matches, E_NOT_OK on mismatch or failure
+ *
+ * REQ-校验操作: 器件内部比较, 数据不经总线传回主机 (无拷贝, 无CRC重算)
+ * 延时: length × read_delay_us (按读取速率感测单元)
+ */
+Std_ReturnType Eep_Verify(uint32_t address, const uint8_t *expected_data, uint32_t length);
+
 /**
  * @brief Get diagnostic information
  *
@@ -106,6 +273,27 @@ Std_ReturnType Eep_Erase(uint32_t address);
  */
 Std_ReturnType Eep_GetDiagnostics(Eeprom_DiagInfoType *diag_info);
 
+/**
+ * @brief Get the erase count of one erase block
+ *
+ * @param address Any address inside the block
+ * @param count Receives the number of erases of that block
+ * @return E_OK on success, E_NOT_OK if not initialized or out of range
+ */
+Std_ReturnType Eep_GetEraseCount(uint32_t address, uint32_t *count);
+
+/**
+ * @brief Add wear to one erase block without erasing it (accelerated aging)
+ *
+ * The count saturates at endurance_cycles, where Eep_Erase starts to
+ * fail. max_erase_count follows; total_erase_count (operations) does not.
+ *
+ * @param address Any address inside the block
+ * @param cycles Erase cycles to add
+ * @return E_OK on success, E_NOT_OK if not initialized or out of range
+ */
+Std_ReturnType Eep_AddEraseCount(uint32_t address, uint32_t cycles);
+
 /**
  * @brief Check if address is page-aligned
  *
@@ -132,11 +320,215 @@ const Eeprom_ConfigType* Eep_GetConfig(void);
 /**
  * @brief Set time scale for simulation (for testing)
  *
+ * Divides the host sleep of EEP_TIMING_REALTIME; 65535 (fastest) sleeps
+ * not at all.
+ *
  * @param scale Time scale factor (1=real-time, 10=10x faster, etc.)
  * @return E_OK on success, E_NOT_OK on failure
  */
 Std_ReturnType Eep_SetTimeScale(uint32_t scale);
 
+/**
+ * @brief Device operation kinds of the timing model
+ */
+typedef enum {
+    EEP_OP_READ = 0,
+    EEP_OP_WRITE = 1,
+    EEP_OP_ERASE = 2,
+    EEP_OP_VERIFY = 3
+} Eep_OpType_t;
+
+#define EEP_OP_COUNT 4U
+
+/**
+ * @brief What the modelled device time drives
+ */
+typedef enum {
+    EEP_TIMING_OFF = 0,        /**< Not modelled (default) */
+    EEP_TIMING_VIRTUAL = 1,    /**< Each operation advances the scheduler's virtual clock */
+    EEP_TIMING_REALTIME = 2    /**< VIRTUAL plus a host sleep of latency / time scale */
+} Eep_TimingMode_t;
+
+/**
+ * @brief Latency distributions around the nominal delay
+ *
+ * The nominal delay comes from the configuration: read_delay_us per
+ * byte (reads and verifies), write_delay_ms per page, erase_delay_ms per
+ * block.
+ */
+typedef enum {
+    EEP_LATENCY_CONSTANT = 0,  /**< Always the nominal delay */
+    EEP_LATENCY_UNIFORM = 1,   /**< Uniform in nominal +/- spread_pct */
+    EEP_LATENCY_NORMAL = 2     /**< Normal, standard deviation spread_pct of nominal */
+} Eep_LatencyDist_t;
+
+/**
+ * @brief Latency model of one operation kind
+ */
+typedef struct {
+    Eep_LatencyDist_t dist;
+    uint32_t spread_pct;       /**< Width of the distribution, percent of nominal */
+    uint32_t tail_ppm;         /**< Slow outliers per million operations */
+    uint32_t tail_factor;      /**< Outlier latency = sample * tail_factor */
+} Eep_LatencyModel_t;
+
+/**
+ * @brief Modelled device time since Eep_Init or Eep_ResetTimingStats
+ */
+typedef struct {
+    uint32_t op_count[EEP_OP_COUNT];
+    uint64_t busy_us[EEP_OP_COUNT];    /**< Sum of sampled latencies */
+    uint32_t min_us[EEP_OP_COUNT];
+    uint32_t max_us[EEP_OP_COUNT];
+    uint32_t tail_count;               /**< Outliers drawn */
+    uint64_t total_busy_us;
+} Eep_TimingStats_t;
+
+/**
+ * @brief Select what device timing drives
+ *
+ * Kept across Eep_Init. With EEP_TIMING_VIRTUAL every read, write and
+ * erase draws a latency from its model and advances the scheduler clock
+ * by it (sub-millisecond remainders carry over), so NvM throughput and
+ * WriteAll duration can be read off OsScheduler_GetVirtualTimeMs.
+ *
+ * @return E_NOT_OK for an unknown mode
+ */
+Std_ReturnType Eep_SetTimingMode(Eep_TimingMode_t mode);
+
+/**
+ * @brief Current timing mode
+ */
+Eep_TimingMode_t Eep_GetTimingMode(void);
+
+/**
+ * @brief Set the latency model of one operation kind (default: constant)
+ *
+ * Kept across Eep_Init.
+ *
+ * @return E_NOT_OK on invalid arguments
+ */
+Std_ReturnType Eep_SetLatencyModel(Eep_OpType_t op, const Eep_LatencyModel_t *model);
+
+/**
+ * @brief Restart the latency random sequence (reproducible runs)
+ */
+void Eep_SetLatencySeed(uint32_t seed);
+
+/**
+ * @brief Draw and account the latency of one operation
+ *
+ * For engines that schedule device time themselves (MemIf jobs): they
+ * draw the step latency here and perform the transfer with the clock
+ * suspended, so the time is counted once.
+ *
+ * @param op Operation kind
+ * @param length Bytes transferred (reads/writes)
+ * @return Latency in microseconds
+ */
+uint32_t Eep_SampleLatencyUs(Eep_OpType_t op, uint32_t length);
+
+/**
+ * @brief Stop (TRUE) or resume (FALSE) charging operations to the clock
+ */
+void Eep_SuspendClock(boolean suspend);
+
+/**
+ * @brief Get modelled device time statistics
+ *
+ * @return E_NOT_OK if stats is NULL
+ */
+Std_ReturnType Eep_GetTimingStats(Eep_TimingStats_t *stats);
+
+/**
+ * @brief Clear modelled device time statistics
+ */
+void Eep_ResetTimingStats(void);
+
+/**
+ * @brief Flat array backend (default)
+ *
+ * One contiguous buffer of capacity_bytes, allocated and filled with
+ * 0xFF at init unless virtual_storage is provided.
+ */
+const Eep_BackendOps_t* Eep_GetFlatBackend(void);
+
+/**
+ * @brief Sparse copy-on-write backend
+ *
+ * Only pages that have been written are allocated; untouched pages read
+ * as 0xFF, or from virtual_storage when a base image is provided. The
+ * base image is never modified: a written page is copied on first write
+ * and an erase shadows the base with 0xFF.
+ */
+const Eep_BackendOps_t* Eep_GetSparseBackend(void);
+
+/**
+ * @brief Memory-mapped image file backend
+ *
+ * Maps image_path (created and filled with 0xFF if missing) MAP_SHARED so
+ * every program/erase persists in the file. Erase counts live in the
+ * "<image_path>.wear" sidecar, which carries a geometry header and is
+ * mapped the same way.
+ */
+const Eep_BackendOps_t* Eep_GetMmapBackend(void);
+
+/**
+ * @brief Freeze the current image as the restore point
+ *
+ * For the mmap backend the image is flushed to the file and then remapped
+ * MAP_PRIVATE, so later changes are copy-on-write and never reach the file.
+ *
+ * @return E_OK on success, E_NOT_OK if not initialized or unsupported
+ */
+Std_ReturnType Eep_Snapshot(void);
+
+/**
+ * @brief Revert image, erase counts and diagnostics to the last snapshot
+ *
+ * Only the pages dirtied since Eep_Snapshot() are discarded, so restoring a
+ * multi-megabyte image costs microseconds.
+ *
+ * @return E_OK on success, E_NOT_OK if no snapshot was taken
+ */
+Std_ReturnType Eep_Restore(void);
+
+/**
+ * @brief Read-only view of the stored image, without a copy or device time
+ *
+ * For host tools (visualizer bindings) that render large images. The
+ * view is not an Eep_Read: it is not traced, counted or timed. Flat and
+ * mmap images are one run; the sparse backend returns one page at a
+ * time and NULL for pages that read as erased (0xFF).
+ *
+ * The pointer stays valid until Eep_Init, Eep_Destroy, Eep_Snapshot or
+ * Eep_Restore, and for the sparse backend until the run is written or
+ * erased.
+ *
+ * @param address First byte
+ * @param data Receives the bytes at address, or NULL if they read as erased
+ * @param length In: bytes wanted; out: bytes available at data (the contiguous run)
+ * @return E_OK on success, E_NOT_OK if not initialized, out of range or
+ *         the backend has no view
+ */
+Std_ReturnType Eep_GetStorageView(uint32_t address, const uint8_t **data, uint32_t *length);
+
+/**
+ * @brief Read-only view of the per-block erase counters
+ *
+ * Counters live in chunks allocated on first erase (one array for
+ * backends that keep their own), so the view covers the run up to the
+ * end of the chunk; NULL means the whole run still reads 0. Re-query
+ * after erases to pick up newly allocated chunks.
+ *
+ * @param block_index First erase block
+ * @param counts Receives the counters from block_index, or NULL if all are 0
+ * @param length Receives the counters in the run
+ * @return E_OK on success, E_NOT_OK if not initialized or out of range
+ */
+Std_ReturnType Eep_GetEraseCountView(uint32_t block_index, const uint32_t **counts,
+                                     uint32_t *length);
+
 /**
  * @brief Destroy EEPROM driver and cleanup resources
  */
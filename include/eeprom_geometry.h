@@ -0,0 +1,72 @@
+/**
+ * @file eeprom_geometry.h
+ * @brief Build-time device geometry (part profiles)
+ *
+ * REQ-EEPROM物理参数模型: design/01-EEPROM基础知识.md §1
+ * - 构建时选择器件型号 (make EEP_PART=24C32), 容量/页/擦除单元成为编译期常量
+ * - 页与擦除单元为2的幂: 地址运算化为移位与掩码, 越界检查由编译器折叠
+ * - 常量可直接用于静态缓冲区大小
+ * - 未选择型号时沿用运行时几何参数 (Eeprom_ConfigType), 支持任意尺寸
+ *
+ * EEPROM cells are byte-alterable; the simulator still models an erase
+ * unit, so the EEPROM profiles erase in 1 KB sectors (one NvM slot).
+ */
+
+#ifndef EEPROM_GEOMETRY_H
+#define EEPROM_GEOMETRY_H
+
+#if defined(EEP_PART_DEFAULT)
+/* The simulator's default device: 4 KB, 256-byte pages, 1 KB erase blocks */
+#define EEP_GEOM_PART_NAME    "default"
+#define EEP_GEOM_CAPACITY     4096U
+#define EEP_GEOM_PAGE_SHIFT   8U
+#define EEP_GEOM_BLOCK_SHIFT  10U
+
+#elif defined(EEP_PART_24C32)
+/* 24C32: 32 Kbit I2C EEPROM, 32-byte write page */
+#define EEP_GEOM_PART_NAME    "24C32"
+#define EEP_GEOM_CAPACITY     4096U
+#define EEP_GEOM_PAGE_SHIFT   5U
+#define EEP_GEOM_BLOCK_SHIFT  10U
+
+#elif defined(EEP_PART_25LC640)
+/* 25LC640: 64 Kbit SPI EEPROM, 32-byte write page */
+#define EEP_GEOM_PART_NAME    "25LC640"
+#define EEP_GEOM_CAPACITY     8192U
+#define EEP_GEOM_PAGE_SHIFT   5U
+#define EEP_GEOM_BLOCK_SHIFT  10U
+
+#elif defined(EEP_PART_M95M01)
+/* M95M01: 1 Mbit SPI EEPROM, 256-byte write page */
+#define EEP_GEOM_PART_NAME    "M95M01"
+#define EEP_GEOM_CAPACITY     131072U
+#define EEP_GEOM_PAGE_SHIFT   8U
+#define EEP_GEOM_BLOCK_SHIFT  10U
+
+#elif defined(EEP_PART)
+#error "EEP_PART: unknown part profile"
+#endif
+
+#ifdef EEP_GEOM_PAGE_SHIFT
+/**
+ * @brief Geometry is fixed at build time
+ */
+#define EEP_GEOM_FIXED        1
+#define EEP_GEOM_PAGE_SIZE    (1U << EEP_GEOM_PAGE_SHIFT)
+#define EEP_GEOM_BLOCK_SIZE   (1U << EEP_GEOM_BLOCK_SHIFT)
+
+#if EEP_GEOM_BLOCK_SHIFT < EEP_GEOM_PAGE_SHIFT
+#error "EEP_PART: erase unit smaller than a page"
+#endif
+#if (EEP_GEOM_CAPACITY % EEP_GEOM_BLOCK_SIZE) != 0
+#error "EEP_PART: capacity is not a whole number of erase units"
+#endif
+
+#else
+/**
+ * @brief Geometry comes from Eeprom_ConfigType at Eep_Init
+ */
+#define EEP_GEOM_FIXED        0
+#endif
+
+#endif /* EEPROM_GEOMETRY_H */
@@ -12,6 +12,7 @@
 #include <stdint.h>
 #include <stddef.h>
 #include "common_types.h"
+#include "eeprom_geometry.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -24,6 +25,50 @@ extern "C" {
  * This ensures CRC and metadata don't conflict with adjacent blocks.
  */
 #define EEPROM_BLOCK_SLOT_SIZE  1024
+#define EEPROM_BLOCK_SLOT_SHIFT 10U
+#if (1 << EEPROM_BLOCK_SLOT_SHIFT) != EEPROM_BLOCK_SLOT_SIZE
+#error "EEPROM_BLOCK_SLOT_SHIFT does not match EEPROM_BLOCK_SLOT_SIZE"
+#endif
+
+/**
+ * @brief EEPROM program unit assumed by the block layout
+ */
+#define EEPROM_LAYOUT_PAGE_SIZE 256U
+
+/* A part profile must fit the layout: whole device pages per layout page,
+ * whole erase units per slot */
+#if EEP_GEOM_FIXED
+#if (EEPROM_LAYOUT_PAGE_SIZE % EEP_GEOM_PAGE_SIZE) != 0
+#error "EEP_PART: device page does not divide EEPROM_LAYOUT_PAGE_SIZE"
+#endif
+#if (EEPROM_BLOCK_SLOT_SIZE % EEP_GEOM_BLOCK_SIZE) != 0
+#error "EEP_PART: erase unit does not divide EEPROM_BLOCK_SLOT_SIZE"
+#endif
+#endif
+
+/**
+ * @brief Round a length up to whole pages
+ */
+#define EEPROM_PAGE_ROUNDUP(len) \
+    ((((uint32_t)(len) + EEPROM_LAYOUT_PAGE_SIZE - 1U) / EEPROM_LAYOUT_PAGE_SIZE) * EEPROM_LAYOUT_PAGE_SIZE)
+
+/**
+ * @brief Dataset slot header: offset within the slot (its last page) and length
+ *
+ * Holds the slot's sequence number; DATASET data and CRC must end before it.
+ */
+#define EEPROM_DATASET_HEADER_OFFSET (EEPROM_BLOCK_SLOT_SIZE - EEPROM_LAYOUT_PAGE_SIZE)
+#define EEPROM_DATASET_HEADER_SIZE   10U
+
+/**
+ * @brief Length header in front of a compressed block copy
+ */
+#define EEPROM_COMPRESSED_HEADER_SIZE 2U
+
+/**
+ * @brief Maximum number of versions of a DATASET block
+ */
+#define EEPROM_MAX_DATASET_COUNT 4U
 
 /**
  * @brief Maximum number of blocks for 4KB EEPROM
@@ -49,7 +94,7 @@ extern "C" {
  * @param offset EEPROM offset
  * @return TRUE if aligned to 1024-byte boundary
  */
-#define EEPROM_IS_SLOT_ALIGNED(offset) (((offset) % EEPROM_BLOCK_SLOT_SIZE) == 0)
+#define EEPROM_IS_SLOT_ALIGNED(offset) (((offset) & (EEPROM_BLOCK_SLOT_SIZE - 1U)) == 0)
 
 /**
  * @brief Calculate next block slot offset
@@ -66,7 +111,9 @@ typedef struct {
     uint32_t data_offset;      /**< Data region offset (slot start) */
     uint32_t data_size;        /**< Data size in bytes */
     uint32_t crc_offset;       /**< CRC offset (data_offset + data_size) */
-    uint32_t crc_size;         /**< CRC size (typically 2 for CRC16) */
+    uint32_t crc_size;         /**< CRC size (0/1/2/4 for NONE/CRC8/CRC16/CRC32) */
+    uint32_t program_size;     /**< Bytes programmed by one block write */
+    uint32_t program_ops;      /**< MemIf_Write calls per block write */
     uint32_t reserved_start;   /**< Reserved region start */
     uint32_t reserved_size;    /**< Reserved region size */
     uint32_t slot_size;        /**< Total slot size */
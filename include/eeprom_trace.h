@@ -0,0 +1,192 @@
+/**
+ * @file eeprom_trace.h
+ * @brief Binary I/O trace of Eep operations and max-speed replay
+ *
+ * - 捕获: 在 Eep_Read/Eep_Write/Eep_Erase/Eep_Verify 边界记录定长记录
+ *   (操作, 地址, 长度, 结果, 虚拟时间戳, 器件延时, 可选负载CRC32)
+ * - 记录先进入内存缓冲, 满后整块写出 (一次fwrite)
+ * - 回放: 直接送入驱动或MemIf, 默认全速; 可选按捕获的虚拟时间戳节拍回放
+ * - 文件为主机字节序, 头部记录捕获时的器件几何参数
+ */
+
+#ifndef EEPROM_TRACE_H
+#define EEPROM_TRACE_H
+
+#include "common_types.h"
+#include "eeprom_driver.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief File format
+ */
+#define EEP_TRACE_MAGIC          0x54504545U    /**< "EEPT" */
+#define EEP_TRACE_VERSION        1U
+
+/**
+ * @brief Capture flags
+ */
+#define EEP_TRACE_HASH_PAYLOAD   0x0001U        /**< CRC32 of data written / read / compared */
+
+/**
+ * @brief Records buffered before a block write (default)
+ */
+#define EEP_TRACE_DEFAULT_BUFFER 8192U
+
+/**
+ * @brief File header
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;           /**< sizeof(EepTrace_Record_t) */
+    uint32_t capacity_bytes;        /**< Geometry at capture */
+    uint32_t page_size;
+    uint32_t block_size;
+    uint32_t flags;                 /**< EEP_TRACE_* capture flags */
+} EepTrace_FileHeader_t;
+
+/**
+ * @brief One operation (24 bytes)
+ */
+typedef struct {
+    uint8_t op;                     /**< Eep_OpType_t */
+    uint8_t result;                 /**< Std_ReturnType returned */
+    uint16_t flags;                 /**< EEP_TRACE_HASH_PAYLOAD if payload_hash is set */
+    uint32_t address;
+    uint32_t length;                /**< Bytes; block size for erases */
+    uint32_t payload_hash;
+    uint32_t virtual_ms;            /**< Scheduler time when the operation started */
+    uint32_t device_us;             /**< Modelled device latency */
+} EepTrace_Record_t;
+
+/**
+ * @brief Capture statistics
+ */
+typedef struct {
+    uint64_t records;               /**< Records captured */
+    uint64_t bytes_written;         /**< Bytes written to the file */
+    uint32_t block_writes;          /**< Buffer flushes */
+    uint32_t write_errors;          /**< Failed flushes (records lost) */
+} EepTrace_Stats_t;
+
+/**
+ * @brief Replay target
+ */
+typedef enum {
+    EEP_REPLAY_DRIVER = 0,          /**< Eep_Read / Eep_Write / Eep_Erase */
+    EEP_REPLAY_MEMIF = 1            /**< MemIf_Read / MemIf_Write / MemIf_Erase (wear leveling applies) */
+} EepReplay_Target_t;
+
+/**
+ * @brief Replay options
+ */
+typedef struct {
+    EepReplay_Target_t target;
+    uint32_t base_address;          /**< Added to every address (MemIf device placement) */
+    boolean timed;                  /**< Issue each operation at its captured virtual time */
+    uint32_t time_scale;            /**< Timed: host pacing divisor (1 = real time, 0 = virtual clock only) */
+} EepReplay_Config_t;
+
+/**
+ * @brief Replay results
+ */
+typedef struct {
+    uint32_t records;
+    uint32_t op_count[EEP_OP_COUNT];
+    uint32_t failed;                /**< Operations that returned E_NOT_OK */
+    uint32_t result_mismatches;     /**< Operations whose result differs from the capture */
+    uint64_t bytes;                 /**< Bytes read and programmed */
+    uint64_t elapsed_ns;            /**< Host time of the replay */
+    uint32_t captured_span_ms;      /**< Virtual time from first to last captured operation */
+} EepReplay_Stats_t;
+
+/**
+ * @brief Capture on/off (read it through EEP_TRACE_ACTIVE)
+ */
+extern uint32_t EepTrace_ActiveFlag;
+
+/**
+ * @brief TRUE while a capture is running
+ */
+#define EEP_TRACE_ACTIVE() (__atomic_load_n(&EepTrace_ActiveFlag, __ATOMIC_RELAXED) != 0U)
+
+/**
+ * @brief Start capturing to a file (truncated)
+ *
+ * The header takes the geometry of the initialized driver. Capture runs
+ * under the driver's threading rules (one thread issuing operations).
+ *
+ * @param path Output file
+ * @param flags EEP_TRACE_* capture flags
+ * @param buffer_records Records per block write (0 = EEP_TRACE_DEFAULT_BUFFER)
+ * @return E_OK on success, E_NOT_OK if already capturing, the driver is
+ *         not initialized or the file cannot be created
+ */
+Std_ReturnType EepTrace_Start(const char *path, uint32_t flags, uint32_t buffer_records);
+
+/**
+ * @brief Write out buffered records
+ *
+ * @return E_OK on success, E_NOT_OK if not capturing or the write failed
+ */
+Std_ReturnType EepTrace_Flush(void);
+
+/**
+ * @brief Flush and close the capture
+ *
+ * @return E_OK on success, E_NOT_OK if not capturing or the final write failed
+ */
+Std_ReturnType EepTrace_Stop(void);
+
+/**
+ * @brief Get capture statistics (of the running or last capture)
+ *
+ * @return E_NOT_OK if stats is NULL
+ */
+Std_ReturnType EepTrace_GetStats(EepTrace_Stats_t *stats);
+
+/**
+ * @brief Record one operation (called by the driver)
+ *
+ * @param op Operation
+ * @param result Result returned to the caller
+ * @param address Address
+ * @param length Bytes (block size for erases)
+ * @param data Payload to hash (NULL for erases and failed reads)
+ * @param virtual_ms Scheduler time at the start of the operation
+ * @param device_us Modelled device latency
+ */
+void EepTrace_Record(Eep_OpType_t op, Std_ReturnType result, uint32_t address, uint32_t length,
+                     const uint8_t *data, uint32_t virtual_ms, uint32_t device_us);
+
+/**
+ * @brief Replay a trace into the driver or MemIf
+ *
+ * The target must be initialized; the replay starts from whatever image
+ * it holds (normally the same state the capture started from). Writes
+ * program a fixed pattern since payloads are not captured, and verifies
+ * compare against that pattern.
+ *
+ * In timed mode the scheduler clock is advanced to each record's
+ * captured time before the operation is issued, and with a non-zero
+ * time_scale the host also waits so operations are spaced by
+ * (captured gap / time_scale).
+ *
+ * @param path Trace file
+ * @param config Options (NULL = driver, max speed)
+ * @param stats Results (may be NULL)
+ * @return E_OK if the whole trace was replayed, E_NOT_OK if the file is
+ *         missing, malformed or truncated
+ */
+Std_ReturnType EepReplay_Run(const char *path, const EepReplay_Config_t *config,
+                             EepReplay_Stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EEPROM_TRACE_H */
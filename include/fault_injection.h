@@ -7,6 +7,11 @@
  * - P0级故障: F01-F05 (PowerLoss, Timeout, BitFlip, CRC, Verify)
  * - Hook机制: Eep_Read/Eep_Write/Crc_Calculate
  * - 可配置的故障概率和触发条件
+ * - 可复现: 每个故障一条由种子派生的随机流, 概率故障预先抽取下次触发间隔
+ * - 零开销: 调用点先检查全局armed位掩码; -DFAULT_INJ_DISABLED 编译期移除调用
+ * - 按Block定向: 地址区间索引 (有序区间, 二分查找) 将EEPROM地址映射到Block
+ * - 磨损相关误码: 读出位错误率随擦除块擦写次数增长 (配合加速老化)
+ * - 多实例: 配置/随机流/统计属于上下文, 线程绑定的上下文生效 (sim_context.h)
  */
 
 #ifndef FAULT_INJECTION_H
@@ -56,21 +61,52 @@ typedef enum {
     /* P0-10: Job queue overflow */
     FAULT_P0_QUEUE_OVERFLOW = 0x0A,
 
+    /* Wear-dependent bit errors after read (FaultInj_SetWearModel) */
+    FAULT_WEAR_BITFLIP = 0x0B,
+
     FAULT_MAX_ID = 0xFF
 } FaultId_t;
 
+/**
+ * @brief target_block_id matching every address (and unmapped addresses)
+ */
+#define FAULT_INJ_ALL_BLOCKS 0xFFU
+
+/**
+ * @brief Maximum number of address ranges in the block index
+ */
+#define FAULT_INJ_MAX_RANGES 1024U
+
 /**
  * @brief Fault configuration
  */
 typedef struct {
     FaultId_t fault_id;
     boolean enabled;
-    uint8_t target_block_id;      /**< 0xFF = all blocks */
+    uint8_t target_block_id;      /**< FAULT_INJ_ALL_BLOCKS = all blocks */
     uint16_t trigger_count;       /**< 0 = trigger every time */
     uint16_t triggered_count;     /**< Internal counter */
-    uint8_t probability_percent;  /**< 0-100, 0 = always, 100 = never */
+    uint8_t probability_percent;  /**< 0 or >= 100 = always, else trigger chance per hook call */
 } FaultConfig_t;
 
+/**
+ * @brief Bit error model of FAULT_WEAR_BITFLIP
+ *
+ * A bit read from an erase block with erase count w flips with probability
+ * ber_ppb_at_endurance * 1e-9 * (w / endurance_cycles)^exponent. Each read
+ * flips the expected number of bits: the integer part always, one more with
+ * the fractional part as probability. Flipped positions are random.
+ */
+typedef struct {
+    uint32_t ber_ppb_at_endurance; /**< Bit errors per 10^9 bits read at the rated endurance */
+    uint8_t exponent;              /**< Growth of the rate with wear (1 = linear, max 8) */
+} FaultWearModel_t;
+
+/**
+ * @brief Seed used until FaultInj_SetSeed is called
+ */
+#define FAULT_INJ_DEFAULT_SEED 12345ULL
+
 /**
  * @brief Fault injection statistics
  */
@@ -80,11 +116,96 @@ typedef struct {
     uint32_t injection_failures;
 } FaultStats_t;
 
+/**
+ * @brief Armed-mask bit of a fault ID (IDs from 31 up share bit 31)
+ */
+#define FAULT_INJ_BIT(fault_id) \
+    (((uint32_t)(fault_id) < 31U) ? (1UL << (uint32_t)(fault_id)) : (1UL << 31))
+
+/**
+ * @brief Faults each hook can inject (call sites test these before calling)
+ */
+#define FAULT_INJ_MASK_BEFORE_READ  0UL
+#define FAULT_INJ_MASK_AFTER_READ   (FAULT_INJ_BIT(FAULT_P0_BITFLIP_SINGLE) | \
+                                     FAULT_INJ_BIT(FAULT_P0_BITFLIP_MULTI) | \
+                                     FAULT_INJ_BIT(FAULT_WEAR_BITFLIP))
+#define FAULT_INJ_MASK_BEFORE_WRITE FAULT_INJ_BIT(FAULT_P0_TIMEOUT_ERASE)
+#define FAULT_INJ_MASK_AFTER_WRITE  FAULT_INJ_BIT(FAULT_P0_POWERLOSS_PAGEPROGRAM)
+#define FAULT_INJ_MASK_CRC          FAULT_INJ_BIT(FAULT_P0_CRC_INVERT)
+#define FAULT_INJ_MASK_VERIFY       FAULT_INJ_BIT(FAULT_P0_WRITE_VERIFY_FAIL)
+#define FAULT_INJ_MASK_RAM_MIRROR   FAULT_INJ_BIT(FAULT_P0_RAM_CORRUPT)
+
+/**
+ * @brief Bits of the faults that are enabled and not yet used up
+ *
+ * Maintained by the FaultInj API over every context; read it through
+ * FAULT_INJ_ARMED.
+ */
+extern uint32_t FaultInj_ArmedMask;
+
+/**
+ * @brief TRUE if a hook covering these mask bits may inject something
+ *
+ * Call sites skip the hook call when this is FALSE. Building with
+ * -DFAULT_INJ_DISABLED (make FAULT_INJ=0) makes it a constant FALSE, so
+ * the hook calls are compiled out of the storage path entirely.
+ */
+#ifdef FAULT_INJ_DISABLED
+#define FAULT_INJ_ARMED(mask) (FALSE)
+#else
+#define FAULT_INJ_ARMED(mask) \
+    ((__atomic_load_n(&FaultInj_ArmedMask, __ATOMIC_RELAXED) & (mask)) != 0U)
+#endif
+
+/**
+ * @brief Fault injection instance: configurations, random streams, ranges, statistics
+ */
+typedef struct FaultInj_Context FaultInj_Context_t;
+
+/**
+ * @brief Create a context in the state FaultInj_Init leaves
+ *
+ * @return NULL if out of memory
+ */
+FaultInj_Context_t* FaultInj_CreateContext(void);
+
+/**
+ * @brief Destroy a context (must not be bound on any thread)
+ */
+void FaultInj_DestroyContext(FaultInj_Context_t *ctx);
+
+/**
+ * @brief Make a context current for the calling thread
+ *
+ * Every FaultInj call and hook on the thread then uses it.
+ *
+ * @param ctx Context, NULL for the default context
+ * @return The previous binding (NULL = default context)
+ */
+FaultInj_Context_t* FaultInj_BindContext(FaultInj_Context_t *ctx);
+
 /**
  * @brief Initialize fault injection framework
  */
 void FaultInj_Init(void);
 
+/**
+ * @brief Set the campaign seed
+ *
+ * Each fault draws from its own stream derived from the seed and its
+ * fault ID, so a fault's trigger pattern depends only on the seed and on
+ * how many times its own hook has run. Faults already configured restart
+ * their streams. The seed survives FaultInj_Init.
+ *
+ * @param seed Campaign seed (e.g. scenario index)
+ */
+void FaultInj_SetSeed(uint64_t seed);
+
+/**
+ * @brief Get the campaign seed
+ */
+uint64_t FaultInj_GetSeed(void);
+
 /**
  * @brief Enable a specific fault
  *
@@ -117,6 +238,18 @@ boolean FaultInj_IsEnabled(FaultId_t fault_id);
  */
 Std_ReturnType FaultInj_Configure(const FaultConfig_t *config);
 
+/**
+ * @brief Set the bit error model of FAULT_WEAR_BITFLIP
+ *
+ * The fault still has to be enabled (FaultInj_Configure/FaultInj_Enable);
+ * its probability_percent is not used, trigger_count limits the reads
+ * that get errors. The model survives FaultInj_ResetAll, not FaultInj_Init.
+ *
+ * @param model Model (NULL = no errors)
+ * @return E_NOT_OK if exponent is above 8
+ */
+Std_ReturnType FaultInj_SetWearModel(const FaultWearModel_t *model);
+
 /**
  * @brief Get fault statistics
  *
@@ -135,6 +268,45 @@ void FaultInj_ResetStats(void);
  */
 void FaultInj_ResetAll(void);
 
+/**
+ * @brief Map an EEPROM address range to a block
+ *
+ * Address-based hooks of a fault with a target_block_id only fire for
+ * addresses inside that block's ranges. NvM_RegisterBlock maps each
+ * block's slots. Ranges are EEPROM (logical) addresses; with MemIf wear
+ * leveling enabled, a remapped slot is no longer found at its address.
+ *
+ * @param block_id Block ID
+ * @param address First address of the range
+ * @param length Range length in bytes
+ * @return E_OK on success, E_NOT_OK if the range is empty, overlaps
+ *         another range or the index is full
+ */
+Std_ReturnType FaultInj_MapRange(uint8_t block_id, uint32_t address, uint32_t length);
+
+/**
+ * @brief Remove every range mapped to a block
+ *
+ * @param block_id Block ID
+ */
+void FaultInj_UnmapBlock(uint8_t block_id);
+
+/**
+ * @brief Remove all mapped ranges
+ *
+ * FaultInj_Init and FaultInj_ResetAll keep the index; it follows the
+ * block layout, not the fault configuration.
+ */
+void FaultInj_ClearRanges(void);
+
+/**
+ * @brief Find the block owning an address (O(log n))
+ *
+ * @param address EEPROM address
+ * @return Block ID, or FAULT_INJ_ALL_BLOCKS if no range covers the address
+ */
+uint8_t FaultInj_LookupBlock(uint32_t address);
+
 /**
  * @brief Hook: Called before EEPROM read
  *
@@ -147,11 +319,12 @@ boolean FaultInj_HookBeforeRead(uint32_t address, uint32_t length);
 /**
  * @brief Hook: Called after EEPROM read
  *
+ * @param address EEPROM address
  * @param data Data buffer (can be modified to inject bit flip)
  * @param length Data length
  * @return TRUE if fault was injected
  */
-boolean FaultInj_HookAfterRead(uint8_t *data, uint32_t length);
+boolean FaultInj_HookAfterRead(uint32_t address, uint8_t *data, uint32_t length);
 
 /**
  * @brief Hook: Called before EEPROM write
@@ -181,16 +354,24 @@ boolean FaultInj_HookAfterWrite(uint32_t address);
 boolean FaultInj_HookCrc(const uint8_t *data, uint32_t length, uint16_t *crc);
 
 /**
- * @brief Hook: Called for write verification
+ * @brief Hook: Called for 32-bit CRC calculation
+ *
+ * @param data Input data
+ * @param length Data length
+ * @param crc Calculated CRC (can be modified)
+ * @return TRUE if CRC was modified
+ */
+boolean FaultInj_HookCrc32(const uint8_t *data, uint32_t length, uint32_t *crc);
+
+/**
+ * @brief Hook: Called by Eep_Verify after a matching compare
  *
  * @param address EEPROM address
  * @param expected_data Expected data
- * @param actual_data Actual read-back data (can be modified)
  * @param length Data length
  * @return TRUE if verification should fail
  */
-boolean FaultInj_HookVerify(uint32_t address, const uint8_t *expected_data,
-                            uint8_t *actual_data, uint32_t length);
+boolean FaultInj_HookVerify(uint32_t address, const uint8_t *expected_data, uint32_t length);
 
 /**
  * @brief Hook: Called before RAM mirror read
@@ -1,12 +1,19 @@
 /**
  * @file logging.h
  * @brief Logging interface for debugging and diagnostics
+ *
+ * - Compile-time floor: levels below LOG_MIN_LEVEL compile to dead code
+ *   (make LOG_MIN_LEVEL=2 drops TRACE/DEBUG from the hot paths)
+ * - Runtime level checked inline, so filtered messages cost one load
+ * - Binary mode: the format pointer and raw arguments go into a per-thread
+ *   lock-free ring; Log_Flush formats them later
  */
 
 #ifndef LOGGING_H
 #define LOGGING_H
 
 #include <stdio.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -24,6 +31,54 @@ typedef enum {
     LOG_LEVEL_FATAL
 } LogLevel_t;
 
+/**
+ * @brief Output mode
+ */
+typedef enum {
+    LOG_MODE_TEXT = 0,      /**< Format and write to stderr on every call */
+    LOG_MODE_BINARY         /**< Record into the calling thread's ring */
+} LogMode_t;
+
+/**
+ * @brief Lowest level compiled in (numeric LogLevel_t value)
+ *
+ * Messages below it are removed at compile time; their arguments are
+ * never evaluated.
+ */
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 0
+#endif
+
+/**
+ * @brief Binary mode limits
+ */
+#define LOG_BINARY_MAX_THREADS  16U     /**< Rings (threads logging at once) */
+#define LOG_BINARY_RING_SIZE    512U    /**< Records per ring (power of 2) */
+#define LOG_BINARY_MAX_ARGS     8U      /**< Arguments kept per record */
+#define LOG_BINARY_STRING_BYTES 44U     /**< %s bytes kept per record */
+
+/**
+ * @brief Binary mode statistics
+ */
+typedef struct {
+    uint64_t recorded;      /**< Records written to rings */
+    uint64_t flushed;       /**< Records formatted by Log_Flush */
+    uint64_t dropped;       /**< Records lost to a full ring or no free ring */
+    uint64_t truncated;     /**< Records whose arguments did not all fit */
+} LogBinaryStats_t;
+
+/**
+ * @brief Current runtime level (read it through LOG_ENABLED)
+ */
+extern LogLevel_t Log_CurrentLevel;
+
+/**
+ * @brief TRUE if a message at this level would be emitted
+ */
+#define LOG_ENABLED(level) \
+    ((int)(level) >= LOG_MIN_LEVEL && \
+     (level) >= __atomic_load_n(&Log_CurrentLevel, __ATOMIC_RELAXED))
+
 /**
  * @brief Set global log level
  *
@@ -47,15 +102,55 @@ LogLevel_t Log_GetLevel(void);
  */
 void Log_Message(LogLevel_t level, const char *format, ...);
 
+/**
+ * @brief Select text or binary output
+ *
+ * In binary mode the format string must outlive the flush (string
+ * literals, as the LOG_* macros pass). Switching back to text mode
+ * flushes pending records. Pending records are also flushed at exit.
+ *
+ * @param mode Output mode
+ */
+void Log_SetMode(LogMode_t mode);
+
+/**
+ * @brief Get the output mode
+ */
+LogMode_t Log_GetMode(void);
+
+/**
+ * @brief Format all pending binary records, oldest first across threads
+ *
+ * Safe to call while other threads keep logging; one flush runs at a time.
+ *
+ * @param stream Output stream (NULL = stderr)
+ * @return Number of records written
+ */
+uint32_t Log_Flush(FILE *stream);
+
+/**
+ * @brief Get binary mode statistics
+ *
+ * @param stats Pointer to statistics structure
+ */
+void Log_GetBinaryStats(LogBinaryStats_t *stats);
+
 /**
  * @brief Convenience macros for logging
  */
-#define LOG_TRACE(fmt, ...) Log_Message(LOG_LEVEL_TRACE, "[TRACE] " fmt "\n", ##__VA_ARGS__)
-#define LOG_DEBUG(fmt, ...) Log_Message(LOG_LEVEL_DEBUG, "[DEBUG] " fmt "\n", ##__VA_ARGS__)
-#define LOG_INFO(fmt, ...)  Log_Message(LOG_LEVEL_INFO,  "[INFO] " fmt "\n", ##__VA_ARGS__)
-#define LOG_WARN(fmt, ...)  Log_Message(LOG_LEVEL_WARN,  "[WARN] " fmt "\n", ##__VA_ARGS__)
-#define LOG_ERROR(fmt, ...) Log_Message(LOG_LEVEL_ERROR, "[ERROR] " fmt "\n", ##__VA_ARGS__)
-#define LOG_FATAL(fmt, ...) Log_Message(LOG_LEVEL_FATAL, "[FATAL] " fmt "\n", ##__VA_ARGS__)
+#define LOG_AT(level, tag, fmt, ...) \
+    do { \
+        if (LOG_ENABLED(level)) { \
+            Log_Message((level), tag fmt "\n", ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define LOG_TRACE(fmt, ...) LOG_AT(LOG_LEVEL_TRACE, "[TRACE] ", fmt, ##__VA_ARGS__)
+#define LOG_DEBUG(fmt, ...) LOG_AT(LOG_LEVEL_DEBUG, "[DEBUG] ", fmt, ##__VA_ARGS__)
+#define LOG_INFO(fmt, ...)  LOG_AT(LOG_LEVEL_INFO,  "[INFO] ", fmt, ##__VA_ARGS__)
+#define LOG_WARN(fmt, ...)  LOG_AT(LOG_LEVEL_WARN,  "[WARN] ", fmt, ##__VA_ARGS__)
+#define LOG_ERROR(fmt, ...) LOG_AT(LOG_LEVEL_ERROR, "[ERROR] ", fmt, ##__VA_ARGS__)
+#define LOG_FATAL(fmt, ...) LOG_AT(LOG_LEVEL_FATAL, "[FATAL] ", fmt, ##__VA_ARGS__)
 
 #ifdef __cplusplus
 }
@@ -23,10 +23,44 @@ extern "C" {
  */
 typedef enum {
     MEMIF_DEVICE_EEPROM = 0,    /**< EEPROM device */
-    MEMIF_DEVICE_FLASH = 1,      /**< Flash device (future) */
-    MEMIF_DEVICE_RAM = 2         /**< RAM device (future) */
+    MEMIF_DEVICE_FLASH = 1,      /**< Emulated flash (erase-before-write) */
+    MEMIF_DEVICE_RAM = 2         /**< Emulated RAM (overwrite in place) */
 } MemIf_DeviceType_t;
 
+/**
+ * @brief Device identifier (index into the MemIf device table)
+ */
+typedef uint8_t MemIf_DeviceIdType;
+
+/**
+ * @brief Maximum number of devices in the device table
+ */
+#define MEMIF_MAX_DEVICES 4U
+
+/**
+ * @brief EEPROM device registered by MemIf_Init
+ */
+#define MEMIF_DEVICE_ID_EEPROM 0U
+
+/**
+ * @brief Device configuration
+ *
+ * Each device owns the address range [base_address, base_address +
+ * size_bytes) of the MemIf address space, has its own job slot and its own
+ * timing model. For MEMIF_DEVICE_EEPROM geometry and timing come from the
+ * EEPROM driver and only base_address is used.
+ */
+typedef struct {
+    MemIf_DeviceType_t type;       /**< Device kind */
+    uint32_t base_address;         /**< Start in MemIf address space */
+    uint32_t size_bytes;           /**< Device capacity */
+    uint32_t page_size;            /**< Program granularity */
+    uint32_t block_size;           /**< Erase granularity */
+    uint32_t read_delay_us;        /**< Read delay per byte */
+    uint32_t write_delay_ms;       /**< Program delay per page */
+    uint32_t erase_delay_ms;       /**< Erase delay per block */
+} MemIf_DeviceConfig_t;
+
 /**
  * @brief MemIf job status
  */
@@ -47,18 +81,62 @@ typedef enum {
     MEMIF_JOB_ERASE = 2
 } MemIf_JobType_t;
 
+struct MemIf_Job_s;
+
+/**
+ * @brief Job end notification
+ *
+ * Called from MemIf_MainFunction (or MemIf_CancelJob) once the job has
+ * left MEMIF_JOB_PENDING; job->status holds the final state.
+ */
+typedef void (*MemIf_JobCallback_t)(const struct MemIf_Job_s *job, void *user_ctx);
+
 /**
  * @brief MemIf job descriptor
  */
-typedef struct {
+typedef struct MemIf_Job_s {
     MemIf_JobType_t job_type;
     uint32_t address;
     uint8_t *data_ptr;
     uint32_t length;
     MemIf_JobStatus_t status;
     MemIf_DeviceType_t device;
+    /* Asynchronous execution state */
+    uint32_t progress;             /**< Bytes completed so far */
+    uint32_t submit_time_ms;       /**< Virtual time of submission */
+    uint32_t complete_time_ms;     /**< Virtual time of completion */
+    uint64_t next_step_us;         /**< Virtual time the current step finishes */
+    MemIf_JobCallback_t callback;  /**< End notification (may be NULL) */
+    void *user_ctx;                /**< Passed to callback */
 } MemIf_Job_t;
 
+/**
+ * @brief MemIf instance: device table, job slots and wear leveling state
+ */
+typedef struct MemIf_Context MemIf_Context_t;
+
+/**
+ * @brief Create a context holding only the EEPROM device (as before MemIf_Init)
+ *
+ * @return NULL if out of memory
+ */
+MemIf_Context_t* MemIf_CreateContext(void);
+
+/**
+ * @brief Destroy a context and its emulated devices (must not be bound on any thread)
+ */
+void MemIf_DestroyContext(MemIf_Context_t *ctx);
+
+/**
+ * @brief Make a context current for the calling thread
+ *
+ * Device 0 is the EEPROM context bound on the same thread (Eep_BindContext).
+ *
+ * @param ctx Context, NULL for the default context
+ * @return The previous binding (NULL = default context)
+ */
+MemIf_Context_t* MemIf_BindContext(MemIf_Context_t *ctx);
+
 /**
  * @brief Initialize MemIf layer
  *
@@ -95,10 +173,161 @@ Std_ReturnType MemIf_Write(uint32_t address, const uint8_t *data_buffer, uint32_
  */
 Std_ReturnType MemIf_Erase(uint32_t address, uint32_t length);
 
+/**
+ * @brief Compare device content with expected data
+ *
+ * EEPROM devices compare in the driver (Eep_Verify); nothing is read
+ * back into a host buffer.
+ *
+ * @param address Device address
+ * @param expected_data Data the range should hold
+ * @param length Number of bytes to compare
+ * @return E_OK if the content matches, E_NOT_OK on mismatch or failure
+ */
+Std_ReturnType MemIf_Verify(uint32_t address, const uint8_t *expected_data, uint32_t length);
+
+/**
+ * @brief One segment of a vectored access (MemIf_ReadV / MemIf_WriteV)
+ *
+ * As with POSIX iovec the buffer is not const: MemIf_WriteV only reads it.
+ */
+typedef struct {
+    uint32_t address;              /**< Device address of the segment */
+    void *buffer;                  /**< Destination (ReadV) or source (WriteV) */
+    uint32_t length;               /**< Segment length in bytes */
+} MemIf_IoVec_t;
+
+/**
+ * @brief Segments passed to the EEPROM driver per vectored command
+ *
+ * Longer vectors (or segments split at wear-leveled slot boundaries)
+ * are issued as several commands.
+ */
+#define MEMIF_IOV_MAX 48U
+
+/**
+ * @brief Read several segments, e.g. a block's data and its CRC, as one request
+ *
+ * EEPROM segments go to the driver as one command (Eep_ReadV); segments
+ * on other devices are copied directly.
+ *
+ * @param iov Segments
+ * @param count Number of segments
+ * @return E_OK if every segment was read
+ */
+Std_ReturnType MemIf_ReadV(const MemIf_IoVec_t *iov, uint32_t count);
+
+/**
+ * @brief Program several segments as one request
+ *
+ * Each segment follows the MemIf_Write rules. EEPROM segments go to the
+ * driver as one command (Eep_WriteV), which checks them all before
+ * programming any.
+ *
+ * @param iov Segments in programming order
+ * @param count Number of segments
+ * @return E_OK if every segment was programmed
+ */
+Std_ReturnType MemIf_WriteV(const MemIf_IoVec_t *iov, uint32_t count);
+
+/**
+ * @brief Submit an asynchronous read job
+ *
+ * Routed by address to the owning device's job slot. Returns
+ * immediately; the job advances page by page in
+ * MemIf_MainFunction according to the device read delay in virtual time.
+ *
+ * @param address Device address
+ * @param data_buffer Buffer to store read data (must stay valid until completion)
+ * @param length Number of bytes to read
+ * @param callback End notification (may be NULL)
+ * @param user_ctx Passed to callback
+ * @return E_OK if accepted, E_NOT_OK if the device is busy or the range invalid
+ */
+Std_ReturnType MemIf_SubmitRead(uint32_t address, uint8_t *data_buffer, uint32_t length,
+                                MemIf_JobCallback_t callback, void *user_ctx);
+
+/**
+ * @brief Submit an asynchronous write job (one page per write_delay_ms)
+ *
+ * @param address Device address (page-aligned)
+ * @param data_buffer Data to write (must stay valid until completion)
+ * @param length Number of bytes (multiple of page size)
+ * @param callback End notification (may be NULL)
+ * @param user_ctx Passed to callback
+ * @return E_OK if accepted, E_NOT_OK if busy or invalid
+ */
+Std_ReturnType MemIf_SubmitWrite(uint32_t address, const uint8_t *data_buffer, uint32_t length,
+                                 MemIf_JobCallback_t callback, void *user_ctx);
+
+/**
+ * @brief Submit an asynchronous erase job (one block per erase_delay_ms)
+ *
+ * @param address Block start address
+ * @param length Bytes to erase (rounded up to whole blocks)
+ * @param callback End notification (may be NULL)
+ * @param user_ctx Passed to callback
+ * @return E_OK if accepted, E_NOT_OK if busy or invalid
+ */
+Std_ReturnType MemIf_SubmitErase(uint32_t address, uint32_t length,
+                                 MemIf_JobCallback_t callback, void *user_ctx);
+
+/**
+ * @brief Get the job currently (or last) processed
+ *
+ * @return Pointer to the most recently submitted job
+ */
+const MemIf_Job_t* MemIf_GetCurrentJob(void);
+
+/**
+ * @brief Add an emulated device to the device table
+ *
+ * Must be called after MemIf_Init. The address range must not overlap an
+ * existing device. Only one EEPROM device exists (registered by MemIf_Init).
+ *
+ * @param config Device configuration
+ * @param device_id Receives the assigned ID (may be NULL)
+ * @return E_OK on success, E_NOT_OK if full, overlapping or invalid
+ */
+Std_ReturnType MemIf_AddDevice(const MemIf_DeviceConfig_t *config, MemIf_DeviceIdType *device_id);
+
+/**
+ * @brief Find the device owning an address
+ *
+ * @param address MemIf address
+ * @param device_id Receives the device ID
+ * @return E_OK if a device owns the address
+ */
+Std_ReturnType MemIf_GetDeviceForAddress(uint32_t address, MemIf_DeviceIdType *device_id);
+
+/**
+ * @brief Get job status of one device
+ *
+ * @param device_id Device ID
+ * @return Job status (MEMIF_JOB_FAILED for an unknown device)
+ */
+MemIf_JobStatus_t MemIf_GetDeviceJobStatus(MemIf_DeviceIdType device_id);
+
+/**
+ * @brief Get the job slot of one device
+ *
+ * @param device_id Device ID
+ * @return Job descriptor, or NULL for an unknown device
+ */
+const MemIf_Job_t* MemIf_GetDeviceJob(MemIf_DeviceIdType device_id);
+
+/**
+ * @brief Cancel the pending job of one device
+ *
+ * @param device_id Device ID
+ * @return E_OK if a job was canceled
+ */
+Std_ReturnType MemIf_CancelDeviceJob(MemIf_DeviceIdType device_id);
+
 /**
  * @brief Get current job status
  *
- * @return Current job status
+ * @return Status of the most recently submitted job
  */
 MemIf_JobStatus_t MemIf_GetJobStatus(void);
 
@@ -110,7 +339,7 @@ MemIf_JobStatus_t MemIf_GetJobStatus(void);
 Std_ReturnType MemIf_GetJobResult(void);
 
 /**
- * @brief Cancel current job
+ * @brief Cancel current job (the most recently submitted one)
  *
  * @return E_OK on success, E_NOT_OK on failure
  */
@@ -119,10 +348,170 @@ Std_ReturnType MemIf_CancelJob(void);
 /**
  * @brief Main function for MemIf (called by scheduler)
  *
- * This function processes pending jobs and updates job status
+ * Advances the pending job of every device by each step whose virtual
+ * completion time has passed, and invokes the end notification when a job
+ * finishes. Devices progress independently, so jobs overlap in time.
  */
 void MemIf_MainFunction(void);
 
+/* ============================================================================
+ * EEPROM Wear Leveling
+ * ============================================================================ */
+
+/**
+ * @brief Maximum leveled slots (logical + spare)
+ */
+#define MEMIF_WL_MAX_SLOTS 128U
+
+/**
+ * @brief Metadata slots kept after the leveled slots (ping-pong)
+ */
+#define MEMIF_WL_META_SLOTS 2U
+
+/**
+ * @brief Buckets of a wear histogram
+ */
+#define MEMIF_WEAR_HISTOGRAM_BUCKETS 16U
+
+/**
+ * @brief Wear leveling configuration
+ *
+ * The leveled range starts at base_address (EEPROM erase block aligned)
+ * and spans logical_slots + spare_slots + MEMIF_WL_META_SLOTS erase
+ * blocks. Callers see logical_slots blocks at
+ * [base_address, base_address + logical_slots * block_size); the spare
+ * and metadata blocks behind them are reserved and cannot be accessed.
+ */
+typedef struct {
+    uint32_t base_address;         /**< First leveled erase block */
+    uint8_t logical_slots;         /**< Erase blocks visible to callers */
+    uint8_t spare_slots;           /**< Extra physical blocks in the rotation (>= 1) */
+    uint32_t threshold;            /**< Erase count lead over the least worn spare that triggers a remap */
+} MemIf_WearLevelConfig_t;
+
+/**
+ * @brief Wear leveling statistics
+ */
+typedef struct {
+    uint32_t remaps;               /**< Logical slots moved to a spare block */
+    uint32_t meta_writes;          /**< Slot map records programmed */
+    uint32_t meta_erases;          /**< Metadata block erases */
+} MemIf_WearLevelStats_t;
+
+/**
+ * @brief Erase count distribution over all EEPROM erase blocks
+ *
+ * Bucket i counts blocks with i * bucket_width <= erase count <
+ * (i + 1) * bucket_width; the last bucket also holds every higher count.
+ */
+typedef struct {
+    uint32_t bucket_width;
+    uint32_t buckets[MEMIF_WEAR_HISTOGRAM_BUCKETS];
+    uint32_t block_count;          /**< Erase blocks counted */
+    uint32_t min_erase_count;
+    uint32_t max_erase_count;
+    uint32_t total_erase_count;
+} MemIf_WearHistogram_t;
+
+/**
+ * @brief Enable dynamic wear leveling on an EEPROM range
+ *
+ * Loads the slot map from the newest valid metadata record, or starts
+ * from the identity map (and records it) on a range without one. From
+ * then on every erase of a logical slot whose block leads the least worn
+ * spare by threshold erases is redirected to that spare, and the map is
+ * persisted before the slot is used again. Only erased slots move: data
+ * that is never rewritten stays where it is.
+ *
+ * Must be called after MemIf_Init (which disables wear leveling) and
+ * with the same configuration on every start.
+ *
+ * @param config Leveled range
+ * @return E_OK on success, E_NOT_OK on an invalid range or device error
+ */
+Std_ReturnType MemIf_EnableWearLeveling(const MemIf_WearLevelConfig_t *config);
+
+/**
+ * @brief Stop translating addresses (the map stays on the device)
+ */
+void MemIf_DisableWearLeveling(void);
+
+/**
+ * @brief Get wear leveling statistics since MemIf_EnableWearLeveling
+ *
+ * @return E_NOT_OK if stats is NULL or wear leveling is disabled
+ */
+Std_ReturnType MemIf_GetWearLevelStats(MemIf_WearLevelStats_t *stats);
+
+/**
+ * @brief Physical EEPROM address currently backing a logical address
+ *
+ * Addresses outside the leveled range map to themselves.
+ *
+ * @return E_NOT_OK for a reserved spare/metadata address
+ */
+Std_ReturnType MemIf_WearLevelTranslate(uint32_t address, uint32_t *physical);
+
+/**
+ * @brief Build the erase count histogram of the EEPROM
+ *
+ * @param bucket_width Erase counts per bucket (> 0)
+ * @param histogram Result
+ * @return E_NOT_OK on invalid arguments or uninitialized EEPROM
+ */
+Std_ReturnType MemIf_GetWearHistogram(uint32_t bucket_width, MemIf_WearHistogram_t *histogram);
+
+/* ============================================================================
+ * Accelerated Aging
+ * ============================================================================ */
+
+/**
+ * @brief Erase rate of one EEPROM erase block in a workload profile
+ */
+typedef struct {
+    uint32_t address;              /**< Erase block (block aligned; a logical slot if leveled) */
+    uint32_t cycles_per_year;      /**< Erases of the block per year of the workload */
+} MemIf_AgingRate_t;
+
+/**
+ * @brief Workload profile to fast-forward
+ */
+typedef struct {
+    const MemIf_AgingRate_t *rates;
+    uint32_t rate_count;
+    uint32_t days;                 /**< Workload period skipped */
+} MemIf_AgingProfile_t;
+
+/**
+ * @brief What an aging run did
+ */
+typedef struct {
+    uint32_t erases;               /**< Erase cycles added (remaps and metadata included) */
+    uint32_t remaps;               /**< Wear leveling remaps replayed */
+    uint32_t worn_out_blocks;      /**< Erase blocks at their endurance limit afterwards */
+} MemIf_AgingResult_t;
+
+/**
+ * @brief Fast-forward the wear of a workload profile
+ *
+ * Advances erase counts in bulk instead of erasing: a block erased
+ * cycles_per_year times a year gains cycles_per_year * days / 365 cycles
+ * (saturating at the device endurance). Leveled slots replay the wear
+ * leveling policy event by event (one step per remap, not per erase):
+ * rates are spread evenly over the period, each slot moves to the least
+ * worn spare when it leads it by threshold, the metadata blocks age with
+ * the map records, and the final map is persisted. Moved slots keep their
+ * contents. Nothing is programmed otherwise, so a lifetime study ages the
+ * device to the start of its last window, enables FAULT_WEAR_BITFLIP with
+ * a FaultWearModel_t, and runs the exact workload only for that window.
+ *
+ * @param profile Workload (every address is checked before anything changes)
+ * @param result Receives totals (can be NULL)
+ * @return E_NOT_OK on invalid arguments, unaligned or reserved addresses,
+ *         or a device error while moving a slot
+ */
+Std_ReturnType MemIf_Age(const MemIf_AgingProfile_t *profile, MemIf_AgingResult_t *result);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,253 @@
+/**
+ * @file metrics.h
+ * @brief Unified latency metrics for the Eep/MemIf/NvM stack
+ *
+ * - 固定桶对数-线性 (HDR风格) 直方图: 每个2的幂区间 METRICS_SUB_BUCKETS 个子桶
+ * - 每个样本同时记录主机纳秒与虚拟微秒
+ * - 序列: 每种EEPROM操作, 每种MemIf/NvM作业, 每个Block的读/写
+ * - 按线程分片, relaxed原子更新, 无锁; 快照时合并
+ * - 计数器源: 各模块Init时注册 (Eep/NvM/调度器诊断计数), 导出时一并输出
+ * - 导出: JSON 与 Prometheus 文本格式
+ * - 默认关闭: Metrics_Enable 开启; -DMETRICS_DISABLED (make METRICS=0) 编译期移除
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "common_types.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Latency series
+ */
+typedef enum {
+    METRIC_EEP_READ = 0,        /**< Eep_Read */
+    METRIC_EEP_WRITE,           /**< Eep_Write */
+    METRIC_EEP_ERASE,           /**< Eep_Erase */
+    METRIC_EEP_VERIFY,          /**< Eep_Verify */
+    METRIC_MEMIF_READ,          /**< MemIf read job, submit to completion */
+    METRIC_MEMIF_WRITE,         /**< MemIf write job, submit to completion */
+    METRIC_MEMIF_ERASE,         /**< MemIf erase job, submit to completion */
+    METRIC_NVM_READ,            /**< NvM_ReadBlock job */
+    METRIC_NVM_WRITE,           /**< NvM_WriteBlock job */
+    METRIC_NVM_READ_ALL,        /**< NvM_ReadAll pass */
+    METRIC_NVM_WRITE_ALL,       /**< NvM_WriteAll pass */
+    METRIC_NVM_WRITE_BATCH,     /**< NvM_WriteBlocks batch */
+    METRIC_NVM_IMMEDIATE,       /**< Any job of an immediate block (also in its own series) */
+    METRIC_SERIES_COUNT
+} Metrics_SeriesId_t;
+
+/**
+ * @brief Per-block series
+ */
+typedef enum {
+    METRIC_BLOCK_READ = 0,
+    METRIC_BLOCK_WRITE,
+    METRIC_BLOCK_OP_COUNT
+} Metrics_BlockOp_t;
+
+/**
+ * @brief Clock of a histogram
+ *
+ * Eep series measure the call (host) and the modelled device latency
+ * (virtual). MemIf series measure from submission to completion on both
+ * clocks. NvM series measure host time from dequeue and virtual time from
+ * submission. The virtual clock counts milliseconds, so MemIf and NvM
+ * virtual values are multiples of 1000.
+ */
+typedef enum {
+    METRIC_CLOCK_HOST_NS = 0,
+    METRIC_CLOCK_VIRTUAL_US,
+    METRIC_CLOCK_COUNT
+} Metrics_Clock_t;
+
+/**
+ * @brief Export formats
+ */
+typedef enum {
+    METRICS_FORMAT_JSON = 0,
+    METRICS_FORMAT_PROMETHEUS
+} Metrics_Format_t;
+
+/**
+ * @brief Histogram geometry
+ *
+ * Values below METRICS_SUB_BUCKETS get a bucket each; above that, every
+ * power-of-two range is split into METRICS_SUB_BUCKETS buckets (relative
+ * error at most 1/METRICS_SUB_BUCKETS). Values past the last range are
+ * counted in the last bucket.
+ */
+#define METRICS_SUB_BUCKET_BITS 3U
+#define METRICS_SUB_BUCKETS     (1U << METRICS_SUB_BUCKET_BITS)
+#define METRICS_RANGES          40U
+#define METRICS_BUCKETS         ((METRICS_RANGES + 1U) * METRICS_SUB_BUCKETS)
+
+/**
+ * @brief Counter sources and counters per source
+ */
+#define METRICS_MAX_SOURCES      8U
+#define METRICS_MAX_COUNTERS     32U
+
+/**
+ * @brief Latency histogram (one clock)
+ */
+typedef struct {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;               /**< UINT64_MAX while empty */
+    uint64_t max;
+    uint32_t buckets[METRICS_BUCKETS];
+} Metrics_Histogram_t;
+
+/**
+ * @brief Summary of one histogram
+ */
+typedef struct {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;               /**< 0 while empty */
+    uint64_t max;
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+    uint64_t p999;
+} Metrics_Summary_t;
+
+/**
+ * @brief Merged view of a series
+ */
+typedef struct {
+    Metrics_Histogram_t hist[METRIC_CLOCK_COUNT];
+    Metrics_Summary_t summary[METRIC_CLOCK_COUNT];
+} Metrics_Snapshot_t;
+
+/**
+ * @brief Named counter reported by a source
+ */
+typedef struct {
+    const char *name;
+    uint64_t value;
+} Metrics_Counter_t;
+
+/**
+ * @brief Counter source: fill up to max counters, return the number filled
+ */
+typedef uint32_t (*Metrics_CounterSource_t)(Metrics_Counter_t *counters, uint32_t max);
+
+/**
+ * @brief Recording on/off (read it through METRICS_ENABLED)
+ */
+extern uint32_t Metrics_EnabledFlag;
+
+/**
+ * @brief TRUE if call sites should time their work
+ *
+ * Building with -DMETRICS_DISABLED (make METRICS=0) makes it a constant
+ * FALSE, so the timing code is compiled out.
+ */
+#ifdef METRICS_DISABLED
+#define METRICS_ENABLED() (FALSE)
+#else
+#define METRICS_ENABLED() (__atomic_load_n(&Metrics_EnabledFlag, __ATOMIC_RELAXED) != 0U)
+#endif
+
+/**
+ * @brief Turn recording on or off (off at startup)
+ *
+ * @param enable TRUE to record
+ */
+void Metrics_Enable(boolean enable);
+
+/**
+ * @brief Host monotonic time in nanoseconds
+ */
+uint64_t Metrics_HostNs(void);
+
+/**
+ * @brief Record one sample of a series
+ *
+ * @param series Series
+ * @param host_ns Host duration in nanoseconds
+ * @param virtual_us Virtual duration in microseconds
+ */
+void Metrics_Record(Metrics_SeriesId_t series, uint64_t host_ns, uint64_t virtual_us);
+
+/**
+ * @brief Record one sample of a block's series
+ *
+ * The block's histograms are allocated on its first sample.
+ *
+ * @param block_id Block ID
+ * @param op Operation
+ * @param host_ns Host duration in nanoseconds
+ * @param virtual_us Virtual duration in microseconds
+ */
+void Metrics_RecordBlock(uint8_t block_id, Metrics_BlockOp_t op, uint64_t host_ns,
+                         uint64_t virtual_us);
+
+/**
+ * @brief Merge a series' shards and summarize them
+ *
+ * @param series Series
+ * @param snapshot Output
+ * @return E_OK on success
+ */
+Std_ReturnType Metrics_GetSnapshot(Metrics_SeriesId_t series, Metrics_Snapshot_t *snapshot);
+
+/**
+ * @brief Merge a block series' shards and summarize them
+ *
+ * @param block_id Block ID
+ * @param op Operation
+ * @param snapshot Output
+ * @return E_OK on success, E_NOT_OK if the block has no samples
+ */
+Std_ReturnType Metrics_GetBlockSnapshot(uint8_t block_id, Metrics_BlockOp_t op,
+                                        Metrics_Snapshot_t *snapshot);
+
+/**
+ * @brief Value at a quantile (upper bound of the bucket holding it)
+ *
+ * @param hist Histogram
+ * @param per_million Quantile in millionths (500000 = p50)
+ * @return Value, clamped to the histogram's max; 0 if empty
+ */
+uint64_t Metrics_Percentile(const Metrics_Histogram_t *hist, uint32_t per_million);
+
+/**
+ * @brief Clear every histogram (registered sources stay)
+ */
+void Metrics_Reset(void);
+
+/**
+ * @brief Register a counter source (once per name; later calls replace it)
+ *
+ * @param name Source name, used as the counter prefix in exports
+ * @param source Callback
+ * @return E_OK on success, E_NOT_OK if the table is full
+ */
+Std_ReturnType Metrics_RegisterCounterSource(const char *name, Metrics_CounterSource_t source);
+
+/**
+ * @brief Export every series, block series and counter source
+ *
+ * Like snprintf: output is truncated to size, and the length the full
+ * export needs is returned.
+ *
+ * @param format JSON or Prometheus text
+ * @param buffer Output (may be NULL if size is 0)
+ * @param size Buffer size
+ * @return Length of the full export, excluding the terminator
+ */
+size_t Metrics_Export(Metrics_Format_t format, char *buffer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* METRICS_H */
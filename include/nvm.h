@@ -25,9 +25,19 @@ extern "C" {
 typedef enum {
     NVM_BLOCK_NATIVE = 0,      /**< Single copy block */
     NVM_BLOCK_REDUNDANT = 1,   /**< Redundant block (dual copy) */
-    NVM_BLOCK_DATASET = 2      /**< Dataset block (multi-version) */
+    NVM_BLOCK_DATASET = 2,     /**< Dataset block (multi-version) */
+    NVM_BLOCK_LOG = 3          /**< Records appended to the shared log region */
 } NvM_BlockType_t;
 
+/**
+ * @brief Log region limits (NVM_BLOCK_LOG)
+ *
+ * A record is an 8-byte header, the data and a CRC-32, programmed in
+ * whole pages inside one 1 KB sector.
+ */
+#define NVM_LOG_MAX_SECTORS      32U
+#define NVM_LOG_MAX_BLOCK_SIZE   1012U
+
 /**
  * @brief CRC types
  */
@@ -38,6 +48,37 @@ typedef enum {
     NVM_CRC32 = 3
 } NvM_CrcType_t;
 
+/**
+ * @brief Where the CRC of a slot-based block is programmed
+ *
+ * The CRC always follows the data at eeprom_offset + block_size; the
+ * placement only decides how it is programmed.
+ */
+typedef enum {
+    NVM_CRC_PLACEMENT_PAGE = 0,    /**< Separate padded page (block_size is a page multiple) */
+    NVM_CRC_PLACEMENT_INLINE = 1   /**< In the data's last page: one contiguous program */
+} NvM_CrcPlacementType_t;
+
+/**
+ * @brief Payload compression of a slot-based block
+ *
+ * A compressed copy is one image: 2-byte length header, payload, CRC over
+ * header and payload. Data that does not shrink is stored raw in the same
+ * image, so the slot must hold 2 + block_size + CRC bytes.
+ */
+typedef enum {
+    NVM_COMPRESSION_NONE = 0,
+    NVM_COMPRESSION_RLE = 1        /**< Run-length coding (rle.h) */
+} NvM_CompressionType_t;
+
+/**
+ * @brief RAM mirror concurrency modes
+ */
+typedef enum {
+    NVM_MIRROR_SEQLOCK = 0,    /**< Single buffer, readers retry across writes */
+    NVM_MIRROR_RCU = 1         /**< Multi-version buffers, wait-free readers */
+} NvM_MirrorModeType_t;
+
 /**
  * @brief Block states
  */
@@ -56,9 +97,20 @@ typedef enum {
     NVM_JOB_READ = 0,
     NVM_JOB_WRITE = 1,
     NVM_JOB_READ_ALL = 2,
-    NVM_JOB_WRITE_ALL = 3
+    NVM_JOB_WRITE_ALL = 3,
+    NVM_JOB_WRITE_BATCH = 4     /**< NvM_WriteBlocks; data_ptr is the batch descriptor */
 } NvM_JobType_t;
 
+/**
+ * @brief Maximum number of blocks in one NvM_WriteBlocks call
+ */
+#define NVM_WRITE_BATCH_MAX_BLOCKS 8U
+
+/**
+ * @brief Number of NvM_WriteBlocks batches that can be queued at once
+ */
+#define NVM_WRITE_BATCH_QUEUE_SIZE 4U
+
 /**
  * @brief NvM job descriptor
  */
@@ -82,12 +134,20 @@ typedef struct {
     uint16_t block_size;
     NvM_BlockType_t block_type;
     NvM_CrcType_t crc_type;
+    NvM_CrcPlacementType_t crc_placement;  /**< CRC programming layout */
     uint8_t priority;
     uint8_t is_immediate;
     uint8_t is_write_protected;
+    uint8_t bit_clear_update;            /**< Updates only clear bits: program in place, no erase (NATIVE/REDUNDANT) */
+    uint8_t delta_pages;                 /**< Stored as per-page records, a write appends only changed pages (LOG) */
+    NvM_CompressionType_t compression;   /**< Payload codec; crc_placement is ignored when set (NATIVE/REDUNDANT/DATASET) */
+    uint8_t read_cache;                  /**< ReadBlock completes from the RAM mirror while it matches the device */
     void *ram_mirror_ptr;
+    NvM_MirrorModeType_t mirror_mode;    /**< Concurrency scheme of the block's RAM mirror */
     const uint8_t *rom_block_ptr;
     uint32_t rom_block_size;
+    uint8_t rom_binding;                 /**< A failed read into the RAM mirror binds the block to
+                                              rom_block_ptr instead of copying it (NvM_GetBlockData) */
     uint32_t eeprom_offset;
 
     /* Redundant Block specific fields */
@@ -101,8 +161,62 @@ typedef struct {
 
     NvM_BlockStateType_t state;
     uint32_t erase_count;
+
+    /* Runtime fields (set by NvM_RegisterBlock) */
+    const struct Crc_Descriptor_s *crc_desc;  /**< CRC engine resolved from crc_type */
+
+    /* Dirty tracking (maintained by NvM) */
+    uint8_t persisted_valid;             /**< persisted_crc describes the device copy */
+    uint32_t persisted_crc;              /**< CRC-32C of the data last read/written */
+    uint32_t persisted_generation;       /**< RamMirror_GetGeneration at that time */
+    uint8_t mirror_clean;                /**< RAM mirror was that data and not handed out for stores since */
+
+    /* Slot sequence headers (maintained by NvM, DATASET only) */
+    uint8_t dataset_scanned;             /**< Slot headers read since registration */
+    uint32_t dataset_sequence;           /**< Sequence of the newest slot written or found */
+
+    /* Idle pre-erase (maintained by NvM, DATASET only) */
+    uint8_t pre_erased;                  /**< pre_erased_index is erased and unwritten */
+    uint8_t pre_erased_index;            /**< Dataset slot erased in the background */
+
+    /* ROM default binding (maintained by NvM, rom_binding only) */
+    uint8_t rom_bound;                   /**< Contents are rom_block_ptr; ram_mirror_ptr not filled */
 } NvM_BlockConfig_t;
 
+/**
+ * @brief NvM instance: registry, job queue, mirrors, logs and wait state
+ *
+ * A context drives the Eep/MemIf/scheduler contexts bound on the same
+ * thread; bind all of them to simulate an independent ECU.
+ */
+typedef struct NvM_Context NvM_Context_t;
+
+/**
+ * @brief Create a context (call NvM_Init with it bound)
+ *
+ * @return NULL if out of memory
+ */
+NvM_Context_t* NvM_CreateContext(void);
+
+/**
+ * @brief Destroy a context and what it owns (must not be bound on any thread)
+ *
+ * Bind the Eep/MemIf contexts it used while destroying it: releasing
+ * server state may touch the device.
+ */
+void NvM_DestroyContext(NvM_Context_t *ctx);
+
+/**
+ * @brief Make a context current for the calling thread
+ *
+ * Every NvM call on the thread then uses it, including NvM_WaitJob from
+ * client threads.
+ *
+ * @param ctx Context, NULL for the default context
+ * @return The previous binding (NULL = default context)
+ */
+NvM_Context_t* NvM_BindContext(NvM_Context_t *ctx);
+
 /**
  * @brief NvM initialization
  *
@@ -121,9 +235,20 @@ Std_ReturnType NvM_RegisterBlock(const NvM_BlockConfig_t *block_config);
 /**
  * @brief Read a single block
  *
+ * For a block configured with read_cache, a call on the NvM thread
+ * completes at once from the RAM mirror (copied into nvm_buffer, result
+ * NVM_REQ_OK, end notification) when the mirror is known to equal the
+ * device copy: the block is VALID, its last read into the mirror or
+ * write from the mirror succeeded, the mirror has not changed since and
+ * no write of the block is queued. Writes, failed reads and
+ * NvM_SetDataIndex end that state; a recovered block reads from the
+ * device until rewritten. Changes are tracked without hashing the
+ * mirror: store into it through NvM_GetWritableBlockData or the mirror
+ * write API, not through a saved ram_mirror_ptr.
+ *
  * @param block_id Block ID
  * @param nvm_buffer Buffer to store data
- * @return E_OK on success (job queued), E_NOT_OK on failure
+ * @return E_OK on success (job queued or served from the mirror), E_NOT_OK on failure
  */
 Std_ReturnType NvM_ReadBlock(NvM_BlockIdType block_id, void *nvm_buffer);
 
@@ -136,9 +261,81 @@ Std_ReturnType NvM_ReadBlock(NvM_BlockIdType block_id, void *nvm_buffer);
  */
 Std_ReturnType NvM_WriteBlock(NvM_BlockIdType block_id, const void *nvm_buffer);
 
+/**
+ * @brief Write several blocks as one all-or-nothing commit
+ *
+ * Queues a single job for the whole group. When it runs, every copy is
+ * programmed with one erase of its erase unit, in ascending offset
+ * order, and the blocks' versions, dataset indices and states are
+ * updated only after all copies are on the device. If any copy fails,
+ * the copies already programmed are restored and every block of the
+ * group reports NVM_REQ_NOT_OK with its previous content intact.
+ *
+ * The job runs at the highest priority of its blocks. Buffers must stay
+ * valid until the job results leave NVM_REQ_PENDING.
+ *
+ * @param ids Block IDs (distinct, registered, not write-protected)
+ * @param bufs Data to write, one buffer per block
+ * @param n Number of blocks (1..NVM_WRITE_BATCH_MAX_BLOCKS)
+ * @return E_OK on success (job queued), E_NOT_OK on invalid arguments or
+ *         when NVM_WRITE_BATCH_QUEUE_SIZE batches are already queued
+ */
+Std_ReturnType NvM_WriteBlocks(const NvM_BlockIdType *ids, const void *const *bufs, uint8_t n);
+
+/**
+ * @brief Current contents of a block for reading
+ *
+ * A rom_binding block whose copies all failed is bound to its ROM
+ * default rather than copied into the RAM mirror: its contents are then
+ * rom_block_ptr (requires rom_block_size >= block_size; shorter defaults
+ * are copied as before). Otherwise the RAM mirror.
+ *
+ * @param block_id Block ID
+ * @return Contents (block_size bytes), or NULL if the ID is not registered
+ */
+const void* NvM_GetBlockData(NvM_BlockIdType block_id);
+
+/**
+ * @brief RAM mirror of a block for modification (copy-on-write)
+ *
+ * A block bound to its ROM default is materialized first: the default is
+ * copied into the RAM mirror and the binding ends. Call before storing
+ * into the mirror, not while a job of the block is pending; the mirror
+ * then no longer serves read_cache hits until written or read again.
+ *
+ * @param block_id Block ID
+ * @return RAM mirror, or NULL if the ID is not registered
+ */
+void* NvM_GetWritableBlockData(NvM_BlockIdType block_id);
+
+/**
+ * @brief Program the ROM default of every bound block in one pass
+ *
+ * First-boot and factory initialization: after a ReadAll on a blank or
+ * corrupt device, every block bound to its ROM default (see
+ * NvM_GetBlockData) is written from rom_block_ptr, without copying it
+ * into the RAM mirror. The copies of all blocks are sorted by offset;
+ * erase units that are already blank are not erased again, the others
+ * are erased once each, then every copy is programmed in ascending order
+ * and dataset headers last. Written blocks become VALID (and stay bound
+ * until materialized); a block whose copy fails stays INVALID.
+ *
+ * Runs synchronously on the NvM thread, outside ReadAll/WriteAll.
+ * Write-protected and LOG blocks are skipped.
+ *
+ * @return E_OK if every bound block was written, E_NOT_OK on a failed
+ *         block or when called from another thread or during ReadAll/WriteAll
+ */
+Std_ReturnType NvM_WriteRomDefaults(void);
+
 /**
  * @brief Read all blocks
  *
+ * The pass runs block by block across NvM_MainFunction calls. Before each
+ * block it lets every queued immediate job (ReadBlock, WriteBlock,
+ * WriteBlocks of an immediate block) run, so such a job waits for at most
+ * one block of the pass. The pipelined ReadAll is not interrupted.
+ *
  * @return E_OK on success (job queued), E_NOT_OK on failure
  */
 Std_ReturnType NvM_ReadAll(void);
@@ -146,6 +343,8 @@ Std_ReturnType NvM_ReadAll(void);
 /**
  * @brief Write all blocks
  *
+ * Immediate jobs run between two blocks of the pass, as for NvM_ReadAll.
+ *
  * @return E_OK on success (job queued), E_NOT_OK on failure
  */
 Std_ReturnType NvM_WriteAll(void);
@@ -189,6 +388,76 @@ void NvM_JobEndNotification(NvM_BlockIdType block_id);
  */
 void NvM_JobErrorNotification(NvM_BlockIdType block_id);
 
+/**
+ * @brief NvM_WaitJob/NvM_WaitJobHandle timeout that never expires
+ */
+#define NVM_WAIT_FOREVER 0xFFFFFFFFU
+
+/**
+ * @brief Completion handle of one job
+ *
+ * Taken with NvM_GetJobHandle before the request is submitted; done once
+ * a job of the block has ended (end or error notification) since then.
+ * Block ID 0xFF names ReadAll/WriteAll.
+ */
+typedef struct {
+    NvM_BlockIdType block_id;
+    uint32_t ticket;                /**< Completions of the block when taken */
+} NvM_JobHandle_t;
+
+/**
+ * @brief Wait until the job result of a block is no longer NVM_REQ_PENDING
+ *
+ * Other threads sleep until a job end/error notification wakes them. On
+ * the NvM thread (NvM_Init caller), which would never wake itself, the
+ * call runs NvM_MainFunction until the job is done instead, advancing
+ * virtual time by 1 ms per cycle; there timeout_ms counts virtual time.
+ *
+ * @param block_id Block ID
+ * @param timeout_ms Wall-clock timeout, virtual on the NvM thread (0: check only, NVM_WAIT_FOREVER)
+ * @return E_OK once done (read the outcome with NvM_GetJobResult),
+ *         E_NOT_OK on timeout
+ */
+Std_ReturnType NvM_WaitJob(NvM_BlockIdType block_id, uint32_t timeout_ms);
+
+/**
+ * @brief Take a completion handle for the next job of a block
+ *
+ * @param block_id Block ID (0xFF: ReadAll/WriteAll)
+ * @param handle Output handle
+ * @return E_OK on success, E_NOT_OK if handle is NULL
+ */
+Std_ReturnType NvM_GetJobHandle(NvM_BlockIdType block_id, NvM_JobHandle_t *handle);
+
+/**
+ * @brief Wait until a handle is done (same wakeups as NvM_WaitJob)
+ *
+ * @param handle Handle from NvM_GetJobHandle
+ * @param timeout_ms Wall-clock timeout, virtual on the NvM thread (0: check only, NVM_WAIT_FOREVER)
+ * @return E_OK once done, E_NOT_OK on timeout or NULL handle
+ */
+Std_ReturnType NvM_WaitJobHandle(const NvM_JobHandle_t *handle, uint32_t timeout_ms);
+
+/**
+ * @brief Check a handle without waiting
+ *
+ * @return TRUE once a job of the handle's block has ended since it was taken
+ */
+boolean NvM_JobHandleDone(const NvM_JobHandle_t *handle);
+
+/**
+ * @brief Completion event file descriptor for event loops (Linux eventfd)
+ *
+ * Readable once any job has ended since the last read(); the 8-byte
+ * counter read is the number of completions. Non-blocking, created on
+ * first call and kept for the life of the process. Harnesses running
+ * many simulated ECUs poll all their descriptors, then check handles
+ * or job results.
+ *
+ * @return File descriptor, or -1 if eventfd is unavailable
+ */
+int NvM_GetEventFd(void);
+
 /**
  * @brief Set data index for dataset blocks
  *
@@ -198,6 +467,153 @@ void NvM_JobErrorNotification(NvM_BlockIdType block_id);
  */
 Std_ReturnType NvM_SetDataIndex(NvM_BlockIdType block_id, uint8_t data_index);
 
+/**
+ * @brief Enable or disable write coalescing (disabled after NvM_Init)
+ *
+ * While enabled, repeated NvM_WriteBlock calls for a block that still has
+ * a queued write update that job in place (latest data wins, earliest
+ * submit time kept), and NvM_ReadBlock for such a block completes
+ * immediately from the pending write's buffer.
+ *
+ * @param enable TRUE to enable
+ */
+void NvM_SetWriteCoalescing(boolean enable);
+
+/**
+ * @brief Enable or disable the pipelined ReadAll (disabled after NvM_Init)
+ *
+ * When enabled, ReadAll streams every block's primary copy (data and CRC
+ * in one request) through the asynchronous MemIf engine in ascending
+ * offset order, one request in flight per device so blocks on different
+ * devices load in parallel. Each block's CRC is checked while the next
+ * read is already running; its RAM mirror, job result and end/error
+ * notification are updated as soon as it completes. Blocks whose
+ * primary copy fails are recovered through the normal block-type
+ * handler (backup copy, other datasets, ROM default).
+ *
+ * The pass completes as virtual time advances, across NvM_MainFunction
+ * calls.
+ *
+ * @param enable TRUE to enable
+ */
+void NvM_SetReadAllPipeline(boolean enable);
+
+/**
+ * @brief Enable or disable idle pre-erase of dataset slots (disabled after NvM_Init)
+ *
+ * When enabled, each NvM_MainFunction call that finds the job queue
+ * empty erases the slot the next write of one DATASET block will use
+ * (blocks are visited round-robin). That write then only programs its
+ * pages, which removes the erase time from its latency. The oldest
+ * version is lost at pre-erase time instead of at the next write, so a
+ * read that has to fall back to older versions has one fewer to try.
+ *
+ * Other block types are not affected: NATIVE and REDUNDANT blocks
+ * rewrite the slots they occupy, and LOG sectors are already erased by
+ * the background compactor.
+ *
+ * @param enable TRUE to enable
+ */
+void NvM_SetDatasetPreErase(boolean enable);
+
+/**
+ * @brief Enable or disable device lanes (disabled after NvM_Init)
+ *
+ * When enabled, ReadBlock and WriteBlock jobs of NATIVE blocks
+ * (uncompressed, CRC inline) go through the asynchronous MemIf engine,
+ * one job in flight per device, so jobs on different devices execute in
+ * parallel and throughput grows with the number of devices. A write is
+ * an erase followed by one program of data and CRC, laid out as on the
+ * synchronous path; a read fetches data and CRC in one request and falls
+ * back to the block-type handler if the copy is invalid.
+ *
+ * Lane jobs leave the queue when they start and complete as virtual
+ * time advances, across NvM_MainFunction calls; their device time is not
+ * charged to the call's budget. Other jobs run synchronously as before,
+ * but wait while a lane job is in flight on their block's device.
+ * ReadAll, WriteAll and NvM_WriteBlocks wait for every lane; jobs queued
+ * behind them do not start meanwhile.
+ *
+ * @param enable TRUE to enable
+ */
+void NvM_SetDeviceOverlap(boolean enable);
+
+/**
+ * @brief Place the log region used by NVM_BLOCK_LOG blocks
+ *
+ * Call after NvM_Init and before the first access to a LOG block. The
+ * region is scanned to rebuild the in-RAM index: for every block ID the
+ * valid record with the highest sequence number is current. Torn or
+ * corrupt records are skipped.
+ *
+ * A LOG block write appends a record to erased pages without erasing
+ * anything. Sectors are reclaimed by copying their current records out
+ * and then erasing them: by NvM_MainFunction when the queue is idle, or
+ * by a write that finds no room. One sector is kept free for that, so
+ * size the region for the current records of all LOG blocks plus two
+ * sectors.
+ * eeprom_offset and crc_type of LOG blocks are not used; every record
+ * carries its own CRC-32.
+ *
+ * A LOG block with delta_pages set is stored as 244-byte chunks, one
+ * page each with its own CRC-32. A write compares every chunk with the
+ * CRC cached for its current record and appends only the chunks that
+ * changed; a write that touches nothing programs nothing. An
+ * interrupted write is rolled back to the previous chunks by the scan.
+ *
+ * @param offset Region start (1 KB aligned)
+ * @param sector_count Number of 1 KB sectors (2..NVM_LOG_MAX_SECTORS)
+ * @return E_OK on success
+ */
+Std_ReturnType NvM_SetLogRegion(uint32_t offset, uint8_t sector_count);
+
+/**
+ * @brief Log region statistics
+ */
+typedef struct {
+    uint32_t records_appended;      /**< LOG block writes */
+    uint32_t pages_programmed;      /**< Pages programmed, relocations included */
+    uint32_t records_relocated;     /**< Current records copied out by compaction */
+    uint32_t sectors_erased;        /**< Sectors reclaimed */
+    uint32_t free_sectors;          /**< Erased sectors right now */
+    uint32_t pages_unchanged;       /**< delta_pages chunks left alone (data unchanged) */
+} NvM_LogStats_t;
+
+/**
+ * @brief Get log region statistics
+ *
+ * @param stats Output
+ * @return E_OK on success
+ */
+Std_ReturnType NvM_GetLogStats(NvM_LogStats_t *stats);
+
+/**
+ * @brief Maximum blocks one clean-shutdown checkpoint describes
+ */
+#define NVM_CHECKPOINT_MAX_BLOCKS 37U
+
+/**
+ * @brief Place the clean-shutdown checkpoint (one 1 KB erase unit)
+ *
+ * A WriteAll that stores every block successfully records, for each
+ * block, its active slot, version and data CRC plus a clean flag. The
+ * first block write after that programs a marker page in the region, so
+ * a reset before the next WriteAll leaves the checkpoint stale.
+ *
+ * The record is read and checked once here. While it is clean, ReadAll
+ * loads each matching block with one read of its active copy: no CRC is
+ * recomputed and no backup copy or dataset header is probed. Blocks the
+ * checkpoint does not describe (LOG, compressed, changed configuration,
+ * beyond NVM_CHECKPOINT_MAX_BLOCKS) take the full read path, as do all
+ * blocks when the checkpoint is stale or corrupt.
+ *
+ * Call after registering the blocks and before NvM_ReadAll.
+ *
+ * @param offset Region start (1 KB aligned, not used by any block)
+ * @return E_OK on success
+ */
+Std_ReturnType NvM_SetCheckpointRegion(uint32_t offset);
+
 /**
  * @brief Get diagnostics information
  *
@@ -210,10 +626,94 @@ typedef struct {
     uint32_t total_jobs_retried;
     uint32_t current_queue_depth;
     uint32_t max_queue_depth;
+    uint32_t coalesced_writes;      /**< WriteBlock calls merged into a pending write */
+    uint32_t coalesced_reads;       /**< ReadBlock calls served from a pending write */
+    uint32_t last_main_cost_us;     /**< Device time used by the last MainFunction call */
+    uint32_t max_main_cost_us;      /**< Worst MainFunction call since init */
+    uint32_t budget_yields;         /**< Calls that stopped with work left over */
+    uint32_t writeall_skipped_blocks; /**< WriteAll blocks left alone (RAM mirror unchanged) */
+    uint32_t batch_rollbacks;       /**< NvM_WriteBlocks batches undone after a failed copy */
+    uint32_t remote_submissions;    /**< Requests from other threads accepted into the submit ring */
+    uint32_t remote_rejects;        /**< Requests refused because the submit ring was full */
+    uint32_t submit_ring_max_depth; /**< Deepest submit ring seen by NvM_MainFunction */
+    uint32_t pre_erases;            /**< Dataset slots erased ahead of their write while idle */
+    uint32_t pre_erase_hits;        /**< Dataset writes that skipped their erase */
+    uint32_t erases_avoided;        /**< bit_clear_update copies programmed in place */
+    uint32_t bit_clear_fallbacks;   /**< bit_clear_update copies that needed a 0→1 bit (erased) */
+    uint32_t compressed_bytes_saved; /**< Device bytes not read or programmed thanks to compression */
+    uint32_t fast_mount_blocks;     /**< ReadAll blocks loaded from the clean-shutdown checkpoint */
+    uint32_t checkpoint_writes;     /**< Clean-shutdown checkpoints written by WriteAll */
+    uint32_t retries_exhausted;     /**< Jobs reported failed after the retry policy gave up */
+    uint32_t multi_block_preemptions; /**< Immediate jobs run between ReadAll/WriteAll blocks */
+    uint32_t read_cache_hits;       /**< ReadBlock calls of read_cache blocks served from the RAM mirror */
+    uint32_t read_cache_misses;     /**< ReadBlock calls of read_cache blocks that went to the device */
+    uint32_t mirror_arena_bytes;    /**< RAM mirror arena bytes allocated to registered blocks */
+    uint32_t rom_bound_blocks;      /**< Blocks currently bound to their ROM default (not copied) */
+    uint32_t rom_defaults_materialized; /**< Bound blocks copied into their RAM mirror for a write */
+    uint32_t rom_defaults_written;  /**< Blocks programmed by NvM_WriteRomDefaults */
+    uint32_t rom_default_erases_skipped; /**< Erase units NvM_WriteRomDefaults found blank */
+    uint32_t overlapped_jobs;       /**< Single-block jobs run on a device lane */
 } NvM_Diagnostics_t;
 
 Std_ReturnType NvM_GetDiagnostics(NvM_Diagnostics_t *info_ptr);
 
+/**
+ * @brief Per-call work quota for NvM_MainFunction (0 = unlimited)
+ *
+ * Checked between blocks: a call always completes the block (or
+ * NvM_WriteBlocks batch) it started, so the quota can be exceeded by at
+ * most one block or batch. ReadAll/WriteAll resume at the next block on
+ * the following call.
+ */
+typedef struct {
+    uint32_t max_bytes;             /**< Device bytes read + written per call */
+    uint32_t max_cost_us;           /**< Modelled device time per call */
+} NvM_MainFunctionBudget_t;
+
+/**
+ * @brief Set the NvM_MainFunction work quota
+ *
+ * @param budget Quota, or NULL for unlimited (default after NvM_Init)
+ * @return E_OK on success
+ */
+Std_ReturnType NvM_SetMainFunctionBudget(const NvM_MainFunctionBudget_t *budget);
+
+/**
+ * @brief Failed jobs that can wait for their retry at once
+ */
+#define NVM_RETRY_QUEUE_SIZE 8U
+
+/**
+ * @brief Engine-managed retry of failed ReadBlock/WriteBlock jobs
+ *
+ * A failed job is set aside with a not-before time on the virtual clock
+ * and rejoins the queue at its priority once that time has passed, so
+ * other jobs keep running meanwhile. Its result stays NVM_REQ_PENDING
+ * until the last attempt. The n-th retry waits base_delay_ms * 2^(n-1),
+ * capped at max_delay_ms, plus a random extra of up to jitter_percent of
+ * that delay.
+ *
+ * A job is reported failed when its max_retries are used up, when the
+ * wait would run past its timeout, or when all NVM_RETRY_QUEUE_SIZE
+ * places are taken. A newer WriteBlock of the same block replaces a
+ * waiting write retry.
+ */
+typedef struct {
+    uint32_t base_delay_ms;         /**< Wait before the first retry (0 = retries off) */
+    uint32_t max_delay_ms;          /**< Longest wait (0 = no cap) */
+    uint8_t jitter_percent;         /**< Random extra wait, in percent of the delay (<= 100) */
+} NvM_RetryPolicy_t;
+
+/**
+ * @brief Set the retry policy
+ *
+ * Jobs already waiting keep their not-before time.
+ *
+ * @param policy Policy, or NULL to fail jobs at once (default after NvM_Init)
+ * @return E_OK on success, E_NOT_OK if jitter_percent exceeds 100
+ */
+Std_ReturnType NvM_SetRetryPolicy(const NvM_RetryPolicy_t *policy);
+
 #ifdef __cplusplus
 }
 #endif
@@ -9,6 +9,7 @@
 #define NVM_BLOCK_TYPES_H
 
 #include "nvm.h"
+#include "crc.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -19,25 +20,129 @@ extern "C" {
 /**
  * @brief Try to read block with CRC verification
  *
+ * Data and CRC are read with one contiguous MemIf_Read.
+ *
  * @param offset EEPROM offset
  * @param data Data buffer
  * @param size Block size
- * @param crc_type CRC type
+ * @param crc CRC engine (NULL or NVM_CRC_NONE = no CRC)
  * @return TRUE if successful
  */
-boolean NvM_TryReadBlock(uint32_t offset, uint8_t *data, uint16_t size, NvM_CrcType_t crc_type);
+boolean NvM_TryReadBlock(uint32_t offset, uint8_t *data, uint16_t size, const Crc_Descriptor_t *crc);
 
 /**
  * @brief Write block with CRC
  *
+ * NVM_CRC_PLACEMENT_PAGE programs the data and then the CRC in its own
+ * padded page; NVM_CRC_PLACEMENT_INLINE programs data and CRC as one
+ * page-padded image.
+ *
  * @param offset EEPROM offset
  * @param data Data buffer
  * @param size Block size
- * @param crc_type CRC type
+ * @param crc CRC engine (NULL or NVM_CRC_NONE = no CRC)
+ * @param placement CRC programming layout
  * @return E_OK if successful
  */
 Std_ReturnType NvM_WriteBlockWithCrc(uint32_t offset, const uint8_t *data,
-                                     uint16_t size, NvM_CrcType_t crc_type);
+                                     uint16_t size, const Crc_Descriptor_t *crc,
+                                     NvM_CrcPlacementType_t placement);
+
+/**
+ * @brief Build the inline-CRC image of a copy: data, CRC, erased padding to whole pages
+ *
+ * @param data Data buffer
+ * @param size Block size
+ * @param crc CRC engine (NULL or NVM_CRC_NONE = no CRC)
+ * @param image Output, EEPROM_BLOCK_SLOT_SIZE bytes
+ * @return Page-rounded image size, 0 if the image exceeds its slot
+ */
+uint32_t NvM_BuildBlockImage(const uint8_t *data, uint16_t size, const Crc_Descriptor_t *crc,
+                             uint8_t *image);
+
+/**
+ * @brief Program block with CRC without erasing first
+ *
+ * Same layout as NvM_WriteBlockWithCrc; the slot must already be erased.
+ *
+ * @param offset EEPROM offset
+ * @param data Data buffer
+ * @param size Block size
+ * @param crc CRC engine (NULL or NVM_CRC_NONE = no CRC)
+ * @param placement CRC programming layout
+ * @return E_OK if successful
+ */
+Std_ReturnType NvM_ProgramBlockWithCrc(uint32_t offset, const uint8_t *data,
+                                       uint16_t size, const Crc_Descriptor_t *crc,
+                                       NvM_CrcPlacementType_t placement);
+
+/**
+ * @brief Read one copy of a block (CRC checked, decoded if compressed)
+ *
+ * A compressed copy costs a header read plus a read of the stored
+ * payload and CRC; the payload is decoded straight into data.
+ *
+ * @param block Block configuration
+ * @param offset EEPROM offset of the copy
+ * @param data Data buffer (block_size bytes)
+ * @return TRUE if the copy is valid
+ */
+boolean NvM_ReadBlockCopy(const NvM_BlockConfig_t *block, uint32_t offset, uint8_t *data);
+
+/**
+ * @brief Program one copy of a block into an erased slot
+ *
+ * Uncompressed blocks use NvM_ProgramBlockWithCrc; compressed blocks
+ * program [length header | payload | CRC] as one page-padded image.
+ *
+ * @param block Block configuration
+ * @param offset EEPROM offset of the copy
+ * @param data Data buffer (block_size bytes)
+ * @return E_OK if successful
+ */
+Std_ReturnType NvM_ProgramBlockCopy(const NvM_BlockConfig_t *block, uint32_t offset,
+                                    const uint8_t *data);
+
+/**
+ * @brief Compare one programmed copy with data on the device
+ *
+ * @param block Block configuration
+ * @param offset EEPROM offset of the copy
+ * @param data Data buffer (block_size bytes)
+ * @return E_OK if the copy holds data
+ */
+Std_ReturnType NvM_VerifyBlockCopy(const NvM_BlockConfig_t *block, uint32_t offset,
+                                   const uint8_t *data);
+
+/**
+ * @brief Write one copy of a block, in place when the device allows it
+ *
+ * For a NATIVE or REDUNDANT block with bit_clear_update set, while the
+ * driver is in EEP_PROGRAM_BIT_CLEAR mode, data and CRC are programmed
+ * over the current copy as one image without an erase. The device
+ * refuses the whole image if any bit would have to go 0→1 (the CRC
+ * bytes included, so such blocks normally use NVM_CRC_NONE), and the
+ * copy is then written with NvM_WriteBlockWithCrc. Compressed blocks
+ * are always erased and programmed with NvM_ProgramBlockCopy.
+ *
+ * @param block Block configuration
+ * @param offset EEPROM offset of the copy
+ * @param data Data buffer (block_size bytes)
+ * @return E_OK if successful
+ */
+Std_ReturnType NvM_UpdateBlockWithCrc(const NvM_BlockConfig_t *block, uint32_t offset,
+                                      const uint8_t *data);
+
+/**
+ * @brief Get the CRC engine of a block
+ *
+ * Returns the descriptor resolved at registration, or resolves it from
+ * crc_type for configurations that did not go through NvM_RegisterBlock.
+ *
+ * @param block Block configuration
+ * @return CRC descriptor (NULL if crc_type is invalid)
+ */
+const Crc_Descriptor_t* NvM_GetBlockCrc(const NvM_BlockConfig_t *block);
 
 /**
  * @brief Read Native Block
@@ -78,12 +183,49 @@ Std_ReturnType NvM_WriteRedundantBlock(NvM_BlockConfig_t *block, const void *dat
 /**
  * @brief Read Dataset Block
  *
+ * Reads the active (newest) slot; if it fails, the other slots with a
+ * header newest first, then slots without one.
+ *
  * @param block Block configuration
  * @param data Data buffer
  * @return E_OK if successful
  */
 Std_ReturnType NvM_ReadDatasetBlock(NvM_BlockConfig_t *block, void *data);
 
+/**
+ * @brief Read the sequence header of one dataset slot
+ *
+ * @param block Block configuration
+ * @param index Dataset slot
+ * @param sequence Receives the slot's sequence
+ * @return TRUE if the slot holds a valid header for this block and slot
+ */
+boolean NvM_ReadDatasetHeader(const NvM_BlockConfig_t *block, uint8_t index, uint32_t *sequence);
+
+/**
+ * @brief Recover the newest dataset slot from the slot headers
+ *
+ * Runs once per registration (later calls return at once): reads only
+ * the header of every slot and points active_dataset_index and
+ * dataset_sequence at the newest valid one. Leaves both unchanged if no
+ * slot has a header.
+ *
+ * @param block Block configuration (ignored unless DATASET)
+ */
+void NvM_ScanDatasetHeaders(NvM_BlockConfig_t *block);
+
+/**
+ * @brief Program the sequence header of a written dataset slot
+ *
+ * Uses dataset_sequence + 1 and advances dataset_sequence on success.
+ * Must follow the slot's data and CRC.
+ *
+ * @param block Block configuration
+ * @param index Dataset slot just written
+ * @return E_OK if successful
+ */
+Std_ReturnType NvM_WriteDatasetHeader(NvM_BlockConfig_t *block, uint8_t index);
+
 /**
  * @brief Write Dataset Block (round-robin)
  *
@@ -93,6 +235,24 @@ Std_ReturnType NvM_ReadDatasetBlock(NvM_BlockConfig_t *block, void *data);
  */
 Std_ReturnType NvM_WriteDatasetBlock(NvM_BlockConfig_t *block, const void *data);
 
+/**
+ * @brief Read Log Block (current record from the log region)
+ *
+ * @param block Block configuration
+ * @param data Data buffer
+ * @return E_OK if successful
+ */
+Std_ReturnType NvM_ReadLogBlock(NvM_BlockConfig_t *block, void *data);
+
+/**
+ * @brief Write Log Block (append a record to the log region)
+ *
+ * @param block Block configuration
+ * @param data Data buffer
+ * @return E_OK if successful
+ */
+Std_ReturnType NvM_WriteLogBlock(NvM_BlockConfig_t *block, const void *data);
+
 #ifdef __cplusplus
 }
 #endif
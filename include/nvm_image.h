@@ -0,0 +1,80 @@
+/**
+ * @file nvm_image.h
+ * @brief Offline EEPROM image building and inspection from block configurations
+ *
+ * - 构建: 按Block配置直接编程到已初始化的器件 (通常是mmap镜像文件), 不经NvM作业队列
+ * - 与运行时相同的代码: eeprom_layout.c校验布局, nvm_block_types.c编程副本、CRC、压缩与Dataset序列头
+ * - 冗余Block两份副本, Dataset按版本从旧到新写入槽位并带序列头, 可预置擦写计数
+ * - 检查: 每个副本/槽位读一次, 校验CRC与序列头, 给出NvM读取时会返回的副本
+ *
+ * Typical use: eepsim_image (tools/eep_image) writes a ready image once;
+ * tests map it with Eeprom_ConfigType.image_path and Eep_Snapshot() and
+ * start from that state without writing ROM defaults through NvM.
+ */
+
+#ifndef NVM_IMAGE_H
+#define NVM_IMAGE_H
+
+#include "nvm.h"
+#include "eeprom_layout.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief One block of an image
+ */
+typedef struct {
+    NvM_BlockConfig_t config;       /**< Layout: ID, size, type, CRC, placement, compression,
+                                         offsets, dataset_count (runtime fields ignored) */
+    const uint8_t *data[EEPROM_MAX_DATASET_COUNT]; /**< Payload of block_size bytes per version,
+                                                        oldest first; NATIVE/REDUNDANT use data[0] */
+    uint8_t version_count;          /**< DATASET: slots written (1..dataset_count), 0 = 1 */
+    uint32_t erase_count;           /**< Minimum erase count of every erase unit of the block's slots */
+} NvM_ImageBlock_t;
+
+/**
+ * @brief Inspection result of one block
+ */
+typedef struct {
+    uint8_t block_id;
+    uint8_t copies;                 /**< Copies (NATIVE 1, REDUNDANT 2) or dataset slots */
+    uint8_t valid_mask;             /**< Bit i: copy / slot i decodes with a good CRC */
+    uint8_t header_mask;            /**< DATASET: bit i: slot i has a sequence header */
+    uint8_t selected;               /**< Copy / slot NvM would read (copies = none) */
+    uint32_t sequence;              /**< DATASET: header sequence of the selected slot (0 = none) */
+    uint32_t erase_count;           /**< Highest erase count over the block's slots */
+    boolean valid;                  /**< Every written copy is good */
+} NvM_ImageReport_t;
+
+/**
+ * @brief Program blocks into the initialized device
+ *
+ * Every configuration is validated and the slots of all blocks must be
+ * disjoint before anything is programmed. Each slot is erased and then
+ * programmed; dataset headers get sequences 1..version_count.
+ * version_control_offset and LOG blocks are not supported.
+ *
+ * @param blocks Blocks to program
+ * @param count Number of blocks
+ * @return E_OK on success, E_NOT_OK on an invalid layout or a device error
+ */
+Std_ReturnType NvM_ImageBuild(const NvM_ImageBlock_t *blocks, uint32_t count);
+
+/**
+ * @brief Decode and validate one block of the initialized device
+ *
+ * @param config Block layout
+ * @param data Receives the copy NvM would read (block_size bytes, may be NULL)
+ * @param report Receives the result
+ * @return E_OK if the block is valid, E_NOT_OK otherwise
+ */
+Std_ReturnType NvM_ImageInspectBlock(const NvM_BlockConfig_t *config, uint8_t *data,
+                                     NvM_ImageReport_t *report);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NVM_IMAGE_H */
@@ -0,0 +1,196 @@
+/**
+ * @file nvm_shm.h
+ * @brief Shared-memory NvM server and client library for multi-process rigs
+ *
+ * - 服务端: 一个进程运行NvM, 把Block表 (大小/状态/结果)、请求环与载荷区放入POSIX共享内存
+ * - 器件镜像可放入/dev/shm (mmap后端), 客户端只读映射即可直接查看EEPROM内容
+ * - 客户端: 占用Block载荷 → 原地填写 → 经无锁多生产者环提交读/写 → 等待完成计数
+ * - 零拷贝: NvM直接读入/写出共享内存中的载荷, 不经套接字或中间缓冲
+ * - 等待: 完成计数即futex字, 无等待者时服务端不发系统调用
+ *
+ * Protocol: a client owns a block's payload from NvM_ShmClient_Acquire to
+ * NvM_ShmClient_Release; one request per block is in flight at a time.
+ * The payload must not change while a write is in flight. Blocks served
+ * to clients should not also be used by the server process itself.
+ */
+
+#ifndef NVM_SHM_H
+#define NVM_SHM_H
+
+#include "nvm.h"
+#include "eeprom_driver.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Longest shared memory object name, including the leading '/'
+ */
+#define NVM_SHM_NAME_MAX 48U
+
+/**
+ * @brief Client requests
+ */
+typedef enum {
+    NVM_SHM_OP_READ = 0,            /**< NvM_ReadBlock into the payload */
+    NVM_SHM_OP_WRITE = 1            /**< NvM_WriteBlock from the payload */
+} NvM_ShmOp_t;
+
+/**
+ * @brief Server configuration
+ */
+typedef struct {
+    const char *name;               /**< Shared memory object name ("/name", no other '/') */
+    const Eeprom_ConfigType *device; /**< Device to re-initialize on the image "/dev/shm/<name>.eep"
+                                          (image_path ignored), NULL = keep the current device */
+} NvM_ShmServerConfig_t;
+
+/**
+ * @brief Server counters
+ */
+typedef struct {
+    uint32_t blocks;                /**< Blocks published to clients */
+    uint32_t requests;              /**< Requests taken from the ring */
+    uint32_t refused;               /**< Requests NvM did not accept (completed NVM_REQ_NOT_OK) */
+    uint32_t rejected;              /**< Client submissions refused because the ring was full */
+} NvM_ShmServerStats_t;
+
+/**
+ * @brief Publish the registered blocks in a new shared memory object
+ *
+ * Call after NvM_Init and block registration; blocks registered later
+ * are not served. An object of the same name left by an earlier server
+ * is replaced.
+ *
+ * @param config Server configuration
+ * @return E_OK on success, E_NOT_OK if already running, on a bad name or
+ *         if the object or the device image cannot be created
+ */
+Std_ReturnType NvM_ShmServer_Start(const NvM_ShmServerConfig_t *config);
+
+/**
+ * @brief Hand waiting client requests to NvM_ReadBlock/NvM_WriteBlock
+ *
+ * Call from one thread, normally the NvM task right before
+ * NvM_MainFunction. Completions reach clients from the job notifications.
+ *
+ * @return Requests taken
+ */
+uint32_t NvM_ShmServer_Poll(void);
+
+/**
+ * @brief Stop serving and remove the object name
+ *
+ * Connected clients see the server stopped; their waits return E_NOT_OK.
+ * The device image stays in /dev/shm.
+ */
+void NvM_ShmServer_Stop(void);
+
+/**
+ * @brief Get the server counters
+ *
+ * @return E_NOT_OK if stats is NULL or the server is not running
+ */
+Std_ReturnType NvM_ShmServer_GetStats(NvM_ShmServerStats_t *stats);
+
+/**
+ * @brief Client connection (process-local)
+ */
+typedef struct {
+    void *region;                   /**< Mapped server object */
+    size_t size;
+    const uint8_t *device;          /**< Read-only device image (NULL if not shared) */
+    size_t device_size;
+    uint32_t id;                    /**< Owner ID (process ID) */
+} NvM_ShmClient_t;
+
+/**
+ * @brief Map a running server's object
+ *
+ * @param client Connection to fill
+ * @param name Object name passed to the server
+ * @return E_OK on success, E_NOT_OK if no compatible server is running
+ */
+Std_ReturnType NvM_ShmClient_Connect(NvM_ShmClient_t *client, const char *name);
+
+/**
+ * @brief Unmap the server object (owned blocks are not released)
+ */
+void NvM_ShmClient_Disconnect(NvM_ShmClient_t *client);
+
+/**
+ * @brief Take a block's payload for exclusive use
+ *
+ * Acquiring a block the client already owns returns the same payload. A
+ * block held by a process that has exited is taken over once its last
+ * request has completed.
+ *
+ * @param client Connection
+ * @param block_id Block ID
+ * @param size Set to the block size (may be NULL)
+ * @return Payload in shared memory, or NULL if the block is not served,
+ *         owned by another client or the server has stopped
+ */
+uint8_t* NvM_ShmClient_Acquire(NvM_ShmClient_t *client, NvM_BlockIdType block_id, uint16_t *size);
+
+/**
+ * @brief Give a block's payload back (no request may be in flight)
+ */
+void NvM_ShmClient_Release(NvM_ShmClient_t *client, NvM_BlockIdType block_id);
+
+/**
+ * @brief Submit a request on an acquired block
+ *
+ * @param client Connection
+ * @param block_id Acquired block
+ * @param op Read into or write from the payload
+ * @param handle Receives the completion handle
+ * @return E_OK if queued; E_NOT_OK if the block is not owned, a request
+ *         is in flight, the ring is full (retry later) or the server stopped
+ */
+Std_ReturnType NvM_ShmClient_Submit(NvM_ShmClient_t *client, NvM_BlockIdType block_id,
+                                    NvM_ShmOp_t op, NvM_JobHandle_t *handle);
+
+/**
+ * @brief Wait for a submitted request
+ *
+ * @param client Connection
+ * @param handle Handle from NvM_ShmClient_Submit
+ * @param timeout_ms Wall-clock timeout (0: check only, NVM_WAIT_FOREVER)
+ * @param result Set to the job result (NVM_REQ_OK / NVM_REQ_NOT_OK, may be NULL)
+ * @return E_OK once completed, E_NOT_OK on timeout or if the server stopped
+ */
+Std_ReturnType NvM_ShmClient_Wait(NvM_ShmClient_t *client, const NvM_JobHandle_t *handle,
+                                  uint32_t timeout_ms, uint8_t *result);
+
+/**
+ * @brief Read a block into a private buffer (acquire, read, wait, copy, release)
+ *
+ * @return E_OK if the job result is NVM_REQ_OK
+ */
+Std_ReturnType NvM_ShmClient_ReadBlock(NvM_ShmClient_t *client, NvM_BlockIdType block_id,
+                                       void *data, uint32_t timeout_ms);
+
+/**
+ * @brief Write a block from a private buffer (acquire, copy, write, wait, release)
+ *
+ * @return E_OK if the job result is NVM_REQ_OK
+ */
+Std_ReturnType NvM_ShmClient_WriteBlock(NvM_ShmClient_t *client, NvM_BlockIdType block_id,
+                                        const void *data, uint32_t timeout_ms);
+
+/**
+ * @brief Get a block's NvM state as of its last completion
+ *
+ * @return E_NOT_OK if the block is not served
+ */
+Std_ReturnType NvM_ShmClient_GetBlockState(const NvM_ShmClient_t *client, NvM_BlockIdType block_id,
+                                           uint8_t *state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NVM_SHM_H */
@@ -7,6 +7,7 @@
  * - 优先级抢占
  * - 虚拟时钟与时间倍速
  * - 中断模拟
+ * - 多核模式: 每核一个线程, 虚拟时间屏障同步
  */
 
 #ifndef OS_SCHEDULER_H
@@ -29,6 +30,16 @@ typedef uint8_t OsTaskId_t;
  */
 typedef uint8_t OsTaskPriority_t;
 
+/**
+ * @brief Virtual core identifier type
+ */
+typedef uint8_t OsCoreId_t;
+
+/**
+ * @brief Maximum number of virtual cores
+ */
+#define OS_MAX_CORES 8U
+
 /**
  * @brief Time scale enumeration
  */
@@ -83,6 +94,33 @@ typedef struct {
     uint32_t max_exec_time_us;      /**< Maximum execution time */
 } OsSchedulerStats_t;
 
+/**
+ * @brief Scheduler instance: cores, tasks and virtual clocks
+ */
+typedef struct OsScheduler_Context OsScheduler_Context_t;
+
+/**
+ * @brief Create a context in the state OsScheduler_Init leaves
+ *
+ * @return NULL if out of memory
+ */
+OsScheduler_Context_t* OsScheduler_CreateContext(void);
+
+/**
+ * @brief Destroy a context (must not be bound on any thread)
+ */
+void OsScheduler_DestroyContext(OsScheduler_Context_t *ctx);
+
+/**
+ * @brief Make a context current for the calling thread
+ *
+ * OsScheduler_RunCores binds the caller's contexts on its core threads.
+ *
+ * @param ctx Context, NULL for the default context
+ * @return The previous binding (NULL = default context)
+ */
+OsScheduler_Context_t* OsScheduler_BindContext(OsScheduler_Context_t *ctx);
+
 /**
  * @brief Initialize the OS scheduler
  *
@@ -92,13 +130,46 @@ typedef struct {
 Std_ReturnType OsScheduler_Init(uint8_t max_tasks);
 
 /**
- * @brief Register a task with the scheduler
+ * @brief Set the number of virtual cores (default 1)
+ *
+ * Each core has its own task set, ready heap and virtual clock; new cores
+ * start at core 0's time. Cores that own tasks cannot be removed.
+ *
+ * @param core_count 1..OS_MAX_CORES
+ * @return E_OK on success, E_NOT_OK on failure
+ */
+Std_ReturnType OsScheduler_SetCoreCount(uint8_t core_count);
+
+/**
+ * @brief Get the number of virtual cores
+ */
+uint8_t OsScheduler_GetCoreCount(void);
+
+/**
+ * @brief Core the calling code runs on (0 outside a core thread)
+ */
+OsCoreId_t OsScheduler_GetCoreId(void);
+
+/**
+ * @brief Register a task with the scheduler (on core 0)
  *
  * @param task Pointer to task structure
  * @return E_OK on success, E_NOT_OK on failure
  */
 Std_ReturnType OsScheduler_RegisterTask(const OsTask_t *task);
 
+/**
+ * @brief Register a task on a given core
+ *
+ * Task IDs are unique over all cores. Not allowed during
+ * OsScheduler_RunCores.
+ *
+ * @param core_id Core to run the task on
+ * @param task Pointer to task structure
+ * @return E_OK on success, E_NOT_OK on failure
+ */
+Std_ReturnType OsScheduler_RegisterTaskOnCore(OsCoreId_t core_id, const OsTask_t *task);
+
 /**
  * @brief Unregister a task
  *
@@ -126,10 +197,22 @@ Std_ReturnType OsScheduler_Stop(void);
 /**
  * @brief Get current virtual time in milliseconds
  *
+ * Time of the calling core (core 0 outside a core thread).
+ *
  * @return Virtual time in milliseconds
  */
 uint32_t OsScheduler_GetVirtualTimeMs(void);
 
+/**
+ * @brief Get current virtual time in microseconds
+ *
+ * Inside a task this includes the work the task has reported so far
+ * (OsScheduler_ReportExecTimeUs).
+ *
+ * @return Virtual time in microseconds
+ */
+uint64_t OsScheduler_GetVirtualTimeUs(void);
+
 /**
  * @brief Set time scale for simulation
  *
@@ -151,17 +234,65 @@ OsTimeScale_t OsScheduler_GetTimeScale(void);
  * @brief Trigger scheduler tick (called by timer)
  *
  * This function advances virtual time and triggers task activation
+ * (on every core in turn, on the calling thread)
  */
 void OsScheduler_Tick(void);
 
+/**
+ * @brief Run the scheduler as a discrete-event simulation
+ *
+ * Same result as calling OsScheduler_Tick until the virtual time reaches
+ * end_time_ms (task order, virtual time and statistics included), but
+ * jumps straight from one task activation to the next: the cost is
+ * proportional to the number of task runs, not to simulated milliseconds.
+ * Virtual time advanced by the tasks themselves (OsScheduler_Sleep)
+ * counts towards end_time_ms. With several cores, the cores advance in
+ * lockstep on the calling thread.
+ *
+ * @param end_time_ms Virtual time to stop at
+ * @return Number of task runs
+ */
+uint32_t OsScheduler_RunUntil(uint32_t end_time_ms);
+
+/**
+ * @brief Run every core on its own OS thread until end_time_ms
+ *
+ * Core 0 runs on the calling thread, each other core on a thread of its
+ * own, so tasks on different cores execute in parallel on the host. Each
+ * core advances as OsScheduler_RunUntil in epochs of barrier_ms and waits
+ * at a barrier for the others: clocks never drift apart by more than one
+ * epoch (plus whatever a task sleeps). On return all cores share the
+ * latest core time.
+ *
+ * Code shared between cores (NvM, MemIf, RAM mirrors) is called
+ * concurrently; only use interfaces that are safe for that.
+ *
+ * @param end_time_ms Virtual time to stop at
+ * @param barrier_ms Epoch length between barriers (> 0)
+ * @return Number of task runs over all cores (0 if the run could not start)
+ */
+uint32_t OsScheduler_RunCores(uint32_t end_time_ms, uint32_t barrier_ms);
+
 /**
  * @brief Get scheduler statistics
  *
+ * Summed over cores (ticks count per core); max_exec_time_us is the
+ * maximum over cores.
+ *
  * @param stats Pointer to statistics structure
  * @return E_OK on success, E_NOT_OK on failure
  */
 Std_ReturnType OsScheduler_GetStats(OsSchedulerStats_t *stats);
 
+/**
+ * @brief Get the statistics of one core
+ *
+ * @param core_id Core
+ * @param stats Pointer to statistics structure
+ * @return E_OK on success, E_NOT_OK on failure
+ */
+Std_ReturnType OsScheduler_GetCoreStats(OsCoreId_t core_id, OsSchedulerStats_t *stats);
+
 /**
  * @brief Disable all interrupts (simulation)
  *
@@ -176,9 +307,22 @@ void OsScheduler_DisableInterrupts(void);
  */
 void OsScheduler_EnableInterrupts(void);
 
+/**
+ * @brief Report execution time consumed by the running task
+ *
+ * For work that is modelled rather than slept (e.g. synchronous device
+ * access in NvM_MainFunction). Added to the task's measured execution
+ * time for max_exec_time_us and deadline_misses. Ignored outside a task.
+ *
+ * @param microseconds Consumed time
+ */
+void OsScheduler_ReportExecTimeUs(uint32_t microseconds);
+
 /**
  * @brief Sleep current task for specified milliseconds
  *
+ * Advances the calling core's clock.
+ *
  * @param milliseconds Sleep duration
  */
 void OsScheduler_Sleep(uint32_t milliseconds);
@@ -0,0 +1,102 @@
+/**
+ * @file powercut_explorer.h
+ * @brief Exhaustive power-cut exploration of one recorded workload
+ *
+ * REQ-故障库: design/07-系统测试与故障场景.md §2
+ * - 工作负载只运行一次; 每个页编程边界和每次擦除之前都是一个掉电点
+ * - 在掉电点fork分支: 子进程继承写时复制的器件镜像与全部模块状态, 补齐已编程的页后执行恢复检查
+ * - 分支并行检查, 工作负载不等待; N个掉电点的总开销接近一次运行加N次恢复
+ * - 子进程崩溃记为CRASHED, 不影响其余分支
+ */
+
+#ifndef POWERCUT_EXPLORER_H
+#define POWERCUT_EXPLORER_H
+
+#include "common_types.h"
+#include "eeprom_driver.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Maximum number of branches checked at once
+ */
+#define POWERCUT_MAX_WORKERS 64U
+
+/**
+ * @brief One power-cut point
+ *
+ * The device holds everything programmed before the operation, plus its
+ * first pages_done pages when it is a program. Erases are atomic: the cut
+ * comes before them.
+ */
+typedef struct {
+    uint32_t index;                 /**< Cut number in workload order */
+    Eep_OpType_t op;                /**< EEP_OP_WRITE or EEP_OP_ERASE being cut */
+    uint32_t address;               /**< Start of that operation */
+    uint32_t pages_done;            /**< Pages of a program already on the device */
+    boolean completed;              /**< After the whole workload (no cut) */
+} PowerCut_Point_t;
+
+/**
+ * @brief Workload recorded once (runs on the calling thread)
+ */
+typedef void (*PowerCut_WorkloadFunc_t)(void *user_ctx);
+
+/**
+ * @brief Recovery and invariant check after a cut
+ *
+ * Runs in a forked child that holds the device image and every module's
+ * state as of the cut. It reboots what it needs (e.g. NvM_Init, block
+ * registration, ReadAll) and checks the result.
+ *
+ * @return TRUE if the invariants hold
+ */
+typedef boolean (*PowerCut_CheckFunc_t)(const PowerCut_Point_t *point, void *user_ctx);
+
+/**
+ * @brief Exploration configuration
+ */
+typedef struct {
+    PowerCut_WorkloadFunc_t workload;
+    PowerCut_CheckFunc_t check;
+    void *user_ctx;
+    uint8_t worker_count;           /**< Branches checked at once, 0: one per online CPU */
+} PowerCut_Config_t;
+
+/**
+ * @brief Exploration summary
+ */
+typedef struct {
+    uint32_t cuts;                  /**< Branches taken, the completed workload included */
+    uint32_t passed;
+    uint32_t failed;
+    uint32_t crashed;
+    uint32_t not_run;               /**< Branches that could not be forked */
+    uint32_t programs;              /**< Program operations seen in the workload */
+    uint32_t erases;                /**< Erase operations seen in the workload */
+    boolean has_failure;
+    PowerCut_Point_t first_failure; /**< Lowest failing or crashing cut (has_failure) */
+    uint32_t elapsed_ms;            /**< Wall-clock time, workload and checks */
+} PowerCut_Summary_t;
+
+/**
+ * @brief Run a workload once and check recovery at every power-cut point
+ *
+ * Needs an initialized driver. The workload must not fork and must do all
+ * device access from the calling thread. The caller's state after the
+ * call is the completed workload.
+ *
+ * @param config Workload and check
+ * @param summary Output (may be NULL)
+ * @return E_OK if every branch was checked (passed, failed or crashed)
+ */
+Std_ReturnType PowerCut_Explore(const PowerCut_Config_t *config, PowerCut_Summary_t *summary);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POWERCUT_EXPLORER_H */
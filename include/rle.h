@@ -0,0 +1,53 @@
+/**
+ * @file rle.h
+ * @brief Run-length codec for NvM block payloads
+ *
+ * REQ-数据压缩: 标定/自适应表中大量0x00/0xFF等重复字节
+ * - 控制字节 c < 0x80: 其后 c+1 个字面字节 (1..128)
+ * - 控制字节 c >= 0x80: 下一字节重复 c-0x80+3 次 (3..130)
+ * - 最坏情况: 每128字节多1个控制字节
+ */
+
+#ifndef RLE_H
+#define RLE_H
+
+#include "common_types.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Worst-case encoded size of length bytes
+ */
+#define RLE_MAX_ENCODED_SIZE(length) ((length) + ((length) + 127U) / 128U)
+
+/**
+ * @brief Encode a buffer
+ *
+ * @param src Data to encode
+ * @param length Bytes in src
+ * @param dst Output
+ * @param capacity Bytes available in dst
+ * @return Encoded size, or 0 if it does not fit in capacity
+ */
+uint32_t RLE_Encode(const uint8_t *src, uint32_t length, uint8_t *dst, uint32_t capacity);
+
+/**
+ * @brief Decode a buffer straight into its destination
+ *
+ * @param src Encoded data
+ * @param length Bytes in src
+ * @param dst Output
+ * @param expected Decoded size the caller expects
+ * @return E_OK if src decodes to exactly expected bytes, E_NOT_OK if it
+ *         is malformed, too short or too long
+ */
+Std_ReturnType RLE_Decode(const uint8_t *src, uint32_t length, uint8_t *dst, uint32_t expected);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* RLE_H */
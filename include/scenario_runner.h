@@ -0,0 +1,132 @@
+/**
+ * @file scenario_runner.h
+ * @brief Parallel scenario runner for simulation campaigns
+ *
+ * REQ-故障库: design/07-系统测试与故障场景.md §2
+ * - 每个工作者是一个独立的模拟ECU (EEPROM/NvM/FaultInj/调度器状态互不干扰)
+ * - 进程模式: 工作者是fork出的进程; 线程模式: 工作者是线程, 各自绑定自己的模块上下文
+ * - 工作窃取: 每个工作者持有场景区间, 空闲时从剩余最多者尾部窃取一半
+ * - 进程模式下场景崩溃时记录为CRASHED并补起工作进程, 其余场景照常完成
+ */
+
+#ifndef SCENARIO_RUNNER_H
+#define SCENARIO_RUNNER_H
+
+#include "common_types.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Maximum number of workers
+ */
+#define SCENARIO_RUNNER_MAX_WORKERS 64U
+
+/**
+ * @brief Scenario outcome
+ */
+typedef enum {
+    SCENARIO_PENDING = 0,      /**< Not run (campaign aborted) */
+    SCENARIO_RUNNING = 1,      /**< Started, not finished */
+    SCENARIO_PASSED = 2,
+    SCENARIO_FAILED = 3,
+    SCENARIO_CRASHED = 4       /**< Worker died while running it */
+} ScenarioRunner_Status_t;
+
+/**
+ * @brief How workers are run
+ */
+typedef enum {
+    SCENARIO_MODE_PROCESS = 0,     /**< Forked processes: crashes are isolated */
+    SCENARIO_MODE_THREAD           /**< Threads in the caller's process, one set of contexts each */
+} ScenarioRunner_Mode_t;
+
+/**
+ * @brief Scenario body
+ *
+ * Runs in a worker and must set up the modules it uses itself
+ * (NvM_Init, FaultInj_Init, ...): a worker runs many scenarios in turn.
+ *
+ * @param index Scenario index (0..scenario_count-1)
+ * @param user_ctx Campaign context (the worker's copy in process mode, shared in thread mode)
+ * @return TRUE if the scenario passed
+ */
+typedef boolean (*ScenarioRunner_Func_t)(uint32_t index, void *user_ctx);
+
+/**
+ * @brief Worker start hook, run on the worker before its first scenario
+ *
+ * In thread mode this is where a worker creates and binds its own module
+ * contexts (Eep_CreateContext, NvM_CreateContext, ...) so it is an
+ * independent ECU.
+ *
+ * @param worker Worker slot
+ * @param user_ctx Campaign context
+ * @return Worker state handed to the end hook
+ */
+typedef void* (*ScenarioRunner_WorkerInit_t)(uint8_t worker, void *user_ctx);
+
+/**
+ * @brief Worker end hook, run on the worker after its last scenario
+ *
+ * @param worker_ctx Value returned by the start hook
+ * @param user_ctx Campaign context
+ */
+typedef void (*ScenarioRunner_WorkerFini_t)(void *worker_ctx, void *user_ctx);
+
+/**
+ * @brief Campaign configuration
+ */
+typedef struct {
+    uint32_t scenario_count;
+    uint8_t worker_count;           /**< 0: one per online CPU */
+    ScenarioRunner_Func_t func;
+    void *user_ctx;
+    ScenarioRunner_Mode_t mode;
+    ScenarioRunner_WorkerInit_t worker_init;    /**< Optional */
+    ScenarioRunner_WorkerFini_t worker_fini;    /**< Optional */
+} ScenarioRunner_Config_t;
+
+/**
+ * @brief Campaign summary
+ */
+typedef struct {
+    uint32_t passed;
+    uint32_t failed;
+    uint32_t crashed;
+    uint32_t not_run;
+    uint8_t workers;                /**< Workers used */
+    uint32_t steals;                /**< Successful steals over all workers */
+    uint32_t respawns;              /**< Workers restarted after a crash (process mode) */
+    uint32_t executed[SCENARIO_RUNNER_MAX_WORKERS]; /**< Scenarios run per worker slot */
+    uint32_t elapsed_ms;            /**< Wall-clock campaign time */
+} ScenarioRunner_Summary_t;
+
+/**
+ * @brief Run a campaign on parallel workers
+ *
+ * Scenario indices are split into one contiguous range per worker. A
+ * worker takes from the front of its own range; once empty, it steals the
+ * back half of the largest remaining range.
+ *
+ * In process mode workers are forked from the caller, so they all start
+ * from the caller's state and nothing they do is visible to the caller
+ * except the outcomes. In thread mode workers share the process: isolation
+ * comes from the contexts the start hook binds, and a crashing scenario
+ * takes the whole campaign down.
+ *
+ * @param config Campaign
+ * @param status Per-scenario ScenarioRunner_Status_t (scenario_count entries, may be NULL)
+ * @param summary Output (may be NULL)
+ * @return E_OK if every scenario was run (passed, failed or crashed)
+ */
+Std_ReturnType ScenarioRunner_Run(const ScenarioRunner_Config_t *config, uint8_t *status,
+                                  ScenarioRunner_Summary_t *summary);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SCENARIO_RUNNER_H */
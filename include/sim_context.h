@@ -0,0 +1,69 @@
+/**
+ * @file sim_context.h
+ * @brief Per-thread binding of module instance contexts
+ *
+ * REQ-多实例: design/07-系统测试与故障场景.md §2
+ * - EEPROM/FaultInj/MemIf/NvM/调度器的状态各自可有多个实例 (上下文)
+ * - 每个线程为每个模块绑定一个上下文, 未绑定时使用模块内置的默认上下文
+ * - 绑定集合可整体保存/恢复 (调度器的核线程继承启动者的绑定)
+ * - 进程级 (不随上下文区分): 日志, 指标, CRC/ECC表, 时间线, RCU读者槽, I/O跟踪捕获, 断电探索器
+ */
+
+#ifndef SIM_CONTEXT_H
+#define SIM_CONTEXT_H
+
+#include "common_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Modules with instance contexts
+ */
+typedef enum {
+    SIM_CONTEXT_EEP = 0,
+    SIM_CONTEXT_FAULTINJ,
+    SIM_CONTEXT_MEMIF,
+    SIM_CONTEXT_NVM,
+    SIM_CONTEXT_SCHED,
+    SIM_CONTEXT_MODULE_COUNT
+} SimContext_Module_t;
+
+/**
+ * @brief Every module's binding of one thread
+ */
+typedef struct {
+    void *bound[SIM_CONTEXT_MODULE_COUNT];
+} SimContext_Binding_t;
+
+/**
+ * @brief Context the calling thread has bound for a module
+ *
+ * @return NULL when the module's default context is in use
+ */
+void* SimContext_Get(SimContext_Module_t module);
+
+/**
+ * @brief Bind a context for a module on the calling thread
+ *
+ * @param ctx Context, NULL for the module's default context
+ * @return The previous binding
+ */
+void* SimContext_Bind(SimContext_Module_t module, void *ctx);
+
+/**
+ * @brief Copy the calling thread's bindings
+ */
+void SimContext_Save(SimContext_Binding_t *binding);
+
+/**
+ * @brief Replace the calling thread's bindings
+ */
+void SimContext_Restore(const SimContext_Binding_t *binding);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SIM_CONTEXT_H */
@@ -0,0 +1,144 @@
+/**
+ * @file timeline.h
+ * @brief Virtual-time activity timeline, exported as Chrome trace-event / Perfetto JSON
+ *
+ * - 记录: 调度器任务运行, NvM作业生命周期 (入队 → 开始 → 完成), EEPROM器件忙区间
+ * - 事件写入启动时预分配的缓冲 (原子取槽, 无锁, 无格式化); 缓冲满后丢弃并计数
+ * - 时间戳为虚拟微秒: 任务内的同步器件操作按器件串行顺延, 与任务计入的执行时间一致
+ * - 导出: Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev 直接打开)
+ */
+
+#ifndef TIMELINE_H
+#define TIMELINE_H
+
+#include "common_types.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Events preallocated by Timeline_Start(0)
+ */
+#define TIMELINE_DEFAULT_EVENTS 65536U
+
+/**
+ * @brief NvM job lifetime points
+ */
+typedef enum {
+    TIMELINE_JOB_QUEUED = 0,        /**< Entered the job queue */
+    TIMELINE_JOB_STARTED,           /**< Taken from the queue by NvM_MainFunction */
+    TIMELINE_JOB_COMPLETED          /**< End or error notification */
+} Timeline_JobPoint_t;
+
+/**
+ * @brief Recorder statistics
+ */
+typedef struct {
+    uint32_t capacity;              /**< Events preallocated */
+    uint32_t events;                /**< Events stored */
+    uint32_t dropped;               /**< Events lost to a full buffer */
+} Timeline_Stats_t;
+
+/**
+ * @brief Recording on/off (read it through TIMELINE_ACTIVE)
+ */
+extern uint32_t Timeline_ActiveFlag;
+
+/**
+ * @brief TRUE while recording; call sites test it before gathering arguments
+ */
+#define TIMELINE_ACTIVE() (__atomic_load_n(&Timeline_ActiveFlag, __ATOMIC_RELAXED) != 0U)
+
+/**
+ * @brief Allocate the event buffer and start recording (earlier events are discarded)
+ *
+ * @param capacity Events to preallocate (0 = TIMELINE_DEFAULT_EVENTS)
+ * @return E_OK on success, E_NOT_OK if already recording or out of memory
+ */
+Std_ReturnType Timeline_Start(uint32_t capacity);
+
+/**
+ * @brief Stop recording; the events stay for export until the next start
+ */
+void Timeline_Stop(void);
+
+/**
+ * @brief Get recorder statistics
+ *
+ * @return E_NOT_OK if stats is NULL
+ */
+Std_ReturnType Timeline_GetStats(Timeline_Stats_t *stats);
+
+/**
+ * @brief Export the stopped recording as Chrome trace-event JSON
+ *
+ * Tracks: one row per scheduler core, one for the EEPROM device, one per
+ * NvM block (queue wait, then the job until its notification). Like
+ * snprintf: output is truncated to size, and the length the full export
+ * needs is returned.
+ *
+ * @param buffer Output (may be NULL if size is 0)
+ * @param size Buffer size
+ * @return Length of the full export, excluding the terminator (0 while recording)
+ */
+size_t Timeline_Export(char *buffer, size_t size);
+
+/**
+ * @brief Export the stopped recording to a file
+ *
+ * @param path Output file (truncated)
+ * @return E_OK on success, E_NOT_OK while recording or if the file cannot be written
+ */
+Std_ReturnType Timeline_ExportFile(const char *path);
+
+/**
+ * @brief Record a task run (called by the scheduler)
+ *
+ * @param core Core the task ran on
+ * @param task_id Task ID
+ * @param name Task name (must outlive the export; NULL = by ID)
+ * @param start_us Virtual start time
+ * @param duration_us Measured execution time
+ */
+void Timeline_TaskRun(uint8_t core, uint32_t task_id, const char *name, uint64_t start_us,
+                      uint32_t duration_us);
+
+/**
+ * @brief Record a device operation (called by the EEPROM driver)
+ *
+ * The device is busy for duration_us from start_us, or from the end of
+ * the previous operation if that is later.
+ *
+ * @param op Eep_OpType_t
+ * @param result Result returned to the caller
+ * @param address Address
+ * @param length Bytes
+ * @param start_us Virtual time the operation was issued
+ * @param duration_us Modelled device latency
+ */
+void Timeline_DeviceOp(uint8_t op, Std_ReturnType result, uint32_t address, uint32_t length,
+                       uint64_t start_us, uint32_t duration_us);
+
+/**
+ * @brief Record a point in an NvM job's lifetime (called by NvM)
+ *
+ * Stamped at now_us, or after the device operations already recorded if
+ * those end later.
+ *
+ * @param point Lifetime point
+ * @param block_id Block ID (0xFF: ReadAll/WriteAll)
+ * @param job_type NvM_JobType_t (ignored for COMPLETED)
+ * @param result Job result (COMPLETED only)
+ * @param now_us Virtual time of the caller
+ */
+void Timeline_Job(Timeline_JobPoint_t point, uint8_t block_id, uint8_t job_type,
+                  Std_ReturnType result, uint64_t now_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TIMELINE_H */
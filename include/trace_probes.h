@@ -0,0 +1,99 @@
+/**
+ * @file trace_probes.h
+ * @brief Static tracepoints (SystemTap SDT / USDT) for perf, bpftrace and SystemTap
+ *
+ * - 每个探针编译为一条nop, 参数位置写入ELF .note.stapsdt节; 未附加时无其他开销
+ * - 与<sys/sdt.h>格式相同, 不依赖systemtap头文件; 参数一律按8字节无符号传递
+ * - 提供者: eep (读/编程/擦除进出), memif (作业提交/完成), nvm (作业入队/出队/完成, CRC),
+ *   ram_mirror (seqlock重试), sched (任务分派)
+ * - -DPROBES_DISABLED (make PROBES=0) 或非ELF/非x86_64/aarch64目标时编译为空
+ *
+ * Usage (unmodified binaries):
+ *   bpftrace -l 'usdt:build/lib/libnvm.so:*'
+ *   perf buildid-cache --add build/lib/libnvm.so && perf record -e 'sdt_nvm:*' ...
+ */
+
+#ifndef TRACE_PROBES_H
+#define TRACE_PROBES_H
+
+#include <stdint.h>
+
+#if !defined(PROBES_DISABLED) && defined(__GNUC__) && defined(__ELF__) && \
+    (defined(__x86_64__) || defined(__aarch64__))
+
+#define TRACE_PROBES_ENABLED 1
+
+/**
+ * @brief Operand constraint of probe arguments (registers, memory or constants on x86)
+ */
+#if defined(__x86_64__)
+#define TRACE_PROBE_CONSTRAINT "nor"
+#else
+#define TRACE_PROBE_CONSTRAINT "r"
+#endif
+
+/**
+ * @brief Probe site: a nop plus its stapsdt note (address, base, semaphore, names, arguments)
+ */
+#define TRACE_PROBE_ASM(provider, name, args) \
+    "990: nop\n" \
+    ".pushsection .note.stapsdt,\"\",\"note\"\n" \
+    ".balign 4\n" \
+    ".4byte 992f-991f, 994f-993f, 3\n" \
+    "991: .asciz \"stapsdt\"\n" \
+    "992: .balign 4\n" \
+    "993: .8byte 990b\n" \
+    ".8byte _.stapsdt.base\n" \
+    ".8byte 0\n" \
+    ".asciz \"" #provider "\"\n" \
+    ".asciz \"" #name "\"\n" \
+    ".asciz \"" args "\"\n" \
+    "994: .balign 4\n" \
+    ".popsection\n" \
+    ".ifndef _.stapsdt.base\n" \
+    ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n" \
+    ".weak _.stapsdt.base\n" \
+    ".hidden _.stapsdt.base\n" \
+    "_.stapsdt.base: .space 1\n" \
+    ".size _.stapsdt.base, 1\n" \
+    ".popsection\n" \
+    ".endif\n"
+
+#define TRACE_PROBE_ARG(n, x) [a##n] TRACE_PROBE_CONSTRAINT ((uint64_t)(x))
+
+#define TRACE_PROBE0(provider, name) \
+    __asm__ __volatile__(TRACE_PROBE_ASM(provider, name, "") : :)
+
+#define TRACE_PROBE1(provider, name, x1) \
+    __asm__ __volatile__(TRACE_PROBE_ASM(provider, name, "8@%[a1]") \
+                         : : TRACE_PROBE_ARG(1, x1))
+
+#define TRACE_PROBE2(provider, name, x1, x2) \
+    __asm__ __volatile__(TRACE_PROBE_ASM(provider, name, "8@%[a1] 8@%[a2]") \
+                         : : TRACE_PROBE_ARG(1, x1), TRACE_PROBE_ARG(2, x2))
+
+#define TRACE_PROBE3(provider, name, x1, x2, x3) \
+    __asm__ __volatile__(TRACE_PROBE_ASM(provider, name, "8@%[a1] 8@%[a2] 8@%[a3]") \
+                         : : TRACE_PROBE_ARG(1, x1), TRACE_PROBE_ARG(2, x2), \
+                             TRACE_PROBE_ARG(3, x3))
+
+#define TRACE_PROBE4(provider, name, x1, x2, x3, x4) \
+    __asm__ __volatile__(TRACE_PROBE_ASM(provider, name, "8@%[a1] 8@%[a2] 8@%[a3] 8@%[a4]") \
+                         : : TRACE_PROBE_ARG(1, x1), TRACE_PROBE_ARG(2, x2), \
+                             TRACE_PROBE_ARG(3, x3), TRACE_PROBE_ARG(4, x4))
+
+#else
+
+#define TRACE_PROBES_ENABLED 0
+
+#define TRACE_PROBE0(provider, name) do { } while (0)
+#define TRACE_PROBE1(provider, name, x1) do { (void)(x1); } while (0)
+#define TRACE_PROBE2(provider, name, x1, x2) do { (void)(x1); (void)(x2); } while (0)
+#define TRACE_PROBE3(provider, name, x1, x2, x3) \
+    do { (void)(x1); (void)(x2); (void)(x3); } while (0)
+#define TRACE_PROBE4(provider, name, x1, x2, x3, x4) \
+    do { (void)(x1); (void)(x2); (void)(x3); (void)(x4); } while (0)
+
+#endif
+
+#endif /* TRACE_PROBES_H */
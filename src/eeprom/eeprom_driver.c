@@ -4,81 +4,186 @@
  *
  * REQ-EEPROM物理参数模型: design/01-EEPROM基础知识.md §1
  * - 容量、页大小、块大小参数化
- * - 读/写/擦除延时模拟
+ * - 读/写/擦除延时模拟 (时序模型见 eeprom_timing.c)
  * - 寿命计数与跟踪
+ * - 延时指标: 每次读/写/擦除记录主机耗时与模型器件延时 (metrics.h)
+ * - I/O跟踪: 捕获开启时每次读/写/擦除/校验追加一条记录 (eeprom_trace.h)
+ * - 写校验: 器件内部比较 (Eep_Verify), 主机侧按字/SIMD比较, 不拷贝数据
+ * - 位清除编程: EEP_PROGRAM_BIT_CLEAR模式下, 非空页只要只需1→0转换即可编程
+ * - 主机视图: Eep_GetStorageView/Eep_GetEraseCountView 只读零拷贝访问镜像与擦写计数 (可视化工具)
+ * - 片上ECC (EEP_CAP_ECC): 编程时生成校验字节, 读出后逐字纠正单比特错误 (eeprom_ecc.c)
+ * - 多实例: 驱动/ECC/时序状态属于上下文 (Eep_CreateContext), 线程绑定的上下文生效
  */
 
 #include "eeprom_driver.h"
+#include "eeprom_geometry.h"
+#include "eeprom_internal.h"
+#include "eeprom_trace.h"
 #include "fault_injection.h"
+#include "metrics.h"
+#include "os_scheduler.h"
+#include "sim_context.h"
+#include "timeline.h"
+#include "trace_probes.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 /**
  * @brief Default EEPROM configuration
  *
  * Based on automotive industry typical values
  */
 static const Eeprom_ConfigType default_config = {
+#if EEP_GEOM_FIXED
+    .capacity_bytes = EEP_GEOM_CAPACITY, /**< Part profile (eeprom_geometry.h) */
+    .page_size = EEP_GEOM_PAGE_SIZE,
+    .block_size = EEP_GEOM_BLOCK_SIZE,
+#else
     .capacity_bytes = 4096,      /**< 4KB capacity */
     .page_size = 256,            /**< 256B pages */
     .block_size = 1024,          /**< 1KB blocks (4 blocks total) */
+#endif
     .read_delay_us = 50,         /**< 50µs per byte */
     .write_delay_ms = 2,         /**< 2ms per page */
     .erase_delay_ms = 3,         /**< 3ms per block */
     .endurance_cycles = 100000,  /**< 100K cycles endurance */
-    .virtual_storage = NULL
+    .virtual_storage = NULL,
+    .backend = NULL,             /**< Flat array backend */
+    .capabilities = EEP_CAP_BIT_CLEAR /**< EEPROM cells program 1→0 in place */
 };
 
 /**
- * @brief Global configuration pointer
+ * @brief Device geometry: constants and shifts under a part profile, the context configuration otherwise
  */
-static Eeprom_ConfigType g_config = {0};
+#if EEP_GEOM_FIXED
+#define GEOM_CAPACITY        EEP_GEOM_CAPACITY
+#define GEOM_PAGE_SIZE       EEP_GEOM_PAGE_SIZE
+#define GEOM_BLOCK_SIZE      EEP_GEOM_BLOCK_SIZE
+#define GEOM_PAGE_INDEX(a)   ((uint32_t)(a) >> EEP_GEOM_PAGE_SHIFT)
+#define GEOM_PAGE_OFFSET(a)  ((uint32_t)(a) & (EEP_GEOM_PAGE_SIZE - 1U))
+#define GEOM_BLOCK_INDEX(a)  ((uint32_t)(a) >> EEP_GEOM_BLOCK_SHIFT)
+#define GEOM_BLOCK_OFFSET(a) ((uint32_t)(a) & (EEP_GEOM_BLOCK_SIZE - 1U))
+#else
+#define GEOM_CAPACITY        (driver_state()->config.capacity_bytes)
+#define GEOM_PAGE_SIZE       (driver_state()->config.page_size)
+#define GEOM_BLOCK_SIZE      (driver_state()->config.block_size)
+#define GEOM_PAGE_INDEX(a)   ((uint32_t)(a) / GEOM_PAGE_SIZE)
+#define GEOM_PAGE_OFFSET(a)  ((uint32_t)(a) % GEOM_PAGE_SIZE)
+#define GEOM_BLOCK_INDEX(a)  ((uint32_t)(a) / GEOM_BLOCK_SIZE)
+#define GEOM_BLOCK_OFFSET(a) ((uint32_t)(a) % GEOM_BLOCK_SIZE)
+#endif
 
 /**
- * @brief Per-block erase count tracking
+ * @brief Erase counters per lazily allocated chunk
  */
-static uint32_t *g_erase_counts = NULL;
+#define EEP_ERASE_COUNT_CHUNK 1024U
 
 /**
- * @brief Diagnostic counters
+ * @brief Bytes read per step when encoding an existing image
  */
-static Eeprom_DiagInfoType g_diagnostics = {0};
+#define EEP_ECC_ENCODE_CHUNK 256U
 
 /**
- * @brief Time scale factor for simulation speed control
+ * @brief Driver state of one EEPROM context
  */
-static uint32_t g_time_scale = 1;
+struct Eep_DriverState {
+    Eeprom_ConfigType config;           /**< Active configuration */
+
+    /**
+     * Per-block erase count tracking. Two-level table: chunks of
+     * EEP_ERASE_COUNT_CHUNK counters are only allocated once a block
+     * inside them is erased.
+     */
+    uint32_t **erase_counts;
+    uint32_t erase_count_chunks;
+    uint32_t *backend_erase_counts;     /**< Dense counters owned by the backend (e.g. mmap sidecar) */
+
+    /**
+     * Per-page "known erased" bitmap. A set bit means the page is known to
+     * read all 0xFF, so the blank check before a program and a repeated
+     * erase can be skipped. Bits start clear (unknown) and are set by
+     * erase or a successful blank check, cleared by program.
+     */
+    uint64_t *erased_bitmap;
+    uint32_t num_pages;
+
+    Eeprom_DiagInfoType snapshot_diagnostics; /**< Captured by Eep_Snapshot() */
+    boolean snapshot_valid;
+    const Eep_BackendOps_t *backend;    /**< Active storage backend */
+    void *backend_ctx;
+    Eeprom_DiagInfoType diagnostics;
+    Eep_ProgramMode_t program_mode;     /**< Program acceptance rule (reset by Eep_Init) */
+    uint32_t time_scale;                /**< Simulation speed factor */
+    Eep_CutHook_t cut_hook;             /**< Program/erase observer (powercut_explorer.c) */
+    boolean initialized;
+};
 
 /**
- * @brief Initialization flag
+ * @brief State used while no context is bound
  */
-static boolean g_initialized = FALSE;
+static struct Eep_DriverState g_default_state = {
+    .program_mode = EEP_PROGRAM_BLANK,
+    .time_scale = 1
+};
+
+static struct Eep_DriverState* driver_state(void)
+{
+    Eep_Context_t *ctx = (Eep_Context_t *)SimContext_Get(SIM_CONTEXT_EEP);
+
+    return (ctx != NULL) ? ctx->driver : &g_default_state;
+}
 
 /**
- * @brief Simulate delay (affected by time scale)
+ * @brief Configured delay of one operation in microseconds
  *
- * @param delay_us Delay in microseconds (real-time)
+ * @param op Operation kind
+ * @param length Bytes transferred (rounded up to pages for writes)
  */
-static void simulate_delay_us(uint32_t delay_us)
+static uint32_t nominal_delay_us(Eep_OpType_t op, uint32_t length)
 {
-    /* In real simulation, this would use the virtual OS scheduler
-     * For now, just a placeholder */
-    (void)delay_us;
-    (void)g_time_scale;
+    struct Eep_DriverState *drv = driver_state();
+    uint64_t delay_us;
+
+    switch (op) {
+        case EEP_OP_READ:
+        case EEP_OP_VERIFY:
+            delay_us = (uint64_t)length * drv->config.read_delay_us;
+            break;
+        case EEP_OP_WRITE: {
+            uint32_t pages = (GEOM_PAGE_SIZE > 0U) ? GEOM_PAGE_INDEX(length + GEOM_PAGE_SIZE - 1U) : 0U;
+            delay_us = (uint64_t)pages * drv->config.write_delay_ms * 1000U;
+            break;
+        }
+        case EEP_OP_ERASE:
+            delay_us = (uint64_t)drv->config.erase_delay_ms * 1000U;
+            break;
+        default:
+            delay_us = 0;
+            break;
+    }
+
+    return (delay_us > 0xFFFFFFFFU) ? 0xFFFFFFFFU : (uint32_t)delay_us;
 }
 
 /**
- * @brief Simulate delay in milliseconds
+ * @brief Simulate the device time of one operation (affected by time scale)
  *
- * @param delay_ms Delay in milliseconds (real-time)
+ * @param op Operation kind
+ * @param length Bytes transferred
+ * @return Modelled device latency in microseconds
  */
-static void simulate_delay_ms(uint32_t delay_ms)
+static uint32_t simulate_delay(Eep_OpType_t op, uint32_t length)
 {
-    /* Apply time scale */
-    uint32_t scaled_delay = delay_ms / g_time_scale;
-    (void)scaled_delay;
-    /* Actual delay would be implemented by virtual OS scheduler */
+    struct Eep_DriverState *drv = driver_state();
+
+    return Eep_Timing_Charge(op, nominal_delay_us(op, length), drv->time_scale);
 }
 
 /**
@@ -90,15 +195,14 @@ static void simulate_delay_ms(uint32_t delay_ms)
  */
 static boolean validate_address(uint32_t address, uint32_t length)
 {
-    if (!g_initialized) {
-        return FALSE;
-    }
+    struct Eep_DriverState *drv = driver_state();
 
-    if (address >= g_config.capacity_bytes) {
+    if (!drv->initialized) {
         return FALSE;
     }
 
-    if ((address + length) > g_config.capacity_bytes) {
+    /* No overflow: length is compared with the room left after address */
+    if (address >= GEOM_CAPACITY || length > (GEOM_CAPACITY - address)) {
         return FALSE;
     }
 
@@ -113,48 +217,574 @@ static boolean validate_address(uint32_t address, uint32_t length)
  */
 static uint32_t address_to_block(uint32_t address)
 {
-    return address / g_config.block_size;
+    return GEOM_BLOCK_INDEX(address);
+}
+
+/**
+ * @brief Get erase counter of a block
+ *
+ * @param block_idx Block index
+ * @param create Allocate the counter chunk if missing
+ * @return Counter pointer, or NULL if not allocated
+ */
+static uint32_t* erase_count_slot(uint32_t block_idx, boolean create)
+{
+    struct Eep_DriverState *drv = driver_state();
+    uint32_t chunk = block_idx / EEP_ERASE_COUNT_CHUNK;
+
+    if (drv->backend_erase_counts != NULL) {
+        return &drv->backend_erase_counts[block_idx];
+    }
+
+    if (chunk >= drv->erase_count_chunks) {
+        return NULL;
+    }
+
+    if (drv->erase_counts[chunk] == NULL) {
+        if (!create) {
+            return NULL;
+        }
+        drv->erase_counts[chunk] = (uint32_t *)calloc(EEP_ERASE_COUNT_CHUNK, sizeof(uint32_t));
+        if (drv->erase_counts[chunk] == NULL) {
+            return NULL;
+        }
+    }
+
+    return &drv->erase_counts[chunk][block_idx % EEP_ERASE_COUNT_CHUNK];
+}
+
+/**
+ * @brief Release erase count tracking
+ */
+static void erase_counts_free(void)
+{
+    struct Eep_DriverState *drv = driver_state();
+
+    if (drv->erase_counts != NULL) {
+        for (uint32_t i = 0; i < drv->erase_count_chunks; i++) {
+            free(drv->erase_counts[i]);
+        }
+        free(drv->erase_counts);
+        drv->erase_counts = NULL;
+    }
+    drv->erase_count_chunks = 0;
+    drv->backend_erase_counts = NULL;
+}
+
+/**
+ * @brief Re-read backend-owned state after the backend remapped it
+ */
+static void backend_refresh(void)
+{
+    struct Eep_DriverState *drv = driver_state();
+
+    drv->backend_erase_counts = (drv->backend->erase_counts != NULL) ?
+                             drv->backend->erase_counts(drv->backend_ctx) : NULL;
+}
+
+boolean Eep_BufferIsBlank(const uint8_t *data, uint32_t length)
+{
+    uint32_t i = 0;
+
+    /* Head: reach 8-byte alignment */
+    while (i < length && (((uintptr_t)&data[i]) & 7U) != 0U) {
+        if (data[i] != 0xFF) {
+            return FALSE;
+        }
+        i++;
+    }
+
+#if defined(__SSE2__)
+    const __m128i ones = _mm_set1_epi8((char)0xFF);
+    for (; i + 64U <= length; i += 64U) {
+        __m128i v0 = _mm_loadu_si128((const __m128i *)&data[i]);
+        __m128i v1 = _mm_loadu_si128((const __m128i *)&data[i + 16U]);
+        __m128i v2 = _mm_loadu_si128((const __m128i *)&data[i + 32U]);
+        __m128i v3 = _mm_loadu_si128((const __m128i *)&data[i + 48U]);
+        __m128i v = _mm_and_si128(_mm_and_si128(v0, v1), _mm_and_si128(v2, v3));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, ones)) != 0xFFFF) {
+            return FALSE;
+        }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for (; i + 64U <= length; i += 64U) {
+        uint8x16_t v = vandq_u8(vandq_u8(vld1q_u8(&data[i]), vld1q_u8(&data[i + 16U])),
+                                vandq_u8(vld1q_u8(&data[i + 32U]), vld1q_u8(&data[i + 48U])));
+        if (vminvq_u8(v) != 0xFFU) {
+            return FALSE;
+        }
+    }
+#endif
+
+    /* 64-bit words, four at a time */
+    for (; i + 32U <= length; i += 32U) {
+        uint64_t w[4];
+        memcpy(w, &data[i], sizeof(w));
+        if ((w[0] & w[1] & w[2] & w[3]) != UINT64_MAX) {
+            return FALSE;
+        }
+    }
+    for (; i + 8U <= length; i += 8U) {
+        uint64_t w;
+        memcpy(&w, &data[i], sizeof(w));
+        if (w != UINT64_MAX) {
+            return FALSE;
+        }
+    }
+
+    /* Tail */
+    for (; i < length; i++) {
+        if (data[i] != 0xFF) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+boolean Eep_BufferEqual(const uint8_t *a, const uint8_t *b, uint32_t length)
+{
+    uint32_t i = 0;
+
+#if defined(__SSE2__)
+    for (; i + 64U <= length; i += 64U) {
+        __m128i d0 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)&a[i]),
+                                   _mm_loadu_si128((const __m128i *)&b[i]));
+        __m128i d1 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)&a[i + 16U]),
+                                   _mm_loadu_si128((const __m128i *)&b[i + 16U]));
+        __m128i d2 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)&a[i + 32U]),
+                                   _mm_loadu_si128((const __m128i *)&b[i + 32U]));
+        __m128i d3 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)&a[i + 48U]),
+                                   _mm_loadu_si128((const __m128i *)&b[i + 48U]));
+        __m128i d = _mm_or_si128(_mm_or_si128(d0, d1), _mm_or_si128(d2, d3));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(d, _mm_setzero_si128())) != 0xFFFF) {
+            return FALSE;
+        }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for (; i + 64U <= length; i += 64U) {
+        uint8x16_t d = vorrq_u8(vorrq_u8(veorq_u8(vld1q_u8(&a[i]), vld1q_u8(&b[i])),
+                                         veorq_u8(vld1q_u8(&a[i + 16U]), vld1q_u8(&b[i + 16U]))),
+                                vorrq_u8(veorq_u8(vld1q_u8(&a[i + 32U]), vld1q_u8(&b[i + 32U])),
+                                         veorq_u8(vld1q_u8(&a[i + 48U]), vld1q_u8(&b[i + 48U]))));
+        if (vmaxvq_u8(d) != 0U) {
+            return FALSE;
+        }
+    }
+#endif
+
+    /* 64-bit words */
+    for (; i + 8U <= length; i += 8U) {
+        uint64_t wa, wb;
+        memcpy(&wa, &a[i], sizeof(wa));
+        memcpy(&wb, &b[i], sizeof(wb));
+        if (wa != wb) {
+            return FALSE;
+        }
+    }
+
+    /* Tail */
+    for (; i < length; i++) {
+        if (a[i] != b[i]) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+boolean Eep_BufferCanProgram(const uint8_t *cells, const uint8_t *data, uint32_t length)
+{
+    uint32_t i = 0;
+
+#if defined(__SSE2__)
+    for (; i + 64U <= length; i += 64U) {
+        /* andnot(cells, data): bits that would have to go 0→1 */
+        __m128i d0 = _mm_andnot_si128(_mm_loadu_si128((const __m128i *)&cells[i]),
+                                      _mm_loadu_si128((const __m128i *)&data[i]));
+        __m128i d1 = _mm_andnot_si128(_mm_loadu_si128((const __m128i *)&cells[i + 16U]),
+                                      _mm_loadu_si128((const __m128i *)&data[i + 16U]));
+        __m128i d2 = _mm_andnot_si128(_mm_loadu_si128((const __m128i *)&cells[i + 32U]),
+                                      _mm_loadu_si128((const __m128i *)&data[i + 32U]));
+        __m128i d3 = _mm_andnot_si128(_mm_loadu_si128((const __m128i *)&cells[i + 48U]),
+                                      _mm_loadu_si128((const __m128i *)&data[i + 48U]));
+        __m128i d = _mm_or_si128(_mm_or_si128(d0, d1), _mm_or_si128(d2, d3));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(d, _mm_setzero_si128())) != 0xFFFF) {
+            return FALSE;
+        }
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for (; i + 64U <= length; i += 64U) {
+        uint8x16_t d = vorrq_u8(vorrq_u8(vbicq_u8(vld1q_u8(&data[i]), vld1q_u8(&cells[i])),
+                                         vbicq_u8(vld1q_u8(&data[i + 16U]), vld1q_u8(&cells[i + 16U]))),
+                                vorrq_u8(vbicq_u8(vld1q_u8(&data[i + 32U]), vld1q_u8(&cells[i + 32U])),
+                                         vbicq_u8(vld1q_u8(&data[i + 48U]), vld1q_u8(&cells[i + 48U]))));
+        if (vmaxvq_u8(d) != 0U) {
+            return FALSE;
+        }
+    }
+#endif
+
+    /* 64-bit words */
+    for (; i + 8U <= length; i += 8U) {
+        uint64_t wc, wd;
+        memcpy(&wc, &cells[i], sizeof(wc));
+        memcpy(&wd, &data[i], sizeof(wd));
+        if ((wd & ~wc) != 0U) {
+            return FALSE;
+        }
+    }
+
+    /* Tail */
+    for (; i < length; i++) {
+        if ((data[i] & (uint8_t)~cells[i]) != 0U) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Check whether every page in [address, address+length) is known erased
+ */
+static boolean pages_known_erased(uint32_t address, uint32_t length)
+{
+    struct Eep_DriverState *drv = driver_state();
+    uint32_t first = GEOM_PAGE_INDEX(address);
+    uint32_t last = GEOM_PAGE_INDEX(address + length - 1U);
+
+    for (uint32_t page = first; page <= last; page++) {
+        if ((drv->erased_bitmap[page >> 6] & (1ULL << (page & 63U))) == 0U) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Set or clear the known-erased bits of a range
+ */
+static void pages_mark_erased(uint32_t address, uint32_t length, boolean erased)
+{
+    struct Eep_DriverState *drv = driver_state();
+    uint32_t first = GEOM_PAGE_INDEX(address);
+    uint32_t last = GEOM_PAGE_INDEX(address + length - 1U);
+
+    for (uint32_t page = first; page <= last; page++) {
+        if (erased) {
+            drv->erased_bitmap[page >> 6] |= (1ULL << (page & 63U));
+        } else {
+            drv->erased_bitmap[page >> 6] &= ~(1ULL << (page & 63U));
+        }
+    }
+}
+
+/**
+ * @brief Forget all known-erased state (storage changed behind the driver)
+ */
+static void pages_forget(void)
+{
+    struct Eep_DriverState *drv = driver_state();
+
+    memset(drv->erased_bitmap, 0, ((drv->num_pages + 63U) / 64U) * sizeof(uint64_t));
+}
+
+/* ============================================================================
+ * Flat Array Backend
+ * ============================================================================ */
+
+/**
+ * @brief Check bytes for the whole current image (ECC enabled over existing content)
+ */
+static void ecc_encode_image(void)
+{
+    struct Eep_DriverState *drv = driver_state();
+    uint8_t chunk[EEP_ECC_ENCODE_CHUNK];
+
+    for (uint32_t address = 0; address < GEOM_CAPACITY; address += sizeof(chunk)) {
+        uint32_t length = GEOM_CAPACITY - address;
+        if (length > sizeof(chunk)) {
+            length = sizeof(chunk);
+        }
+        drv->backend->read(drv->backend_ctx, address, chunk, length);
+        Eep_Ecc_Encode(address, chunk, length);
+    }
+}
+
+/**
+ * @brief Correct the words of a read buffer after the fault hooks
+ *
+ * Words only partly inside the buffer are checked with the rest taken
+ * from the cells.
+ */
+static void ecc_correct(uint32_t address, uint8_t *data, uint32_t length)
+{
+    struct Eep_DriverState *drv = driver_state();
+    uint32_t end = address + length;
+
+    for (uint32_t word = address - (address % EEP_ECC_WORD_SIZE); word < end;
+         word += EEP_ECC_WORD_SIZE) {
+        Eep_EccResult_t result;
+
+        if (word >= address && word + EEP_ECC_WORD_SIZE <= end) {
+            result = Eep_Ecc_Correct(word, &data[word - address]);
+        } else {
+            uint8_t cells[EEP_ECC_WORD_SIZE];
+            uint32_t from = (word < address) ? address : word;
+            uint32_t to = (word + EEP_ECC_WORD_SIZE > end) ? end : word + EEP_ECC_WORD_SIZE;
+
+            drv->backend->read(drv->backend_ctx, word, cells, EEP_ECC_WORD_SIZE);
+            memcpy(&cells[from - word], &data[from - address], to - from);
+            result = Eep_Ecc_Correct(word, cells);
+            memcpy(&data[from - address], &cells[from - word], to - from);
+        }
+
+        if (result == EEP_ECC_CORRECTED) {
+            drv->diagnostics.ecc_corrected_count++;
+        } else if (result == EEP_ECC_UNCORRECTABLE) {
+            drv->diagnostics.ecc_uncorrectable_count++;
+        }
+    }
+}
+
+static Std_ReturnType flat_init(Eeprom_ConfigType *config, void **ctx)
+{
+    if (config->virtual_storage == NULL) {
+        config->virtual_storage = (uint8_t *)calloc(config->capacity_bytes, sizeof(uint8_t));
+        if (config->virtual_storage == NULL) {
+            return E_NOT_OK;
+        }
+
+        /* Initialize with 0xFF (erased state) */
+        memset(config->virtual_storage, 0xFF, config->capacity_bytes);
+    }
+
+    *ctx = config->virtual_storage;
+    return E_OK;
+}
+
+static void flat_destroy(void *ctx)
+{
+    free(ctx);
+}
+
+static void flat_read(void *ctx, uint32_t address, uint8_t *dst, uint32_t length)
+{
+    memcpy(dst, (uint8_t *)ctx + address, length);
+}
+
+static Std_ReturnType flat_write(void *ctx, uint32_t address, const uint8_t *src, uint32_t length)
+{
+    memcpy((uint8_t *)ctx + address, src, length);
+    return E_OK;
+}
+
+static Std_ReturnType flat_erase(void *ctx, uint32_t address, uint32_t length)
+{
+    memset((uint8_t *)ctx + address, 0xFF, length);
+    return E_OK;
+}
+
+static boolean flat_is_blank(void *ctx, uint32_t address, uint32_t length)
+{
+    return Eep_BufferIsBlank((const uint8_t *)ctx + address, length);
+}
+
+static boolean flat_compare(void *ctx, uint32_t address, const uint8_t *expected, uint32_t length)
+{
+    return Eep_BufferEqual((const uint8_t *)ctx + address, expected, length);
+}
+
+static boolean flat_is_programmable(void *ctx, uint32_t address, const uint8_t *src,
+                                    uint32_t length)
+{
+    return Eep_BufferCanProgram((const uint8_t *)ctx + address, src, length);
+}
+
+static const uint8_t* flat_view(void *ctx, uint32_t address, uint32_t *length)
+{
+    (void)length;
+    return (const uint8_t *)ctx + address;
+}
+
+static uint32_t flat_resident_bytes(void *ctx)
+{
+    struct Eep_DriverState *drv = driver_state();
+
+    (void)ctx;
+    return drv->config.capacity_bytes;
+}
+
+static const Eep_BackendOps_t g_flat_backend = {
+    .name = "flat",
+    .init = flat_init,
+    .destroy = flat_destroy,
+    .read = flat_read,
+    .write = flat_write,
+    .erase = flat_erase,
+    .is_blank = flat_is_blank,
+    .compare = flat_compare,
+    .resident_bytes = flat_resident_bytes,
+    .is_programmable = flat_is_programmable,
+    .view = flat_view
+};
+
+const Eep_BackendOps_t* Eep_GetFlatBackend(void)
+{
+    return &g_flat_backend;
+}
+
+/**
+ * @brief Counter source for Metrics_Export
+ */
+static uint32_t eep_counters(Metrics_Counter_t *counters, uint32_t max)
+{
+    Eeprom_DiagInfoType diag;
+    uint32_t n = 0;
+
+    if (Eep_GetDiagnostics(&diag) != E_OK) {
+        return 0;
+    }
+
+#define EEP_COUNTER(field) \
+    do { \
+        if (n < max) { \
+            counters[n].name = #field; \
+            counters[n].value = diag.field; \
+            n++; \
+        } \
+    } while (0)
+
+    EEP_COUNTER(total_read_count);
+    EEP_COUNTER(total_write_count);
+    EEP_COUNTER(total_erase_count);
+    EEP_COUNTER(max_erase_count);
+    EEP_COUNTER(crc_error_count);
+    EEP_COUNTER(total_bytes_read);
+    EEP_COUNTER(total_bytes_written);
+    EEP_COUNTER(resident_bytes);
+    EEP_COUNTER(skipped_erase_count);
+    EEP_COUNTER(skipped_blank_check_count);
+    EEP_COUNTER(total_verify_count);
+    EEP_COUNTER(verify_mismatch_count);
+    EEP_COUNTER(bit_clear_write_count);
+    EEP_COUNTER(ecc_corrected_count);
+    EEP_COUNTER(ecc_uncorrectable_count);
+
+#undef EEP_COUNTER
+
+    return n;
 }
 
 Std_ReturnType Eep_Init(const Eeprom_ConfigType *config)
 {
+    struct Eep_DriverState *drv = driver_state();
+
+    /* Re-initialization starts from a fresh image */
+    if (drv->initialized) {
+        Eep_Destroy();
+    }
+
     if (config == NULL) {
         /* Use default configuration */
-        g_config = default_config;
+        drv->config = default_config;
     } else {
         /* Use provided configuration */
-        g_config = *config;
+        drv->config = *config;
+    }
+
+#if EEP_GEOM_FIXED
+    /* A part profile compiles the geometry in: the device must match it */
+    if (drv->config.capacity_bytes != EEP_GEOM_CAPACITY || drv->config.page_size != EEP_GEOM_PAGE_SIZE ||
+        drv->config.block_size != EEP_GEOM_BLOCK_SIZE) {
+        return E_NOT_OK;
+    }
+#endif
+
+    if (drv->config.backend == NULL) {
+        drv->config.backend = (drv->config.image_path != NULL) ? Eep_GetMmapBackend() : &g_flat_backend;
     }
 
     /* Allocate virtual storage */
-    if (g_config.virtual_storage == NULL) {
-        g_config.virtual_storage = (uint8_t *)calloc(g_config.capacity_bytes, sizeof(uint8_t));
-        if (g_config.virtual_storage == NULL) {
-            return E_NOT_OK;
-        }
+    if (drv->config.backend->init(&drv->config, &drv->backend_ctx) != E_OK) {
+        return E_NOT_OK;
+    }
+    drv->backend = drv->config.backend;
 
-        /* Initialize with 0xFF (erased state) */
-        memset(g_config.virtual_storage, 0xFF, g_config.capacity_bytes);
+    /* Allocate erase count directory (chunks allocated on first erase) */
+    uint32_t num_blocks = drv->config.capacity_bytes / drv->config.block_size;
+    drv->erase_count_chunks = (num_blocks + EEP_ERASE_COUNT_CHUNK - 1U) / EEP_ERASE_COUNT_CHUNK;
+    drv->erase_counts = (uint32_t **)calloc(drv->erase_count_chunks, sizeof(uint32_t *));
+    if (drv->erase_counts == NULL) {
+        drv->erase_count_chunks = 0;
+        drv->backend->destroy(drv->backend_ctx);
+        drv->backend = NULL;
+        drv->backend_ctx = NULL;
+        drv->config.virtual_storage = NULL;
+        return E_NOT_OK;
     }
 
-    /* Allocate erase count tracking */
-    uint32_t num_blocks = g_config.capacity_bytes / g_config.block_size;
-    g_erase_counts = (uint32_t *)calloc(num_blocks, sizeof(uint32_t));
-    if (g_erase_counts == NULL) {
-        free(g_config.virtual_storage);
-        g_config.virtual_storage = NULL;
+    /* Allocate known-erased bitmap (all pages start unknown) */
+    drv->num_pages = (drv->config.capacity_bytes + drv->config.page_size - 1U) / drv->config.page_size;
+    drv->erased_bitmap = (uint64_t *)calloc((drv->num_pages + 63U) / 64U, sizeof(uint64_t));
+    if (drv->erased_bitmap == NULL) {
+        erase_counts_free();
+        drv->backend->destroy(drv->backend_ctx);
+        drv->backend = NULL;
+        drv->backend_ctx = NULL;
+        drv->config.virtual_storage = NULL;
         return E_NOT_OK;
     }
 
+    /* Check bytes of the initial image (a persistent image is trusted as stored) */
+    if ((drv->config.capabilities & EEP_CAP_ECC) != 0U) {
+        if ((drv->config.page_size % EEP_ECC_WORD_SIZE) != 0U ||
+            Eep_Ecc_Init(drv->config.capacity_bytes) != E_OK) {
+            free(drv->erased_bitmap);
+            drv->erased_bitmap = NULL;
+            drv->num_pages = 0;
+            erase_counts_free();
+            drv->backend->destroy(drv->backend_ctx);
+            drv->backend = NULL;
+            drv->backend_ctx = NULL;
+            drv->config.virtual_storage = NULL;
+            return E_NOT_OK;
+        }
+        ecc_encode_image();
+    }
+
     /* Reset diagnostics */
-    memset(&g_diagnostics, 0, sizeof(Eeprom_DiagInfoType));
+    memset(&drv->diagnostics, 0, sizeof(Eeprom_DiagInfoType));
+    Eep_Timing_ResetStats();
+    drv->program_mode = EEP_PROGRAM_BLANK;
+    drv->snapshot_valid = FALSE;
 
-    g_initialized = TRUE;
+    /* Persistent erase counts carry over from a pre-aged image */
+    backend_refresh();
+    if (drv->backend_erase_counts != NULL) {
+        for (uint32_t i = 0; i < num_blocks; i++) {
+            if (drv->backend_erase_counts[i] > drv->diagnostics.max_erase_count) {
+                drv->diagnostics.max_erase_count = drv->backend_erase_counts[i];
+            }
+        }
+    }
+
+    (void)Metrics_RegisterCounterSource("eep", eep_counters);
+
+    drv->initialized = TRUE;
     return E_OK;
 }
 
-Std_ReturnType Eep_Read(uint32_t address, uint8_t *data_buffer, uint32_t length)
+/**
+ * @brief Read (untraced); device_us receives the modelled latency
+ */
+static Std_ReturnType eep_read(uint32_t address, uint8_t *data_buffer, uint32_t length,
+                               uint32_t *device_us)
 {
+    struct Eep_DriverState *drv = driver_state();
+
     /* Validate parameters */
     if (data_buffer == NULL) {
         return E_NOT_OK;
@@ -164,31 +794,48 @@ Std_ReturnType Eep_Read(uint32_t address, uint8_t *data_buffer, uint32_t length)
         return E_NOT_OK;
     }
 
+    uint64_t start_ns = METRICS_ENABLED() ? Metrics_HostNs() : 0U;
+
     /* Fault injection hook: Before read */
-    if (FaultInj_HookBeforeRead(address, length)) {
+    if (FAULT_INJ_ARMED(FAULT_INJ_MASK_BEFORE_READ) && FaultInj_HookBeforeRead(address, length)) {
         /* Hook indicates read should be blocked */
         return E_NOT_OK;
     }
 
     /* Simulate read delay */
-    uint32_t total_delay_us = length * g_config.read_delay_us;
-    simulate_delay_us(total_delay_us);
+    *device_us = simulate_delay(EEP_OP_READ, length);
 
     /* Read data from virtual storage */
-    memcpy(data_buffer, &g_config.virtual_storage[address], length);
+    drv->backend->read(drv->backend_ctx, address, data_buffer, length);
 
     /* Fault injection hook: After read (bit flip) */
-    FaultInj_HookAfterRead(data_buffer, length);
+    if (FAULT_INJ_ARMED(FAULT_INJ_MASK_AFTER_READ)) {
+        FaultInj_HookAfterRead(address, data_buffer, length);
+    }
+
+    if (Eep_Ecc_Enabled()) {
+        ecc_correct(address, data_buffer, length);
+    }
 
     /* Update diagnostics */
-    g_diagnostics.total_read_count++;
-    g_diagnostics.total_bytes_read += length;
+    drv->diagnostics.total_read_count++;
+    drv->diagnostics.total_bytes_read += length;
+
+    if (METRICS_ENABLED()) {
+        Metrics_Record(METRIC_EEP_READ, Metrics_HostNs() - start_ns, *device_us);
+    }
 
     return E_OK;
 }
 
-Std_ReturnType Eep_Write(uint32_t address, const uint8_t *data_buffer, uint32_t length)
+/**
+ * @brief Program (untraced); device_us receives the modelled latency
+ */
+static Std_ReturnType eep_write(uint32_t address, const uint8_t *data_buffer, uint32_t length,
+                                uint32_t *device_us)
 {
+    struct Eep_DriverState *drv = driver_state();
+
     /* Validate parameters */
     if (data_buffer == NULL) {
         return E_NOT_OK;
@@ -198,8 +845,10 @@ Std_ReturnType Eep_Write(uint32_t address, const uint8_t *data_buffer, uint32_t
         return E_NOT_OK;
     }
 
+    uint64_t start_ns = METRICS_ENABLED() ? Metrics_HostNs() : 0U;
+
     /* Fault injection hook: Before write (e.g., erase timeout) */
-    if (FaultInj_HookBeforeWrite(address, length)) {
+    if (FAULT_INJ_ARMED(FAULT_INJ_MASK_BEFORE_WRITE) && FaultInj_HookBeforeWrite(address, length)) {
         /* Hook indicates write should be blocked */
         return E_NOT_OK;
     }
@@ -209,34 +858,53 @@ Std_ReturnType Eep_Write(uint32_t address, const uint8_t *data_buffer, uint32_t
         return E_NOT_OK;
     }
 
-    if ((length % g_config.page_size) != 0) {
+    if (GEOM_PAGE_OFFSET(length) != 0U) {
         return E_NOT_OK;
     }
 
-    /* Check if target pages are empty (0xFF) */
-    for (uint32_t i = 0; i < length; i++) {
-        if (g_config.virtual_storage[address + i] != 0xFF) {
+    /* Check if target pages are empty (0xFF), or in bit-clear mode only
+     * need 1→0 transitions */
+    boolean bit_clear = FALSE;
+    if (pages_known_erased(address, length)) {
+        drv->diagnostics.skipped_blank_check_count++;
+    } else if (!drv->backend->is_blank(drv->backend_ctx, address, length)) {
+        if (drv->program_mode != EEP_PROGRAM_BIT_CLEAR ||
+            !drv->backend->is_programmable(drv->backend_ctx, address, data_buffer, length)) {
             /* Page not empty, need erase first */
             return E_NOT_OK;
         }
+        bit_clear = TRUE;
     }
 
-    /* Calculate number of pages */
-    uint32_t num_pages = length / g_config.page_size;
+    if (drv->cut_hook != NULL) {
+        drv->cut_hook(EEP_OP_WRITE, address, data_buffer, length);
+    }
 
-    /* Simulate write delay */
-    uint32_t total_delay_ms = num_pages * g_config.write_delay_ms;
-    simulate_delay_ms(total_delay_ms);
+    /* Simulate write delay (write_delay_ms per page) */
+    *device_us = simulate_delay(EEP_OP_WRITE, length);
 
     /* Write data to virtual storage */
-    memcpy(&g_config.virtual_storage[address], data_buffer, length);
+    if (drv->backend->write(drv->backend_ctx, address, data_buffer, length) != E_OK) {
+        return E_NOT_OK;
+    }
+    pages_mark_erased(address, length, FALSE);
+    if (Eep_Ecc_Enabled()) {
+        Eep_Ecc_Encode(address, data_buffer, length);
+    }
 
     /* Update diagnostics */
-    g_diagnostics.total_write_count++;
-    g_diagnostics.total_bytes_written += length;
+    drv->diagnostics.total_write_count++;
+    drv->diagnostics.total_bytes_written += length;
+    if (bit_clear) {
+        drv->diagnostics.bit_clear_write_count++;
+    }
+
+    if (METRICS_ENABLED()) {
+        Metrics_Record(METRIC_EEP_WRITE, Metrics_HostNs() - start_ns, *device_us);
+    }
 
     /* Fault injection hook: After write (e.g., power loss) */
-    if (FaultInj_HookAfterWrite(address)) {
+    if (FAULT_INJ_ARMED(FAULT_INJ_MASK_AFTER_WRITE) && FaultInj_HookAfterWrite(address)) {
         /* Power loss simulated - data written but may be inconsistent */
         return E_NOT_OK;
     }
@@ -244,10 +912,15 @@ Std_ReturnType Eep_Write(uint32_t address, const uint8_t *data_buffer, uint32_t
     return E_OK;
 }
 
-Std_ReturnType Eep_Erase(uint32_t address)
+/**
+ * @brief Erase (untraced); device_us receives the modelled latency
+ */
+static Std_ReturnType eep_erase(uint32_t address, uint32_t *device_us)
 {
+    struct Eep_DriverState *drv = driver_state();
+
     /* Validate parameters */
-    if (!validate_address(address, g_config.block_size)) {
+    if (!validate_address(address, GEOM_BLOCK_SIZE)) {
         return E_NOT_OK;
     }
 
@@ -259,92 +932,663 @@ Std_ReturnType Eep_Erase(uint32_t address)
     /* Get block index */
     uint32_t block_idx = address_to_block(address);
 
+    uint32_t *erase_count = erase_count_slot(block_idx, TRUE);
+    if (erase_count == NULL) {
+        return E_NOT_OK;
+    }
+
     /* Check endurance */
-    if (g_erase_counts[block_idx] >= g_config.endurance_cycles) {
+    if (*erase_count >= drv->config.endurance_cycles) {
         /* Endurance exceeded */
         return E_NOT_OK;
     }
 
+    if (drv->cut_hook != NULL) {
+        drv->cut_hook(EEP_OP_ERASE, address, NULL, GEOM_BLOCK_SIZE);
+    }
+
     /* Simulate erase delay */
-    simulate_delay_ms(g_config.erase_delay_ms);
+    uint64_t start_ns = METRICS_ENABLED() ? Metrics_HostNs() : 0U;
+    *device_us = simulate_delay(EEP_OP_ERASE, GEOM_BLOCK_SIZE);
 
-    /* Erase block (set to 0xFF) */
-    memset(&g_config.virtual_storage[address], 0xFF, g_config.block_size);
+    /* Erase block (set to 0xFF); the cycle still counts as wear when the
+     * block is already known erased, only the backend work is skipped */
+    if (pages_known_erased(address, GEOM_BLOCK_SIZE)) {
+        drv->diagnostics.skipped_erase_count++;
+    } else {
+        if (drv->backend->erase(drv->backend_ctx, address, GEOM_BLOCK_SIZE) != E_OK) {
+            return E_NOT_OK;
+        }
+        pages_mark_erased(address, GEOM_BLOCK_SIZE, TRUE);
+        if (Eep_Ecc_Enabled()) {
+            Eep_Ecc_Erase(address, GEOM_BLOCK_SIZE);
+        }
+    }
 
     /* Update erase count */
-    g_erase_counts[block_idx]++;
-    g_diagnostics.total_erase_count++;
+    (*erase_count)++;
+    drv->diagnostics.total_erase_count++;
 
     /* Update max erase count */
-    if (g_erase_counts[block_idx] > g_diagnostics.max_erase_count) {
-        g_diagnostics.max_erase_count = g_erase_counts[block_idx];
+    if (*erase_count > drv->diagnostics.max_erase_count) {
+        drv->diagnostics.max_erase_count = *erase_count;
+    }
+
+    if (METRICS_ENABLED()) {
+        Metrics_Record(METRIC_EEP_ERASE, Metrics_HostNs() - start_ns, *device_us);
+    }
+
+    return E_OK;
+}
+
+/**
+ * @brief Compare (untraced); device_us receives the modelled latency
+ */
+static Std_ReturnType eep_verify(uint32_t address, const uint8_t *expected_data, uint32_t length,
+                                 uint32_t *device_us)
+{
+    struct Eep_DriverState *drv = driver_state();
+
+    if (expected_data == NULL) {
+        return E_NOT_OK;
+    }
+
+    if (!validate_address(address, length)) {
+        return E_NOT_OK;
+    }
+
+    uint64_t start_ns = METRICS_ENABLED() ? Metrics_HostNs() : 0U;
+
+    /* Fault injection hook: Before read (the cells are sensed as for a read) */
+    if (FAULT_INJ_ARMED(FAULT_INJ_MASK_BEFORE_READ) && FaultInj_HookBeforeRead(address, length)) {
+        return E_NOT_OK;
+    }
+
+    /* Simulate compare delay */
+    *device_us = simulate_delay(EEP_OP_VERIFY, length);
+
+    /* Compare in place: nothing is copied out of virtual storage */
+    boolean match = drv->backend->compare(drv->backend_ctx, address, expected_data, length);
+
+    /* Fault injection hook: Forced verification failure */
+    if (match && FAULT_INJ_ARMED(FAULT_INJ_MASK_VERIFY) &&
+        FaultInj_HookVerify(address, expected_data, length)) {
+        match = FALSE;
+    }
+
+    /* Update diagnostics */
+    drv->diagnostics.total_verify_count++;
+    if (!match) {
+        drv->diagnostics.verify_mismatch_count++;
+    }
+
+    if (METRICS_ENABLED()) {
+        Metrics_Record(METRIC_EEP_VERIFY, Metrics_HostNs() - start_ns, *device_us);
+    }
+
+    return match ? E_OK : E_NOT_OK;
+}
+
+/**
+ * @brief Vectored read (untraced); device_us receives the modelled latency
+ */
+static Std_ReturnType eep_read_v(const Eep_IoVec_t *iov, uint32_t count, uint32_t *device_us)
+{
+    struct Eep_DriverState *drv = driver_state();
+    uint32_t total = 0;
+
+    if (iov == NULL || count == 0U) {
+        return E_NOT_OK;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (iov[i].buffer == NULL || !validate_address(iov[i].address, iov[i].length)) {
+            return E_NOT_OK;
+        }
+        total += iov[i].length;
+    }
+
+    uint64_t start_ns = METRICS_ENABLED() ? Metrics_HostNs() : 0U;
+
+    /* Fault injection hook: Before read, per segment */
+    if (FAULT_INJ_ARMED(FAULT_INJ_MASK_BEFORE_READ)) {
+        for (uint32_t i = 0; i < count; i++) {
+            if (FaultInj_HookBeforeRead(iov[i].address, iov[i].length)) {
+                return E_NOT_OK;
+            }
+        }
+    }
+
+    /* One command: the latency is charged once for the whole vector */
+    *device_us = simulate_delay(EEP_OP_READ, total);
+
+    for (uint32_t i = 0; i < count; i++) {
+        drv->backend->read(drv->backend_ctx, iov[i].address, (uint8_t *)iov[i].buffer, iov[i].length);
+        if (FAULT_INJ_ARMED(FAULT_INJ_MASK_AFTER_READ)) {
+            FaultInj_HookAfterRead(iov[i].address, (uint8_t *)iov[i].buffer, iov[i].length);
+        }
+        if (Eep_Ecc_Enabled()) {
+            ecc_correct(iov[i].address, (uint8_t *)iov[i].buffer, iov[i].length);
+        }
+    }
+
+    drv->diagnostics.total_read_count++;
+    drv->diagnostics.total_bytes_read += total;
+
+    if (METRICS_ENABLED()) {
+        Metrics_Record(METRIC_EEP_READ, Metrics_HostNs() - start_ns, *device_us);
+    }
+
+    return E_OK;
+}
+
+/**
+ * @brief Vectored program (untraced); device_us receives the modelled latency
+ *
+ * @param programmed Receives the number of segments that completed
+ */
+static Std_ReturnType eep_write_v(const Eep_IoVec_t *iov, uint32_t count, uint32_t *device_us,
+                                  uint32_t *programmed)
+{
+    struct Eep_DriverState *drv = driver_state();
+    uint32_t total = 0;
+    uint32_t bit_clear = 0;
+
+    *programmed = 0;
+    if (iov == NULL || count == 0U) {
+        return E_NOT_OK;
+    }
+
+    /* Every segment is checked before the first page changes */
+    for (uint32_t i = 0; i < count; i++) {
+        const Eep_IoVec_t *v = &iov[i];
+        if (v->buffer == NULL || !validate_address(v->address, v->length) ||
+            GEOM_PAGE_OFFSET(v->address) != 0U || GEOM_PAGE_OFFSET(v->length) != 0U) {
+            return E_NOT_OK;
+        }
+        if (FAULT_INJ_ARMED(FAULT_INJ_MASK_BEFORE_WRITE) &&
+            FaultInj_HookBeforeWrite(v->address, v->length)) {
+            return E_NOT_OK;
+        }
+        if (pages_known_erased(v->address, v->length)) {
+            drv->diagnostics.skipped_blank_check_count++;
+        } else if (!drv->backend->is_blank(drv->backend_ctx, v->address, v->length)) {
+            if (drv->program_mode != EEP_PROGRAM_BIT_CLEAR ||
+                !drv->backend->is_programmable(drv->backend_ctx, v->address, (const uint8_t *)v->buffer,
+                                            v->length)) {
+                return E_NOT_OK;
+            }
+            bit_clear++;
+        }
+        total += v->length;
+    }
+
+    uint64_t start_ns = METRICS_ENABLED() ? Metrics_HostNs() : 0U;
+    *device_us = simulate_delay(EEP_OP_WRITE, total);
+
+    drv->diagnostics.total_write_count++;
+    drv->diagnostics.bit_clear_write_count += bit_clear;
+
+    for (uint32_t i = 0; i < count; i++) {
+        const Eep_IoVec_t *v = &iov[i];
+        if (drv->cut_hook != NULL) {
+            drv->cut_hook(EEP_OP_WRITE, v->address, (const uint8_t *)v->buffer, v->length);
+        }
+        if (drv->backend->write(drv->backend_ctx, v->address, (const uint8_t *)v->buffer, v->length) != E_OK) {
+            return E_NOT_OK;
+        }
+        pages_mark_erased(v->address, v->length, FALSE);
+        if (Eep_Ecc_Enabled()) {
+            Eep_Ecc_Encode(v->address, (const uint8_t *)v->buffer, v->length);
+        }
+        drv->diagnostics.total_bytes_written += v->length;
+
+        /* Fault injection hook: After write (power loss stops the vector here) */
+        if (FAULT_INJ_ARMED(FAULT_INJ_MASK_AFTER_WRITE) && FaultInj_HookAfterWrite(v->address)) {
+            return E_NOT_OK;
+        }
+        (*programmed)++;
+    }
+
+    if (METRICS_ENABLED()) {
+        Metrics_Record(METRIC_EEP_WRITE, Metrics_HostNs() - start_ns, *device_us);
+    }
+
+    return E_OK;
+}
+
+Std_ReturnType Eep_Read(uint32_t address, uint8_t *data_buffer, uint32_t length)
+{
+    boolean traced = EEP_TRACE_ACTIVE();
+    uint32_t virtual_ms = traced ? OsScheduler_GetVirtualTimeMs() : 0U;
+    uint64_t timeline_us = TIMELINE_ACTIVE() ? OsScheduler_GetVirtualTimeUs() : 0U;
+    uint32_t device_us = 0U;
+
+    TRACE_PROBE2(eep, read_start, address, length);
+    Std_ReturnType ret = eep_read(address, data_buffer, length, &device_us);
+    TRACE_PROBE4(eep, read_done, address, length, ret, device_us);
+    if (traced) {
+        EepTrace_Record(EEP_OP_READ, ret, address, length, (ret == E_OK) ? data_buffer : NULL,
+                        virtual_ms, device_us);
+    }
+    if (TIMELINE_ACTIVE()) {
+        Timeline_DeviceOp(EEP_OP_READ, ret, address, length, timeline_us, device_us);
+    }
+    return ret;
+}
+
+Std_ReturnType Eep_Write(uint32_t address, const uint8_t *data_buffer, uint32_t length)
+{
+    boolean traced = EEP_TRACE_ACTIVE();
+    uint32_t virtual_ms = traced ? OsScheduler_GetVirtualTimeMs() : 0U;
+    uint64_t timeline_us = TIMELINE_ACTIVE() ? OsScheduler_GetVirtualTimeUs() : 0U;
+    uint32_t device_us = 0U;
+
+    TRACE_PROBE2(eep, program_start, address, length);
+    Std_ReturnType ret = eep_write(address, data_buffer, length, &device_us);
+    TRACE_PROBE4(eep, program_done, address, length, ret, device_us);
+    if (traced) {
+        EepTrace_Record(EEP_OP_WRITE, ret, address, length, (ret == E_OK) ? data_buffer : NULL,
+                        virtual_ms, device_us);
+    }
+    if (TIMELINE_ACTIVE()) {
+        Timeline_DeviceOp(EEP_OP_WRITE, ret, address, length, timeline_us, device_us);
+    }
+    return ret;
+}
+
+Std_ReturnType Eep_ReadV(const Eep_IoVec_t *iov, uint32_t count)
+{
+    boolean traced = EEP_TRACE_ACTIVE();
+    uint32_t virtual_ms = traced ? OsScheduler_GetVirtualTimeMs() : 0U;
+    uint64_t timeline_us = TIMELINE_ACTIVE() ? OsScheduler_GetVirtualTimeUs() : 0U;
+    uint32_t device_us = 0U;
+
+    TRACE_PROBE1(eep, readv_start, count);
+    Std_ReturnType ret = eep_read_v(iov, count, &device_us);
+    TRACE_PROBE3(eep, readv_done, count, ret, device_us);
+    if (traced && iov != NULL) {
+        /* One record per segment; the command latency goes to the first */
+        for (uint32_t i = 0; i < count; i++) {
+            EepTrace_Record(EEP_OP_READ, ret, iov[i].address, iov[i].length,
+                            (ret == E_OK) ? iov[i].buffer : NULL, virtual_ms,
+                            (i == 0U) ? device_us : 0U);
+        }
+    }
+    if (TIMELINE_ACTIVE() && iov != NULL && count > 0U) {
+        /* One command: a single busy interval for the whole vector */
+        uint32_t total = 0U;
+        for (uint32_t i = 0; i < count; i++) {
+            total += iov[i].length;
+        }
+        Timeline_DeviceOp(EEP_OP_READ, ret, iov[0].address, total, timeline_us, device_us);
+    }
+    return ret;
+}
+
+Std_ReturnType Eep_WriteV(const Eep_IoVec_t *iov, uint32_t count)
+{
+    boolean traced = EEP_TRACE_ACTIVE();
+    uint32_t virtual_ms = traced ? OsScheduler_GetVirtualTimeMs() : 0U;
+    uint64_t timeline_us = TIMELINE_ACTIVE() ? OsScheduler_GetVirtualTimeUs() : 0U;
+    uint32_t device_us = 0U;
+    uint32_t programmed;
+
+    TRACE_PROBE1(eep, programv_start, count);
+    Std_ReturnType ret = eep_write_v(iov, count, &device_us, &programmed);
+    TRACE_PROBE3(eep, programv_done, count, ret, device_us);
+    if (traced && iov != NULL) {
+        /* Completed segments, then the one that failed (as Eep_Write records it) */
+        for (uint32_t i = 0; i < count; i++) {
+            Std_ReturnType seg = (i < programmed) ? E_OK : E_NOT_OK;
+            EepTrace_Record(EEP_OP_WRITE, seg, iov[i].address, iov[i].length,
+                            (seg == E_OK) ? iov[i].buffer : NULL, virtual_ms,
+                            (i == 0U) ? device_us : 0U);
+            if (seg != E_OK) {
+                break;
+            }
+        }
+    }
+    if (TIMELINE_ACTIVE() && iov != NULL && count > 0U) {
+        /* One command: a single busy interval for the whole vector */
+        uint32_t total = 0U;
+        for (uint32_t i = 0; i < count; i++) {
+            total += iov[i].length;
+        }
+        Timeline_DeviceOp(EEP_OP_WRITE, ret, iov[0].address, total, timeline_us, device_us);
+    }
+    return ret;
+}
+
+Std_ReturnType Eep_Erase(uint32_t address)
+{
+    boolean traced = EEP_TRACE_ACTIVE();
+    uint32_t virtual_ms = traced ? OsScheduler_GetVirtualTimeMs() : 0U;
+    uint64_t timeline_us = TIMELINE_ACTIVE() ? OsScheduler_GetVirtualTimeUs() : 0U;
+    uint32_t device_us = 0U;
+
+    TRACE_PROBE1(eep, erase_start, address);
+    Std_ReturnType ret = eep_erase(address, &device_us);
+    TRACE_PROBE3(eep, erase_done, address, ret, device_us);
+    if (traced) {
+        EepTrace_Record(EEP_OP_ERASE, ret, address, GEOM_BLOCK_SIZE, NULL,
+                        virtual_ms, device_us);
+    }
+    if (TIMELINE_ACTIVE()) {
+        Timeline_DeviceOp(EEP_OP_ERASE, ret, address, GEOM_BLOCK_SIZE, timeline_us, device_us);
+    }
+    return ret;
+}
+
+Std_ReturnType Eep_Verify(uint32_t address, const uint8_t *expected_data, uint32_t length)
+{
+    boolean traced = EEP_TRACE_ACTIVE();
+    uint32_t virtual_ms = traced ? OsScheduler_GetVirtualTimeMs() : 0U;
+    uint64_t timeline_us = TIMELINE_ACTIVE() ? OsScheduler_GetVirtualTimeUs() : 0U;
+    uint32_t device_us = 0U;
+
+    Std_ReturnType ret = eep_verify(address, expected_data, length, &device_us);
+    if (traced) {
+        EepTrace_Record(EEP_OP_VERIFY, ret, address, length, expected_data, virtual_ms, device_us);
+    }
+    if (TIMELINE_ACTIVE()) {
+        Timeline_DeviceOp(EEP_OP_VERIFY, ret, address, length, timeline_us, device_us);
+    }
+    return ret;
+}
+
+void Eep_SetCutHook(Eep_CutHook_t hook)
+{
+    struct Eep_DriverState *drv = driver_state();
+
+    drv->cut_hook = hook;
+}
+
+Std_ReturnType Eep_SetProgramMode(Eep_ProgramMode_t mode)
+{
+    struct Eep_DriverState *drv = driver_state();
+
+    if (!drv->initialized) {
+        return E_NOT_OK;
+    }
+
+    switch (mode) {
+        case EEP_PROGRAM_BLANK:
+            break;
+        case EEP_PROGRAM_BIT_CLEAR:
+            if ((drv->config.capabilities & EEP_CAP_BIT_CLEAR) == 0U ||
+                drv->backend->is_programmable == NULL) {
+                return E_NOT_OK;
+            }
+            break;
+        default:
+            return E_NOT_OK;
     }
 
+    drv->program_mode = mode;
     return E_OK;
 }
 
+Eep_ProgramMode_t Eep_GetProgramMode(void)
+{
+    struct Eep_DriverState *drv = driver_state();
+
+    return drv->program_mode;
+}
+
 Std_ReturnType Eep_GetDiagnostics(Eeprom_DiagInfoType *diag_info)
 {
+    struct Eep_DriverState *drv = driver_state();
+
     if (diag_info == NULL) {
         return E_NOT_OK;
     }
 
-    if (!g_initialized) {
+    if (!drv->initialized) {
+        return E_NOT_OK;
+    }
+
+    *diag_info = drv->diagnostics;
+    diag_info->resident_bytes = drv->backend->resident_bytes(drv->backend_ctx);
+    return E_OK;
+}
+
+/**
+ * @brief Get the erase count of one erase block
+ */
+Std_ReturnType Eep_GetEraseCount(uint32_t address, uint32_t *count)
+{
+    if (count == NULL || !validate_address(address, 1)) {
+        return E_NOT_OK;
+    }
+
+    uint32_t *erase_count = erase_count_slot(address_to_block(address), FALSE);
+    *count = (erase_count != NULL) ? *erase_count : 0U;
+    return E_OK;
+}
+
+Std_ReturnType Eep_AddEraseCount(uint32_t address, uint32_t cycles)
+{
+    struct Eep_DriverState *drv = driver_state();
+
+    if (!validate_address(address, 1)) {
+        return E_NOT_OK;
+    }
+
+    uint32_t *erase_count = erase_count_slot(address_to_block(address), TRUE);
+    if (erase_count == NULL) {
+        return E_NOT_OK;
+    }
+
+    /* A real block stops erasing at its endurance limit */
+    uint64_t aged = (uint64_t)*erase_count + cycles;
+    *erase_count = (aged > drv->config.endurance_cycles) ? drv->config.endurance_cycles : (uint32_t)aged;
+
+    if (*erase_count > drv->diagnostics.max_erase_count) {
+        drv->diagnostics.max_erase_count = *erase_count;
+    }
+    return E_OK;
+}
+
+Std_ReturnType Eep_GetStorageView(uint32_t address, const uint8_t **data, uint32_t *length)
+{
+    struct Eep_DriverState *drv = driver_state();
+
+    if (data == NULL || length == NULL || *length == 0U || !validate_address(address, *length) ||
+        drv->backend->view == NULL) {
+        return E_NOT_OK;
+    }
+
+    *data = drv->backend->view(drv->backend_ctx, address, length);
+    return E_OK;
+}
+
+Std_ReturnType Eep_GetEraseCountView(uint32_t block_index, const uint32_t **counts,
+                                     uint32_t *length)
+{
+    struct Eep_DriverState *drv = driver_state();
+
+    if (!drv->initialized || counts == NULL || length == NULL) {
+        return E_NOT_OK;
+    }
+
+    uint32_t num_blocks = GEOM_BLOCK_INDEX(GEOM_CAPACITY);
+    if (block_index >= num_blocks) {
         return E_NOT_OK;
     }
 
-    *diag_info = g_diagnostics;
+    if (drv->backend_erase_counts != NULL) {
+        *counts = &drv->backend_erase_counts[block_index];
+        *length = num_blocks - block_index;
+        return E_OK;
+    }
+
+    uint32_t chunk = block_index / EEP_ERASE_COUNT_CHUNK;
+    uint32_t end = (chunk + 1U) * EEP_ERASE_COUNT_CHUNK;
+    if (end > num_blocks) {
+        end = num_blocks;
+    }
+    *counts = (drv->erase_counts[chunk] != NULL)
+                  ? &drv->erase_counts[chunk][block_index % EEP_ERASE_COUNT_CHUNK] : NULL;
+    *length = end - block_index;
     return E_OK;
 }
 
 boolean Eep_IsPageAligned(uint32_t address)
 {
-    if (!g_initialized) {
+    struct Eep_DriverState *drv = driver_state();
+
+    if (!drv->initialized) {
         return FALSE;
     }
 
-    return (address % g_config.page_size) == 0;
+    return GEOM_PAGE_OFFSET(address) == 0U;
 }
 
 boolean Eep_IsBlockAligned(uint32_t address)
 {
-    if (!g_initialized) {
+    struct Eep_DriverState *drv = driver_state();
+
+    if (!drv->initialized) {
         return FALSE;
     }
 
-    return (address % g_config.block_size) == 0;
+    return GEOM_BLOCK_OFFSET(address) == 0U;
 }
 
 const Eeprom_ConfigType* Eep_GetConfig(void)
 {
-    if (!g_initialized) {
+    struct Eep_DriverState *drv = driver_state();
+
+    if (!drv->initialized) {
         return NULL;
     }
 
-    return &g_config;
+    return &drv->config;
 }
 
 Std_ReturnType Eep_SetTimeScale(uint32_t scale)
 {
+    struct Eep_DriverState *drv = driver_state();
+
     if (scale == 0) {
         return E_NOT_OK;
     }
 
-    g_time_scale = scale;
+    drv->time_scale = scale;
+    return E_OK;
+}
+
+uint32_t Eep_SampleLatencyUs(Eep_OpType_t op, uint32_t length)
+{
+    if ((uint32_t)op >= EEP_OP_COUNT) {
+        return 0;
+    }
+
+    return Eep_Timing_Sample(op, nominal_delay_us(op, length));
+}
+
+Std_ReturnType Eep_Snapshot(void)
+{
+    struct Eep_DriverState *drv = driver_state();
+
+    if (!drv->initialized || drv->backend->snapshot == NULL) {
+        return E_NOT_OK;
+    }
+
+    if (drv->backend->snapshot(drv->backend_ctx) != E_OK) {
+        return E_NOT_OK;
+    }
+    backend_refresh();
+
+    drv->snapshot_diagnostics = drv->diagnostics;
+    drv->snapshot_valid = TRUE;
+    return E_OK;
+}
+
+Std_ReturnType Eep_Restore(void)
+{
+    struct Eep_DriverState *drv = driver_state();
+
+    if (!drv->initialized || !drv->snapshot_valid || drv->backend->restore == NULL) {
+        return E_NOT_OK;
+    }
+
+    if (drv->backend->restore(drv->backend_ctx) != E_OK) {
+        return E_NOT_OK;
+    }
+    backend_refresh();
+    pages_forget();
+    if (Eep_Ecc_Enabled()) {
+        ecc_encode_image();
+    }
+
+    drv->diagnostics = drv->snapshot_diagnostics;
     return E_OK;
 }
 
 void Eep_Destroy(void)
 {
-    if (g_config.virtual_storage != NULL) {
-        free(g_config.virtual_storage);
-        g_config.virtual_storage = NULL;
+    struct Eep_DriverState *drv = driver_state();
+
+    if (drv->backend != NULL) {
+        drv->backend->destroy(drv->backend_ctx);
+        drv->backend = NULL;
+        drv->backend_ctx = NULL;
     }
+    drv->config.virtual_storage = NULL;
+
+    erase_counts_free();
+    Eep_Ecc_Destroy();
+    drv->snapshot_valid = FALSE;
 
-    if (g_erase_counts != NULL) {
-        free(g_erase_counts);
-        g_erase_counts = NULL;
+    free(drv->erased_bitmap);
+    drv->erased_bitmap = NULL;
+    drv->num_pages = 0;
+
+    drv->initialized = FALSE;
+}
+
+Eep_Context_t* Eep_CreateContext(void)
+{
+    Eep_Context_t *ctx = (Eep_Context_t *)calloc(1, sizeof(Eep_Context_t));
+
+    if (ctx == NULL) {
+        return NULL;
+    }
+
+    ctx->driver = (struct Eep_DriverState *)calloc(1, sizeof(struct Eep_DriverState));
+    ctx->ecc = Eep_Ecc_CreateState();
+    ctx->timing = Eep_Timing_CreateState();
+    if (ctx->driver == NULL || ctx->ecc == NULL || ctx->timing == NULL) {
+        Eep_DestroyContext(ctx);
+        return NULL;
     }
 
-    g_initialized = FALSE;
+    ctx->driver->program_mode = EEP_PROGRAM_BLANK;
+    ctx->driver->time_scale = 1;
+    return ctx;
+}
+
+void Eep_DestroyContext(Eep_Context_t *ctx)
+{
+    if (ctx == NULL) {
+        return;
+    }
+
+    if (ctx->driver != NULL && ctx->ecc != NULL && ctx->timing != NULL) {
+        Eep_Context_t *previous = Eep_BindContext(ctx);
+        Eep_Destroy();
+        (void)Eep_BindContext(previous);
+    }
+
+    free(ctx->driver);
+    Eep_Ecc_DestroyState(ctx->ecc);
+    Eep_Timing_DestroyState(ctx->timing);
+    free(ctx);
+}
+
+Eep_Context_t* Eep_BindContext(Eep_Context_t *ctx)
+{
+    return (Eep_Context_t *)SimContext_Bind(SIM_CONTEXT_EEP, ctx);
 }
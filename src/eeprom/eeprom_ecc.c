@@ -0,0 +1,211 @@
+/**
+ * @file eeprom_ecc.c
+ * @brief Per-word SECDED ECC of the simulated device (Hsiao (72,64) code)
+ *
+ * REQ-EEPROM物理参数模型: design/01-EEPROM基础知识.md §1
+ * - 每8字节数据字一个校验字节, 存放在独立的备用区 (不占用数据地址空间)
+ * - Hsiao码: 数据位列向量取奇数权重, 单比特错误可纠正, 双比特错误可检测
+ * - 查表计算校验子: 每字节位置一张256项表, 每字8次查表
+ */
+
+#include "eeprom_driver.h"
+#include "eeprom_internal.h"
+#include "sim_context.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Syndrome position marker: not a single-bit error
+ */
+#define ECC_NO_POSITION 0xFFU
+
+/**
+ * @brief Check byte contribution of each data byte value at each byte position
+ */
+static uint8_t g_syndrome[EEP_ECC_WORD_SIZE][256];
+
+/**
+ * @brief Syndrome to bit position (0-63 data, 64-71 check bit, ECC_NO_POSITION otherwise)
+ */
+static uint8_t g_position[256];
+
+/**
+ * @brief Check byte of an erased (all 0xFF) word
+ */
+static uint8_t g_erased_check = 0;
+
+/**
+ * @brief The code tables are built once and shared by every context
+ */
+static pthread_once_t g_tables_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief ECC state of one EEPROM context
+ */
+struct Eep_EccState {
+    uint8_t *check;                     /**< One check byte per data word, NULL = ECC off */
+    uint32_t words;
+};
+
+/**
+ * @brief State used while no context is bound
+ */
+static struct Eep_EccState g_default_state;
+
+static struct Eep_EccState* ecc_state(void)
+{
+    Eep_Context_t *ctx = (Eep_Context_t *)SimContext_Get(SIM_CONTEXT_EEP);
+
+    return (ctx != NULL) ? ctx->ecc : &g_default_state;
+}
+
+static uint8_t weight(uint32_t x)
+{
+    uint8_t n = 0;
+
+    for (; x != 0U; x &= x - 1U) {
+        n++;
+    }
+    return n;
+}
+
+/**
+ * @brief Build the code tables (H columns: the 56 weight-3 bytes, then 8 weight-5 bytes)
+ */
+static void build_tables(void)
+{
+    uint8_t column[EEP_ECC_WORD_SIZE * 8U];
+    uint32_t n = 0;
+
+    for (uint32_t w = 3U; w <= 5U; w += 2U) {
+        for (uint32_t c = 0; c < 256U && n < sizeof(column); c++) {
+            if (weight(c) == w) {
+                column[n++] = (uint8_t)c;
+            }
+        }
+    }
+
+    memset(g_position, ECC_NO_POSITION, sizeof(g_position));
+    for (uint32_t bit = 0; bit < sizeof(column); bit++) {
+        g_position[column[bit]] = (uint8_t)bit;
+    }
+    for (uint32_t k = 0; k < 8U; k++) {
+        g_position[1U << k] = (uint8_t)(sizeof(column) + k);
+    }
+
+    for (uint32_t pos = 0; pos < EEP_ECC_WORD_SIZE; pos++) {
+        for (uint32_t v = 0; v < 256U; v++) {
+            uint8_t s = 0;
+            for (uint32_t b = 0; b < 8U; b++) {
+                if ((v & (1U << b)) != 0U) {
+                    s ^= column[pos * 8U + b];
+                }
+            }
+            g_syndrome[pos][v] = s;
+        }
+    }
+
+    uint8_t erased[EEP_ECC_WORD_SIZE];
+    memset(erased, 0xFF, sizeof(erased));
+    g_erased_check = 0;
+    for (uint32_t pos = 0; pos < EEP_ECC_WORD_SIZE; pos++) {
+        g_erased_check ^= g_syndrome[pos][erased[pos]];
+    }
+}
+
+static uint8_t word_check(const uint8_t *word)
+{
+    return (uint8_t)(g_syndrome[0][word[0]] ^ g_syndrome[1][word[1]] ^
+                     g_syndrome[2][word[2]] ^ g_syndrome[3][word[3]] ^
+                     g_syndrome[4][word[4]] ^ g_syndrome[5][word[5]] ^
+                     g_syndrome[6][word[6]] ^ g_syndrome[7][word[7]]);
+}
+
+Std_ReturnType Eep_Ecc_Init(uint32_t capacity_bytes)
+{
+    struct Eep_EccState *ecc = ecc_state();
+
+    Eep_Ecc_Destroy();
+
+    if (capacity_bytes == 0U || (capacity_bytes % EEP_ECC_WORD_SIZE) != 0U) {
+        return E_NOT_OK;
+    }
+
+    ecc->check = (uint8_t *)malloc(capacity_bytes / EEP_ECC_WORD_SIZE);
+    if (ecc->check == NULL) {
+        return E_NOT_OK;
+    }
+    ecc->words = capacity_bytes / EEP_ECC_WORD_SIZE;
+
+    (void)pthread_once(&g_tables_once, build_tables);
+    memset(ecc->check, g_erased_check, ecc->words);
+    return E_OK;
+}
+
+void Eep_Ecc_Destroy(void)
+{
+    struct Eep_EccState *ecc = ecc_state();
+
+    free(ecc->check);
+    ecc->check = NULL;
+    ecc->words = 0;
+}
+
+boolean Eep_Ecc_Enabled(void)
+{
+    struct Eep_EccState *ecc = ecc_state();
+
+    return (ecc->check != NULL) ? TRUE : FALSE;
+}
+
+void Eep_Ecc_Encode(uint32_t address, const uint8_t *data, uint32_t length)
+{
+    struct Eep_EccState *ecc = ecc_state();
+    uint8_t *check = &ecc->check[address / EEP_ECC_WORD_SIZE];
+
+    for (uint32_t i = 0; i < length; i += EEP_ECC_WORD_SIZE) {
+        *check++ = word_check(&data[i]);
+    }
+}
+
+void Eep_Ecc_Erase(uint32_t address, uint32_t length)
+{
+    struct Eep_EccState *ecc = ecc_state();
+
+    memset(&ecc->check[address / EEP_ECC_WORD_SIZE], g_erased_check, length / EEP_ECC_WORD_SIZE);
+}
+
+Eep_EccResult_t Eep_Ecc_Correct(uint32_t address, uint8_t *word)
+{
+    struct Eep_EccState *ecc = ecc_state();
+    uint8_t syndrome = (uint8_t)(word_check(word) ^ ecc->check[address / EEP_ECC_WORD_SIZE]);
+
+    if (syndrome == 0U) {
+        return EEP_ECC_CLEAN;
+    }
+
+    uint8_t position = g_position[syndrome];
+    if (position == ECC_NO_POSITION) {
+        return EEP_ECC_UNCORRECTABLE;
+    }
+
+    /* A flipped check bit leaves the data intact */
+    if (position < EEP_ECC_WORD_SIZE * 8U) {
+        word[position / 8U] ^= (uint8_t)(1U << (position % 8U));
+    }
+    return EEP_ECC_CORRECTED;
+}
+
+struct Eep_EccState* Eep_Ecc_CreateState(void)
+{
+    return (struct Eep_EccState *)calloc(1, sizeof(struct Eep_EccState));
+}
+
+void Eep_Ecc_DestroyState(struct Eep_EccState *state)
+{
+    if (state != NULL) {
+        free(state->check);
+        free(state);
+    }
+}
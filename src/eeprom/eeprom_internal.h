@@ -0,0 +1,180 @@
+/**
+ * @file eeprom_internal.h
+ * @brief EEPROM driver internals shared between the driver and its backends
+ *
+ * Not part of the public API.
+ */
+
+#ifndef EEPROM_INTERNAL_H
+#define EEPROM_INTERNAL_H
+
+#include "common_types.h"
+#include "eeprom_driver.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief EEPROM context: the state of each driver translation unit
+ *
+ * While no context is bound, each file uses its static default state.
+ */
+struct Eep_Context {
+    struct Eep_DriverState *driver;     /**< eeprom_driver.c */
+    struct Eep_EccState *ecc;           /**< eeprom_ecc.c */
+    struct Eep_TimingState *timing;     /**< eeprom_timing.c */
+};
+
+/**
+ * @brief Allocate the ECC state of a new context (ECC off)
+ */
+struct Eep_EccState* Eep_Ecc_CreateState(void);
+
+/**
+ * @brief Free an ECC state and its check byte store
+ */
+void Eep_Ecc_DestroyState(struct Eep_EccState *state);
+
+/**
+ * @brief Allocate the timing state of a new context (timing off, constant models)
+ */
+struct Eep_TimingState* Eep_Timing_CreateState(void);
+
+/**
+ * @brief Free a timing state
+ */
+void Eep_Timing_DestroyState(struct Eep_TimingState *state);
+
+/**
+ * @brief Check that a buffer is entirely erased (0xFF)
+ *
+ * Word-wise kernel (SSE2/NEON when available) used by every backend's
+ * is_blank operation.
+ *
+ * @param data Buffer to check
+ * @param length Length in bytes
+ * @return TRUE if all bytes are 0xFF
+ */
+boolean Eep_BufferIsBlank(const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Check that two buffers hold the same bytes
+ *
+ * Same kernel layout as Eep_BufferIsBlank; used by every backend's
+ * compare operation.
+ *
+ * @param a First buffer
+ * @param b Second buffer
+ * @param length Length in bytes
+ * @return TRUE if equal
+ */
+boolean Eep_BufferEqual(const uint8_t *a, const uint8_t *b, uint32_t length);
+
+/**
+ * @brief Check that programming data over cells only clears bits
+ *
+ * Same kernel layout as Eep_BufferIsBlank; used by every backend's
+ * is_programmable operation.
+ *
+ * @param cells Current content
+ * @param data Content to program
+ * @param length Length in bytes
+ * @return TRUE if (cells & data) == data for every byte
+ */
+boolean Eep_BufferCanProgram(const uint8_t *cells, const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Charge one device operation to the timing model
+ *
+ * No-op with EEP_TIMING_OFF or while the clock is suspended.
+ *
+ * @param op Operation kind
+ * @param nominal_us Configured delay of the operation
+ * @param time_scale Eep_SetTimeScale factor (host sleep divisor)
+ * @return Latency charged, or nominal_us when nothing was charged
+ */
+uint32_t Eep_Timing_Charge(Eep_OpType_t op, uint32_t nominal_us, uint32_t time_scale);
+
+/**
+ * @brief Draw and account one latency around a nominal delay
+ */
+uint32_t Eep_Timing_Sample(Eep_OpType_t op, uint32_t nominal_us);
+
+/**
+ * @brief Clear timing statistics and the pending clock remainder (Eep_Init)
+ */
+void Eep_Timing_ResetStats(void);
+
+/**
+ * @brief Observer called just before the device programs or erases
+ *
+ * Called after every check has passed, so the operation will happen.
+ * Vectored programs call it once per segment.
+ *
+ * @param op EEP_OP_WRITE or EEP_OP_ERASE
+ * @param address Start of the program or erase unit
+ * @param data Bytes to program (NULL for an erase)
+ * @param length Bytes to program, or the erase unit size
+ */
+typedef void (*Eep_CutHook_t)(Eep_OpType_t op, uint32_t address, const uint8_t *data,
+                              uint32_t length);
+
+/**
+ * @brief Install the program/erase observer (NULL = none; power-cut explorer)
+ */
+void Eep_SetCutHook(Eep_CutHook_t hook);
+
+/**
+ * @brief Outcome of checking one data word against its check byte
+ */
+typedef enum {
+    EEP_ECC_CLEAN = 0,             /**< Syndrome zero */
+    EEP_ECC_CORRECTED,             /**< Single-bit error fixed (data or check bit) */
+    EEP_ECC_UNCORRECTABLE          /**< Double (or wider) error, data left as read */
+} Eep_EccResult_t;
+
+/**
+ * @brief Allocate the check byte store, every word erased (EEP_CAP_ECC)
+ *
+ * @param capacity_bytes Device capacity (multiple of EEP_ECC_WORD_SIZE)
+ */
+Std_ReturnType Eep_Ecc_Init(uint32_t capacity_bytes);
+
+/**
+ * @brief Free the check byte store (ECC off)
+ */
+void Eep_Ecc_Destroy(void);
+
+/**
+ * @brief TRUE between Eep_Ecc_Init and Eep_Ecc_Destroy
+ */
+boolean Eep_Ecc_Enabled(void);
+
+/**
+ * @brief Store the check bytes of programmed words
+ *
+ * @param address Word-aligned start
+ * @param data Cell content after programming
+ * @param length Multiple of EEP_ECC_WORD_SIZE
+ */
+void Eep_Ecc_Encode(uint32_t address, const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Reset the check bytes of erased words
+ */
+void Eep_Ecc_Erase(uint32_t address, uint32_t length);
+
+/**
+ * @brief Check one word as sensed and correct a single-bit error in place
+ *
+ * @param address Word-aligned device address of the word
+ * @param word EEP_ECC_WORD_SIZE bytes
+ */
+Eep_EccResult_t Eep_Ecc_Correct(uint32_t address, uint8_t *word);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EEPROM_INTERNAL_H */
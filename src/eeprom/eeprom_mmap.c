@@ -0,0 +1,348 @@
+/**
+ * @file eeprom_mmap.c
+ * @brief Memory-mapped persistent image file backend with snapshot/restore
+ *
+ * REQ-EEPROM物理参数模型: design/01-EEPROM基础知识.md §1
+ * - 镜像文件以MAP_SHARED映射，擦写直接落盘
+ * - 擦写计数保存在 "<image>.wear" 旁路文件 (带几何参数头)
+ * - 快照: 切换为MAP_PRIVATE写时复制，恢复时丢弃脏页
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "eeprom_driver.h"
+#include "eeprom_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * @brief Sidecar file magic ("EEPW") and version
+ */
+#define MMAP_WEAR_MAGIC   0x57504545U
+#define MMAP_WEAR_VERSION 1U
+
+/**
+ * @brief Sidecar header, followed by num_blocks uint32_t erase counts
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity_bytes;
+    uint32_t block_size;
+    uint32_t num_blocks;
+    uint32_t reserved[3];
+} MmapWearHeader_t;
+
+/**
+ * @brief A mapped file
+ */
+typedef struct {
+    int fd;
+    size_t size;
+    uint8_t *base;
+} MmapRegion_t;
+
+/**
+ * @brief mmap backend context
+ */
+typedef struct {
+    MmapRegion_t image;            /**< EEPROM content */
+    MmapRegion_t wear;             /**< Sidecar header + erase counts */
+    boolean is_private;            /**< Mapped MAP_PRIVATE (snapshot active) */
+    uint8_t **storage_alias;       /**< Config virtual_storage, kept on the live mapping */
+} MmapBackend_t;
+
+/**
+ * @brief Map a region with the given sharing mode
+ */
+static Std_ReturnType region_map(MmapRegion_t *r, int flags)
+{
+    void *p = mmap(NULL, r->size, PROT_READ | PROT_WRITE, flags, r->fd, 0);
+    if (p == MAP_FAILED) {
+        r->base = NULL;
+        return E_NOT_OK;
+    }
+
+    r->base = (uint8_t *)p;
+    return E_OK;
+}
+
+static void region_unmap(MmapRegion_t *r)
+{
+    if (r->base != NULL) {
+        munmap(r->base, r->size);
+        r->base = NULL;
+    }
+}
+
+static void region_close(MmapRegion_t *r)
+{
+    region_unmap(r);
+    if (r->fd >= 0) {
+        close(r->fd);
+        r->fd = -1;
+    }
+}
+
+/**
+ * @brief Open (or create) a file of exactly size bytes and map it shared
+ *
+ * @param created Set to TRUE if the file was empty or new
+ */
+static Std_ReturnType region_open(MmapRegion_t *r, const char *path, size_t size, boolean *created)
+{
+    struct stat st;
+
+    r->fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (r->fd < 0) {
+        return E_NOT_OK;
+    }
+
+    if (fstat(r->fd, &st) != 0) {
+        region_close(r);
+        return E_NOT_OK;
+    }
+
+    *created = (st.st_size == 0) ? TRUE : FALSE;
+    if (*created) {
+        if (ftruncate(r->fd, (off_t)size) != 0) {
+            region_close(r);
+            return E_NOT_OK;
+        }
+    } else if ((size_t)st.st_size != size) {
+        /* Geometry mismatch: refuse to reinterpret an existing image */
+        region_close(r);
+        return E_NOT_OK;
+    }
+
+    r->size = size;
+    if (region_map(r, MAP_SHARED) != E_OK) {
+        region_close(r);
+        return E_NOT_OK;
+    }
+
+    return E_OK;
+}
+
+static Std_ReturnType mmap_init(Eeprom_ConfigType *config, void **ctx)
+{
+    if (config->image_path == NULL || config->block_size == 0U) {
+        return E_NOT_OK;
+    }
+
+    MmapBackend_t *mb = (MmapBackend_t *)calloc(1, sizeof(MmapBackend_t));
+    if (mb == NULL) {
+        return E_NOT_OK;
+    }
+    mb->image.fd = -1;
+    mb->wear.fd = -1;
+
+    boolean created = FALSE;
+    if (region_open(&mb->image, config->image_path, config->capacity_bytes, &created) != E_OK) {
+        free(mb);
+        return E_NOT_OK;
+    }
+    if (created) {
+        memset(mb->image.base, 0xFF, mb->image.size);
+    }
+
+    /* Sidecar: "<image_path>.wear" */
+    size_t path_len = strlen(config->image_path);
+    char *wear_path = (char *)malloc(path_len + sizeof(".wear"));
+    if (wear_path == NULL) {
+        region_close(&mb->image);
+        free(mb);
+        return E_NOT_OK;
+    }
+    memcpy(wear_path, config->image_path, path_len);
+    memcpy(&wear_path[path_len], ".wear", sizeof(".wear"));
+
+    uint32_t num_blocks = config->capacity_bytes / config->block_size;
+    size_t wear_size = sizeof(MmapWearHeader_t) + (size_t)num_blocks * sizeof(uint32_t);
+    Std_ReturnType ret = region_open(&mb->wear, wear_path, wear_size, &created);
+    free(wear_path);
+    if (ret != E_OK) {
+        region_close(&mb->image);
+        free(mb);
+        return E_NOT_OK;
+    }
+
+    MmapWearHeader_t *hdr = (MmapWearHeader_t *)mb->wear.base;
+    if (created) {
+        hdr->magic = MMAP_WEAR_MAGIC;
+        hdr->version = MMAP_WEAR_VERSION;
+        hdr->capacity_bytes = config->capacity_bytes;
+        hdr->block_size = config->block_size;
+        hdr->num_blocks = num_blocks;
+    } else if (hdr->magic != MMAP_WEAR_MAGIC || hdr->version != MMAP_WEAR_VERSION ||
+               hdr->capacity_bytes != config->capacity_bytes ||
+               hdr->block_size != config->block_size) {
+        region_close(&mb->wear);
+        region_close(&mb->image);
+        free(mb);
+        return E_NOT_OK;
+    }
+
+    /* virtual_storage aliases the mapping for Eep_GetConfig() users */
+    mb->storage_alias = &config->virtual_storage;
+    *mb->storage_alias = mb->image.base;
+    *ctx = mb;
+    return E_OK;
+}
+
+static void mmap_destroy(void *ctx)
+{
+    MmapBackend_t *mb = (MmapBackend_t *)ctx;
+
+    if (mb == NULL) {
+        return;
+    }
+
+    /* Shared mappings are written back by munmap; private changes are dropped */
+    region_close(&mb->wear);
+    region_close(&mb->image);
+    free(mb);
+}
+
+static void mmap_read(void *ctx, uint32_t address, uint8_t *dst, uint32_t length)
+{
+    memcpy(dst, &((MmapBackend_t *)ctx)->image.base[address], length);
+}
+
+static Std_ReturnType mmap_write(void *ctx, uint32_t address, const uint8_t *src, uint32_t length)
+{
+    memcpy(&((MmapBackend_t *)ctx)->image.base[address], src, length);
+    return E_OK;
+}
+
+static Std_ReturnType mmap_erase(void *ctx, uint32_t address, uint32_t length)
+{
+    memset(&((MmapBackend_t *)ctx)->image.base[address], 0xFF, length);
+    return E_OK;
+}
+
+static boolean mmap_is_blank(void *ctx, uint32_t address, uint32_t length)
+{
+    return Eep_BufferIsBlank(&((MmapBackend_t *)ctx)->image.base[address], length);
+}
+
+static boolean mmap_compare(void *ctx, uint32_t address, const uint8_t *expected, uint32_t length)
+{
+    return Eep_BufferEqual(&((MmapBackend_t *)ctx)->image.base[address], expected, length);
+}
+
+static const uint8_t* mmap_view(void *ctx, uint32_t address, uint32_t *length)
+{
+    (void)length;
+    return &((MmapBackend_t *)ctx)->image.base[address];
+}
+
+static boolean mmap_is_programmable(void *ctx, uint32_t address, const uint8_t *src,
+                                    uint32_t length)
+{
+    return Eep_BufferCanProgram(&((MmapBackend_t *)ctx)->image.base[address], src, length);
+}
+
+static uint32_t mmap_resident_bytes(void *ctx)
+{
+    MmapBackend_t *mb = (MmapBackend_t *)ctx;
+    return (uint32_t)(mb->image.size + mb->wear.size);
+}
+
+static uint32_t* mmap_erase_counts(void *ctx)
+{
+    MmapBackend_t *mb = (MmapBackend_t *)ctx;
+    return (uint32_t *)(mb->wear.base + sizeof(MmapWearHeader_t));
+}
+
+/**
+ * @brief Write a private mapping's content back into its file
+ */
+static Std_ReturnType region_flush_private(MmapRegion_t *r)
+{
+    size_t done = 0;
+
+    while (done < r->size) {
+        ssize_t n = pwrite(r->fd, r->base + done, r->size - done, (off_t)done);
+        if (n <= 0) {
+            return E_NOT_OK;
+        }
+        done += (size_t)n;
+    }
+
+    return E_OK;
+}
+
+static Std_ReturnType mmap_remap_private(MmapRegion_t *r)
+{
+    region_unmap(r);
+    return region_map(r, MAP_PRIVATE);
+}
+
+static Std_ReturnType mmap_snapshot(void *ctx)
+{
+    MmapBackend_t *mb = (MmapBackend_t *)ctx;
+    MmapRegion_t *regions[2] = { &mb->image, &mb->wear };
+
+    for (uint32_t i = 0; i < 2U; i++) {
+        if (mb->is_private) {
+            /* Promote the current private state to the new restore point */
+            if (region_flush_private(regions[i]) != E_OK) {
+                return E_NOT_OK;
+            }
+        } else if (msync(regions[i]->base, regions[i]->size, MS_SYNC) != 0) {
+            return E_NOT_OK;
+        }
+
+        if (mmap_remap_private(regions[i]) != E_OK) {
+            return E_NOT_OK;
+        }
+    }
+
+    mb->is_private = TRUE;
+    *mb->storage_alias = mb->image.base;
+    return E_OK;
+}
+
+static Std_ReturnType mmap_restore(void *ctx)
+{
+    MmapBackend_t *mb = (MmapBackend_t *)ctx;
+
+    if (!mb->is_private) {
+        return E_NOT_OK;
+    }
+
+    if (mmap_remap_private(&mb->image) != E_OK ||
+        mmap_remap_private(&mb->wear) != E_OK) {
+        return E_NOT_OK;
+    }
+
+    *mb->storage_alias = mb->image.base;
+    return E_OK;
+}
+
+static const Eep_BackendOps_t g_mmap_backend = {
+    .name = "mmap",
+    .init = mmap_init,
+    .destroy = mmap_destroy,
+    .read = mmap_read,
+    .write = mmap_write,
+    .erase = mmap_erase,
+    .is_blank = mmap_is_blank,
+    .compare = mmap_compare,
+    .resident_bytes = mmap_resident_bytes,
+    .is_programmable = mmap_is_programmable,
+    .erase_counts = mmap_erase_counts,
+    .snapshot = mmap_snapshot,
+    .restore = mmap_restore,
+    .view = mmap_view
+};
+
+const Eep_BackendOps_t* Eep_GetMmapBackend(void)
+{
+    return &g_mmap_backend;
+}
@@ -0,0 +1,343 @@
+/**
+ * @file eeprom_sparse.c
+ * @brief Sparse copy-on-write storage backend for large EEPROM/flash images
+ *
+ * REQ-EEPROM物理参数模型: design/01-EEPROM基础知识.md §1
+ * - 仅为写入过的页分配内存，未触及的页读作0xFF
+ * - 可选只读基础镜像: 首次写入时复制页 (copy-on-write)
+ * - 页表为两级基数树，目录大小与容量成正比，叶表按需分配
+ */
+
+#include "eeprom_driver.h"
+#include "eeprom_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Page pointers per leaf table
+ */
+#define SPARSE_LEAF_SHIFT 10U
+#define SPARSE_LEAF_SIZE  (1U << SPARSE_LEAF_SHIFT)
+#define SPARSE_LEAF_MASK  (SPARSE_LEAF_SIZE - 1U)
+
+/**
+ * @brief Sparse backend context
+ *
+ * Page slot states:
+ * - NULL: untouched, reads from base image (or 0xFF without one)
+ * - g_sparse_erased: erased over a base image, reads 0xFF
+ * - other: privately owned page copy
+ */
+typedef struct {
+    uint32_t page_size;            /**< Page granularity of the page table */
+    uint32_t num_pages;            /**< Total page count */
+    uint32_t num_leaves;           /**< Directory size */
+    uint32_t resident_pages;       /**< Privately allocated pages */
+    uint32_t resident_leaves;      /**< Allocated leaf tables */
+    const uint8_t *base;           /**< Read-only base image (may be NULL) */
+    uint8_t ***dir;                /**< Directory of leaf tables */
+} SparseBackend_t;
+
+/**
+ * @brief Sentinel for pages erased over a base image
+ */
+static uint8_t g_sparse_erased;
+
+/**
+ * @brief Look up a page slot
+ *
+ * @param sb Backend context
+ * @param page Page index
+ * @param create Allocate the leaf table if missing
+ * @return Slot pointer, or NULL if the leaf does not exist
+ */
+static uint8_t** sparse_slot(SparseBackend_t *sb, uint32_t page, boolean create)
+{
+    uint32_t leaf = page >> SPARSE_LEAF_SHIFT;
+
+    if (sb->dir[leaf] == NULL) {
+        if (!create) {
+            return NULL;
+        }
+        sb->dir[leaf] = (uint8_t **)calloc(SPARSE_LEAF_SIZE, sizeof(uint8_t *));
+        if (sb->dir[leaf] == NULL) {
+            return NULL;
+        }
+        sb->resident_leaves++;
+    }
+
+    return &sb->dir[leaf][page & SPARSE_LEAF_MASK];
+}
+
+/**
+ * @brief Resolve the bytes currently visible for a page
+ *
+ * @return Page data, or NULL if the page reads as all 0xFF
+ */
+static const uint8_t* sparse_page_view(SparseBackend_t *sb, uint32_t page)
+{
+    uint8_t **slot = sparse_slot(sb, page, FALSE);
+    uint8_t *owned = (slot != NULL) ? *slot : NULL;
+
+    if (owned == &g_sparse_erased) {
+        return NULL;
+    }
+    if (owned != NULL) {
+        return owned;
+    }
+    if (sb->base != NULL) {
+        return &sb->base[page * sb->page_size];
+    }
+
+    return NULL;
+}
+
+static Std_ReturnType sparse_init(Eeprom_ConfigType *config, void **ctx)
+{
+    if (config->page_size == 0U) {
+        return E_NOT_OK;
+    }
+
+    SparseBackend_t *sb = (SparseBackend_t *)calloc(1, sizeof(SparseBackend_t));
+    if (sb == NULL) {
+        return E_NOT_OK;
+    }
+
+    sb->page_size = config->page_size;
+    sb->num_pages = (config->capacity_bytes + config->page_size - 1U) / config->page_size;
+    sb->num_leaves = (sb->num_pages + SPARSE_LEAF_SIZE - 1U) >> SPARSE_LEAF_SHIFT;
+    sb->base = config->virtual_storage;
+    sb->dir = (uint8_t ***)calloc(sb->num_leaves, sizeof(uint8_t **));
+    if (sb->dir == NULL) {
+        free(sb);
+        return E_NOT_OK;
+    }
+
+    *ctx = sb;
+    return E_OK;
+}
+
+static void sparse_destroy(void *ctx)
+{
+    SparseBackend_t *sb = (SparseBackend_t *)ctx;
+
+    if (sb == NULL) {
+        return;
+    }
+
+    for (uint32_t leaf = 0; leaf < sb->num_leaves; leaf++) {
+        if (sb->dir[leaf] == NULL) {
+            continue;
+        }
+        for (uint32_t i = 0; i < SPARSE_LEAF_SIZE; i++) {
+            if (sb->dir[leaf][i] != &g_sparse_erased) {
+                free(sb->dir[leaf][i]);
+            }
+        }
+        free(sb->dir[leaf]);
+    }
+
+    /* The base image belongs to the caller */
+    free(sb->dir);
+    free(sb);
+}
+
+static void sparse_read(void *ctx, uint32_t address, uint8_t *dst, uint32_t length)
+{
+    SparseBackend_t *sb = (SparseBackend_t *)ctx;
+
+    while (length > 0U) {
+        uint32_t page = address / sb->page_size;
+        uint32_t in_page = address % sb->page_size;
+        uint32_t chunk = sb->page_size - in_page;
+        if (chunk > length) {
+            chunk = length;
+        }
+
+        const uint8_t *view = sparse_page_view(sb, page);
+        if (view != NULL) {
+            memcpy(dst, &view[in_page], chunk);
+        } else {
+            memset(dst, 0xFF, chunk);
+        }
+
+        address += chunk;
+        dst += chunk;
+        length -= chunk;
+    }
+}
+
+static Std_ReturnType sparse_write(void *ctx, uint32_t address, const uint8_t *src, uint32_t length)
+{
+    SparseBackend_t *sb = (SparseBackend_t *)ctx;
+
+    /* Eep_Write guarantees page-aligned address and length */
+    for (uint32_t off = 0; off < length; off += sb->page_size) {
+        uint32_t page = (address + off) / sb->page_size;
+        uint8_t **slot = sparse_slot(sb, page, TRUE);
+        if (slot == NULL) {
+            return E_NOT_OK;
+        }
+
+        if (*slot == NULL || *slot == &g_sparse_erased) {
+            uint8_t *copy = (uint8_t *)malloc(sb->page_size);
+            if (copy == NULL) {
+                return E_NOT_OK;
+            }
+            *slot = copy;
+            sb->resident_pages++;
+        }
+
+        memcpy(*slot, &src[off], sb->page_size);
+    }
+
+    return E_OK;
+}
+
+static Std_ReturnType sparse_erase(void *ctx, uint32_t address, uint32_t length)
+{
+    SparseBackend_t *sb = (SparseBackend_t *)ctx;
+    uint32_t first = address / sb->page_size;
+    uint32_t last = (address + length - 1U) / sb->page_size;
+
+    for (uint32_t page = first; page <= last; page++) {
+        uint8_t **slot = sparse_slot(sb, page, (sb->base != NULL) ? TRUE : FALSE);
+        if (slot == NULL) {
+            if (sb->base != NULL) {
+                return E_NOT_OK;
+            }
+            /* No leaf and no base image: already reads as 0xFF */
+            continue;
+        }
+
+        if (*slot != NULL && *slot != &g_sparse_erased) {
+            free(*slot);
+            sb->resident_pages--;
+        }
+
+        *slot = (sb->base != NULL) ? &g_sparse_erased : NULL;
+    }
+
+    return E_OK;
+}
+
+static boolean sparse_is_blank(void *ctx, uint32_t address, uint32_t length)
+{
+    SparseBackend_t *sb = (SparseBackend_t *)ctx;
+
+    while (length > 0U) {
+        uint32_t page = address / sb->page_size;
+        uint32_t in_page = address % sb->page_size;
+        uint32_t chunk = sb->page_size - in_page;
+        if (chunk > length) {
+            chunk = length;
+        }
+
+        const uint8_t *view = sparse_page_view(sb, page);
+        if (view != NULL && !Eep_BufferIsBlank(&view[in_page], chunk)) {
+            return FALSE;
+        }
+
+        address += chunk;
+        length -= chunk;
+    }
+
+    return TRUE;
+}
+
+static boolean sparse_compare(void *ctx, uint32_t address, const uint8_t *expected, uint32_t length)
+{
+    SparseBackend_t *sb = (SparseBackend_t *)ctx;
+
+    while (length > 0U) {
+        uint32_t page = address / sb->page_size;
+        uint32_t in_page = address % sb->page_size;
+        uint32_t chunk = sb->page_size - in_page;
+        if (chunk > length) {
+            chunk = length;
+        }
+
+        /* Pages without a view read as erased */
+        const uint8_t *view = sparse_page_view(sb, page);
+        if ((view != NULL) ? !Eep_BufferEqual(&view[in_page], expected, chunk)
+                           : !Eep_BufferIsBlank(expected, chunk)) {
+            return FALSE;
+        }
+
+        address += chunk;
+        expected += chunk;
+        length -= chunk;
+    }
+
+    return TRUE;
+}
+
+static boolean sparse_is_programmable(void *ctx, uint32_t address, const uint8_t *src,
+                                      uint32_t length)
+{
+    SparseBackend_t *sb = (SparseBackend_t *)ctx;
+
+    while (length > 0U) {
+        uint32_t page = address / sb->page_size;
+        uint32_t in_page = address % sb->page_size;
+        uint32_t chunk = sb->page_size - in_page;
+        if (chunk > length) {
+            chunk = length;
+        }
+
+        /* Pages without a view are erased: anything can be programmed */
+        const uint8_t *view = sparse_page_view(sb, page);
+        if (view != NULL && !Eep_BufferCanProgram(&view[in_page], src, chunk)) {
+            return FALSE;
+        }
+
+        address += chunk;
+        src += chunk;
+        length -= chunk;
+    }
+
+    return TRUE;
+}
+
+static const uint8_t* sparse_view(void *ctx, uint32_t address, uint32_t *length)
+{
+    SparseBackend_t *sb = (SparseBackend_t *)ctx;
+    uint32_t in_page = address % sb->page_size;
+
+    /* Pages are not adjacent in memory: one page per view */
+    if (*length > sb->page_size - in_page) {
+        *length = sb->page_size - in_page;
+    }
+
+    const uint8_t *view = sparse_page_view(sb, address / sb->page_size);
+    return (view != NULL) ? &view[in_page] : NULL;
+}
+
+static uint32_t sparse_resident_bytes(void *ctx)
+{
+    SparseBackend_t *sb = (SparseBackend_t *)ctx;
+
+    return (uint32_t)(sizeof(SparseBackend_t) +
+                      sb->num_leaves * sizeof(uint8_t **) +
+                      sb->resident_leaves * SPARSE_LEAF_SIZE * sizeof(uint8_t *) +
+                      sb->resident_pages * sb->page_size);
+}
+
+static const Eep_BackendOps_t g_sparse_backend = {
+    .name = "sparse",
+    .init = sparse_init,
+    .destroy = sparse_destroy,
+    .read = sparse_read,
+    .write = sparse_write,
+    .erase = sparse_erase,
+    .is_blank = sparse_is_blank,
+    .compare = sparse_compare,
+    .resident_bytes = sparse_resident_bytes,
+    .is_programmable = sparse_is_programmable,
+    .view = sparse_view
+};
+
+const Eep_BackendOps_t* Eep_GetSparseBackend(void)
+{
+    return &g_sparse_backend;
+}
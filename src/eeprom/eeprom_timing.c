@@ -0,0 +1,262 @@
+/**
+ * @file eeprom_timing.c
+ * @brief EEPROM device timing model
+ *
+ * REQ-EEPROM物理参数模型: design/01-EEPROM基础知识.md §1
+ * - 读/写/擦除延时: 标称值来自配置, 按分布 (恒定/均匀/正态) 抽样, 并带慢速长尾
+ * - 虚拟时间模式: 每个操作推进调度器虚拟时钟
+ * - 实时模式: 额外按时间倍速进行主机睡眠
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "eeprom_driver.h"
+#include "eeprom_internal.h"
+#include "os_scheduler.h"
+#include "sim_context.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief Time scale at which the host never sleeps (TIME_SCALE_FASTEST)
+ */
+#define EEP_TIME_SCALE_NO_DELAY 65535U
+
+/**
+ * @brief Seed of the latency stream until Eep_SetLatencySeed (xorshift never leaves 0)
+ */
+#define EEP_TIMING_DEFAULT_SEED 0x2545F491U
+
+/**
+ * @brief Timing state of one EEPROM context (mode and models survive Eep_Init)
+ */
+struct Eep_TimingState {
+    Eep_TimingMode_t mode;
+    boolean suspended;
+    Eep_LatencyModel_t models[EEP_OP_COUNT];
+    uint32_t rng;                   /**< xorshift32 state */
+    uint32_t pending_us;            /**< Device time not yet charged to the millisecond clock */
+    Eep_TimingStats_t stats;
+};
+
+/**
+ * @brief State used while no context is bound
+ */
+static struct Eep_TimingState g_default_state = { .rng = EEP_TIMING_DEFAULT_SEED };
+
+static struct Eep_TimingState* timing_state(void)
+{
+    Eep_Context_t *ctx = (Eep_Context_t *)SimContext_Get(SIM_CONTEXT_EEP);
+
+    return (ctx != NULL) ? ctx->timing : &g_default_state;
+}
+
+static uint32_t next_random(void)
+{
+    struct Eep_TimingState *timing = timing_state();
+    uint32_t x = timing->rng;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    timing->rng = x;
+    return x;
+}
+
+/**
+ * @brief Signed offset in millionths of nominal for one draw
+ */
+static int64_t draw_offset_ppm(const Eep_LatencyModel_t *model)
+{
+    int64_t spread_ppm = (int64_t)model->spread_pct * 10000;
+
+    switch (model->dist) {
+        case EEP_LATENCY_UNIFORM: {
+            /* [-1, 1) in 2^-31 units */
+            int64_t u = (int64_t)next_random() - 0x80000000LL;
+            return (u * spread_ppm) / 0x80000000LL;
+        }
+
+        case EEP_LATENCY_NORMAL: {
+            /* Irwin-Hall: sum of 12 uniforms minus 6 is close to N(0, 1) */
+            int64_t sum = 0;
+            for (uint32_t i = 0; i < 12U; i++) {
+                sum += (int64_t)(next_random() >> 8);   /* [0, 2^24) */
+            }
+            int64_t z = sum - 6LL * (1LL << 24);        /* N(0, 1) in 2^-24 units */
+            return (z * spread_ppm) / (1LL << 24);
+        }
+
+        default:
+            return 0;
+    }
+}
+
+uint32_t Eep_Timing_Sample(Eep_OpType_t op, uint32_t nominal_us)
+{
+    struct Eep_TimingState *timing = timing_state();
+    const Eep_LatencyModel_t *model = &timing->models[op];
+    int64_t latency = (int64_t)nominal_us + ((int64_t)nominal_us * draw_offset_ppm(model)) / 1000000;
+    uint32_t sample;
+
+    if (latency < 0) {
+        latency = 0;
+    }
+
+    if (model->tail_ppm > 0U && model->tail_factor > 1U &&
+        (next_random() % 1000000U) < model->tail_ppm) {
+        latency *= model->tail_factor;
+        timing->stats.tail_count++;
+    }
+
+    sample = (latency > 0xFFFFFFFFLL) ? 0xFFFFFFFFU : (uint32_t)latency;
+
+    Eep_TimingStats_t *stats = &timing->stats;
+    if (stats->op_count[op] == 0U || sample < stats->min_us[op]) {
+        stats->min_us[op] = sample;
+    }
+    if (sample > stats->max_us[op]) {
+        stats->max_us[op] = sample;
+    }
+    stats->op_count[op]++;
+    stats->busy_us[op] += sample;
+    stats->total_busy_us += sample;
+
+    return sample;
+}
+
+/**
+ * @brief Sleep the host for a scaled device latency
+ */
+static void host_sleep_us(uint32_t latency_us, uint32_t time_scale)
+{
+    if (time_scale == 0U || time_scale >= EEP_TIME_SCALE_NO_DELAY) {
+        return;
+    }
+
+    uint32_t scaled_us = latency_us / time_scale;
+    if (scaled_us == 0U) {
+        return;
+    }
+
+    struct timespec ts = {
+        .tv_sec = (time_t)(scaled_us / 1000000U),
+        .tv_nsec = (long)(scaled_us % 1000000U) * 1000L
+    };
+    (void)nanosleep(&ts, NULL);
+}
+
+uint32_t Eep_Timing_Charge(Eep_OpType_t op, uint32_t nominal_us, uint32_t time_scale)
+{
+    struct Eep_TimingState *timing = timing_state();
+
+    if (timing->mode == EEP_TIMING_OFF || timing->suspended) {
+        return nominal_us;
+    }
+
+    uint32_t latency_us = Eep_Timing_Sample(op, nominal_us);
+
+    /* The scheduler clock counts milliseconds: carry the remainder */
+    uint64_t pending = (uint64_t)timing->pending_us + latency_us;
+    uint32_t whole_ms = (uint32_t)(pending / 1000U);
+    timing->pending_us = (uint32_t)(pending % 1000U);
+    if (whole_ms > 0U) {
+        OsScheduler_Sleep(whole_ms);
+    }
+
+    if (timing->mode == EEP_TIMING_REALTIME) {
+        host_sleep_us(latency_us, time_scale);
+    }
+    return latency_us;
+}
+
+void Eep_Timing_ResetStats(void)
+{
+    struct Eep_TimingState *timing = timing_state();
+
+    memset(&timing->stats, 0, sizeof(timing->stats));
+    timing->pending_us = 0;
+}
+
+Std_ReturnType Eep_SetTimingMode(Eep_TimingMode_t mode)
+{
+    struct Eep_TimingState *timing = timing_state();
+
+    if (mode != EEP_TIMING_OFF && mode != EEP_TIMING_VIRTUAL && mode != EEP_TIMING_REALTIME) {
+        return E_NOT_OK;
+    }
+
+    timing->mode = mode;
+    timing->pending_us = 0;
+    return E_OK;
+}
+
+Eep_TimingMode_t Eep_GetTimingMode(void)
+{
+    struct Eep_TimingState *timing = timing_state();
+
+    return timing->mode;
+}
+
+Std_ReturnType Eep_SetLatencyModel(Eep_OpType_t op, const Eep_LatencyModel_t *model)
+{
+    struct Eep_TimingState *timing = timing_state();
+
+    if (model == NULL || (uint32_t)op >= EEP_OP_COUNT ||
+        (model->dist != EEP_LATENCY_CONSTANT && model->dist != EEP_LATENCY_UNIFORM &&
+         model->dist != EEP_LATENCY_NORMAL) ||
+        model->spread_pct > 100U || model->tail_ppm > 1000000U) {
+        return E_NOT_OK;
+    }
+
+    timing->models[op] = *model;
+    return E_OK;
+}
+
+void Eep_SetLatencySeed(uint32_t seed)
+{
+    struct Eep_TimingState *timing = timing_state();
+
+    /* xorshift never leaves 0 */
+    timing->rng = (seed != 0U) ? seed : EEP_TIMING_DEFAULT_SEED;
+}
+
+void Eep_SuspendClock(boolean suspend)
+{
+    struct Eep_TimingState *timing = timing_state();
+
+    timing->suspended = suspend;
+}
+
+Std_ReturnType Eep_GetTimingStats(Eep_TimingStats_t *stats)
+{
+    struct Eep_TimingState *timing = timing_state();
+
+    if (stats == NULL) {
+        return E_NOT_OK;
+    }
+
+    *stats = timing->stats;
+    return E_OK;
+}
+
+void Eep_ResetTimingStats(void)
+{
+    Eep_Timing_ResetStats();
+}
+
+struct Eep_TimingState* Eep_Timing_CreateState(void)
+{
+    struct Eep_TimingState *state = (struct Eep_TimingState *)calloc(1, sizeof(struct Eep_TimingState));
+
+    if (state != NULL) {
+        state->rng = EEP_TIMING_DEFAULT_SEED;
+    }
+    return state;
+}
+
+void Eep_Timing_DestroyState(struct Eep_TimingState *state)
+{
+    free(state);
+}
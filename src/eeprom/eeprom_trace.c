@@ -0,0 +1,178 @@
+/**
+ * @file eeprom_trace.c
+ * @brief Binary I/O trace capture at the Eep operation boundary
+ *
+ * - 定长24字节记录, 追加到内存缓冲; 缓冲满时一次fwrite整块写出
+ * - 未开启时驱动只做一次relaxed加载 (EEP_TRACE_ACTIVE)
+ * - 负载哈希 (可选): CRC-32, 写入数据或成功读取的数据
+ */
+
+#include "eeprom_trace.h"
+#include "crc.h"
+#include "logging.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The file format depends on these sizes */
+typedef char eep_trace_record_size_check[(sizeof(EepTrace_Record_t) == 24U) ? 1 : -1];
+typedef char eep_trace_header_size_check[(sizeof(EepTrace_FileHeader_t) == 24U) ? 1 : -1];
+
+uint32_t EepTrace_ActiveFlag = 0U;
+
+static struct {
+    FILE *file;
+    EepTrace_Record_t *buffer;
+    uint32_t capacity;              /**< Records per block write */
+    uint32_t count;                 /**< Records buffered */
+    uint32_t flags;
+    EepTrace_Stats_t stats;
+} g_trace;
+
+static Std_ReturnType trace_write_buffer(void)
+{
+    if (g_trace.count == 0U) {
+        return E_OK;
+    }
+
+    size_t bytes = (size_t)g_trace.count * sizeof(EepTrace_Record_t);
+    size_t written = fwrite(g_trace.buffer, 1, bytes, g_trace.file);
+
+    g_trace.count = 0;
+    g_trace.stats.block_writes++;
+    g_trace.stats.bytes_written += written;
+    if (written != bytes) {
+        g_trace.stats.write_errors++;
+        LOG_ERROR("EepTrace: Block write failed (%zu of %zu bytes)", written, bytes);
+        return E_NOT_OK;
+    }
+    return E_OK;
+}
+
+Std_ReturnType EepTrace_Start(const char *path, uint32_t flags, uint32_t buffer_records)
+{
+    const Eeprom_ConfigType *cfg = Eep_GetConfig();
+
+    if (path == NULL || g_trace.file != NULL || cfg == NULL) {
+        return E_NOT_OK;
+    }
+
+    if (buffer_records == 0U) {
+        buffer_records = EEP_TRACE_DEFAULT_BUFFER;
+    }
+
+    g_trace.buffer = malloc((size_t)buffer_records * sizeof(EepTrace_Record_t));
+    if (g_trace.buffer == NULL) {
+        return E_NOT_OK;
+    }
+
+    g_trace.file = fopen(path, "wb");
+    if (g_trace.file == NULL) {
+        LOG_ERROR("EepTrace: Cannot create %s", path);
+        free(g_trace.buffer);
+        g_trace.buffer = NULL;
+        return E_NOT_OK;
+    }
+
+    EepTrace_FileHeader_t header = {
+        .magic = EEP_TRACE_MAGIC,
+        .version = EEP_TRACE_VERSION,
+        .record_size = (uint16_t)sizeof(EepTrace_Record_t),
+        .capacity_bytes = cfg->capacity_bytes,
+        .page_size = cfg->page_size,
+        .block_size = cfg->block_size,
+        .flags = flags
+    };
+
+    memset(&g_trace.stats, 0, sizeof(g_trace.stats));
+    if (fwrite(&header, sizeof(header), 1, g_trace.file) != 1U) {
+        LOG_ERROR("EepTrace: Cannot write header to %s", path);
+        fclose(g_trace.file);
+        g_trace.file = NULL;
+        free(g_trace.buffer);
+        g_trace.buffer = NULL;
+        return E_NOT_OK;
+    }
+    g_trace.stats.bytes_written = sizeof(header);
+
+    g_trace.capacity = buffer_records;
+    g_trace.count = 0;
+    g_trace.flags = flags;
+    __atomic_store_n(&EepTrace_ActiveFlag, 1U, __ATOMIC_RELEASE);
+
+    LOG_INFO("EepTrace: Capturing to %s (%u records per block)", path, buffer_records);
+    return E_OK;
+}
+
+Std_ReturnType EepTrace_Flush(void)
+{
+    if (g_trace.file == NULL) {
+        return E_NOT_OK;
+    }
+
+    Std_ReturnType ret = trace_write_buffer();
+    if (fflush(g_trace.file) != 0) {
+        ret = E_NOT_OK;
+    }
+    return ret;
+}
+
+Std_ReturnType EepTrace_Stop(void)
+{
+    if (g_trace.file == NULL) {
+        return E_NOT_OK;
+    }
+
+    __atomic_store_n(&EepTrace_ActiveFlag, 0U, __ATOMIC_RELEASE);
+
+    Std_ReturnType ret = trace_write_buffer();
+    if (fclose(g_trace.file) != 0) {
+        ret = E_NOT_OK;
+    }
+    g_trace.file = NULL;
+    free(g_trace.buffer);
+    g_trace.buffer = NULL;
+
+    LOG_INFO("EepTrace: Captured %llu records",
+             (unsigned long long)g_trace.stats.records);
+    return ret;
+}
+
+Std_ReturnType EepTrace_GetStats(EepTrace_Stats_t *stats)
+{
+    if (stats == NULL) {
+        return E_NOT_OK;
+    }
+
+    *stats = g_trace.stats;
+    return E_OK;
+}
+
+void EepTrace_Record(Eep_OpType_t op, Std_ReturnType result, uint32_t address, uint32_t length,
+                     const uint8_t *data, uint32_t virtual_ms, uint32_t device_us)
+{
+    if (g_trace.file == NULL) {
+        return;
+    }
+
+    EepTrace_Record_t *rec = &g_trace.buffer[g_trace.count];
+
+    rec->op = (uint8_t)op;
+    rec->result = (uint8_t)result;
+    rec->flags = 0;
+    rec->address = address;
+    rec->length = length;
+    rec->payload_hash = 0;
+    rec->virtual_ms = virtual_ms;
+    rec->device_us = device_us;
+
+    if ((g_trace.flags & EEP_TRACE_HASH_PAYLOAD) != 0U && data != NULL) {
+        rec->payload_hash = CRC_CalculateCRC32(data, length);
+        rec->flags = EEP_TRACE_HASH_PAYLOAD;
+    }
+
+    g_trace.stats.records++;
+    if (++g_trace.count == g_trace.capacity) {
+        (void)trace_write_buffer();
+    }
+}
@@ -4,13 +4,19 @@
  *
  * REQ-故障注入: design/04-数据完整性方案.md §5
  * - Fault enable/disable management
- * - Probability-based triggering
- * - Block-specific targeting
+ * - Probability-based triggering (per-fault seedable xoshiro128** stream,
+ *   geometric countdown to the next trigger: one decrement per hook call)
+ * - Block-specific targeting (sorted address ranges, binary search per hook)
+ * - Wear-dependent bit errors (rate from the erase count of the block read)
  * - Statistics tracking
  */
 
 #include "fault_injection.h"
+#include "eeprom_driver.h"
 #include "logging.h"
+#include "sim_context.h"
+#include <pthread.h>
+#include <stdlib.h>
 #include <string.h>
 
 /**
@@ -19,29 +25,186 @@
 #define FAULT_MAX_CONFIGS 16
 
 /**
- * @brief Fault configuration table
+ * @brief Outputs generated per refill of a fault's random stream
  */
-static FaultConfig_t g_fault_configs[FAULT_MAX_CONFIGS];
+#define FAULT_RNG_BLOCK 16U
 
 /**
- * @brief Fault statistics
+ * @brief Per-fault random stream and trigger countdown
  */
-static FaultStats_t g_stats = {0};
+typedef struct {
+    uint32_t s[4];                  /**< xoshiro128** state */
+    uint32_t buf[FAULT_RNG_BLOCK];  /**< Pre-generated outputs */
+    uint8_t pos;                    /**< Next unused entry in buf */
+    uint32_t countdown;             /**< Hook calls left before the next trigger */
+} FaultRandom_t;
 
 /**
- * @brief Random number generator state (simple LCG)
+ * @brief Address range owned by a block: [start, end)
  */
-static uint32_t g_rand_state = 12345;
+typedef struct {
+    uint32_t start;
+    uint32_t end;
+    uint8_t block_id;
+} FaultRange_t;
 
 /**
- * @brief Simple pseudo-random number generator
+ * @brief Fault injection state of one context
+ */
+struct FaultInj_Context {
+    FaultConfig_t configs[FAULT_MAX_CONFIGS];   /**< Fault configuration table */
+    FaultStats_t stats;
+    uint8_t config_index[FAULT_MAX_ID];         /**< Slot + 1 per fault ID (0 = not configured) */
+    FaultRandom_t random[FAULT_MAX_CONFIGS];
+    FaultRange_t ranges[FAULT_INJ_MAX_RANGES];  /**< Sorted by start address (non-overlapping) */
+    uint32_t range_count;
+    uint64_t seed;                              /**< Campaign seed (streams derive from it per fault ID) */
+    FaultWearModel_t wear_model;                /**< Bit error model of FAULT_WEAR_BITFLIP */
+    uint32_t armed;                             /**< This context's part of FaultInj_ArmedMask */
+};
+
+/**
+ * @brief Context used while none is bound
+ */
+static FaultInj_Context_t g_default_context = { .seed = FAULT_INJ_DEFAULT_SEED };
+
+/**
+ * @brief Armed faults of every context (see FAULT_INJ_ARMED)
+ */
+uint32_t FaultInj_ArmedMask = 0;
+
+/**
+ * @brief Contexts arming each fault ID (FaultInj_ArmedMask has a bit per non-zero count)
+ */
+static uint32_t g_armed_contexts[32];
+static pthread_mutex_t g_armed_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static FaultInj_Context_t* faultinj_context(void)
+{
+    FaultInj_Context_t *bound = (FaultInj_Context_t *)SimContext_Get(SIM_CONTEXT_FAULTINJ);
+
+    return (bound != NULL) ? bound : &g_default_context;
+}
+
+static uint32_t rotl32(uint32_t x, uint32_t k)
+{
+    return (x << k) | (x >> (32U - k));
+}
+
+static uint64_t splitmix64(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Refill a stream's buffer in one pass
+ */
+static void random_refill(FaultRandom_t *rng)
+{
+    uint32_t s0 = rng->s[0], s1 = rng->s[1], s2 = rng->s[2], s3 = rng->s[3];
+
+    for (uint32_t i = 0; i < FAULT_RNG_BLOCK; i++) {
+        rng->buf[i] = rotl32(s1 * 5U, 7U) * 9U;
+        uint32_t t = s1 << 9;
+        s2 ^= s0;
+        s3 ^= s1;
+        s1 ^= s2;
+        s0 ^= s3;
+        s2 ^= t;
+        s3 = rotl32(s3, 11U);
+    }
+    rng->s[0] = s0;
+    rng->s[1] = s1;
+    rng->s[2] = s2;
+    rng->s[3] = s3;
+    rng->pos = 0;
+}
+
+static uint32_t random_next(FaultRandom_t *rng)
+{
+    if (rng->pos >= FAULT_RNG_BLOCK) {
+        random_refill(rng);
+    }
+    return rng->buf[rng->pos++];
+}
+
+/**
+ * @brief Seed a fault's stream from the campaign seed and the fault ID
+ *
+ * The stream of one fault does not depend on how often other faults'
+ * hooks run.
+ */
+static void random_seed(FaultRandom_t *rng, FaultId_t fault_id)
+{
+    FaultInj_Context_t *fi = faultinj_context();
+    uint64_t state = fi->seed ^ ((uint64_t)fault_id << 56);
+    uint64_t a = splitmix64(&state);
+    uint64_t b = splitmix64(&state);
+
+    rng->s[0] = (uint32_t)a;
+    rng->s[1] = (uint32_t)(a >> 32);
+    rng->s[2] = (uint32_t)b;
+    rng->s[3] = (uint32_t)(b >> 32);
+    if ((rng->s[0] | rng->s[1] | rng->s[2] | rng->s[3]) == 0U) {
+        rng->s[0] = 1U;     /* All-zero state never leaves zero */
+    }
+    rng->pos = FAULT_RNG_BLOCK;
+    rng->countdown = 0;
+}
+
+/**
+ * @brief log2(x) in Q16.16 for x >= 1
+ */
+static int32_t log2_q16(uint32_t x)
+{
+    int32_t result = 31 - __builtin_clz(x);
+    /* Mantissa in [1, 2) as Q31 */
+    uint64_t m = (result >= 31) ? x : ((uint64_t)x << (31 - result));
+
+    result <<= 16;
+    for (int32_t bit = 1 << 15; bit != 0; bit >>= 1) {
+        m = (m * m) >> 31;
+        if (m >= (2ULL << 31)) {
+            m >>= 1;
+            result |= bit;
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Number of hook calls before the next trigger
  *
- * @return Random number 0-999
+ * Geometric with success probability percent/100: floor(log(u) / log(1-p))
+ * with u uniform in (0, 1].
  */
-static uint16_t random_percent(void)
+static uint32_t random_countdown(FaultRandom_t *rng, uint8_t percent)
 {
-    g_rand_state = g_rand_state * 1103515245 + 12345;
-    return (uint16_t)((g_rand_state / 65536) % 1000);
+    /* u = (r + 1) / 2^31, so log2(u) = log2(r + 1) - 31 */
+    int64_t log_u = (int64_t)log2_q16((uint32_t)((random_next(rng) >> 1) + 1U)) - (31 << 16);
+    /* log2(1 - p) = log2(100 - percent) - log2(100) */
+    int64_t log_q = (int64_t)log2_q16(100U - percent) - log2_q16(100U);
+    int64_t calls = log_u / log_q;
+
+    return (calls > (int64_t)UINT32_MAX) ? UINT32_MAX : (uint32_t)calls;
+}
+
+/**
+ * @brief Draw a fresh countdown for a configured fault
+ */
+static void arm_countdown(FaultConfig_t *config)
+{
+    FaultInj_Context_t *fi = faultinj_context();
+    FaultRandom_t *rng = &fi->random[config - fi->configs];
+
+    if (config->probability_percent == 0U || config->probability_percent >= 100U) {
+        rng->countdown = 0;
+    } else {
+        rng->countdown = random_countdown(rng, config->probability_percent);
+    }
 }
 
 /**
@@ -49,12 +212,13 @@ static uint16_t random_percent(void)
  */
 static FaultConfig_t* find_config(FaultId_t fault_id)
 {
-    for (int i = 0; i < FAULT_MAX_CONFIGS; i++) {
-        if (g_fault_configs[i].fault_id == fault_id && g_fault_configs[i].fault_id != FAULT_NONE) {
-            return &g_fault_configs[i];
-        }
+    FaultInj_Context_t *fi = faultinj_context();
+
+    if (fault_id >= FAULT_MAX_ID) {
+        return NULL;
     }
-    return NULL;
+    uint8_t slot = fi->config_index[fault_id];
+    return (slot != 0U) ? &fi->configs[slot - 1U] : NULL;
 }
 
 /**
@@ -62,6 +226,8 @@ static FaultConfig_t* find_config(FaultId_t fault_id)
  */
 static FaultConfig_t* find_or_create_config(FaultId_t fault_id)
 {
+    FaultInj_Context_t *fi = faultinj_context();
+
     /* Try to find existing */
     FaultConfig_t *config = find_config(fault_id);
     if (config != NULL) {
@@ -70,45 +236,123 @@ static FaultConfig_t* find_or_create_config(FaultId_t fault_id)
 
     /* Create new config */
     for (int i = 0; i < FAULT_MAX_CONFIGS; i++) {
-        if (g_fault_configs[i].fault_id == FAULT_NONE) {
-            g_fault_configs[i].fault_id = fault_id;
-            g_fault_configs[i].enabled = FALSE;
-            g_fault_configs[i].target_block_id = 0xFF;
-            g_fault_configs[i].trigger_count = 0;
-            g_fault_configs[i].triggered_count = 0;
-            g_fault_configs[i].probability_percent = 0;
-            return &g_fault_configs[i];
+        if (fi->configs[i].fault_id == FAULT_NONE) {
+            fi->configs[i].fault_id = fault_id;
+            fi->configs[i].enabled = FALSE;
+            fi->configs[i].target_block_id = FAULT_INJ_ALL_BLOCKS;
+            fi->configs[i].trigger_count = 0;
+            fi->configs[i].triggered_count = 0;
+            fi->configs[i].probability_percent = 0;
+            fi->config_index[fault_id] = (uint8_t)(i + 1);
+            random_seed(&fi->random[i], fault_id);
+            return &fi->configs[i];
         }
     }
 
     return NULL;
 }
 
+/**
+ * @brief Recompute a context's armed faults and fold them into FaultInj_ArmedMask
+ *
+ * The shared mask has a bit set while any context arms that fault; hooks
+ * called for a context that does not arm it find nothing to inject.
+ */
+static void update_armed(FaultInj_Context_t *fi)
+{
+    uint32_t mask = 0;
+
+    for (int i = 0; i < FAULT_MAX_CONFIGS; i++) {
+        const FaultConfig_t *config = &fi->configs[i];
+        if (config->fault_id != FAULT_NONE && config->enabled &&
+            (config->trigger_count == 0U || config->triggered_count < config->trigger_count)) {
+            mask |= FAULT_INJ_BIT(config->fault_id);
+        }
+    }
+    if (mask == fi->armed) {
+        return;
+    }
+
+    pthread_mutex_lock(&g_armed_lock);
+    uint32_t shared = 0;
+    for (uint32_t bit = 0; bit < 32U; bit++) {
+        uint32_t was = (fi->armed >> bit) & 1U;
+        uint32_t now = (mask >> bit) & 1U;
+        g_armed_contexts[bit] = g_armed_contexts[bit] + now - was;
+        if (g_armed_contexts[bit] != 0U) {
+            shared |= 1UL << bit;
+        }
+    }
+    fi->armed = mask;
+    __atomic_store_n(&FaultInj_ArmedMask, shared, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&g_armed_lock);
+}
+
 /**
  * @brief Check if fault should trigger based on probability and count
  */
 static boolean should_trigger(FaultConfig_t *config)
 {
+    FaultInj_Context_t *fi = faultinj_context();
+
     if (!config->enabled) {
         return FALSE;
     }
 
     /* Check trigger count limit */
     if (config->trigger_count > 0 && config->triggered_count >= config->trigger_count) {
+        update_armed(fi);     /* Used up: stop call sites from calling in */
         return FALSE;
     }
 
-    /* Check probability (0 = always trigger, 100 = never trigger) */
-    if (config->probability_percent == 0) {
-        return TRUE;
+    /* Check probability (0 = always trigger, otherwise percent per call) */
+    FaultRandom_t *rng = &fi->random[config - fi->configs];
+    if (rng->countdown > 0U) {
+        rng->countdown--;
+        return FALSE;
     }
 
-    uint16_t roll = random_percent();
-    if (roll < config->probability_percent * 10) {
-        return TRUE;
+    arm_countdown(config);
+    return TRUE;
+}
+
+/**
+ * @brief Check a fault's target block covers an address
+ *
+ * Checked before should_trigger, so accesses to other blocks neither
+ * fire the fault nor consume its countdown.
+ */
+static boolean targets_address(const FaultConfig_t *config, uint32_t address)
+{
+    return config->target_block_id == FAULT_INJ_ALL_BLOCKS ||
+           FaultInj_LookupBlock(address) == config->target_block_id;
+}
+
+FaultInj_Context_t* FaultInj_CreateContext(void)
+{
+    FaultInj_Context_t *ctx = (FaultInj_Context_t *)calloc(1, sizeof(FaultInj_Context_t));
+
+    if (ctx != NULL) {
+        ctx->seed = FAULT_INJ_DEFAULT_SEED;
     }
+    return ctx;
+}
 
-    return FALSE;
+void FaultInj_DestroyContext(FaultInj_Context_t *ctx)
+{
+    if (ctx == NULL || ctx == &g_default_context) {
+        return;
+    }
+
+    /* Give back its share of the armed mask */
+    memset(ctx->configs, 0, sizeof(ctx->configs));
+    update_armed(ctx);
+    free(ctx);
+}
+
+FaultInj_Context_t* FaultInj_BindContext(FaultInj_Context_t *ctx)
+{
+    return (FaultInj_Context_t *)SimContext_Bind(SIM_CONTEXT_FAULTINJ, ctx);
 }
 
 /**
@@ -116,10 +360,44 @@ static boolean should_trigger(FaultConfig_t *config)
  */
 void FaultInj_Init(void)
 {
-    memset(g_fault_configs, 0, sizeof(g_fault_configs));
-    memset(&g_stats, 0, sizeof(g_stats));
+    FaultInj_Context_t *fi = faultinj_context();
+
+    memset(fi->configs, 0, sizeof(fi->configs));
+    memset(fi->config_index, 0, sizeof(fi->config_index));
+    memset(&fi->stats, 0, sizeof(fi->stats));
+    memset(&fi->wear_model, 0, sizeof(fi->wear_model));
+    update_armed(fi);
+
+    LOG_INFO("FaultInj: Initialized (max_configs=%d, seed=0x%llX)", FAULT_MAX_CONFIGS,
+             (unsigned long long)fi->seed);
+}
+
+/**
+ * @brief Set the campaign seed
+ */
+void FaultInj_SetSeed(uint64_t seed)
+{
+    FaultInj_Context_t *fi = faultinj_context();
+
+    fi->seed = seed;
+
+    /* Restart the streams of faults already configured */
+    for (int i = 0; i < FAULT_MAX_CONFIGS; i++) {
+        if (fi->configs[i].fault_id != FAULT_NONE) {
+            random_seed(&fi->random[i], fi->configs[i].fault_id);
+            arm_countdown(&fi->configs[i]);
+        }
+    }
+}
+
+/**
+ * @brief Get the campaign seed
+ */
+uint64_t FaultInj_GetSeed(void)
+{
+    FaultInj_Context_t *fi = faultinj_context();
 
-    LOG_INFO("FaultInj: Initialized (max_configs=%d)", FAULT_MAX_CONFIGS);
+    return fi->seed;
 }
 
 /**
@@ -138,6 +416,7 @@ Std_ReturnType FaultInj_Enable(FaultId_t fault_id)
     }
 
     config->enabled = TRUE;
+    update_armed(faultinj_context());
     LOG_INFO("FaultInj: Enabled fault %d", fault_id);
 
     return E_OK;
@@ -154,6 +433,7 @@ Std_ReturnType FaultInj_Disable(FaultId_t fault_id)
     }
 
     config->enabled = FALSE;
+    update_armed(faultinj_context());
     LOG_INFO("FaultInj: Disabled fault %d", fault_id);
 
     return E_OK;
@@ -188,6 +468,8 @@ Std_ReturnType FaultInj_Configure(const FaultConfig_t *config)
 
     *target = *config;
     target->triggered_count = 0;  /* Reset counter on reconfigure */
+    arm_countdown(target);
+    update_armed(faultinj_context());
 
     LOG_INFO("FaultInj: Configured fault %d (block=%d, prob=%u%%, count=%u)",
              config->fault_id, config->target_block_id,
@@ -201,11 +483,13 @@ Std_ReturnType FaultInj_Configure(const FaultConfig_t *config)
  */
 Std_ReturnType FaultInj_GetStats(FaultStats_t *stats)
 {
+    FaultInj_Context_t *fi = faultinj_context();
+
     if (stats == NULL) {
         return E_NOT_OK;
     }
 
-    *stats = g_stats;
+    *stats = fi->stats;
     return E_OK;
 }
 
@@ -214,19 +498,126 @@ Std_ReturnType FaultInj_GetStats(FaultStats_t *stats)
  */
 void FaultInj_ResetStats(void)
 {
-    memset(&g_stats, 0, sizeof(g_stats));
+    FaultInj_Context_t *fi = faultinj_context();
+
+    memset(&fi->stats, 0, sizeof(fi->stats));
     LOG_INFO("FaultInj: Statistics reset");
 }
 
 /**
  * @brief Reset all fault configurations
  */
+Std_ReturnType FaultInj_SetWearModel(const FaultWearModel_t *model)
+{
+    FaultInj_Context_t *fi = faultinj_context();
+
+    if (model == NULL) {
+        memset(&fi->wear_model, 0, sizeof(fi->wear_model));
+        return E_OK;
+    }
+
+    if (model->exponent > 8U) {
+        return E_NOT_OK;
+    }
+
+    fi->wear_model = *model;
+    LOG_INFO("FaultInj: Wear model %u ppb at endurance, exponent %u",
+             model->ber_ppb_at_endurance, model->exponent);
+    return E_OK;
+}
+
 void FaultInj_ResetAll(void)
 {
-    memset(g_fault_configs, 0, sizeof(g_fault_configs));
+    FaultInj_Context_t *fi = faultinj_context();
+
+    memset(fi->configs, 0, sizeof(fi->configs));
+    memset(fi->config_index, 0, sizeof(fi->config_index));
+    update_armed(fi);
     LOG_INFO("FaultInj: All configurations reset");
 }
 
+/**
+ * @brief Map an EEPROM address range to a block
+ */
+Std_ReturnType FaultInj_MapRange(uint8_t block_id, uint32_t address, uint32_t length)
+{
+    FaultInj_Context_t *fi = faultinj_context();
+
+    if (length == 0U || address > UINT32_MAX - length || fi->range_count >= FAULT_INJ_MAX_RANGES) {
+        return E_NOT_OK;
+    }
+
+    uint32_t end = address + length;
+    uint32_t pos = fi->range_count;
+    while (pos > 0U && fi->ranges[pos - 1U].start >= end) {
+        pos--;
+    }
+    if (pos > 0U && fi->ranges[pos - 1U].end > address) {
+        LOG_WARN("FaultInj: Range 0x%X+%u of block %d overlaps block %d",
+                 address, length, block_id, fi->ranges[pos - 1U].block_id);
+        return E_NOT_OK;
+    }
+
+    memmove(&fi->ranges[pos + 1U], &fi->ranges[pos], (fi->range_count - pos) * sizeof(FaultRange_t));
+    fi->ranges[pos].start = address;
+    fi->ranges[pos].end = end;
+    fi->ranges[pos].block_id = block_id;
+    fi->range_count++;
+
+    return E_OK;
+}
+
+/**
+ * @brief Remove every range mapped to a block
+ */
+void FaultInj_UnmapBlock(uint8_t block_id)
+{
+    FaultInj_Context_t *fi = faultinj_context();
+    uint32_t kept = 0;
+
+    for (uint32_t i = 0; i < fi->range_count; i++) {
+        if (fi->ranges[i].block_id != block_id) {
+            fi->ranges[kept++] = fi->ranges[i];
+        }
+    }
+    fi->range_count = kept;
+}
+
+/**
+ * @brief Remove all mapped ranges
+ */
+void FaultInj_ClearRanges(void)
+{
+    FaultInj_Context_t *fi = faultinj_context();
+
+    fi->range_count = 0;
+}
+
+/**
+ * @brief Find the block owning an address
+ */
+uint8_t FaultInj_LookupBlock(uint32_t address)
+{
+    FaultInj_Context_t *fi = faultinj_context();
+
+    /* Last range starting at or below the address */
+    uint32_t lo = 0;
+    uint32_t hi = fi->range_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2U;
+        if (fi->ranges[mid].start <= address) {
+            lo = mid + 1U;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (lo > 0U && address < fi->ranges[lo - 1U].end) {
+        return fi->ranges[lo - 1U].block_id;
+    }
+    return FAULT_INJ_ALL_BLOCKS;
+}
+
 /**
  * @brief Hook: Called before EEPROM read
  */
@@ -239,22 +630,92 @@ boolean FaultInj_HookBeforeRead(uint32_t address, uint32_t length)
     return FALSE;
 }
 
+/**
+ * @brief Expected bit errors of a read within one erase block, Q32.32
+ */
+static uint64_t wear_expected_flips(uint32_t address, uint32_t length, uint32_t endurance)
+{
+    FaultInj_Context_t *fi = faultinj_context();
+    uint32_t wear = 0;
+
+    (void)Eep_GetEraseCount(address, &wear);
+    if (wear > endurance) {
+        wear = endurance;
+    }
+
+    /* (wear / endurance)^exponent in Q16.16 */
+    uint64_t ratio = ((uint64_t)wear << 16) / endurance;
+    uint64_t scale = 1ULL << 16;
+    for (uint8_t i = 0; i < fi->wear_model.exponent; i++) {
+        scale = (scale * ratio) >> 16;
+    }
+
+    uint64_t per_bit = ((uint64_t)fi->wear_model.ber_ppb_at_endurance << 32) / 1000000000ULL;
+    return ((per_bit * scale) >> 16) * ((uint64_t)length * 8U);
+}
+
+/**
+ * @brief Flip bits of a read according to the wear of each erase block it covers
+ *
+ * @return Bits flipped
+ */
+static uint32_t wear_bitflips(FaultConfig_t *config, uint32_t address, uint8_t *data,
+                              uint32_t length)
+{
+    FaultInj_Context_t *fi = faultinj_context();
+    const Eeprom_ConfigType *eep = Eep_GetConfig();
+    FaultRandom_t *rng = &fi->random[config - fi->configs];
+    uint32_t flipped = 0;
+
+    if (eep == NULL || eep->endurance_cycles == 0U || eep->block_size == 0U) {
+        return 0;
+    }
+
+    for (uint32_t done = 0; done < length;) {
+        uint32_t chunk = eep->block_size - ((address + done) % eep->block_size);
+        if (chunk > length - done) {
+            chunk = length - done;
+        }
+
+        uint64_t expected = wear_expected_flips(address + done, chunk, eep->endurance_cycles);
+        uint64_t flips = expected >> 32;
+        if (random_next(rng) < (uint32_t)expected) {
+            flips++;
+        }
+        if (flips > (uint64_t)chunk * 8U) {
+            flips = (uint64_t)chunk * 8U;
+        }
+
+        for (uint64_t i = 0; i < flips; i++) {
+            uint32_t bit = random_next(rng) % (chunk * 8U);
+            data[done + bit / 8U] ^= (uint8_t)(1U << (bit % 8U));
+        }
+
+        flipped += (uint32_t)flips;
+        done += chunk;
+    }
+
+    return flipped;
+}
+
 /**
  * @brief Hook: Called after EEPROM read (bit flip injection)
  */
-boolean FaultInj_HookAfterRead(uint8_t *data, uint32_t length)
+boolean FaultInj_HookAfterRead(uint32_t address, uint8_t *data, uint32_t length)
 {
+    FaultInj_Context_t *fi = faultinj_context();
+
     if (data == NULL || length == 0) {
         return FALSE;
     }
 
     /* Check for P0-03: Single bit flip */
     FaultConfig_t *config = find_config(FAULT_P0_BITFLIP_SINGLE);
-    if (config != NULL && should_trigger(config)) {
+    if (config != NULL && targets_address(config, address) && should_trigger(config)) {
         /* Flip single bit in first byte */
         data[0] ^= 0x01;
         config->triggered_count++;
-        g_stats.total_injected++;
+        fi->stats.total_injected++;
 
         LOG_WARN("FaultInj: Injected single bit flip at offset 0 (0x%02X -> 0x%02X)",
                  data[0] ^ 0x01, data[0]);
@@ -263,19 +724,36 @@ boolean FaultInj_HookAfterRead(uint8_t *data, uint32_t length)
 
     /* Check for P0-04: Multiple bit flip */
     config = find_config(FAULT_P0_BITFLIP_MULTI);
-    if (config != NULL && should_trigger(config)) {
+    if (config != NULL && targets_address(config, address) && should_trigger(config)) {
         /* Flip multiple bits in first few bytes */
         uint32_t flip_count = (length > 4) ? 4 : length;
         for (uint32_t i = 0; i < flip_count; i++) {
             data[i] ^= 0xFF;
         }
         config->triggered_count++;
-        g_stats.total_injected++;
+        fi->stats.total_injected++;
 
         LOG_WARN("FaultInj: Injected multi-bit flip in first %u bytes", flip_count);
         return TRUE;
     }
 
+    /* Wear-dependent bit errors (the model, not probability_percent, decides) */
+    config = find_config(FAULT_WEAR_BITFLIP);
+    if (config != NULL && config->enabled && fi->wear_model.ber_ppb_at_endurance != 0U &&
+        (config->trigger_count == 0U || config->triggered_count < config->trigger_count) &&
+        targets_address(config, address)) {
+        uint32_t flips = wear_bitflips(config, address, data, length);
+        if (flips > 0U) {
+            config->triggered_count++;
+            fi->stats.total_injected++;
+            update_armed(fi);
+
+            LOG_DEBUG("FaultInj: Injected %u wear bit errors at 0x%X (%u bytes)",
+                      flips, address, length);
+            return TRUE;
+        }
+    }
+
     return FALSE;
 }
 
@@ -284,14 +762,15 @@ boolean FaultInj_HookAfterRead(uint8_t *data, uint32_t length)
  */
 boolean FaultInj_HookBeforeWrite(uint32_t address, uint32_t length)
 {
-    (void)address;
+    FaultInj_Context_t *fi = faultinj_context();
+
     (void)length;
 
     /* Check for P0-06: Erase timeout */
     FaultConfig_t *config = find_config(FAULT_P0_TIMEOUT_ERASE);
-    if (config != NULL && should_trigger(config)) {
+    if (config != NULL && targets_address(config, address) && should_trigger(config)) {
         config->triggered_count++;
-        g_stats.total_injected++;
+        fi->stats.total_injected++;
 
         LOG_WARN("FaultInj: Injected erase timeout at address 0x%X", address);
         return TRUE;  /* Block the write */
@@ -305,11 +784,13 @@ boolean FaultInj_HookBeforeWrite(uint32_t address, uint32_t length)
  */
 boolean FaultInj_HookAfterWrite(uint32_t address)
 {
+    FaultInj_Context_t *fi = faultinj_context();
+
     /* Check for P0-01: Power loss during page program */
     FaultConfig_t *config = find_config(FAULT_P0_POWERLOSS_PAGEPROGRAM);
-    if (config != NULL && should_trigger(config)) {
+    if (config != NULL && targets_address(config, address) && should_trigger(config)) {
         config->triggered_count++;
-        g_stats.total_injected++;
+        fi->stats.total_injected++;
 
         LOG_ERROR("FaultInj: Injected power loss after write at 0x%X", address);
         return TRUE;  /* Simulate power loss */
@@ -323,6 +804,8 @@ boolean FaultInj_HookAfterWrite(uint32_t address)
  */
 boolean FaultInj_HookCrc(const uint8_t *data, uint32_t length, uint16_t *crc)
 {
+    FaultInj_Context_t *fi = faultinj_context();
+
     if (crc == NULL) {
         return FALSE;
     }
@@ -335,7 +818,7 @@ boolean FaultInj_HookCrc(const uint8_t *data, uint32_t length, uint16_t *crc)
     if (config != NULL && should_trigger(config)) {
         *crc = ~(*crc);
         config->triggered_count++;
-        g_stats.total_injected++;
+        fi->stats.total_injected++;
 
         LOG_WARN("FaultInj: Injected CRC inversion (0x%04X -> 0x%04X)",
                  ~(*crc), *crc);
@@ -346,26 +829,50 @@ boolean FaultInj_HookCrc(const uint8_t *data, uint32_t length, uint16_t *crc)
 }
 
 /**
- * @brief Hook: Called for write verification
+ * @brief Hook: Called for 32-bit CRC calculation
  */
-boolean FaultInj_HookVerify(uint32_t address, const uint8_t *expected_data,
-                            uint8_t *actual_data, uint32_t length)
+boolean FaultInj_HookCrc32(const uint8_t *data, uint32_t length, uint32_t *crc)
 {
-    if (actual_data == NULL || expected_data == NULL) {
+    FaultInj_Context_t *fi = faultinj_context();
+
+    if (crc == NULL) {
         return FALSE;
     }
 
-    (void)address;
+    (void)data;
+    (void)length;
+
+    /* Check for P0-07: CRC inversion */
+    FaultConfig_t *config = find_config(FAULT_P0_CRC_INVERT);
+    if (config != NULL && should_trigger(config)) {
+        *crc = ~(*crc);
+        config->triggered_count++;
+        fi->stats.total_injected++;
+
+        LOG_WARN("FaultInj: Injected CRC32 inversion (0x%08X -> 0x%08X)",
+                 ~(*crc), *crc);
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Hook: Called for write verification
+ */
+boolean FaultInj_HookVerify(uint32_t address, const uint8_t *expected_data, uint32_t length)
+{
+    FaultInj_Context_t *fi = faultinj_context();
+
+    if (expected_data == NULL || length == 0) {
+        return FALSE;
+    }
 
     /* Check for P0-08: Write verify always fail */
     FaultConfig_t *config = find_config(FAULT_P0_WRITE_VERIFY_FAIL);
-    if (config != NULL && should_trigger(config)) {
-        /* Corrupt actual data to cause verification failure */
-        if (length > 0) {
-            actual_data[0] = ~expected_data[0];
-        }
+    if (config != NULL && targets_address(config, address) && should_trigger(config)) {
         config->triggered_count++;
-        g_stats.total_injected++;
+        fi->stats.total_injected++;
 
         LOG_WARN("FaultInj: Injected verification failure at 0x%X", address);
         return TRUE;
@@ -379,6 +886,8 @@ boolean FaultInj_HookVerify(uint32_t address, const uint8_t *expected_data,
  */
 boolean FaultInj_HookRamMirror(uint8_t block_id, uint8_t *data, uint32_t length)
 {
+    FaultInj_Context_t *fi = faultinj_context();
+
     if (data == NULL || length == 0) {
         return FALSE;
     }
@@ -387,16 +896,16 @@ boolean FaultInj_HookRamMirror(uint8_t block_id, uint8_t *data, uint32_t length)
     FaultConfig_t *config = find_config(FAULT_P0_RAM_CORRUPT);
 
     /* Check if this block is targeted */
-    if (config != NULL && should_trigger(config)) {
-        if (config->target_block_id == 0xFF || config->target_block_id == block_id) {
-            /* Corrupt data */
-            memset(data, 0xAA, length);
-            config->triggered_count++;
-            g_stats.total_injected++;
+    if (config != NULL &&
+        (config->target_block_id == FAULT_INJ_ALL_BLOCKS || config->target_block_id == block_id) &&
+        should_trigger(config)) {
+        /* Corrupt data */
+        memset(data, 0xAA, length);
+        config->triggered_count++;
+        fi->stats.total_injected++;
 
-            LOG_WARN("FaultInj: Injected RAM corruption for block %d", block_id);
-            return TRUE;
-        }
+        LOG_WARN("FaultInj: Injected RAM corruption for block %d", block_id);
+        return TRUE;
     }
 
     return FALSE;
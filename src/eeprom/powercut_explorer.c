@@ -0,0 +1,217 @@
+/**
+ * @file powercut_explorer.c
+ * @brief Power-cut exploration by forking at every program/erase boundary
+ *
+ * REQ-故障库: design/07-系统测试与故障场景.md §2
+ * - 驱动观察者 (Eep_SetCutHook) 在每次编程/擦除前回调; 编程按页拆成多个掉电点
+ * - fork即快照: 子进程的器件镜像与模块状态写时复制, 父进程继续工作负载
+ * - 并行度受限: 在途分支达到上限时先回收一个
+ * - 结果按退出状态分类: 0通过, 非0失败, 信号终止为崩溃
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "powercut_explorer.h"
+#include "eeprom_internal.h"
+#include "logging.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+/**
+ * @brief Child exit status of a failed check
+ */
+#define POWERCUT_EXIT_FAILED 1
+
+/**
+ * @brief One branch being checked
+ */
+typedef struct {
+    pid_t pid;                      /**< 0 = free */
+    PowerCut_Point_t point;
+} PowerCut_Branch_t;
+
+static struct {
+    const PowerCut_Config_t *config;
+    uint32_t workers;
+    uint32_t page_size;
+    uint32_t in_flight;
+    PowerCut_Branch_t branches[POWERCUT_MAX_WORKERS];
+    PowerCut_Summary_t summary;
+} g_explore;
+
+static uint64_t now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000U + (uint64_t)ts.tv_nsec / 1000000U;
+}
+
+static void record_failure(const PowerCut_Point_t *point)
+{
+    PowerCut_Summary_t *summary = &g_explore.summary;
+
+    if (!summary->has_failure || point->index < summary->first_failure.index) {
+        summary->first_failure = *point;
+        summary->has_failure = TRUE;
+    }
+}
+
+/**
+ * @brief Wait for one of our branches and classify its outcome
+ */
+static void reap_one(void)
+{
+    while (g_explore.in_flight > 0U) {
+        int wstatus;
+        pid_t pid = wait(&wstatus);
+        if (pid < 0) {
+            return;
+        }
+
+        uint32_t b = 0;
+        while (b < g_explore.workers && g_explore.branches[b].pid != pid) {
+            b++;
+        }
+        if (b == g_explore.workers) {
+            continue;   /* Not one of ours */
+        }
+
+        PowerCut_Branch_t *branch = &g_explore.branches[b];
+        if (WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0) {
+            g_explore.summary.passed++;
+        } else if (WIFEXITED(wstatus)) {
+            LOG_ERROR("PowerCut: Check failed at cut %u (op %d at 0x%X, %u pages done)",
+                      branch->point.index, branch->point.op, branch->point.address,
+                      branch->point.pages_done);
+            g_explore.summary.failed++;
+            record_failure(&branch->point);
+        } else {
+            LOG_ERROR("PowerCut: Check crashed at cut %u", branch->point.index);
+            g_explore.summary.crashed++;
+            record_failure(&branch->point);
+        }
+
+        branch->pid = 0;
+        g_explore.in_flight--;
+        return;
+    }
+}
+
+/**
+ * @brief Fork one branch at the current device state
+ *
+ * @param data Program source; the child programs its first pages_done pages
+ */
+static void branch(const PowerCut_Point_t *point, const uint8_t *data)
+{
+    if (g_explore.in_flight == g_explore.workers) {
+        reap_one();
+    }
+
+    /* Buffered output would otherwise be printed again by the child */
+    fflush(NULL);
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        boolean passed = TRUE;
+
+        Eep_SetCutHook(NULL);
+        if (point->pages_done > 0U &&
+            Eep_Write(point->address, data, point->pages_done * g_explore.page_size) != E_OK) {
+            passed = FALSE;
+        }
+        if (passed) {
+            passed = g_explore.config->check(point, g_explore.config->user_ctx);
+        }
+        fflush(NULL);
+        _exit(passed ? 0 : POWERCUT_EXIT_FAILED);
+    }
+
+    g_explore.summary.cuts++;
+    if (pid < 0) {
+        LOG_WARN("PowerCut: Cannot fork the branch of cut %u", point->index);
+        g_explore.summary.not_run++;
+        return;
+    }
+
+    uint32_t b = 0;
+    while (g_explore.branches[b].pid != 0) {
+        b++;
+    }
+    g_explore.branches[b].pid = pid;
+    g_explore.branches[b].point = *point;
+    g_explore.in_flight++;
+}
+
+/**
+ * @brief Driver observer: one cut per page not yet programmed, one before an erase
+ */
+static void cut_hook(Eep_OpType_t op, uint32_t address, const uint8_t *data, uint32_t length)
+{
+    PowerCut_Point_t point = { .op = op, .address = address, .completed = FALSE };
+    uint32_t pages = 1U;
+
+    if (op == EEP_OP_WRITE) {
+        pages = length / g_explore.page_size;
+        g_explore.summary.programs++;
+    } else {
+        g_explore.summary.erases++;
+    }
+
+    for (uint32_t done = 0; done < pages; done++) {
+        point.index = g_explore.summary.cuts;
+        point.pages_done = done;
+        branch(&point, data);
+    }
+}
+
+Std_ReturnType PowerCut_Explore(const PowerCut_Config_t *config, PowerCut_Summary_t *summary)
+{
+    const Eeprom_ConfigType *eep = Eep_GetConfig();
+
+    if (config == NULL || config->workload == NULL || config->check == NULL || eep == NULL) {
+        return E_NOT_OK;
+    }
+
+    memset(&g_explore, 0, sizeof(g_explore));
+    g_explore.config = config;
+    g_explore.page_size = eep->page_size;
+    g_explore.workers = config->worker_count;
+    if (g_explore.workers == 0U) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        g_explore.workers = (cpus > 0) ? (uint32_t)cpus : 1U;
+    }
+    if (g_explore.workers > POWERCUT_MAX_WORKERS) {
+        g_explore.workers = POWERCUT_MAX_WORKERS;
+    }
+
+    uint64_t start = now_ms();
+
+    Eep_SetCutHook(cut_hook);
+    config->workload(config->user_ctx);
+    Eep_SetCutHook(NULL);
+
+    /* The uncut run must recover too */
+    PowerCut_Point_t last = { .index = g_explore.summary.cuts, .op = EEP_OP_WRITE,
+                              .completed = TRUE };
+    branch(&last, NULL);
+
+    while (g_explore.in_flight > 0U) {
+        reap_one();
+    }
+    g_explore.summary.elapsed_ms = (uint32_t)(now_ms() - start);
+
+    LOG_INFO("PowerCut: %u cuts (%u programs, %u erases) on %u workers in %u ms: "
+             "%u passed, %u failed, %u crashed", g_explore.summary.cuts,
+             g_explore.summary.programs, g_explore.summary.erases, g_explore.workers,
+             g_explore.summary.elapsed_ms, g_explore.summary.passed, g_explore.summary.failed,
+             g_explore.summary.crashed);
+
+    if (summary != NULL) {
+        *summary = g_explore.summary;
+    }
+    return (g_explore.summary.not_run == 0U) ? E_OK : E_NOT_OK;
+}
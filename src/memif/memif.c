@@ -4,37 +4,201 @@
  *
  * REQ-MemIf抽象层: design/02-NvM架构设计.md §1.1
  * - 统一的内存访问接口
- * - 驱动抽象(当前仅支持EEPROM)
- * - 异步作业处理
+ * - 设备表: 按地址范围路由到EEPROM / Flash / RAM
+ * - 异步作业处理: 每个设备独立的作业槽与时序模型
+ * - EEPROM磨损均衡: 访问前将逻辑地址转换为物理地址 (memif_wearlevel.c)
+ * - 多实例: 设备表与磨损均衡状态属于上下文, 设备0为当前线程绑定的EEPROM上下文
  */
 
 #include "memif.h"
+#include "memif_internal.h"
 #include "eeprom_driver.h"
+#include "os_scheduler.h"
+#include "sim_context.h"
+#include "metrics.h"
+#include "trace_probes.h"
 #include "logging.h"
+#include <stdlib.h>
 #include <string.h>
 
 /**
- * @brief Current active job
+ * @brief Device table entry
  */
-static MemIf_Job_t g_current_job = {0};
+typedef struct {
+    boolean in_use;                /**< Slot populated */
+    MemIf_DeviceConfig_t cfg;      /**< Geometry, timing and address range */
+    uint8_t *storage;              /**< Emulated content (FLASH/RAM only) */
+    MemIf_Job_t job;               /**< Job slot */
+    MemIf_JobStatus_t job_status;  /**< Job status */
+    Std_ReturnType job_result;     /**< Job result */
+    uint64_t submit_ns;            /**< Host time of submission (0 = not timed) */
+} MemIf_Device_t;
 
 /**
- * @brief Job status
+ * @brief Device table of one MemIf context
+ *
+ * Slot 0 is always the EEPROM driver, so routing works even before
+ * MemIf_Init (callers that only initialized Eep directly).
+ */
+struct MemIf_DeviceTable {
+    MemIf_Device_t devices[MEMIF_MAX_DEVICES];
+    MemIf_DeviceIdType last_device;     /**< Device of the most recently submitted job */
+};
+
+/**
+ * @brief Table used while no context is bound
+ */
+static struct MemIf_DeviceTable g_default_table = {
+    .devices = {
+        [MEMIF_DEVICE_ID_EEPROM] = { .in_use = TRUE, .cfg = { .type = MEMIF_DEVICE_EEPROM } }
+    },
+    .last_device = MEMIF_DEVICE_ID_EEPROM
+};
+
+static struct MemIf_DeviceTable* device_table(void)
+{
+    MemIf_Context_t *ctx = (MemIf_Context_t *)SimContext_Get(SIM_CONTEXT_MEMIF);
+
+    return (ctx != NULL) ? ctx->table : &g_default_table;
+}
+
+/**
+ * @brief Release emulated devices
  */
-static MemIf_JobStatus_t g_job_status = MEMIF_JOB_OK;
+static void memif_free_devices(void)
+{
+    struct MemIf_DeviceTable *tbl = device_table();
+
+    for (uint32_t i = 0; i < MEMIF_MAX_DEVICES; i++) {
+        free(tbl->devices[i].storage);
+    }
+    memset(tbl->devices, 0, sizeof(tbl->devices));
+
+    tbl->devices[MEMIF_DEVICE_ID_EEPROM].in_use = TRUE;
+    tbl->devices[MEMIF_DEVICE_ID_EEPROM].cfg.type = MEMIF_DEVICE_EEPROM;
+}
 
 /**
- * @brief Job result
+ * @brief Track EEPROM geometry and timing (the driver may be re-initialized)
  */
-static Std_ReturnType g_job_result = E_OK;
+static void memif_sync_eeprom(MemIf_Device_t *dev)
+{
+    const Eeprom_ConfigType *eep = Eep_GetConfig();
+
+    if (eep == NULL) {
+        dev->cfg.size_bytes = 0;
+        return;
+    }
+
+    dev->cfg.size_bytes = eep->capacity_bytes;
+    dev->cfg.page_size = eep->page_size;
+    dev->cfg.block_size = eep->block_size;
+    dev->cfg.read_delay_us = eep->read_delay_us;
+    dev->cfg.write_delay_ms = eep->write_delay_ms;
+    dev->cfg.erase_delay_ms = eep->erase_delay_ms;
+}
+
+/**
+ * @brief Find the device owning [address, address+length)
+ *
+ * @param local Receives the device-local address
+ * @return Device, or NULL if no single device owns the whole range
+ */
+static MemIf_Device_t* memif_route(uint32_t address, uint32_t length, uint32_t *local)
+{
+    struct MemIf_DeviceTable *tbl = device_table();
+
+    for (uint32_t i = 0; i < MEMIF_MAX_DEVICES; i++) {
+        MemIf_Device_t *dev = &tbl->devices[i];
+        if (!dev->in_use) {
+            continue;
+        }
+        if (dev->cfg.type == MEMIF_DEVICE_EEPROM) {
+            memif_sync_eeprom(dev);
+        }
+        if (address < dev->cfg.base_address) {
+            continue;
+        }
+
+        uint32_t offset = address - dev->cfg.base_address;
+        if (offset < dev->cfg.size_bytes && length <= (dev->cfg.size_bytes - offset)) {
+            *local = offset;
+            return dev;
+        }
+    }
+
+    return NULL;
+}
+
+/* ============================================================================
+ * Device Primitives
+ * ============================================================================ */
+
+static Std_ReturnType dev_read(MemIf_Device_t *dev, uint32_t local, uint8_t *data, uint32_t length)
+{
+    if (dev->cfg.type == MEMIF_DEVICE_EEPROM) {
+        return Eep_Read(local, data, length);
+    }
+
+    memcpy(data, &dev->storage[local], length);
+    return E_OK;
+}
+
+static Std_ReturnType dev_write(MemIf_Device_t *dev, uint32_t local, const uint8_t *data, uint32_t length)
+{
+    if (dev->cfg.type == MEMIF_DEVICE_EEPROM) {
+        return Eep_Write(local, data, length);
+    }
+
+    if (dev->cfg.type == MEMIF_DEVICE_FLASH) {
+        /* Flash: page-aligned program of erased cells only */
+        if ((local % dev->cfg.page_size) != 0U || (length % dev->cfg.page_size) != 0U) {
+            return E_NOT_OK;
+        }
+        for (uint32_t i = 0; i < length; i++) {
+            if (dev->storage[local + i] != 0xFF) {
+                return E_NOT_OK;
+            }
+        }
+    }
+
+    memcpy(&dev->storage[local], data, length);
+    return E_OK;
+}
+
+static Std_ReturnType dev_verify(MemIf_Device_t *dev, uint32_t local, const uint8_t *data,
+                                 uint32_t length)
+{
+    if (dev->cfg.type == MEMIF_DEVICE_EEPROM) {
+        return Eep_Verify(local, data, length);
+    }
+
+    return (memcmp(&dev->storage[local], data, length) == 0) ? E_OK : E_NOT_OK;
+}
+
+static Std_ReturnType dev_erase(MemIf_Device_t *dev, uint32_t local)
+{
+    if (dev->cfg.type == MEMIF_DEVICE_EEPROM) {
+        return Eep_Erase(local);
+    }
+
+    memset(&dev->storage[local], 0xFF, dev->cfg.block_size);
+    return E_OK;
+}
 
 /**
  * @brief Initialize MemIf layer
  */
 Std_ReturnType MemIf_Init(void)
 {
+    struct MemIf_DeviceTable *tbl = device_table();
+
     LOG_INFO("MemIf: Initializing...");
 
+    memif_free_devices();
+    MemIf_WL_Reset();
+    tbl->last_device = MEMIF_DEVICE_ID_EEPROM;
+
     /* Initialize underlying EEPROM driver */
     Std_ReturnType ret = Eep_Init(NULL);
     if (ret != E_OK) {
@@ -42,15 +206,85 @@ Std_ReturnType MemIf_Init(void)
         return E_NOT_OK;
     }
 
-    /* Reset job state */
-    memset(&g_current_job, 0, sizeof(MemIf_Job_t));
-    g_job_status = MEMIF_JOB_OK;
-    g_job_result = E_OK;
+    /* Device 0: EEPROM at the bottom of the address space */
+    memif_sync_eeprom(&tbl->devices[MEMIF_DEVICE_ID_EEPROM]);
 
     LOG_INFO("MemIf: Initialization complete");
     return E_OK;
 }
 
+Std_ReturnType MemIf_AddDevice(const MemIf_DeviceConfig_t *config, MemIf_DeviceIdType *device_id)
+{
+    struct MemIf_DeviceTable *tbl = device_table();
+
+    if (config == NULL || config->type == MEMIF_DEVICE_EEPROM ||
+        config->size_bytes == 0U || config->page_size == 0U || config->block_size == 0U ||
+        (config->size_bytes % config->block_size) != 0U ||
+        config->base_address > (UINT32_MAX - config->size_bytes)) {
+        return E_NOT_OK;
+    }
+
+    uint32_t free_slot = MEMIF_MAX_DEVICES;
+    for (uint32_t i = 0; i < MEMIF_MAX_DEVICES; i++) {
+        MemIf_Device_t *dev = &tbl->devices[i];
+        if (!dev->in_use) {
+            if (free_slot == MEMIF_MAX_DEVICES) {
+                free_slot = i;
+            }
+            continue;
+        }
+        if (dev->cfg.type == MEMIF_DEVICE_EEPROM) {
+            memif_sync_eeprom(dev);
+        }
+
+        /* Reject overlapping address ranges */
+        if (config->base_address < dev->cfg.base_address + dev->cfg.size_bytes &&
+            dev->cfg.base_address < config->base_address + config->size_bytes) {
+            LOG_ERROR("MemIf: Device range 0x%X overlaps device %u",
+                      config->base_address, i);
+            return E_NOT_OK;
+        }
+    }
+
+    if (free_slot == MEMIF_MAX_DEVICES) {
+        return E_NOT_OK;
+    }
+
+    MemIf_Device_t *dev = &tbl->devices[free_slot];
+    dev->storage = (uint8_t *)malloc(config->size_bytes);
+    if (dev->storage == NULL) {
+        return E_NOT_OK;
+    }
+    memset(dev->storage, 0xFF, config->size_bytes);
+
+    dev->in_use = TRUE;
+    dev->cfg = *config;
+    dev->job_status = MEMIF_JOB_OK;
+    dev->job_result = E_OK;
+
+    if (device_id != NULL) {
+        *device_id = (MemIf_DeviceIdType)free_slot;
+    }
+
+    LOG_INFO("MemIf: Device %u (type=%d) at 0x%X, %u bytes",
+             free_slot, config->type, config->base_address, config->size_bytes);
+    return E_OK;
+}
+
+Std_ReturnType MemIf_GetDeviceForAddress(uint32_t address, MemIf_DeviceIdType *device_id)
+{
+    struct MemIf_DeviceTable *tbl = device_table();
+    uint32_t local;
+    MemIf_Device_t *dev = memif_route(address, 1, &local);
+
+    if (dev == NULL || device_id == NULL) {
+        return E_NOT_OK;
+    }
+
+    *device_id = (MemIf_DeviceIdType)(dev - tbl->devices);
+    return E_OK;
+}
+
 /**
  * @brief Read data from memory device
  */
@@ -63,13 +297,21 @@ Std_ReturnType MemIf_Read(uint32_t address, uint8_t *data_buffer, uint32_t lengt
 
     LOG_DEBUG("MemIf: Read %u bytes from address 0x%X", length, address);
 
-    /* Currently only EEPROM is supported */
-    Std_ReturnType ret = Eep_Read(address, data_buffer, length);
-
-    if (ret != E_OK) {
-        LOG_ERROR("MemIf: Read failed at address 0x%X", address);
-        return E_NOT_OK;
-    }
+    /* One pass per wear-leveled slot the range touches */
+    do {
+        uint32_t local, physical, chunk;
+        MemIf_Device_t *dev = NULL;
+        if (MemIf_WL_Map(address, length, &physical, &chunk) == E_OK) {
+            dev = memif_route(physical, chunk, &local);
+        }
+        if (dev == NULL || dev_read(dev, local, data_buffer, chunk) != E_OK) {
+            LOG_ERROR("MemIf: Read failed at address 0x%X", address);
+            return E_NOT_OK;
+        }
+        address += chunk;
+        data_buffer += chunk;
+        length -= chunk;
+    } while (length > 0U);
 
     return E_OK;
 }
@@ -86,13 +328,21 @@ Std_ReturnType MemIf_Write(uint32_t address, const uint8_t *data_buffer, uint32_
 
     LOG_DEBUG("MemIf: Write %u bytes to address 0x%X", length, address);
 
-    /* Currently only EEPROM is supported */
-    Std_ReturnType ret = Eep_Write(address, data_buffer, length);
-
-    if (ret != E_OK) {
-        LOG_ERROR("MemIf: Write failed at address 0x%X", address);
-        return E_NOT_OK;
-    }
+    /* One pass per wear-leveled slot the range touches */
+    do {
+        uint32_t local, physical, chunk;
+        MemIf_Device_t *dev = NULL;
+        if (MemIf_WL_Map(address, length, &physical, &chunk) == E_OK) {
+            dev = memif_route(physical, chunk, &local);
+        }
+        if (dev == NULL || dev_write(dev, local, data_buffer, chunk) != E_OK) {
+            LOG_ERROR("MemIf: Write failed at address 0x%X", address);
+            return E_NOT_OK;
+        }
+        address += chunk;
+        data_buffer += chunk;
+        length -= chunk;
+    } while (length > 0U);
 
     return E_OK;
 }
@@ -104,16 +354,24 @@ Std_ReturnType MemIf_Erase(uint32_t address, uint32_t length)
 {
     LOG_DEBUG("MemIf: Erase %u bytes at address 0x%X", length, address);
 
-    /* EEPROM must be erased in block units */
-    if (!Eep_IsBlockAligned(address)) {
-        LOG_ERROR("MemIf: Erase failed - address not block-aligned");
+    uint32_t local, physical, chunk;
+    MemIf_Device_t *dev = NULL;
+    if (MemIf_WL_Map(address, 1, &physical, &chunk) == E_OK) {
+        dev = memif_route(physical, 1, &local);
+    }
+    if (dev == NULL) {
+        LOG_ERROR("MemIf: Erase failed at address 0x%X", address);
         return E_NOT_OK;
     }
 
-    /* Erase the block */
-    Std_ReturnType ret = Eep_Erase(address);
+    /* Devices must be erased in block units */
+    if ((local % dev->cfg.block_size) != 0U) {
+        LOG_ERROR("MemIf: Erase failed - address not block-aligned");
+        return E_NOT_OK;
+    }
 
-    if (ret != E_OK) {
+    /* Erase the block (a leveled slot may move to a spare block) */
+    if ((MemIf_WL_Leveled(address) ? MemIf_WL_Erase(address) : dev_erase(dev, local)) != E_OK) {
         LOG_ERROR("MemIf: Erase failed at address 0x%X", address);
         return E_NOT_OK;
     }
@@ -121,12 +379,326 @@ Std_ReturnType MemIf_Erase(uint32_t address, uint32_t length)
     return E_OK;
 }
 
+/**
+ * @brief Compare memory device content with expected data
+ */
+Std_ReturnType MemIf_Verify(uint32_t address, const uint8_t *expected_data, uint32_t length)
+{
+    if (expected_data == NULL) {
+        LOG_ERROR("MemIf: Verify failed - NULL buffer");
+        return E_NOT_OK;
+    }
+
+    LOG_DEBUG("MemIf: Verify %u bytes at address 0x%X", length, address);
+
+    /* One pass per wear-leveled slot the range touches */
+    do {
+        uint32_t local, physical, chunk;
+        MemIf_Device_t *dev = NULL;
+        if (MemIf_WL_Map(address, length, &physical, &chunk) == E_OK) {
+            dev = memif_route(physical, chunk, &local);
+        }
+        if (dev == NULL || dev_verify(dev, local, expected_data, chunk) != E_OK) {
+            LOG_DEBUG("MemIf: Verify mismatch or failure at address 0x%X", address);
+            return E_NOT_OK;
+        }
+        address += chunk;
+        expected_data += chunk;
+        length -= chunk;
+    } while (length > 0U);
+
+    return E_OK;
+}
+
+/**
+ * @brief Translate a vector to device-local segments and run it
+ *
+ * EEPROM segments are gathered into driver vectors of up to MEMIF_IOV_MAX;
+ * other devices are handled segment by segment in between.
+ */
+static Std_ReturnType memif_run_vector(const MemIf_IoVec_t *iov, uint32_t count, boolean write)
+{
+    Eep_IoVec_t eep[MEMIF_IOV_MAX];
+    uint32_t pending = 0;
+
+    if (iov == NULL) {
+        return E_NOT_OK;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t address = iov[i].address;
+        uint8_t *buffer = (uint8_t *)iov[i].buffer;
+        uint32_t length = iov[i].length;
+
+        if (buffer == NULL) {
+            return E_NOT_OK;
+        }
+
+        /* One piece per wear-leveled slot the segment touches */
+        while (length > 0U) {
+            uint32_t local, physical, chunk;
+            MemIf_Device_t *dev = NULL;
+            if (MemIf_WL_Map(address, length, &physical, &chunk) == E_OK) {
+                dev = memif_route(physical, chunk, &local);
+            }
+            if (dev == NULL) {
+                LOG_ERROR("MemIf: Vectored %s failed at address 0x%X", write ? "write" : "read", address);
+                return E_NOT_OK;
+            }
+
+            if (dev->cfg.type == MEMIF_DEVICE_EEPROM) {
+                if (pending == MEMIF_IOV_MAX) {
+                    if ((write ? Eep_WriteV(eep, pending) : Eep_ReadV(eep, pending)) != E_OK) {
+                        return E_NOT_OK;
+                    }
+                    pending = 0;
+                }
+                eep[pending].address = local;
+                eep[pending].buffer = buffer;
+                eep[pending].length = chunk;
+                pending++;
+            } else if ((write ? dev_write(dev, local, buffer, chunk)
+                              : dev_read(dev, local, buffer, chunk)) != E_OK) {
+                LOG_ERROR("MemIf: Vectored %s failed at address 0x%X", write ? "write" : "read", address);
+                return E_NOT_OK;
+            }
+
+            address += chunk;
+            buffer += chunk;
+            length -= chunk;
+        }
+    }
+
+    if (pending > 0U && (write ? Eep_WriteV(eep, pending) : Eep_ReadV(eep, pending)) != E_OK) {
+        LOG_ERROR("MemIf: Vectored %s of %u segments failed", write ? "write" : "read", pending);
+        return E_NOT_OK;
+    }
+
+    return E_OK;
+}
+
+/**
+ * @brief Read several segments as one request
+ */
+Std_ReturnType MemIf_ReadV(const MemIf_IoVec_t *iov, uint32_t count)
+{
+    LOG_DEBUG("MemIf: ReadV of %u segments", count);
+    return memif_run_vector(iov, count, FALSE);
+}
+
+/**
+ * @brief Program several segments as one request
+ */
+Std_ReturnType MemIf_WriteV(const MemIf_IoVec_t *iov, uint32_t count)
+{
+    LOG_DEBUG("MemIf: WriteV of %u segments", count);
+    return memif_run_vector(iov, count, TRUE);
+}
+
+/* ============================================================================
+ * Asynchronous Job Engine
+ * ============================================================================ */
+
+/**
+ * @brief Current virtual time in microseconds
+ */
+static uint64_t memif_now_us(void)
+{
+    return (uint64_t)OsScheduler_GetVirtualTimeMs() * 1000U;
+}
+
+/**
+ * @brief Bytes processed by the next step of a device's job
+ */
+static uint32_t memif_step_length(const MemIf_Device_t *dev)
+{
+    const MemIf_Job_t *job = &dev->job;
+    uint32_t unit = (job->job_type == MEMIF_JOB_ERASE) ? dev->cfg.block_size : dev->cfg.page_size;
+    uint32_t remaining = job->length - job->progress;
+
+    return (remaining < unit) ? remaining : unit;
+}
+
+/**
+ * @brief Device time of one step in microseconds
+ */
+static uint64_t memif_step_delay_us(const MemIf_Device_t *dev, uint32_t step_len)
+{
+    /* EEPROM with driver timing on: draw from the driver's latency model */
+    if (dev->cfg.type == MEMIF_DEVICE_EEPROM && Eep_GetTimingMode() != EEP_TIMING_OFF) {
+        switch (dev->job.job_type) {
+            case MEMIF_JOB_READ:
+                return Eep_SampleLatencyUs(EEP_OP_READ, step_len);
+            case MEMIF_JOB_WRITE:
+                return Eep_SampleLatencyUs(EEP_OP_WRITE, step_len);
+            case MEMIF_JOB_ERASE:
+                return Eep_SampleLatencyUs(EEP_OP_ERASE, step_len);
+            default:
+                return 0;
+        }
+    }
+
+    switch (dev->job.job_type) {
+        case MEMIF_JOB_READ:
+            return (uint64_t)step_len * dev->cfg.read_delay_us;
+        case MEMIF_JOB_WRITE:
+            return (uint64_t)dev->cfg.write_delay_ms * 1000U;
+        case MEMIF_JOB_ERASE:
+            return (uint64_t)dev->cfg.erase_delay_ms * 1000U;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Finish a device's job and notify the submitter
+ */
+static void memif_finish_job(MemIf_Device_t *dev, MemIf_JobStatus_t status)
+{
+    dev->job_status = status;
+    dev->job_result = (status == MEMIF_JOB_OK) ? E_OK : E_NOT_OK;
+    dev->job.status = status;
+    dev->job.complete_time_ms = OsScheduler_GetVirtualTimeMs();
+    TRACE_PROBE3(memif, job_done, dev->job.job_type, dev->job.address, status);
+
+    if (METRICS_ENABLED() && dev->submit_ns != 0U && dev->job.job_type <= MEMIF_JOB_ERASE) {
+        static const Metrics_SeriesId_t series[] = {
+            [MEMIF_JOB_READ] = METRIC_MEMIF_READ,
+            [MEMIF_JOB_WRITE] = METRIC_MEMIF_WRITE,
+            [MEMIF_JOB_ERASE] = METRIC_MEMIF_ERASE
+        };
+        Metrics_Record(series[dev->job.job_type], Metrics_HostNs() - dev->submit_ns,
+                       (uint64_t)(dev->job.complete_time_ms - dev->job.submit_time_ms) * 1000U);
+    }
+
+    if (dev->job.callback != NULL) {
+        dev->job.callback(&dev->job, dev->job.user_ctx);
+    }
+}
+
+/**
+ * @brief Accept a job into the owning device's job slot
+ */
+static Std_ReturnType memif_submit(MemIf_JobType_t type, uint32_t address, uint8_t *data,
+                                   uint32_t length, MemIf_JobCallback_t callback, void *user_ctx)
+{
+    struct MemIf_DeviceTable *tbl = device_table();
+    uint32_t local, physical, chunk;
+    uint32_t span = (type == MEMIF_JOB_ERASE) ? 1U : length;
+    MemIf_Device_t *dev;
+
+    if (length == 0U) {
+        return E_NOT_OK;
+    }
+
+    /* Jobs are not split: a read/write must stay within one leveled slot */
+    if (MemIf_WL_Map(address, span, &physical, &chunk) != E_OK || chunk != span) {
+        return E_NOT_OK;
+    }
+
+    dev = memif_route(physical, span, &local);
+    if (dev == NULL) {
+        return E_NOT_OK;
+    }
+
+    if (type == MEMIF_JOB_ERASE && (local % dev->cfg.block_size) != 0U) {
+        return E_NOT_OK;
+    }
+
+    if (dev->job_status == MEMIF_JOB_PENDING) {
+        LOG_DEBUG("MemIf: Device %u busy, job rejected", (uint32_t)(dev - tbl->devices));
+        return E_NOT_OK;
+    }
+
+    MemIf_Job_t *job = &dev->job;
+    memset(job, 0, sizeof(MemIf_Job_t));
+    job->job_type = type;
+    job->address = address;
+    job->data_ptr = data;
+    job->length = length;
+    job->status = MEMIF_JOB_PENDING;
+    job->device = dev->cfg.type;
+    job->submit_time_ms = OsScheduler_GetVirtualTimeMs();
+    job->callback = callback;
+    job->user_ctx = user_ctx;
+    job->next_step_us = memif_now_us() + memif_step_delay_us(dev, memif_step_length(dev));
+
+    dev->job_status = MEMIF_JOB_PENDING;
+    dev->job_result = E_OK;
+    dev->submit_ns = METRICS_ENABLED() ? Metrics_HostNs() : 0U;
+    tbl->last_device = (MemIf_DeviceIdType)(dev - tbl->devices);
+    TRACE_PROBE4(memif, job_submit, type, address, length, tbl->last_device);
+
+    LOG_DEBUG("MemIf: Job %d submitted to device %u (addr=0x%X, len=%u)",
+              type, (uint32_t)tbl->last_device, address, length);
+    return E_OK;
+}
+
+Std_ReturnType MemIf_SubmitRead(uint32_t address, uint8_t *data_buffer, uint32_t length,
+                                MemIf_JobCallback_t callback, void *user_ctx)
+{
+    if (data_buffer == NULL) {
+        return E_NOT_OK;
+    }
+
+    return memif_submit(MEMIF_JOB_READ, address, data_buffer, length, callback, user_ctx);
+}
+
+Std_ReturnType MemIf_SubmitWrite(uint32_t address, const uint8_t *data_buffer, uint32_t length,
+                                 MemIf_JobCallback_t callback, void *user_ctx)
+{
+    if (data_buffer == NULL) {
+        return E_NOT_OK;
+    }
+
+    /* The buffer is only read back by the write step */
+    return memif_submit(MEMIF_JOB_WRITE, address, (uint8_t *)data_buffer, length,
+                        callback, user_ctx);
+}
+
+Std_ReturnType MemIf_SubmitErase(uint32_t address, uint32_t length,
+                                 MemIf_JobCallback_t callback, void *user_ctx)
+{
+    return memif_submit(MEMIF_JOB_ERASE, address, NULL, length, callback, user_ctx);
+}
+
+const MemIf_Job_t* MemIf_GetCurrentJob(void)
+{
+    struct MemIf_DeviceTable *tbl = device_table();
+
+    return &tbl->devices[tbl->last_device].job;
+}
+
+const MemIf_Job_t* MemIf_GetDeviceJob(MemIf_DeviceIdType device_id)
+{
+    struct MemIf_DeviceTable *tbl = device_table();
+
+    if (device_id >= MEMIF_MAX_DEVICES || !tbl->devices[device_id].in_use) {
+        return NULL;
+    }
+
+    return &tbl->devices[device_id].job;
+}
+
+MemIf_JobStatus_t MemIf_GetDeviceJobStatus(MemIf_DeviceIdType device_id)
+{
+    struct MemIf_DeviceTable *tbl = device_table();
+
+    if (device_id >= MEMIF_MAX_DEVICES || !tbl->devices[device_id].in_use) {
+        return MEMIF_JOB_FAILED;
+    }
+
+    return tbl->devices[device_id].job_status;
+}
+
 /**
  * @brief Get current job status
  */
 MemIf_JobStatus_t MemIf_GetJobStatus(void)
 {
-    return g_job_status;
+    struct MemIf_DeviceTable *tbl = device_table();
+
+    return tbl->devices[tbl->last_device].job_status;
 }
 
 /**
@@ -134,22 +706,102 @@ MemIf_JobStatus_t MemIf_GetJobStatus(void)
  */
 Std_ReturnType MemIf_GetJobResult(void)
 {
-    return g_job_result;
+    struct MemIf_DeviceTable *tbl = device_table();
+
+    return tbl->devices[tbl->last_device].job_result;
+}
+
+Std_ReturnType MemIf_CancelDeviceJob(MemIf_DeviceIdType device_id)
+{
+    struct MemIf_DeviceTable *tbl = device_table();
+
+    if (device_id >= MEMIF_MAX_DEVICES) {
+        return E_NOT_OK;
+    }
+
+    MemIf_Device_t *dev = &tbl->devices[device_id];
+    if (dev->in_use && dev->job_status == MEMIF_JOB_PENDING) {
+        LOG_INFO("MemIf: Canceling job on device %u", (uint32_t)device_id);
+        memif_finish_job(dev, MEMIF_JOB_CANCELED);
+        return E_OK;
+    }
+
+    return E_NOT_OK;
 }
 
 /**
  * @brief Cancel current job
+ *
+ * Steps already completed stay on the device, as on real hardware.
  */
 Std_ReturnType MemIf_CancelJob(void)
 {
-    if (g_job_status == MEMIF_JOB_PENDING) {
-        LOG_INFO("MemIf: Canceling job");
-        g_job_status = MEMIF_JOB_CANCELED;
-        g_job_result = E_NOT_OK;
-        return E_OK;
-    }
+    struct MemIf_DeviceTable *tbl = device_table();
 
-    return E_NOT_OK;
+    return MemIf_CancelDeviceJob(tbl->last_device);
+}
+
+/**
+ * @brief Advance one device's job to the given virtual time
+ */
+static void memif_process_device(MemIf_Device_t *dev, uint64_t now_us)
+{
+    MemIf_Job_t *job = &dev->job;
+
+    /* A step takes effect once its device time has elapsed */
+    while (dev->job_status == MEMIF_JOB_PENDING && now_us >= job->next_step_us) {
+        uint32_t step_len = memif_step_length(dev);
+        uint32_t address = job->address + job->progress;
+        uint32_t local = address - dev->cfg.base_address;
+        uint32_t physical, chunk;
+        Std_ReturnType ret = E_NOT_OK;
+
+        /* The step's device time has already elapsed: do not charge the clock again */
+        Eep_SuspendClock(TRUE);
+
+        /* Each step is translated on its own: erase jobs may span several slots */
+        if (MemIf_WL_Map(address, step_len, &physical, &chunk) == E_OK && chunk == step_len) {
+            local = physical - dev->cfg.base_address;
+
+            switch (job->job_type) {
+                case MEMIF_JOB_READ:
+                    ret = dev_read(dev, local, &job->data_ptr[job->progress], step_len);
+                    break;
+                case MEMIF_JOB_WRITE:
+                    ret = dev_write(dev, local, &job->data_ptr[job->progress], step_len);
+                    break;
+                case MEMIF_JOB_ERASE:
+                    if (local >= dev->cfg.size_bytes) {
+                        ret = E_NOT_OK;
+                    } else if (MemIf_WL_Leveled(address)) {
+                        ret = MemIf_WL_Erase(address);
+                    } else {
+                        ret = dev_erase(dev, local);
+                    }
+                    break;
+                default:
+                    ret = E_NOT_OK;
+                    break;
+            }
+        }
+
+        Eep_SuspendClock(FALSE);
+
+        if (ret != E_OK) {
+            LOG_ERROR("MemIf: Job %d failed at address 0x%X",
+                      job->job_type, dev->cfg.base_address + local);
+            memif_finish_job(dev, MEMIF_JOB_FAILED);
+            return;
+        }
+
+        job->progress += step_len;
+        if (job->progress >= job->length) {
+            memif_finish_job(dev, MEMIF_JOB_OK);
+            return;
+        }
+
+        job->next_step_us += memif_step_delay_us(dev, memif_step_length(dev));
+    }
 }
 
 /**
@@ -157,25 +809,55 @@ Std_ReturnType MemIf_CancelJob(void)
  */
 void MemIf_MainFunction(void)
 {
-    /* Process current job if any */
-    if (g_current_job.job_type == MEMIF_JOB_READ) {
-        /* Process read job */
-        g_job_result = MemIf_Read(g_current_job.address,
-                                   g_current_job.data_ptr,
-                                   g_current_job.length);
-        g_job_status = (g_job_result == E_OK) ? MEMIF_JOB_OK : MEMIF_JOB_FAILED;
-    }
-    else if (g_current_job.job_type == MEMIF_JOB_WRITE) {
-        /* Process write job */
-        g_job_result = MemIf_Write(g_current_job.address,
-                                    g_current_job.data_ptr,
-                                    g_current_job.length);
-        g_job_status = (g_job_result == E_OK) ? MEMIF_JOB_OK : MEMIF_JOB_FAILED;
-    }
-    else if (g_current_job.job_type == MEMIF_JOB_ERASE) {
-        /* Process erase job */
-        g_job_result = MemIf_Erase(g_current_job.address,
-                                    g_current_job.length);
-        g_job_status = (g_job_result == E_OK) ? MEMIF_JOB_OK : MEMIF_JOB_FAILED;
+    struct MemIf_DeviceTable *tbl = device_table();
+    uint64_t now_us = memif_now_us();
+
+    for (uint32_t i = 0; i < MEMIF_MAX_DEVICES; i++) {
+        if (tbl->devices[i].in_use) {
+            memif_process_device(&tbl->devices[i], now_us);
+        }
+    }
+}
+
+MemIf_Context_t* MemIf_CreateContext(void)
+{
+    MemIf_Context_t *ctx = (MemIf_Context_t *)calloc(1, sizeof(MemIf_Context_t));
+
+    if (ctx == NULL) {
+        return NULL;
     }
+
+    ctx->table = (struct MemIf_DeviceTable *)calloc(1, sizeof(struct MemIf_DeviceTable));
+    ctx->wl = MemIf_WL_CreateState();
+    if (ctx->table == NULL || ctx->wl == NULL) {
+        MemIf_DestroyContext(ctx);
+        return NULL;
+    }
+
+    ctx->table->devices[MEMIF_DEVICE_ID_EEPROM].in_use = TRUE;
+    ctx->table->devices[MEMIF_DEVICE_ID_EEPROM].cfg.type = MEMIF_DEVICE_EEPROM;
+    ctx->table->last_device = MEMIF_DEVICE_ID_EEPROM;
+    return ctx;
+}
+
+void MemIf_DestroyContext(MemIf_Context_t *ctx)
+{
+    if (ctx == NULL) {
+        return;
+    }
+
+    if (ctx->table != NULL) {
+        for (uint32_t i = 0; i < MEMIF_MAX_DEVICES; i++) {
+            free(ctx->table->devices[i].storage);
+        }
+    }
+
+    free(ctx->table);
+    MemIf_WL_DestroyState(ctx->wl);
+    free(ctx);
+}
+
+MemIf_Context_t* MemIf_BindContext(MemIf_Context_t *ctx)
+{
+    return (MemIf_Context_t *)SimContext_Bind(SIM_CONTEXT_MEMIF, ctx);
 }
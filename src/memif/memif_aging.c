@@ -0,0 +1,101 @@
+/**
+ * @file memif_aging.c
+ * @brief Accelerated aging: fast-forward the wear of a workload profile
+ *
+ * REQ-EEPROM物理参数模型: design/01-EEPROM基础知识.md §1
+ * - 按擦除块给出每年擦写次数, 按天数批量推进擦写计数 (不实际擦除)
+ * - 磨损均衡范围内的逻辑槽回放均衡策略 (memif_wearlevel.c)
+ * - 计数在器件寿命处饱和; 磨损相关误码由故障注入 FAULT_WEAR_BITFLIP 提供
+ * - 寿命研究: 老化到最后窗口之前, 只对最后窗口运行真实负载
+ */
+
+#include "memif.h"
+#include "memif_internal.h"
+#include "eeprom_driver.h"
+#include "logging.h"
+#include <string.h>
+
+/**
+ * @brief Days per year of MemIf_AgingRate_t.cycles_per_year
+ */
+#define MEMIF_AGING_DAYS_PER_YEAR 365U
+
+static uint32_t period_erases(uint32_t cycles_per_year, uint32_t days)
+{
+    uint64_t erases = ((uint64_t)cycles_per_year * days) / MEMIF_AGING_DAYS_PER_YEAR;
+
+    return (erases > UINT32_MAX) ? UINT32_MAX : (uint32_t)erases;
+}
+
+static uint32_t add_saturated(uint32_t a, uint32_t b)
+{
+    return (b > UINT32_MAX - a) ? UINT32_MAX : a + b;
+}
+
+Std_ReturnType MemIf_Age(const MemIf_AgingProfile_t *profile, MemIf_AgingResult_t *result)
+{
+    const Eeprom_ConfigType *eep = Eep_GetConfig();
+    uint32_t slot_erases[MEMIF_WL_MAX_SLOTS];
+    boolean leveled = FALSE;
+    MemIf_AgingResult_t totals;
+
+    if (profile == NULL || (profile->rates == NULL && profile->rate_count > 0U) || eep == NULL) {
+        return E_NOT_OK;
+    }
+
+    /* Check everything before the first change */
+    for (uint32_t i = 0; i < profile->rate_count; i++) {
+        uint32_t address = profile->rates[i].address;
+        uint32_t physical;
+
+        if (address >= eep->capacity_bytes || (address % eep->block_size) != 0U ||
+            MemIf_WearLevelTranslate(address, &physical) != E_OK) {
+            LOG_ERROR("MemIf: Aging - invalid erase block 0x%X", address);
+            return E_NOT_OK;
+        }
+    }
+
+    memset(&totals, 0, sizeof(totals));
+    memset(slot_erases, 0, sizeof(slot_erases));
+
+    for (uint32_t i = 0; i < profile->rate_count; i++) {
+        const MemIf_AgingRate_t *rate = &profile->rates[i];
+        uint32_t erases = period_erases(rate->cycles_per_year, profile->days);
+
+        if (MemIf_WL_Leveled(rate->address)) {
+            uint32_t slot = MemIf_WL_Slot(rate->address);
+            slot_erases[slot] = add_saturated(slot_erases[slot], erases);
+            leveled = TRUE;
+            continue;
+        }
+
+        uint32_t before = 0;
+        uint32_t after = 0;
+        (void)Eep_GetEraseCount(rate->address, &before);
+        if (Eep_AddEraseCount(rate->address, erases) != E_OK) {
+            return E_NOT_OK;
+        }
+        (void)Eep_GetEraseCount(rate->address, &after);
+        totals.erases += after - before;
+    }
+
+    if (leveled && MemIf_WL_Age(slot_erases, &totals.erases, &totals.remaps) != E_OK) {
+        return E_NOT_OK;
+    }
+
+    for (uint32_t address = 0; address < eep->capacity_bytes; address += eep->block_size) {
+        uint32_t count = 0;
+        (void)Eep_GetEraseCount(address, &count);
+        if (count >= eep->endurance_cycles) {
+            totals.worn_out_blocks++;
+        }
+    }
+
+    LOG_INFO("MemIf: Aged %u days: +%u erase cycles, %u remaps, %u blocks worn out",
+             profile->days, totals.erases, totals.remaps, totals.worn_out_blocks);
+
+    if (result != NULL) {
+        *result = totals;
+    }
+    return E_OK;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file memif_internal.h
+ * @brief MemIf internal definitions shared between MemIf translation units
+ *
+ * Not part of the public API.
+ */
+
+#ifndef MEMIF_INTERNAL_H
+#define MEMIF_INTERNAL_H
+
+#include "memif.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief MemIf context: the state of each MemIf translation unit
+ *
+ * While no context is bound, each file uses its static default state.
+ */
+struct MemIf_Context {
+    struct MemIf_DeviceTable *table;    /**< memif.c */
+    struct MemIf_WearLevelState *wl;    /**< memif_wearlevel.c */
+};
+
+/**
+ * @brief Allocate the wear leveling state of a new context (disabled)
+ */
+struct MemIf_WearLevelState* MemIf_WL_CreateState(void);
+
+/**
+ * @brief Free a wear leveling state
+ */
+void MemIf_WL_DestroyState(struct MemIf_WearLevelState *state);
+
+/**
+ * @brief Disable wear leveling and forget the slot map (MemIf_Init)
+ */
+void MemIf_WL_Reset(void);
+
+/**
+ * @brief Translate the start of an access to a physical address
+ *
+ * @param address Logical address
+ * @param length Bytes requested
+ * @param physical Receives the physical address of the first byte
+ * @param chunk Receives the bytes contiguous at physical (<= length): an
+ *        access crossing a leveled slot boundary has to be split
+ * @return E_NOT_OK if the access starts in the reserved spare/metadata area
+ */
+Std_ReturnType MemIf_WL_Map(uint32_t address, uint32_t length, uint32_t *physical, uint32_t *chunk);
+
+/**
+ * @brief TRUE if the address lies in a leveled logical slot
+ */
+boolean MemIf_WL_Leveled(uint32_t address);
+
+/**
+ * @brief Erase a leveled logical slot, moving it to a spare if worn ahead
+ *
+ * @param address Block-aligned logical address (MemIf_WL_Leveled)
+ * @return E_OK once the slot reads back erased at its (new) physical block
+ */
+Std_ReturnType MemIf_WL_Erase(uint32_t address);
+
+/**
+ * @brief Logical slot of a leveled address (MemIf_WL_Leveled)
+ */
+uint32_t MemIf_WL_Slot(uint32_t address);
+
+/**
+ * @brief Replay the wear leveling policy for a number of erases per logical slot
+ *
+ * @param erases Erases per logical slot over the period (indexed by slot)
+ * @param added Incremented by the erase cycles added
+ * @param remaps Incremented by the remaps replayed
+ * @return E_NOT_OK on a device error while moving a slot or persisting the map
+ */
+Std_ReturnType MemIf_WL_Age(const uint32_t *erases, uint32_t *added, uint32_t *remaps);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MEMIF_INTERNAL_H */
@@ -0,0 +1,222 @@
+/**
+ * @file memif_replay.c
+ * @brief Replay of captured Eep I/O traces into the driver or MemIf
+ *
+ * - 按块读取跟踪文件 (每次 EEP_TRACE_DEFAULT_BUFFER 条记录)
+ * - 全速模式: 逐条直接调用, 不等待
+ * - 定时模式: 调度器时钟推进到记录的捕获时间; time_scale 非0时主机同步等待
+ * - 写操作编程固定图样 (跟踪不含负载), 校验操作与同一图样比较; 结果与捕获结果不一致时计数
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "eeprom_trace.h"
+#include "memif.h"
+#include "os_scheduler.h"
+#include "logging.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static uint64_t host_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Grow a buffer to hold length bytes
+ *
+ * @param pattern TRUE to fill new bytes with the write pattern
+ */
+static uint8_t* reserve_buffer(uint8_t *buffer, uint32_t *size, uint32_t length, boolean pattern)
+{
+    if (length <= *size) {
+        return buffer;
+    }
+
+    uint8_t *grown = realloc(buffer, length);
+    if (grown == NULL) {
+        free(buffer);
+        *size = 0;
+        return NULL;
+    }
+    if (pattern) {
+        for (uint32_t i = *size; i < length; i++) {
+            grown[i] = (uint8_t)(0x5AU ^ i);
+        }
+    }
+    *size = length;
+    return grown;
+}
+
+/**
+ * @brief Timed mode: wait until offset_ms after the replay started
+ */
+static void pace(const EepReplay_Config_t *cfg, uint32_t offset_ms, uint32_t base_ms,
+                 uint64_t start_ns)
+{
+    uint32_t elapsed_ms = OsScheduler_GetVirtualTimeMs() - base_ms;
+
+    if (elapsed_ms < offset_ms) {
+        OsScheduler_Sleep(offset_ms - elapsed_ms);
+    }
+
+    if (cfg->time_scale > 0U) {
+        uint64_t due_ns = start_ns + ((uint64_t)offset_ms * 1000000ULL) / cfg->time_scale;
+        uint64_t now_ns = host_now_ns();
+        if (now_ns < due_ns) {
+            struct timespec ts = {
+                .tv_sec = (time_t)((due_ns - now_ns) / 1000000000ULL),
+                .tv_nsec = (long)((due_ns - now_ns) % 1000000000ULL)
+            };
+            nanosleep(&ts, NULL);
+        }
+    }
+}
+
+static Std_ReturnType replay_one(const EepReplay_Config_t *cfg, const EepTrace_Record_t *rec,
+                                 uint8_t *scratch, const uint8_t *pattern)
+{
+    uint32_t address = rec->address + cfg->base_address;
+
+    switch ((Eep_OpType_t)rec->op) {
+        case EEP_OP_READ:
+            return (cfg->target == EEP_REPLAY_MEMIF) ? MemIf_Read(address, scratch, rec->length)
+                                                     : Eep_Read(address, scratch, rec->length);
+        case EEP_OP_WRITE:
+            return (cfg->target == EEP_REPLAY_MEMIF) ? MemIf_Write(address, pattern, rec->length)
+                                                     : Eep_Write(address, pattern, rec->length);
+        case EEP_OP_ERASE:
+            return (cfg->target == EEP_REPLAY_MEMIF) ? MemIf_Erase(address, rec->length)
+                                                     : Eep_Erase(address);
+        case EEP_OP_VERIFY:
+            return (cfg->target == EEP_REPLAY_MEMIF) ? MemIf_Verify(address, pattern, rec->length)
+                                                     : Eep_Verify(address, pattern, rec->length);
+        default:
+            return E_NOT_OK;
+    }
+}
+
+Std_ReturnType EepReplay_Run(const char *path, const EepReplay_Config_t *config,
+                             EepReplay_Stats_t *stats)
+{
+    static const EepReplay_Config_t default_config = { .target = EEP_REPLAY_DRIVER };
+    const EepReplay_Config_t *cfg = (config != NULL) ? config : &default_config;
+    EepReplay_Stats_t local;
+    EepTrace_FileHeader_t header;
+    Std_ReturnType ret = E_OK;
+
+    if (stats == NULL) {
+        stats = &local;
+    }
+    memset(stats, 0, sizeof(*stats));
+
+    if (path == NULL) {
+        return E_NOT_OK;
+    }
+
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        LOG_ERROR("EepReplay: Cannot open %s", path);
+        return E_NOT_OK;
+    }
+
+    if (fread(&header, sizeof(header), 1, file) != 1U || header.magic != EEP_TRACE_MAGIC ||
+        header.version != EEP_TRACE_VERSION || header.record_size != sizeof(EepTrace_Record_t)) {
+        LOG_ERROR("EepReplay: %s is not a version %u trace", path, EEP_TRACE_VERSION);
+        fclose(file);
+        return E_NOT_OK;
+    }
+
+    const Eeprom_ConfigType *eep = Eep_GetConfig();
+    if (cfg->target == EEP_REPLAY_DRIVER && eep != NULL &&
+        (eep->capacity_bytes != header.capacity_bytes || eep->page_size != header.page_size ||
+         eep->block_size != header.block_size)) {
+        LOG_WARN("EepReplay: Captured geometry %u/%u/%u differs from the driver's %u/%u/%u",
+                 header.capacity_bytes, header.page_size, header.block_size,
+                 eep->capacity_bytes, eep->page_size, eep->block_size);
+    }
+
+    EepTrace_Record_t *records = malloc(EEP_TRACE_DEFAULT_BUFFER * sizeof(EepTrace_Record_t));
+    uint8_t *scratch = NULL;
+    uint8_t *pattern = NULL;
+    uint32_t scratch_size = 0;
+    uint32_t pattern_size = 0;
+    uint32_t first_ms = 0;
+    uint32_t last_ms = 0;
+    uint32_t base_ms = OsScheduler_GetVirtualTimeMs();
+
+    if (records == NULL) {
+        fclose(file);
+        return E_NOT_OK;
+    }
+
+    uint64_t start_ns = host_now_ns();
+    size_t n;
+    while ((n = fread(records, sizeof(EepTrace_Record_t), EEP_TRACE_DEFAULT_BUFFER, file)) > 0U) {
+        for (size_t i = 0; i < n; i++) {
+            const EepTrace_Record_t *rec = &records[i];
+
+            if (rec->op >= EEP_OP_COUNT) {
+                ret = E_NOT_OK;
+                break;
+            }
+            if (rec->op == EEP_OP_READ) {
+                scratch = reserve_buffer(scratch, &scratch_size, rec->length, FALSE);
+            } else if (rec->op == EEP_OP_WRITE || rec->op == EEP_OP_VERIFY) {
+                pattern = reserve_buffer(pattern, &pattern_size, rec->length, TRUE);
+            }
+            if ((rec->op == EEP_OP_READ && scratch == NULL) ||
+                ((rec->op == EEP_OP_WRITE || rec->op == EEP_OP_VERIFY) && pattern == NULL)) {
+                ret = E_NOT_OK;
+                break;
+            }
+
+            if (stats->records == 0U) {
+                first_ms = rec->virtual_ms;
+            }
+            last_ms = rec->virtual_ms;
+            if (cfg->timed) {
+                pace(cfg, rec->virtual_ms - first_ms, base_ms, start_ns);
+            }
+
+            Std_ReturnType result = replay_one(cfg, rec, scratch, pattern);
+
+            stats->records++;
+            stats->op_count[rec->op]++;
+            if (result != E_OK) {
+                stats->failed++;
+            } else if (rec->op != EEP_OP_ERASE) {
+                stats->bytes += rec->length;
+            }
+            if (result != (Std_ReturnType)rec->result) {
+                stats->result_mismatches++;
+            }
+        }
+        if (ret != E_OK) {
+            break;
+        }
+    }
+
+    /* A partial record means the capture was cut short */
+    if (ret == E_OK && (ferror(file) || ftell(file) != (long)(sizeof(header) +
+                        stats->records * sizeof(EepTrace_Record_t)))) {
+        LOG_WARN("EepReplay: %s is truncated or unreadable", path);
+        ret = E_NOT_OK;
+    }
+
+    stats->elapsed_ns = host_now_ns() - start_ns;
+    stats->captured_span_ms = last_ms - first_ms;
+
+    free(scratch);
+    free(pattern);
+    free(records);
+    fclose(file);
+
+    LOG_INFO("EepReplay: %u records, %u failed, %u result mismatches",
+             stats->records, stats->failed, stats->result_mismatches);
+    return ret;
+}
@@ -0,0 +1,623 @@
+/**
+ * @file memif_wearlevel.c
+ * @brief Dynamic wear leveling of EEPROM erase blocks
+ *
+ * REQ-MemIf抽象层: design/02-NvM架构设计.md §1.1
+ * - 逻辑槽 -> 物理擦除块映射, 备用块参与轮换
+ * - 擦除逻辑槽时, 若其物理块比最少磨损的备用块多擦除 threshold 次, 则改用该备用块
+ * - 映射表记录 (magic + seq + map + CRC-32) 追加写入两个乒乓元数据块
+ * - 擦除计数直方图
+ * - 加速老化: 按事件 (每次重映射一步) 回放均衡策略, 不逐次擦除
+ */
+
+#include "memif.h"
+#include "memif_internal.h"
+#include "eeprom_driver.h"
+#include "crc.h"
+#include "logging.h"
+#include "sim_context.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Metadata record: magic LE16, seq LE32, logical, spare, map[logical], CRC-32 LE32
+ */
+#define MEMIF_WL_MAGIC        0x4C57U
+#define MEMIF_WL_HEADER_SIZE  8U
+#define MEMIF_WL_CRC_SIZE     4U
+
+/**
+ * @brief Largest page buffered for metadata access
+ */
+#define MEMIF_WL_PAGE_MAX     1024U
+
+/**
+ * @brief Wear leveling state of one MemIf context
+ */
+struct MemIf_WearLevelState {
+    boolean enabled;
+    MemIf_WearLevelConfig_t cfg;
+    uint32_t slot_size;                 /**< EEPROM erase block size */
+    uint32_t page_size;                 /**< EEPROM program unit */
+    uint8_t map[MEMIF_WL_MAX_SLOTS];    /**< Logical slot -> physical slot */
+    uint8_t meta_slot;                  /**< Metadata block holding the newest record */
+    uint32_t meta_page;                 /**< Next page to program in meta_slot */
+    uint32_t seq;                       /**< Sequence number of the newest record */
+    MemIf_WearLevelStats_t stats;
+    uint8_t page[MEMIF_WL_PAGE_MAX];    /**< Metadata page buffer */
+};
+
+/**
+ * @brief State used while no context is bound
+ */
+static struct MemIf_WearLevelState g_default_state;
+
+static struct MemIf_WearLevelState* wl_state(void)
+{
+    MemIf_Context_t *ctx = (MemIf_Context_t *)SimContext_Get(SIM_CONTEXT_MEMIF);
+
+    return (ctx != NULL) ? ctx->wl : &g_default_state;
+}
+
+static uint32_t physical_slots(void)
+{
+    struct MemIf_WearLevelState *wl = wl_state();
+
+    return (uint32_t)wl->cfg.logical_slots + wl->cfg.spare_slots;
+}
+
+static uint32_t slot_address(uint32_t slot)
+{
+    struct MemIf_WearLevelState *wl = wl_state();
+
+    return wl->cfg.base_address + slot * wl->slot_size;
+}
+
+static uint32_t meta_address(uint8_t meta_slot, uint32_t page)
+{
+    struct MemIf_WearLevelState *wl = wl_state();
+
+    return slot_address(physical_slots() + meta_slot) + page * wl->page_size;
+}
+
+static uint32_t pages_per_slot(void)
+{
+    struct MemIf_WearLevelState *wl = wl_state();
+
+    return wl->slot_size / wl->page_size;
+}
+
+static uint32_t slot_wear(uint32_t slot)
+{
+    uint32_t count = 0;
+
+    (void)Eep_GetEraseCount(slot_address(slot), &count);
+    return count;
+}
+
+static void store_le(uint8_t *dst, uint32_t value, uint32_t bytes)
+{
+    for (uint32_t i = 0; i < bytes; i++) {
+        dst[i] = (uint8_t)(value >> (8U * i));
+    }
+}
+
+static uint32_t load_le(const uint8_t *src, uint32_t bytes)
+{
+    uint32_t value = 0;
+
+    for (uint32_t i = 0; i < bytes; i++) {
+        value |= (uint32_t)src[i] << (8U * i);
+    }
+    return value;
+}
+
+/**
+ * @brief Decode a metadata page
+ *
+ * @return TRUE if it holds a valid record for the configured range
+ */
+static boolean decode_record(const uint8_t *page, uint32_t *seq, uint8_t *map)
+{
+    struct MemIf_WearLevelState *wl = wl_state();
+    uint32_t logical = wl->cfg.logical_slots;
+    uint32_t crc_at = MEMIF_WL_HEADER_SIZE + logical;
+    uint8_t seen[MEMIF_WL_MAX_SLOTS];
+
+    if (load_le(&page[0], 2) != MEMIF_WL_MAGIC ||
+        page[6] != wl->cfg.logical_slots || page[7] != wl->cfg.spare_slots ||
+        load_le(&page[crc_at], MEMIF_WL_CRC_SIZE) != CRC_CalculateCRC32(page, crc_at)) {
+        return FALSE;
+    }
+
+    /* A map must be a permutation into the physical slots */
+    memset(seen, 0, sizeof(seen));
+    for (uint32_t i = 0; i < logical; i++) {
+        uint8_t slot = page[MEMIF_WL_HEADER_SIZE + i];
+        if (slot >= physical_slots() || seen[slot] != 0U) {
+            return FALSE;
+        }
+        seen[slot] = 1U;
+    }
+
+    *seq = load_le(&page[2], 4);
+    memcpy(map, &page[MEMIF_WL_HEADER_SIZE], logical);
+    return TRUE;
+}
+
+/**
+ * @brief Append the current map as a new record
+ *
+ * Records are appended page by page; when the current metadata block is
+ * full the other one is erased and continued. The newest record always
+ * survives that erase, so a power loss at any point leaves a valid map.
+ */
+static Std_ReturnType persist_map(void)
+{
+    struct MemIf_WearLevelState *wl = wl_state();
+    uint32_t logical = wl->cfg.logical_slots;
+    uint32_t crc_at = MEMIF_WL_HEADER_SIZE + logical;
+    uint32_t pages = pages_per_slot();
+
+    memset(wl->page, 0xFF, wl->page_size);
+    store_le(&wl->page[0], MEMIF_WL_MAGIC, 2);
+    store_le(&wl->page[2], wl->seq + 1U, 4);
+    wl->page[6] = wl->cfg.logical_slots;
+    wl->page[7] = wl->cfg.spare_slots;
+    memcpy(&wl->page[MEMIF_WL_HEADER_SIZE], wl->map, logical);
+    store_le(&wl->page[crc_at], CRC_CalculateCRC32(wl->page, crc_at), MEMIF_WL_CRC_SIZE);
+
+    /* Pages left in the current block, then a whole fresh block */
+    for (uint32_t attempt = 0; attempt <= 2U * pages; attempt++) {
+        if (wl->meta_page >= pages) {
+            uint8_t other = (uint8_t)(wl->meta_slot ^ 1U);
+            if (Eep_Erase(meta_address(other, 0)) != E_OK) {
+                LOG_ERROR("MemIf: WL - metadata erase failed at 0x%X", meta_address(other, 0));
+                return E_NOT_OK;
+            }
+            wl->stats.meta_erases++;
+            wl->meta_slot = other;
+            wl->meta_page = 0;
+        }
+
+        uint32_t address = meta_address(wl->meta_slot, wl->meta_page);
+        wl->meta_page++;
+
+        /* A torn or foreign page is not blank: skip it */
+        if (Eep_Write(address, wl->page, wl->page_size) == E_OK) {
+            wl->seq++;
+            wl->stats.meta_writes++;
+            return E_OK;
+        }
+    }
+
+    LOG_ERROR("MemIf: WL - no metadata page could be programmed");
+    return E_NOT_OK;
+}
+
+/**
+ * @brief Load the newest valid record of both metadata blocks
+ *
+ * @return TRUE if one was found
+ */
+static boolean scan_metadata(void)
+{
+    struct MemIf_WearLevelState *wl = wl_state();
+    boolean found = FALSE;
+    uint32_t pages = pages_per_slot();
+    uint8_t map[MEMIF_WL_MAX_SLOTS];
+
+    for (uint8_t m = 0; m < MEMIF_WL_META_SLOTS; m++) {
+        for (uint32_t p = 0; p < pages; p++) {
+            uint32_t seq;
+            if (Eep_Read(meta_address(m, p), wl->page, wl->page_size) != E_OK ||
+                !decode_record(wl->page, &seq, map)) {
+                continue;
+            }
+            if (!found || seq > wl->seq) {
+                found = TRUE;
+                wl->seq = seq;
+                memcpy(wl->map, map, wl->cfg.logical_slots);
+                wl->meta_slot = m;
+                wl->meta_page = p + 1U;
+            }
+        }
+    }
+
+    return found;
+}
+
+void MemIf_WL_Reset(void)
+{
+    memset(wl_state(), 0, sizeof(struct MemIf_WearLevelState));
+}
+
+Std_ReturnType MemIf_EnableWearLeveling(const MemIf_WearLevelConfig_t *config)
+{
+    struct MemIf_WearLevelState *wl = wl_state();
+    const Eeprom_ConfigType *eep = Eep_GetConfig();
+
+    MemIf_WL_Reset();
+
+    if (config == NULL || eep == NULL ||
+        config->logical_slots == 0U || config->spare_slots == 0U ||
+        ((uint32_t)config->logical_slots + config->spare_slots) > MEMIF_WL_MAX_SLOTS ||
+        eep->page_size > MEMIF_WL_PAGE_MAX ||
+        (MEMIF_WL_HEADER_SIZE + config->logical_slots + MEMIF_WL_CRC_SIZE) > eep->page_size ||
+        (config->base_address % eep->block_size) != 0U) {
+        LOG_ERROR("MemIf: WL - invalid configuration");
+        return E_NOT_OK;
+    }
+
+    uint64_t blocks = (uint64_t)config->logical_slots + config->spare_slots + MEMIF_WL_META_SLOTS;
+    if ((uint64_t)config->base_address + blocks * eep->block_size > eep->capacity_bytes) {
+        LOG_ERROR("MemIf: WL - range at 0x%X exceeds the EEPROM", config->base_address);
+        return E_NOT_OK;
+    }
+
+    wl->cfg = *config;
+    wl->slot_size = eep->block_size;
+    wl->page_size = eep->page_size;
+
+    if (!scan_metadata()) {
+        /* Fresh range: identity map, recorded into metadata block 0 */
+        for (uint32_t i = 0; i < config->logical_slots; i++) {
+            wl->map[i] = (uint8_t)i;
+        }
+        wl->seq = 0;
+        wl->meta_slot = 1;
+        wl->meta_page = pages_per_slot();
+        if (persist_map() != E_OK) {
+            MemIf_WL_Reset();
+            return E_NOT_OK;
+        }
+    }
+
+    wl->enabled = TRUE;
+    LOG_INFO("MemIf: WL enabled at 0x%X (%u logical + %u spare slots, seq %u)",
+             config->base_address, config->logical_slots, config->spare_slots, wl->seq);
+    return E_OK;
+}
+
+void MemIf_DisableWearLeveling(void)
+{
+    struct MemIf_WearLevelState *wl = wl_state();
+
+    wl->enabled = FALSE;
+}
+
+Std_ReturnType MemIf_GetWearLevelStats(MemIf_WearLevelStats_t *stats)
+{
+    struct MemIf_WearLevelState *wl = wl_state();
+
+    if (stats == NULL || !wl->enabled) {
+        return E_NOT_OK;
+    }
+
+    *stats = wl->stats;
+    return E_OK;
+}
+
+Std_ReturnType MemIf_WL_Map(uint32_t address, uint32_t length, uint32_t *physical, uint32_t *chunk)
+{
+    struct MemIf_WearLevelState *wl = wl_state();
+    uint32_t base = wl->cfg.base_address;
+    uint64_t end = (uint64_t)base + (physical_slots() + MEMIF_WL_META_SLOTS) * (uint64_t)wl->slot_size;
+
+    *physical = address;
+    *chunk = length;
+
+    if (!wl->enabled || address >= end) {
+        return E_OK;
+    }
+
+    if (address < base) {
+        if (length > base - address) {
+            *chunk = base - address;
+        }
+        return E_OK;
+    }
+
+    uint32_t slot = (address - base) / wl->slot_size;
+    uint32_t within = (address - base) % wl->slot_size;
+    if (slot >= wl->cfg.logical_slots) {
+        return E_NOT_OK;
+    }
+
+    *physical = slot_address(wl->map[slot]) + within;
+    if (length > wl->slot_size - within) {
+        *chunk = wl->slot_size - within;
+    }
+    return E_OK;
+}
+
+boolean MemIf_WL_Leveled(uint32_t address)
+{
+    struct MemIf_WearLevelState *wl = wl_state();
+
+    return (wl->enabled && address >= wl->cfg.base_address &&
+            (address - wl->cfg.base_address) / wl->slot_size < wl->cfg.logical_slots)
+           ? TRUE : FALSE;
+}
+
+Std_ReturnType MemIf_WL_Erase(uint32_t address)
+{
+    struct MemIf_WearLevelState *wl = wl_state();
+    uint32_t slot = (address - wl->cfg.base_address) / wl->slot_size;
+    uint8_t current = wl->map[slot];
+    uint8_t used[MEMIF_WL_MAX_SLOTS];
+    uint32_t spare = MEMIF_WL_MAX_SLOTS;
+    uint32_t spare_wear = 0;
+
+    memset(used, 0, sizeof(used));
+    for (uint32_t i = 0; i < wl->cfg.logical_slots; i++) {
+        used[wl->map[i]] = 1U;
+    }
+    for (uint32_t p = 0; p < physical_slots(); p++) {
+        uint32_t wear;
+        if (used[p] != 0U) {
+            continue;
+        }
+        wear = slot_wear(p);
+        if (spare == MEMIF_WL_MAX_SLOTS || wear < spare_wear) {
+            spare = p;
+            spare_wear = wear;
+        }
+    }
+
+    /* Erase the spare first, then switch the map: the old block keeps the data until then */
+    if (spare != MEMIF_WL_MAX_SLOTS && slot_wear(current) >= spare_wear + wl->cfg.threshold &&
+        Eep_Erase(slot_address(spare)) == E_OK) {
+        wl->map[slot] = (uint8_t)spare;
+        if (persist_map() == E_OK) {
+            wl->stats.remaps++;
+            LOG_DEBUG("MemIf: WL - slot %u moved from block %u to block %u",
+                      slot, (uint32_t)current, spare);
+            return E_OK;
+        }
+        wl->map[slot] = current;
+        LOG_WARN("MemIf: WL - map update failed, slot %u stays on block %u",
+                    slot, (uint32_t)current);
+    }
+
+    return Eep_Erase(slot_address(current));
+}
+
+uint32_t MemIf_WL_Slot(uint32_t address)
+{
+    struct MemIf_WearLevelState *wl = wl_state();
+
+    return (address - wl->cfg.base_address) / wl->slot_size;
+}
+
+/**
+ * @brief Least worn physical slot not mapped by a logical slot
+ */
+static uint32_t least_worn_spare(const uint8_t *map, const uint64_t *wear)
+{
+    struct MemIf_WearLevelState *wl = wl_state();
+    uint8_t used[MEMIF_WL_MAX_SLOTS];
+    uint32_t spare = MEMIF_WL_MAX_SLOTS;
+
+    memset(used, 0, sizeof(used));
+    for (uint32_t i = 0; i < wl->cfg.logical_slots; i++) {
+        used[map[i]] = 1U;
+    }
+    for (uint32_t p = 0; p < physical_slots(); p++) {
+        if (used[p] == 0U && (spare == MEMIF_WL_MAX_SLOTS || wear[p] < wear[spare])) {
+            spare = p;
+        }
+    }
+    return spare;
+}
+
+/**
+ * @brief Give moved slots their data back at their new block
+ *
+ * Every old block is read before any new block is erased: a slot may move
+ * onto the block another slot left. Each new block is erased once.
+ */
+static Std_ReturnType move_slots(const uint8_t *map)
+{
+    struct MemIf_WearLevelState *wl = wl_state();
+    uint32_t moved = 0;
+    uint8_t *image;
+
+    for (uint32_t i = 0; i < wl->cfg.logical_slots; i++) {
+        moved += (map[i] != wl->map[i]) ? 1U : 0U;
+    }
+    if (moved == 0U) {
+        return E_OK;
+    }
+
+    image = (uint8_t *)malloc((size_t)moved * wl->slot_size);
+    if (image == NULL) {
+        return E_NOT_OK;
+    }
+
+    Std_ReturnType ret = E_OK;
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < wl->cfg.logical_slots && ret == E_OK; i++) {
+        if (map[i] != wl->map[i]) {
+            ret = Eep_Read(slot_address(wl->map[i]), &image[n++ * wl->slot_size], wl->slot_size);
+        }
+    }
+
+    n = 0;
+    for (uint32_t i = 0; i < wl->cfg.logical_slots && ret == E_OK; i++) {
+        if (map[i] != wl->map[i]) {
+            ret = Eep_Erase(slot_address(map[i]));
+            if (ret == E_OK) {
+                ret = Eep_Write(slot_address(map[i]), &image[n++ * wl->slot_size], wl->slot_size);
+            }
+        }
+    }
+
+    free(image);
+    return ret;
+}
+
+Std_ReturnType MemIf_WL_Age(const uint32_t *erases, uint32_t *added, uint32_t *remaps)
+{
+    struct MemIf_WearLevelState *wl = wl_state();
+    uint32_t logical = wl->cfg.logical_slots;
+    uint64_t wear[MEMIF_WL_MAX_SLOTS + MEMIF_WL_META_SLOTS];
+    uint32_t before[MEMIF_WL_MAX_SLOTS + MEMIF_WL_META_SLOTS];
+    uint64_t done[MEMIF_WL_MAX_SLOTS];
+    uint64_t next[MEMIF_WL_MAX_SLOTS];
+    uint8_t map[MEMIF_WL_MAX_SLOTS];
+    uint32_t records = 0;
+
+    for (uint32_t p = 0; p < physical_slots() + MEMIF_WL_META_SLOTS; p++) {
+        before[p] = slot_wear(p);
+        wear[p] = before[p];
+    }
+    memcpy(map, wl->map, logical);
+    memset(done, 0, sizeof(done));
+
+    /* One step per remap: the slot whose remapping erase comes first in
+     * the period (erase k of E at time k / E) moves, the others catch up */
+    for (;;) {
+        uint32_t spare = least_worn_spare(map, wear);
+        uint32_t first = MEMIF_WL_MAX_SLOTS;
+
+        for (uint32_t i = 0; i < logical; i++) {
+            uint64_t w = wear[map[i]];
+            uint64_t limit = wear[spare] + wl->cfg.threshold;
+
+            next[i] = done[i] + ((w >= limit) ? 1U : limit - w + 1U);
+            if (next[i] > erases[i]) {
+                next[i] = 0;    /* No remap left in the period */
+                continue;
+            }
+            if (first == MEMIF_WL_MAX_SLOTS || next[i] * erases[first] < next[first] * erases[i]) {
+                first = i;
+            }
+        }
+        if (first == MEMIF_WL_MAX_SLOTS) {
+            break;
+        }
+
+        for (uint32_t i = 0; i < logical; i++) {
+            uint64_t target = (next[first] * erases[i]) / erases[first];
+            if (next[i] != 0U && target >= next[i]) {
+                target = next[i] - 1U;
+            }
+            if (target > done[i]) {
+                wear[map[i]] += target - done[i];
+                done[i] = target;
+            }
+        }
+
+        /* The remapping erase goes to the spare */
+        wear[spare]++;
+        map[first] = (uint8_t)spare;
+        done[first]++;
+        records++;
+    }
+
+    for (uint32_t i = 0; i < logical; i++) {
+        wear[map[i]] += erases[i] - done[i];
+    }
+
+    /* Metadata blocks: one page per record, the other block erased when one fills */
+    uint32_t meta_erases = 0;
+    uint32_t meta_page = wl->meta_page;
+    uint8_t meta_slot = wl->meta_slot;
+    for (uint32_t r = 1; r < records; r++) {
+        if (meta_page >= pages_per_slot()) {
+            meta_slot ^= 1U;
+            meta_page = 0;
+            wear[physical_slots() + meta_slot]++;
+            meta_erases++;
+        }
+        meta_page++;
+    }
+
+    /* Data first (needs erases the new counts could forbid), then wear */
+    if (move_slots(map) != E_OK) {
+        LOG_ERROR("MemIf: WL - aging could not move the slots");
+        return E_NOT_OK;
+    }
+    memcpy(wl->map, map, logical);
+
+    /* The moves already erased their new blocks once each */
+    for (uint32_t p = 0; p < physical_slots() + MEMIF_WL_META_SLOTS; p++) {
+        uint32_t now = slot_wear(p);
+        if (wear[p] > now) {
+            uint64_t delta = wear[p] - now;
+            (void)Eep_AddEraseCount(slot_address(p), (delta > UINT32_MAX) ? UINT32_MAX : (uint32_t)delta);
+        }
+        *added += slot_wear(p) - before[p];
+    }
+
+    if (records > 0U) {
+        wl->seq += records - 1U;
+        wl->stats.remaps += records;
+        wl->stats.meta_writes += records - 1U;
+        wl->stats.meta_erases += meta_erases;
+        if (persist_map() != E_OK) {
+            return E_NOT_OK;
+        }
+        *remaps += records;
+    }
+
+    LOG_INFO("MemIf: WL - aged %u slots, %u remaps", logical, records);
+    return E_OK;
+}
+
+Std_ReturnType MemIf_WearLevelTranslate(uint32_t address, uint32_t *physical)
+{
+    uint32_t chunk;
+
+    if (physical == NULL) {
+        return E_NOT_OK;
+    }
+
+    return MemIf_WL_Map(address, 1, physical, &chunk);
+}
+
+Std_ReturnType MemIf_GetWearHistogram(uint32_t bucket_width, MemIf_WearHistogram_t *histogram)
+{
+    const Eeprom_ConfigType *eep = Eep_GetConfig();
+
+    if (histogram == NULL || bucket_width == 0U || eep == NULL) {
+        return E_NOT_OK;
+    }
+
+    memset(histogram, 0, sizeof(*histogram));
+    histogram->bucket_width = bucket_width;
+    histogram->block_count = eep->capacity_bytes / eep->block_size;
+
+    for (uint32_t b = 0; b < histogram->block_count; b++) {
+        uint32_t count = 0;
+        uint32_t bucket;
+
+        (void)Eep_GetEraseCount(b * eep->block_size, &count);
+        bucket = count / bucket_width;
+        if (bucket >= MEMIF_WEAR_HISTOGRAM_BUCKETS) {
+            bucket = MEMIF_WEAR_HISTOGRAM_BUCKETS - 1U;
+        }
+        histogram->buckets[bucket]++;
+
+        if (b == 0U || count < histogram->min_erase_count) {
+            histogram->min_erase_count = count;
+        }
+        if (count > histogram->max_erase_count) {
+            histogram->max_erase_count = count;
+        }
+        histogram->total_erase_count += count;
+    }
+
+    return E_OK;
+}
+
+struct MemIf_WearLevelState* MemIf_WL_CreateState(void)
+{
+    return (struct MemIf_WearLevelState *)calloc(1, sizeof(struct MemIf_WearLevelState));
+}
+
+void MemIf_WL_DestroyState(struct MemIf_WearLevelState *state)
+{
+    free(state);
+}
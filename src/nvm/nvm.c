@@ -6,54 +6,295 @@
  * - 状态机实现
  * - Job处理
  * - Block管理
+ * - 跨核提交: 非NvM线程的请求经无锁提交环进入, MainFunction统一取出
+ * - 延时指标: 按作业类型与Block记录 (metrics.h)
+ * - 失败重试: 按退避策略搁置后重新入队 (nvm_retry.c)
+ * - ReadAll/WriteAll在Block边界让出: 队列中的Immediate作业先执行
+ * - 作业通知唤醒NvM_WaitJob等待者与eventfd (nvm_wait.c)
+ * - 设备通道: 不同MemIf设备上的单Block作业异步并行 (nvm_lanes.c)
  */
 
 #include "nvm.h"
+#include "nvm_internal.h"
 #include "nvm_jobqueue.h"
 #include "nvm_block_types.h"
+#include "ram_mirror_seqlock.h"
+#include "ram_mirror_rcu.h"
 #include "memif.h"
-#include "crc16.h"
+#include "eeprom_driver.h"
+#include "crc.h"
 #include "eeprom_layout.h"
 #include "os_scheduler.h"
+#include "fault_injection.h"
+#include "metrics.h"
+#include "timeline.h"
+#include "trace_probes.h"
 #include "logging.h"
+#include <pthread.h>
 #include <string.h>
 
 /**
- * @brief Maximum number of blocks
+ * @brief Resumable ReadAll/WriteAll progress
  */
-#define NVM_MAX_BLOCKS 16
+typedef struct {
+    boolean active;
+    NvM_JobType_t job_type;         /**< NVM_JOB_READ_ALL or NVM_JOB_WRITE_ALL */
+    uint8_t count;                  /**< Blocks registered when the pass started */
+    uint8_t next_index;             /**< Next position in order[] */
+    uint8_t order[NVM_MAX_BLOCKS];  /**< Registration slots by ascending offset */
+    Std_ReturnType result;          /**< Accumulated result */
+    boolean pipelined;              /**< ReadAll runs through nvm_readall.c */
+    uint32_t submit_time_ms;        /**< Submission of the ReadAll/WriteAll job */
+    uint64_t start_ns;              /**< Host time the pass started (0 = not timed) */
+} NvM_MultiBlockState_t;
+
+/**
+ * @brief Queued NvM_WriteBlocks group (referenced by the job's data_ptr)
+ */
+typedef struct {
+    boolean in_use;
+    uint8_t count;
+    NvM_BlockIdType ids[NVM_WRITE_BATCH_MAX_BLOCKS];
+    const void *bufs[NVM_WRITE_BATCH_MAX_BLOCKS];
+} NvM_WriteBatch_t;
 
 /**
  * @brief NvM instance structure
  */
 typedef struct {
-    NvM_BlockConfig_t blocks[NVM_MAX_BLOCKS];
-    uint8_t block_count;
     NvM_Diagnostics_t diagnostics;
+    boolean coalescing;
+    boolean readall_pipeline;
+    boolean pre_erase;
+    boolean device_overlap;         /**< Single-block jobs run on device lanes */
+    NvM_MainFunctionBudget_t budget;
+    NvM_MultiBlockState_t multi;
+    NvM_WriteBatch_t batches[NVM_WRITE_BATCH_QUEUE_SIZE];
+    pthread_t owner_thread;         /**< Thread that owns the job queue (NvM_Init caller) */
     boolean initialized;
+
+    /**
+     * Job result storage (indexed by block ID, not registration slot).
+     * Written by other threads for ring submissions: accessed atomically.
+     */
+    uint8_t job_results[NVM_BLOCK_ID_COUNT];
+
+    /**
+     * Jobs dropped by the last timeout check (one queue's worth, so a
+     * single check reports them all)
+     */
+    NvM_Job_t timed_out[NVM_JOB_QUEUE_SIZE];
 } NvM_Instance_t;
 
 /**
- * @brief Global NvM instance
+ * @brief NvM instance used while no context is bound
+ */
+static NvM_Instance_t g_default_state = {0};
+
+static NvM_Instance_t* instance(void)
+{
+    return (NvM_Instance_t *)NvM_PartState(NVM_PART_CORE);
+}
+
+static void set_job_result(uint8_t block_id, uint8_t result)
+{
+    NvM_Instance_t *inst = instance();
+
+    __atomic_store_n(&inst->job_results[block_id], result, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief TRUE on the thread that may touch the job queue directly
  */
-static NvM_Instance_t g_nvm = {0};
+static boolean on_nvm_thread(void)
+{
+    NvM_Instance_t *inst = instance();
+
+    return pthread_equal(pthread_self(), inst->owner_thread) ? TRUE : FALSE;
+}
+
+boolean NvM_IsNvmThread(void)
+{
+    return on_nvm_thread();
+}
+
+/**
+ * @brief Queue a single-block or ReadAll/WriteAll job
+ *
+ * On the NvM thread the job goes straight into the priority queue; from
+ * any other thread it goes through the submission ring, and the result
+ * reads PENDING before the job becomes visible to NvM_MainFunction.
+ */
+static Std_ReturnType submit_job(const NvM_Job_t *job)
+{
+    NvM_Instance_t *inst = instance();
+
+    if (on_nvm_thread()) {
+        Std_ReturnType ret = NvM_JobQueue_Enqueue(job);
+        if (ret == E_OK && job->block_id != 0xFF) {
+            set_job_result(job->block_id, NVM_REQ_PENDING);
+        }
+        return ret;
+    }
+
+    uint8_t previous = 0;
+    if (job->block_id != 0xFF) {
+        previous = __atomic_exchange_n(&inst->job_results[job->block_id], NVM_REQ_PENDING,
+                                       __ATOMIC_ACQ_REL);
+    }
+
+    Std_ReturnType ret = NvM_Submit_Push(job);
+    if (ret != E_OK && job->block_id != 0xFF) {
+        /* Nothing was queued: put the earlier result back */
+        uint8_t expected = NVM_REQ_PENDING;
+        (void)__atomic_compare_exchange_n(&inst->job_results[job->block_id], &expected, previous,
+                                          FALSE, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+    }
+    return ret;
+}
 
 /**
- * @brief Job result storage
+ * @brief Move ring submissions into the priority queue (NvM thread)
+ *
+ * Jobs stay in the ring while the queue is full. The timeout budget
+ * starts here, on the NvM core's clock.
  */
-static uint8_t g_job_results[NVM_MAX_BLOCKS] = {0};
+static void drain_submissions(void)
+{
+    NvM_Job_t job;
+
+    while (!NvM_JobQueue_IsFull() && NvM_Submit_Pop(&job) == E_OK) {
+        job.submit_time_ms = OsScheduler_GetVirtualTimeMs();
+        if (NvM_JobQueue_Enqueue(&job) != E_OK) {
+            LOG_ERROR("NvM: Submitted job for block %d could not be queued", job.block_id);
+            if (job.block_id != 0xFF) {
+                set_job_result(job.block_id, NVM_REQ_NOT_OK);
+            }
+            NvM_JobErrorNotification(job.block_id);
+        }
+    }
+}
 
 /**
  * @brief Find block configuration by ID
  */
 static NvM_BlockConfig_t* find_block(uint8_t block_id)
 {
-    for (uint8_t i = 0; i < g_nvm.block_count; i++) {
-        if (g_nvm.blocks[i].block_id == block_id) {
-            return &g_nvm.blocks[i];
-        }
+    return NvM_Registry_Find(block_id);
+}
+
+/**
+ * @brief Current contents of a block: its ROM default while bound, else the RAM mirror
+ */
+static const void* block_data(const NvM_BlockConfig_t *block)
+{
+    return block->rom_bound ? (const void *)block->rom_block_ptr : block->ram_mirror_ptr;
+}
+
+/**
+ * @brief Hash used for dirty detection (independent of the block's CRC type)
+ */
+static uint32_t mirror_hash(const NvM_BlockConfig_t *block, const void *data)
+{
+    return CRC_CalculateCRC32((const uint8_t *)data, block->block_size);
+}
+
+/**
+ * @brief Record that the device copy of a block now equals data
+ */
+static void mark_persisted(NvM_BlockConfig_t *block, const void *data)
+{
+    if (data == NULL) {
+        return;
     }
-    return NULL;
+
+    block->persisted_crc = mirror_hash(block, data);
+    block->persisted_generation = RamMirror_GetGeneration(block->block_id);
+    block->persisted_valid = TRUE;
+    block->mirror_clean = (data == block_data(block)) ? TRUE : FALSE;
+}
+
+/**
+ * @brief Check whether a block's RAM mirror differs from its device copy
+ *
+ * A new mirror generation proves a write without hashing; otherwise the
+ * mirror is hashed, which also catches direct stores to ram_mirror_ptr.
+ */
+static boolean block_is_dirty(const NvM_BlockConfig_t *block)
+{
+    if (!block->persisted_valid || block->ram_mirror_ptr == NULL) {
+        return TRUE;
+    }
+    if (RamMirror_GetGeneration(block->block_id) != block->persisted_generation) {
+        return TRUE;
+    }
+
+    return (mirror_hash(block, block_data(block)) != block->persisted_crc) ? TRUE : FALSE;
+}
+
+/**
+ * @brief Check whether a read_cache block's ReadBlock can complete from its RAM mirror
+ *
+ * Flag and generation checks only: a hit costs no pass over the data.
+ * Stores through NvM_GetWritableBlockData clear mirror_clean.
+ */
+static boolean read_cache_hit(const NvM_BlockConfig_t *block)
+{
+    if (block->state != NVM_BLOCKSTATE_VALID || !block->persisted_valid || !block->mirror_clean ||
+        RamMirror_GetGeneration(block->block_id) != block->persisted_generation) {
+        return FALSE;
+    }
+
+    /* A queued write changes the device copy before or after this read */
+    return (NvM_JobQueue_FindPendingWrite(block->block_id) == NULL) ? TRUE : FALSE;
+}
+
+/**
+ * @brief Block bookkeeping before a read
+ */
+static void read_prepare(NvM_BlockConfig_t *block, const NvM_Job_t *job)
+{
+    /* A read into the mirror replaces a ROM default binding (or binds again) */
+    if (job->data_ptr == block->ram_mirror_ptr) {
+        block->rom_bound = FALSE;
+    }
+}
+
+/**
+ * @brief Block bookkeeping after a read
+ */
+static void read_finish(NvM_BlockConfig_t *block, const NvM_Job_t *job, Std_ReturnType ret)
+{
+    if (ret == E_OK && job->data_ptr == block->ram_mirror_ptr) {
+        mark_persisted(block, job->data_ptr);
+    } else if (ret != E_OK) {
+        /* Whatever the device holds now, it is not known to match the mirror */
+        block->persisted_valid = FALSE;
+    }
+    NvM_Registry_SyncState(block);
+}
+
+/**
+ * @brief Block bookkeeping before a write
+ */
+static void write_prepare(NvM_BlockConfig_t *block)
+{
+    /* Device copy is unknown until the write succeeds */
+    block->persisted_valid = FALSE;
+    if (block->block_type != NVM_BLOCK_LOG) {
+        NvM_Checkpoint_Invalidate();
+    }
+}
+
+/**
+ * @brief Block bookkeeping after a write
+ */
+static void write_finish(NvM_BlockConfig_t *block, const NvM_Job_t *job, Std_ReturnType ret)
+{
+    if (ret == E_OK) {
+        mark_persisted(block, job->data_ptr);
+    }
+    NvM_Registry_SyncState(block);
 }
 
 /**
@@ -69,23 +310,35 @@ static Std_ReturnType process_read_block(const NvM_Job_t *job)
 
     LOG_DEBUG("NvM: Reading block %d (size=%u, type=%d)",
               block->block_id, block->block_size, block->block_type);
+    read_prepare(block, job);
 
     /* Use block-type-specific read handlers */
+    Std_ReturnType ret;
     switch (block->block_type) {
         case NVM_BLOCK_NATIVE:
-            return NvM_ReadNativeBlock(block, job->data_ptr);
+            ret = NvM_ReadNativeBlock(block, job->data_ptr);
+            break;
 
         case NVM_BLOCK_REDUNDANT:
-            return NvM_ReadRedundantBlock(block, job->data_ptr);
+            ret = NvM_ReadRedundantBlock(block, job->data_ptr);
+            break;
 
         case NVM_BLOCK_DATASET:
-            return NvM_ReadDatasetBlock(block, job->data_ptr);
+            ret = NvM_ReadDatasetBlock(block, job->data_ptr);
+            break;
+
+        case NVM_BLOCK_LOG:
+            ret = NvM_ReadLogBlock(block, job->data_ptr);
+            break;
 
         default:
             LOG_ERROR("NvM: Unknown block type %d for block %d",
                      block->block_type, block->block_id);
             return E_NOT_OK;
     }
+
+    read_finish(block, job, ret);
+    return ret;
 }
 
 /**
@@ -106,81 +359,635 @@ static Std_ReturnType process_write_block(const NvM_Job_t *job)
 
     LOG_DEBUG("NvM: Writing block %d (size=%u, type=%d)",
               block->block_id, block->block_size, block->block_type);
+    write_prepare(block);
 
     /* Use block-type-specific write handlers */
+    Std_ReturnType ret;
     switch (block->block_type) {
         case NVM_BLOCK_NATIVE:
-            return NvM_WriteNativeBlock(block, job->data_ptr);
+            ret = NvM_WriteNativeBlock(block, job->data_ptr);
+            break;
 
         case NVM_BLOCK_REDUNDANT:
-            return NvM_WriteRedundantBlock(block, job->data_ptr);
+            ret = NvM_WriteRedundantBlock(block, job->data_ptr);
+            break;
 
         case NVM_BLOCK_DATASET:
-            return NvM_WriteDatasetBlock(block, job->data_ptr);
+            ret = NvM_WriteDatasetBlock(block, job->data_ptr);
+            break;
+
+        case NVM_BLOCK_LOG:
+            ret = NvM_WriteLogBlock(block, job->data_ptr);
+            break;
 
         default:
             LOG_ERROR("NvM: Unknown block type %d for block %d",
                      block->block_type, block->block_id);
             return E_NOT_OK;
     }
+
+    write_finish(block, job, ret);
+    return ret;
 }
 
 /**
- * @brief Process ReadAll job
+ * @brief Process WriteBatch job: one commit, then a result per block
  */
-static Std_ReturnType process_read_all(void)
+static void process_write_batch(const NvM_Job_t *job)
 {
-    LOG_INFO("NvM: ReadAll - reading all blocks");
-
+    NvM_Instance_t *inst = instance();
+    NvM_WriteBatch_t *batch = (NvM_WriteBatch_t *)job->data_ptr;
+    NvM_BlockConfig_t *blocks[NVM_WRITE_BATCH_MAX_BLOCKS];
+    uint8_t was_persisted[NVM_WRITE_BATCH_MAX_BLOCKS];
     Std_ReturnType ret = E_OK;
-    for (uint8_t i = 0; i < g_nvm.block_count; i++) {
-        NvM_BlockConfig_t *block = &g_nvm.blocks[i];
-
-        NvM_Job_t job = {
-            .job_type = NVM_JOB_READ,
-            .block_id = block->block_id,
-            .data_ptr = block->ram_mirror_ptr,
-            .priority = 0
-        };
+    boolean restored = TRUE;
 
-        if (process_read_block(&job) != E_OK) {
-            LOG_WARN("NvM: ReadAll - block %d failed", block->block_id);
+    /* Blocks may have changed between NvM_WriteBlocks and now */
+    for (uint8_t i = 0; i < batch->count; i++) {
+        blocks[i] = find_block(batch->ids[i]);
+        if (blocks[i] == NULL || blocks[i]->is_write_protected) {
+            LOG_WARN("NvM: Batch - block %d missing or write-protected", batch->ids[i]);
             ret = E_NOT_OK;
         }
     }
 
-    return ret;
+    LOG_DEBUG("NvM: Writing batch of %u blocks", batch->count);
+
+    if (ret == E_OK) {
+        for (uint8_t i = 0; i < batch->count; i++) {
+            was_persisted[i] = blocks[i]->persisted_valid;
+            blocks[i]->persisted_valid = FALSE;
+        }
+        NvM_Checkpoint_Invalidate();
+
+        ret = NvM_WriteBatch_Execute(blocks, batch->bufs, batch->count, &restored);
+
+        for (uint8_t i = 0; i < batch->count; i++) {
+            if (ret == E_OK) {
+                mark_persisted(blocks[i], batch->bufs[i]);
+            } else if (restored) {
+                blocks[i]->persisted_valid = was_persisted[i];
+            }
+            NvM_Registry_SyncState(blocks[i]);
+        }
+
+        if (ret != E_OK) {
+            inst->diagnostics.batch_rollbacks++;
+        }
+    }
+
+    for (uint8_t i = 0; i < batch->count; i++) {
+        set_job_result(batch->ids[i], (ret == E_OK) ? NVM_REQ_OK : NVM_REQ_NOT_OK);
+    }
+
+    inst->diagnostics.total_jobs_processed++;
+    if (ret != E_OK) {
+        inst->diagnostics.total_jobs_failed++;
+    }
+
+    for (uint8_t i = 0; i < batch->count; i++) {
+        if (ret == E_OK) {
+            NvM_JobEndNotification(batch->ids[i]);
+        } else {
+            NvM_JobErrorNotification(batch->ids[i]);
+        }
+    }
+
+    batch->in_use = FALSE;
 }
 
 /**
- * @brief Process WriteAll job
+ * @brief Device work accounting for one MainFunction call
  */
-static Std_ReturnType process_write_all(void)
+typedef struct {
+    Eeprom_DiagInfoType start;      /**< Driver counters at call entry */
+    uint64_t start_busy_us;         /**< Driver timing model busy time at call entry */
+    uint32_t bytes;                 /**< Bytes read + written so far */
+    uint32_t cost_us;               /**< Modelled device time so far */
+} NvM_WorkMeter_t;
+
+static void meter_start(NvM_WorkMeter_t *meter)
 {
-    LOG_INFO("NvM: WriteAll - writing all blocks");
+    Eep_TimingStats_t timing;
 
-    Std_ReturnType ret = E_OK;
-    for (uint8_t i = 0; i < g_nvm.block_count; i++) {
-        NvM_BlockConfig_t *block = &g_nvm.blocks[i];
+    memset(meter, 0, sizeof(NvM_WorkMeter_t));
+    (void)Eep_GetDiagnostics(&meter->start);
+    if (Eep_GetTimingStats(&timing) == E_OK) {
+        meter->start_busy_us = timing.total_busy_us;
+    }
+}
 
-        if (block->is_write_protected) {
-            continue;
+/**
+ * @brief Recompute the meter from the driver counters
+ *
+ * Cost uses the device timing model: read_delay_us per byte,
+ * write_delay_ms per page, erase_delay_ms per block. With driver timing
+ * on it is the latency the driver actually drew.
+ */
+static void meter_update(NvM_WorkMeter_t *meter)
+{
+    Eeprom_DiagInfoType now;
+    const Eeprom_ConfigType *eep = Eep_GetConfig();
+
+    if (eep == NULL || eep->page_size == 0U || Eep_GetDiagnostics(&now) != E_OK) {
+        return;
+    }
+
+    uint32_t read = now.total_bytes_read - meter->start.total_bytes_read;
+    uint32_t written = now.total_bytes_written - meter->start.total_bytes_written;
+    uint32_t erases = now.total_erase_count - meter->start.total_erase_count;
+    uint64_t cost = (uint64_t)read * eep->read_delay_us +
+                    (uint64_t)((written + eep->page_size - 1U) / eep->page_size) *
+                        eep->write_delay_ms * 1000U +
+                    (uint64_t)erases * eep->erase_delay_ms * 1000U;
+
+    Eep_TimingStats_t timing;
+    if (Eep_GetTimingMode() != EEP_TIMING_OFF && Eep_GetTimingStats(&timing) == E_OK) {
+        cost = timing.total_busy_us - meter->start_busy_us;
+    }
+
+    meter->bytes = read + written;
+    meter->cost_us = (cost > 0xFFFFFFFFU) ? 0xFFFFFFFFU : (uint32_t)cost;
+}
+
+static boolean meter_exhausted(const NvM_WorkMeter_t *meter)
+{
+    NvM_Instance_t *inst = instance();
+    const NvM_MainFunctionBudget_t *budget = &inst->budget;
+
+    if (budget->max_bytes != 0U && meter->bytes >= budget->max_bytes) {
+        return TRUE;
+    }
+    if (budget->max_cost_us != 0U && meter->cost_us >= budget->max_cost_us) {
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Record a finished job's latency
+ *
+ * Host time counts from dequeue, virtual time from submission.
+ *
+ * @param start_ns Host time at dequeue (0 = metrics were off then)
+ * @param immediate Also record the job in the immediate latency series
+ */
+static void record_job_metrics(NvM_JobType_t job_type, uint8_t block_id, uint32_t submit_time_ms,
+                               uint64_t start_ns, boolean immediate)
+{
+    static const Metrics_SeriesId_t series[] = {
+        [NVM_JOB_READ] = METRIC_NVM_READ,
+        [NVM_JOB_WRITE] = METRIC_NVM_WRITE,
+        [NVM_JOB_READ_ALL] = METRIC_NVM_READ_ALL,
+        [NVM_JOB_WRITE_ALL] = METRIC_NVM_WRITE_ALL,
+        [NVM_JOB_WRITE_BATCH] = METRIC_NVM_WRITE_BATCH
+    };
+
+    if (!METRICS_ENABLED() || start_ns == 0U || (uint32_t)job_type >= sizeof(series) / sizeof(series[0])) {
+        return;
+    }
+
+    uint64_t host_ns = Metrics_HostNs() - start_ns;
+    uint64_t virtual_us = (uint64_t)(OsScheduler_GetVirtualTimeMs() - submit_time_ms) * 1000U;
+
+    Metrics_Record(series[job_type], host_ns, virtual_us);
+    if (immediate) {
+        Metrics_Record(METRIC_NVM_IMMEDIATE, host_ns, virtual_us);
+    }
+    if (job_type == NVM_JOB_READ) {
+        Metrics_RecordBlock(block_id, METRIC_BLOCK_READ, host_ns, virtual_us);
+    } else if (job_type == NVM_JOB_WRITE) {
+        Metrics_RecordBlock(block_id, METRIC_BLOCK_WRITE, host_ns, virtual_us);
+    }
+}
+
+/**
+ * @brief Record a finished job: result, diagnostics, notification
+ */
+static void complete_job(uint8_t block_id, Std_ReturnType ret)
+{
+    NvM_Instance_t *inst = instance();
+
+    if (block_id != 0xFF) {
+        set_job_result(block_id, (ret == E_OK) ? NVM_REQ_OK : NVM_REQ_NOT_OK);
+    }
+
+    inst->diagnostics.total_jobs_processed++;
+    if (ret != E_OK) {
+        inst->diagnostics.total_jobs_failed++;
+    }
+
+    if (ret == E_OK) {
+        NvM_JobEndNotification(block_id);
+    } else {
+        NvM_JobErrorNotification(block_id);
+    }
+}
+
+/**
+ * @brief Complete the jobs dropped after their last timeout retry
+ *
+ * Waiters, the completion eventfd and shared-memory clients are woken as
+ * for a job that ran and failed.
+ */
+static void fail_timed_out_jobs(uint32_t current_time)
+{
+    NvM_Instance_t *inst = instance();
+    uint32_t n;
+
+    do {
+        n = NvM_JobQueue_CheckTimeouts(current_time, inst->timed_out, NVM_JOB_QUEUE_SIZE);
+        for (uint32_t i = 0; i < n; i++) {
+            complete_job(inst->timed_out[i].block_id, E_NOT_OK);
+        }
+    } while (n == NVM_JOB_QUEUE_SIZE);
+}
+
+/**
+ * @brief Complete a single-block job, or set it aside for a retry
+ */
+static void settle_job(const NvM_Job_t *job, Std_ReturnType ret, uint64_t start_ns)
+{
+    /* Set aside for a later attempt: other jobs run meanwhile, result stays pending */
+    if (ret != E_OK && NvM_Retry_Defer(job, OsScheduler_GetVirtualTimeMs())) {
+        return;
+    }
+
+    complete_job(job->block_id, ret);
+    record_job_metrics(job->job_type, job->block_id, job->submit_time_ms, start_ns,
+                       job->is_immediate);
+}
+
+/**
+ * @brief Run one single-block or NvM_WriteBlocks job to completion
+ */
+static void run_job(const NvM_Job_t *job, NvM_WorkMeter_t *meter)
+{
+    Std_ReturnType ret = E_NOT_OK;
+    uint64_t start_ns = METRICS_ENABLED() ? Metrics_HostNs() : 0U;
+
+    /* Process job based on type */
+    switch (job->job_type) {
+        case NVM_JOB_READ:
+            ret = process_read_block(job);
+            break;
+
+        case NVM_JOB_WRITE:
+            /* This write supersedes a failed one still waiting for its retry */
+            NvM_Retry_Cancel(job->block_id);
+            ret = process_write_block(job);
+            break;
+
+        case NVM_JOB_WRITE_BATCH:
+            process_write_batch(job);
+            record_job_metrics(job->job_type, job->block_id, job->submit_time_ms, start_ns,
+                               job->is_immediate);
+            meter_update(meter);
+            return;
+
+        default:
+            LOG_ERROR("NvM: Unknown job type %d", job->job_type);
+            break;
+    }
+
+    settle_job(job, ret, start_ns);
+    meter_update(meter);
+}
+
+/**
+ * @brief Completion of a job run on a device lane
+ */
+static void lane_job_done(const NvM_Job_t *job, uint64_t start_ns, Std_ReturnType ret)
+{
+    NvM_BlockConfig_t *block = find_block(job->block_id);
+
+    if (block != NULL) {
+        if (job->job_type == NVM_JOB_WRITE) {
+            write_finish(block, job, ret);
+        } else {
+            read_finish(block, job, ret);
+        }
+    }
+
+    settle_job(job, ret, start_ns);
+}
+
+/**
+ * @brief Start a single-block job on its device's lane
+ *
+ * @return FALSE if the job has to run synchronously (run_job)
+ */
+static boolean start_on_lane(const NvM_Job_t *job)
+{
+    NvM_Instance_t *inst = instance();
+    NvM_BlockConfig_t *block;
+
+    if (job->job_type != NVM_JOB_READ && job->job_type != NVM_JOB_WRITE) {
+        return FALSE;
+    }
+
+    block = find_block(job->block_id);
+    if (block == NULL || !NvM_Lanes_Accepts(block) ||
+        (job->job_type == NVM_JOB_WRITE && block->is_write_protected)) {
+        return FALSE;
+    }
+
+    if (job->job_type == NVM_JOB_WRITE) {
+        NvM_Retry_Cancel(job->block_id);
+        write_prepare(block);
+    } else {
+        read_prepare(block, job);
+    }
+
+    inst->diagnostics.overlapped_jobs++;
+    NvM_Lanes_Start(job, block, METRICS_ENABLED() ? Metrics_HostNs() : 0U, lane_job_done);
+    return TRUE;
+}
+
+/**
+ * @brief Dequeue filter with device lanes on
+ *
+ * A job waits while a lane job is in flight on its device. ReadAll,
+ * WriteAll and write batches wait for every lane, and nothing behind
+ * them starts meanwhile.
+ */
+static boolean job_may_start(const NvM_Job_t *job, void *ctx)
+{
+    boolean *draining = (boolean *)ctx;
+
+    if (*draining) {
+        return FALSE;
+    }
+
+    if (job->job_type == NVM_JOB_READ || job->job_type == NVM_JOB_WRITE) {
+        const NvM_BlockConfig_t *block = find_block(job->block_id);
+        return (block == NULL || NvM_Lanes_DeviceIdle(block)) ? TRUE : FALSE;
+    }
+
+    if (!NvM_Lanes_Idle()) {
+        *draining = TRUE;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static Std_ReturnType dequeue_job(NvM_Job_t *job)
+{
+    NvM_Instance_t *inst = instance();
+    boolean draining = FALSE;
+
+    if (!inst->device_overlap) {
+        return NvM_JobQueue_Dequeue(job);
+    }
+
+    return NvM_JobQueue_DequeueIf(job_may_start, &draining, job);
+}
+
+/**
+ * @brief Let queued immediate jobs run at a ReadAll/WriteAll block boundary
+ *
+ * The pass waits at most for the block it is on; the immediate jobs share
+ * the call's budget with it.
+ */
+static void run_immediate_jobs(NvM_WorkMeter_t *meter)
+{
+    NvM_Instance_t *inst = instance();
+    NvM_Job_t job;
+
+    while (!meter_exhausted(meter) && NvM_JobQueue_DequeueImmediate(&job) == E_OK) {
+        LOG_DEBUG("NvM: Immediate job for block %d preempts %s", job.block_id,
+                  (inst->multi.job_type == NVM_JOB_READ_ALL) ? "ReadAll" : "WriteAll");
+        inst->diagnostics.multi_block_preemptions++;
+        run_job(&job, meter);
+    }
+}
+
+/**
+ * @brief Process ReadAll/WriteAll blocks until done or out of budget
+ *
+ * @return TRUE when every block has been handled
+ */
+static boolean multi_block_step(NvM_WorkMeter_t *meter)
+{
+    NvM_Instance_t *inst = instance();
+    NvM_MultiBlockState_t *multi = &inst->multi;
+
+    if (multi->pipelined) {
+        boolean done = NvM_ReadAllPipeline_Poll();
+        meter_update(meter);
+        if (!done) {
+            return FALSE;
+        }
+        multi->next_index = multi->count;
+    }
+
+    while (multi->next_index < multi->count) {
+        /* Block boundary: immediate jobs first */
+        run_immediate_jobs(meter);
+        if (meter_exhausted(meter)) {
+            return FALSE;
         }
 
+        NvM_BlockConfig_t *block = &NvM_Registry_Blocks()[multi->order[multi->next_index++]];
+        /* WriteAll of a bound block programs straight from its ROM default */
         NvM_Job_t job = {
-            .job_type = NVM_JOB_WRITE,
+            .job_type = (multi->job_type == NVM_JOB_READ_ALL) ? NVM_JOB_READ : NVM_JOB_WRITE,
             .block_id = block->block_id,
-            .data_ptr = block->ram_mirror_ptr,
+            .data_ptr = (multi->job_type == NVM_JOB_READ_ALL) ? block->ram_mirror_ptr
+                                                              : (void *)block_data(block),
             .priority = 0
         };
 
-        if (process_write_block(&job) != E_OK) {
-            LOG_WARN("NvM: WriteAll - block %d failed", block->block_id);
-            ret = E_NOT_OK;
+        if (multi->job_type == NVM_JOB_READ_ALL) {
+            uint32_t data_crc;
+            if (NvM_Checkpoint_ReadBlock(block, &data_crc)) {
+                /* The checkpoint vouches for the copy: no CRC pass over the data */
+                block->persisted_crc = data_crc;
+                block->persisted_generation = RamMirror_GetGeneration(block->block_id);
+                block->persisted_valid = TRUE;
+                block->mirror_clean = (job.data_ptr == block_data(block)) ? TRUE : FALSE;
+                NvM_Registry_SyncState(block);
+            } else if (process_read_block(&job) != E_OK) {
+                LOG_WARN("NvM: ReadAll - block %d failed", block->block_id);
+                multi->result = E_NOT_OK;
+            }
+        } else if (block->is_write_protected) {
+            continue;
+        } else if (!block_is_dirty(block)) {
+            LOG_DEBUG("NvM: WriteAll - block %d unchanged, skipped", block->block_id);
+            inst->diagnostics.writeall_skipped_blocks++;
+            continue;
+        } else {
+            if (process_write_block(&job) != E_OK) {
+                LOG_WARN("NvM: WriteAll - block %d failed", block->block_id);
+                multi->result = E_NOT_OK;
+            }
         }
+
+        meter_update(meter);
     }
 
-    return ret;
+    multi->active = FALSE;
+    if (multi->job_type == NVM_JOB_WRITE_ALL && multi->result == E_OK) {
+        (void)NvM_Checkpoint_Commit();
+    }
+    complete_job(0xFF, multi->result);
+    record_job_metrics(multi->job_type, 0xFF, multi->submit_time_ms, multi->start_ns, FALSE);
+    return TRUE;
+}
+
+/**
+ * @brief Per-block completion of a pipelined ReadAll
+ */
+static void readall_block_done(NvM_BlockConfig_t *block, Std_ReturnType result)
+{
+    NvM_Instance_t *inst = instance();
+
+    set_job_result(block->block_id, (result == E_OK) ? NVM_REQ_OK : NVM_REQ_NOT_OK);
+
+    NvM_Registry_SyncState(block);
+
+    if (result == E_OK) {
+        mark_persisted(block, block->ram_mirror_ptr);
+        NvM_JobEndNotification(block->block_id);
+    } else {
+        LOG_WARN("NvM: ReadAll - block %d failed", block->block_id);
+        inst->multi.result = E_NOT_OK;
+        NvM_JobErrorNotification(block->block_id);
+    }
+}
+
+/**
+ * @brief Start a ReadAll/WriteAll pass at the first block
+ */
+static void multi_block_start(NvM_JobType_t job_type)
+{
+    NvM_Instance_t *inst = instance();
+
+    LOG_INFO("NvM: %s - %s all blocks", (job_type == NVM_JOB_READ_ALL) ? "ReadAll" : "WriteAll",
+             (job_type == NVM_JOB_READ_ALL) ? "reading" : "writing");
+
+    inst->multi.active = TRUE;
+    inst->multi.job_type = job_type;
+    inst->multi.next_index = 0;
+    inst->multi.result = E_OK;
+
+    inst->multi.count = (uint8_t)NvM_Registry_Count();
+
+    /* Every mirror is read again: bindings are decided afresh */
+    if (job_type == NVM_JOB_READ_ALL) {
+        for (uint8_t i = 0; i < inst->multi.count; i++) {
+            NvM_Registry_Blocks()[i].rom_bound = FALSE;
+        }
+    }
+
+    /* Ascending offset: sequential device access, each erase unit visited once */
+    for (uint8_t i = 0; i < inst->multi.count; i++) {
+        uint32_t offset = NvM_Registry_Offset(i);
+        uint8_t j = i;
+        while (j > 0U && NvM_Registry_Offset(inst->multi.order[j - 1U]) > offset) {
+            inst->multi.order[j] = inst->multi.order[j - 1U];
+            j--;
+        }
+        inst->multi.order[j] = i;
+    }
+    /* A clean checkpoint already makes each block a single read */
+    inst->multi.pipelined = (job_type == NVM_JOB_READ_ALL && !NvM_Checkpoint_IsClean())
+                                ? inst->readall_pipeline : FALSE;
+
+    if (job_type == NVM_JOB_READ_ALL && NvM_Checkpoint_IsClean()) {
+        NvM_Checkpoint_Prefetch();
+    }
+
+    if (inst->multi.pipelined) {
+        for (uint8_t i = 0; i < inst->multi.count; i++) {
+            set_job_result(NvM_Registry_BlockId(i), NVM_REQ_PENDING);
+        }
+        NvM_ReadAllPipeline_Start(NvM_Registry_Blocks(), inst->multi.count, readall_block_done);
+    }
+}
+
+/**
+ * @brief Map a block's EEPROM slots for block-targeted faults
+ *
+ * Log blocks share the log region, so they have no range of their own.
+ */
+static void map_fault_ranges(const NvM_BlockConfig_t *block)
+{
+    FaultInj_UnmapBlock(block->block_id);
+
+    if (block->block_type == NVM_BLOCK_LOG) {
+        return;
+    }
+
+    uint8_t slots = (block->block_type == NVM_BLOCK_DATASET) ? block->dataset_count : 1U;
+    for (uint8_t i = 0; i < slots; i++) {
+        (void)FaultInj_MapRange(block->block_id, EEPROM_DatasetVersionOffset(block->eeprom_offset, i),
+                                EEPROM_BLOCK_SLOT_SIZE);
+    }
+    if (block->block_type == NVM_BLOCK_REDUNDANT) {
+        (void)FaultInj_MapRange(block->block_id, block->redundant_eeprom_offset, EEPROM_BLOCK_SLOT_SIZE);
+    }
+}
+
+/**
+ * @brief Counter source for Metrics_Export
+ */
+static uint32_t nvm_counters(Metrics_Counter_t *counters, uint32_t max)
+{
+    NvM_Diagnostics_t diag;
+    uint32_t n = 0;
+
+    if (NvM_GetDiagnostics(&diag) != E_OK) {
+        return 0;
+    }
+
+#define NVM_COUNTER(field) \
+    do { \
+        if (n < max) { \
+            counters[n].name = #field; \
+            counters[n].value = diag.field; \
+            n++; \
+        } \
+    } while (0)
+
+    NVM_COUNTER(total_jobs_processed);
+    NVM_COUNTER(total_jobs_failed);
+    NVM_COUNTER(total_jobs_retried);
+    NVM_COUNTER(current_queue_depth);
+    NVM_COUNTER(max_queue_depth);
+    NVM_COUNTER(coalesced_writes);
+    NVM_COUNTER(coalesced_reads);
+    NVM_COUNTER(last_main_cost_us);
+    NVM_COUNTER(max_main_cost_us);
+    NVM_COUNTER(budget_yields);
+    NVM_COUNTER(writeall_skipped_blocks);
+    NVM_COUNTER(batch_rollbacks);
+    NVM_COUNTER(remote_submissions);
+    NVM_COUNTER(remote_rejects);
+    NVM_COUNTER(submit_ring_max_depth);
+    NVM_COUNTER(pre_erases);
+    NVM_COUNTER(pre_erase_hits);
+    NVM_COUNTER(erases_avoided);
+    NVM_COUNTER(bit_clear_fallbacks);
+    NVM_COUNTER(compressed_bytes_saved);
+    NVM_COUNTER(fast_mount_blocks);
+    NVM_COUNTER(checkpoint_writes);
+    NVM_COUNTER(retries_exhausted);
+    NVM_COUNTER(multi_block_preemptions);
+    NVM_COUNTER(read_cache_hits);
+    NVM_COUNTER(read_cache_misses);
+    NVM_COUNTER(mirror_arena_bytes);
+    NVM_COUNTER(rom_bound_blocks);
+    NVM_COUNTER(rom_defaults_materialized);
+    NVM_COUNTER(rom_defaults_written);
+    NVM_COUNTER(rom_default_erases_skipped);
+    NVM_COUNTER(overlapped_jobs);
+
+#undef NVM_COUNTER
+
+    return n;
 }
 
 /**
@@ -188,20 +995,42 @@ static Std_ReturnType process_write_all(void)
  */
 Std_ReturnType NvM_Init(void)
 {
+    NvM_Instance_t *inst = instance();
+
     LOG_INFO("NvM: Initializing...");
 
-    /* Initialize job queue */
+    /* Initialize job queue; the calling thread owns it */
     NvM_JobQueue_Init();
+    NvM_Submit_Reset();
+    inst->owner_thread = pthread_self();
 
     /* Initialize MemIf */
     MemIf_Init();
 
     /* Reset diagnostics */
-    memset(&g_nvm.diagnostics, 0, sizeof(NvM_Diagnostics_t));
+    memset(&inst->diagnostics, 0, sizeof(NvM_Diagnostics_t));
 
     /* Initialize default block configuration */
-    g_nvm.block_count = 0;
-    g_nvm.initialized = TRUE;
+    NvM_Registry_Reset();
+    FaultInj_ClearRanges();
+    inst->coalescing = FALSE;
+    memset(&inst->budget, 0, sizeof(inst->budget));
+    memset(&inst->multi, 0, sizeof(inst->multi));
+    memset(inst->batches, 0, sizeof(inst->batches));
+    inst->readall_pipeline = FALSE;
+    NvM_ReadAllPipeline_Reset();
+    NvM_Log_Reset();
+    inst->pre_erase = FALSE;
+    NvM_PreErase_Reset();
+    inst->device_overlap = FALSE;
+    NvM_Lanes_Reset();
+    NvM_BitClear_Reset();
+    NvM_Compression_Reset();
+    NvM_Checkpoint_Reset();
+    NvM_Retry_Reset();
+    RamMirror_ResetAll();
+    (void)Metrics_RegisterCounterSource("nvm", nvm_counters);
+    inst->initialized = TRUE;
 
     LOG_INFO("NvM: Initialization complete");
     return E_OK;
@@ -212,7 +1041,22 @@ Std_ReturnType NvM_Init(void)
  */
 Std_ReturnType NvM_RegisterBlock(const NvM_BlockConfig_t *block_config)
 {
-    if (block_config == NULL || g_nvm.block_count >= NVM_MAX_BLOCKS) {
+    NvM_Instance_t *inst = instance();
+
+    if (block_config == NULL) {
+        return E_NOT_OK;
+    }
+
+    /* The registry may move while ReadAll/WriteAll walks it */
+    if (inst->multi.active) {
+        LOG_ERROR("NvM: Block %d registered during ReadAll/WriteAll", block_config->block_id);
+        return E_NOT_OK;
+    }
+
+    if (block_config->mirror_mode != NVM_MIRROR_SEQLOCK &&
+        block_config->mirror_mode != NVM_MIRROR_RCU) {
+        LOG_ERROR("NvM: Block %d has invalid mirror mode %d",
+                 block_config->block_id, block_config->mirror_mode);
         return E_NOT_OK;
     }
 
@@ -226,17 +1070,39 @@ Std_ReturnType NvM_RegisterBlock(const NvM_BlockConfig_t *block_config)
     /* Calculate and log block layout */
     Eeprom_BlockLayout_t layout;
     if (EEPROM_CalcBlockLayout((const void*)block_config, &layout) == 0) {
-        LOG_DEBUG("NvM: Block %d layout: data@0x%X(%uB), crc@0x%X(%uB), slot@0x%X(%uB)",
+        LOG_DEBUG("NvM: Block %d layout: data@0x%X(%uB), crc@0x%X(%uB), slot@0x%X(%uB), "
+                 "program %uB in %u ops",
                  block_config->block_id,
                  layout.data_offset, layout.data_size,
                  layout.crc_offset, layout.crc_size,
-                 block_config->eeprom_offset, layout.slot_size);
+                 block_config->eeprom_offset, layout.slot_size,
+                 layout.program_size, layout.program_ops);
     }
 
-    g_nvm.blocks[g_nvm.block_count] = *block_config;
-    g_nvm.blocks[g_nvm.block_count].state = NVM_BLOCKSTATE_UNINITIALIZED;
-    g_nvm.blocks[g_nvm.block_count].erase_count = 0;
-    g_nvm.block_count++;
+    /* Only the flavour the block uses gets arena space, sized to the block */
+    if (RamMirror_Allocate(block_config->block_id, block_config->mirror_mode,
+                           block_config->block_size) != E_OK) {
+        LOG_ERROR("NvM: Block %d RAM mirror does not fit the arena (%u of %u bytes used)",
+                 block_config->block_id, RamMirror_GetArenaUsage(), RAM_MIRROR_ARENA_SIZE);
+        return E_NOT_OK;
+    }
+
+    NvM_BlockConfig_t config = *block_config;
+    config.state = NVM_BLOCKSTATE_UNINITIALIZED;
+    config.erase_count = 0;
+    config.crc_desc = CRC_GetDescriptor(block_config->crc_type);
+    config.persisted_valid = FALSE;
+    config.mirror_clean = FALSE;
+    config.dataset_scanned = FALSE;
+    config.dataset_sequence = 0;
+    config.pre_erased = FALSE;
+    config.rom_bound = FALSE;
+
+    if (NvM_Registry_Add(&config) == NULL) {
+        LOG_ERROR("NvM: Block %d cannot be registered (reserved ID or registry full)", block_config->block_id);
+        return E_NOT_OK;
+    }
+    map_fault_ranges(block_config);
 
     LOG_INFO("NvM: Registered block %d (type=%d, size=%u)",
              block_config->block_id, block_config->block_type, block_config->block_size);
@@ -249,7 +1115,9 @@ Std_ReturnType NvM_RegisterBlock(const NvM_BlockConfig_t *block_config)
  */
 Std_ReturnType NvM_ReadBlock(NvM_BlockIdType block_id, void *nvm_buffer)
 {
-    if (!g_nvm.initialized) {
+    NvM_Instance_t *inst = instance();
+
+    if (!inst->initialized) {
         return E_NOT_OK;
     }
 
@@ -258,6 +1126,36 @@ Std_ReturnType NvM_ReadBlock(NvM_BlockIdType block_id, void *nvm_buffer)
         return E_NOT_OK;
     }
 
+    /* Read-your-writes: serve from a queued write instead of the device */
+    const NvM_Job_t *pending = (inst->coalescing && on_nvm_thread())
+                                   ? NvM_JobQueue_FindPendingWrite(block_id) : NULL;
+    if (pending != NULL && nvm_buffer != NULL) {
+        if (pending->data_ptr != nvm_buffer) {
+            memcpy(nvm_buffer, pending->data_ptr, block->block_size);
+        }
+        set_job_result(block_id, NVM_REQ_OK);
+        inst->diagnostics.coalesced_reads++;
+        NvM_JobEndNotification(block_id);
+        return E_OK;
+    }
+
+    /* Read-through cache: the mirror equals the device copy, no job needed */
+    if (block->read_cache && on_nvm_thread()) {
+        if (nvm_buffer != NULL && read_cache_hit(block)) {
+            if (block_data(block) != nvm_buffer) {
+                memcpy(nvm_buffer, block_data(block), block->block_size);
+            }
+            if (nvm_buffer == block->ram_mirror_ptr) {
+                block->rom_bound = FALSE;
+            }
+            set_job_result(block_id, NVM_REQ_OK);
+            inst->diagnostics.read_cache_hits++;
+            NvM_JobEndNotification(block_id);
+            return E_OK;
+        }
+        inst->diagnostics.read_cache_misses++;
+    }
+
     /* Create read job */
     NvM_Job_t job = {
         .job_type = NVM_JOB_READ,
@@ -271,13 +1169,7 @@ Std_ReturnType NvM_ReadBlock(NvM_BlockIdType block_id, void *nvm_buffer)
         .max_retries = 3
     };
 
-    /* Enqueue job */
-    Std_ReturnType ret = NvM_JobQueue_Enqueue(&job);
-    if (ret == E_OK) {
-        g_job_results[block_id] = NVM_REQ_PENDING;
-    }
-
-    return ret;
+    return submit_job(&job);
 }
 
 /**
@@ -285,7 +1177,9 @@ Std_ReturnType NvM_ReadBlock(NvM_BlockIdType block_id, void *nvm_buffer)
  */
 Std_ReturnType NvM_WriteBlock(NvM_BlockIdType block_id, const void *nvm_buffer)
 {
-    if (!g_nvm.initialized) {
+    NvM_Instance_t *inst = instance();
+
+    if (!inst->initialized) {
         return E_NOT_OK;
     }
 
@@ -307,21 +1201,161 @@ Std_ReturnType NvM_WriteBlock(NvM_BlockIdType block_id, const void *nvm_buffer)
         .max_retries = 3
     };
 
+    return submit_job(&job);
+}
+
+/**
+ * @brief Write several blocks as one commit
+ */
+Std_ReturnType NvM_WriteBlocks(const NvM_BlockIdType *ids, const void *const *bufs, uint8_t n)
+{
+    NvM_Instance_t *inst = instance();
+
+    /* Batch slots are NvM-thread state: no ring path */
+    if (!inst->initialized || ids == NULL || bufs == NULL ||
+        n == 0U || n > NVM_WRITE_BATCH_MAX_BLOCKS || !on_nvm_thread()) {
+        return E_NOT_OK;
+    }
+
+    uint8_t priority = 0xFF;
+    uint8_t is_immediate = FALSE;
+    for (uint8_t i = 0; i < n; i++) {
+        NvM_BlockConfig_t *block = find_block(ids[i]);
+        if (block == NULL || bufs[i] == NULL || block->is_write_protected) {
+            return E_NOT_OK;
+        }
+        for (uint8_t j = 0; j < i; j++) {
+            if (ids[j] == ids[i]) {
+                LOG_ERROR("NvM: Block %d appears twice in one batch", ids[i]);
+                return E_NOT_OK;
+            }
+        }
+        if (block->priority < priority) {
+            priority = block->priority;
+        }
+        if (block->is_immediate) {
+            is_immediate = TRUE;
+        }
+    }
+
+    NvM_WriteBatch_t *batch = NULL;
+    for (uint32_t i = 0; i < NVM_WRITE_BATCH_QUEUE_SIZE; i++) {
+        if (!inst->batches[i].in_use) {
+            batch = &inst->batches[i];
+            break;
+        }
+    }
+    if (batch == NULL) {
+        LOG_WARN("NvM: No free batch slot (%u queued)", NVM_WRITE_BATCH_QUEUE_SIZE);
+        return E_NOT_OK;
+    }
+
+    batch->count = n;
+    memcpy(batch->ids, ids, n * sizeof(NvM_BlockIdType));
+    memcpy(batch->bufs, bufs, n * sizeof(const void *));
+
+    /* Create batch job; no timeout, the slot is released only by processing */
+    NvM_Job_t job = {
+        .job_type = NVM_JOB_WRITE_BATCH,
+        .block_id = ids[0],
+        .data_ptr = batch,
+        .priority = priority,
+        .is_immediate = is_immediate,
+        .submit_time_ms = OsScheduler_GetVirtualTimeMs(),
+        .timeout_ms = 0,
+        .retry_count = 0,
+        .max_retries = 3
+    };
+
     /* Enqueue job */
     Std_ReturnType ret = NvM_JobQueue_Enqueue(&job);
     if (ret == E_OK) {
-        g_job_results[block_id] = NVM_REQ_PENDING;
+        batch->in_use = TRUE;
+        for (uint8_t i = 0; i < n; i++) {
+            set_job_result(ids[i], NVM_REQ_PENDING);
+        }
     }
 
     return ret;
 }
 
+const void* NvM_GetBlockData(NvM_BlockIdType block_id)
+{
+    const NvM_BlockConfig_t *block = find_block(block_id);
+
+    return (block != NULL) ? block_data(block) : NULL;
+}
+
+void* NvM_GetWritableBlockData(NvM_BlockIdType block_id)
+{
+    NvM_Instance_t *inst = instance();
+    NvM_BlockConfig_t *block = find_block(block_id);
+
+    if (block == NULL) {
+        return NULL;
+    }
+
+    /* Copy-on-write: the first store into a bound block's mirror pays the copy */
+    if (block->rom_bound && block->ram_mirror_ptr != NULL) {
+        memcpy(block->ram_mirror_ptr, block->rom_block_ptr, block->block_size);
+        block->rom_bound = FALSE;
+        inst->diagnostics.rom_defaults_materialized++;
+    }
+    block->mirror_clean = FALSE;
+    return block->ram_mirror_ptr;
+}
+
+/**
+ * @brief Program the ROM defaults of every bound block
+ */
+Std_ReturnType NvM_WriteRomDefaults(void)
+{
+    NvM_Instance_t *inst = instance();
+    NvM_BlockConfig_t *blocks[NVM_MAX_BLOCKS];
+    boolean written[NVM_MAX_BLOCKS];
+    uint16_t n = 0;
+
+    if (!inst->initialized || !on_nvm_thread() || inst->multi.active) {
+        return E_NOT_OK;
+    }
+
+    for (uint16_t i = 0; i < NvM_Registry_Count(); i++) {
+        NvM_BlockConfig_t *block = &NvM_Registry_Blocks()[i];
+        if (block->rom_bound && !block->is_write_protected && block->block_type != NVM_BLOCK_LOG) {
+            blocks[n++] = block;
+        }
+    }
+    if (n == 0U) {
+        return E_OK;
+    }
+
+    LOG_INFO("NvM: Writing ROM defaults of %u blocks", n);
+    for (uint16_t i = 0; i < n; i++) {
+        blocks[i]->persisted_valid = FALSE;
+    }
+    NvM_Checkpoint_Invalidate();
+
+    Std_ReturnType ret = NvM_RomDefaults_Execute(blocks, n, written,
+                                                 &inst->diagnostics.rom_default_erases_skipped);
+
+    for (uint16_t i = 0; i < n; i++) {
+        if (written[i]) {
+            mark_persisted(blocks[i], blocks[i]->rom_block_ptr);
+            inst->diagnostics.rom_defaults_written++;
+        }
+        NvM_Registry_SyncState(blocks[i]);
+    }
+    return ret;
+}
+
 /**
  * @brief Read all blocks
  */
 Std_ReturnType NvM_ReadAll(void)
 {
-    if (!g_nvm.initialized) {
+    NvM_Instance_t *inst = instance();
+
+    if (!inst->initialized) {
         return E_NOT_OK;
     }
 
@@ -338,7 +1372,7 @@ Std_ReturnType NvM_ReadAll(void)
         .max_retries = 3
     };
 
-    return NvM_JobQueue_Enqueue(&job);
+    return submit_job(&job);
 }
 
 /**
@@ -346,7 +1380,9 @@ Std_ReturnType NvM_ReadAll(void)
  */
 Std_ReturnType NvM_WriteAll(void)
 {
-    if (!g_nvm.initialized) {
+    NvM_Instance_t *inst = instance();
+
+    if (!inst->initialized) {
         return E_NOT_OK;
     }
 
@@ -363,7 +1399,7 @@ Std_ReturnType NvM_WriteAll(void)
         .max_retries = 3
     };
 
-    return NvM_JobQueue_Enqueue(&job);
+    return submit_job(&job);
 }
 
 /**
@@ -375,13 +1411,11 @@ Std_ReturnType NvM_GetErrorStatus(NvM_BlockIdType block_id, uint8_t *error_statu
         return E_NOT_OK;
     }
 
-    NvM_BlockConfig_t *block = find_block(block_id);
-    if (block == NULL) {
+    if (NvM_Registry_GetState(block_id, error_status_ptr) != E_OK) {
         *error_status_ptr = NVM_BLOCK_INVALID;
         return E_NOT_OK;
     }
 
-    *error_status_ptr = block->state;
     return E_OK;
 }
 
@@ -390,76 +1424,95 @@ Std_ReturnType NvM_GetErrorStatus(NvM_BlockIdType block_id, uint8_t *error_statu
  */
 Std_ReturnType NvM_GetJobResult(NvM_BlockIdType block_id, uint8_t *result_ptr)
 {
-    if (result_ptr == NULL || block_id >= NVM_MAX_BLOCKS) {
+    NvM_Instance_t *inst = instance();
+
+    if (result_ptr == NULL) {
         return E_NOT_OK;
     }
 
-    *result_ptr = g_job_results[block_id];
+    *result_ptr = __atomic_load_n(&inst->job_results[block_id], __ATOMIC_ACQUIRE);
     return E_OK;
 }
 
 /**
  * @brief Main function
+ *
+ * Processes queued jobs until the queue is empty or the per-call budget
+ * is used up. An unfinished ReadAll/WriteAll resumes first on the next
+ * call. With budget left and nothing queued, one log sector may be
+ * compacted. The modelled device time is reported to the scheduler
+ * (unless driver timing already advanced the virtual clock).
  */
 void NvM_MainFunction(void)
 {
-    if (!g_nvm.initialized) {
+    NvM_Instance_t *inst = instance();
+
+    if (!inst->initialized) {
         return;
     }
 
-    /* Check for timeouts */
+    /* Requests from other cores join the priority queue first */
+    drain_submissions();
+
+    /* Retries whose backoff has passed rejoin the queue, then check for timeouts */
     uint32_t current_time = OsScheduler_GetVirtualTimeMs();
-    NvM_JobQueue_CheckTimeouts(current_time);
+    NvM_Retry_Release(current_time);
+    fail_timed_out_jobs(current_time);
+
+    /* Lane jobs finish as their devices get through them; the device time is not this call's */
+    if (inst->device_overlap) {
+        NvM_Lanes_Poll();
+    }
+
+    NvM_WorkMeter_t meter;
+    meter_start(&meter);
+
+    boolean finished = TRUE;
+    if (inst->multi.active) {
+        finished = multi_block_step(&meter);
+    }
 
     /* Process jobs from queue */
     NvM_Job_t job;
-    while (NvM_JobQueue_Dequeue(&job) == E_OK) {
-        Std_ReturnType ret = E_NOT_OK;
-
-        /* Process job based on type */
-        switch (job.job_type) {
-            case NVM_JOB_READ:
-                ret = process_read_block(&job);
-                break;
-
-            case NVM_JOB_WRITE:
-                ret = process_write_block(&job);
-                break;
-
-            case NVM_JOB_READ_ALL:
-                ret = process_read_all();
-                break;
-
-            case NVM_JOB_WRITE_ALL:
-                ret = process_write_all();
-                break;
-
-            default:
-                LOG_ERROR("NvM: Unknown job type %d", job.job_type);
-                break;
+    while (finished && !meter_exhausted(&meter) && dequeue_job(&job) == E_OK) {
+        if (job.job_type == NVM_JOB_READ_ALL || job.job_type == NVM_JOB_WRITE_ALL) {
+            multi_block_start(job.job_type);
+            inst->multi.submit_time_ms = job.submit_time_ms;
+            inst->multi.start_ns = METRICS_ENABLED() ? Metrics_HostNs() : 0U;
+            finished = multi_block_step(&meter);
+            continue;
         }
 
-        /* Update result */
-        if (job.block_id != 0xFF) {
-            g_job_results[job.block_id] = (ret == E_OK) ? NVM_REQ_OK : NVM_REQ_NOT_OK;
+        if (inst->device_overlap && start_on_lane(&job)) {
+            continue;
         }
 
-        /* Update diagnostics */
-        g_nvm.diagnostics.total_jobs_processed++;
-        if (ret != E_OK) {
-            g_nvm.diagnostics.total_jobs_failed++;
-        }
+        run_job(&job, &meter);
+    }
 
-        /* Notify application */
-        if (ret == E_OK) {
-            NvM_JobEndNotification(job.block_id);
-        } else {
-            NvM_JobErrorNotification(job.block_id);
+    /* Idle: reclaim one log sector, else erase one dataset slot, ahead of the writes that need it */
+    if (finished && !inst->multi.active && NvM_JobQueue_IsEmpty() && !meter_exhausted(&meter)) {
+        if (NvM_Log_BackgroundStep()) {
+            meter_update(&meter);
+        } else if (inst->pre_erase && NvM_PreErase_Step()) {
+            meter_update(&meter);
         }
     }
 
     /* Update diagnostics */
-    g_nvm.diagnostics.current_queue_depth = NvM_JobQueue_GetDepth();
+    if ((inst->multi.active || !NvM_JobQueue_IsEmpty()) && meter_exhausted(&meter)) {
+        inst->diagnostics.budget_yields++;
+    }
+    inst->diagnostics.last_main_cost_us = meter.cost_us;
+    if (meter.cost_us > inst->diagnostics.max_main_cost_us) {
+        inst->diagnostics.max_main_cost_us = meter.cost_us;
+    }
+    inst->diagnostics.current_queue_depth = NvM_JobQueue_GetDepth();
+
+    /* With driver timing on the device time has already elapsed on the clock */
+    if (Eep_GetTimingMode() == EEP_TIMING_OFF) {
+        OsScheduler_ReportExecTimeUs(meter.cost_us);
+    }
 }
 
 /**
@@ -468,6 +1521,12 @@ void NvM_MainFunction(void)
 void NvM_JobEndNotification(NvM_BlockIdType block_id)
 {
     LOG_DEBUG("NvM: Job ended for block %d", block_id);
+    TRACE_PROBE2(nvm, job_complete, block_id, E_OK);
+    if (TIMELINE_ACTIVE()) {
+        Timeline_Job(TIMELINE_JOB_COMPLETED, block_id, 0U, E_OK, OsScheduler_GetVirtualTimeUs());
+    }
+    NvM_Shm_Complete(block_id);
+    NvM_Wait_Signal(block_id);
 }
 
 /**
@@ -476,6 +1535,12 @@ void NvM_JobEndNotification(NvM_BlockIdType block_id)
 void NvM_JobErrorNotification(NvM_BlockIdType block_id)
 {
     LOG_WARN("NvM: Job error for block %d", block_id);
+    TRACE_PROBE2(nvm, job_complete, block_id, E_NOT_OK);
+    if (TIMELINE_ACTIVE()) {
+        Timeline_Job(TIMELINE_JOB_COMPLETED, block_id, 0U, E_NOT_OK, OsScheduler_GetVirtualTimeUs());
+    }
+    NvM_Shm_Complete(block_id);
+    NvM_Wait_Signal(block_id);
 }
 
 /**
@@ -493,7 +1558,9 @@ void NvM_JobErrorNotification(NvM_BlockIdType block_id)
  */
 Std_ReturnType NvM_SetDataIndex(NvM_BlockIdType block_id, uint8_t data_index)
 {
-    if (!g_nvm.initialized) {
+    NvM_Instance_t *inst = instance();
+
+    if (!inst->initialized) {
         LOG_ERROR("NvM: Not initialized");
         return E_NOT_OK;
     }
@@ -518,11 +1585,15 @@ Std_ReturnType NvM_SetDataIndex(NvM_BlockIdType block_id, uint8_t data_index)
         return E_NOT_OK;
     }
 
+    /* The next write must still outrank every slot on the device */
+    NvM_ScanDatasetHeaders(block);
+
     /* Store previous index for logging */
     uint8_t prev_index = block->active_dataset_index;
 
-    /* Update active dataset index */
+    /* Update active dataset index; the mirror no longer describes the active slot */
     block->active_dataset_index = data_index;
+    block->persisted_valid = FALSE;
 
     LOG_INFO("NvM: Block %d dataset index changed: %u -> %u",
              block_id, prev_index, data_index);
@@ -530,17 +1601,115 @@ Std_ReturnType NvM_SetDataIndex(NvM_BlockIdType block_id, uint8_t data_index)
     return E_OK;
 }
 
+/**
+ * @brief Enable or disable write coalescing
+ */
+void NvM_SetWriteCoalescing(boolean enable)
+{
+    NvM_Instance_t *inst = instance();
+
+    inst->coalescing = enable;
+    NvM_JobQueue_SetCoalescing(enable);
+}
+
+/**
+ * @brief Enable or disable the pipelined ReadAll
+ */
+void NvM_SetReadAllPipeline(boolean enable)
+{
+    NvM_Instance_t *inst = instance();
+
+    inst->readall_pipeline = enable;
+}
+
+/**
+ * @brief Enable or disable idle pre-erase of dataset slots
+ */
+void NvM_SetDatasetPreErase(boolean enable)
+{
+    NvM_Instance_t *inst = instance();
+
+    inst->pre_erase = enable;
+}
+
+/**
+ * @brief Enable or disable device lanes for single-block jobs
+ */
+void NvM_SetDeviceOverlap(boolean enable)
+{
+    NvM_Instance_t *inst = instance();
+
+    inst->device_overlap = enable;
+}
+
+/**
+ * @brief Set MainFunction work quota
+ */
+Std_ReturnType NvM_SetMainFunctionBudget(const NvM_MainFunctionBudget_t *budget)
+{
+    NvM_Instance_t *inst = instance();
+
+    if (budget == NULL) {
+        memset(&inst->budget, 0, sizeof(inst->budget));
+    } else {
+        inst->budget = *budget;
+    }
+
+    return E_OK;
+}
+
+/**
+ * @brief Set the retry policy for failed ReadBlock/WriteBlock jobs
+ */
+Std_ReturnType NvM_SetRetryPolicy(const NvM_RetryPolicy_t *policy)
+{
+    if (policy != NULL && policy->jitter_percent > 100U) {
+        return E_NOT_OK;
+    }
+
+    NvM_Retry_SetPolicy(policy);
+    return E_OK;
+}
+
 /**
  * @brief Get diagnostics
  */
 Std_ReturnType NvM_GetDiagnostics(NvM_Diagnostics_t *info_ptr)
 {
+    NvM_Instance_t *inst = instance();
+
     if (info_ptr == NULL) {
         return E_NOT_OK;
     }
 
-    *info_ptr = g_nvm.diagnostics;
+    *info_ptr = inst->diagnostics;
     info_ptr->max_queue_depth = NvM_JobQueue_GetMaxDepth();
+    info_ptr->coalesced_writes = NvM_JobQueue_GetCoalescedCount();
+
+    NvM_SubmitStats_t submit;
+    NvM_Submit_GetStats(&submit);
+    info_ptr->remote_submissions = submit.submitted;
+    info_ptr->remote_rejects = submit.rejected;
+    info_ptr->submit_ring_max_depth = submit.max_depth;
+
+    NvM_PreErase_GetCounts(&info_ptr->pre_erases, &info_ptr->pre_erase_hits);
+    NvM_BitClear_GetCounts(&info_ptr->erases_avoided, &info_ptr->bit_clear_fallbacks);
+    info_ptr->compressed_bytes_saved = NvM_Compression_GetBytesSaved();
+    NvM_Checkpoint_GetCounts(&info_ptr->fast_mount_blocks, &info_ptr->checkpoint_writes);
+    NvM_Retry_GetCounts(&info_ptr->total_jobs_retried, &info_ptr->retries_exhausted);
+    info_ptr->mirror_arena_bytes = RamMirror_GetArenaUsage();
+
+    info_ptr->rom_bound_blocks = 0U;
+    for (uint16_t i = 0; i < NvM_Registry_Count(); i++) {
+        if (NvM_Registry_Blocks()[i].rom_bound) {
+            info_ptr->rom_bound_blocks++;
+        }
+    }
 
     return E_OK;
 }
+
+const NvM_PartDesc_t NvM_CorePart = {
+    .size = sizeof(NvM_Instance_t),
+    .default_state = &g_default_state
+};
@@ -0,0 +1,338 @@
+/**
+ * @file nvm_batch.c
+ * @brief All-or-nothing device commit of a multi-block write (NvM_WriteBlocks)
+ *
+ * REQ-Block管理: design/03-Block管理机制.md §2
+ * - 按擦除单元分组: 每个擦除单元只擦写一次, 按eeprom_offset升序编程
+ * - 覆盖现有有效副本前保存原始内容 (undo), 任一编程失败则全部回滚
+ * - 全部编程成功后才统一提交Block元数据 (版本号/Dataset索引/状态)
+ */
+
+#include "nvm.h"
+#include "nvm_internal.h"
+#include "nvm_block_types.h"
+#include "eeprom_layout.h"
+#include "memif.h"
+#include "crc.h"
+#include "logging.h"
+#include <string.h>
+
+/**
+ * @brief Device copies one batch may program (REDUNDANT blocks have two)
+ */
+#define NVM_BATCH_MAX_TARGETS (NVM_WRITE_BATCH_MAX_BLOCKS * 2U)
+
+/**
+ * @brief CRC page length programmed after the data (as NvM_WriteBlockWithCrc)
+ */
+#define NVM_BATCH_CRC_PAGE_SIZE EEPROM_LAYOUT_PAGE_SIZE
+
+/**
+ * @brief One device copy programmed by the batch
+ */
+typedef struct {
+    NvM_BlockConfig_t *block;
+    const uint8_t *data;
+    uint32_t offset;               /**< Slot start = erase unit start */
+    boolean verify;                /**< Compare with the data after programming */
+    boolean has_undo;              /**< Copy is live: saved before programming */
+    uint8_t *undo;                 /**< Raw data + stored CRC bytes */
+} NvM_BatchTarget_t;
+
+/**
+ * @brief Write batch working set of one context
+ */
+struct NvM_BatchState {
+    NvM_BatchTarget_t targets[NVM_BATCH_MAX_TARGETS];
+    uint8_t undo[NVM_BATCH_MAX_TARGETS][EEPROM_BLOCK_SLOT_SIZE];
+};
+
+/**
+ * @brief State used while no context is bound
+ */
+static struct NvM_BatchState g_default_state;
+
+static struct NvM_BatchState* batch_state(void)
+{
+    return (struct NvM_BatchState *)NvM_PartState(NVM_PART_BATCH);
+}
+
+static uint32_t stored_length(const NvM_BlockConfig_t *block)
+{
+    const Crc_Descriptor_t *crc = NvM_GetBlockCrc(block);
+    uint32_t length = (uint32_t)block->block_size + ((crc != NULL) ? crc->crc_size : 0U);
+
+    /* Compressed copies: the largest image (raw payload) after the length header */
+    return (block->compression != NVM_COMPRESSION_NONE) ? EEPROM_COMPRESSED_HEADER_SIZE + length
+                                                        : length;
+}
+
+/**
+ * @brief Dataset slot the batch writes (the one after the active slot)
+ */
+static uint8_t dataset_next_index(const NvM_BlockConfig_t *block)
+{
+    return (uint8_t)((block->active_dataset_index + 1U) % block->dataset_count);
+}
+
+static void add_target(uint8_t *count, NvM_BlockConfig_t *block, const void *data,
+                       uint32_t offset, boolean verify, boolean has_undo)
+{
+    struct NvM_BatchState *bs = batch_state();
+    NvM_BatchTarget_t *t = &bs->targets[*count];
+
+    t->block = block;
+    t->data = (const uint8_t *)data;
+    t->offset = offset;
+    t->verify = verify;
+    t->has_undo = has_undo;
+    t->undo = bs->undo[*count];
+    (*count)++;
+}
+
+/**
+ * @brief Build the copy list in ascending offset order
+ *
+ * Every copy starts its own slot, and slots are erase-unit aligned, so
+ * grouping by erase unit means one erase per copy. Two copies in the same
+ * unit could not both survive that erase and are rejected.
+ */
+static Std_ReturnType plan_targets(NvM_BlockConfig_t *const *blocks, const void *const *bufs,
+                                   uint8_t n, uint8_t *count)
+{
+    struct NvM_BatchState *bs = batch_state();
+
+    *count = 0;
+
+    for (uint8_t i = 0; i < n; i++) {
+        NvM_BlockConfig_t *block = blocks[i];
+
+        switch (block->block_type) {
+            case NVM_BLOCK_NATIVE:
+                add_target(count, block, bufs[i], block->eeprom_offset, FALSE, TRUE);
+                break;
+
+            case NVM_BLOCK_REDUNDANT:
+                add_target(count, block, bufs[i], block->eeprom_offset, TRUE, TRUE);
+                add_target(count, block, bufs[i], block->redundant_eeprom_offset, FALSE, TRUE);
+                break;
+
+            case NVM_BLOCK_DATASET: {
+                /* The active slot stays untouched until the commit flips the index */
+                NvM_ScanDatasetHeaders(block);
+                uint8_t next = dataset_next_index(block);
+                add_target(count, block, bufs[i],
+                           EEPROM_DatasetVersionOffset(block->eeprom_offset, next), FALSE,
+                           (next == block->active_dataset_index) ? TRUE : FALSE);
+                break;
+            }
+
+            case NVM_BLOCK_LOG:
+                /* An appended record is current at once; it cannot wait for the commit */
+                LOG_ERROR("NvM: Batch - LOG block %d cannot be batched", block->block_id);
+                return E_NOT_OK;
+
+            default:
+                LOG_ERROR("NvM: Batch - unknown block type %d for block %d",
+                         block->block_type, block->block_id);
+                return E_NOT_OK;
+        }
+    }
+
+    /* Insertion sort by offset (count <= NVM_BATCH_MAX_TARGETS) */
+    for (uint8_t i = 1; i < *count; i++) {
+        NvM_BatchTarget_t t = bs->targets[i];
+        uint8_t j = i;
+        while (j > 0U && bs->targets[j - 1U].offset > t.offset) {
+            bs->targets[j] = bs->targets[j - 1U];
+            j--;
+        }
+        bs->targets[j] = t;
+    }
+
+    for (uint8_t i = 1; i < *count; i++) {
+        if ((bs->targets[i].offset / EEPROM_BLOCK_SLOT_SIZE) ==
+            (bs->targets[i - 1U].offset / EEPROM_BLOCK_SLOT_SIZE)) {
+            LOG_ERROR("NvM: Batch - blocks %d and %d share the erase unit at 0x%X",
+                     bs->targets[i - 1U].block->block_id, bs->targets[i].block->block_id,
+                     bs->targets[i].offset);
+            return E_NOT_OK;
+        }
+    }
+
+    return E_OK;
+}
+
+/**
+ * @brief Program one copy (one erase unless pre-erased or updated in place, data + CRC page)
+ */
+static Std_ReturnType program_target(const NvM_BatchTarget_t *t)
+{
+    Std_ReturnType ret = E_NOT_OK;
+
+    /* A dataset slot erased while idle goes straight to programming */
+    if (t->block->block_type == NVM_BLOCK_DATASET &&
+        NvM_PreErase_Take(t->block, dataset_next_index(t->block))) {
+        ret = NvM_ProgramBlockCopy(t->block, t->offset, t->data);
+    }
+    if (ret != E_OK && NvM_UpdateBlockWithCrc(t->block, t->offset, t->data) != E_OK) {
+        return E_NOT_OK;
+    }
+
+    if (t->verify) {
+        if (NvM_VerifyBlockCopy(t->block, t->offset, t->data) != E_OK) {
+            LOG_ERROR("NvM: Batch - block %d verification failed at 0x%X",
+                     t->block->block_id, t->offset);
+            return E_NOT_OK;
+        }
+    }
+
+    return E_OK;
+}
+
+/**
+ * @brief Put a saved copy back byte for byte (its old CRC included)
+ */
+static Std_ReturnType restore_target(const NvM_BatchTarget_t *t)
+{
+    uint16_t size = t->block->block_size;
+    uint32_t crc_size = stored_length(t->block) - size;
+
+    if (MemIf_Erase(t->offset, size) != E_OK) {
+        return E_NOT_OK;
+    }
+
+    /* Compressed copies are one image, like an inline CRC */
+    if (t->block->crc_placement == NVM_CRC_PLACEMENT_INLINE ||
+        t->block->compression != NVM_COMPRESSION_NONE) {
+        /* The undo buffer is a whole slot: pad the saved image in place */
+        uint32_t image_size = EEPROM_PAGE_ROUNDUP(size + crc_size);
+        memset(&t->undo[size + crc_size], 0xFF, image_size - (size + crc_size));
+        return MemIf_Write(t->offset, t->undo, image_size);
+    }
+
+    if (crc_size == 0U) {
+        return MemIf_Write(t->offset, t->undo, size);
+    }
+
+    /* Data and padded CRC page in one program request */
+    uint8_t page_buffer[NVM_BATCH_CRC_PAGE_SIZE];
+    memset(page_buffer, 0xFF, sizeof(page_buffer));
+    memcpy(page_buffer, &t->undo[size], crc_size);
+    MemIf_IoVec_t iov[2] = {
+        { .address = t->offset, .buffer = t->undo, .length = size },
+        { .address = t->offset + size, .buffer = page_buffer, .length = sizeof(page_buffer) }
+    };
+    return MemIf_WriteV(iov, 2U);
+}
+
+/**
+ * @brief Undo copies [0, failed] after a programming failure
+ *
+ * @return TRUE if the device is back to its state before the batch
+ */
+static boolean rollback(uint8_t failed)
+{
+    struct NvM_BatchState *bs = batch_state();
+    boolean restored = TRUE;
+
+    for (uint8_t i = 0; i <= failed; i++) {
+        const NvM_BatchTarget_t *t = &bs->targets[i];
+        if (!t->has_undo) {
+            /* Inactive dataset slot: not read before the commit, but its header must go */
+            if (MemIf_Erase(t->offset, t->block->block_size) != E_OK) {
+                restored = FALSE;
+            }
+            continue;
+        }
+        if (restore_target(t) != E_OK) {
+            LOG_ERROR("NvM: Batch - block %d rollback failed at 0x%X", t->block->block_id, t->offset);
+            t->block->state = NVM_BLOCKSTATE_INVALID;
+            restored = FALSE;
+        }
+    }
+
+    return restored;
+}
+
+/**
+ * @brief Apply the per-type metadata of a committed block
+ */
+static void commit_block(NvM_BlockConfig_t *block)
+{
+    switch (block->block_type) {
+        case NVM_BLOCK_REDUNDANT:
+            block->active_version++;
+            if (block->version_control_offset > 0) {
+                MemIf_Write(block->version_control_offset, &block->active_version, 1);
+            }
+            break;
+
+        case NVM_BLOCK_DATASET:
+            block->active_dataset_index = dataset_next_index(block);
+            break;
+
+        default:
+            break;
+    }
+
+    block->erase_count++;
+    block->state = NVM_BLOCKSTATE_VALID;
+}
+
+Std_ReturnType NvM_WriteBatch_Execute(NvM_BlockConfig_t *const *blocks, const void *const *bufs,
+                                      uint8_t n, boolean *restored)
+{
+    struct NvM_BatchState *bs = batch_state();
+    uint8_t count;
+
+    *restored = TRUE;
+
+    if (n == 0U || n > NVM_WRITE_BATCH_MAX_BLOCKS ||
+        plan_targets(blocks, bufs, n, &count) != E_OK) {
+        return E_NOT_OK;
+    }
+
+    /* Save every live copy before the first erase */
+    for (uint8_t i = 0; i < count; i++) {
+        NvM_BatchTarget_t *t = &bs->targets[i];
+        if (t->has_undo && MemIf_Read(t->offset, t->undo, stored_length(t->block)) != E_OK) {
+            LOG_ERROR("NvM: Batch - cannot save block %d at 0x%X", t->block->block_id, t->offset);
+            return E_NOT_OK;
+        }
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        if (program_target(&bs->targets[i]) != E_OK) {
+            LOG_ERROR("NvM: Batch - block %d write failed at 0x%X, rolling back %u copies",
+                     bs->targets[i].block->block_id, bs->targets[i].offset, i + 1U);
+            *restored = rollback(i);
+            return E_NOT_OK;
+        }
+    }
+
+    /* Dataset headers last, so a partial batch never outranks the old slots */
+    for (uint8_t i = 0; i < count; i++) {
+        NvM_BatchTarget_t *t = &bs->targets[i];
+        if (t->block->block_type == NVM_BLOCK_DATASET &&
+            NvM_WriteDatasetHeader(t->block, dataset_next_index(t->block)) != E_OK) {
+            LOG_ERROR("NvM: Batch - block %d header write failed, rolling back %u copies",
+                     t->block->block_id, count);
+            *restored = rollback((uint8_t)(count - 1U));
+            return E_NOT_OK;
+        }
+    }
+
+    /* Commit point: every copy is on the device */
+    for (uint8_t i = 0; i < n; i++) {
+        commit_block(blocks[i]);
+    }
+
+    LOG_INFO("NvM: Batch of %u blocks committed (%u copies)", n, count);
+    return E_OK;
+}
+
+const NvM_PartDesc_t NvM_BatchPart = {
+    .size = sizeof(struct NvM_BatchState),
+    .default_state = &g_default_state
+};
@@ -6,54 +6,103 @@
  * - Native Block: 单副本
  * - Redundant Block: 双副本机制
  * - Dataset Block: 多版本管理
+ * - 位清除更新: bit_clear_update的Native/Redundant副本在器件允许时原地编程, 省去擦除
+ * - 负载压缩: 副本存为 [长度头|压缩负载|CRC] 单一映像, 读取时校验后直接解码到调用者缓冲
+ * - ROM默认值绑定: rom_binding的Block全部副本失败时RAM镜像指向ROM默认值, 不拷贝
  */
 
 #include "nvm.h"
 #include "nvm_block_types.h"
+#include "nvm_internal.h"
 #include "eeprom_layout.h"
+#include "eeprom_driver.h"
 #include "memif.h"
-#include "crc16.h"
+#include "crc.h"
+#include "rle.h"
+#include "trace_probes.h"
 #include "logging.h"
 #include <string.h>
 
+/**
+ * @brief Compressed copy header: payload length (LE), bit 15 set when stored raw
+ *
+ * An erased header (0xFFFF) never matches a valid length.
+ */
+#define NVM_COMPRESSED_RAW_FLAG   0x8000U
+#define NVM_COMPRESSED_LENGTH_MASK 0x7FFFU
+
+/**
+ * @brief Block-type counters of one context (cleared by NvM_Init)
+ */
+struct NvM_BlockTypesState {
+    uint32_t bit_clear_updates;         /**< In-place updates */
+    uint32_t bit_clear_fallbacks;
+    uint32_t compressed_bytes_saved;    /**< Device bytes saved by compressed copies */
+};
+
+/**
+ * @brief State used while no context is bound
+ */
+static struct NvM_BlockTypesState g_default_state;
+
+static struct NvM_BlockTypesState* block_types_state(void)
+{
+    return (struct NvM_BlockTypesState *)NvM_PartState(NVM_PART_BLOCK_TYPES);
+}
+
+/**
+ * @brief Get the CRC engine of a block
+ */
+const Crc_Descriptor_t* NvM_GetBlockCrc(const NvM_BlockConfig_t *block)
+{
+    if (block->crc_desc != NULL) {
+        return block->crc_desc;
+    }
+
+    return CRC_GetDescriptor(block->crc_type);
+}
+
 /**
  * @brief Try to read block with CRC verification
  *
+ * Data and CRC are adjacent in every placement; one vectored read puts
+ * the data straight into the caller's buffer and the CRC beside it.
+ *
  * @param offset EEPROM offset
  * @param data Data buffer
  * @param size Block size
- * @param crc_type CRC type
+ * @param crc CRC engine (NULL or NVM_CRC_NONE = no CRC)
  * @return TRUE if successful
  */
-boolean NvM_TryReadBlock(uint32_t offset, uint8_t *data, uint16_t size, NvM_CrcType_t crc_type)
+boolean NvM_TryReadBlock(uint32_t offset, uint8_t *data, uint16_t size, const Crc_Descriptor_t *crc)
 {
-    /* Read data */
-    if (MemIf_Read(offset, data, size) != E_OK) {
-        return FALSE;
+    if (crc == NULL || crc->crc_size == 0) {
+        return (MemIf_Read(offset, data, size) == E_OK) ? TRUE : FALSE;
     }
 
-    /* Verify CRC if needed */
-    if (crc_type != NVM_CRC_NONE) {
-        uint32_t crc_offset = offset + size;
-        uint16_t stored_crc = 0;
-
-        /* Read CRC from page-aligned location */
-        if (MemIf_Read(crc_offset, (uint8_t*)&stored_crc, sizeof(stored_crc)) != E_OK) {
-            LOG_DEBUG("NvM: CRC read failed at offset 0x%X", crc_offset);
-            return FALSE;
-        }
+    uint8_t stored[4];
+    MemIf_IoVec_t iov[2] = {
+        { .address = offset, .buffer = data, .length = size },
+        { .address = offset + size, .buffer = stored, .length = crc->crc_size }
+    };
 
-        uint16_t calculated_crc = Crc16_Calculate(data, size);
+    if (MemIf_ReadV(iov, 2U) != E_OK) {
+        LOG_DEBUG("NvM: Block read failed at offset 0x%X", offset);
+        return FALSE;
+    }
 
-        if (stored_crc != calculated_crc) {
-            LOG_DEBUG("NvM: CRC failed at offset 0x%X (stored=0x%04X, calc=0x%04X)",
-                     offset, stored_crc, calculated_crc);
-            return FALSE;
-        }
+    uint32_t stored_crc = CRC_Load(crc, stored);
+    TRACE_PROBE1(nvm, crc_start, size);
+    uint32_t calculated_crc = crc->calculate(data, size);
+    TRACE_PROBE1(nvm, crc_done, size);
 
-        LOG_DEBUG("NvM: CRC OK at offset 0x%X (0x%04X)", offset, stored_crc);
+    if (stored_crc != calculated_crc) {
+        LOG_DEBUG("NvM: CRC failed at offset 0x%X (stored=0x%08X, calc=0x%08X)",
+                 offset, stored_crc, calculated_crc);
+        return FALSE;
     }
 
+    LOG_DEBUG("NvM: CRC OK at offset 0x%X (0x%08X)", offset, stored_crc);
     return TRUE;
 }
 
@@ -63,69 +112,378 @@ boolean NvM_TryReadBlock(uint32_t offset, uint8_t *data, uint16_t size, NvM_CrcT
  * @param offset EEPROM offset
  * @param data Data buffer
  * @param size Block size
- * @param crc_type CRC type
+ * @param crc CRC engine (NULL or NVM_CRC_NONE = no CRC)
+ * @param placement CRC programming layout
  * @return E_OK if successful
  */
 Std_ReturnType NvM_WriteBlockWithCrc(uint32_t offset, const uint8_t *data,
-                                     uint16_t size, NvM_CrcType_t crc_type)
+                                     uint16_t size, const Crc_Descriptor_t *crc,
+                                     NvM_CrcPlacementType_t placement)
+{
+    /* Erase block first */
+    if (MemIf_Erase(offset, size) != E_OK) {
+        LOG_ERROR("NvM: Erase failed at offset 0x%X", offset);
+        return E_NOT_OK;
+    }
+
+    return NvM_ProgramBlockWithCrc(offset, data, size, crc, placement);
+}
+
+uint32_t NvM_BuildBlockImage(const uint8_t *data, uint16_t size, const Crc_Descriptor_t *crc,
+                             uint8_t *image)
 {
-    uint16_t crc = 0;
-    uint16_t crc_size = 0;
+    boolean has_crc = (crc != NULL && crc->crc_size > 0) ? TRUE : FALSE;
+    uint32_t image_size = EEPROM_PAGE_ROUNDUP((uint32_t)size + (has_crc ? crc->crc_size : 0U));
+
+    if (image_size > EEPROM_BLOCK_SLOT_SIZE) {
+        return 0;
+    }
+
+    memset(image, 0xFF, image_size);  /* Fill with erased state */
+    memcpy(image, data, size);
+    if (has_crc) {
+        TRACE_PROBE1(nvm, crc_start, size);
+        CRC_Store(crc, crc->calculate(data, size), &image[size]);
+        TRACE_PROBE1(nvm, crc_done, size);
+    }
+
+    return image_size;
+}
+
+/**
+ * @brief Program block with CRC into an erased slot
+ *
+ * @param offset EEPROM offset
+ * @param data Data buffer
+ * @param size Block size
+ * @param crc CRC engine (NULL or NVM_CRC_NONE = no CRC)
+ * @param placement CRC programming layout
+ * @return E_OK if successful
+ */
+Std_ReturnType NvM_ProgramBlockWithCrc(uint32_t offset, const uint8_t *data,
+                                       uint16_t size, const Crc_Descriptor_t *crc,
+                                       NvM_CrcPlacementType_t placement)
+{
+    uint32_t crc_value = 0;
+    boolean has_crc = (crc != NULL && crc->crc_size > 0) ? TRUE : FALSE;
+
+    /* Inline CRC: data + CRC padded to whole pages, one program */
+    if (placement == NVM_CRC_PLACEMENT_INLINE) {
+        uint8_t image[EEPROM_BLOCK_SLOT_SIZE];
+        uint32_t image_size = NvM_BuildBlockImage(data, size, crc, image);
+
+        if (image_size == 0U) {
+            LOG_ERROR("NvM: Block image at offset 0x%X exceeds its slot", offset);
+            return E_NOT_OK;
+        }
+
+        if (MemIf_Write(offset, image, image_size) != E_OK) {
+            LOG_ERROR("NvM: Write failed at offset 0x%X", offset);
+            return E_NOT_OK;
+        }
+
+        return E_OK;
+    }
 
     /* Calculate CRC if needed */
-    if (crc_type != NVM_CRC_NONE) {
-        crc = Crc16_Calculate(data, size);
-        crc_size = sizeof(crc);
-        LOG_DEBUG("NvM: CRC = 0x%04X for offset 0x%X", crc, offset);
+    if (has_crc) {
+        TRACE_PROBE1(nvm, crc_start, size);
+        crc_value = crc->calculate(data, size);
+        TRACE_PROBE1(nvm, crc_done, size);
+        LOG_DEBUG("NvM: CRC = 0x%08X for offset 0x%X", crc_value, offset);
     }
 
-    /* Erase block first */
-    if (MemIf_Erase(offset, size) != E_OK) {
-        LOG_ERROR("NvM: Erase failed at offset 0x%X", offset);
+    if (!has_crc) {
+        if (MemIf_Write(offset, data, size) != E_OK) {
+            LOG_ERROR("NvM: Write failed at offset 0x%X", offset);
+            return E_NOT_OK;
+        }
+        return E_OK;
+    }
+
+    /* Separate CRC: its own page after the data, padded for EEPROM write constraints */
+    uint32_t crc_offset = offset + size;
+    if ((crc_offset % EEPROM_LAYOUT_PAGE_SIZE) != 0) {
+        /* CRC is within data page - needs NVM_CRC_PLACEMENT_INLINE */
+        LOG_ERROR("NvM: CRC at offset 0x%X is not page-aligned", crc_offset);
         return E_NOT_OK;
     }
 
-    /* Write data */
-    if (MemIf_Write(offset, data, size) != E_OK) {
+    uint8_t page_buffer[EEPROM_LAYOUT_PAGE_SIZE];
+    memset(page_buffer, 0xFF, sizeof(page_buffer));  /* Fill with erased state */
+    CRC_Store(crc, crc_value, page_buffer);
+
+    /* Data and CRC page in one program request */
+    MemIf_IoVec_t iov[2] = {
+        { .address = offset, .buffer = (void *)data, .length = size },
+        { .address = crc_offset, .buffer = page_buffer, .length = sizeof(page_buffer) }
+    };
+    if (MemIf_WriteV(iov, 2U) != E_OK) {
         LOG_ERROR("NvM: Write failed at offset 0x%X", offset);
         return E_NOT_OK;
     }
 
-    /* Write CRC - pad to page boundary for EEPROM write constraints */
-    if (crc_type != NVM_CRC_NONE) {
-        uint32_t crc_offset = offset + size;
+    return E_OK;
+}
 
-        /* Check if CRC offset is page-aligned */
-        if ((crc_offset % 256) == 0) {
-            /* CRC is at page boundary - can write directly with padding */
-            uint8_t page_buffer[256];
-            memset(page_buffer, 0xFF, 256);  /* Fill with erased state */
+/**
+ * @brief Bytes an uncompressed copy of the block occupies (data + CRC)
+ */
+static uint32_t plain_length(const NvM_BlockConfig_t *block, const Crc_Descriptor_t *crc)
+{
+    return (uint32_t)block->block_size + ((crc != NULL) ? crc->crc_size : 0U);
+}
 
-            /* Copy CRC to start of page */
-            memcpy(page_buffer, &crc, crc_size);
+/**
+ * @brief Build the stored image of a compressed copy
+ *
+ * @param image Output, EEPROM_BLOCK_SLOT_SIZE bytes
+ * @param used Header + payload + CRC bytes (before page padding)
+ * @return Page-rounded image size
+ */
+static uint32_t compressed_image(const NvM_BlockConfig_t *block, const uint8_t *data,
+                                 uint8_t *image, uint32_t *used)
+{
+    const Crc_Descriptor_t *crc = NvM_GetBlockCrc(block);
+    uint32_t crc_size = (crc != NULL) ? crc->crc_size : 0U;
+    uint16_t header;
+
+    /* Only a strictly smaller payload is worth decoding */
+    uint32_t length = RLE_Encode(data, block->block_size, &image[EEPROM_COMPRESSED_HEADER_SIZE],
+                                 (uint32_t)block->block_size - 1U);
+    if (length > 0U) {
+        header = (uint16_t)length;
+    } else {
+        length = block->block_size;
+        memcpy(&image[EEPROM_COMPRESSED_HEADER_SIZE], data, length);
+        header = (uint16_t)(length | NVM_COMPRESSED_RAW_FLAG);
+    }
+    image[0] = (uint8_t)header;
+    image[1] = (uint8_t)(header >> 8);
 
-            /* Write entire page */
-            if (MemIf_Write(crc_offset, page_buffer, 256) != E_OK) {
-                LOG_ERROR("NvM: CRC page write failed at offset 0x%X", offset);
-                return E_NOT_OK;
-            }
-        } else {
-            /* CRC is within data page - this shouldn't happen with slot layout */
-            LOG_ERROR("NvM: CRC at offset 0x%X is not page-aligned", crc_offset);
-            return E_NOT_OK;
+    *used = EEPROM_COMPRESSED_HEADER_SIZE + length + crc_size;
+    if (crc_size > 0U) {
+        CRC_Store(crc, crc->calculate(image, EEPROM_COMPRESSED_HEADER_SIZE + length),
+                  &image[EEPROM_COMPRESSED_HEADER_SIZE + length]);
+    }
+
+    uint32_t image_size = EEPROM_PAGE_ROUNDUP(*used);
+    memset(&image[*used], 0xFF, image_size - *used);  /* Padding stays erased */
+    return image_size;
+}
+
+/**
+ * @brief Read one compressed copy: header, then payload + CRC, decoded into data
+ */
+static boolean read_compressed(const NvM_BlockConfig_t *block, uint32_t offset, uint8_t *data)
+{
+    struct NvM_BlockTypesState *bt = block_types_state();
+    const Crc_Descriptor_t *crc = NvM_GetBlockCrc(block);
+    uint32_t crc_size = (crc != NULL) ? crc->crc_size : 0U;
+    uint8_t image[EEPROM_BLOCK_SLOT_SIZE];
+
+    if (MemIf_Read(offset, image, EEPROM_COMPRESSED_HEADER_SIZE) != E_OK) {
+        return FALSE;
+    }
+
+    uint16_t header = (uint16_t)(image[0] | ((uint16_t)image[1] << 8));
+    uint32_t length = header & NVM_COMPRESSED_LENGTH_MASK;
+    boolean raw = ((header & NVM_COMPRESSED_RAW_FLAG) != 0U) ? TRUE : FALSE;
+
+    if (raw ? (length != block->block_size) : (length == 0U || length >= block->block_size)) {
+        LOG_DEBUG("NvM: No compressed copy at offset 0x%X (header 0x%04X)", offset, header);
+        return FALSE;
+    }
+
+    if (MemIf_Read(offset + EEPROM_COMPRESSED_HEADER_SIZE, &image[EEPROM_COMPRESSED_HEADER_SIZE],
+                   length + crc_size) != E_OK) {
+        return FALSE;
+    }
+
+    if (crc_size > 0U) {
+        uint32_t stored_crc = CRC_Load(crc, &image[EEPROM_COMPRESSED_HEADER_SIZE + length]);
+        if (stored_crc != crc->calculate(image, EEPROM_COMPRESSED_HEADER_SIZE + length)) {
+            LOG_DEBUG("NvM: CRC failed on compressed copy at offset 0x%X", offset);
+            return FALSE;
         }
     }
 
+    if (raw) {
+        memcpy(data, &image[EEPROM_COMPRESSED_HEADER_SIZE], length);
+    } else if (RLE_Decode(&image[EEPROM_COMPRESSED_HEADER_SIZE], length,
+                          data, block->block_size) != E_OK) {
+        LOG_DEBUG("NvM: Compressed copy at offset 0x%X does not decode", offset);
+        return FALSE;
+    }
+
+    uint32_t stored = EEPROM_COMPRESSED_HEADER_SIZE + length + crc_size;
+    if (stored < plain_length(block, crc)) {
+        bt->compressed_bytes_saved += plain_length(block, crc) - stored;
+    }
+    return TRUE;
+}
+
+boolean NvM_ReadBlockCopy(const NvM_BlockConfig_t *block, uint32_t offset, uint8_t *data)
+{
+    if (block->compression != NVM_COMPRESSION_NONE) {
+        return read_compressed(block, offset, data);
+    }
+
+    return NvM_TryReadBlock(offset, data, block->block_size, NvM_GetBlockCrc(block));
+}
+
+Std_ReturnType NvM_ProgramBlockCopy(const NvM_BlockConfig_t *block, uint32_t offset,
+                                    const uint8_t *data)
+{
+    struct NvM_BlockTypesState *bt = block_types_state();
+
+    if (block->compression == NVM_COMPRESSION_NONE) {
+        return NvM_ProgramBlockWithCrc(offset, data, block->block_size, NvM_GetBlockCrc(block),
+                                       block->crc_placement);
+    }
+
+    uint8_t image[EEPROM_BLOCK_SLOT_SIZE];
+    uint32_t used;
+    uint32_t image_size = compressed_image(block, data, image, &used);
+
+    if (MemIf_Write(offset, image, image_size) != E_OK) {
+        LOG_ERROR("NvM: Write failed at offset 0x%X", offset);
+        return E_NOT_OK;
+    }
+
+    uint32_t plain_size = EEPROM_PAGE_ROUNDUP(plain_length(block, NvM_GetBlockCrc(block)));
+    if (image_size < plain_size) {
+        bt->compressed_bytes_saved += plain_size - image_size;
+    }
+    LOG_DEBUG("NvM: Block %d stored as %u of %u bytes at 0x%X",
+              block->block_id, used, plain_length(block, NvM_GetBlockCrc(block)), offset);
     return E_OK;
 }
 
+Std_ReturnType NvM_VerifyBlockCopy(const NvM_BlockConfig_t *block, uint32_t offset,
+                                   const uint8_t *data)
+{
+    if (block->compression == NVM_COMPRESSION_NONE) {
+        return MemIf_Verify(offset, data, block->block_size);
+    }
+
+    uint8_t image[EEPROM_BLOCK_SLOT_SIZE];
+    uint32_t used;
+    (void)compressed_image(block, data, image, &used);
+
+    return MemIf_Verify(offset, image, used);
+}
+
+void NvM_Compression_Reset(void)
+{
+    struct NvM_BlockTypesState *bt = block_types_state();
+
+    bt->compressed_bytes_saved = 0;
+}
+
+uint32_t NvM_Compression_GetBytesSaved(void)
+{
+    struct NvM_BlockTypesState *bt = block_types_state();
+
+    return bt->compressed_bytes_saved;
+}
+
+/**
+ * @brief Program a copy's stored image over its current content
+ *
+ * Data and CRC go out as one program so the device accepts or refuses
+ * the whole image; a refused program leaves the copy untouched.
+ *
+ * @return TRUE if the image was programmed
+ */
+static boolean program_in_place(uint32_t offset, const uint8_t *data, uint16_t size,
+                                const Crc_Descriptor_t *crc, NvM_CrcPlacementType_t placement)
+{
+    uint8_t image[EEPROM_BLOCK_SLOT_SIZE];
+
+    /* A separate CRC page needs page-multiple data (NvM_ProgramBlockWithCrc reports it) */
+    if (placement == NVM_CRC_PLACEMENT_PAGE && (size % EEPROM_LAYOUT_PAGE_SIZE) != 0U) {
+        return FALSE;
+    }
+
+    uint32_t image_size = NvM_BuildBlockImage(data, size, crc, image);
+    if (image_size == 0U) {
+        return FALSE;
+    }
+
+    return (MemIf_Write(offset, image, image_size) == E_OK) ? TRUE : FALSE;
+}
+
+Std_ReturnType NvM_UpdateBlockWithCrc(const NvM_BlockConfig_t *block, uint32_t offset,
+                                      const uint8_t *data)
+{
+    struct NvM_BlockTypesState *bt = block_types_state();
+    const Crc_Descriptor_t *crc = NvM_GetBlockCrc(block);
+
+    /* A compressed image changes shape with the data: always erase */
+    if (block->compression != NVM_COMPRESSION_NONE) {
+        if (MemIf_Erase(offset, block->block_size) != E_OK) {
+            LOG_ERROR("NvM: Erase failed at offset 0x%X", offset);
+            return E_NOT_OK;
+        }
+        return NvM_ProgramBlockCopy(block, offset, data);
+    }
+
+    if (block->bit_clear_update &&
+        (block->block_type == NVM_BLOCK_NATIVE || block->block_type == NVM_BLOCK_REDUNDANT) &&
+        Eep_GetProgramMode() == EEP_PROGRAM_BIT_CLEAR) {
+        if (program_in_place(offset, data, block->block_size, crc, block->crc_placement)) {
+            bt->bit_clear_updates++;
+            LOG_DEBUG("NvM: Block %d updated in place at 0x%X", block->block_id, offset);
+            return E_OK;
+        }
+        bt->bit_clear_fallbacks++;
+        LOG_DEBUG("NvM: Block %d update at 0x%X sets bits, erasing", block->block_id, offset);
+    }
+
+    return NvM_WriteBlockWithCrc(offset, data, block->block_size, crc, block->crc_placement);
+}
+
+void NvM_BitClear_Reset(void)
+{
+    struct NvM_BlockTypesState *bt = block_types_state();
+
+    bt->bit_clear_updates = 0;
+    bt->bit_clear_fallbacks = 0;
+}
+
+void NvM_BitClear_GetCounts(uint32_t *updates, uint32_t *fallbacks)
+{
+    struct NvM_BlockTypesState *bt = block_types_state();
+
+    *updates = bt->bit_clear_updates;
+    *fallbacks = bt->bit_clear_fallbacks;
+}
+
+/**
+ * @brief Fall back to the ROM default after every copy failed
+ *
+ * A rom_binding block read into its RAM mirror is bound instead: the
+ * default is not copied until NvM_GetWritableBlockData materializes it.
+ */
+static void load_rom_default(NvM_BlockConfig_t *block, void *data)
+{
+    if (block->rom_binding && data == block->ram_mirror_ptr &&
+        block->rom_block_size >= block->block_size) {
+        block->rom_bound = TRUE;
+        return;
+    }
+
+    memcpy(data, block->rom_block_ptr,
+           (block->rom_block_size < block->block_size) ? block->rom_block_size : block->block_size);
+}
+
 /**
  * @brief Read Native Block
  */
 Std_ReturnType NvM_ReadNativeBlock(NvM_BlockConfig_t *block, void *data)
 {
-    if (NvM_TryReadBlock(block->eeprom_offset, (uint8_t*)data,
-                        block->block_size, block->crc_type)) {
+    if (NvM_ReadBlockCopy(block, block->eeprom_offset, (uint8_t*)data)) {
         block->state = NVM_BLOCKSTATE_VALID;
         return E_OK;
     }
@@ -133,8 +491,7 @@ Std_ReturnType NvM_ReadNativeBlock(NvM_BlockConfig_t *block, void *data)
     /* CRC failed, try ROM fallback */
     if (block->rom_block_ptr != NULL && block->rom_block_size > 0) {
         LOG_WARN("NvM: NATIVE block %d CRC failed, loading ROM default", block->block_id);
-        memcpy(data, block->rom_block_ptr,
-               (block->rom_block_size < block->block_size) ? block->rom_block_size : block->block_size);
+        load_rom_default(block, data);
         block->state = NVM_BLOCKSTATE_INVALID;
         return E_NOT_OK;
     }
@@ -148,8 +505,7 @@ Std_ReturnType NvM_ReadNativeBlock(NvM_BlockConfig_t *block, void *data)
  */
 Std_ReturnType NvM_WriteNativeBlock(NvM_BlockConfig_t *block, const void *data)
 {
-    Std_ReturnType ret = NvM_WriteBlockWithCrc(block->eeprom_offset, (uint8_t*)data,
-                                               block->block_size, block->crc_type);
+    Std_ReturnType ret = NvM_UpdateBlockWithCrc(block, block->eeprom_offset, (const uint8_t*)data);
     if (ret == E_OK) {
         block->erase_count++;
         block->state = NVM_BLOCKSTATE_VALID;
@@ -167,8 +523,7 @@ Std_ReturnType NvM_ReadRedundantBlock(NvM_BlockConfig_t *block, void *data)
     LOG_DEBUG("NvM: Reading REDUNDANT block %d", block->block_id);
 
     /* Try primary copy */
-    if (NvM_TryReadBlock(block->eeprom_offset, (uint8_t*)data,
-                        block->block_size, block->crc_type)) {
+    if (NvM_ReadBlockCopy(block, block->eeprom_offset, (uint8_t*)data)) {
         LOG_INFO("NvM: REDUNDANT block %d primary copy OK", block->block_id);
         block->state = NVM_BLOCKSTATE_VALID;
         return E_OK;
@@ -176,8 +531,7 @@ Std_ReturnType NvM_ReadRedundantBlock(NvM_BlockConfig_t *block, void *data)
 
     /* Primary failed, try backup copy */
     LOG_WARN("NvM: REDUNDANT block %d primary failed, trying backup", block->block_id);
-    if (NvM_TryReadBlock(block->redundant_eeprom_offset, (uint8_t*)data,
-                        block->block_size, block->crc_type)) {
+    if (NvM_ReadBlockCopy(block, block->redundant_eeprom_offset, (uint8_t*)data)) {
         LOG_INFO("NvM: REDUNDANT block %d backup copy OK (recovered)", block->block_id);
         block->state = NVM_BLOCKSTATE_RECOVERED;
         return E_OK;
@@ -186,8 +540,7 @@ Std_ReturnType NvM_ReadRedundantBlock(NvM_BlockConfig_t *block, void *data)
     /* Both failed, try ROM fallback */
     if (block->rom_block_ptr != NULL && block->rom_block_size > 0) {
         LOG_ERROR("NvM: REDUNDANT block %d both copies failed, loading ROM default", block->block_id);
-        memcpy(data, block->rom_block_ptr,
-               (block->rom_block_size < block->block_size) ? block->rom_block_size : block->block_size);
+        load_rom_default(block, data);
         block->state = NVM_BLOCKSTATE_INVALID;
         return E_NOT_OK;
     }
@@ -205,26 +558,20 @@ Std_ReturnType NvM_WriteRedundantBlock(NvM_BlockConfig_t *block, const void *dat
     LOG_DEBUG("NvM: Writing REDUNDANT block %d", block->block_id);
 
     /* Write primary copy */
-    Std_ReturnType ret = NvM_WriteBlockWithCrc(block->eeprom_offset, (uint8_t*)data,
-                                               block->block_size, block->crc_type);
+    Std_ReturnType ret = NvM_UpdateBlockWithCrc(block, block->eeprom_offset, (const uint8_t*)data);
     if (ret != E_OK) {
         LOG_ERROR("NvM: REDUNDANT block %d primary write failed", block->block_id);
         return E_NOT_OK;
     }
 
-    /* Verify primary copy */
-    uint8_t verify_buffer[256];
-    if (block->block_size <= 256) {
-        if (!NvM_TryReadBlock(block->eeprom_offset, verify_buffer,
-                             block->block_size, block->crc_type)) {
-            LOG_ERROR("NvM: REDUNDANT block %d primary verification failed", block->block_id);
-            return E_NOT_OK;
-        }
+    /* Verify primary copy (device compare, any block size) */
+    if (NvM_VerifyBlockCopy(block, block->eeprom_offset, (const uint8_t*)data) != E_OK) {
+        LOG_ERROR("NvM: REDUNDANT block %d primary verification failed", block->block_id);
+        return E_NOT_OK;
     }
 
     /* Write backup copy */
-    ret = NvM_WriteBlockWithCrc(block->redundant_eeprom_offset, (uint8_t*)data,
-                               block->block_size, block->crc_type);
+    ret = NvM_UpdateBlockWithCrc(block, block->redundant_eeprom_offset, (const uint8_t*)data);
     if (ret != E_OK) {
         LOG_WARN("NvM: REDUNDANT block %d backup write failed (primary OK)", block->block_id);
         /* Continue anyway - primary is OK */
@@ -244,29 +591,182 @@ Std_ReturnType NvM_WriteRedundantBlock(NvM_BlockConfig_t *block, const void *dat
     return E_OK;
 }
 
+/**
+ * @brief Dataset slot header
+ *
+ * [0] magic  [1] block_id  [2] slot  [3] 0xFF  [4..7] sequence (LE)
+ * [8..9] CRC-16 of [0..7]. Programmed after data and CRC, so a slot whose
+ * write was cut short has no valid header.
+ */
+#define NVM_DATASET_HEADER_MAGIC 0x53U  /**< 'S'; erased pages read 0xFF */
+
+/**
+ * @brief TRUE if sequence a was written after sequence b (wraps)
+ */
+static boolean sequence_newer(uint32_t a, uint32_t b)
+{
+    return ((int32_t)(a - b) > 0) ? TRUE : FALSE;
+}
+
+/**
+ * @brief Read one slot header
+ */
+boolean NvM_ReadDatasetHeader(const NvM_BlockConfig_t *block, uint8_t index, uint32_t *sequence)
+{
+    uint8_t header[EEPROM_DATASET_HEADER_SIZE];
+    uint32_t offset = EEPROM_DatasetVersionOffset(block->eeprom_offset, index) +
+                      EEPROM_DATASET_HEADER_OFFSET;
+
+    if (MemIf_Read(offset, header, sizeof(header)) != E_OK) {
+        return FALSE;
+    }
+
+    uint16_t stored = (uint16_t)(header[8] | ((uint16_t)header[9] << 8));
+    if (header[0] != NVM_DATASET_HEADER_MAGIC || header[1] != block->block_id ||
+        header[2] != index || stored != CRC_CalculateCRC16(header, 8)) {
+        return FALSE;
+    }
+
+    *sequence = (uint32_t)header[4] | ((uint32_t)header[5] << 8) |
+                ((uint32_t)header[6] << 16) | ((uint32_t)header[7] << 24);
+    return TRUE;
+}
+
+/**
+ * @brief Read every slot header
+ *
+ * @param valid Per slot: header found
+ * @param sequence Per slot: its sequence
+ * @return Slot with the newest sequence, or dataset_count if none is valid
+ */
+static uint8_t read_dataset_headers(const NvM_BlockConfig_t *block, boolean *valid,
+                                    uint32_t *sequence)
+{
+    uint8_t newest = block->dataset_count;
+
+    for (uint8_t i = 0; i < block->dataset_count; i++) {
+        valid[i] = NvM_ReadDatasetHeader(block, i, &sequence[i]);
+        if (valid[i] && (newest == block->dataset_count ||
+                         sequence_newer(sequence[i], sequence[newest]))) {
+            newest = i;
+        }
+    }
+
+    return newest;
+}
+
+/**
+ * @brief Recover the newest dataset slot from the slot headers
+ */
+void NvM_ScanDatasetHeaders(NvM_BlockConfig_t *block)
+{
+    boolean valid[EEPROM_MAX_DATASET_COUNT];
+    uint32_t sequence[EEPROM_MAX_DATASET_COUNT];
+
+    if (block->block_type != NVM_BLOCK_DATASET || block->dataset_scanned) {
+        return;
+    }
+
+    uint8_t newest = read_dataset_headers(block, valid, sequence);
+    if (newest < block->dataset_count) {
+        block->active_dataset_index = newest;
+        block->dataset_sequence = sequence[newest];
+        LOG_DEBUG("NvM: DATASET block %d newest slot %u (sequence %u)",
+                  block->block_id, newest, sequence[newest]);
+    }
+    block->dataset_scanned = TRUE;
+}
+
+/**
+ * @brief Program the header of a freshly written slot
+ */
+Std_ReturnType NvM_WriteDatasetHeader(NvM_BlockConfig_t *block, uint8_t index)
+{
+    uint8_t page[EEPROM_LAYOUT_PAGE_SIZE];
+    uint32_t sequence = block->dataset_sequence + 1U;
+
+    memset(page, 0xFF, sizeof(page));
+    page[0] = NVM_DATASET_HEADER_MAGIC;
+    page[1] = block->block_id;
+    page[2] = index;
+    page[4] = (uint8_t)sequence;
+    page[5] = (uint8_t)(sequence >> 8);
+    page[6] = (uint8_t)(sequence >> 16);
+    page[7] = (uint8_t)(sequence >> 24);
+    uint16_t crc = CRC_CalculateCRC16(page, 8);
+    page[8] = (uint8_t)crc;
+    page[9] = (uint8_t)(crc >> 8);
+
+    if (MemIf_Write(EEPROM_DatasetVersionOffset(block->eeprom_offset, index) +
+                    EEPROM_DATASET_HEADER_OFFSET, page, sizeof(page)) != E_OK) {
+        LOG_ERROR("NvM: DATASET block %d header write failed at slot %u", block->block_id, index);
+        return E_NOT_OK;
+    }
+
+    block->dataset_sequence = sequence;
+    return E_OK;
+}
+
 /**
  * @brief Read Dataset Block
  */
 Std_ReturnType NvM_ReadDatasetBlock(NvM_BlockConfig_t *block, void *data)
 {
+    /* After registration: headers only, then one full read of the newest slot */
+    NvM_ScanDatasetHeaders(block);
+
     LOG_DEBUG("NvM: Reading DATASET block %d (active=%u/%u)",
               block->block_id, block->active_dataset_index, block->dataset_count);
 
-    /* Try active dataset first, then other versions */
-    for (uint8_t i = 0; i < block->dataset_count; i++) {
-        uint8_t dataset_index = (block->active_dataset_index + i) % block->dataset_count;
-        /* Use fixed slot size for each dataset version */
-        uint32_t offset = block->eeprom_offset + (dataset_index * EEPROM_BLOCK_SLOT_SIZE);
-
-        if (NvM_TryReadBlock(offset, (uint8_t*)data, block->block_size, block->crc_type)) {
-            if (i == 0) {
-                LOG_INFO("NvM: DATASET block %d version %u OK", block->block_id, dataset_index);
-                block->state = NVM_BLOCKSTATE_VALID;
-            } else {
-                LOG_WARN("NvM: DATASET block %d fell back to version %u", block->block_id, dataset_index);
-                block->state = NVM_BLOCKSTATE_RECOVERED;
-                block->active_dataset_index = dataset_index;
+    uint32_t offset = EEPROM_DatasetVersionOffset(block->eeprom_offset, block->active_dataset_index);
+    if (NvM_ReadBlockCopy(block, offset, (uint8_t*)data)) {
+        LOG_INFO("NvM: DATASET block %d version %u OK", block->block_id, block->active_dataset_index);
+        block->state = NVM_BLOCKSTATE_VALID;
+        return E_OK;
+    }
+
+    /* Fall back newest first among the slots with a header */
+    boolean pending[EEPROM_MAX_DATASET_COUNT];
+    boolean has_header[EEPROM_MAX_DATASET_COUNT];
+    uint32_t sequence[EEPROM_MAX_DATASET_COUNT];
+    (void)read_dataset_headers(block, has_header, sequence);
+    memcpy(pending, has_header, sizeof(pending));
+    pending[block->active_dataset_index] = FALSE;
+
+    for (;;) {
+        uint8_t newest = block->dataset_count;
+        for (uint8_t i = 0; i < block->dataset_count; i++) {
+            if (pending[i] && (newest == block->dataset_count ||
+                               sequence_newer(sequence[i], sequence[newest]))) {
+                newest = i;
             }
+        }
+        if (newest == block->dataset_count) {
+            break;
+        }
+        pending[newest] = FALSE;
+
+        offset = EEPROM_DatasetVersionOffset(block->eeprom_offset, newest);
+        if (NvM_ReadBlockCopy(block, offset, (uint8_t*)data)) {
+            LOG_WARN("NvM: DATASET block %d fell back to version %u", block->block_id, newest);
+            block->state = NVM_BLOCKSTATE_RECOVERED;
+            block->active_dataset_index = newest;
+            return E_OK;
+        }
+    }
+
+    /* Slots without a header (written before headers existed): round-robin */
+    for (uint8_t i = 1; i < block->dataset_count; i++) {
+        uint8_t dataset_index = (block->active_dataset_index + i) % block->dataset_count;
+        if (has_header[dataset_index]) {
+            continue;
+        }
+
+        offset = EEPROM_DatasetVersionOffset(block->eeprom_offset, dataset_index);
+        if (NvM_ReadBlockCopy(block, offset, (uint8_t*)data)) {
+            LOG_WARN("NvM: DATASET block %d fell back to version %u", block->block_id, dataset_index);
+            block->state = NVM_BLOCKSTATE_RECOVERED;
+            block->active_dataset_index = dataset_index;
             return E_OK;
         }
     }
@@ -274,8 +774,7 @@ Std_ReturnType NvM_ReadDatasetBlock(NvM_BlockConfig_t *block, void *data)
     /* All versions failed, try ROM fallback */
     if (block->rom_block_ptr != NULL && block->rom_block_size > 0) {
         LOG_ERROR("NvM: DATASET block %d all versions failed, loading ROM default", block->block_id);
-        memcpy(data, block->rom_block_ptr,
-               (block->rom_block_size < block->block_size) ? block->rom_block_size : block->block_size);
+        load_rom_default(block, data);
         block->state = NVM_BLOCKSTATE_INVALID;
         return E_NOT_OK;
     }
@@ -292,14 +791,26 @@ Std_ReturnType NvM_WriteDatasetBlock(NvM_BlockConfig_t *block, const void *data)
 {
     LOG_DEBUG("NvM: Writing DATASET block %d", block->block_id);
 
+    /* Never rotate onto the newest slot on the device */
+    NvM_ScanDatasetHeaders(block);
+
     /* Move to next dataset slot */
     uint8_t next_index = (block->active_dataset_index + 1) % block->dataset_count;
     /* Use fixed slot size for each dataset version */
     uint32_t offset = block->eeprom_offset + (next_index * EEPROM_BLOCK_SLOT_SIZE);
 
-    /* Write to new slot */
-    Std_ReturnType ret = NvM_WriteBlockWithCrc(offset, (uint8_t*)data,
-                                               block->block_size, block->crc_type);
+    /* Write to new slot (straight to programming if it was erased while idle) */
+    Std_ReturnType ret = E_NOT_OK;
+    if (NvM_PreErase_Take(block, next_index)) {
+        ret = NvM_ProgramBlockCopy(block, offset, (const uint8_t*)data);
+    }
+    if (ret != E_OK) {
+        ret = NvM_UpdateBlockWithCrc(block, offset, (const uint8_t*)data);
+    }
+    /* The header goes last: it makes the slot the newest one */
+    if (ret == E_OK) {
+        ret = NvM_WriteDatasetHeader(block, next_index);
+    }
     if (ret != E_OK) {
         LOG_ERROR("NvM: DATASET block %d write failed at slot %u", block->block_id, next_index);
         return E_NOT_OK;
@@ -315,3 +826,8 @@ Std_ReturnType NvM_WriteDatasetBlock(NvM_BlockConfig_t *block, const void *data)
 
     return E_OK;
 }
+
+const NvM_PartDesc_t NvM_BlockTypesPart = {
+    .size = sizeof(struct NvM_BlockTypesState),
+    .default_state = &g_default_state
+};
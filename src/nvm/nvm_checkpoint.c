@@ -0,0 +1,359 @@
+/**
+ * @file nvm_checkpoint.c
+ * @brief Clean-shutdown checkpoint for a fast ReadAll
+ *
+ * REQ-ReadAll启动加速: design/02-NvM架构设计.md §3
+ * - WriteAll全部成功后写入检查点: 每个Block的ID、槽位、版本号与数据CRC, 以及clean标志
+ * - 检查点之后的第一次Block写入先编程"脏"标记页, 掉电后检查点即失效
+ * - ReadAll时检查点只校验一次; 所有匹配Block的数据以一个向量读取 (MemIf_ReadV) 载入, 不再重算CRC、不探测备份副本
+ * - 检查点无效 (非正常关机) 时退回逐Block完整读取
+ *
+ * Region (one 1 KB erase unit):
+ *   [0..767]   record: [0] 'K' [1] version [2] flags [3] entries [4..7] sequence
+ *              entries of 20 bytes, then CRC-32 of header and entries
+ *   [768..1023] dirty marker page: erased while the record is current
+ * Entry: [0] block_id [1] type [2] slot [3] version [4..5] size [6] flags
+ *        [7] 0xFF [8..11] eeprom_offset [12..15] dataset sequence [16..19] data CRC-32
+ */
+
+#include "nvm.h"
+#include "nvm_internal.h"
+#include "nvm_block_types.h"
+#include "eeprom_layout.h"
+#include "memif.h"
+#include "crc.h"
+#include "logging.h"
+#include <string.h>
+
+#define NVM_CHECKPOINT_MAGIC        0x4BU   /**< 'K'; erased pages read 0xFF */
+#define NVM_CHECKPOINT_VERSION      1U
+#define NVM_CHECKPOINT_CLEAN        0x01U   /**< Written by a WriteAll that stored every block */
+#define NVM_CHECKPOINT_HEADER_SIZE  8U
+#define NVM_CHECKPOINT_ENTRY_SIZE   20U
+#define NVM_CHECKPOINT_RECORD_SIZE  (EEPROM_BLOCK_SLOT_SIZE - EEPROM_LAYOUT_PAGE_SIZE)
+#define NVM_CHECKPOINT_MARKER       NVM_CHECKPOINT_RECORD_SIZE
+
+/**
+ * @brief Entry flag: the dataset sequence field is valid
+ */
+#define NVM_CHECKPOINT_ENTRY_SEQUENCE 0x01U
+
+typedef struct {
+    uint8_t block_id;
+    uint8_t type;
+    uint8_t slot;
+    uint8_t version;
+    uint16_t size;
+    uint8_t flags;
+    uint32_t offset;
+    uint32_t sequence;
+    uint32_t data_crc;
+    boolean prefetched;            /**< Data already in the RAM mirror (NvM_Checkpoint_Prefetch) */
+} NvM_CheckpointEntry_t;
+
+struct NvM_CheckpointState {
+    boolean configured;
+    boolean armed;                  /**< A clean record is current and the marker is erased */
+    uint32_t base;
+    uint32_t sequence;              /**< Sequence of the last record read or written */
+    uint8_t count;
+    NvM_CheckpointEntry_t entries[NVM_CHECKPOINT_MAX_BLOCKS];
+    uint32_t loaded;
+    uint32_t writes;
+};
+
+/**
+ * @brief State used while no context is bound
+ */
+static struct NvM_CheckpointState g_default_state;
+
+static struct NvM_CheckpointState* checkpoint_state(void)
+{
+    return (struct NvM_CheckpointState *)NvM_PartState(NVM_PART_CHECKPOINT);
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Read and validate the record, then check the marker
+ *
+ * @return TRUE if a clean, current record was loaded into the table
+ */
+static boolean load_record(void)
+{
+    struct NvM_CheckpointState *cp = checkpoint_state();
+    uint8_t record[NVM_CHECKPOINT_RECORD_SIZE];
+    uint8_t marker[4];
+
+    if (MemIf_Read(cp->base, record, NVM_CHECKPOINT_HEADER_SIZE) != E_OK ||
+        record[0] != NVM_CHECKPOINT_MAGIC || record[1] != NVM_CHECKPOINT_VERSION ||
+        (record[2] & NVM_CHECKPOINT_CLEAN) == 0U || record[3] > NVM_CHECKPOINT_MAX_BLOCKS) {
+        return FALSE;
+    }
+
+    uint32_t body = NVM_CHECKPOINT_HEADER_SIZE + (uint32_t)record[3] * NVM_CHECKPOINT_ENTRY_SIZE;
+    if (MemIf_Read(cp->base + NVM_CHECKPOINT_HEADER_SIZE, &record[NVM_CHECKPOINT_HEADER_SIZE],
+                   body + 4U - NVM_CHECKPOINT_HEADER_SIZE) != E_OK ||
+        get_u32(&record[body]) != CRC_CalculateCRC32(record, body)) {
+        LOG_WARN("NvM: Checkpoint record at 0x%X is corrupt", cp->base);
+        return FALSE;
+    }
+
+    /* A write after the checkpoint programmed the marker first */
+    if (MemIf_Read(cp->base + NVM_CHECKPOINT_MARKER, marker, sizeof(marker)) != E_OK ||
+        get_u32(marker) != 0xFFFFFFFFU) {
+        LOG_INFO("NvM: Checkpoint at 0x%X is stale (written after)", cp->base);
+        return FALSE;
+    }
+
+    cp->count = record[3];
+    cp->sequence = get_u32(&record[4]);
+    for (uint8_t i = 0; i < cp->count; i++) {
+        const uint8_t *p = &record[NVM_CHECKPOINT_HEADER_SIZE + (uint32_t)i * NVM_CHECKPOINT_ENTRY_SIZE];
+        NvM_CheckpointEntry_t *e = &cp->entries[i];
+        e->block_id = p[0];
+        e->type = p[1];
+        e->slot = p[2];
+        e->version = p[3];
+        e->size = (uint16_t)(p[4] | ((uint16_t)p[5] << 8));
+        e->flags = p[6];
+        e->offset = get_u32(&p[8]);
+        e->sequence = get_u32(&p[12]);
+        e->data_crc = get_u32(&p[16]);
+        e->prefetched = FALSE;
+    }
+    return TRUE;
+}
+
+void NvM_Checkpoint_Reset(void)
+{
+    memset(checkpoint_state(), 0, sizeof(struct NvM_CheckpointState));
+}
+
+Std_ReturnType NvM_SetCheckpointRegion(uint32_t offset)
+{
+    struct NvM_CheckpointState *cp = checkpoint_state();
+
+    if (!EEPROM_IS_SLOT_ALIGNED(offset)) {
+        LOG_ERROR("NvM: Invalid checkpoint region 0x%X", offset);
+        return E_NOT_OK;
+    }
+
+    uint32_t loaded = cp->loaded;
+    uint32_t writes = cp->writes;
+    NvM_Checkpoint_Reset();
+    cp->loaded = loaded;
+    cp->writes = writes;
+    cp->base = offset;
+    cp->configured = TRUE;
+    cp->armed = load_record();
+
+    LOG_INFO("NvM: Checkpoint region 0x%X (%s, %u blocks)", offset,
+             cp->armed ? "clean" : "none", cp->count);
+    return E_OK;
+}
+
+boolean NvM_Checkpoint_IsClean(void)
+{
+    struct NvM_CheckpointState *cp = checkpoint_state();
+
+    return cp->armed;
+}
+
+/**
+ * @brief Entry describing the block as registered now
+ *
+ * @param offset Receives the device offset of the active copy
+ * @return Entry, or NULL if the block must take the full read path
+ */
+static NvM_CheckpointEntry_t* find_entry(const NvM_BlockConfig_t *block, uint32_t *offset)
+{
+    struct NvM_CheckpointState *cp = checkpoint_state();
+
+    if (!cp->armed || block->ram_mirror_ptr == NULL) {
+        return NULL;
+    }
+
+    for (uint8_t i = 0; i < cp->count; i++) {
+        NvM_CheckpointEntry_t *e = &cp->entries[i];
+        if (e->block_id != block->block_id) {
+            continue;
+        }
+
+        /* Reconfigured since the checkpoint: the full read decides */
+        if (e->type != (uint8_t)block->block_type || e->size != block->block_size ||
+            e->offset != block->eeprom_offset || block->compression != NVM_COMPRESSION_NONE ||
+            (block->block_type == NVM_BLOCK_DATASET && e->slot >= block->dataset_count)) {
+            return NULL;
+        }
+
+        *offset = (block->block_type == NVM_BLOCK_DATASET)
+                      ? EEPROM_DatasetVersionOffset(block->eeprom_offset, e->slot)
+                      : block->eeprom_offset;
+        return e;
+    }
+
+    return NULL;
+}
+
+void NvM_Checkpoint_Prefetch(void)
+{
+    MemIf_IoVec_t iov[NVM_CHECKPOINT_MAX_BLOCKS];
+    NvM_CheckpointEntry_t *entries[NVM_CHECKPOINT_MAX_BLOCKS];
+    NvM_BlockConfig_t *blocks = NvM_Registry_Blocks();
+    uint16_t registered = NvM_Registry_Count();
+    uint32_t count = 0;
+
+    for (uint16_t i = 0; i < registered && count < NVM_CHECKPOINT_MAX_BLOCKS; i++) {
+        uint32_t offset;
+        NvM_CheckpointEntry_t *e = find_entry(&blocks[i], &offset);
+        if (e == NULL) {
+            continue;
+        }
+        iov[count].address = offset;
+        iov[count].buffer = blocks[i].ram_mirror_ptr;
+        iov[count].length = blocks[i].block_size;
+        entries[count++] = e;
+    }
+
+    /* Every block's data in one request; on failure each block reads its own */
+    if (count == 0U || MemIf_ReadV(iov, count) != E_OK) {
+        return;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        entries[i]->prefetched = TRUE;
+    }
+}
+
+boolean NvM_Checkpoint_ReadBlock(NvM_BlockConfig_t *block, uint32_t *data_crc)
+{
+    struct NvM_CheckpointState *cp = checkpoint_state();
+    uint32_t offset;
+    NvM_CheckpointEntry_t *e = find_entry(block, &offset);
+
+    if (e == NULL) {
+        return FALSE;
+    }
+
+    if (!e->prefetched &&
+        MemIf_Read(offset, (uint8_t *)block->ram_mirror_ptr, block->block_size) != E_OK) {
+        return FALSE;
+    }
+    e->prefetched = FALSE;
+
+    if (block->block_type == NVM_BLOCK_DATASET) {
+        block->active_dataset_index = e->slot;
+        if ((e->flags & NVM_CHECKPOINT_ENTRY_SEQUENCE) != 0U) {
+            block->dataset_sequence = e->sequence;
+            block->dataset_scanned = TRUE;
+        }
+    } else if (block->block_type == NVM_BLOCK_REDUNDANT) {
+        block->active_version = e->version;
+    }
+    block->state = NVM_BLOCKSTATE_VALID;
+    *data_crc = e->data_crc;
+    cp->loaded++;
+    return TRUE;
+}
+
+void NvM_Checkpoint_Invalidate(void)
+{
+    struct NvM_CheckpointState *cp = checkpoint_state();
+    uint8_t page[EEPROM_LAYOUT_PAGE_SIZE];
+
+    if (!cp->armed) {
+        return;
+    }
+
+    /* Before the first byte of block data changes */
+    memset(page, 0x00, sizeof(page));
+    if (MemIf_Write(cp->base + NVM_CHECKPOINT_MARKER, page, sizeof(page)) != E_OK) {
+        LOG_WARN("NvM: Checkpoint marker write failed, erasing the record");
+        (void)MemIf_Erase(cp->base, EEPROM_BLOCK_SLOT_SIZE);
+    }
+    cp->armed = FALSE;
+}
+
+Std_ReturnType NvM_Checkpoint_Commit(void)
+{
+    struct NvM_CheckpointState *cp = checkpoint_state();
+    uint8_t record[NVM_CHECKPOINT_RECORD_SIZE];
+    NvM_BlockConfig_t *blocks = NvM_Registry_Blocks();
+    uint16_t registered = NvM_Registry_Count();
+    uint8_t count = 0;
+
+    /* Nothing was written since the current record */
+    if (!cp->configured || cp->armed) {
+        return E_OK;
+    }
+
+    memset(record, 0xFF, sizeof(record));
+    for (uint16_t i = 0; i < registered && count < NVM_CHECKPOINT_MAX_BLOCKS; i++) {
+        const NvM_BlockConfig_t *block = &blocks[i];
+
+        /* Only device copies known to hold persisted_crc, read back in one piece */
+        if (block->block_type == NVM_BLOCK_LOG || block->compression != NVM_COMPRESSION_NONE ||
+            !block->persisted_valid || block->state != NVM_BLOCKSTATE_VALID) {
+            continue;
+        }
+
+        uint8_t *p = &record[NVM_CHECKPOINT_HEADER_SIZE + (uint32_t)count * NVM_CHECKPOINT_ENTRY_SIZE];
+        p[0] = block->block_id;
+        p[1] = (uint8_t)block->block_type;
+        p[2] = block->active_dataset_index;
+        p[3] = block->active_version;
+        p[4] = (uint8_t)block->block_size;
+        p[5] = (uint8_t)(block->block_size >> 8);
+        p[6] = block->dataset_scanned ? NVM_CHECKPOINT_ENTRY_SEQUENCE : 0U;
+        put_u32(&p[8], block->eeprom_offset);
+        put_u32(&p[12], block->dataset_sequence);
+        put_u32(&p[16], block->persisted_crc);
+        count++;
+    }
+
+    uint32_t body = NVM_CHECKPOINT_HEADER_SIZE + (uint32_t)count * NVM_CHECKPOINT_ENTRY_SIZE;
+    record[0] = NVM_CHECKPOINT_MAGIC;
+    record[1] = NVM_CHECKPOINT_VERSION;
+    record[2] = NVM_CHECKPOINT_CLEAN;
+    record[3] = count;
+    put_u32(&record[4], cp->sequence + 1U);
+    put_u32(&record[body], CRC_CalculateCRC32(record, body));
+
+    if (MemIf_Erase(cp->base, EEPROM_BLOCK_SLOT_SIZE) != E_OK ||
+        MemIf_Write(cp->base, record, EEPROM_PAGE_ROUNDUP(body + 4U)) != E_OK) {
+        LOG_ERROR("NvM: Checkpoint write failed at 0x%X", cp->base);
+        return E_NOT_OK;
+    }
+
+    cp->sequence++;
+    cp->writes++;
+    /* The table is only consulted at ReadAll; reload it from the device then */
+    cp->armed = load_record();
+
+    LOG_INFO("NvM: Checkpoint of %u blocks written at 0x%X", count, cp->base);
+    return cp->armed ? E_OK : E_NOT_OK;
+}
+
+void NvM_Checkpoint_GetCounts(uint32_t *loaded, uint32_t *writes)
+{
+    struct NvM_CheckpointState *cp = checkpoint_state();
+
+    *loaded = cp->loaded;
+    *writes = cp->writes;
+}
+
+const NvM_PartDesc_t NvM_CheckpointPart = {
+    .size = sizeof(struct NvM_CheckpointState),
+    .default_state = &g_default_state
+};
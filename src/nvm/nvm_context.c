@@ -0,0 +1,102 @@
+/**
+ * @file nvm_context.c
+ * @brief NvM instance contexts
+ *
+ * REQ-多实例: design/07-系统测试与故障场景.md §2
+ * - 每个NvM翻译单元的状态为一个部件, 上下文为全部部件的集合
+ * - 未绑定上下文时各文件使用自己的静态默认部件 (单实例行为不变)
+ * - 进程级状态不属于上下文: RCU读者槽与纪元, 日志, 指标, 时间线
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include "nvm.h"
+#include "nvm_internal.h"
+#include "sim_context.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Part alignment (submit ring and mirror arenas keep cache-line members)
+ */
+#define NVM_PART_ALIGN 64U
+
+struct NvM_Context {
+    void *parts[NVM_PART_COUNT];
+};
+
+static const NvM_PartDesc_t *const g_parts[NVM_PART_COUNT] = {
+    [NVM_PART_CORE] = &NvM_CorePart,
+    [NVM_PART_BATCH] = &NvM_BatchPart,
+    [NVM_PART_BLOCK_TYPES] = &NvM_BlockTypesPart,
+    [NVM_PART_CHECKPOINT] = &NvM_CheckpointPart,
+    [NVM_PART_DEFAULTS] = &NvM_DefaultsPart,
+    [NVM_PART_JOBQUEUE] = &NvM_JobQueuePart,
+    [NVM_PART_LANES] = &NvM_LanesPart,
+    [NVM_PART_LOG] = &NvM_LogPart,
+    [NVM_PART_PREERASE] = &NvM_PreErasePart,
+    [NVM_PART_READALL] = &NvM_ReadAllPart,
+    [NVM_PART_REGISTRY] = &NvM_RegistryPart,
+    [NVM_PART_RETRY] = &NvM_RetryPart,
+    [NVM_PART_SHM] = &NvM_ShmPart,
+    [NVM_PART_SUBMIT] = &NvM_SubmitPart,
+    [NVM_PART_WAIT] = &NvM_WaitPart,
+    [NVM_PART_MIRROR_RCU] = &NvM_MirrorRcuPart,
+    [NVM_PART_MIRROR_SEQLOCK] = &NvM_MirrorSeqlockPart
+};
+
+void* NvM_PartState(NvM_ContextPart_t part)
+{
+    NvM_Context_t *ctx = (NvM_Context_t *)SimContext_Get(SIM_CONTEXT_NVM);
+
+    return (ctx != NULL) ? ctx->parts[part] : g_parts[part]->default_state;
+}
+
+NvM_Context_t* NvM_CreateContext(void)
+{
+    NvM_Context_t *ctx = (NvM_Context_t *)calloc(1, sizeof(NvM_Context_t));
+
+    if (ctx == NULL) {
+        return NULL;
+    }
+
+    for (uint32_t p = 0; p < NVM_PART_COUNT; p++) {
+        if (posix_memalign(&ctx->parts[p], NVM_PART_ALIGN, g_parts[p]->size) != 0) {
+            ctx->parts[p] = NULL;
+            NvM_DestroyContext(ctx);
+            return NULL;
+        }
+        memset(ctx->parts[p], 0, g_parts[p]->size);
+        if (g_parts[p]->init != NULL) {
+            g_parts[p]->init(ctx->parts[p]);
+        }
+    }
+
+    return ctx;
+}
+
+void NvM_DestroyContext(NvM_Context_t *ctx)
+{
+    if (ctx == NULL) {
+        return;
+    }
+
+    /* Release in reverse order with the context bound: parts may call back into NvM */
+    NvM_Context_t *previous = NvM_BindContext(ctx);
+    for (uint32_t p = NVM_PART_COUNT; p-- > 0U;) {
+        if (ctx->parts[p] != NULL && g_parts[p]->release != NULL) {
+            g_parts[p]->release(ctx->parts[p]);
+        }
+    }
+    (void)NvM_BindContext(previous);
+
+    for (uint32_t p = 0; p < NVM_PART_COUNT; p++) {
+        free(ctx->parts[p]);
+    }
+    free(ctx);
+}
+
+NvM_Context_t* NvM_BindContext(NvM_Context_t *ctx)
+{
+    return (NvM_Context_t *)SimContext_Bind(SIM_CONTEXT_NVM, ctx);
+}
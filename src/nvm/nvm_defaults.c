@@ -0,0 +1,224 @@
+/**
+ * @file nvm_defaults.c
+ * @brief First-boot programming of ROM defaults, grouped by erase unit (NvM_WriteRomDefaults)
+ *
+ * REQ-Block管理: design/03-Block管理机制.md §2
+ * - 所有Block的副本按eeprom_offset排序, 每个擦除单元只处理一次
+ * - 擦除前用MemIf_Verify比对全0xFF: 空白单元 (新器件) 不再擦除
+ * - 直接从rom_block_ptr编程, 不经RAM镜像; Dataset序列头最后写入
+ * - 单个Block失败不影响其余Block, 失败Block保持INVALID
+ */
+
+#include "nvm.h"
+#include "nvm_internal.h"
+#include "nvm_block_types.h"
+#include "eeprom_layout.h"
+#include "eeprom_driver.h"
+#include "memif.h"
+#include "logging.h"
+#include <string.h>
+
+/**
+ * @brief Device copies one pass may program (REDUNDANT blocks have two)
+ */
+#define NVM_ROM_MAX_TARGETS (NVM_MAX_BLOCKS * 2U)
+
+/**
+ * @brief One device copy of a block
+ */
+typedef struct {
+    NvM_BlockConfig_t *block;
+    uint16_t index;                 /**< Position in the caller's block list */
+    uint32_t offset;                /**< Slot start */
+} NvM_RomTarget_t;
+
+/**
+ * @brief ROM default pass working set of one context
+ */
+struct NvM_DefaultsState {
+    NvM_RomTarget_t targets[NVM_ROM_MAX_TARGETS];
+    uint8_t blank[EEPROM_BLOCK_SLOT_SIZE];
+};
+
+/**
+ * @brief State used while no context is bound
+ */
+static struct NvM_DefaultsState g_default_state;
+
+static struct NvM_DefaultsState* defaults_state(void)
+{
+    return (struct NvM_DefaultsState *)NvM_PartState(NVM_PART_DEFAULTS);
+}
+
+/**
+ * @brief Dataset slot the defaults go to (the one a write would use next)
+ */
+static uint8_t dataset_next_index(const NvM_BlockConfig_t *block)
+{
+    return (uint8_t)((block->active_dataset_index + 1U) % block->dataset_count);
+}
+
+static void add_target(uint16_t *count, NvM_BlockConfig_t *block, uint16_t index, uint32_t offset)
+{
+    struct NvM_DefaultsState *ds = defaults_state();
+
+    ds->targets[*count].block = block;
+    ds->targets[*count].index = index;
+    ds->targets[*count].offset = offset;
+    (*count)++;
+}
+
+/**
+ * @brief Build the copy list in ascending offset order
+ */
+static uint16_t plan_targets(NvM_BlockConfig_t *const *blocks, uint16_t n, boolean *written)
+{
+    struct NvM_DefaultsState *ds = defaults_state();
+    uint16_t count = 0;
+
+    for (uint16_t i = 0; i < n; i++) {
+        NvM_BlockConfig_t *block = blocks[i];
+        written[i] = TRUE;
+
+        switch (block->block_type) {
+            case NVM_BLOCK_NATIVE:
+                add_target(&count, block, i, block->eeprom_offset);
+                break;
+
+            case NVM_BLOCK_REDUNDANT:
+                add_target(&count, block, i, block->eeprom_offset);
+                add_target(&count, block, i, block->redundant_eeprom_offset);
+                break;
+
+            case NVM_BLOCK_DATASET:
+                /* Never rotate onto the newest slot on the device */
+                NvM_ScanDatasetHeaders(block);
+                add_target(&count, block, i,
+                           EEPROM_DatasetVersionOffset(block->eeprom_offset, dataset_next_index(block)));
+                /* The slot changes: a background erase of it no longer counts */
+                (void)NvM_PreErase_Take(block, dataset_next_index(block));
+                break;
+
+            default:
+                LOG_ERROR("NvM: ROM defaults - block %d type %d not supported",
+                          block->block_id, block->block_type);
+                written[i] = FALSE;
+                break;
+        }
+    }
+
+    /* Insertion sort by offset: mostly registered in layout order already */
+    for (uint16_t i = 1; i < count; i++) {
+        NvM_RomTarget_t t = ds->targets[i];
+        uint16_t j = i;
+        while (j > 0U && ds->targets[j - 1U].offset > t.offset) {
+            ds->targets[j] = ds->targets[j - 1U];
+            j--;
+        }
+        ds->targets[j] = t;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Erase the units of one slot that are not blank already
+ */
+static Std_ReturnType erase_slot(uint32_t slot, uint32_t unit, uint32_t *erases_skipped)
+{
+    struct NvM_DefaultsState *ds = defaults_state();
+
+    for (uint32_t address = slot; address < slot + EEPROM_BLOCK_SLOT_SIZE; address += unit) {
+        /* Compared in the driver: far cheaper than an erase cycle */
+        if (MemIf_Verify(address, ds->blank, unit) == E_OK) {
+            (*erases_skipped)++;
+            continue;
+        }
+        if (MemIf_Erase(address, unit) != E_OK) {
+            return E_NOT_OK;
+        }
+    }
+    return E_OK;
+}
+
+/**
+ * @brief Apply the per-type metadata of a written block
+ */
+static void commit_block(NvM_BlockConfig_t *block)
+{
+    switch (block->block_type) {
+        case NVM_BLOCK_REDUNDANT:
+            block->active_version++;
+            if (block->version_control_offset > 0) {
+                MemIf_Write(block->version_control_offset, &block->active_version, 1);
+            }
+            break;
+
+        case NVM_BLOCK_DATASET:
+            block->active_dataset_index = dataset_next_index(block);
+            break;
+
+        default:
+            break;
+    }
+
+    block->erase_count++;
+    block->state = NVM_BLOCKSTATE_VALID;
+}
+
+Std_ReturnType NvM_RomDefaults_Execute(NvM_BlockConfig_t *const *blocks, uint16_t n,
+                                       boolean *written, uint32_t *erases_skipped)
+{
+    struct NvM_DefaultsState *ds = defaults_state();
+    const Eeprom_ConfigType *eep = Eep_GetConfig();
+    uint32_t unit = (eep != NULL && eep->block_size > 0U && eep->block_size <= EEPROM_BLOCK_SLOT_SIZE)
+                        ? eep->block_size : EEPROM_BLOCK_SLOT_SIZE;
+    uint16_t count = plan_targets(blocks, n, written);
+    Std_ReturnType ret = E_OK;
+
+    memset(ds->blank, 0xFF, sizeof(ds->blank));
+
+    /* Each erase unit once, in ascending order */
+    for (uint16_t i = 0; i < count; i++) {
+        NvM_RomTarget_t *t = &ds->targets[i];
+        if (written[t->index] && erase_slot(t->offset, unit, erases_skipped) != E_OK) {
+            LOG_ERROR("NvM: ROM defaults - block %d cannot erase 0x%X", t->block->block_id, t->offset);
+            written[t->index] = FALSE;
+        }
+    }
+
+    for (uint16_t i = 0; i < count; i++) {
+        NvM_RomTarget_t *t = &ds->targets[i];
+        if (written[t->index] &&
+            NvM_ProgramBlockCopy(t->block, t->offset, t->block->rom_block_ptr) != E_OK) {
+            LOG_ERROR("NvM: ROM defaults - block %d write failed at 0x%X", t->block->block_id, t->offset);
+            written[t->index] = FALSE;
+        }
+    }
+
+    /* Dataset headers last, so a partial pass never outranks the old slots */
+    for (uint16_t i = 0; i < count; i++) {
+        NvM_RomTarget_t *t = &ds->targets[i];
+        if (written[t->index] && t->block->block_type == NVM_BLOCK_DATASET &&
+            NvM_WriteDatasetHeader(t->block, dataset_next_index(t->block)) != E_OK) {
+            LOG_ERROR("NvM: ROM defaults - block %d header write failed", t->block->block_id);
+            written[t->index] = FALSE;
+        }
+    }
+
+    for (uint16_t i = 0; i < n; i++) {
+        if (written[i]) {
+            commit_block(blocks[i]);
+        } else {
+            blocks[i]->state = NVM_BLOCKSTATE_INVALID;
+            ret = E_NOT_OK;
+        }
+    }
+
+    return ret;
+}
+
+const NvM_PartDesc_t NvM_DefaultsPart = {
+    .size = sizeof(struct NvM_DefaultsState),
+    .default_state = &g_default_state
+};
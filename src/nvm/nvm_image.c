@@ -0,0 +1,246 @@
+/**
+ * @file nvm_image.c
+ * @brief Offline EEPROM image building and inspection
+ *
+ * REQ-Block管理: design/03-Block管理机制.md §2
+ * - 布局先整体校验 (单Block规则 + 槽位互不重叠), 校验通过才开始编程
+ * - 副本编程与Dataset序列头沿用nvm_block_types.c, 保证与NvM读写的格式一致
+ * - 擦写计数按擦除单元补足到配置值 (构建自身的一次擦除计入其中)
+ */
+
+#include "nvm_image.h"
+#include "nvm_block_types.h"
+#include "eeprom_driver.h"
+#include "memif.h"
+#include "logging.h"
+#include <string.h>
+
+/**
+ * @brief Slots of a block (primary first, then backup or dataset slots)
+ *
+ * @return Number of slots
+ */
+static uint8_t block_slots(const NvM_BlockConfig_t *config, uint32_t *slots)
+{
+    switch (config->block_type) {
+        case NVM_BLOCK_REDUNDANT:
+            slots[0] = config->eeprom_offset;
+            slots[1] = config->redundant_eeprom_offset;
+            return 2U;
+
+        case NVM_BLOCK_DATASET:
+            for (uint8_t i = 0; i < config->dataset_count; i++) {
+                slots[i] = EEPROM_DatasetVersionOffset(config->eeprom_offset, i);
+            }
+            return config->dataset_count;
+
+        default:
+            slots[0] = config->eeprom_offset;
+            return 1U;
+    }
+}
+
+static boolean layout_valid(const NvM_ImageBlock_t *blocks, uint32_t count)
+{
+    uint32_t slots_a[EEPROM_MAX_DATASET_COUNT];
+    uint32_t slots_b[EEPROM_MAX_DATASET_COUNT];
+
+    for (uint32_t a = 0; a < count; a++) {
+        const NvM_ImageBlock_t *block = &blocks[a];
+        const NvM_BlockConfig_t *cfg = &block->config;
+
+        if (cfg->block_type == NVM_BLOCK_LOG || cfg->block_size == 0U ||
+            !EEPROM_ValidateBlockConfig(cfg)) {
+            LOG_ERROR("NvM Image: Block %d has an invalid layout", cfg->block_id);
+            return FALSE;
+        }
+        uint8_t versions = (block->version_count == 0U) ? 1U : block->version_count;
+        if (cfg->block_type == NVM_BLOCK_DATASET && versions > cfg->dataset_count) {
+            LOG_ERROR("NvM Image: Block %d has %u versions for %u slots", cfg->block_id,
+                      versions, cfg->dataset_count);
+            return FALSE;
+        }
+
+        /* Slots are whole; two blocks must not share one */
+        uint8_t n_a = block_slots(cfg, slots_a);
+        for (uint32_t b = 0; b < a; b++) {
+            if (blocks[b].config.block_id == cfg->block_id) {
+                LOG_ERROR("NvM Image: Block %d configured twice", cfg->block_id);
+                return FALSE;
+            }
+            uint8_t n_b = block_slots(&blocks[b].config, slots_b);
+            for (uint8_t i = 0; i < n_a; i++) {
+                for (uint8_t j = 0; j < n_b; j++) {
+                    if (slots_a[i] == slots_b[j]) {
+                        LOG_ERROR("NvM Image: Blocks %d and %d share the slot at 0x%X",
+                                  blocks[b].config.block_id, cfg->block_id, slots_a[i]);
+                        return FALSE;
+                    }
+                }
+            }
+        }
+    }
+    return TRUE;
+}
+
+/**
+ * @brief Raise the erase count of every erase unit of a slot to at least count
+ */
+static Std_ReturnType age_slot(uint32_t slot, uint32_t count)
+{
+    const Eeprom_ConfigType *eep = Eep_GetConfig();
+    uint32_t unit = (eep != NULL && eep->block_size > 0U) ? eep->block_size : EEPROM_BLOCK_SLOT_SIZE;
+
+    for (uint32_t address = slot; address < slot + EEPROM_BLOCK_SLOT_SIZE; address += unit) {
+        uint32_t current = 0U;
+        if (Eep_GetEraseCount(address, &current) != E_OK) {
+            return E_NOT_OK;
+        }
+        if (current < count && Eep_AddEraseCount(address, count - current) != E_OK) {
+            return E_NOT_OK;
+        }
+    }
+    return E_OK;
+}
+
+static Std_ReturnType build_block(const NvM_ImageBlock_t *block)
+{
+    /* Private copy: headers advance dataset_sequence */
+    NvM_BlockConfig_t cfg = block->config;
+    uint32_t slots[EEPROM_MAX_DATASET_COUNT];
+    uint8_t n = block_slots(&cfg, slots);
+    uint8_t versions = (block->version_count == 0U) ? 1U : block->version_count;
+
+    cfg.crc_desc = NULL;
+    cfg.dataset_sequence = 0U;
+
+    for (uint8_t i = 0; i < n; i++) {
+        if (MemIf_Erase(slots[i], EEPROM_BLOCK_SLOT_SIZE) != E_OK ||
+            age_slot(slots[i], block->erase_count) != E_OK) {
+            LOG_ERROR("NvM Image: Block %d cannot erase the slot at 0x%X", cfg.block_id, slots[i]);
+            return E_NOT_OK;
+        }
+    }
+
+    if (cfg.block_type != NVM_BLOCK_DATASET) {
+        /* Both copies of a REDUNDANT block hold the same data */
+        for (uint8_t i = 0; i < n; i++) {
+            if (block->data[0] == NULL ||
+                NvM_ProgramBlockCopy(&cfg, slots[i], block->data[0]) != E_OK) {
+                LOG_ERROR("NvM Image: Block %d copy %u not programmed", cfg.block_id, i);
+                return E_NOT_OK;
+            }
+        }
+        return E_OK;
+    }
+
+    /* Oldest first: the last version written gets the newest sequence */
+    for (uint8_t v = 0; v < versions; v++) {
+        if (block->data[v] == NULL || NvM_ProgramBlockCopy(&cfg, slots[v], block->data[v]) != E_OK ||
+            NvM_WriteDatasetHeader(&cfg, v) != E_OK) {
+            LOG_ERROR("NvM Image: Block %d version %u not programmed", cfg.block_id, v);
+            return E_NOT_OK;
+        }
+    }
+    return E_OK;
+}
+
+Std_ReturnType NvM_ImageBuild(const NvM_ImageBlock_t *blocks, uint32_t count)
+{
+    if (blocks == NULL || !layout_valid(blocks, count)) {
+        return E_NOT_OK;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (build_block(&blocks[i]) != E_OK) {
+            return E_NOT_OK;
+        }
+    }
+
+    LOG_INFO("NvM Image: %u blocks programmed", count);
+    return E_OK;
+}
+
+/**
+ * @brief DATASET slot NvM would read: newest good slot with a header, else a good one without
+ */
+static uint8_t select_dataset_slot(const NvM_ImageReport_t *report, const uint32_t *sequence)
+{
+    uint8_t selected = report->copies;
+
+    for (uint8_t i = 0; i < report->copies; i++) {
+        boolean good = ((report->valid_mask >> i) & 1U) != 0U;
+        boolean header = ((report->header_mask >> i) & 1U) != 0U;
+        if (good && header &&
+            (selected == report->copies || (int32_t)(sequence[i] - sequence[selected]) > 0)) {
+            selected = i;
+        }
+    }
+    for (uint8_t i = 0; i < report->copies && selected == report->copies; i++) {
+        if (((report->valid_mask >> i) & 1U) != 0U) {
+            selected = i;
+        }
+    }
+    return selected;
+}
+
+Std_ReturnType NvM_ImageInspectBlock(const NvM_BlockConfig_t *config, uint8_t *data,
+                                     NvM_ImageReport_t *report)
+{
+    uint8_t copy[EEPROM_MAX_DATASET_COUNT][EEPROM_BLOCK_SLOT_SIZE];
+    uint32_t slots[EEPROM_MAX_DATASET_COUNT];
+    uint32_t sequence[EEPROM_MAX_DATASET_COUNT];
+
+    if (config == NULL || report == NULL || config->block_type == NVM_BLOCK_LOG ||
+        config->block_size == 0U || !EEPROM_ValidateBlockConfig(config)) {
+        return E_NOT_OK;
+    }
+
+    memset(report, 0, sizeof(NvM_ImageReport_t));
+    report->block_id = config->block_id;
+    report->copies = block_slots(config, slots);
+
+    /* One read of every copy and header */
+    for (uint8_t i = 0; i < report->copies; i++) {
+        if (NvM_ReadBlockCopy(config, slots[i], copy[i])) {
+            report->valid_mask |= (uint8_t)(1U << i);
+        }
+        if (config->block_type == NVM_BLOCK_DATASET &&
+            NvM_ReadDatasetHeader(config, i, &sequence[i])) {
+            report->header_mask |= (uint8_t)(1U << i);
+        }
+
+        const Eeprom_ConfigType *eep = Eep_GetConfig();
+        uint32_t unit = (eep != NULL && eep->block_size > 0U) ? eep->block_size
+                                                              : EEPROM_BLOCK_SLOT_SIZE;
+        for (uint32_t address = slots[i]; address < slots[i] + EEPROM_BLOCK_SLOT_SIZE;
+             address += unit) {
+            uint32_t erases = 0U;
+            if (Eep_GetEraseCount(address, &erases) == E_OK && erases > report->erase_count) {
+                report->erase_count = erases;
+            }
+        }
+    }
+
+    uint8_t all = (uint8_t)((1U << report->copies) - 1U);
+    if (config->block_type == NVM_BLOCK_DATASET) {
+        report->selected = select_dataset_slot(report, sequence);
+        if (report->selected < report->copies &&
+            ((report->header_mask >> report->selected) & 1U) != 0U) {
+            report->sequence = sequence[report->selected];
+        }
+        report->valid = (report->header_mask != 0U &&
+                         (report->valid_mask & report->header_mask) == report->header_mask)
+                            ? TRUE : FALSE;
+    } else {
+        /* Primary first, as NvM reads it */
+        report->selected = ((report->valid_mask & 1U) != 0U) ? 0U
+                         : (report->valid_mask != 0U) ? 1U : report->copies;
+        report->valid = (report->valid_mask == all) ? TRUE : FALSE;
+    }
+
+    if (data != NULL && report->selected < report->copies) {
+        memcpy(data, copy[report->selected], config->block_size);
+    }
+    return report->valid ? E_OK : E_NOT_OK;
+}
@@ -0,0 +1,504 @@
+/**
+ * @file nvm_internal.h
+ * @brief NvM internal definitions shared between NvM translation units
+ *
+ * Not part of the public API.
+ */
+
+#ifndef NVM_INTERNAL_H
+#define NVM_INTERNAL_H
+
+#include "nvm.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Maximum number of registered blocks
+ *
+ * Every block ID except 0xFF (used by ReadAll/WriteAll jobs) can be
+ * registered; registry storage grows with the number actually used.
+ */
+#define NVM_MAX_BLOCKS 255
+
+/**
+ * @brief Registry slot marker for unregistered block IDs
+ */
+#define NVM_REGISTRY_NONE 0xFFU
+
+/**
+ * @brief Number of addressable block IDs (NvM_BlockIdType is 8-bit)
+ */
+#define NVM_BLOCK_ID_COUNT 256U
+
+/**
+ * @brief NvM translation units with per-context state
+ */
+typedef enum {
+    NVM_PART_CORE = 0,              /**< nvm.c */
+    NVM_PART_BATCH,                 /**< nvm_batch.c */
+    NVM_PART_BLOCK_TYPES,           /**< nvm_block_types.c */
+    NVM_PART_CHECKPOINT,            /**< nvm_checkpoint.c */
+    NVM_PART_DEFAULTS,              /**< nvm_defaults.c */
+    NVM_PART_JOBQUEUE,              /**< nvm_jobqueue.c */
+    NVM_PART_LANES,                 /**< nvm_lanes.c */
+    NVM_PART_LOG,                   /**< nvm_log.c */
+    NVM_PART_PREERASE,              /**< nvm_preerase.c */
+    NVM_PART_READALL,               /**< nvm_readall.c */
+    NVM_PART_REGISTRY,              /**< nvm_registry.c */
+    NVM_PART_RETRY,                 /**< nvm_retry.c */
+    NVM_PART_SHM,                   /**< nvm_shm.c */
+    NVM_PART_SUBMIT,                /**< nvm_submit.c */
+    NVM_PART_WAIT,                  /**< nvm_wait.c */
+    NVM_PART_MIRROR_RCU,            /**< ram_mirror_rcu.c */
+    NVM_PART_MIRROR_SEQLOCK,        /**< ram_mirror_seqlock.c */
+    NVM_PART_COUNT
+} NvM_ContextPart_t;
+
+/**
+ * @brief How a translation unit's state is created and released
+ */
+typedef struct {
+    size_t size;
+    void *default_state;            /**< The file's static instance (no context bound) */
+    void (*init)(void *state);      /**< Non-zero initial values of a new state (may be NULL) */
+    void (*release)(void *state);   /**< Free what a state owns, context bound (may be NULL) */
+} NvM_PartDesc_t;
+
+extern const NvM_PartDesc_t NvM_CorePart;
+extern const NvM_PartDesc_t NvM_BatchPart;
+extern const NvM_PartDesc_t NvM_BlockTypesPart;
+extern const NvM_PartDesc_t NvM_CheckpointPart;
+extern const NvM_PartDesc_t NvM_DefaultsPart;
+extern const NvM_PartDesc_t NvM_JobQueuePart;
+extern const NvM_PartDesc_t NvM_LanesPart;
+extern const NvM_PartDesc_t NvM_LogPart;
+extern const NvM_PartDesc_t NvM_PreErasePart;
+extern const NvM_PartDesc_t NvM_ReadAllPart;
+extern const NvM_PartDesc_t NvM_RegistryPart;
+extern const NvM_PartDesc_t NvM_RetryPart;
+extern const NvM_PartDesc_t NvM_ShmPart;
+extern const NvM_PartDesc_t NvM_SubmitPart;
+extern const NvM_PartDesc_t NvM_WaitPart;
+extern const NvM_PartDesc_t NvM_MirrorRcuPart;
+extern const NvM_PartDesc_t NvM_MirrorSeqlockPart;
+
+/**
+ * @brief A translation unit's state in the context bound on the calling thread
+ */
+void* NvM_PartState(NvM_ContextPart_t part);
+
+/**
+ * @brief Drop every registered block and release registry storage
+ */
+void NvM_Registry_Reset(void);
+
+/**
+ * @brief Register (or re-register) a block
+ *
+ * Slots are dense and stable until NvM_Registry_Reset, but the slot arrays
+ * may move when the registry grows: do not hold block pointers across
+ * registrations.
+ *
+ * @param block_config Configuration to copy
+ * @return Registry-owned configuration, or NULL if full / out of memory
+ */
+NvM_BlockConfig_t* NvM_Registry_Add(const NvM_BlockConfig_t *block_config);
+
+/**
+ * @brief Look up a block configuration by ID (O(1))
+ *
+ * @return Configuration, or NULL if the ID is not registered
+ */
+NvM_BlockConfig_t* NvM_Registry_Find(uint8_t block_id);
+
+/**
+ * @brief Number of registered blocks (slots 0..count-1)
+ */
+uint16_t NvM_Registry_Count(void);
+
+/**
+ * @brief Slot-indexed configuration array
+ */
+NvM_BlockConfig_t* NvM_Registry_Blocks(void);
+
+/**
+ * @brief Hot-field accessors by slot
+ */
+uint32_t NvM_Registry_Offset(uint16_t slot);
+uint8_t NvM_Registry_BlockId(uint16_t slot);
+
+/**
+ * @brief Publish a block's state to the hot table after a job
+ */
+void NvM_Registry_SyncState(const NvM_BlockConfig_t *block);
+
+/**
+ * @brief Get a block's state from the hot table
+ *
+ * @return E_NOT_OK if the ID is not registered
+ */
+Std_ReturnType NvM_Registry_GetState(uint8_t block_id, uint8_t *state);
+
+/**
+ * @brief Per-block completion of a pipelined ReadAll
+ *
+ * Called as soon as the block's RAM mirror holds its final content.
+ */
+typedef void (*NvM_ReadAllBlockDone_t)(NvM_BlockConfig_t *block, Std_ReturnType result);
+
+/**
+ * @brief Start a pipelined ReadAll over the registered blocks
+ *
+ * @param blocks Block table (must stay valid until the pass ends)
+ * @param count Number of blocks
+ * @param done Per-block completion
+ */
+void NvM_ReadAllPipeline_Start(NvM_BlockConfig_t *blocks, uint8_t count, NvM_ReadAllBlockDone_t done);
+
+/**
+ * @brief Advance the pipeline (drives MemIf_MainFunction)
+ *
+ * @return TRUE once every block has completed
+ */
+boolean NvM_ReadAllPipeline_Poll(void);
+
+/**
+ * @brief Abandon a running pipeline
+ */
+void NvM_ReadAllPipeline_Reset(void);
+
+/**
+ * @brief Completion of a job run on a device lane
+ *
+ * Called once the block's state and the caller's buffer are final.
+ *
+ * @param job The job as started
+ * @param start_ns Host time passed to NvM_Lanes_Start
+ * @param result Job result
+ */
+typedef void (*NvM_LaneJobDone_t)(const NvM_Job_t *job, uint64_t start_ns, Std_ReturnType result);
+
+/**
+ * @brief Free every device lane (NvM_Init)
+ */
+void NvM_Lanes_Reset(void);
+
+/**
+ * @brief TRUE if a lane can run the block's jobs now
+ *
+ * The block must suit the lanes (NATIVE, uncompressed, inline CRC) and
+ * the lane of its device must be free.
+ */
+boolean NvM_Lanes_Accepts(const NvM_BlockConfig_t *block);
+
+/**
+ * @brief TRUE unless a lane job is in flight on the block's device
+ */
+boolean NvM_Lanes_DeviceIdle(const NvM_BlockConfig_t *block);
+
+/**
+ * @brief TRUE when no lane job is in flight
+ */
+boolean NvM_Lanes_Idle(void);
+
+/**
+ * @brief Start a READ or WRITE job on its device's lane
+ *
+ * Only after NvM_Lanes_Accepts. The job completes through done as
+ * virtual time advances, across NvM_Lanes_Poll calls.
+ */
+void NvM_Lanes_Start(const NvM_Job_t *job, const NvM_BlockConfig_t *block, uint64_t start_ns,
+                     NvM_LaneJobDone_t done);
+
+/**
+ * @brief Advance the lanes (drives MemIf_MainFunction)
+ */
+void NvM_Lanes_Poll(void);
+
+/**
+ * @brief Program a batch of blocks as one all-or-nothing device commit
+ *
+ * Saves every live copy the batch overwrites, programs all copies in
+ * ascending offset order and only then updates the blocks' metadata
+ * (version, dataset index, state). If a copy fails, the copies already
+ * programmed are restored and no block is changed.
+ *
+ * @param blocks Registered blocks (distinct, not write-protected)
+ * @param bufs Data per block
+ * @param n Number of blocks (1..NVM_WRITE_BATCH_MAX_BLOCKS)
+ * @param restored Set FALSE if a failed batch could not be fully rolled back
+ * @return E_OK if every block was committed
+ */
+Std_ReturnType NvM_WriteBatch_Execute(NvM_BlockConfig_t *const *blocks, const void *const *bufs,
+                                      uint8_t n, boolean *restored);
+
+/**
+ * @brief Program the ROM defaults of blocks, each erase unit once, in ascending offset order
+ *
+ * Erase units that already read blank are not erased. Written blocks get
+ * their metadata (version, dataset index, state VALID); a block with a
+ * failed copy is set INVALID and the others are still written.
+ *
+ * @param blocks Blocks to write (ROM default of block_size bytes, not LOG)
+ * @param n Number of blocks (up to NVM_MAX_BLOCKS)
+ * @param written Set per block: TRUE if every copy was programmed
+ * @param erases_skipped Incremented for each erase unit found blank
+ * @return E_OK if every block was written
+ */
+Std_ReturnType NvM_RomDefaults_Execute(NvM_BlockConfig_t *const *blocks, uint16_t n,
+                                       boolean *written, uint32_t *erases_skipped);
+
+/**
+ * @brief Forget the log region and its index (NvM_Init)
+ */
+void NvM_Log_Reset(void);
+
+/**
+ * @brief Reclaim one log sector if worthwhile
+ *
+ * Erases sectors without current records; copies current records out
+ * first only when free sectors run low.
+ *
+ * @return TRUE if a sector was reclaimed
+ */
+boolean NvM_Log_BackgroundStep(void);
+
+/**
+ * @brief Forget every pre-erased dataset slot and clear the counters (NvM_Init)
+ */
+void NvM_PreErase_Reset(void);
+
+/**
+ * @brief Erase the next rotation slot of one DATASET block
+ *
+ * Visits the registered blocks round-robin and erases the slot the
+ * block's next write will use, unless it is already erased. Blocks with
+ * a single dataset are skipped (their next slot is the live one).
+ *
+ * @return TRUE if a slot was erased
+ */
+boolean NvM_PreErase_Step(void);
+
+/**
+ * @brief Consume a block's pre-erased slot
+ *
+ * @param block Block about to be written
+ * @param index Dataset slot the write programs
+ * @return TRUE if that slot was erased in the background (the mark is
+ *         cleared either way, since the write changes the slot)
+ */
+boolean NvM_PreErase_Take(NvM_BlockConfig_t *block, uint8_t index);
+
+/**
+ * @brief Pre-erase counters
+ *
+ * @param erases Slots erased in the background
+ * @param hits Writes that skipped their erase
+ */
+void NvM_PreErase_GetCounts(uint32_t *erases, uint32_t *hits);
+
+/**
+ * @brief Clear the in-place update counters (NvM_Init)
+ */
+void NvM_BitClear_Reset(void);
+
+/**
+ * @brief In-place update counters
+ *
+ * @param updates Copies programmed without an erase
+ * @param fallbacks Copies the device refused in place (erased and written)
+ */
+void NvM_BitClear_GetCounts(uint32_t *updates, uint32_t *fallbacks);
+
+/**
+ * @brief Clear the compression counter (NvM_Init)
+ */
+void NvM_Compression_Reset(void);
+
+/**
+ * @brief Device bytes compressed copies did not read or program
+ */
+uint32_t NvM_Compression_GetBytesSaved(void);
+
+/**
+ * @brief Forget the checkpoint region and clear its counters (NvM_Init)
+ */
+void NvM_Checkpoint_Reset(void);
+
+/**
+ * @brief TRUE while a clean checkpoint is current (ReadAll may use it)
+ */
+boolean NvM_Checkpoint_IsClean(void);
+
+/**
+ * @brief Read every block the clean checkpoint describes in one request
+ *
+ * Gathers the active copies into one MemIf_ReadV straight into the RAM
+ * mirrors; NvM_Checkpoint_ReadBlock then only restores the metadata.
+ */
+void NvM_Checkpoint_Prefetch(void);
+
+/**
+ * @brief Load a block from the clean checkpoint
+ *
+ * Takes the prefetched data, or reads the active copy into the RAM
+ * mirror; restores the active slot/version and sets the block VALID.
+ *
+ * @param block Block being read by ReadAll
+ * @param data_crc Set to the CRC-32 of the data the checkpoint recorded
+ * @return TRUE if loaded; FALSE means take the full read path
+ */
+boolean NvM_Checkpoint_ReadBlock(NvM_BlockConfig_t *block, uint32_t *data_crc);
+
+/**
+ * @brief Mark the checkpoint stale before the first write after it
+ */
+void NvM_Checkpoint_Invalidate(void);
+
+/**
+ * @brief Record the clean checkpoint after a successful WriteAll
+ *
+ * @return E_OK if written, or if the current checkpoint is still clean
+ */
+Std_ReturnType NvM_Checkpoint_Commit(void);
+
+/**
+ * @brief Checkpoint counters
+ *
+ * @param loaded ReadAll blocks loaded from the checkpoint
+ * @param writes Checkpoints written
+ */
+void NvM_Checkpoint_GetCounts(uint32_t *loaded, uint32_t *writes);
+
+/**
+ * @brief Slots in the cross-core submission ring (power of two, override with -D)
+ */
+#ifndef NVM_SUBMIT_RING_SIZE
+#define NVM_SUBMIT_RING_SIZE 64U
+#endif
+
+/**
+ * @brief Submission ring counters
+ */
+typedef struct {
+    uint32_t submitted;             /**< Jobs accepted into the ring */
+    uint32_t rejected;              /**< Pushes refused because the ring was full */
+    uint32_t depth;                 /**< Jobs waiting right now */
+    uint32_t max_depth;             /**< Deepest ring seen by the consumer */
+} NvM_SubmitStats_t;
+
+/**
+ * @brief Empty the submission ring and clear its counters (NvM_Init)
+ *
+ * Must not race with producers.
+ */
+void NvM_Submit_Reset(void);
+
+/**
+ * @brief Queue a job from any thread (lock-free, bounded)
+ *
+ * @return E_NOT_OK if the ring is full (backpressure: retry later)
+ */
+Std_ReturnType NvM_Submit_Push(const NvM_Job_t *job);
+
+/**
+ * @brief Take the oldest submitted job (NvM thread only)
+ *
+ * @return E_NOT_OK if no complete job is waiting
+ */
+Std_ReturnType NvM_Submit_Pop(NvM_Job_t *job);
+
+/**
+ * @brief Get the submission ring counters
+ */
+void NvM_Submit_GetStats(NvM_SubmitStats_t *stats);
+
+/**
+ * @brief Drop waiting retries, turn retries off and clear the counters (NvM_Init)
+ */
+void NvM_Retry_Reset(void);
+
+/**
+ * @brief Install a retry policy (NULL = off)
+ */
+void NvM_Retry_SetPolicy(const NvM_RetryPolicy_t *policy);
+
+/**
+ * @brief Set a failed ReadBlock/WriteBlock job aside for a later attempt
+ *
+ * @param job Failed job (retry_count = retries so far)
+ * @param now_ms Current virtual time
+ * @return TRUE if the job will be retried; FALSE if it has failed for good
+ */
+boolean NvM_Retry_Defer(const NvM_Job_t *job, uint32_t now_ms);
+
+/**
+ * @brief Move every retry whose not-before time has passed into the job queue
+ *
+ * Retries stay set aside while the queue is full. A write retry whose
+ * block already has a newer write queued is dropped.
+ */
+void NvM_Retry_Release(uint32_t now_ms);
+
+/**
+ * @brief Drop a waiting write retry (a newer write of the block is running)
+ */
+void NvM_Retry_Cancel(uint8_t block_id);
+
+/**
+ * @brief Retry counters
+ *
+ * @param retried Jobs set aside for another attempt
+ * @param exhausted Jobs the policy gave up on
+ */
+void NvM_Retry_GetCounts(uint32_t *retried, uint32_t *exhausted);
+
+/**
+ * @brief TRUE on the NvM thread (the NvM_Init caller, which owns the job queue)
+ */
+boolean NvM_IsNvmThread(void);
+
+/**
+ * @brief Count a finished job of a block and wake its waiters (job notifications)
+ */
+void NvM_Wait_Signal(NvM_BlockIdType block_id);
+
+/**
+ * @brief Publish a block's state and complete its client request (shared-memory server)
+ *
+ * No-op unless NvM_ShmServer_Start has published the block.
+ */
+void NvM_Shm_Complete(NvM_BlockIdType block_id);
+
+/**
+ * @brief Back off in a RAM mirror retry/wait loop
+ *
+ * CPU pause for the first retries, then yield the CPU.
+ *
+ * @param retry_count Retries so far
+ */
+void RamMirror_Backoff(uint32_t retry_count);
+
+/**
+ * @brief Carve a cache-line aligned buffer from the mirror arena
+ *
+ * @param size Bytes needed (rounded up to RAM_MIRROR_CACHE_LINE_SIZE)
+ * @return Buffer, or NULL if the arena is full
+ */
+uint8_t* RamMirror_ArenaAlloc(uint32_t size);
+
+/**
+ * @brief Drop every seqlock/versioned buffer and empty the arena
+ *
+ * Part of RamMirror_ResetAll; no mirror may be in use.
+ */
+void RamMirror_ArenaReset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NVM_INTERNAL_H */
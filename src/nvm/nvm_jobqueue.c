@@ -3,46 +3,37 @@
  * @brief NvM Job Queue Implementation
  *
  * REQ-Job队列管理: design/03-Block管理机制.md §4
- * - 优先级排序(0=最高优先级)
+ * - 优先级排序(0=最高优先级): 256级位图索引, O(1)入队/出队
  * - FIFO for same priority
+ * - 超时: 截止时间最小堆 (堆数组分布在节点池中, 节点记录自身堆位置), 删除O(log n)
  * - ReadAll/WriteAll特殊处理
+ * - 按条件出队: 被跳过的作业保持原位 (设备通道忙时)
  */
 
 #include "nvm_jobqueue.h"
+#include "nvm_internal.h"
+#include "os_scheduler.h"
+#include "timeline.h"
+#include "trace_probes.h"
 #include "logging.h"
 #include <string.h>
 
 /**
- * @brief Job queue structure
+ * @brief NvM queue of one context and its node pool
  */
-typedef struct {
-    NvM_Job_t jobs[NVM_JOB_QUEUE_SIZE];
-    uint16_t head;
-    uint16_t tail;
-    uint16_t count;
-    uint16_t max_count;         /**< Watermark */
-    uint32_t overflow_count;
-} NvM_JobQueue_t;
+struct NvM_JobQueueState {
+    NvM_JobQueueNode_t pool[NVM_JOB_QUEUE_SIZE];
+    NvM_JobQueueType queue;
+};
 
 /**
- * @brief Global job queue
+ * @brief State used while no context is bound
  */
-static NvM_JobQueue_t g_job_queue = {0};
+static struct NvM_JobQueueState g_default_state;
 
-/**
- * @brief Initialize job queue
- */
-Std_ReturnType NvM_JobQueue_Init(void)
+static struct NvM_JobQueueState* jobqueue_state(void)
 {
-    memset(&g_job_queue, 0, sizeof(NvM_JobQueue_t));
-    g_job_queue.head = 0;
-    g_job_queue.tail = 0;
-    g_job_queue.count = 0;
-    g_job_queue.max_count = 0;
-    g_job_queue.overflow_count = 0;
-
-    LOG_INFO("NvM JobQueue: Initialized (size=%d)", NVM_JOB_QUEUE_SIZE);
-    return E_OK;
+    return (struct NvM_JobQueueState *)NvM_PartState(NVM_PART_JOBQUEUE);
 }
 
 /**
@@ -71,103 +62,556 @@ static uint8_t calculate_effective_priority(const NvM_Job_t *job)
 }
 
 /**
- * @brief Find insert position for priority-based ordering
+ * @brief Immediate job that may run inside a ReadAll/WriteAll pass
+ */
+static boolean job_preempts(const NvM_Job_t *job)
+{
+    return (job->is_immediate && job->job_type != NVM_JOB_READ_ALL &&
+            job->job_type != NVM_JOB_WRITE_ALL) ? TRUE : FALSE;
+}
+
+/**
+ * @brief Mark priority level non-empty / empty
  */
-static uint16_t find_insert_position(const NvM_Job_t *job)
+static void level_set(NvM_JobQueueType *queue, uint8_t level)
 {
-    uint8_t new_priority = calculate_effective_priority(job);
+    queue->level_bitmap[level >> 6] |= (1ULL << (level & 63U));
+}
 
-    /* Scan queue to find correct position */
-    for (uint16_t i = 0; i < g_job_queue.count; i++) {
-        uint16_t idx = (g_job_queue.head + i) % NVM_JOB_QUEUE_SIZE;
-        uint8_t existing_priority = calculate_effective_priority(&g_job_queue.jobs[idx]);
+static void level_clear(NvM_JobQueueType *queue, uint8_t level)
+{
+    queue->level_bitmap[level >> 6] &= ~(1ULL << (level & 63U));
+}
 
-        if (new_priority < existing_priority) {
-            /* Insert before this job */
-            return idx;
+/**
+ * @brief Find highest priority (lowest numbered) non-empty level
+ *
+ * @return Level, or NVM_JOB_QUEUE_PRIO_LEVELS if the queue is empty
+ */
+static uint32_t level_first(const NvM_JobQueueType *queue)
+{
+    for (uint32_t w = 0; w < (NVM_JOB_QUEUE_PRIO_LEVELS / 64U); w++) {
+        if (queue->level_bitmap[w] != 0U) {
+            return (w * 64U) + (uint32_t)__builtin_ctzll(queue->level_bitmap[w]);
         }
     }
 
-    /* Insert at end */
-    return g_job_queue.tail;
+    return NVM_JOB_QUEUE_PRIO_LEVELS;
 }
 
 /**
- * @brief Enqueue a job
+ * @brief Append a node to the tail of a level FIFO
  */
-Std_ReturnType NvM_JobQueue_Enqueue(const NvM_Job_t *job)
+static void node_link(NvM_JobQueueType *queue, uint16_t idx, uint8_t level)
 {
-    if (job == NULL) {
-        return E_NOT_OK;
+    NvM_JobQueueNode_t *node = &queue->pool[idx];
+
+    node->level = level;
+    node->next = NVM_JOB_QUEUE_NIL;
+    node->prev = queue->tail[level];
+
+    if (queue->tail[level] != NVM_JOB_QUEUE_NIL) {
+        queue->pool[queue->tail[level]].next = idx;
+    } else {
+        queue->head[level] = idx;
+        level_set(queue, level);
     }
+    queue->tail[level] = idx;
+}
 
-    if (NvM_JobQueue_IsFull()) {
-        g_job_queue.overflow_count++;
-        LOG_WARN("NvM JobQueue: Overflow! Total overflows: %u", g_job_queue.overflow_count);
-        return E_NOT_OK;
+/**
+ * @brief Unlink a node from its level FIFO
+ */
+static void node_unlink(NvM_JobQueueType *queue, uint16_t idx)
+{
+    NvM_JobQueueNode_t *node = &queue->pool[idx];
+    uint8_t level = node->level;
+
+    if (node->prev != NVM_JOB_QUEUE_NIL) {
+        queue->pool[node->prev].next = node->next;
+    } else {
+        queue->head[level] = node->next;
     }
 
-    /* Find insert position based on priority */
-    uint16_t insert_pos = find_insert_position(job);
+    if (node->next != NVM_JOB_QUEUE_NIL) {
+        queue->pool[node->next].prev = node->prev;
+    } else {
+        queue->tail[level] = node->prev;
+    }
 
-    /* Shift elements to make room */
-    if (g_job_queue.count > 0) {
-        uint16_t shift_count = (g_job_queue.tail - insert_pos + NVM_JOB_QUEUE_SIZE) % NVM_JOB_QUEUE_SIZE;
+    if (queue->head[level] == NVM_JOB_QUEUE_NIL) {
+        level_clear(queue, level);
+    }
+}
+
+/**
+ * @brief Deadline of a job with a timeout
+ */
+static uint32_t node_deadline(const NvM_JobQueueType *queue, uint16_t idx)
+{
+    const NvM_Job_t *job = &queue->pool[idx].job;
+
+    return job->submit_time_ms + job->timeout_ms;
+}
+
+/**
+ * @brief Deadline order modulo 2^32
+ */
+static boolean deadline_before(uint32_t a, uint32_t b)
+{
+    return ((int32_t)(a - b) < 0) ? TRUE : FALSE;
+}
 
-        for (uint16_t i = shift_count; i > 0; i--) {
-            uint16_t src_idx = (insert_pos + i - 1) % NVM_JOB_QUEUE_SIZE;
-            uint16_t dst_idx = (insert_pos + i) % NVM_JOB_QUEUE_SIZE;
+/**
+ * @brief Put node idx at heap slot pos
+ */
+static void heap_place(NvM_JobQueueType *queue, uint16_t pos, uint16_t idx)
+{
+    queue->pool[pos].heap_entry = idx;
+    queue->pool[idx].heap_pos = pos;
+}
 
-            g_job_queue.jobs[dst_idx] = g_job_queue.jobs[src_idx];
+static void heap_sift_up(NvM_JobQueueType *queue, uint16_t pos)
+{
+    uint16_t idx = queue->pool[pos].heap_entry;
+    uint32_t deadline = node_deadline(queue, idx);
+
+    while (pos > 0U) {
+        uint16_t parent = (uint16_t)((pos - 1U) / 2U);
+        uint16_t parent_idx = queue->pool[parent].heap_entry;
+        if (!deadline_before(deadline, node_deadline(queue, parent_idx))) {
+            break;
+        }
+        heap_place(queue, pos, parent_idx);
+        pos = parent;
+    }
+    heap_place(queue, pos, idx);
+}
+
+static void heap_sift_down(NvM_JobQueueType *queue, uint16_t pos)
+{
+    uint16_t idx = queue->pool[pos].heap_entry;
+    uint32_t deadline = node_deadline(queue, idx);
+
+    for (;;) {
+        uint32_t child = (uint32_t)pos * 2U + 1U;
+        if (child >= queue->heap_count) {
+            break;
+        }
+        if (child + 1U < queue->heap_count &&
+            deadline_before(node_deadline(queue, queue->pool[child + 1U].heap_entry),
+                            node_deadline(queue, queue->pool[child].heap_entry))) {
+            child++;
         }
+        uint16_t child_idx = queue->pool[child].heap_entry;
+        if (!deadline_before(node_deadline(queue, child_idx), deadline)) {
+            break;
+        }
+        heap_place(queue, pos, child_idx);
+        pos = (uint16_t)child;
+    }
+    heap_place(queue, pos, idx);
+}
+
+/**
+ * @brief Track a queued job's deadline (jobs without a timeout are not tracked)
+ */
+static void heap_insert(NvM_JobQueueType *queue, uint16_t idx)
+{
+    if (queue->pool[idx].job.timeout_ms == 0U) {
+        queue->pool[idx].heap_pos = NVM_JOB_QUEUE_NIL;
+        return;
+    }
+
+    uint16_t pos = queue->heap_count++;
+    heap_place(queue, pos, idx);
+    heap_sift_up(queue, pos);
+}
+
+/**
+ * @brief Stop tracking a job's deadline
+ */
+static void heap_remove(NvM_JobQueueType *queue, uint16_t idx)
+{
+    uint16_t pos = queue->pool[idx].heap_pos;
+
+    if (pos == NVM_JOB_QUEUE_NIL) {
+        return;
+    }
+
+    queue->pool[idx].heap_pos = NVM_JOB_QUEUE_NIL;
+    queue->heap_count--;
+    if (pos == queue->heap_count) {
+        return;
+    }
+
+    /* Move the last entry into the hole, then restore the order either way */
+    uint16_t last = queue->pool[queue->heap_count].heap_entry;
+    heap_place(queue, pos, last);
+    heap_sift_up(queue, pos);
+    heap_sift_down(queue, queue->pool[last].heap_pos);
+}
+
+/**
+ * @brief Unlink a node and return it to the free list
+ */
+static void node_remove(NvM_JobQueueType *queue, uint16_t idx)
+{
+    NvM_JobQueueNode_t *node = &queue->pool[idx];
+
+    node_unlink(queue, idx);
+    heap_remove(queue, idx);
+    if (job_preempts(&node->job)) {
+        queue->immediate_count--;
+    }
+
+    if (node->job.job_type == NVM_JOB_WRITE &&
+        queue->pending_write[node->job.block_id] == idx) {
+        queue->pending_write[node->job.block_id] = NVM_JOB_QUEUE_NIL;
+    }
+
+    node->next = queue->free_head;
+    queue->free_head = idx;
+    queue->count--;
+}
+
+/**
+ * @brief Merge a WRITE into the block's pending WRITE, if there is one
+ *
+ * @return TRUE if the job was absorbed
+ */
+static boolean coalesce_write(NvM_JobQueueType *queue, const NvM_Job_t *job)
+{
+    uint16_t idx = queue->pending_write[job->block_id];
+
+    if (!queue->coalesce_writes || job->job_type != NVM_JOB_WRITE ||
+        idx == NVM_JOB_QUEUE_NIL) {
+        return FALSE;
+    }
+
+    NvM_JobQueueNode_t *node = &queue->pool[idx];
+    uint8_t level = calculate_effective_priority(job);
+
+    /* Latest data wins; submit_time_ms and retry state stay with the first request */
+    node->job.data_ptr = job->data_ptr;
+
+    if (level < node->level) {
+        if (job_preempts(job) && !job_preempts(&node->job)) {
+            queue->immediate_count++;
+        }
+        node->job.priority = job->priority;
+        node->job.is_immediate = job->is_immediate;
+        node_unlink(queue, idx);
+        node_link(queue, idx, level);
+    }
+
+    queue->coalesced_count++;
+    LOG_DEBUG("NvM JobQueue: Coalesced write for block_id=%d (total=%u)",
+              job->block_id, queue->coalesced_count);
+
+    return TRUE;
+}
+
+Std_ReturnType NvM_JobQueue_InstanceInit(NvM_JobQueueType *queue, NvM_JobQueueNode_t *pool,
+                                         uint16_t capacity)
+{
+    if (queue == NULL || pool == NULL || capacity == 0U || capacity >= NVM_JOB_QUEUE_NIL) {
+        return E_NOT_OK;
+    }
+
+    memset(queue, 0, sizeof(NvM_JobQueueType));
+    queue->pool = pool;
+    queue->capacity = capacity;
+    NvM_JobQueue_InstanceReset(queue);
+
+    return E_OK;
+}
+
+void NvM_JobQueue_InstanceReset(NvM_JobQueueType *queue)
+{
+    if (queue == NULL || queue->pool == NULL) {
+        return;
+    }
+
+    for (uint32_t l = 0; l < NVM_JOB_QUEUE_PRIO_LEVELS; l++) {
+        queue->head[l] = NVM_JOB_QUEUE_NIL;
+        queue->tail[l] = NVM_JOB_QUEUE_NIL;
+    }
+    memset(queue->level_bitmap, 0, sizeof(queue->level_bitmap));
+
+    /* Thread every node onto the free list */
+    for (uint16_t i = 0; i < queue->capacity; i++) {
+        queue->pool[i].next = (uint16_t)(i + 1U);
+    }
+    queue->pool[queue->capacity - 1U].next = NVM_JOB_QUEUE_NIL;
+    queue->free_head = 0;
+    queue->heap_count = 0;
+    queue->immediate_count = 0;
+
+    for (uint32_t b = 0; b < NVM_JOB_QUEUE_BLOCK_SLOTS; b++) {
+        queue->pending_write[b] = NVM_JOB_QUEUE_NIL;
+    }
+    queue->count = 0;
+    /* Keep max_count for diagnostics */
+}
+
+Std_ReturnType NvM_JobQueue_InstanceEnqueue(NvM_JobQueueType *queue, const NvM_Job_t *job)
+{
+    if (queue == NULL || job == NULL) {
+        return E_NOT_OK;
+    }
+
+    if (coalesce_write(queue, job)) {
+        return E_OK;
     }
 
-    /* Insert new job */
-    g_job_queue.jobs[insert_pos] = *job;
-    g_job_queue.tail = (g_job_queue.tail + 1) % NVM_JOB_QUEUE_SIZE;
-    g_job_queue.count++;
+    if (queue->free_head == NVM_JOB_QUEUE_NIL) {
+        queue->overflow_count++;
+        LOG_WARN("NvM JobQueue: Overflow! Total overflows: %u", queue->overflow_count);
+        return E_NOT_OK;
+    }
+
+    /* Take a node from the free list and append it to its level FIFO */
+    uint16_t idx = queue->free_head;
+    NvM_JobQueueNode_t *node = &queue->pool[idx];
+    uint8_t level = calculate_effective_priority(job);
+
+    queue->free_head = node->next;
+    node->job = *job;
+    node_link(queue, idx, level);
+    heap_insert(queue, idx);
+    queue->count++;
+    if (job_preempts(job)) {
+        queue->immediate_count++;
+    }
+
+    if (job->job_type == NVM_JOB_WRITE) {
+        queue->pending_write[job->block_id] = idx;
+    }
 
     /* Update watermark */
-    if (g_job_queue.count > g_job_queue.max_count) {
-        g_job_queue.max_count = g_job_queue.count;
+    if (queue->count > queue->max_count) {
+        queue->max_count = queue->count;
     }
 
     LOG_DEBUG("NvM JobQueue: Enqueued job type=%d, block_id=%d, priority=%d (depth=%u)",
-              job->job_type, job->block_id, job->priority, g_job_queue.count);
+              job->job_type, job->block_id, job->priority, queue->count);
 
     return E_OK;
 }
 
-/**
- * @brief Dequeue highest priority job
- */
-Std_ReturnType NvM_JobQueue_Dequeue(NvM_Job_t *job_ptr)
+void NvM_JobQueue_InstanceSetCoalescing(NvM_JobQueueType *queue, boolean enable)
+{
+    if (queue != NULL) {
+        queue->coalesce_writes = enable;
+    }
+}
+
+const NvM_Job_t* NvM_JobQueue_InstanceFindPendingWrite(const NvM_JobQueueType *queue,
+                                                       uint8_t block_id)
+{
+    if (queue == NULL || queue->pending_write[block_id] == NVM_JOB_QUEUE_NIL) {
+        return NULL;
+    }
+
+    return &queue->pool[queue->pending_write[block_id]].job;
+}
+
+Std_ReturnType NvM_JobQueue_InstanceDequeue(NvM_JobQueueType *queue, NvM_Job_t *job_ptr)
 {
-    if (job_ptr == NULL) {
+    if (queue == NULL || job_ptr == NULL) {
         return E_NOT_OK;
     }
 
-    if (NvM_JobQueue_IsEmpty()) {
+    uint32_t level = level_first(queue);
+    if (level >= NVM_JOB_QUEUE_PRIO_LEVELS) {
         return E_NOT_OK;
     }
 
-    /* Dequeue from head (highest priority) */
-    *job_ptr = g_job_queue.jobs[g_job_queue.head];
-    g_job_queue.head = (g_job_queue.head + 1) % NVM_JOB_QUEUE_SIZE;
-    g_job_queue.count--;
+    /* Dequeue from head of the highest priority level */
+    uint16_t idx = queue->head[level];
+    *job_ptr = queue->pool[idx].job;
+    node_remove(queue, idx);
 
     LOG_DEBUG("NvM JobQueue: Dequeued job type=%d, block_id=%d (depth=%u)",
-              job_ptr->job_type, job_ptr->block_id, g_job_queue.count);
+              job_ptr->job_type, job_ptr->block_id, queue->count);
 
     return E_OK;
 }
 
+Std_ReturnType NvM_JobQueue_InstanceDequeueImmediate(NvM_JobQueueType *queue, NvM_Job_t *job_ptr)
+{
+    if (queue == NULL || job_ptr == NULL || queue->immediate_count == 0U) {
+        return E_NOT_OK;
+    }
+
+    for (uint32_t level = level_first(queue); level < NVM_JOB_QUEUE_PRIO_LEVELS; level++) {
+        for (uint16_t idx = queue->head[level]; idx != NVM_JOB_QUEUE_NIL;
+             idx = queue->pool[idx].next) {
+            if (job_preempts(&queue->pool[idx].job)) {
+                *job_ptr = queue->pool[idx].job;
+                node_remove(queue, idx);
+                LOG_DEBUG("NvM JobQueue: Dequeued immediate job type=%d, block_id=%d (depth=%u)",
+                          job_ptr->job_type, job_ptr->block_id, queue->count);
+                return E_OK;
+            }
+        }
+    }
+
+    return E_NOT_OK;
+}
+
+Std_ReturnType NvM_JobQueue_InstanceDequeueIf(NvM_JobQueueType *queue, NvM_JobQueue_Filter_t accept,
+                                              void *ctx, NvM_Job_t *job_ptr)
+{
+    if (queue == NULL || accept == NULL || job_ptr == NULL) {
+        return E_NOT_OK;
+    }
+
+    for (uint32_t level = level_first(queue); level < NVM_JOB_QUEUE_PRIO_LEVELS; level++) {
+        for (uint16_t idx = queue->head[level]; idx != NVM_JOB_QUEUE_NIL;
+             idx = queue->pool[idx].next) {
+            if (accept(&queue->pool[idx].job, ctx)) {
+                *job_ptr = queue->pool[idx].job;
+                node_remove(queue, idx);
+                LOG_DEBUG("NvM JobQueue: Dequeued job type=%d, block_id=%d (depth=%u)",
+                          job_ptr->job_type, job_ptr->block_id, queue->count);
+                return E_OK;
+            }
+        }
+    }
+
+    return E_NOT_OK;
+}
+
+uint32_t NvM_JobQueue_InstanceCheckTimeouts(NvM_JobQueueType *queue, uint32_t current_time_ms,
+                                            NvM_Job_t *dropped, uint32_t max_dropped)
+{
+    uint32_t timeout_count = 0;
+    uint16_t expired = NVM_JOB_QUEUE_NIL;
+    uint16_t last = NVM_JOB_QUEUE_NIL;
+
+    /* Take every passed deadline off the heap, earliest first; while out of
+     * the heap, heap_pos chains the expired jobs in that order */
+    while (queue->heap_count > 0U) {
+        uint16_t idx = queue->pool[0].heap_entry;
+        const NvM_Job_t *job = &queue->pool[idx].job;
+
+        if ((current_time_ms - job->submit_time_ms) <= job->timeout_ms) {
+            break;
+        }
+        heap_remove(queue, idx);
+        queue->pool[idx].heap_pos = NVM_JOB_QUEUE_NIL;
+        if (last == NVM_JOB_QUEUE_NIL) {
+            expired = idx;
+        } else {
+            queue->pool[last].heap_pos = idx;
+        }
+        last = idx;
+    }
+
+    while (expired != NVM_JOB_QUEUE_NIL) {
+        uint16_t idx = expired;
+        NvM_Job_t *job = &queue->pool[idx].job;
+
+        expired = queue->pool[idx].heap_pos;
+        queue->pool[idx].heap_pos = NVM_JOB_QUEUE_NIL;
+
+        if (dropped != NULL && timeout_count >= max_dropped &&
+            job->retry_count >= job->max_retries) {
+            /* Would be dropped with no room to report it: untouched until the next check */
+            heap_insert(queue, idx);
+            continue;
+        }
+
+        LOG_WARN("NvM JobQueue: Job timeout (type=%d, block_id=%d, elapsed=%ums, limit=%ums)",
+                 job->job_type, job->block_id, current_time_ms - job->submit_time_ms,
+                 job->timeout_ms);
+
+        /* Mark job as failed */
+        job->retry_count++;
+        if (job->retry_count > job->max_retries) {
+            if (dropped != NULL) {
+                dropped[timeout_count] = *job;
+            }
+            node_remove(queue, idx);
+            timeout_count++;
+        } else {
+            /* Still expired: it uses another retry at the next check */
+            heap_insert(queue, idx);
+        }
+    }
+
+    return timeout_count;
+}
+
+/**
+ * @brief Initialize job queue
+ */
+Std_ReturnType NvM_JobQueue_Init(void)
+{
+    struct NvM_JobQueueState *jq = jobqueue_state();
+    Std_ReturnType ret = NvM_JobQueue_InstanceInit(&jq->queue, jq->pool,
+                                                    NVM_JOB_QUEUE_SIZE);
+
+    LOG_INFO("NvM JobQueue: Initialized (size=%d)", NVM_JOB_QUEUE_SIZE);
+    return ret;
+}
+
+/**
+ * @brief Enqueue a job
+ */
+Std_ReturnType NvM_JobQueue_Enqueue(const NvM_Job_t *job)
+{
+    struct NvM_JobQueueState *jq = jobqueue_state();
+    Std_ReturnType ret = NvM_JobQueue_InstanceEnqueue(&jq->queue, job);
+    TRACE_PROBE4(nvm, job_enqueue, job->block_id, job->job_type, job->priority, ret);
+    if (ret == E_OK && TIMELINE_ACTIVE()) {
+        Timeline_Job(TIMELINE_JOB_QUEUED, job->block_id, (uint8_t)job->job_type, ret,
+                     OsScheduler_GetVirtualTimeUs());
+    }
+    return ret;
+}
+
+/**
+ * @brief Dequeue highest priority job
+ */
+Std_ReturnType NvM_JobQueue_Dequeue(NvM_Job_t *job_ptr)
+{
+    struct NvM_JobQueueState *jq = jobqueue_state();
+    Std_ReturnType ret = NvM_JobQueue_InstanceDequeue(&jq->queue, job_ptr);
+    if (ret == E_OK) {
+        TRACE_PROBE3(nvm, job_dequeue, job_ptr->block_id, job_ptr->job_type, job_ptr->priority);
+        if (TIMELINE_ACTIVE()) {
+            Timeline_Job(TIMELINE_JOB_STARTED, job_ptr->block_id, (uint8_t)job_ptr->job_type, E_OK,
+                         OsScheduler_GetVirtualTimeUs());
+        }
+    }
+    return ret;
+}
+
+Std_ReturnType NvM_JobQueue_DequeueIf(NvM_JobQueue_Filter_t accept, void *ctx, NvM_Job_t *job_ptr)
+{
+    struct NvM_JobQueueState *jq = jobqueue_state();
+    Std_ReturnType ret = NvM_JobQueue_InstanceDequeueIf(&jq->queue, accept, ctx, job_ptr);
+    if (ret == E_OK) {
+        TRACE_PROBE3(nvm, job_dequeue, job_ptr->block_id, job_ptr->job_type, job_ptr->priority);
+        if (TIMELINE_ACTIVE()) {
+            Timeline_Job(TIMELINE_JOB_STARTED, job_ptr->block_id, (uint8_t)job_ptr->job_type, E_OK,
+                         OsScheduler_GetVirtualTimeUs());
+        }
+    }
+    return ret;
+}
+
 /**
  * @brief Check if queue is empty
  */
 boolean NvM_JobQueue_IsEmpty(void)
 {
-    return (g_job_queue.count == 0);
+    struct NvM_JobQueueState *jq = jobqueue_state();
+
+    return (jq->queue.count == 0);
 }
 
 /**
@@ -175,7 +619,9 @@ boolean NvM_JobQueue_IsEmpty(void)
  */
 boolean NvM_JobQueue_IsFull(void)
 {
-    return (g_job_queue.count >= NVM_JOB_QUEUE_SIZE);
+    struct NvM_JobQueueState *jq = jobqueue_state();
+
+    return (jq->queue.count >= jq->queue.capacity);
 }
 
 /**
@@ -183,7 +629,9 @@ boolean NvM_JobQueue_IsFull(void)
  */
 uint16_t NvM_JobQueue_GetDepth(void)
 {
-    return g_job_queue.count;
+    struct NvM_JobQueueState *jq = jobqueue_state();
+
+    return jq->queue.count;
 }
 
 /**
@@ -191,48 +639,36 @@ uint16_t NvM_JobQueue_GetDepth(void)
  */
 uint16_t NvM_JobQueue_GetMaxDepth(void)
 {
-    return g_job_queue.max_count;
+    struct NvM_JobQueueState *jq = jobqueue_state();
+
+    return jq->queue.max_count;
 }
 
 /**
- * @brief Check for timeout jobs
+ * @brief Dequeue the highest priority immediate job
  */
-uint8_t NvM_JobQueue_CheckTimeouts(uint32_t current_time_ms)
+Std_ReturnType NvM_JobQueue_DequeueImmediate(NvM_Job_t *job_ptr)
 {
-    uint8_t timeout_count = 0;
-
-    for (uint16_t i = 0; i < g_job_queue.count; i++) {
-        uint16_t idx = (g_job_queue.head + i) % NVM_JOB_QUEUE_SIZE;
-        NvM_Job_t *job = &g_job_queue.jobs[idx];
-
-        if (job->timeout_ms == 0) {
-            continue;  /* No timeout limit */
-        }
-
-        uint32_t elapsed = current_time_ms - job->submit_time_ms;
-
-        if (elapsed > job->timeout_ms) {
-            LOG_WARN("NvM JobQueue: Job timeout (type=%d, block_id=%d, elapsed=%ums, limit=%ums)",
-                     job->job_type, job->block_id, elapsed, job->timeout_ms);
-
-            /* Mark job as failed */
-            job->retry_count++;
-            if (job->retry_count > job->max_retries) {
-                /* Remove from queue by shifting */
-                for (uint16_t j = i; j < g_job_queue.count - 1; j++) {
-                    uint16_t src = (g_job_queue.head + j + 1) % NVM_JOB_QUEUE_SIZE;
-                    uint16_t dst = (g_job_queue.head + j) % NVM_JOB_QUEUE_SIZE;
-                    g_job_queue.jobs[dst] = g_job_queue.jobs[src];
-                }
-                g_job_queue.tail = (g_job_queue.tail - 1 + NVM_JOB_QUEUE_SIZE) % NVM_JOB_QUEUE_SIZE;
-                g_job_queue.count--;
-                i--;  /* Recheck this position */
-                timeout_count++;
-            }
+    struct NvM_JobQueueState *jq = jobqueue_state();
+    Std_ReturnType ret = NvM_JobQueue_InstanceDequeueImmediate(&jq->queue, job_ptr);
+    if (ret == E_OK) {
+        TRACE_PROBE3(nvm, job_dequeue, job_ptr->block_id, job_ptr->job_type, job_ptr->priority);
+        if (TIMELINE_ACTIVE()) {
+            Timeline_Job(TIMELINE_JOB_STARTED, job_ptr->block_id, (uint8_t)job_ptr->job_type, E_OK,
+                         OsScheduler_GetVirtualTimeUs());
         }
     }
+    return ret;
+}
 
-    return timeout_count;
+/**
+ * @brief Check for timeout jobs
+ */
+uint32_t NvM_JobQueue_CheckTimeouts(uint32_t current_time_ms, NvM_Job_t *dropped, uint32_t max_dropped)
+{
+    struct NvM_JobQueueState *jq = jobqueue_state();
+
+    return NvM_JobQueue_InstanceCheckTimeouts(&jq->queue, current_time_ms, dropped, max_dropped);
 }
 
 /**
@@ -240,8 +676,42 @@ uint8_t NvM_JobQueue_CheckTimeouts(uint32_t current_time_ms)
  */
 void NvM_JobQueue_Reset(void)
 {
-    g_job_queue.head = 0;
-    g_job_queue.tail = 0;
-    g_job_queue.count = 0;
-    /* Keep max_count for diagnostics */
+    struct NvM_JobQueueState *jq = jobqueue_state();
+
+    NvM_JobQueue_InstanceReset(&jq->queue);
 }
+
+/**
+ * @brief Enable or disable write coalescing
+ */
+void NvM_JobQueue_SetCoalescing(boolean enable)
+{
+    struct NvM_JobQueueState *jq = jobqueue_state();
+
+    NvM_JobQueue_InstanceSetCoalescing(&jq->queue, enable);
+}
+
+/**
+ * @brief Find pending write for a block
+ */
+const NvM_Job_t* NvM_JobQueue_FindPendingWrite(uint8_t block_id)
+{
+    struct NvM_JobQueueState *jq = jobqueue_state();
+
+    return NvM_JobQueue_InstanceFindPendingWrite(&jq->queue, block_id);
+}
+
+/**
+ * @brief Get coalesced write count
+ */
+uint32_t NvM_JobQueue_GetCoalescedCount(void)
+{
+    struct NvM_JobQueueState *jq = jobqueue_state();
+
+    return jq->queue.coalesced_count;
+}
+
+const NvM_PartDesc_t NvM_JobQueuePart = {
+    .size = sizeof(struct NvM_JobQueueState),
+    .default_state = &g_default_state
+};
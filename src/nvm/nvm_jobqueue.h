@@ -4,7 +4,7 @@
  *
  * REQ-Job队列管理: design/03-Block管理机制.md §4
  * - 优先级队列
- * - 超时管理
+ * - 超时管理: 按截止时间排序的最小堆, 只访问已超时的Job
  * - 溢出处理
  */
 
@@ -19,9 +19,165 @@ extern "C" {
 #endif
 
 /**
- * @brief Job queue size
+ * @brief Job queue size of the default NvM queue (override with -D)
  */
+#ifndef NVM_JOB_QUEUE_SIZE
 #define NVM_JOB_QUEUE_SIZE 32
+#endif
+
+/**
+ * @brief Number of effective priority levels
+ */
+#define NVM_JOB_QUEUE_PRIO_LEVELS 256U
+
+/**
+ * @brief End-of-list marker for node indices
+ */
+#define NVM_JOB_QUEUE_NIL 0xFFFFU
+
+/**
+ * @brief Number of block IDs tracked for write coalescing (8-bit block ID)
+ */
+#define NVM_JOB_QUEUE_BLOCK_SLOTS 256U
+
+/**
+ * @brief Job queue pool node
+ */
+typedef struct {
+    NvM_Job_t job;
+    uint16_t next;                  /**< Next node in priority FIFO / free list */
+    uint16_t prev;                  /**< Previous node in priority FIFO */
+    uint8_t level;                  /**< Effective priority level */
+    uint16_t heap_pos;              /**< Position in the deadline heap (NIL = no timeout) */
+    uint16_t heap_entry;            /**< Deadline heap slot with this index: node at that position */
+} NvM_JobQueueNode_t;
+
+/**
+ * @brief Bitmap-indexed priority queue instance
+ *
+ * One FIFO per effective priority level, threaded through a caller-owned
+ * fixed node pool. A set bit in level_bitmap marks a non-empty level, so
+ * enqueue and dequeue are O(1) and FIFO order holds within a level.
+ *
+ * pending_write indexes the newest queued WRITE per block so coalescing
+ * can find it without scanning the pool.
+ *
+ * Jobs with a timeout are also kept in a binary min-heap keyed by
+ * submit_time_ms + timeout_ms. The heap array is spread over the pool
+ * (pool[i].heap_entry is heap slot i) and every node knows its slot, so
+ * removing any job is O(log n) and a timeout check stops at the first
+ * deadline that has not passed. Deadlines are compared modulo 2^32, so
+ * pending timeouts must lie within 2^31 ms of each other.
+ */
+typedef struct {
+    NvM_JobQueueNode_t *pool;       /**< Node pool (capacity entries) */
+    uint16_t capacity;              /**< Pool size (< NVM_JOB_QUEUE_NIL) */
+    uint16_t free_head;             /**< Free list */
+    uint16_t head[NVM_JOB_QUEUE_PRIO_LEVELS];
+    uint16_t tail[NVM_JOB_QUEUE_PRIO_LEVELS];
+    uint64_t level_bitmap[NVM_JOB_QUEUE_PRIO_LEVELS / 64U];
+    uint16_t count;
+    uint16_t heap_count;            /**< Jobs in the deadline heap */
+    uint16_t immediate_count;       /**< Queued immediate single-block/batch jobs */
+    uint16_t max_count;             /**< Watermark */
+    uint32_t overflow_count;
+    boolean coalesce_writes;        /**< Merge repeated writes to one block */
+    uint32_t coalesced_count;       /**< Writes merged into a pending job */
+    uint16_t pending_write[NVM_JOB_QUEUE_BLOCK_SLOTS];
+} NvM_JobQueueType;
+
+/**
+ * @brief Initialize a queue instance over a caller-owned pool
+ *
+ * @param queue Queue instance
+ * @param pool Node pool
+ * @param capacity Number of nodes in pool (1..65534)
+ * @return E_OK on success
+ */
+Std_ReturnType NvM_JobQueue_InstanceInit(NvM_JobQueueType *queue, NvM_JobQueueNode_t *pool,
+                                         uint16_t capacity);
+
+/**
+ * @brief Enqueue into a queue instance
+ */
+Std_ReturnType NvM_JobQueue_InstanceEnqueue(NvM_JobQueueType *queue, const NvM_Job_t *job);
+
+/**
+ * @brief Enable or disable write coalescing on a queue instance
+ *
+ * When enabled, a WRITE for a block that already has a queued WRITE
+ * replaces that job's data pointer in place instead of taking a new node.
+ * The pending job keeps its submit time (timeout budget) and retry state;
+ * it only moves if the new request has a higher effective priority.
+ */
+void NvM_JobQueue_InstanceSetCoalescing(NvM_JobQueueType *queue, boolean enable);
+
+/**
+ * @brief Find the queued WRITE for a block
+ *
+ * @return Pending job (owned by the queue), or NULL if none is queued
+ */
+const NvM_Job_t* NvM_JobQueue_InstanceFindPendingWrite(const NvM_JobQueueType *queue,
+                                                       uint8_t block_id);
+
+/**
+ * @brief Dequeue highest priority job from a queue instance
+ */
+Std_ReturnType NvM_JobQueue_InstanceDequeue(NvM_JobQueueType *queue, NvM_Job_t *job_ptr);
+
+/**
+ * @brief Dequeue the highest priority immediate job from a queue instance
+ *
+ * ReadAll/WriteAll jobs do not count as immediate here: this is what a
+ * running ReadAll/WriteAll pass lets in between two blocks. O(1) when no
+ * immediate job is queued, else a walk from the highest priority level.
+ *
+ * @return E_NOT_OK if no immediate job is queued
+ */
+Std_ReturnType NvM_JobQueue_InstanceDequeueImmediate(NvM_JobQueueType *queue, NvM_Job_t *job_ptr);
+
+/**
+ * @brief Job filter for NvM_JobQueue_InstanceDequeueIf
+ *
+ * @return TRUE if the job may be dequeued now
+ */
+typedef boolean (*NvM_JobQueue_Filter_t)(const NvM_Job_t *job, void *ctx);
+
+/**
+ * @brief Dequeue the highest priority job the filter accepts
+ *
+ * Jobs the filter skips keep their place. A walk from the highest
+ * priority level, stopping at the first accepted job.
+ *
+ * @return E_NOT_OK if no queued job is accepted
+ */
+Std_ReturnType NvM_JobQueue_InstanceDequeueIf(NvM_JobQueueType *queue, NvM_JobQueue_Filter_t accept,
+                                              void *ctx, NvM_Job_t *job_ptr);
+
+/**
+ * @brief Check for timeout jobs in a queue instance
+ *
+ * Every job whose deadline has passed uses up one retry per check and is
+ * dropped once its retries are exhausted. Only expired jobs are visited:
+ * O(k log n) for k expired jobs.
+ *
+ * Dropped jobs are copied to dropped so the caller can complete them.
+ * Once max_dropped are reported, expired jobs out of retries are left
+ * as they are until the next check; the others still spend their retry.
+ *
+ * @param queue Queue instance
+ * @param current_time_ms Current virtual time
+ * @param dropped Receives the dropped jobs (NULL: not reported, no limit)
+ * @param max_dropped Capacity of dropped
+ * @return Number of jobs dropped
+ */
+uint32_t NvM_JobQueue_InstanceCheckTimeouts(NvM_JobQueueType *queue, uint32_t current_time_ms,
+                                            NvM_Job_t *dropped, uint32_t max_dropped);
+
+/**
+ * @brief Drop all jobs of a queue instance (watermark kept)
+ */
+void NvM_JobQueue_InstanceReset(NvM_JobQueueType *queue);
 
 /**
  * @brief Initialize job queue
@@ -46,6 +202,24 @@ Std_ReturnType NvM_JobQueue_Enqueue(const NvM_Job_t *job);
  */
 Std_ReturnType NvM_JobQueue_Dequeue(NvM_Job_t *job_ptr);
 
+/**
+ * @brief Dequeue the highest priority immediate job (not ReadAll/WriteAll)
+ *
+ * @param job_ptr Pointer to store dequeued job
+ * @return E_OK on success, E_NOT_OK if no immediate job is queued
+ */
+Std_ReturnType NvM_JobQueue_DequeueImmediate(NvM_Job_t *job_ptr);
+
+/**
+ * @brief Dequeue the highest priority job the filter accepts
+ *
+ * @param accept Filter
+ * @param ctx Passed to the filter
+ * @param job_ptr Pointer to store dequeued job
+ * @return E_OK on success, E_NOT_OK if no queued job is accepted
+ */
+Std_ReturnType NvM_JobQueue_DequeueIf(NvM_JobQueue_Filter_t accept, void *ctx, NvM_Job_t *job_ptr);
+
 /**
  * @brief Check if queue is empty
  *
@@ -78,15 +252,34 @@ uint16_t NvM_JobQueue_GetMaxDepth(void);
  * @brief Check for timeout jobs
  *
  * @param current_time_ms Current virtual time
+ * @param dropped Receives the dropped jobs (see NvM_JobQueue_InstanceCheckTimeouts)
+ * @param max_dropped Capacity of dropped
  * @return Number of timeout jobs
  */
-uint8_t NvM_JobQueue_CheckTimeouts(uint32_t current_time_ms);
+uint32_t NvM_JobQueue_CheckTimeouts(uint32_t current_time_ms, NvM_Job_t *dropped, uint32_t max_dropped);
 
 /**
  * @brief Reset job queue
  */
 void NvM_JobQueue_Reset(void);
 
+/**
+ * @brief Enable or disable write coalescing on the default queue
+ */
+void NvM_JobQueue_SetCoalescing(boolean enable);
+
+/**
+ * @brief Find the queued WRITE for a block in the default queue
+ *
+ * @return Pending job, or NULL if none is queued
+ */
+const NvM_Job_t* NvM_JobQueue_FindPendingWrite(uint8_t block_id);
+
+/**
+ * @brief Get number of writes merged into pending jobs
+ */
+uint32_t NvM_JobQueue_GetCoalescedCount(void);
+
 #ifdef __cplusplus
 }
 #endif
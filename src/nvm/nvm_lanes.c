@@ -0,0 +1,356 @@
+/**
+ * @file nvm_lanes.c
+ * @brief Single-block jobs over the asynchronous MemIf job engine
+ *
+ * REQ-多设备并行: design/02-NvM架构设计.md §3
+ * - 每个MemIf设备一条通道, 每条通道一个在途作业
+ * - 不同设备上的作业在虚拟时间上重叠, 吞吐随设备数增长
+ * - 写: 擦除 → 整页编程 (数据+CRC一次编程, 与同步路径布局相同)
+ * - 读: 数据与CRC一次读取, 校验失败时交由块类型处理函数恢复
+ */
+
+#include "nvm.h"
+#include "nvm_internal.h"
+#include "nvm_block_types.h"
+#include "eeprom_layout.h"
+#include "eeprom_driver.h"
+#include "memif.h"
+#include "crc.h"
+#include "logging.h"
+#include <string.h>
+
+/**
+ * @brief Largest request a lane stages (page-rounded image, or data + CRC)
+ */
+#define NVM_LANE_STAGING_SIZE (EEPROM_BLOCK_SLOT_SIZE + CRC_MAX_SIZE)
+
+/**
+ * @brief MemIf request a lane is working on
+ */
+typedef enum {
+    NVM_LANE_IDLE = 0,
+    NVM_LANE_ERASE,
+    NVM_LANE_PROGRAM,
+    NVM_LANE_READ
+} NvM_LaneStep_t;
+
+/**
+ * @brief Per-device lane: one job in flight
+ */
+typedef struct {
+    NvM_LaneStep_t step;           /**< Current request, IDLE when free */
+    boolean submitted;             /**< Request accepted by the device job slot */
+    NvM_Job_t job;                 /**< Job in flight */
+    uint32_t offset;               /**< Device address of the copy */
+    uint32_t length;               /**< Image (write) or data + CRC (read) length */
+    uint64_t start_ns;             /**< Host time at dequeue, handed back on completion */
+    NvM_LaneJobDone_t done;
+    uint8_t staging[NVM_LANE_STAGING_SIZE];
+} NvM_Lane_t;
+
+/**
+ * @brief Device lanes of one context
+ */
+struct NvM_LanesState {
+    NvM_Lane_t lanes[MEMIF_MAX_DEVICES];
+};
+
+/**
+ * @brief State used while no context is bound
+ */
+static struct NvM_LanesState g_default_state;
+
+static struct NvM_LanesState* lanes_state(void)
+{
+    return (struct NvM_LanesState *)NvM_PartState(NVM_PART_LANES);
+}
+
+static uint32_t read_length(const NvM_BlockConfig_t *block)
+{
+    const Crc_Descriptor_t *crc = NvM_GetBlockCrc(block);
+
+    return (uint32_t)block->block_size + ((crc != NULL) ? crc->crc_size : 0U);
+}
+
+/**
+ * @brief Lane of the device holding the block's copy
+ *
+ * @return NULL if the copy is not on a single device
+ */
+static NvM_Lane_t* block_lane(const NvM_BlockConfig_t *block)
+{
+    struct NvM_LanesState *ls = lanes_state();
+    MemIf_DeviceIdType device;
+
+    if (MemIf_GetDeviceForAddress(block->eeprom_offset, &device) != E_OK ||
+        device >= MEMIF_MAX_DEVICES) {
+        return NULL;
+    }
+
+    return &ls->lanes[device];
+}
+
+/**
+ * @brief Block whose jobs the lanes can run
+ *
+ * Single-copy, uncompressed blocks with the CRC programmed inline. Blocks
+ * updated in place by bit clearing keep the synchronous path.
+ */
+static boolean block_eligible(const NvM_BlockConfig_t *block)
+{
+    const Crc_Descriptor_t *crc = NvM_GetBlockCrc(block);
+    uint32_t image_size = EEPROM_PAGE_ROUNDUP(read_length(block));
+
+    if (block->block_type != NVM_BLOCK_NATIVE || block->compression != NVM_COMPRESSION_NONE) {
+        return FALSE;
+    }
+    if (crc != NULL && crc->crc_size > 0U && block->crc_placement != NVM_CRC_PLACEMENT_INLINE) {
+        return FALSE;
+    }
+    if (block->bit_clear_update && Eep_GetProgramMode() == EEP_PROGRAM_BIT_CLEAR) {
+        return FALSE;
+    }
+
+    return (image_size <= EEPROM_BLOCK_SLOT_SIZE) ? TRUE : FALSE;
+}
+
+static void lane_step_done(const MemIf_Job_t *job, void *user_ctx);
+
+/**
+ * @brief Free the lane, then report the job
+ *
+ * The lane is free before the notification so its job may be followed at once.
+ */
+static void lane_finish(NvM_Lane_t *lane, Std_ReturnType result)
+{
+    NvM_Job_t job = lane->job;
+    uint64_t start_ns = lane->start_ns;
+    NvM_LaneJobDone_t done = lane->done;
+
+    lane->step = NVM_LANE_IDLE;
+    lane->submitted = FALSE;
+    done(&job, start_ns, result);
+}
+
+/**
+ * @brief Read through the block-type handler (recovery path)
+ */
+static Std_ReturnType read_block_sync(NvM_Lane_t *lane)
+{
+    NvM_BlockConfig_t *block = NvM_Registry_Find(lane->job.block_id);
+
+    return (block != NULL) ? NvM_ReadNativeBlock(block, lane->job.data_ptr) : E_NOT_OK;
+}
+
+/**
+ * @brief Verify a staged copy and hand it to the caller's buffer
+ */
+static void lane_read_done(NvM_Lane_t *lane, boolean read_ok)
+{
+    NvM_BlockConfig_t *block = NvM_Registry_Find(lane->job.block_id);
+    const Crc_Descriptor_t *crc;
+
+    if (block == NULL) {
+        lane_finish(lane, E_NOT_OK);
+        return;
+    }
+
+    crc = NvM_GetBlockCrc(block);
+    if (read_ok && crc != NULL && crc->crc_size > 0U) {
+        uint32_t stored = CRC_Load(crc, &lane->staging[block->block_size]);
+        read_ok = (stored == crc->calculate(lane->staging, block->block_size)) ? TRUE : FALSE;
+    }
+
+    if (read_ok) {
+        memcpy(lane->job.data_ptr, lane->staging, block->block_size);
+        block->state = NVM_BLOCKSTATE_VALID;
+        lane_finish(lane, E_OK);
+        return;
+    }
+
+    /* The handler retries the copy, then falls back to the ROM default */
+    LOG_WARN("NvM: Block %d copy failed on its lane, recovering", block->block_id);
+    lane_finish(lane, read_block_sync(lane));
+}
+
+static void lane_write_done(NvM_Lane_t *lane)
+{
+    NvM_BlockConfig_t *block = NvM_Registry_Find(lane->job.block_id);
+
+    if (block == NULL) {
+        lane_finish(lane, E_NOT_OK);
+        return;
+    }
+
+    block->erase_count++;
+    block->state = NVM_BLOCKSTATE_VALID;
+    LOG_INFO("NvM: NATIVE block %d written successfully", block->block_id);
+    lane_finish(lane, E_OK);
+}
+
+/**
+ * @brief Hand the lane's current request to its device
+ *
+ * A device slot taken by another MemIf user is retried on the next poll.
+ */
+static void lane_submit(NvM_Lane_t *lane)
+{
+    struct NvM_LanesState *ls = lanes_state();
+    Std_ReturnType ret;
+
+    switch (lane->step) {
+        case NVM_LANE_ERASE:
+            ret = MemIf_SubmitErase(lane->offset, lane->length, lane_step_done, lane);
+            break;
+        case NVM_LANE_PROGRAM:
+            ret = MemIf_SubmitWrite(lane->offset, lane->staging, lane->length, lane_step_done, lane);
+            break;
+        case NVM_LANE_READ:
+            ret = MemIf_SubmitRead(lane->offset, lane->staging, lane->length, lane_step_done, lane);
+            break;
+        default:
+            return;
+    }
+
+    if (ret == E_OK) {
+        lane->submitted = TRUE;
+        return;
+    }
+
+    if (MemIf_GetDeviceJobStatus((MemIf_DeviceIdType)(lane - ls->lanes)) == MEMIF_JOB_PENDING) {
+        return;
+    }
+
+    LOG_ERROR("NvM: Block %d request refused at 0x%X", lane->job.block_id, lane->offset);
+    if (lane->step == NVM_LANE_READ) {
+        lane_finish(lane, read_block_sync(lane));
+    } else {
+        lane_finish(lane, E_NOT_OK);
+    }
+}
+
+/**
+ * @brief MemIf end notification of a lane request
+ */
+static void lane_step_done(const MemIf_Job_t *job, void *user_ctx)
+{
+    NvM_Lane_t *lane = (NvM_Lane_t *)user_ctx;
+    boolean ok = (job->status == MEMIF_JOB_OK) ? TRUE : FALSE;
+
+    if (lane->step == NVM_LANE_IDLE || !lane->submitted) {
+        return;
+    }
+    lane->submitted = FALSE;
+
+    switch (lane->step) {
+        case NVM_LANE_ERASE:
+            if (!ok) {
+                LOG_ERROR("NvM: Erase failed at offset 0x%X", lane->offset);
+                lane_finish(lane, E_NOT_OK);
+                return;
+            }
+            lane->step = NVM_LANE_PROGRAM;
+            lane_submit(lane);
+            break;
+
+        case NVM_LANE_PROGRAM:
+            if (!ok) {
+                LOG_ERROR("NvM: Write failed at offset 0x%X", lane->offset);
+                lane_finish(lane, E_NOT_OK);
+                return;
+            }
+            lane_write_done(lane);
+            break;
+
+        case NVM_LANE_READ:
+            lane_read_done(lane, ok);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void NvM_Lanes_Reset(void)
+{
+    struct NvM_LanesState *ls = lanes_state();
+
+    memset(ls->lanes, 0, sizeof(ls->lanes));
+}
+
+boolean NvM_Lanes_Accepts(const NvM_BlockConfig_t *block)
+{
+    const NvM_Lane_t *lane;
+
+    if (!block_eligible(block)) {
+        return FALSE;
+    }
+
+    lane = block_lane(block);
+    return (lane != NULL && lane->step == NVM_LANE_IDLE) ? TRUE : FALSE;
+}
+
+boolean NvM_Lanes_DeviceIdle(const NvM_BlockConfig_t *block)
+{
+    const NvM_Lane_t *lane = block_lane(block);
+
+    return (lane == NULL || lane->step == NVM_LANE_IDLE) ? TRUE : FALSE;
+}
+
+boolean NvM_Lanes_Idle(void)
+{
+    struct NvM_LanesState *ls = lanes_state();
+
+    for (uint32_t d = 0; d < MEMIF_MAX_DEVICES; d++) {
+        if (ls->lanes[d].step != NVM_LANE_IDLE) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+void NvM_Lanes_Start(const NvM_Job_t *job, const NvM_BlockConfig_t *block, uint64_t start_ns,
+                     NvM_LaneJobDone_t done)
+{
+    struct NvM_LanesState *ls = lanes_state();
+    NvM_Lane_t *lane = block_lane(block);
+
+    lane->job = *job;
+    lane->offset = block->eeprom_offset;
+    lane->start_ns = start_ns;
+    lane->done = done;
+    lane->submitted = FALSE;
+
+    if (job->job_type == NVM_JOB_WRITE) {
+        /* The image is taken now: the caller's buffer may change while the erase runs */
+        lane->length = NvM_BuildBlockImage((const uint8_t *)job->data_ptr, block->block_size,
+                                           NvM_GetBlockCrc(block), lane->staging);
+        lane->step = NVM_LANE_ERASE;
+    } else {
+        lane->length = read_length(block);
+        lane->step = NVM_LANE_READ;
+    }
+
+    LOG_DEBUG("NvM: Block %d %s on device lane %u", block->block_id,
+              (job->job_type == NVM_JOB_WRITE) ? "write" : "read", (uint32_t)(lane - ls->lanes));
+    lane_submit(lane);
+}
+
+void NvM_Lanes_Poll(void)
+{
+    struct NvM_LanesState *ls = lanes_state();
+
+    MemIf_MainFunction();
+
+    for (uint32_t d = 0; d < MEMIF_MAX_DEVICES; d++) {
+        if (ls->lanes[d].step != NVM_LANE_IDLE && !ls->lanes[d].submitted) {
+            lane_submit(&ls->lanes[d]);
+        }
+    }
+}
+
+const NvM_PartDesc_t NvM_LanesPart = {
+    .size = sizeof(struct NvM_LanesState),
+    .default_state = &g_default_state
+};
@@ -0,0 +1,806 @@
+/**
+ * @file nvm_log.c
+ * @brief Log-structured block storage (NVM_BLOCK_LOG)
+ *
+ * REQ-Block管理: design/03-Block管理机制.md §2
+ * - 记录 (id, seq, len, data, crc) 追加写入日志区的已擦除页, 写入不擦除
+ * - RAM索引 (block_id -> 最新记录) 在NvM_SetLogRegion时扫描日志区重建
+ * - 压缩: 先把扇区内的有效记录复制出去, 再擦除该扇区
+ * - 始终保留一个空闲扇区供压缩使用
+ * - 增量写 (delta_pages): Block按页切分, 每页一条自带CRC的记录; 写入只追加内容变化的页
+ *
+ * Record layout (page-aligned, never spans sectors):
+ *   [0] magic  [1] block_id  [2..3] len  [4..7] seq  [8..] data  [+len] CRC-32
+ * The CRC-32 covers header and data; a sequence number orders the copies
+ * of a block, the highest valid one is current.
+ *
+ * Paged record (delta_pages blocks, exactly one page):
+ *   [0] 'P'  [1] block_id  [2] chunk  [3] chunks in update  [4..7] seq
+ *   [8..251] chunk data (0xFF padded)  [252..255] CRC-32
+ * Chunk c holds block bytes [c * 244, (c + 1) * 244). All chunks of one
+ * write share its seq; the newest seq of a block is complete only if
+ * that many distinct chunks carry it, otherwise the write was torn and
+ * its chunks are ignored.
+ */
+
+#include "nvm.h"
+#include "nvm_internal.h"
+#include "nvm_block_types.h"
+#include "eeprom_layout.h"
+#include "memif.h"
+#include "crc.h"
+#include "logging.h"
+#include <string.h>
+
+#define NVM_LOG_SECTOR_SIZE      EEPROM_BLOCK_SLOT_SIZE
+#define NVM_LOG_PAGE_SIZE        EEPROM_LAYOUT_PAGE_SIZE /**< Program unit, as NvM_WriteBlockWithCrc */
+#define NVM_LOG_PAGES_PER_SECTOR (NVM_LOG_SECTOR_SIZE / NVM_LOG_PAGE_SIZE)
+#define NVM_LOG_HEADER_SIZE      8U
+#define NVM_LOG_MAGIC            0x4CU  /**< 'L'; erased pages read 0xFF */
+#define NVM_LOG_PAGED_MAGIC      0x50U  /**< 'P' */
+#define NVM_LOG_CHUNK_SIZE       (NVM_LOG_PAGE_SIZE - NVM_LOG_HEADER_SIZE - 4U)
+#define NVM_LOG_MAX_CHUNKS       ((NVM_LOG_MAX_BLOCK_SIZE + NVM_LOG_CHUNK_SIZE - 1U) / NVM_LOG_CHUNK_SIZE)
+#define NVM_LOG_NO_PAGE          0xFFFFU
+#define NVM_LOG_NO_SECTOR        0xFFU
+
+/**
+ * @brief Free sectors below which the background compactor runs
+ *
+ * One free sector is always kept for compaction, so this is one more.
+ */
+#define NVM_LOG_MIN_FREE_SECTORS 2U
+
+/**
+ * @brief Per-sector fill state
+ */
+typedef struct {
+    uint8_t next_page;              /**< First unprogrammed page */
+    uint8_t live_pages;             /**< Pages held by current records */
+} NvM_LogSector_t;
+
+/**
+ * @brief Current record of one block ID (or of one chunk of a paged block)
+ */
+typedef struct {
+    uint16_t page;                  /**< Region page number, or NO_PAGE */
+    uint8_t pages;
+    uint32_t data_crc;              /**< Paged: CRC-32 of the chunk data (unchanged check) */
+} NvM_LogIndexEntry_t;
+
+/**
+ * @brief Log region state
+ */
+typedef struct {
+    boolean configured;
+    uint32_t base;
+    uint8_t sector_count;
+    uint8_t free_count;
+    uint8_t active;                 /**< Sector being appended, or NO_SECTOR */
+    uint32_t next_seq;
+    NvM_LogSector_t sectors[NVM_LOG_MAX_SECTORS];
+    NvM_LogIndexEntry_t index[NVM_BLOCK_ID_COUNT][NVM_LOG_MAX_CHUNKS]; /**< Whole records use chunk 0 */
+    boolean rewrite[NVM_BLOCK_ID_COUNT];  /**< Paged: next write programs every chunk */
+    NvM_LogStats_t stats;
+} NvM_LogRegion_t;
+
+/**
+ * @brief Log-structured region of one context
+ */
+struct NvM_LogState {
+    NvM_LogRegion_t region;
+    uint8_t record[NVM_LOG_SECTOR_SIZE];
+};
+
+/**
+ * @brief State used while no context is bound
+ */
+static struct NvM_LogState g_default_state;
+
+static struct NvM_LogState* log_state(void)
+{
+    return (struct NvM_LogState *)NvM_PartState(NVM_PART_LOG);
+}
+
+static uint32_t record_bytes(uint16_t len)
+{
+    return NVM_LOG_HEADER_SIZE + (uint32_t)len + 4U;
+}
+
+static uint8_t record_pages(uint16_t len)
+{
+    return (uint8_t)((record_bytes(len) + NVM_LOG_PAGE_SIZE - 1U) / NVM_LOG_PAGE_SIZE);
+}
+
+static uint8_t chunk_count(uint16_t block_size)
+{
+    return (uint8_t)((block_size + NVM_LOG_CHUNK_SIZE - 1U) / NVM_LOG_CHUNK_SIZE);
+}
+
+static uint32_t page_address(uint16_t page)
+{
+    struct NvM_LogState *lg = log_state();
+
+    return lg->region.base + (uint32_t)page * NVM_LOG_PAGE_SIZE;
+}
+
+static uint8_t sector_of(uint16_t page)
+{
+    return (uint8_t)(page / NVM_LOG_PAGES_PER_SECTOR);
+}
+
+static uint32_t load_le(const uint8_t *p, uint8_t size)
+{
+    uint32_t v = 0;
+    for (uint8_t i = 0; i < size; i++) {
+        v |= (uint32_t)p[i] << (8U * i);
+    }
+    return v;
+}
+
+static void store_le(uint8_t *p, uint32_t v, uint8_t size)
+{
+    for (uint8_t i = 0; i < size; i++) {
+        p[i] = (uint8_t)(v >> (8U * i));
+    }
+}
+
+/**
+ * @brief Read and check the record at a page into the record buffer
+ *
+ * The staged record is padded with 0xFF to whole pages, ready to be
+ * programmed elsewhere.
+ *
+ * @return TRUE if a valid record starts there
+ */
+static boolean load_record(uint16_t page, uint8_t max_pages)
+{
+    struct NvM_LogState *lg = log_state();
+    uint8_t *rec = lg->record;
+
+    if (MemIf_Read(page_address(page), rec, NVM_LOG_HEADER_SIZE) != E_OK) {
+        return FALSE;
+    }
+
+    if (rec[0] == NVM_LOG_PAGED_MAGIC) {
+        if (max_pages < 1U || rec[2] >= NVM_LOG_MAX_CHUNKS ||
+            MemIf_Read(page_address(page) + NVM_LOG_HEADER_SIZE, &rec[NVM_LOG_HEADER_SIZE],
+                       NVM_LOG_PAGE_SIZE - NVM_LOG_HEADER_SIZE) != E_OK) {
+            return FALSE;
+        }
+        uint32_t stored = load_le(&rec[NVM_LOG_PAGE_SIZE - 4U], 4);
+        return (stored == CRC_CalculateCRC32(rec, NVM_LOG_PAGE_SIZE - 4U)) ? TRUE : FALSE;
+    }
+
+    if (rec[0] != NVM_LOG_MAGIC) {
+        return FALSE;
+    }
+
+    uint16_t len = (uint16_t)load_le(&rec[2], 2);
+    if (len > NVM_LOG_MAX_BLOCK_SIZE || record_pages(len) > max_pages) {
+        return FALSE;
+    }
+
+    uint32_t bytes = record_bytes(len);
+    if (MemIf_Read(page_address(page) + NVM_LOG_HEADER_SIZE, &rec[NVM_LOG_HEADER_SIZE],
+                   bytes - NVM_LOG_HEADER_SIZE) != E_OK) {
+        return FALSE;
+    }
+    memset(&rec[bytes], 0xFF, (uint32_t)record_pages(len) * NVM_LOG_PAGE_SIZE - bytes);
+
+    uint32_t stored = load_le(&rec[bytes - 4U], 4);
+    return (stored == CRC_CalculateCRC32(rec, bytes - 4U)) ? TRUE : FALSE;
+}
+
+/**
+ * @brief Make a record current for its block (chunk), releasing the previous one
+ */
+static void index_set(uint8_t block_id, uint8_t chunk, uint16_t page, uint8_t pages,
+                      uint32_t data_crc)
+{
+    struct NvM_LogState *lg = log_state();
+    NvM_LogIndexEntry_t *entry = &lg->region.index[block_id][chunk];
+
+    if (entry->page != NVM_LOG_NO_PAGE) {
+        lg->region.sectors[sector_of(entry->page)].live_pages -= entry->pages;
+    }
+
+    entry->page = page;
+    entry->pages = pages;
+    entry->data_crc = data_crc;
+    lg->region.sectors[sector_of(page)].live_pages += pages;
+}
+
+/**
+ * @brief Take an erased sector as the append target
+ *
+ * @param for_compaction Allowed to take the sector reserved for compaction
+ */
+static boolean open_sector(boolean for_compaction)
+{
+    struct NvM_LogState *lg = log_state();
+
+    /* The last free sector is the compaction reserve */
+    if (lg->region.free_count == 0U || (!for_compaction && lg->region.free_count == 1U)) {
+        return FALSE;
+    }
+
+    for (uint8_t s = 0; s < lg->region.sector_count; s++) {
+        if (lg->region.sectors[s].next_page == 0U && s != lg->region.active) {
+            lg->region.active = s;
+            lg->region.free_count--;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Program the staged record into the active sector
+ *
+ * A page that does not take the program (not blank) is skipped as dead.
+ *
+ * @return Region page of the record, or NO_PAGE if the sector is used up
+ */
+static uint16_t program_record(uint8_t pages)
+{
+    struct NvM_LogState *lg = log_state();
+    NvM_LogSector_t *sector = &lg->region.sectors[lg->region.active];
+
+    while (sector->next_page + pages <= NVM_LOG_PAGES_PER_SECTOR) {
+        uint16_t page = (uint16_t)(lg->region.active * NVM_LOG_PAGES_PER_SECTOR + sector->next_page);
+
+        if (MemIf_Write(page_address(page), lg->record, (uint32_t)pages * NVM_LOG_PAGE_SIZE) == E_OK) {
+            sector->next_page += pages;
+            lg->region.stats.pages_programmed += pages;
+            if (sector->next_page == NVM_LOG_PAGES_PER_SECTOR) {
+                lg->region.active = NVM_LOG_NO_SECTOR;
+            }
+            return page;
+        }
+
+        LOG_WARN("NvM: Log page 0x%X not programmable, skipped", page_address(page));
+        sector->next_page++;
+    }
+
+    lg->region.active = NVM_LOG_NO_SECTOR;
+    return NVM_LOG_NO_PAGE;
+}
+
+/**
+ * @brief Sector with the most reclaimable pages (not the active one)
+ *
+ * @param dead_only Only sectors without current records (erase, no copies)
+ */
+static uint8_t pick_victim(boolean dead_only)
+{
+    struct NvM_LogState *lg = log_state();
+    uint8_t victim = NVM_LOG_NO_SECTOR;
+    uint8_t best = 0;
+
+    for (uint8_t s = 0; s < lg->region.sector_count; s++) {
+        const NvM_LogSector_t *sector = &lg->region.sectors[s];
+        uint8_t dead = (uint8_t)(sector->next_page - sector->live_pages);
+        if (s == lg->region.active || (dead_only && sector->live_pages != 0U)) {
+            continue;
+        }
+        if (dead > best) {
+            best = dead;
+            victim = s;
+        }
+    }
+
+    return victim;
+}
+
+/**
+ * @brief Copy a sector's current records out, then erase it
+ */
+static Std_ReturnType compact_sector(uint8_t victim)
+{
+    struct NvM_LogState *lg = log_state();
+
+    for (uint32_t slot = 0; slot < NVM_BLOCK_ID_COUNT * NVM_LOG_MAX_CHUNKS; slot++) {
+        uint32_t id = slot / NVM_LOG_MAX_CHUNKS;
+        uint8_t chunk = (uint8_t)(slot % NVM_LOG_MAX_CHUNKS);
+        NvM_LogIndexEntry_t *entry = &lg->region.index[id][chunk];
+        if (entry->page == NVM_LOG_NO_PAGE || sector_of(entry->page) != victim) {
+            continue;
+        }
+
+        uint8_t pages = entry->pages;
+        uint16_t page = entry->page;
+        if (!load_record(page, pages)) {
+            LOG_ERROR("NvM: Log record of block %u unreadable during compaction", id);
+            return E_NOT_OK;
+        }
+        /* The copy keeps its seq: one left behind by an interrupted
+         * compaction is identical to the relocated one */
+
+        uint16_t target = NVM_LOG_NO_PAGE;
+        while (target == NVM_LOG_NO_PAGE) {
+            if (lg->region.active == NVM_LOG_NO_SECTOR && !open_sector(TRUE)) {
+                LOG_ERROR("NvM: Log compaction has no free sector");
+                return E_NOT_OK;
+            }
+            target = program_record(pages);
+        }
+
+        index_set((uint8_t)id, chunk, target, pages, entry->data_crc);
+        lg->region.stats.records_relocated++;
+    }
+
+    if (MemIf_Erase(lg->region.base + (uint32_t)victim * NVM_LOG_SECTOR_SIZE, NVM_LOG_SECTOR_SIZE) != E_OK) {
+        LOG_ERROR("NvM: Log sector %u erase failed", victim);
+        return E_NOT_OK;
+    }
+
+    lg->region.sectors[victim].next_page = 0;
+    lg->region.sectors[victim].live_pages = 0;
+    lg->region.free_count++;
+    lg->region.stats.sectors_erased++;
+
+    LOG_DEBUG("NvM: Log sector %u compacted (%u free)", victim, lg->region.free_count);
+    return E_OK;
+}
+
+/**
+ * @brief Make the active sector fit a record of the given size
+ *
+ * Opens a free sector while one beyond the compaction reserve is left,
+ * otherwise compacts until one is.
+ */
+static boolean make_room(uint8_t pages)
+{
+    struct NvM_LogState *lg = log_state();
+
+    while (lg->region.active == NVM_LOG_NO_SECTOR ||
+           lg->region.sectors[lg->region.active].next_page + pages > NVM_LOG_PAGES_PER_SECTOR) {
+        lg->region.active = NVM_LOG_NO_SECTOR;
+        if (open_sector(FALSE)) {
+            break;
+        }
+
+        uint8_t victim = pick_victim(FALSE);
+        if (victim == NVM_LOG_NO_SECTOR || compact_sector(victim) != E_OK) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Scan candidates of one chunk of a paged block
+ */
+typedef struct {
+    uint16_t page[2];               /**< Newest and next older copy, or NO_PAGE */
+    uint32_t seq[2];
+    uint32_t data_crc[2];
+} NvM_LogChunkScan_t;
+
+/**
+ * @brief Scan state of one paged block
+ */
+typedef struct {
+    NvM_LogChunkScan_t chunk[NVM_LOG_MAX_CHUNKS];
+    boolean any;
+    uint32_t newest;                /**< Highest seq seen */
+    uint8_t newest_chunks;          /**< Chunks that seq says it wrote */
+    uint8_t newest_seen;            /**< Bitmask of chunks found with that seq */
+} NvM_LogPagedScan_t;
+
+/**
+ * @brief Account one valid paged record (staged in the record buffer) found by the scan
+ */
+static void scan_paged_record(NvM_LogPagedScan_t *scan, uint16_t page, uint32_t seq)
+{
+    struct NvM_LogState *lg = log_state();
+    uint8_t chunk = lg->record[2];
+    NvM_LogChunkScan_t *c = &scan->chunk[chunk];
+    uint32_t data_crc = CRC_CalculateCRC32(&lg->record[NVM_LOG_HEADER_SIZE], NVM_LOG_CHUNK_SIZE);
+
+    /* Equal seq: a copy left behind by an interrupted compaction */
+    if (c->page[0] == NVM_LOG_NO_PAGE || seq > c->seq[0]) {
+        c->page[1] = c->page[0];
+        c->seq[1] = c->seq[0];
+        c->data_crc[1] = c->data_crc[0];
+        c->page[0] = page;
+        c->seq[0] = seq;
+        c->data_crc[0] = data_crc;
+    } else if (seq < c->seq[0] && (c->page[1] == NVM_LOG_NO_PAGE || seq > c->seq[1])) {
+        c->page[1] = page;
+        c->seq[1] = seq;
+        c->data_crc[1] = data_crc;
+    }
+
+    if (!scan->any || seq > scan->newest) {
+        scan->any = TRUE;
+        scan->newest = seq;
+        scan->newest_chunks = lg->record[3];
+        scan->newest_seen = 0;
+    }
+    if (seq == scan->newest) {
+        scan->newest_seen |= (uint8_t)(1U << chunk);
+    }
+}
+
+/**
+ * @brief Index the chunks of a scanned paged block, rolling back a torn write
+ */
+static void index_paged_block(uint8_t block_id, const NvM_LogPagedScan_t *scan)
+{
+    struct NvM_LogState *lg = log_state();
+    uint8_t seen = 0;
+
+    for (uint8_t c = 0; c < NVM_LOG_MAX_CHUNKS; c++) {
+        seen = (uint8_t)(seen + ((scan->newest_seen >> c) & 1U));
+    }
+    boolean torn = (seen < scan->newest_chunks) ? TRUE : FALSE;
+
+    for (uint8_t c = 0; c < NVM_LOG_MAX_CHUNKS; c++) {
+        const NvM_LogChunkScan_t *chunk = &scan->chunk[c];
+        uint8_t pick = (torn && chunk->page[0] != NVM_LOG_NO_PAGE &&
+                        chunk->seq[0] == scan->newest) ? 1U : 0U;
+        NvM_LogIndexEntry_t *entry = &lg->region.index[block_id][c];
+
+        entry->page = chunk->page[pick];
+        entry->pages = 1;
+        entry->data_crc = chunk->data_crc[pick];
+    }
+
+    /* The torn chunks stay on the device with the highest seq until every
+     * chunk has been written again */
+    if (torn) {
+        lg->region.rewrite[block_id] = TRUE;
+        LOG_WARN("NvM: Log block %u: interrupted paged write rolled back", block_id);
+    }
+}
+
+/**
+ * @brief Rebuild sector state and index from the device
+ */
+static void scan_region(void)
+{
+    struct NvM_LogState *lg = log_state();
+    static uint32_t seq_of[NVM_BLOCK_ID_COUNT];
+    static NvM_LogPagedScan_t paged[NVM_BLOCK_ID_COUNT];
+    uint32_t max_seq = 0;
+    boolean any = FALSE;
+    uint16_t newest_page = NVM_LOG_NO_PAGE;
+
+    memset(paged, 0, sizeof(paged));
+    for (uint32_t id = 0; id < NVM_BLOCK_ID_COUNT; id++) {
+        for (uint8_t c = 0; c < NVM_LOG_MAX_CHUNKS; c++) {
+            paged[id].chunk[c].page[0] = NVM_LOG_NO_PAGE;
+            paged[id].chunk[c].page[1] = NVM_LOG_NO_PAGE;
+        }
+    }
+
+    for (uint8_t s = 0; s < lg->region.sector_count; s++) {
+        uint8_t p = 0;
+
+        while (p < NVM_LOG_PAGES_PER_SECTOR) {
+            uint16_t page = (uint16_t)(s * NVM_LOG_PAGES_PER_SECTOR + p);
+
+            if (!load_record(page, (uint8_t)(NVM_LOG_PAGES_PER_SECTOR - p))) {
+                boolean erased = TRUE;
+                for (uint32_t i = 0; i < NVM_LOG_HEADER_SIZE; i++) {
+                    if (lg->record[i] != 0xFFU) {
+                        erased = FALSE;
+                    }
+                }
+                if (erased) {
+                    break;  /* Appends are sequential: the rest is free */
+                }
+                p++;        /* Torn or corrupt record: dead page */
+                continue;
+            }
+
+            uint8_t block_id = lg->record[1];
+            uint32_t seq = load_le(&lg->record[4], 4);
+            uint8_t pages = 1;
+
+            if (lg->record[0] == NVM_LOG_PAGED_MAGIC) {
+                scan_paged_record(&paged[block_id], page, seq);
+            } else {
+                uint16_t len = (uint16_t)load_le(&lg->record[2], 2);
+                NvM_LogIndexEntry_t *entry = &lg->region.index[block_id][0];
+
+                pages = record_pages(len);
+                if (entry->page == NVM_LOG_NO_PAGE || seq > seq_of[block_id]) {
+                    entry->page = page;
+                    entry->pages = pages;
+                    seq_of[block_id] = seq;
+                }
+            }
+            if (!any || seq >= max_seq) {
+                max_seq = seq;
+                newest_page = page;
+                any = TRUE;
+            }
+            p += pages;
+        }
+
+        lg->region.sectors[s].next_page = p;
+        if (p == 0U) {
+            lg->region.free_count++;
+        }
+    }
+
+    for (uint32_t id = 0; id < NVM_BLOCK_ID_COUNT; id++) {
+        if (paged[id].any) {
+            index_paged_block((uint8_t)id, &paged[id]);
+        }
+        for (uint8_t c = 0; c < NVM_LOG_MAX_CHUNKS; c++) {
+            const NvM_LogIndexEntry_t *entry = &lg->region.index[id][c];
+            if (entry->page != NVM_LOG_NO_PAGE) {
+                lg->region.sectors[sector_of(entry->page)].live_pages += entry->pages;
+            }
+        }
+    }
+
+    lg->region.next_seq = any ? (max_seq + 1U) : 0U;
+    if (newest_page != NVM_LOG_NO_PAGE &&
+        lg->region.sectors[sector_of(newest_page)].next_page < NVM_LOG_PAGES_PER_SECTOR) {
+        lg->region.active = sector_of(newest_page);
+    }
+}
+
+void NvM_Log_Reset(void)
+{
+    struct NvM_LogState *lg = log_state();
+
+    memset(&lg->region, 0, sizeof(lg->region));
+    lg->region.active = NVM_LOG_NO_SECTOR;
+    for (uint32_t id = 0; id < NVM_BLOCK_ID_COUNT; id++) {
+        for (uint8_t c = 0; c < NVM_LOG_MAX_CHUNKS; c++) {
+            lg->region.index[id][c].page = NVM_LOG_NO_PAGE;
+        }
+    }
+}
+
+Std_ReturnType NvM_SetLogRegion(uint32_t offset, uint8_t sector_count)
+{
+    struct NvM_LogState *lg = log_state();
+
+    if (!EEPROM_IS_SLOT_ALIGNED(offset) || sector_count < 2U || sector_count > NVM_LOG_MAX_SECTORS) {
+        LOG_ERROR("NvM: Invalid log region 0x%X (%u sectors)", offset, sector_count);
+        return E_NOT_OK;
+    }
+
+    NvM_Log_Reset();
+    lg->region.base = offset;
+    lg->region.sector_count = sector_count;
+    scan_region();
+    lg->region.configured = TRUE;
+
+    LOG_INFO("NvM: Log region 0x%X, %u sectors (%u free, next seq %u)",
+             offset, sector_count, lg->region.free_count, lg->region.next_seq);
+    return E_OK;
+}
+
+Std_ReturnType NvM_GetLogStats(NvM_LogStats_t *stats)
+{
+    struct NvM_LogState *lg = log_state();
+
+    if (stats == NULL) {
+        return E_NOT_OK;
+    }
+
+    *stats = lg->region.stats;
+    stats->free_sectors = lg->region.free_count;
+    return E_OK;
+}
+
+boolean NvM_Log_BackgroundStep(void)
+{
+    struct NvM_LogState *lg = log_state();
+
+    if (!lg->region.configured) {
+        return FALSE;
+    }
+
+    /* Plenty of free sectors: only reclaim sectors that need no copies */
+    uint8_t victim = pick_victim((lg->region.free_count >= NVM_LOG_MIN_FREE_SECTORS) ? TRUE : FALSE);
+    if (victim == NVM_LOG_NO_SECTOR) {
+        return FALSE;
+    }
+
+    return (compact_sector(victim) == E_OK) ? TRUE : FALSE;
+}
+
+/**
+ * @brief Gather a paged block from its current chunk records
+ */
+static boolean read_paged(const NvM_BlockConfig_t *block, uint8_t *data)
+{
+    struct NvM_LogState *lg = log_state();
+    uint8_t chunks = chunk_count(block->block_size);
+
+    for (uint8_t c = 0; c < chunks; c++) {
+        const NvM_LogIndexEntry_t *entry = &lg->region.index[block->block_id][c];
+
+        if (entry->page == NVM_LOG_NO_PAGE || !load_record(entry->page, 1) ||
+            lg->record[0] != NVM_LOG_PAGED_MAGIC || lg->record[1] != block->block_id ||
+            lg->record[2] != c) {
+            return FALSE;
+        }
+
+        uint32_t at = (uint32_t)c * NVM_LOG_CHUNK_SIZE;
+        uint32_t len = ((uint32_t)block->block_size - at < NVM_LOG_CHUNK_SIZE)
+                       ? (uint32_t)block->block_size - at : NVM_LOG_CHUNK_SIZE;
+        memcpy(&data[at], &lg->record[NVM_LOG_HEADER_SIZE], len);
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Append the chunks of a paged block whose data changed
+ *
+ * The chunks are compared with the CRC cached in the index, so nothing
+ * is read back. Each chunk is made current as soon as it is programmed
+ * (compaction must see it); after a failure the next write programs
+ * every chunk again.
+ */
+static Std_ReturnType write_paged(NvM_BlockConfig_t *block, const uint8_t *data)
+{
+    struct NvM_LogState *lg = log_state();
+    uint8_t chunks = chunk_count(block->block_size);
+    uint8_t chunk_data[NVM_LOG_MAX_CHUNKS][NVM_LOG_CHUNK_SIZE];
+    uint32_t data_crc[NVM_LOG_MAX_CHUNKS];
+    uint8_t dirty = 0;
+    uint8_t dirty_count = 0;
+
+    for (uint8_t c = 0; c < chunks; c++) {
+        uint32_t at = (uint32_t)c * NVM_LOG_CHUNK_SIZE;
+        uint32_t len = ((uint32_t)block->block_size - at < NVM_LOG_CHUNK_SIZE)
+                       ? (uint32_t)block->block_size - at : NVM_LOG_CHUNK_SIZE;
+        const NvM_LogIndexEntry_t *entry = &lg->region.index[block->block_id][c];
+
+        memset(chunk_data[c], 0xFF, NVM_LOG_CHUNK_SIZE);
+        memcpy(chunk_data[c], &data[at], len);
+        data_crc[c] = CRC_CalculateCRC32(chunk_data[c], NVM_LOG_CHUNK_SIZE);
+
+        if (lg->region.rewrite[block->block_id] || entry->page == NVM_LOG_NO_PAGE ||
+            entry->data_crc != data_crc[c]) {
+            dirty |= (uint8_t)(1U << c);
+            dirty_count++;
+        }
+    }
+
+    uint32_t seq = lg->region.next_seq;
+    for (uint8_t c = 0; c < chunks; c++) {
+        if ((dirty & (1U << c)) == 0U) {
+            continue;
+        }
+
+        uint16_t page = NVM_LOG_NO_PAGE;
+        for (uint32_t attempt = 0; page == NVM_LOG_NO_PAGE; attempt++) {
+            if (attempt > (uint32_t)lg->region.sector_count * NVM_LOG_PAGES_PER_SECTOR || !make_room(1)) {
+                LOG_ERROR("NvM: Log region full, LOG block %d chunk %u not written",
+                         block->block_id, c);
+                lg->region.rewrite[block->block_id] = TRUE;
+                return E_NOT_OK;
+            }
+
+            /* Staged after make_room: compaction uses the same buffer */
+            uint8_t *rec = lg->record;
+            rec[0] = NVM_LOG_PAGED_MAGIC;
+            rec[1] = block->block_id;
+            rec[2] = c;
+            rec[3] = dirty_count;
+            store_le(&rec[4], seq, 4);
+            memcpy(&rec[NVM_LOG_HEADER_SIZE], chunk_data[c], NVM_LOG_CHUNK_SIZE);
+            store_le(&rec[NVM_LOG_PAGE_SIZE - 4U], CRC_CalculateCRC32(rec, NVM_LOG_PAGE_SIZE - 4U), 4);
+
+            page = program_record(1);
+        }
+
+        index_set(block->block_id, c, page, 1, data_crc[c]);
+    }
+
+    if (dirty_count > 0U) {
+        lg->region.next_seq++;
+    }
+    lg->region.rewrite[block->block_id] = FALSE;
+    lg->region.stats.records_appended++;
+    lg->region.stats.pages_unchanged += (uint32_t)(chunks - dirty_count);
+
+    block->state = NVM_BLOCKSTATE_VALID;
+    LOG_INFO("NvM: LOG block %d: %u of %u pages appended", block->block_id, dirty_count, chunks);
+    return E_OK;
+}
+
+/**
+ * @brief Read Log Block (current record)
+ */
+Std_ReturnType NvM_ReadLogBlock(NvM_BlockConfig_t *block, void *data)
+{
+    struct NvM_LogState *lg = log_state();
+    const NvM_LogIndexEntry_t *entry = &lg->region.index[block->block_id][0];
+    boolean ok;
+
+    if (!lg->region.configured) {
+        ok = FALSE;
+    } else if (block->delta_pages) {
+        ok = read_paged(block, (uint8_t *)data);
+    } else {
+        ok = (entry->page != NVM_LOG_NO_PAGE && load_record(entry->page, entry->pages) &&
+              lg->record[0] == NVM_LOG_MAGIC &&
+              load_le(&lg->record[2], 2) == block->block_size) ? TRUE : FALSE;
+        if (ok) {
+            memcpy(data, &lg->record[NVM_LOG_HEADER_SIZE], block->block_size);
+        }
+    }
+
+    if (ok) {
+        block->state = NVM_BLOCKSTATE_VALID;
+        return E_OK;
+    }
+
+    if (block->rom_block_ptr != NULL && block->rom_block_size > 0) {
+        LOG_WARN("NvM: LOG block %d has no valid record, loading ROM default", block->block_id);
+        memcpy(data, block->rom_block_ptr,
+               (block->rom_block_size < block->block_size) ? block->rom_block_size : block->block_size);
+    }
+
+    block->state = NVM_BLOCKSTATE_INVALID;
+    return E_NOT_OK;
+}
+
+/**
+ * @brief Write Log Block (append a record)
+ */
+Std_ReturnType NvM_WriteLogBlock(NvM_BlockConfig_t *block, const void *data)
+{
+    struct NvM_LogState *lg = log_state();
+
+    if (!lg->region.configured) {
+        LOG_ERROR("NvM: LOG block %d written without a log region", block->block_id);
+        return E_NOT_OK;
+    }
+
+    if (block->delta_pages) {
+        return write_paged(block, (const uint8_t *)data);
+    }
+
+    uint16_t len = block->block_size;
+    uint8_t pages = record_pages(len);
+    uint16_t page = NVM_LOG_NO_PAGE;
+
+    for (uint32_t attempt = 0; page == NVM_LOG_NO_PAGE; attempt++) {
+        if (attempt > (uint32_t)lg->region.sector_count * NVM_LOG_PAGES_PER_SECTOR || !make_room(pages)) {
+            LOG_ERROR("NvM: Log region full, LOG block %d not written", block->block_id);
+            return E_NOT_OK;
+        }
+
+        /* Staged after make_room: compaction uses the same buffer */
+        uint8_t *rec = lg->record;
+        uint32_t crc_at = record_bytes(len) - 4U;
+        memset(rec, 0xFF, (uint32_t)pages * NVM_LOG_PAGE_SIZE);
+        rec[0] = NVM_LOG_MAGIC;
+        rec[1] = block->block_id;
+        store_le(&rec[2], len, 2);
+        store_le(&rec[4], lg->region.next_seq, 4);
+        memcpy(&rec[NVM_LOG_HEADER_SIZE], data, len);
+        store_le(&rec[crc_at], CRC_CalculateCRC32(rec, crc_at), 4);
+
+        page = program_record(pages);
+    }
+
+    lg->region.next_seq++;
+    index_set(block->block_id, 0, page, pages, 0);
+    lg->region.stats.records_appended++;
+
+    block->state = NVM_BLOCKSTATE_VALID;
+    LOG_INFO("NvM: LOG block %d appended at 0x%X (%u pages)", block->block_id,
+             page_address(page), pages);
+    return E_OK;
+}
+
+const NvM_PartDesc_t NvM_LogPart = {
+    .size = sizeof(struct NvM_LogState),
+    .default_state = &g_default_state
+};
@@ -0,0 +1,105 @@
+/**
+ * @file nvm_preerase.c
+ * @brief Idle-time erase of the next DATASET rotation slot
+ *
+ * REQ-Block管理: design/03-Block管理机制.md §2
+ * - 队列空闲时, 每次NvM_MainFunction擦除一个Dataset Block的下一个轮换槽
+ * - 已擦除的槽记录在Block运行时字段中; 前台写入直接编程, 省去擦除时间
+ * - 代价: 最旧的版本在下次写入之前就已丢失 (读恢复少一个可回退版本)
+ * - 其他Block类型没有空闲槽 (Native/Redundant原地覆盖, LOG由日志压缩擦除)
+ */
+
+#include "nvm.h"
+#include "nvm_internal.h"
+#include "eeprom_layout.h"
+#include "memif.h"
+#include "logging.h"
+
+struct NvM_PreEraseState {
+    uint16_t cursor;                /**< Next registry slot to visit */
+    uint32_t erases;
+    uint32_t hits;
+};
+
+/**
+ * @brief State used while no context is bound
+ */
+static struct NvM_PreEraseState g_default_state;
+
+static struct NvM_PreEraseState* preerase_state(void)
+{
+    return (struct NvM_PreEraseState *)NvM_PartState(NVM_PART_PREERASE);
+}
+
+void NvM_PreErase_Reset(void)
+{
+    struct NvM_PreEraseState *pe = preerase_state();
+
+    pe->cursor = 0;
+    pe->erases = 0;
+    pe->hits = 0;
+}
+
+boolean NvM_PreErase_Step(void)
+{
+    struct NvM_PreEraseState *pe = preerase_state();
+    uint16_t count = NvM_Registry_Count();
+    NvM_BlockConfig_t *blocks = NvM_Registry_Blocks();
+
+    for (uint16_t visited = 0; visited < count; visited++) {
+        uint16_t slot = (uint16_t)((pe->cursor + visited) % count);
+        NvM_BlockConfig_t *block = &blocks[slot];
+
+        /* Until its headers are read the active index may not be the newest slot */
+        if (block->block_type != NVM_BLOCK_DATASET || block->dataset_count < 2U ||
+            block->is_write_protected || !block->dataset_scanned) {
+            continue;
+        }
+
+        uint8_t next = (uint8_t)((block->active_dataset_index + 1U) % block->dataset_count);
+        if (block->pre_erased && block->pre_erased_index == next) {
+            continue;
+        }
+
+        pe->cursor = (uint16_t)((slot + 1U) % count);
+        block->pre_erased = FALSE;
+        if (MemIf_Erase(EEPROM_DatasetVersionOffset(block->eeprom_offset, next),
+                        block->block_size) != E_OK) {
+            LOG_WARN("NvM: Pre-erase of block %d slot %u failed", block->block_id, next);
+            return FALSE;
+        }
+
+        block->pre_erased = TRUE;
+        block->pre_erased_index = next;
+        pe->erases++;
+        LOG_DEBUG("NvM: Pre-erased block %d slot %u", block->block_id, next);
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+boolean NvM_PreErase_Take(NvM_BlockConfig_t *block, uint8_t index)
+{
+    struct NvM_PreEraseState *pe = preerase_state();
+    boolean erased = (block->pre_erased && block->pre_erased_index == index) ? TRUE : FALSE;
+
+    block->pre_erased = FALSE;
+    if (erased) {
+        pe->hits++;
+    }
+    return erased;
+}
+
+void NvM_PreErase_GetCounts(uint32_t *erases, uint32_t *hits)
+{
+    struct NvM_PreEraseState *pe = preerase_state();
+
+    *erases = pe->erases;
+    *hits = pe->hits;
+}
+
+const NvM_PartDesc_t NvM_PreErasePart = {
+    .size = sizeof(struct NvM_PreEraseState),
+    .default_state = &g_default_state
+};
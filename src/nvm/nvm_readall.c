@@ -0,0 +1,307 @@
+/**
+ * @file nvm_readall.c
+ * @brief Pipelined ReadAll over the asynchronous MemIf job engine
+ *
+ * REQ-ReadAll启动加速: design/02-NvM架构设计.md §3
+ * - 按eeprom_offset升序读取, 每个设备一个在途请求, 多设备并行
+ * - 数据与CRC一次读取 (CRC紧随数据存放)
+ * - CRC校验与下一个Block的读取重叠 (双缓冲)
+ * - 每个Block完成即填充RAM镜像并通知
+ */
+
+#include "nvm.h"
+#include "nvm_internal.h"
+#include "nvm_block_types.h"
+#include "eeprom_layout.h"
+#include "memif.h"
+#include "crc.h"
+#include "logging.h"
+#include <string.h>
+
+/**
+ * @brief Largest block handled by the pipeline (data + stored CRC)
+ *
+ * Larger and compressed blocks are read through the synchronous
+ * block-type handler.
+ */
+#define NVM_READALL_STAGING_SIZE (EEPROM_BLOCK_SLOT_SIZE + CRC_MAX_SIZE)
+
+#define NVM_READALL_IDLE 0xFFU
+
+/**
+ * @brief Per-device lane: one read in flight, double-buffered staging
+ */
+typedef struct {
+    uint8_t slot;                  /**< Registration slot in flight, or IDLE */
+    uint8_t buf;                   /**< Staging buffer of the read in flight */
+    uint8_t staging[2][NVM_READALL_STAGING_SIZE];
+} NvM_ReadAllLane_t;
+
+/**
+ * @brief Pipeline state
+ */
+typedef struct {
+    boolean active;
+    NvM_BlockConfig_t *blocks;
+    uint8_t count;
+    uint8_t done_count;
+    uint8_t order[NVM_MAX_BLOCKS];           /**< Slots by ascending primary offset */
+    uint8_t device_of[NVM_MAX_BLOCKS];       /**< MemIf device per slot */
+    boolean submitted[NVM_MAX_BLOCKS];
+    NvM_ReadAllBlockDone_t done;
+    NvM_ReadAllLane_t lanes[MEMIF_MAX_DEVICES];
+} NvM_ReadAllPipeline_t;
+
+/**
+ * @brief Pipelined ReadAll of one context
+ */
+struct NvM_ReadAllState {
+    NvM_ReadAllPipeline_t pipeline;
+};
+
+/**
+ * @brief State used while no context is bound
+ */
+static struct NvM_ReadAllState g_default_state;
+
+static struct NvM_ReadAllState* readall_state(void)
+{
+    return (struct NvM_ReadAllState *)NvM_PartState(NVM_PART_READALL);
+}
+
+/**
+ * @brief Offset of the copy read first (active dataset for DATASET blocks)
+ */
+static uint32_t primary_offset(const NvM_BlockConfig_t *block)
+{
+    if (block->block_type == NVM_BLOCK_DATASET) {
+        return block->eeprom_offset + ((uint32_t)block->active_dataset_index * EEPROM_BLOCK_SLOT_SIZE);
+    }
+
+    return block->eeprom_offset;
+}
+
+static uint32_t request_length(const NvM_BlockConfig_t *block)
+{
+    const Crc_Descriptor_t *crc = NvM_GetBlockCrc(block);
+
+    return (uint32_t)block->block_size + ((crc != NULL) ? crc->crc_size : 0U);
+}
+
+/**
+ * @brief Read a block through its synchronous handler (recovery path)
+ */
+static Std_ReturnType read_block_sync(NvM_BlockConfig_t *block)
+{
+    if (block->ram_mirror_ptr == NULL) {
+        return E_NOT_OK;
+    }
+
+    switch (block->block_type) {
+        case NVM_BLOCK_NATIVE:
+            return NvM_ReadNativeBlock(block, block->ram_mirror_ptr);
+        case NVM_BLOCK_REDUNDANT:
+            return NvM_ReadRedundantBlock(block, block->ram_mirror_ptr);
+        case NVM_BLOCK_DATASET:
+            return NvM_ReadDatasetBlock(block, block->ram_mirror_ptr);
+        case NVM_BLOCK_LOG:
+            return NvM_ReadLogBlock(block, block->ram_mirror_ptr);
+        default:
+            return E_NOT_OK;
+    }
+}
+
+static void finish_block(uint8_t slot, Std_ReturnType result)
+{
+    struct NvM_ReadAllState *ra = readall_state();
+
+    ra->pipeline.done_count++;
+    ra->pipeline.done(&ra->pipeline.blocks[slot], result);
+}
+
+/**
+ * @brief Verify a staged primary copy and publish it to the RAM mirror
+ *
+ * A failed primary read falls back to the block-type handler, which
+ * retries the primary and then tries backup copies and ROM defaults.
+ */
+static void verify_block(uint8_t slot, const uint8_t *staged, boolean read_ok)
+{
+    struct NvM_ReadAllState *ra = readall_state();
+    NvM_BlockConfig_t *block = &ra->pipeline.blocks[slot];
+    const Crc_Descriptor_t *crc = NvM_GetBlockCrc(block);
+
+    if (read_ok && crc != NULL && crc->crc_size > 0U) {
+        uint32_t stored = CRC_Load(crc, &staged[block->block_size]);
+        read_ok = (stored == crc->calculate(staged, block->block_size)) ? TRUE : FALSE;
+    }
+
+    if (read_ok) {
+        memcpy(block->ram_mirror_ptr, staged, block->block_size);
+        block->state = NVM_BLOCKSTATE_VALID;
+        finish_block(slot, E_OK);
+        return;
+    }
+
+    LOG_WARN("NvM: ReadAll - block %d primary copy failed, recovering", block->block_id);
+    finish_block(slot, read_block_sync(block));
+}
+
+static void lane_read_done(const MemIf_Job_t *job, void *user_ctx);
+
+/**
+ * @brief Start the next read of a device, in ascending offset order
+ *
+ * Blocks that cannot go through the pipeline are handled synchronously.
+ */
+static void lane_submit_next(uint8_t device)
+{
+    struct NvM_ReadAllState *ra = readall_state();
+    NvM_ReadAllLane_t *lane = &ra->pipeline.lanes[device];
+
+    for (uint8_t i = 0; i < ra->pipeline.count && lane->slot == NVM_READALL_IDLE; i++) {
+        uint8_t slot = ra->pipeline.order[i];
+        if (ra->pipeline.submitted[slot] || ra->pipeline.device_of[slot] != device) {
+            continue;
+        }
+
+        NvM_BlockConfig_t *block = &ra->pipeline.blocks[slot];
+        uint8_t buf = (uint8_t)(lane->buf ^ 1U);
+        uint32_t length = request_length(block);
+        ra->pipeline.submitted[slot] = TRUE;
+
+        /* Compressed blocks read only their stored length, through the handler */
+        if (block->ram_mirror_ptr == NULL || length > NVM_READALL_STAGING_SIZE ||
+            block->compression != NVM_COMPRESSION_NONE) {
+            finish_block(slot, read_block_sync(block));
+            continue;
+        }
+
+        if (MemIf_SubmitRead(primary_offset(block), lane->staging[buf], length,
+                             lane_read_done, lane) != E_OK) {
+            if (MemIf_GetDeviceJobStatus(device) == MEMIF_JOB_PENDING) {
+                /* Device slot taken by another user: retry on the next poll */
+                ra->pipeline.submitted[slot] = FALSE;
+                return;
+            }
+            finish_block(slot, read_block_sync(block));
+            continue;
+        }
+
+        lane->slot = slot;
+        lane->buf = buf;
+    }
+}
+
+/**
+ * @brief MemIf end notification of a lane read
+ *
+ * The next read is queued before verification so the device keeps
+ * streaming while the CRC of this block is checked.
+ */
+static void lane_read_done(const MemIf_Job_t *job, void *user_ctx)
+{
+    struct NvM_ReadAllState *ra = readall_state();
+    NvM_ReadAllLane_t *lane = (NvM_ReadAllLane_t *)user_ctx;
+    boolean read_ok = (job->status == MEMIF_JOB_OK) ? TRUE : FALSE;
+    uint8_t slot = lane->slot;
+    uint8_t buf = lane->buf;
+
+    if (!ra->pipeline.active || slot == NVM_READALL_IDLE) {
+        return;
+    }
+
+    /* job points into the MemIf slot, which the next submit reuses */
+    lane->slot = NVM_READALL_IDLE;
+    lane_submit_next((uint8_t)(lane - ra->pipeline.lanes));
+
+    verify_block(slot, lane->staging[buf], read_ok);
+}
+
+void NvM_ReadAllPipeline_Start(NvM_BlockConfig_t *blocks, uint8_t count, NvM_ReadAllBlockDone_t done)
+{
+    struct NvM_ReadAllState *ra = readall_state();
+
+    memset(&ra->pipeline, 0, sizeof(ra->pipeline));
+    ra->pipeline.blocks = blocks;
+    ra->pipeline.count = count;
+    ra->pipeline.done = done;
+
+    for (uint32_t d = 0; d < MEMIF_MAX_DEVICES; d++) {
+        ra->pipeline.lanes[d].slot = NVM_READALL_IDLE;
+    }
+
+    /* Dataset blocks: read headers only, so the pass streams the newest slot */
+    for (uint8_t i = 0; i < count; i++) {
+        NvM_ScanDatasetHeaders(&blocks[i]);
+    }
+
+    /* Insertion sort by primary offset (count <= NVM_MAX_BLOCKS) */
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t j = i;
+        while (j > 0U && primary_offset(&blocks[ra->pipeline.order[j - 1U]]) > primary_offset(&blocks[i])) {
+            ra->pipeline.order[j] = ra->pipeline.order[j - 1U];
+            j--;
+        }
+        ra->pipeline.order[j] = i;
+
+        /* LOG records are located through the log index, not streamed */
+        MemIf_DeviceIdType device;
+        if (blocks[i].block_type == NVM_BLOCK_LOG ||
+            MemIf_GetDeviceForAddress(primary_offset(&blocks[i]), &device) != E_OK) {
+            device = NVM_READALL_IDLE;
+        }
+        ra->pipeline.device_of[i] = device;
+    }
+
+    ra->pipeline.active = TRUE;
+    LOG_INFO("NvM: ReadAll - pipelined read of %u blocks", count);
+
+    /* Unroutable primaries cannot be streamed; let the handler read or report them */
+    for (uint8_t i = 0; i < count; i++) {
+        if (ra->pipeline.device_of[i] == NVM_READALL_IDLE) {
+            ra->pipeline.submitted[i] = TRUE;
+            finish_block(i, read_block_sync(&blocks[i]));
+        }
+    }
+
+    for (uint8_t d = 0; d < MEMIF_MAX_DEVICES; d++) {
+        lane_submit_next(d);
+    }
+}
+
+boolean NvM_ReadAllPipeline_Poll(void)
+{
+    struct NvM_ReadAllState *ra = readall_state();
+
+    if (!ra->pipeline.active) {
+        return TRUE;
+    }
+
+    MemIf_MainFunction();
+
+    for (uint8_t d = 0; d < MEMIF_MAX_DEVICES; d++) {
+        if (ra->pipeline.lanes[d].slot == NVM_READALL_IDLE) {
+            lane_submit_next(d);
+        }
+    }
+
+    if (ra->pipeline.done_count < ra->pipeline.count) {
+        return FALSE;
+    }
+
+    ra->pipeline.active = FALSE;
+    return TRUE;
+}
+
+void NvM_ReadAllPipeline_Reset(void)
+{
+    struct NvM_ReadAllState *ra = readall_state();
+
+    ra->pipeline.active = FALSE;
+}
+
+const NvM_PartDesc_t NvM_ReadAllPart = {
+    .size = sizeof(struct NvM_ReadAllState),
+    .default_state = &g_default_state
+};
@@ -0,0 +1,218 @@
+/**
+ * @file nvm_registry.c
+ * @brief NvM block registry: O(1) block_id lookup over a growable block table
+ *
+ * REQ-Block管理: design/03-Block管理机制.md §2
+ * - block_id -> 槽位 直接映射表, 覆盖完整的NvM_BlockIdType范围
+ * - 热字段 (ID/偏移/大小/类型/状态) 按结构数组(SoA)存放, 扫描只触及所需字段
+ * - 冷配置 (NvM_BlockConfig_t) 单独存放, 按需扩容
+ */
+
+#include "nvm.h"
+#include "nvm_internal.h"
+#include "logging.h"
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Initial slot capacity (doubled on demand up to NVM_MAX_BLOCKS)
+ */
+#define NVM_REGISTRY_INITIAL_CAPACITY 16U
+
+/**
+ * @brief Registry state
+ */
+typedef struct {
+    uint16_t count;
+    uint16_t capacity;
+    uint8_t index[NVM_BLOCK_ID_COUNT];   /**< block_id -> slot, NVM_REGISTRY_NONE if absent */
+
+    /* Hot fields, slot-indexed */
+    uint8_t *block_id;
+    uint32_t *offset;
+    uint16_t *size;
+    uint8_t *type;
+    uint8_t *state;
+
+    /* Cold configuration, slot-indexed */
+    NvM_BlockConfig_t *config;
+} NvM_BlockRegistry_t;
+
+/**
+ * @brief Registry used while no context is bound
+ */
+static NvM_BlockRegistry_t g_default_state = {
+    .index = { [0 ... (NVM_BLOCK_ID_COUNT - 1U)] = NVM_REGISTRY_NONE }
+};
+
+static NvM_BlockRegistry_t* registry(void)
+{
+    return (NvM_BlockRegistry_t *)NvM_PartState(NVM_PART_REGISTRY);
+}
+
+/**
+ * @brief Grow one slot-indexed array, keeping its content
+ */
+static boolean grow_array(void **array, size_t elem_size, uint16_t capacity)
+{
+    void *p = realloc(*array, elem_size * capacity);
+    if (p == NULL) {
+        return FALSE;
+    }
+
+    *array = p;
+    return TRUE;
+}
+
+static Std_ReturnType registry_reserve(uint16_t needed)
+{
+    NvM_BlockRegistry_t *reg = registry();
+
+    if (needed <= reg->capacity) {
+        return E_OK;
+    }
+
+    uint16_t capacity = (reg->capacity == 0U) ? NVM_REGISTRY_INITIAL_CAPACITY
+                                                    : (uint16_t)(reg->capacity * 2U);
+    if (capacity > NVM_MAX_BLOCKS) {
+        capacity = NVM_MAX_BLOCKS;
+    }
+
+    if (!grow_array((void **)&reg->block_id, sizeof(uint8_t), capacity) ||
+        !grow_array((void **)&reg->offset, sizeof(uint32_t), capacity) ||
+        !grow_array((void **)&reg->size, sizeof(uint16_t), capacity) ||
+        !grow_array((void **)&reg->type, sizeof(uint8_t), capacity) ||
+        !grow_array((void **)&reg->state, sizeof(uint8_t), capacity) ||
+        !grow_array((void **)&reg->config, sizeof(NvM_BlockConfig_t), capacity)) {
+        /* Arrays already grown stay valid; capacity reflects the smallest */
+        LOG_ERROR("NvM: Block registry allocation failed (capacity=%u)", capacity);
+        return E_NOT_OK;
+    }
+
+    reg->capacity = capacity;
+    return E_OK;
+}
+
+static void registry_load_hot(uint16_t slot)
+{
+    NvM_BlockRegistry_t *reg = registry();
+    const NvM_BlockConfig_t *cfg = &reg->config[slot];
+
+    reg->block_id[slot] = cfg->block_id;
+    reg->offset[slot] = cfg->eeprom_offset;
+    reg->size[slot] = cfg->block_size;
+    reg->type[slot] = (uint8_t)cfg->block_type;
+    reg->state[slot] = (uint8_t)cfg->state;
+}
+
+/**
+ * @brief Free the slot arrays and mark every block ID unregistered
+ */
+static void registry_clear(void *state)
+{
+    NvM_BlockRegistry_t *reg = (NvM_BlockRegistry_t *)state;
+
+    free(reg->block_id);
+    free(reg->offset);
+    free(reg->size);
+    free(reg->type);
+    free(reg->state);
+    free(reg->config);
+
+    memset(reg, 0, sizeof(*reg));
+    memset(reg->index, NVM_REGISTRY_NONE, sizeof(reg->index));
+}
+
+void NvM_Registry_Reset(void)
+{
+    registry_clear(registry());
+}
+
+NvM_BlockConfig_t* NvM_Registry_Add(const NvM_BlockConfig_t *block_config)
+{
+    NvM_BlockRegistry_t *reg = registry();
+    uint8_t slot = reg->index[block_config->block_id];
+
+    if (block_config->block_id == NVM_REGISTRY_NONE) {
+        return NULL;  /* Reserved for ReadAll/WriteAll */
+    }
+
+    /* Re-registration replaces the configuration in place */
+    if (slot == NVM_REGISTRY_NONE) {
+        if (reg->count >= NVM_MAX_BLOCKS || registry_reserve(reg->count + 1U) != E_OK) {
+            return NULL;
+        }
+        slot = (uint8_t)reg->count++;
+        reg->index[block_config->block_id] = slot;
+    }
+
+    reg->config[slot] = *block_config;
+    registry_load_hot(slot);
+    return &reg->config[slot];
+}
+
+NvM_BlockConfig_t* NvM_Registry_Find(uint8_t block_id)
+{
+    NvM_BlockRegistry_t *reg = registry();
+    uint8_t slot = reg->index[block_id];
+
+    return (slot == NVM_REGISTRY_NONE) ? NULL : &reg->config[slot];
+}
+
+uint16_t NvM_Registry_Count(void)
+{
+    NvM_BlockRegistry_t *reg = registry();
+
+    return reg->count;
+}
+
+NvM_BlockConfig_t* NvM_Registry_Blocks(void)
+{
+    NvM_BlockRegistry_t *reg = registry();
+
+    return reg->config;
+}
+
+uint32_t NvM_Registry_Offset(uint16_t slot)
+{
+    NvM_BlockRegistry_t *reg = registry();
+
+    return reg->offset[slot];
+}
+
+uint8_t NvM_Registry_BlockId(uint16_t slot)
+{
+    NvM_BlockRegistry_t *reg = registry();
+
+    return reg->block_id[slot];
+}
+
+void NvM_Registry_SyncState(const NvM_BlockConfig_t *block)
+{
+    NvM_BlockRegistry_t *reg = registry();
+    uint16_t slot = (uint16_t)(block - reg->config);
+
+    if (slot < reg->count) {
+        reg->state[slot] = (uint8_t)block->state;
+    }
+}
+
+Std_ReturnType NvM_Registry_GetState(uint8_t block_id, uint8_t *state)
+{
+    NvM_BlockRegistry_t *reg = registry();
+    uint8_t slot = reg->index[block_id];
+
+    if (slot == NVM_REGISTRY_NONE) {
+        return E_NOT_OK;
+    }
+
+    *state = reg->state[slot];
+    return E_OK;
+}
+
+const NvM_PartDesc_t NvM_RegistryPart = {
+    .size = sizeof(NvM_BlockRegistry_t),
+    .default_state = &g_default_state,
+    .init = registry_clear,
+    .release = registry_clear
+};
@@ -0,0 +1,195 @@
+/**
+ * @file nvm_retry.c
+ * @brief Deferred retry of failed single-block jobs (exponential backoff, virtual time)
+ *
+ * REQ-NvM核心模块: design/02-NvM架构设计.md §3
+ * - 失败的ReadBlock/WriteBlock作业搁置到"不早于"时间点, 期间其他作业照常处理
+ * - 等待时间指数增长并加随机抖动 (确定性伪随机, 仿真可复现), 可设上限
+ * - 重试次数用尽、等待超出作业超时或搁置位已满时才报告失败
+ * - 同一Block更新的写入取代搁置中的写重试 (避免旧数据覆盖新数据)
+ */
+
+#include "nvm.h"
+#include "nvm_internal.h"
+#include "nvm_jobqueue.h"
+#include "logging.h"
+#include <string.h>
+
+/**
+ * @brief Jitter stream seed (fixed: runs repeat exactly)
+ */
+#define NVM_RETRY_SEED 0x9E3779B9U
+
+typedef struct {
+    boolean in_use;
+    uint32_t not_before_ms;
+    NvM_Job_t job;                  /**< retry_count already counts this attempt */
+} NvM_RetrySlot_t;
+
+struct NvM_RetryState {
+    NvM_RetryPolicy_t policy;
+    uint32_t random;                /**< xorshift32 state */
+    NvM_RetrySlot_t slots[NVM_RETRY_QUEUE_SIZE];
+    uint32_t retried;
+    uint32_t exhausted;
+};
+
+/**
+ * @brief State used while no context is bound
+ */
+static struct NvM_RetryState g_default_state;
+
+static struct NvM_RetryState* retry_state(void)
+{
+    return (struct NvM_RetryState *)NvM_PartState(NVM_PART_RETRY);
+}
+
+static uint32_t next_random(void)
+{
+    struct NvM_RetryState *rt = retry_state();
+    uint32_t x = rt->random;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rt->random = x;
+    return x;
+}
+
+/**
+ * @brief Wait before attempt number retry + 1 (retry = retries so far)
+ */
+static uint32_t backoff_ms(uint8_t retry)
+{
+    struct NvM_RetryState *rt = retry_state();
+    const NvM_RetryPolicy_t *policy = &rt->policy;
+    uint32_t delay = policy->base_delay_ms;
+
+    for (uint8_t i = 0; i < retry && delay < 0x80000000U; i++) {
+        delay <<= 1;
+    }
+    if (policy->max_delay_ms != 0U && delay > policy->max_delay_ms) {
+        delay = policy->max_delay_ms;
+    }
+
+    uint32_t jitter = (uint32_t)(((uint64_t)delay * policy->jitter_percent) / 100U);
+    if (jitter > 0U) {
+        delay += next_random() % (jitter + 1U);
+    }
+
+    return delay;
+}
+
+void NvM_Retry_Reset(void)
+{
+    struct NvM_RetryState *rt = retry_state();
+
+    memset(rt, 0, sizeof(*rt));
+    rt->random = NVM_RETRY_SEED;
+}
+
+void NvM_Retry_SetPolicy(const NvM_RetryPolicy_t *policy)
+{
+    struct NvM_RetryState *rt = retry_state();
+
+    if (policy == NULL) {
+        memset(&rt->policy, 0, sizeof(rt->policy));
+    } else {
+        rt->policy = *policy;
+    }
+}
+
+boolean NvM_Retry_Defer(const NvM_Job_t *job, uint32_t now_ms)
+{
+    struct NvM_RetryState *rt = retry_state();
+
+    if (rt->policy.base_delay_ms == 0U ||
+        (job->job_type != NVM_JOB_READ && job->job_type != NVM_JOB_WRITE)) {
+        return FALSE;
+    }
+
+    if (job->retry_count >= job->max_retries) {
+        LOG_WARN("NvM: Block %d failed after %u retries", job->block_id, job->retry_count);
+        rt->exhausted++;
+        return FALSE;
+    }
+
+    uint32_t not_before = now_ms + backoff_ms(job->retry_count);
+    if (job->timeout_ms != 0U && (not_before - job->submit_time_ms) >= job->timeout_ms) {
+        LOG_WARN("NvM: Block %d retry would run past its %ums timeout", job->block_id,
+                 job->timeout_ms);
+        rt->exhausted++;
+        return FALSE;
+    }
+
+    for (uint32_t i = 0; i < NVM_RETRY_QUEUE_SIZE; i++) {
+        NvM_RetrySlot_t *slot = &rt->slots[i];
+        if (slot->in_use) {
+            continue;
+        }
+
+        slot->in_use = TRUE;
+        slot->not_before_ms = not_before;
+        slot->job = *job;
+        slot->job.retry_count++;
+        rt->retried++;
+        LOG_INFO("NvM: Block %d retry %u/%u at %ums", job->block_id, slot->job.retry_count,
+                 job->max_retries, not_before);
+        return TRUE;
+    }
+
+    LOG_WARN("NvM: No room to retry block %d", job->block_id);
+    rt->exhausted++;
+    return FALSE;
+}
+
+void NvM_Retry_Release(uint32_t now_ms)
+{
+    struct NvM_RetryState *rt = retry_state();
+
+    for (uint32_t i = 0; i < NVM_RETRY_QUEUE_SIZE; i++) {
+        NvM_RetrySlot_t *slot = &rt->slots[i];
+        if (!slot->in_use || (int32_t)(now_ms - slot->not_before_ms) < 0) {
+            continue;
+        }
+
+        /* Coalescing would put the old data over the newer write */
+        if (slot->job.job_type == NVM_JOB_WRITE &&
+            NvM_JobQueue_FindPendingWrite(slot->job.block_id) != NULL) {
+            LOG_DEBUG("NvM: Retry of block %d superseded by a newer write", slot->job.block_id);
+            slot->in_use = FALSE;
+            continue;
+        }
+
+        if (NvM_JobQueue_Enqueue(&slot->job) != E_OK) {
+            /* Queue full: try again on the next call */
+            return;
+        }
+        slot->in_use = FALSE;
+    }
+}
+
+void NvM_Retry_Cancel(uint8_t block_id)
+{
+    struct NvM_RetryState *rt = retry_state();
+
+    for (uint32_t i = 0; i < NVM_RETRY_QUEUE_SIZE; i++) {
+        NvM_RetrySlot_t *slot = &rt->slots[i];
+        if (slot->in_use && slot->job.job_type == NVM_JOB_WRITE && slot->job.block_id == block_id) {
+            slot->in_use = FALSE;
+        }
+    }
+}
+
+void NvM_Retry_GetCounts(uint32_t *retried, uint32_t *exhausted)
+{
+    struct NvM_RetryState *rt = retry_state();
+
+    *retried = rt->retried;
+    *exhausted = rt->exhausted;
+}
+
+const NvM_PartDesc_t NvM_RetryPart = {
+    .size = sizeof(struct NvM_RetryState),
+    .default_state = &g_default_state
+};
@@ -0,0 +1,301 @@
+/**
+ * @file nvm_shm.c
+ * @brief Shared-memory NvM server
+ *
+ * REQ-NvM核心模块: design/02-NvM架构设计.md §3
+ * - 启动时按已注册Block分配共享对象: 头部、Block表、请求环, 载荷区按缓存行对齐
+ * - 轮询: 单消费者取出请求, 以共享载荷为缓冲调用NvM_ReadBlock/NvM_WriteBlock
+ * - 作业结束/出错通知时发布结果与Block状态, 完成计数加一, 有等待者才futex唤醒
+ * - NvM不接受的请求立即以NVM_REQ_NOT_OK完成, 客户端不会空等
+ */
+
+#define _GNU_SOURCE
+
+#include "nvm_shm.h"
+#include "nvm_shm_layout.h"
+#include "nvm_internal.h"
+#include "logging.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+struct NvM_ShmState {
+    NvM_ShmRegion_t *region;        /**< NULL while stopped */
+    size_t size;
+    char name[NVM_SHM_NAME_MAX];
+    char device_path[NVM_SHM_PATH_MAX];
+    Eeprom_ConfigType device;       /**< Eep keeps the image_path pointer */
+    NvM_ShmServerStats_t stats;
+};
+
+/**
+ * @brief State used while no context is bound
+ */
+static struct NvM_ShmState g_default_state;
+
+static struct NvM_ShmState* shm_state(void)
+{
+    return (struct NvM_ShmState *)NvM_PartState(NVM_PART_SHM);
+}
+
+static size_t align_line(size_t size)
+{
+    return (size + NVM_SHM_CACHE_LINE - 1U) & ~(size_t)(NVM_SHM_CACHE_LINE - 1U);
+}
+
+static boolean name_valid(const char *name)
+{
+    if (name == NULL || name[0] != '/' || name[1] == '\0' ||
+        strlen(name) >= NVM_SHM_NAME_MAX || strchr(&name[1], '/') != NULL) {
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief Re-initialize the device on an image in /dev/shm
+ */
+static Std_ReturnType share_device(const NvM_ShmServerConfig_t *config)
+{
+    struct NvM_ShmState *srv = shm_state();
+
+    (void)snprintf(srv->device_path, sizeof(srv->device_path), "/dev/shm%s.eep",
+                   config->name);
+    srv->device = *config->device;
+    srv->device.image_path = srv->device_path;
+    srv->device.backend = NULL;
+
+    if (Eep_Init(&srv->device) != E_OK) {
+        LOG_ERROR("NvM Shm: Device image %s not mapped", srv->device_path);
+        return E_NOT_OK;
+    }
+    return E_OK;
+}
+
+/**
+ * @brief Publish the state of a block to clients
+ */
+static void publish_state(NvM_ShmBlock_t *entry, NvM_BlockIdType block_id)
+{
+    uint8_t state = 0U;
+
+    if (NvM_Registry_GetState(block_id, &state) == E_OK) {
+        __atomic_store_n(&entry->state, state, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Complete the in-flight client request of a block
+ */
+static void complete(NvM_ShmBlock_t *entry, uint8_t result)
+{
+    __atomic_store_n(&entry->result, result, __ATOMIC_RELAXED);
+    __atomic_store_n(&entry->in_flight, 0U, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&entry->completions, 1U, __ATOMIC_RELEASE);
+
+    /* Pairs with the waiter's increment: either it sees the count or we see it */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&entry->waiters, __ATOMIC_RELAXED) > 0U) {
+        NvM_Shm_FutexWake(&entry->completions);
+    }
+}
+
+Std_ReturnType NvM_ShmServer_Start(const NvM_ShmServerConfig_t *config)
+{
+    struct NvM_ShmState *srv = shm_state();
+
+    if (srv->region != NULL || config == NULL || !name_valid(config->name)) {
+        return E_NOT_OK;
+    }
+
+    memset(&srv->stats, 0, sizeof(srv->stats));
+    srv->device_path[0] = '\0';
+    if (config->device != NULL && share_device(config) != E_OK) {
+        return E_NOT_OK;
+    }
+
+    /* Payloads follow the fixed part, one cache-line aligned buffer per block */
+    size_t size = align_line(sizeof(NvM_ShmRegion_t));
+    for (uint32_t id = 0; id < NVM_BLOCK_ID_COUNT; id++) {
+        const NvM_BlockConfig_t *block = NvM_Registry_Find((uint8_t)id);
+        if (block != NULL) {
+            size += align_line(block->block_size);
+        }
+    }
+
+    (void)shm_unlink(config->name);
+    int fd = shm_open(config->name, O_RDWR | O_CREAT | O_EXCL, 0660);
+    if (fd < 0) {
+        LOG_ERROR("NvM Shm: Cannot create %s", config->name);
+        return E_NOT_OK;
+    }
+    if (ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        (void)shm_unlink(config->name);
+        return E_NOT_OK;
+    }
+    void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        (void)shm_unlink(config->name);
+        return E_NOT_OK;
+    }
+
+    /* A new object reads as zeros: only non-zero fields are set */
+    NvM_ShmRegion_t *region = (NvM_ShmRegion_t *)base;
+    region->version = NVM_SHM_VERSION;
+    region->size = size;
+    region->server_pid = (uint32_t)getpid();
+    if (srv->device_path[0] != '\0') {
+        const Eeprom_ConfigType *eep = Eep_GetConfig();
+        region->device_size = (eep != NULL) ? eep->capacity_bytes : 0U;
+        memcpy(region->device_path, srv->device_path, sizeof(region->device_path));
+    }
+    for (uint32_t i = 0; i < NVM_SHM_RING_SIZE; i++) {
+        region->ring[i].seq = i;
+    }
+
+    size_t offset = align_line(sizeof(NvM_ShmRegion_t));
+    for (uint32_t id = 0; id < NVM_BLOCK_ID_COUNT; id++) {
+        const NvM_BlockConfig_t *block = NvM_Registry_Find((uint8_t)id);
+        if (block == NULL) {
+            continue;
+        }
+        NvM_ShmBlock_t *entry = &region->blocks[id];
+        entry->block_size = block->block_size;
+        entry->block_type = (uint8_t)block->block_type;
+        entry->payload_offset = (uint32_t)offset;
+        entry->result = NVM_REQ_OK;
+        publish_state(entry, (NvM_BlockIdType)id);
+        offset += align_line(block->block_size);
+        srv->stats.blocks++;
+    }
+
+    (void)snprintf(srv->name, sizeof(srv->name), "%s", config->name);
+    srv->size = size;
+    region->running = 1U;
+    /* Clients check the magic last */
+    __atomic_store_n(&region->magic, NVM_SHM_MAGIC, __ATOMIC_RELEASE);
+    __atomic_store_n(&srv->region, region, __ATOMIC_RELEASE);
+
+    LOG_INFO("NvM Shm: Serving %u blocks on %s (%zu bytes)", srv->stats.blocks,
+             config->name, size);
+    return E_OK;
+}
+
+uint32_t NvM_ShmServer_Poll(void)
+{
+    struct NvM_ShmState *srv = shm_state();
+    NvM_ShmRegion_t *region = srv->region;
+    uint32_t taken = 0U;
+
+    if (region == NULL) {
+        return 0U;
+    }
+
+    for (;;) {
+        uint32_t pos = region->tail;
+        NvM_ShmRequest_t *slot = &region->ring[pos & NVM_SHM_RING_MASK];
+
+        /* A claimed slot whose request is still being filled also reads as empty */
+        if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != pos + 1U) {
+            break;
+        }
+        NvM_ShmRequest_t request = *slot;
+        __atomic_store_n(&slot->seq, pos + NVM_SHM_RING_SIZE, __ATOMIC_RELEASE);
+        region->tail = pos + 1U;
+        taken++;
+        srv->stats.requests++;
+
+        NvM_ShmBlock_t *entry = &region->blocks[request.block_id];
+        uint8_t *payload = (uint8_t *)region + entry->payload_offset;
+        Std_ReturnType ret = E_NOT_OK;
+
+        /* Payload offsets come from this process: a stray request cannot redirect them */
+        if (entry->block_size != 0U &&
+            __atomic_load_n(&entry->owner, __ATOMIC_ACQUIRE) == request.client) {
+            ret = (request.op == (uint8_t)NVM_SHM_OP_WRITE)
+                      ? NvM_WriteBlock(request.block_id, payload)
+                      : NvM_ReadBlock(request.block_id, payload);
+        }
+        if (ret != E_OK) {
+            LOG_WARN("NvM Shm: Request for block %d from client %u refused", request.block_id,
+                     request.client);
+            srv->stats.refused++;
+            if (entry->block_size != 0U) {
+                complete(entry, NVM_REQ_NOT_OK);
+            }
+        }
+    }
+    return taken;
+}
+
+void NvM_Shm_Complete(NvM_BlockIdType block_id)
+{
+    struct NvM_ShmState *srv = shm_state();
+    NvM_ShmRegion_t *region = __atomic_load_n(&srv->region, __ATOMIC_ACQUIRE);
+
+    if (region == NULL || region->blocks[block_id].block_size == 0U) {
+        return;
+    }
+
+    NvM_ShmBlock_t *entry = &region->blocks[block_id];
+    publish_state(entry, block_id);
+    if (__atomic_load_n(&entry->in_flight, __ATOMIC_ACQUIRE) != 0U) {
+        uint8_t result = NVM_REQ_NOT_OK;
+        (void)NvM_GetJobResult(block_id, &result);
+        complete(entry, result);
+    }
+}
+
+void NvM_ShmServer_Stop(void)
+{
+    struct NvM_ShmState *srv = shm_state();
+    NvM_ShmRegion_t *region = srv->region;
+
+    if (region == NULL) {
+        return;
+    }
+
+    __atomic_store_n(&srv->region, NULL, __ATOMIC_RELEASE);
+    __atomic_store_n(&region->running, 0U, __ATOMIC_SEQ_CST);
+
+    /* Sleeping clients re-check running */
+    for (uint32_t id = 0; id < NVM_BLOCK_ID_COUNT; id++) {
+        if (__atomic_load_n(&region->blocks[id].waiters, __ATOMIC_RELAXED) > 0U) {
+            NvM_Shm_FutexWake(&region->blocks[id].completions);
+        }
+    }
+
+    (void)shm_unlink(srv->name);
+    (void)munmap(region, srv->size);
+    LOG_INFO("NvM Shm: %s stopped after %u requests", srv->name, srv->stats.requests);
+}
+
+Std_ReturnType NvM_ShmServer_GetStats(NvM_ShmServerStats_t *stats)
+{
+    struct NvM_ShmState *srv = shm_state();
+    NvM_ShmRegion_t *region = srv->region;
+
+    if (stats == NULL || region == NULL) {
+        return E_NOT_OK;
+    }
+
+    *stats = srv->stats;
+    stats->rejected = __atomic_load_n(&region->rejected, __ATOMIC_RELAXED);
+    return E_OK;
+}
+
+static void shm_release(void *state)
+{
+    (void)state;
+    NvM_ShmServer_Stop();
+}
+
+const NvM_PartDesc_t NvM_ShmPart = {
+    .size = sizeof(struct NvM_ShmState),
+    .default_state = &g_default_state,
+    .release = shm_release
+};
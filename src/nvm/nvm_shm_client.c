@@ -0,0 +1,323 @@
+/**
+ * @file nvm_shm_client.c
+ * @brief Client library of the shared-memory NvM server
+ *
+ * REQ-NvM核心模块: design/02-NvM架构设计.md §3
+ * - 连接: 映射服务端共享对象, 校验魔数/版本/服务端进程仍在
+ * - 占用: CAS抢占Block载荷所有权; 所有者已退出且无在途请求时可接管
+ * - 提交: 多生产者环, 每槽序号, CAS抢占位置, 环满时拒绝 (背压)
+ * - 等待: 等待者计数 + futex, 与nvm_wait.c相同的先加计数再检查顺序
+ */
+
+#define _GNU_SOURCE
+
+#include "nvm_shm.h"
+#include "nvm_shm_layout.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static NvM_ShmRegion_t *region_of(const NvM_ShmClient_t *client)
+{
+    return (client != NULL) ? (NvM_ShmRegion_t *)client->region : NULL;
+}
+
+static boolean server_running(const NvM_ShmRegion_t *region)
+{
+    return (__atomic_load_n(&region->running, __ATOMIC_ACQUIRE) != 0U) ? TRUE : FALSE;
+}
+
+static boolean process_gone(uint32_t pid)
+{
+    return (kill((pid_t)pid, 0) != 0 && errno == ESRCH) ? TRUE : FALSE;
+}
+
+static NvM_ShmBlock_t *owned_block(const NvM_ShmClient_t *client, NvM_BlockIdType block_id)
+{
+    NvM_ShmRegion_t *region = region_of(client);
+
+    if (region == NULL || region->blocks[block_id].block_size == 0U ||
+        __atomic_load_n(&region->blocks[block_id].owner, __ATOMIC_ACQUIRE) != client->id) {
+        return NULL;
+    }
+    return &region->blocks[block_id];
+}
+
+Std_ReturnType NvM_ShmClient_Connect(NvM_ShmClient_t *client, const char *name)
+{
+    struct stat st;
+
+    if (client == NULL || name == NULL) {
+        return E_NOT_OK;
+    }
+    memset(client, 0, sizeof(NvM_ShmClient_t));
+
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+        return E_NOT_OK;
+    }
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(NvM_ShmRegion_t)) {
+        close(fd);
+        return E_NOT_OK;
+    }
+    void *base = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return E_NOT_OK;
+    }
+
+    /* A server that died without NvM_ShmServer_Stop leaves running set */
+    NvM_ShmRegion_t *region = (NvM_ShmRegion_t *)base;
+    if (__atomic_load_n(&region->magic, __ATOMIC_ACQUIRE) != NVM_SHM_MAGIC ||
+        region->version != NVM_SHM_VERSION || region->size != (uint64_t)st.st_size ||
+        !server_running(region) || process_gone(region->server_pid)) {
+        (void)munmap(base, (size_t)st.st_size);
+        return E_NOT_OK;
+    }
+
+    client->region = base;
+    client->size = (size_t)st.st_size;
+    client->id = (uint32_t)getpid();
+
+    /* The device image is optional: requests work without it */
+    if (region->device_size != 0U) {
+        fd = open(region->device_path, O_RDONLY);
+        if (fd >= 0) {
+            void *device = mmap(NULL, region->device_size, PROT_READ, MAP_SHARED, fd, 0);
+            close(fd);
+            if (device != MAP_FAILED) {
+                client->device = (const uint8_t *)device;
+                client->device_size = region->device_size;
+            }
+        }
+    }
+    return E_OK;
+}
+
+void NvM_ShmClient_Disconnect(NvM_ShmClient_t *client)
+{
+    if (client == NULL || client->region == NULL) {
+        return;
+    }
+
+    if (client->device != NULL) {
+        (void)munmap((void *)client->device, client->device_size);
+    }
+    (void)munmap(client->region, client->size);
+    memset(client, 0, sizeof(NvM_ShmClient_t));
+}
+
+uint8_t* NvM_ShmClient_Acquire(NvM_ShmClient_t *client, NvM_BlockIdType block_id, uint16_t *size)
+{
+    NvM_ShmRegion_t *region = region_of(client);
+
+    if (region == NULL || !server_running(region) || region->blocks[block_id].block_size == 0U) {
+        return NULL;
+    }
+
+    NvM_ShmBlock_t *entry = &region->blocks[block_id];
+    uint32_t owner = 0U;
+    if (!__atomic_compare_exchange_n(&entry->owner, &owner, client->id, FALSE,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        /* Already ours (kept after a timed-out wait), or take over from an
+           exited owner, never under its running request */
+        if (owner != client->id &&
+            (!process_gone(owner) || __atomic_load_n(&entry->in_flight, __ATOMIC_ACQUIRE) != 0U ||
+             !__atomic_compare_exchange_n(&entry->owner, &owner, client->id, FALSE,
+                                          __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))) {
+            return NULL;
+        }
+    }
+
+    if (size != NULL) {
+        *size = entry->block_size;
+    }
+    return (uint8_t *)region + entry->payload_offset;
+}
+
+void NvM_ShmClient_Release(NvM_ShmClient_t *client, NvM_BlockIdType block_id)
+{
+    NvM_ShmBlock_t *entry = owned_block(client, block_id);
+
+    if (entry != NULL && __atomic_load_n(&entry->in_flight, __ATOMIC_ACQUIRE) == 0U) {
+        __atomic_store_n(&entry->owner, 0U, __ATOMIC_RELEASE);
+    }
+}
+
+Std_ReturnType NvM_ShmClient_Submit(NvM_ShmClient_t *client, NvM_BlockIdType block_id,
+                                    NvM_ShmOp_t op, NvM_JobHandle_t *handle)
+{
+    NvM_ShmBlock_t *entry = owned_block(client, block_id);
+
+    if (entry == NULL || handle == NULL || (op != NVM_SHM_OP_READ && op != NVM_SHM_OP_WRITE) ||
+        __atomic_load_n(&entry->in_flight, __ATOMIC_ACQUIRE) != 0U) {
+        return E_NOT_OK;
+    }
+
+    NvM_ShmRegion_t *region = region_of(client);
+    if (!server_running(region)) {
+        return E_NOT_OK;
+    }
+
+    /* Ticket before the request becomes visible: the completion cannot be missed */
+    handle->block_id = block_id;
+    handle->ticket = __atomic_load_n(&entry->completions, __ATOMIC_ACQUIRE);
+    __atomic_store_n(&entry->in_flight, 1U, __ATOMIC_RELEASE);
+
+    uint32_t pos = __atomic_load_n(&region->head, __ATOMIC_RELAXED);
+    NvM_ShmRequest_t *slot;
+    for (;;) {
+        slot = &region->ring[pos & NVM_SHM_RING_MASK];
+        uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        int32_t diff = (int32_t)(seq - pos);
+
+        if (diff == 0) {
+            /* Free slot: claim the position */
+            if (__atomic_compare_exchange_n(&region->head, &pos, pos + 1U, TRUE,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* Slot still holds the request from one lap ago: ring full */
+            __atomic_add_fetch(&region->rejected, 1U, __ATOMIC_RELAXED);
+            __atomic_store_n(&entry->in_flight, 0U, __ATOMIC_RELEASE);
+            return E_NOT_OK;
+        } else {
+            /* Another producer took this position */
+            pos = __atomic_load_n(&region->head, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->block_id = block_id;
+    slot->op = (uint8_t)op;
+    slot->client = client->id;
+    __atomic_store_n(&slot->seq, pos + 1U, __ATOMIC_RELEASE);
+    return E_OK;
+}
+
+static boolean remaining_time(const struct timespec *deadline, struct timespec *left)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    left->tv_sec = deadline->tv_sec - now.tv_sec;
+    left->tv_nsec = deadline->tv_nsec - now.tv_nsec;
+    if (left->tv_nsec < 0) {
+        left->tv_sec--;
+        left->tv_nsec += 1000000000L;
+    }
+    return (left->tv_sec >= 0) ? TRUE : FALSE;
+}
+
+Std_ReturnType NvM_ShmClient_Wait(NvM_ShmClient_t *client, const NvM_JobHandle_t *handle,
+                                  uint32_t timeout_ms, uint8_t *result)
+{
+    NvM_ShmRegion_t *region = region_of(client);
+
+    if (region == NULL || handle == NULL) {
+        return E_NOT_OK;
+    }
+
+    NvM_ShmBlock_t *entry = &region->blocks[handle->block_id];
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += (time_t)(timeout_ms / 1000U);
+    deadline.tv_nsec += (long)(timeout_ms % 1000U) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    boolean done = FALSE;
+    __atomic_add_fetch(&entry->waiters, 1U, __ATOMIC_SEQ_CST);
+    for (;;) {
+        uint32_t count = __atomic_load_n(&entry->completions, __ATOMIC_ACQUIRE);
+        struct timespec left;
+        if (count != handle->ticket) {
+            done = TRUE;
+            break;
+        }
+        if (!server_running(region) || timeout_ms == 0U) {
+            break;
+        }
+        if (timeout_ms == NVM_WAIT_FOREVER) {
+            NvM_Shm_FutexWait(&entry->completions, count, NULL);
+        } else if (remaining_time(&deadline, &left)) {
+            NvM_Shm_FutexWait(&entry->completions, count, &left);
+        } else {
+            break;
+        }
+    }
+    __atomic_sub_fetch(&entry->waiters, 1U, __ATOMIC_SEQ_CST);
+
+    if (done && result != NULL) {
+        *result = (uint8_t)__atomic_load_n(&entry->result, __ATOMIC_RELAXED);
+    }
+    return done ? E_OK : E_NOT_OK;
+}
+
+/**
+ * @brief Acquire, run one request on the payload and release
+ */
+static Std_ReturnType run_request(NvM_ShmClient_t *client, NvM_BlockIdType block_id,
+                                  NvM_ShmOp_t op, void *out, const void *in, uint32_t timeout_ms)
+{
+    uint16_t size = 0U;
+    uint8_t *payload = NvM_ShmClient_Acquire(client, block_id, &size);
+    NvM_JobHandle_t handle;
+    uint8_t result = NVM_REQ_NOT_OK;
+
+    if (payload == NULL) {
+        return E_NOT_OK;
+    }
+    if (in != NULL) {
+        memcpy(payload, in, size);
+    }
+
+    Std_ReturnType ret = NvM_ShmClient_Submit(client, block_id, op, &handle);
+    if (ret == E_OK) {
+        ret = NvM_ShmClient_Wait(client, &handle, timeout_ms, &result);
+    }
+    if (ret == E_OK && result == NVM_REQ_OK && out != NULL) {
+        memcpy(out, payload, size);
+    }
+
+    /* Kept on timeout: the request may still run on the payload */
+    NvM_ShmClient_Release(client, block_id);
+    return (ret == E_OK && result == NVM_REQ_OK) ? E_OK : E_NOT_OK;
+}
+
+Std_ReturnType NvM_ShmClient_ReadBlock(NvM_ShmClient_t *client, NvM_BlockIdType block_id,
+                                       void *data, uint32_t timeout_ms)
+{
+    if (data == NULL) {
+        return E_NOT_OK;
+    }
+    return run_request(client, block_id, NVM_SHM_OP_READ, data, NULL, timeout_ms);
+}
+
+Std_ReturnType NvM_ShmClient_WriteBlock(NvM_ShmClient_t *client, NvM_BlockIdType block_id,
+                                        const void *data, uint32_t timeout_ms)
+{
+    if (data == NULL) {
+        return E_NOT_OK;
+    }
+    return run_request(client, block_id, NVM_SHM_OP_WRITE, NULL, data, timeout_ms);
+}
+
+Std_ReturnType NvM_ShmClient_GetBlockState(const NvM_ShmClient_t *client, NvM_BlockIdType block_id,
+                                           uint8_t *state)
+{
+    NvM_ShmRegion_t *region = region_of(client);
+
+    if (region == NULL || state == NULL || region->blocks[block_id].block_size == 0U) {
+        return E_NOT_OK;
+    }
+
+    *state = (uint8_t)__atomic_load_n(&region->blocks[block_id].state, __ATOMIC_RELAXED);
+    return E_OK;
+}
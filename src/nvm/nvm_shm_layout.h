@@ -0,0 +1,117 @@
+/**
+ * @file nvm_shm_layout.h
+ * @brief Layout of the shared memory object shared by nvm_shm.c and nvm_shm_client.c
+ *
+ * Not part of the public API. Every field shared across processes is
+ * accessed with __atomic builtins; a layout change bumps NVM_SHM_VERSION.
+ */
+
+#ifndef NVM_SHM_LAYOUT_H
+#define NVM_SHM_LAYOUT_H
+
+#include "nvm_shm.h"
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NVM_SHM_MAGIC   0x4D485345U     /**< "ESHM" */
+#define NVM_SHM_VERSION 1U
+
+/**
+ * @brief Slots in the client request ring (power of two, override with -D)
+ */
+#ifndef NVM_SHM_RING_SIZE
+#define NVM_SHM_RING_SIZE 64U
+#endif
+
+#define NVM_SHM_RING_MASK  (NVM_SHM_RING_SIZE - 1U)
+#define NVM_SHM_CACHE_LINE 64U
+#define NVM_SHM_PATH_MAX   (NVM_SHM_NAME_MAX + 16U)
+
+/**
+ * @brief Ring slot (same sequence protocol as nvm_submit.c)
+ */
+typedef struct {
+    uint32_t seq;
+    uint8_t block_id;
+    uint8_t op;
+    uint16_t reserved;
+    uint32_t client;
+} NvM_ShmRequest_t;
+
+/**
+ * @brief Block table entry, one cache line per block
+ */
+typedef struct {
+    uint16_t block_size;            /**< 0 = not served */
+    uint8_t block_type;
+    uint8_t reserved;
+    uint32_t payload_offset;        /**< From the start of the object */
+    uint32_t owner;                 /**< Owning client ID, 0 = free */
+    uint32_t in_flight;             /**< A request of the owner has not completed */
+    uint32_t state;                 /**< NvM_BlockStateType_t after the last completion */
+    uint32_t result;                /**< Job result of the last client request */
+    uint32_t completions;           /**< Futex word: client requests completed */
+    uint32_t waiters;               /**< Clients sleeping on completions */
+} __attribute__((aligned(NVM_SHM_CACHE_LINE))) NvM_ShmBlock_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t size;                  /**< Object size including payloads */
+    uint32_t server_pid;
+    uint32_t running;               /**< Cleared by NvM_ShmServer_Stop */
+    uint32_t device_size;           /**< Bytes of the device image (0 = not shared) */
+    char device_path[NVM_SHM_PATH_MAX];
+
+    uint32_t head __attribute__((aligned(NVM_SHM_CACHE_LINE)));  /**< Next position to claim */
+    uint32_t rejected;
+    uint32_t tail __attribute__((aligned(NVM_SHM_CACHE_LINE)));  /**< Next position to serve */
+
+    NvM_ShmBlock_t blocks[256];
+    NvM_ShmRequest_t ring[NVM_SHM_RING_SIZE];
+} NvM_ShmRegion_t;
+
+/**
+ * @brief Wake every process sleeping on a shared word
+ */
+static inline void NvM_Shm_FutexWake(uint32_t *word)
+{
+#ifdef __linux__
+    (void)syscall(SYS_futex, word, FUTEX_WAKE, 0x7FFFFFFF, NULL, NULL, 0);
+#else
+    (void)word;
+#endif
+}
+
+/**
+ * @brief Sleep while *word == expected, at most timeout (NULL = no limit)
+ *
+ * Without futexes the caller polls: sleep a short slice instead.
+ */
+static inline void NvM_Shm_FutexWait(uint32_t *word, uint32_t expected, const struct timespec *timeout)
+{
+#ifdef __linux__
+    (void)syscall(SYS_futex, word, FUTEX_WAIT, expected, timeout, NULL, 0);
+#else
+    struct timespec slice = { 0, 100000L };
+    (void)word;
+    (void)expected;
+    (void)timeout;
+    nanosleep(&slice, NULL);
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NVM_SHM_LAYOUT_H */
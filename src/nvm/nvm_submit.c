@@ -0,0 +1,135 @@
+/**
+ * @file nvm_submit.c
+ * @brief Lock-free multi-producer submission ring for requests from other cores
+ *
+ * REQ-Job队列管理: design/03-Block管理机制.md §4
+ * - 多生产者/单消费者有界环形缓冲: 每槽序号, 生产者CAS抢占位置, 无锁
+ * - NvM_MainFunction单线程取出并放入优先级队列
+ * - 环满时拒绝提交 (背压), 并统计拒绝次数与最大深度
+ */
+
+#include "nvm_internal.h"
+#include <string.h>
+
+#if (NVM_SUBMIT_RING_SIZE & (NVM_SUBMIT_RING_SIZE - 1U)) != 0U
+#error "NVM_SUBMIT_RING_SIZE must be a power of two"
+#endif
+
+#define NVM_SUBMIT_RING_MASK (NVM_SUBMIT_RING_SIZE - 1U)
+
+/**
+ * @brief Cache line size (producer and consumer indices kept apart)
+ */
+#define NVM_SUBMIT_CACHE_LINE 64
+
+/**
+ * @brief Ring slot
+ *
+ * seq == position: free for the producer claiming that position.
+ * seq == position + 1: holds a job for the consumer.
+ */
+typedef struct {
+    uint32_t seq;
+    NvM_Job_t job;
+} NvM_SubmitSlot_t;
+
+struct NvM_SubmitState {
+    NvM_SubmitSlot_t slots[NVM_SUBMIT_RING_SIZE];
+    uint32_t head __attribute__((aligned(NVM_SUBMIT_CACHE_LINE)));  /**< Next position to claim */
+    uint32_t submitted;
+    uint32_t rejected;
+    uint32_t tail __attribute__((aligned(NVM_SUBMIT_CACHE_LINE)));  /**< Next position to drain */
+    uint32_t max_depth;
+};
+
+/**
+ * @brief State used while no context is bound
+ */
+static struct NvM_SubmitState g_default_state;
+
+static struct NvM_SubmitState* submit_state(void)
+{
+    return (struct NvM_SubmitState *)NvM_PartState(NVM_PART_SUBMIT);
+}
+
+void NvM_Submit_Reset(void)
+{
+    struct NvM_SubmitState *sub = submit_state();
+
+    memset(sub, 0, sizeof(*sub));
+    for (uint32_t i = 0; i < NVM_SUBMIT_RING_SIZE; i++) {
+        sub->slots[i].seq = i;
+    }
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+Std_ReturnType NvM_Submit_Push(const NvM_Job_t *job)
+{
+    struct NvM_SubmitState *sub = submit_state();
+    uint32_t pos = __atomic_load_n(&sub->head, __ATOMIC_RELAXED);
+    NvM_SubmitSlot_t *slot;
+
+    for (;;) {
+        slot = &sub->slots[pos & NVM_SUBMIT_RING_MASK];
+        uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        int32_t diff = (int32_t)(seq - pos);
+
+        if (diff == 0) {
+            /* Free slot: claim the position */
+            if (__atomic_compare_exchange_n(&sub->head, &pos, pos + 1U, TRUE,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* Slot still holds the job from one lap ago: ring full */
+            __atomic_add_fetch(&sub->rejected, 1U, __ATOMIC_RELAXED);
+            return E_NOT_OK;
+        } else {
+            /* Another producer took this position */
+            pos = __atomic_load_n(&sub->head, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->job = *job;
+    __atomic_store_n(&slot->seq, pos + 1U, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&sub->submitted, 1U, __ATOMIC_RELAXED);
+    return E_OK;
+}
+
+Std_ReturnType NvM_Submit_Pop(NvM_Job_t *job)
+{
+    struct NvM_SubmitState *sub = submit_state();
+    uint32_t pos = sub->tail;
+    NvM_SubmitSlot_t *slot = &sub->slots[pos & NVM_SUBMIT_RING_MASK];
+
+    /* A claimed slot whose job is still being copied also reads as empty */
+    if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != pos + 1U) {
+        return E_NOT_OK;
+    }
+
+    uint32_t depth = __atomic_load_n(&sub->head, __ATOMIC_RELAXED) - pos;
+    if (depth > sub->max_depth) {
+        sub->max_depth = depth;
+    }
+
+    *job = slot->job;
+    __atomic_store_n(&slot->seq, pos + NVM_SUBMIT_RING_SIZE, __ATOMIC_RELEASE);
+    sub->tail = pos + 1U;
+    return E_OK;
+}
+
+void NvM_Submit_GetStats(NvM_SubmitStats_t *stats)
+{
+    struct NvM_SubmitState *sub = submit_state();
+    uint32_t head = __atomic_load_n(&sub->head, __ATOMIC_RELAXED);
+
+    stats->submitted = __atomic_load_n(&sub->submitted, __ATOMIC_RELAXED);
+    stats->rejected = __atomic_load_n(&sub->rejected, __ATOMIC_RELAXED);
+    stats->depth = head - sub->tail;
+    stats->max_depth = sub->max_depth;
+}
+
+const NvM_PartDesc_t NvM_SubmitPart = {
+    .size = sizeof(struct NvM_SubmitState),
+    .default_state = &g_default_state
+};
@@ -0,0 +1,267 @@
+/**
+ * @file nvm_wait.c
+ * @brief Blocking wait for job completion (condition variable and eventfd wakeups)
+ *
+ * REQ-NvM核心模块: design/02-NvM架构设计.md §3
+ * - 作业结束/出错通知时按Block累加完成计数并唤醒等待者, 无等待者时不加锁
+ * - NvM_WaitJob: 等待Block的作业结果离开PENDING; 作业句柄: 等待取句柄之后的下一次完成
+ * - NvM线程上调用时不阻塞, 而是自行运行NvM_MainFunction直到完成或超时,
+ *   每周期推进1ms虚拟时间 (重试退避/作业超时/设备时序都以虚拟时间计)
+ * - eventfd: 每次完成计数加一, 事件循环可用poll/epoll同时等待多个仿真ECU
+ */
+
+#define _GNU_SOURCE
+
+#include "nvm.h"
+#include "nvm_internal.h"
+#include "os_scheduler.h"
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+struct NvM_WaitState {
+    pthread_mutex_t lock;
+    pthread_cond_t done;
+    uint32_t waiters;               /**< Threads blocked (or about to block) on done */
+    uint32_t completions[NVM_BLOCK_ID_COUNT];
+    int event_fd;                   /**< -1 until NvM_GetEventFd */
+};
+
+/**
+ * @brief State used while no context is bound (lock and condition set up on first wait)
+ */
+static struct NvM_WaitState g_default_state = { .event_fd = -1 };
+static pthread_once_t g_default_once = PTHREAD_ONCE_INIT;
+
+static struct NvM_WaitState* wait_state(void)
+{
+    return (struct NvM_WaitState *)NvM_PartState(NVM_PART_WAIT);
+}
+
+/**
+ * @brief Condition variable on the monotonic clock (timeouts ignore clock steps)
+ */
+static void wait_state_init(void *state)
+{
+    struct NvM_WaitState *w = (struct NvM_WaitState *)state;
+    pthread_condattr_t attr;
+
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&w->done, &attr);
+    pthread_condattr_destroy(&attr);
+    w->event_fd = -1;
+}
+
+static void wait_init_default(void)
+{
+    wait_state_init(&g_default_state);
+}
+
+/**
+ * @brief Destroy a context's lock and condition and close its eventfd
+ */
+static void wait_state_release(void *state)
+{
+    struct NvM_WaitState *w = (struct NvM_WaitState *)state;
+
+    pthread_cond_destroy(&w->done);
+    pthread_mutex_destroy(&w->lock);
+    if (w->event_fd >= 0) {
+        close(w->event_fd);
+    }
+}
+
+static struct timespec deadline_after(uint32_t timeout_ms)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_sec += (time_t)(timeout_ms / 1000U);
+    ts.tv_nsec += (long)(timeout_ms % 1000U) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
+
+static boolean job_finished(NvM_BlockIdType block_id)
+{
+    uint8_t result = NVM_REQ_PENDING;
+
+    (void)NvM_GetJobResult(block_id, &result);
+    return (result != NVM_REQ_PENDING) ? TRUE : FALSE;
+}
+
+static boolean handle_finished(const NvM_JobHandle_t *handle)
+{
+    struct NvM_WaitState *w = wait_state();
+
+    return (__atomic_load_n(&w->completions[handle->block_id], __ATOMIC_ACQUIRE) !=
+            handle->ticket) ? TRUE : FALSE;
+}
+
+typedef boolean (*WaitCondition_t)(const void *arg);
+
+static boolean job_condition(const void *arg)
+{
+    return job_finished(*(const NvM_BlockIdType *)arg);
+}
+
+static boolean handle_condition(const void *arg)
+{
+    return handle_finished((const NvM_JobHandle_t *)arg);
+}
+
+/**
+ * @brief Wait until cond holds or the timeout expires
+ *
+ * The NvM thread cannot block on itself: it runs the main function
+ * instead, one cycle per virtual millisecond as a cyclic NvM task would.
+ * Frozen virtual time would hold retry backoff, job timeouts and device
+ * latency where they are, so the awaited job could never finish.
+ */
+static Std_ReturnType wait_for(WaitCondition_t cond, const void *arg, uint32_t timeout_ms)
+{
+    struct NvM_WaitState *w = wait_state();
+
+    if (cond(arg)) {
+        return E_OK;
+    }
+    if (timeout_ms == 0U) {
+        return E_NOT_OK;
+    }
+
+    if (NvM_IsNvmThread()) {
+        uint32_t start_ms = OsScheduler_GetVirtualTimeMs();
+        do {
+            NvM_MainFunction();
+            if (cond(arg)) {
+                return E_OK;
+            }
+            OsScheduler_Sleep(1);
+        } while (timeout_ms == NVM_WAIT_FOREVER ||
+                 (OsScheduler_GetVirtualTimeMs() - start_ms) < timeout_ms);
+        return E_NOT_OK;
+    }
+
+    struct timespec deadline = deadline_after(timeout_ms);
+
+    if (w == &g_default_state) {
+        pthread_once(&g_default_once, wait_init_default);
+    }
+    pthread_mutex_lock(&w->lock);
+    __atomic_add_fetch(&w->waiters, 1U, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    boolean finished = cond(arg);
+    int err = 0;
+    while (!finished && err != ETIMEDOUT) {
+        err = (timeout_ms == NVM_WAIT_FOREVER)
+                  ? pthread_cond_wait(&w->done, &w->lock)
+                  : pthread_cond_timedwait(&w->done, &w->lock, &deadline);
+        finished = cond(arg);
+    }
+
+    __atomic_sub_fetch(&w->waiters, 1U, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&w->lock);
+    return finished ? E_OK : E_NOT_OK;
+}
+
+void NvM_Wait_Signal(NvM_BlockIdType block_id)
+{
+    struct NvM_WaitState *w = wait_state();
+
+    __atomic_add_fetch(&w->completions[block_id], 1U, __ATOMIC_RELEASE);
+
+    /* Pairs with the waiter's increment: either it sees the result or we see it */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&w->waiters, __ATOMIC_RELAXED) > 0U) {
+        pthread_mutex_lock(&w->lock);
+        pthread_cond_broadcast(&w->done);
+        pthread_mutex_unlock(&w->lock);
+    }
+
+#ifdef __linux__
+    int fd = __atomic_load_n(&w->event_fd, __ATOMIC_ACQUIRE);
+    if (fd >= 0) {
+        uint64_t one = 1U;
+        /* EAGAIN only when the counter is saturated: readers wake anyway */
+        (void)!write(fd, &one, sizeof(one));
+    }
+#endif
+}
+
+Std_ReturnType NvM_WaitJob(NvM_BlockIdType block_id, uint32_t timeout_ms)
+{
+    return wait_for(job_condition, &block_id, timeout_ms);
+}
+
+Std_ReturnType NvM_GetJobHandle(NvM_BlockIdType block_id, NvM_JobHandle_t *handle)
+{
+    struct NvM_WaitState *w = wait_state();
+
+    if (handle == NULL) {
+        return E_NOT_OK;
+    }
+
+    handle->block_id = block_id;
+    handle->ticket = __atomic_load_n(&w->completions[block_id], __ATOMIC_ACQUIRE);
+    return E_OK;
+}
+
+Std_ReturnType NvM_WaitJobHandle(const NvM_JobHandle_t *handle, uint32_t timeout_ms)
+{
+    if (handle == NULL) {
+        return E_NOT_OK;
+    }
+
+    return wait_for(handle_condition, handle, timeout_ms);
+}
+
+boolean NvM_JobHandleDone(const NvM_JobHandle_t *handle)
+{
+    return (handle != NULL) ? handle_finished(handle) : FALSE;
+}
+
+int NvM_GetEventFd(void)
+{
+    struct NvM_WaitState *w = wait_state();
+
+#ifdef __linux__
+    int fd = __atomic_load_n(&w->event_fd, __ATOMIC_ACQUIRE);
+    if (fd >= 0) {
+        return fd;
+    }
+
+    fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+
+    int expected = -1;
+    if (!__atomic_compare_exchange_n(&w->event_fd, &expected, fd, FALSE,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        /* Another thread created it first */
+        close(fd);
+        fd = expected;
+    }
+    return fd;
+#else
+    return -1;
+#endif
+}
+
+const NvM_PartDesc_t NvM_WaitPart = {
+    .size = sizeof(struct NvM_WaitState),
+    .default_state = &g_default_state,
+    .init = wait_state_init,
+    .release = wait_state_release
+};
@@ -0,0 +1,482 @@
+/**
+ * @file ram_mirror_rcu.c
+ * @brief Multi-version (RCU-style) RAM Mirror Implementation
+ *
+ * Design Reference: 03-Block管理机制.md §3.4
+ *
+ * Reclamation (epoch based):
+ * - A reader announces the global epoch in its own slot, then loads the
+ *   published index; it leaves by clearing the slot
+ * - A writer publishes the new buffer, then advances the epoch; the
+ *   replaced buffer is stamped with the epoch before the advance
+ * - A stamped buffer is reusable once no slot announces an epoch at or
+ *   below its stamp: later readers can only have seen a newer buffer
+ * - Slots also record the buffer loaded, so an old reader only holds back
+ *   the buffer it actually reads (preempted readers would otherwise stall
+ *   every writer until they run again)
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "ram_mirror_rcu.h"
+#include "nvm_internal.h"
+#include "logging.h"
+#include <string.h>
+#include <pthread.h>
+
+#define RCU_INDEX_MASK   0x3ULL
+#define RCU_VERSION_SHIFT 2U
+
+/* Slot held values: (block_id << 2) | buffer index, or one of these */
+#define RCU_HELD_NONE  0xFFFFFFFFU   /* Announced, buffer not loaded yet */
+#define RCU_HELD_ANY   0xFFFFFFFEU   /* Nested sections: may hold several */
+
+#define RCU_HELD(block_id, index) (((uint32_t)(block_id) << 2) | (uint32_t)(index))
+
+/**
+ * @brief Reader slot: one cache line per registered thread
+ *
+ * epoch == 0 means the thread is outside any read section.
+ */
+typedef struct {
+    uint64_t epoch;
+    uint32_t held;
+    uint32_t in_use;
+} RAM_MIRROR_CACHE_ALIGNED RcuReaderSlot_t;
+
+/**
+ * @brief Multi-version mirrors of one context (indexed by block_id)
+ */
+struct NvM_MirrorRcuState {
+    RamMirrorRcu_t mirrors[NVM_MAX_BLOCKS];
+    RcuStats_t stats[NVM_MAX_BLOCKS];
+    uint8_t mirror_mode[NVM_MAX_BLOCKS];    /**< 0 = NVM_MIRROR_SEQLOCK */
+};
+
+/**
+ * @brief Mirrors used while no context is bound
+ */
+static struct NvM_MirrorRcuState g_default_state;
+
+static struct NvM_MirrorRcuState* rcu_state(void)
+{
+    return (struct NvM_MirrorRcuState *)NvM_PartState(NVM_PART_MIRROR_RCU);
+}
+
+/*
+ * Reader registry, shared by every context; epochs start at 1 so 0 can
+ * mean quiescent. A reader holding block N of one context only delays
+ * the reuse of block N's buffers in the others.
+ */
+static RcuReaderSlot_t g_rcu_readers[RAM_MIRROR_RCU_MAX_READERS];
+static uint32_t g_rcu_reader_hwm;     /* Slots ever claimed (scan bound) */
+static uint64_t g_rcu_epoch RAM_MIRROR_CACHE_ALIGNED = 1U;
+
+static pthread_once_t g_rcu_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_rcu_key;
+
+/* Calling thread's slot and read-section nesting depth */
+static __thread RcuReaderSlot_t* t_rcu_slot;
+static __thread uint32_t t_rcu_depth;
+
+/**
+ * @brief Thread exit: give the reader slot back
+ */
+static void reader_slot_release(void* arg)
+{
+    RcuReaderSlot_t* slot = (RcuReaderSlot_t*)arg;
+
+    __atomic_store_n(&slot->epoch, 0U, __ATOMIC_RELEASE);
+    __atomic_store_n(&slot->in_use, 0U, __ATOMIC_RELEASE);
+}
+
+static void reader_key_create(void)
+{
+    (void)pthread_key_create(&g_rcu_key, reader_slot_release);
+}
+
+/**
+ * @brief Slot of the calling thread, claimed on first use
+ *
+ * @return Slot, or NULL if all RAM_MIRROR_RCU_MAX_READERS slots are taken
+ */
+static RcuReaderSlot_t* reader_slot(void)
+{
+    if (t_rcu_slot != NULL) {
+        return t_rcu_slot;
+    }
+
+    (void)pthread_once(&g_rcu_key_once, reader_key_create);
+
+    for (uint32_t i = 0; i < RAM_MIRROR_RCU_MAX_READERS; i++) {
+        uint32_t expected = 0U;
+        if (!__atomic_compare_exchange_n(&g_rcu_readers[i].in_use, &expected, 1U, FALSE,
+                                         __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            continue;
+        }
+
+        uint32_t hwm = __atomic_load_n(&g_rcu_reader_hwm, __ATOMIC_RELAXED);
+        while (hwm < i + 1U &&
+               !__atomic_compare_exchange_n(&g_rcu_reader_hwm, &hwm, i + 1U, TRUE,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        }
+
+        t_rcu_slot = &g_rcu_readers[i];
+        (void)pthread_setspecific(g_rcu_key, t_rcu_slot);
+        return t_rcu_slot;
+    }
+
+    LOG_ERROR("RCU: No free reader slot (max %u threads)", RAM_MIRROR_RCU_MAX_READERS);
+    return NULL;
+}
+
+/**
+ * @brief Enter a read section and load the published word
+ */
+static boolean read_lock(NvM_BlockIdType block_id, uint64_t* published)
+{
+    struct NvM_MirrorRcuState *rs = rcu_state();
+    RcuReaderSlot_t* slot = reader_slot();
+    if (slot == NULL) {
+        return FALSE;
+    }
+
+    boolean outermost = (t_rcu_depth++ == 0U) ? TRUE : FALSE;
+    if (outermost) {
+        /* Announce before loading published (pairs with the writer's scan);
+         * acquire: an advanced epoch implies its publish is visible;
+         * release: a writer seeing this epoch also sees held reset */
+        __atomic_store_n(&slot->epoch, __atomic_load_n(&g_rcu_epoch, __ATOMIC_ACQUIRE),
+                         __ATOMIC_RELEASE);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    }
+
+    *published = __atomic_load_n(&rs->mirrors[block_id].published, __ATOMIC_ACQUIRE);
+    __atomic_store_n(&slot->held,
+                     outermost ? RCU_HELD(block_id, *published & RCU_INDEX_MASK) : RCU_HELD_ANY,
+                     __ATOMIC_RELAXED);
+    return TRUE;
+}
+
+static void read_unlock(void)
+{
+    if (--t_rcu_depth == 0U) {
+        __atomic_store_n(&t_rcu_slot->held, RCU_HELD_NONE, __ATOMIC_RELAXED);
+        __atomic_store_n(&t_rcu_slot->epoch, 0U, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * @brief Whether a buffer retired at retire_epoch may still be read
+ *
+ * A reader announcing an epoch at or below the stamp blocks the buffer
+ * unless its slot shows it loaded a different one.
+ */
+static boolean buffer_in_use(NvM_BlockIdType block_id, uint32_t index, uint64_t retire_epoch)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    /* Read after the fence: a slot claimed later is seen, or its reader
+     * sees the current publish */
+    uint32_t hwm = __atomic_load_n(&g_rcu_reader_hwm, __ATOMIC_ACQUIRE);
+    for (uint32_t i = 0; i < hwm; i++) {
+        uint64_t e = __atomic_load_n(&g_rcu_readers[i].epoch, __ATOMIC_ACQUIRE);
+        if (e == 0U || e > retire_epoch) {
+            continue;
+        }
+
+        uint32_t held = __atomic_load_n(&g_rcu_readers[i].held, __ATOMIC_RELAXED);
+        if (held == RCU_HELD_NONE || held == RCU_HELD_ANY || held == RCU_HELD(block_id, index)) {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Point a mirror at buffers of size bytes, reusing ones large enough
+ *
+ * The buffers are one arena run, each starting on its own cache line.
+ */
+static Std_ReturnType mirror_buffers(RamMirrorRcu_t* mirror, uint16_t size)
+{
+    uint32_t stride = ((uint32_t)size + RAM_MIRROR_CACHE_LINE_SIZE - 1U) &
+                      ~(uint32_t)(RAM_MIRROR_CACHE_LINE_SIZE - 1U);
+
+    if (mirror->data[0] == NULL || (uint32_t)(mirror->data[1] - mirror->data[0]) < stride) {
+        uint8_t* base = RamMirror_ArenaAlloc(stride * RAM_MIRROR_RCU_BUFFERS);
+        if (base == NULL) {
+            return E_NOT_OK;
+        }
+        for (uint32_t i = 0; i < RAM_MIRROR_RCU_BUFFERS; i++) {
+            mirror->data[i] = &base[i * stride];
+        }
+    }
+
+    mirror->size = size;
+    return E_OK;
+}
+
+Std_ReturnType RamMirror_RcuInit(NvM_BlockIdType block_id)
+{
+    struct NvM_MirrorRcuState *rs = rcu_state();
+
+    if (block_id >= NVM_MAX_BLOCKS) {
+        return E_NOT_OK;
+    }
+
+    RamMirrorRcu_t* mirror = &rs->mirrors[block_id];
+
+    /* Standalone use (no registration): full-size buffers */
+    if (mirror->data[0] == NULL && mirror_buffers(mirror, RAM_MIRROR_MAX_BLOCK_SIZE) != E_OK) {
+        return E_NOT_OK;
+    }
+
+    mirror->published = 0;
+    mirror->writer_busy = 0;
+    memset(mirror->retire_epoch, 0, sizeof(mirror->retire_epoch));
+    for (uint32_t i = 0; i < RAM_MIRROR_RCU_BUFFERS; i++) {
+        memset(mirror->data[i], 0xFF, mirror->size);  /* Erased state */
+    }
+    memset(&rs->stats[block_id], 0, sizeof(RcuStats_t));
+
+    LOG_DEBUG("RCU: Block %d initialized", block_id);
+    return E_OK;
+}
+
+Std_ReturnType RamMirror_RcuAllocate(NvM_BlockIdType block_id, uint16_t size)
+{
+    struct NvM_MirrorRcuState *rs = rcu_state();
+
+    if (block_id >= NVM_MAX_BLOCKS || size == 0U || size > RAM_MIRROR_MAX_BLOCK_SIZE ||
+        mirror_buffers(&rs->mirrors[block_id], size) != E_OK) {
+        return E_NOT_OK;
+    }
+
+    return RamMirror_RcuInit(block_id);
+}
+
+boolean RamMirror_RcuRead(NvM_BlockIdType block_id, uint8_t* buffer, uint16_t size,
+                          uint32_t* out_version)
+{
+    struct NvM_MirrorRcuState *rs = rcu_state();
+    uint64_t published;
+
+    if (block_id >= NVM_MAX_BLOCKS || buffer == NULL || rs->mirrors[block_id].data[0] == NULL ||
+        size > rs->mirrors[block_id].size || !read_lock(block_id, &published)) {
+        return FALSE;
+    }
+
+    memcpy(buffer, rs->mirrors[block_id].data[published & RCU_INDEX_MASK], size);
+    read_unlock();
+
+    if (out_version != NULL) {
+        *out_version = (uint32_t)(published >> RCU_VERSION_SHIFT);
+    }
+    return TRUE;
+}
+
+boolean RamMirror_RcuVisit(NvM_BlockIdType block_id, uint16_t offset, uint16_t len,
+                           RamMirror_VisitFn fn, void* ctx)
+{
+    struct NvM_MirrorRcuState *rs = rcu_state();
+    uint64_t published;
+
+    if (block_id >= NVM_MAX_BLOCKS || fn == NULL || rs->mirrors[block_id].data[0] == NULL ||
+        (uint32_t)offset + len > rs->mirrors[block_id].size ||
+        !read_lock(block_id, &published)) {
+        return FALSE;
+    }
+
+    fn(&rs->mirrors[block_id].data[published & RCU_INDEX_MASK][offset], len, ctx);
+    read_unlock();
+    return TRUE;
+}
+
+/**
+ * @brief Pick a free buffer, waiting for a grace period if both are in use
+ *
+ * The buffer retired longest ago is tried first.
+ */
+static uint32_t writer_pick_buffer(NvM_BlockIdType block_id, uint32_t current)
+{
+    struct NvM_MirrorRcuState *rs = rcu_state();
+    RamMirrorRcu_t* mirror = &rs->mirrors[block_id];
+    uint32_t a = (current + 1U) % RAM_MIRROR_RCU_BUFFERS;
+    uint32_t b = (current + 2U) % RAM_MIRROR_RCU_BUFFERS;
+    uint32_t spins = 0;
+
+    if (mirror->retire_epoch[b] < mirror->retire_epoch[a]) {
+        uint32_t t = a;
+        a = b;
+        b = t;
+    }
+
+    for (;;) {
+        if (!buffer_in_use(block_id, a, mirror->retire_epoch[a])) {
+            break;
+        }
+        if (!buffer_in_use(block_id, b, mirror->retire_epoch[b])) {
+            a = b;
+            break;
+        }
+        RamMirror_Backoff(spins++);
+    }
+
+    if (spins > 0U) {
+        rs->stats[block_id].grace_waits++;
+        if (spins > rs->stats[block_id].max_grace_spins) {
+            rs->stats[block_id].max_grace_spins = spins;
+        }
+    }
+
+    return a;
+}
+
+Std_ReturnType RamMirror_RcuWrite(NvM_BlockIdType block_id, const uint8_t* data, uint16_t size)
+{
+    struct NvM_MirrorRcuState *rs = rcu_state();
+
+    if (block_id >= NVM_MAX_BLOCKS || data == NULL || rs->mirrors[block_id].data[0] == NULL ||
+        size > rs->mirrors[block_id].size) {
+        return E_NOT_OK;
+    }
+
+    RamMirrorRcu_t* mirror = &rs->mirrors[block_id];
+
+    /* Serialize writers of this block */
+    uint32_t spins = 0;
+    uint32_t expected = 0U;
+    while (!__atomic_compare_exchange_n(&mirror->writer_busy, &expected, 1U, FALSE,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        expected = 0U;
+        RamMirror_Backoff(spins++);
+    }
+
+    uint64_t published = __atomic_load_n(&mirror->published, __ATOMIC_RELAXED);
+    uint32_t current = (uint32_t)(published & RCU_INDEX_MASK);
+    uint32_t version = (uint32_t)(published >> RCU_VERSION_SHIFT) + 1U;
+    uint32_t target = writer_pick_buffer(block_id, current);
+
+    /* Unwritten tail keeps the previous version's bytes */
+    memcpy(mirror->data[target], data, size);
+    if (size < mirror->size) {
+        memcpy(&mirror->data[target][size], &mirror->data[current][size], mirror->size - size);
+    }
+
+    /* Publish, then advance the epoch: readers announcing the old epoch
+     * may still hold the replaced buffer, newer ones cannot */
+    __atomic_store_n(&mirror->published,
+                     ((uint64_t)version << RCU_VERSION_SHIFT) | target, __ATOMIC_SEQ_CST);
+    mirror->retire_epoch[current] = __atomic_fetch_add(&g_rcu_epoch, 1U, __ATOMIC_SEQ_CST);
+
+    rs->stats[block_id].write_count++;
+    __atomic_store_n(&mirror->writer_busy, 0U, __ATOMIC_RELEASE);
+
+    LOG_DEBUG("RCU: Block %d published version %u (buffer %u)", block_id, version, target);
+    return E_OK;
+}
+
+uint32_t RamMirror_RcuGetVersion(NvM_BlockIdType block_id)
+{
+    struct NvM_MirrorRcuState *rs = rcu_state();
+
+    if (block_id >= NVM_MAX_BLOCKS) {
+        return 0;
+    }
+
+    return (uint32_t)(__atomic_load_n(&rs->mirrors[block_id].published, __ATOMIC_ACQUIRE) >>
+                      RCU_VERSION_SHIFT);
+}
+
+Std_ReturnType RamMirror_GetRcuStats(NvM_BlockIdType block_id, RcuStats_t* stats)
+{
+    struct NvM_MirrorRcuState *rs = rcu_state();
+
+    if (block_id >= NVM_MAX_BLOCKS || stats == NULL) {
+        return E_NOT_OK;
+    }
+
+    memcpy(stats, &rs->stats[block_id], sizeof(RcuStats_t));
+    return E_OK;
+}
+
+Std_ReturnType RamMirror_SetMode(NvM_BlockIdType block_id, NvM_MirrorModeType_t mode)
+{
+    struct NvM_MirrorRcuState *rs = rcu_state();
+
+    if (block_id >= NVM_MAX_BLOCKS || (mode != NVM_MIRROR_SEQLOCK && mode != NVM_MIRROR_RCU)) {
+        return E_NOT_OK;
+    }
+
+    __atomic_store_n(&rs->mirror_mode[block_id], (uint8_t)mode, __ATOMIC_RELEASE);
+    return E_OK;
+}
+
+Std_ReturnType RamMirror_Allocate(NvM_BlockIdType block_id, NvM_MirrorModeType_t mode,
+                                  uint16_t block_size)
+{
+    uint16_t size = (block_size > RAM_MIRROR_MAX_BLOCK_SIZE) ? RAM_MIRROR_MAX_BLOCK_SIZE
+                                                             : block_size;
+    Std_ReturnType ret;
+
+    if (size == 0U) {
+        size = 1U;
+    }
+
+    if (mode == NVM_MIRROR_RCU) {
+        ret = RamMirror_RcuAllocate(block_id, size);
+    } else if (mode == NVM_MIRROR_SEQLOCK) {
+        ret = RamMirror_SeqlockAllocate(block_id, size);
+    } else {
+        return E_NOT_OK;
+    }
+
+    return (ret == E_OK) ? RamMirror_SetMode(block_id, mode) : E_NOT_OK;
+}
+
+void RamMirror_ResetAll(void)
+{
+    struct NvM_MirrorRcuState *rs = rcu_state();
+
+    for (uint32_t i = 0; i < NVM_MAX_BLOCKS; i++) {
+        rs->mirrors[i].size = 0;
+        memset(rs->mirrors[i].data, 0, sizeof(rs->mirrors[i].data));
+    }
+    RamMirror_ArenaReset();
+}
+
+NvM_MirrorModeType_t RamMirror_GetMode(NvM_BlockIdType block_id)
+{
+    struct NvM_MirrorRcuState *rs = rcu_state();
+
+    if (block_id >= NVM_MAX_BLOCKS) {
+        return NVM_MIRROR_SEQLOCK;
+    }
+
+    return (NvM_MirrorModeType_t)__atomic_load_n(&rs->mirror_mode[block_id], __ATOMIC_ACQUIRE);
+}
+
+boolean RamMirror_Read(NvM_BlockIdType block_id, uint8_t* buffer, uint16_t size)
+{
+    if (RamMirror_GetMode(block_id) == NVM_MIRROR_RCU) {
+        return RamMirror_RcuRead(block_id, buffer, size, NULL);
+    }
+
+    return RamMirror_SeqlockRead(block_id, buffer, size);
+}
+
+Std_ReturnType RamMirror_Write(NvM_BlockIdType block_id, const uint8_t* data, uint16_t size)
+{
+    if (RamMirror_GetMode(block_id) == NVM_MIRROR_RCU) {
+        return RamMirror_RcuWrite(block_id, data, size);
+    }
+
+    return RamMirror_SeqlockWrite(block_id, data, size);
+}
+
+const NvM_PartDesc_t NvM_MirrorRcuPart = {
+    .size = sizeof(struct NvM_MirrorRcuState),
+    .default_state = &g_default_state
+};
@@ -0,0 +1,188 @@
+/**
+ * @file ram_mirror_rcu.h
+ * @brief Multi-version (RCU-style) RAM Mirror with wait-free readers
+ *
+ * Design Reference: 03-Block管理机制.md §3.4
+ *
+ * Alternative to the seqlock mirror for blocks whose readers must not
+ * be delayed by long writes:
+ * - Three buffers per block; writers fill an inactive buffer and publish
+ *   its index together with a version in one atomic word
+ * - Readers load the published word and read that buffer: no retries
+ * - Buffers are reclaimed with epochs: a retired buffer is rewritten only
+ *   after every reader that could have seen it has left its read section
+ *
+ * Writers are serialized per block and may wait for a grace period;
+ * readers never wait. A reader preempted inside its read section keeps
+ * its buffer, so with more runnable threads than CPUs write throughput
+ * drops sharply: prefer this mode when readers run on dedicated cores or
+ * writes are rare, and the seqlock mode otherwise.
+ */
+
+#ifndef RAM_MIRROR_RCU_H
+#define RAM_MIRROR_RCU_H
+
+#include "nvm.h"
+#include "ram_mirror_seqlock.h"
+
+/*
+ * Buffers per block (current, recently retired, free)
+ */
+#define RAM_MIRROR_RCU_BUFFERS  3U
+
+/*
+ * Maximum threads concurrently registered as RCU readers
+ *
+ * A thread holds a reader slot from its first RCU read until it exits.
+ */
+#define RAM_MIRROR_RCU_MAX_READERS  1024U
+
+/**
+ * @brief Multi-version mirror of one block
+ *
+ * published = (version << 2) | buffer index
+ */
+typedef struct {
+    uint64_t published;                         /* Read by every reader */
+    uint32_t writer_busy RAM_MIRROR_CACHE_ALIGNED;  /* Writer serialization flag */
+    uint64_t retire_epoch[RAM_MIRROR_RCU_BUFFERS];  /* Epoch a buffer was retired in */
+    uint16_t size RAM_MIRROR_CACHE_ALIGNED;     /* Bytes per buffer (read-only after allocation) */
+    uint8_t* data[RAM_MIRROR_RCU_BUFFERS];      /* Arena buffers, NULL until allocated */
+} RAM_MIRROR_CACHE_ALIGNED RamMirrorRcu_t;
+
+/**
+ * @brief RCU mirror statistics (writer side; readers keep no shared counters)
+ */
+typedef struct {
+    uint32_t write_count;       /* Completed writes */
+    uint32_t grace_waits;       /* Writes that had to wait for readers to drain */
+    uint32_t max_grace_spins;   /* Longest wait, in reader-slot scans */
+} RcuStats_t;
+
+/**
+ * @brief Initialize a block's multi-version mirror (all buffers erased, version 0)
+ *
+ * A mirror without buffers (block not registered in RCU mode) gets
+ * RAM_MIRROR_MAX_BLOCK_SIZE buffers from the arena.
+ *
+ * @param block_id Block ID
+ * @return Std_ReturnType E_OK on success, E_NOT_OK on invalid block ID or full arena
+ */
+Std_ReturnType RamMirror_RcuInit(NvM_BlockIdType block_id);
+
+/**
+ * @brief Give a block's multi-version mirror buffers of size bytes and initialize it
+ *
+ * Buffers already large enough are reused (re-registration).
+ *
+ * @param block_id Block ID
+ * @param size Bytes per buffer (1 .. RAM_MIRROR_MAX_BLOCK_SIZE)
+ * @return Std_ReturnType E_OK on success, E_NOT_OK on invalid arguments or full arena
+ */
+Std_ReturnType RamMirror_RcuAllocate(NvM_BlockIdType block_id, uint16_t size);
+
+/**
+ * @brief Wait-free read of the current version
+ *
+ * @param block_id Block ID to read
+ * @param buffer Output buffer
+ * @param size Bytes to read
+ * @param out_version Version read (can be NULL)
+ * @return boolean TRUE on success, FALSE on invalid arguments or when no
+ *         reader slot is free (more than RAM_MIRROR_RCU_MAX_READERS threads)
+ */
+boolean RamMirror_RcuRead(NvM_BlockIdType block_id, uint8_t* buffer, uint16_t size,
+                          uint32_t* out_version);
+
+/**
+ * @brief Zero-copy wait-free read: run a visitor on the current version
+ *
+ * Unlike RamMirror_SeqlockVisit the visitor runs exactly once and always
+ * sees a stable snapshot.
+ *
+ * @param block_id Block ID to read
+ * @param offset Byte offset within the block
+ * @param len Number of bytes the visitor may access
+ * @param fn Visitor
+ * @param ctx Passed to fn
+ * @return boolean TRUE if fn ran, FALSE on invalid arguments or no reader slot
+ */
+boolean RamMirror_RcuVisit(NvM_BlockIdType block_id, uint16_t offset, uint16_t len,
+                           RamMirror_VisitFn fn, void* ctx);
+
+/**
+ * @brief Publish a new version
+ *
+ * Serialized against other writers of the block. Waits (yielding) only if
+ * both inactive buffers may still be in use by readers.
+ *
+ * @param block_id Block ID to write
+ * @param data Input data
+ * @param size Data size
+ * @return Std_ReturnType E_OK on success
+ */
+Std_ReturnType RamMirror_RcuWrite(NvM_BlockIdType block_id, const uint8_t* data, uint16_t size);
+
+/**
+ * @brief Current published version of a block (0 before the first write)
+ */
+uint32_t RamMirror_RcuGetVersion(NvM_BlockIdType block_id);
+
+/**
+ * @brief Get RCU mirror statistics
+ */
+Std_ReturnType RamMirror_GetRcuStats(NvM_BlockIdType block_id, RcuStats_t* stats);
+
+/**
+ * @brief Select the mirror mode used by RamMirror_Read/RamMirror_Write
+ *
+ * NvM_RegisterBlock selects NvM_BlockConfig_t.mirror_mode through RamMirror_Allocate.
+ *
+ * @param block_id Block ID
+ * @param mode NVM_MIRROR_SEQLOCK or NVM_MIRROR_RCU
+ * @return Std_ReturnType E_OK on success, E_NOT_OK on invalid arguments
+ */
+Std_ReturnType RamMirror_SetMode(NvM_BlockIdType block_id, NvM_MirrorModeType_t mode);
+
+/**
+ * @brief Allocate and initialize the mirror flavour a block uses
+ *
+ * Called by NvM_RegisterBlock: only the mirror of the given mode gets
+ * arena space, sized to the block (capped at RAM_MIRROR_MAX_BLOCK_SIZE).
+ * The mode is selected as by RamMirror_SetMode.
+ *
+ * @param block_id Block ID
+ * @param mode NVM_MIRROR_SEQLOCK or NVM_MIRROR_RCU
+ * @param block_size Block size in bytes
+ * @return Std_ReturnType E_OK on success, E_NOT_OK on invalid arguments or full arena
+ */
+Std_ReturnType RamMirror_Allocate(NvM_BlockIdType block_id, NvM_MirrorModeType_t mode,
+                                  uint16_t block_size);
+
+/**
+ * @brief Drop every mirror buffer and empty the arena (NvM_Init)
+ *
+ * Modes are kept; no mirror may be in use.
+ */
+void RamMirror_ResetAll(void);
+
+/**
+ * @brief Get the mirror mode of a block
+ */
+NvM_MirrorModeType_t RamMirror_GetMode(NvM_BlockIdType block_id);
+
+/**
+ * @brief Read a block's mirror in its configured mode
+ *
+ * @return boolean TRUE on success
+ */
+boolean RamMirror_Read(NvM_BlockIdType block_id, uint8_t* buffer, uint16_t size);
+
+/**
+ * @brief Write a block's mirror in its configured mode
+ *
+ * @return Std_ReturnType E_OK on success
+ */
+Std_ReturnType RamMirror_Write(NvM_BlockIdType block_id, const uint8_t* data, uint16_t size);
+
+#endif /* RAM_MIRROR_RCU_H */
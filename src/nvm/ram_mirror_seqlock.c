@@ -8,138 +8,430 @@
  * Design Reference: 03-Block管理机制.md §3.4.1-3.4.2
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "ram_mirror_seqlock.h"
+#include "ram_mirror_rcu.h"
 #include "nvm_internal.h"
+#include "trace_probes.h"
 #include "logging.h"
 #include <string.h>
 #include <stdatomic.h>
+#include <sched.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+/* Statistics shards per block (threads are spread round-robin) */
+#define SEQLOCK_STATS_SHARDS  8U
+
+/* Retries spent spinning with a CPU pause before yielding the CPU */
+#define SEQLOCK_SPIN_RETRIES  16U
+
+/* Checksum tag that never matches a stable (even) sequence */
+#define CHECKSUM_STALE  ((uint64_t)1U << 32)
+
+#define ARENA_ROUNDUP(size) \
+    (((size) + RAM_MIRROR_CACHE_LINE_SIZE - 1U) & ~(uint32_t)(RAM_MIRROR_CACHE_LINE_SIZE - 1U))
+
+/* Statistics shard: one cache line, updated once per read */
+typedef struct {
+    SeqlockStats_t stats;
+} RAM_MIRROR_CACHE_ALIGNED SeqlockStatsShard_t;
+
+/* Next shard handed to a new thread (shared by every context) */
+static uint32_t g_next_shard;
+
+/* Shard of the calling thread (SEQLOCK_STATS_SHARDS = not assigned yet) */
+static __thread uint32_t t_shard = SEQLOCK_STATS_SHARDS;
+
+/**
+ * @brief Seqlock mirrors of one context
+ */
+struct NvM_MirrorSeqlockState {
+    /* Seqlock-protected mirrors (indexed by block_id); data lives in the arena */
+    RamMirrorSeqlock_t seqlock_mirrors[NVM_MAX_BLOCKS];
+    RamMirrorVersioned_t versioned_mirrors[NVM_MAX_BLOCKS];
+
+    /* Mirror arena: bump allocated at registration, emptied by NvM_Init */
+    uint8_t mirror_arena[RAM_MIRROR_ARENA_SIZE] RAM_MIRROR_CACHE_ALIGNED;
+    uint32_t arena_used;
 
-/* Maximum retry attempts for seqlock read */
-#define SEQLOCK_MAX_RETRIES  1000
+    /* Per-block statistics, kept away from the mirrors' sequence lines */
+    SeqlockStatsShard_t seqlock_stats[NVM_MAX_BLOCKS][SEQLOCK_STATS_SHARDS];
 
-/* Global seqlock-protected mirrors (indexed by block_id) */
-static RamMirrorSeqlock_t g_seqlock_mirrors[NVM_MAX_BLOCKS];
-static RamMirrorVersioned_t g_versioned_mirrors[NVM_MAX_BLOCKS];
+    /* When RamMirror_SeqlockWrite computes the checksum (0: eager) */
+    RamMirror_ChecksumMode_t checksum_mode;
+};
 
-/* Per-block statistics */
-static SeqlockStats_t g_seqlock_stats[NVM_MAX_BLOCKS];
+/**
+ * @brief Mirrors used while no context is bound
+ */
+static struct NvM_MirrorSeqlockState g_default_state = { .checksum_mode = RAM_MIRROR_CHECKSUM_EAGER };
+
+static struct NvM_MirrorSeqlockState* seqlock_state(void)
+{
+    return (struct NvM_MirrorSeqlockState *)NvM_PartState(NVM_PART_MIRROR_SEQLOCK);
+}
 
 /* Atomic operations helpers */
 #define ATOMIC_LOAD_RELAXED(ptr)      __atomic_load_n((ptr), __ATOMIC_RELAXED)
 #define ATOMIC_LOAD_ACQUIRE(ptr)      __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
 #define ATOMIC_STORE_RELEASE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
 #define ATOMIC_FETCH_ADD(ptr, val)    __atomic_fetch_add((ptr), (val), __ATOMIC_ACQ_REL)
+#define ATOMIC_ADD_RELAXED(ptr, val)  __atomic_fetch_add((ptr), (val), __ATOMIC_RELAXED)
 
 /* Memory barrier */
 #define MEMORY_BARRIER_ACQUIRE()      __atomic_thread_fence(__ATOMIC_ACQUIRE)
 #define MEMORY_BARRIER_RELEASE()      __atomic_thread_fence(__ATOMIC_RELEASE)
 
 /**
- * @brief Calculate simple checksum for data integrity
+ * @brief Statistics shard of the calling thread for a block
+ */
+static SeqlockStats_t* stats_shard(NvM_BlockIdType block_id)
+{
+    struct NvM_MirrorSeqlockState *ms = seqlock_state();
+
+    if (t_shard >= SEQLOCK_STATS_SHARDS) {
+        t_shard = ATOMIC_ADD_RELAXED(&g_next_shard, 1U) % SEQLOCK_STATS_SHARDS;
+    }
+
+    return &ms->seqlock_stats[block_id][t_shard].stats;
+}
+
+/**
+ * @brief Account one read call (attempts, retries, tears)
+ *
+ * Shards may still be shared when threads outnumber them, so updates
+ * are relaxed atomics; they are made once per call, not per attempt.
+ */
+static void stats_account_read(NvM_BlockIdType block_id, uint32_t attempts,
+                               uint32_t retries, uint32_t tears)
+{
+    SeqlockStats_t* stats = stats_shard(block_id);
+
+    ATOMIC_ADD_RELAXED(&stats->read_count, attempts);
+    if (retries == 0U) {
+        return;
+    }
+
+    ATOMIC_ADD_RELAXED(&stats->read_retries, retries);
+    ATOMIC_ADD_RELAXED(&stats->data_tears, tears);
+
+    uint32_t max = ATOMIC_LOAD_RELAXED(&stats->max_retries);
+    while (retries > max &&
+           !__atomic_compare_exchange_n(&stats->max_retries, &max, retries, TRUE,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+/**
+ * @brief Back off in a RAM mirror retry/wait loop
+ *
+ * Spins with a CPU pause first (the writer is usually mid-memcpy), then
+ * yields so a preempted writer can finish.
+ */
+void RamMirror_Backoff(uint32_t retry_count)
+{
+    if (retry_count < SEQLOCK_SPIN_RETRIES) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#endif
+    } else {
+        sched_yield();
+    }
+}
+
+/**
+ * @brief Byte-sum checksum of src, copying it to dst in the same pass
+ *
+ * One load per 16 bytes feeds both the store and the sum (SAD against
+ * zero / pairwise widening adds), so a write reads its source once.
+ * dst may be NULL to only sum.
  */
-static uint32_t calculate_checksum(const uint8_t* data, uint16_t size)
+static inline uint32_t copy_checksum(uint8_t* dst, const uint8_t* src, uint16_t size)
 {
     uint32_t checksum = 0;
-    for (uint16_t i = 0; i < size; i++) {
-        checksum += data[i];
+    uint16_t i = 0;
+
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = zero;
+    for (; (uint32_t)i + 16U <= size; i += 16U) {
+        __m128i v = _mm_loadu_si128((const __m128i*)&src[i]);
+        if (dst != NULL) {
+            _mm_storeu_si128((__m128i*)&dst[i], v);
+        }
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(v, zero));
+    }
+    checksum = (uint32_t)_mm_cvtsi128_si32(acc) +
+               (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(acc, 8));
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    uint32x4_t acc = vdupq_n_u32(0);
+    for (; (uint32_t)i + 16U <= size; i += 16U) {
+        uint8x16_t v = vld1q_u8(&src[i]);
+        if (dst != NULL) {
+            vst1q_u8(&dst[i], v);
+        }
+        acc = vpadalq_u16(acc, vpaddlq_u8(v));
+    }
+    checksum = vaddvq_u32(acc);
+#endif
+
+    for (; i < size; i++) {
+        if (dst != NULL) {
+            dst[i] = src[i];
+        }
+        checksum += src[i];
     }
     return checksum;
 }
 
+uint8_t* RamMirror_ArenaAlloc(uint32_t size)
+{
+    struct NvM_MirrorSeqlockState *ms = seqlock_state();
+    uint32_t rounded = ARENA_ROUNDUP(size);
+
+    if (rounded == 0U || rounded > RAM_MIRROR_ARENA_SIZE - ms->arena_used) {
+        LOG_ERROR("RamMirror: Arena full (%u of %u bytes used, %u requested)",
+                 ms->arena_used, RAM_MIRROR_ARENA_SIZE, size);
+        return NULL;
+    }
+
+    uint8_t* buffer = &ms->mirror_arena[ms->arena_used];
+    ms->arena_used += rounded;
+    return buffer;
+}
+
+void RamMirror_ArenaReset(void)
+{
+    struct NvM_MirrorSeqlockState *ms = seqlock_state();
+
+    for (uint32_t i = 0; i < NVM_MAX_BLOCKS; i++) {
+        ms->seqlock_mirrors[i].data = NULL;
+        ms->seqlock_mirrors[i].size = 0;
+        ms->versioned_mirrors[i].data = NULL;
+        ms->versioned_mirrors[i].size = 0;
+    }
+    ms->arena_used = 0;
+}
+
+uint32_t RamMirror_GetArenaUsage(void)
+{
+    struct NvM_MirrorSeqlockState *ms = seqlock_state();
+
+    return ms->arena_used;
+}
+
+/**
+ * @brief Point a mirror at a buffer of size bytes, reusing one large enough
+ */
+static boolean mirror_buffer(uint8_t** data, uint16_t* current, uint16_t size)
+{
+    if (*data == NULL || ARENA_ROUNDUP(*current) < ARENA_ROUNDUP(size)) {
+        uint8_t* buffer = RamMirror_ArenaAlloc(size);
+        if (buffer == NULL) {
+            return FALSE;
+        }
+        *data = buffer;
+    }
+
+    *current = size;
+    return TRUE;
+}
+
 /**
  * @brief Initialize Seqlock-protected RAM Mirror
  */
 Std_ReturnType RamMirror_SeqlockInit(RamMirrorSeqlock_t* mirror, NvM_BlockIdType block_id)
 {
+    struct NvM_MirrorSeqlockState *ms = seqlock_state();
+
     if (mirror == NULL || block_id >= NVM_MAX_BLOCKS) {
         return E_NOT_OK;
     }
 
+    /* Standalone use (no registration): full-size mirror */
+    if (mirror->data == NULL &&
+        !mirror_buffer(&mirror->data, &mirror->size, RAM_MIRROR_MAX_BLOCK_SIZE)) {
+        return E_NOT_OK;
+    }
+
     /* Initialize structure */
     mirror->sequence = 0;  /* Even = stable */
-    memset(mirror->data, 0xFF, RAM_MIRROR_MAX_BLOCK_SIZE);  /* Erased state */
-    mirror->checksum = 0;
+    memset(mirror->data, 0xFF, mirror->size);  /* Erased state */
+    mirror->checksum = CHECKSUM_STALE;
+    mirror->generation = 0;
 
     /* Initialize statistics */
-    memset(&g_seqlock_stats[block_id], 0, sizeof(SeqlockStats_t));
+    memset(ms->seqlock_stats[block_id], 0, sizeof(ms->seqlock_stats[block_id]));
 
     LOG_DEBUG("Seqlock: Block %d initialized", block_id);
     return E_OK;
 }
 
+Std_ReturnType RamMirror_SeqlockAllocate(NvM_BlockIdType block_id, uint16_t size)
+{
+    struct NvM_MirrorSeqlockState *ms = seqlock_state();
+
+    if (block_id >= NVM_MAX_BLOCKS || size == 0U || size > RAM_MIRROR_MAX_BLOCK_SIZE) {
+        return E_NOT_OK;
+    }
+
+    RamMirrorSeqlock_t* mirror = &ms->seqlock_mirrors[block_id];
+    if (!mirror_buffer(&mirror->data, &mirror->size, size)) {
+        return E_NOT_OK;
+    }
+
+    return RamMirror_SeqlockInit(mirror, block_id);
+}
+
+Std_ReturnType RamMirror_VersionedAllocate(NvM_BlockIdType block_id, uint16_t size)
+{
+    struct NvM_MirrorSeqlockState *ms = seqlock_state();
+
+    if (block_id >= NVM_MAX_BLOCKS || size == 0U || size > RAM_MIRROR_MAX_BLOCK_SIZE) {
+        return E_NOT_OK;
+    }
+
+    RamMirrorVersioned_t* mirror = &ms->versioned_mirrors[block_id];
+    if (!mirror_buffer(&mirror->data, &mirror->size, size)) {
+        return E_NOT_OK;
+    }
+
+    /* Version keeps counting: it feeds RamMirror_GetGeneration */
+    __atomic_store_n(&mirror->meta.combined, mirror->meta.combined & ~0xFFFFFFFFULL,
+                     __ATOMIC_RELEASE);
+    memset(mirror->data, 0xFF, size);  /* Erased state */
+    mirror->checksum = 0;
+    return E_OK;
+}
+
 /**
- * @brief Lock-free atomic read from Seqlock-protected mirror
+ * @brief Lock-free read window shared by all non-versioned reads
  *
  * Design Reference: 03§3.4.1 Seqlock无锁机制
  *
+ * Runs fn on data[offset .. offset+len-1] until no write overlapped it.
+ *
  * Performance:
  * - No contention: ~8-12ns (single read + memory barrier)
  * - High contention: ~20-50ns (with retries)
  * - Worst case: SEQLOCK_MAX_RETRIES attempts
  */
-boolean RamMirror_SeqlockRead(NvM_BlockIdType block_id, uint8_t* buffer, uint16_t size)
+static boolean seqlock_read_window(NvM_BlockIdType block_id, uint16_t offset, uint16_t len,
+                                   RamMirror_VisitFn fn, void* ctx)
 {
-    if (block_id >= NVM_MAX_BLOCKS || buffer == NULL || size > RAM_MIRROR_MAX_BLOCK_SIZE) {
-        return FALSE;
-    }
-
-    RamMirrorSeqlock_t* mirror = &g_seqlock_mirrors[block_id];
-    SeqlockStats_t* stats = &g_seqlock_stats[block_id];
+    struct NvM_MirrorSeqlockState *ms = seqlock_state();
+    RamMirrorSeqlock_t* mirror = &ms->seqlock_mirrors[block_id];
 
     uint32_t retry_count = 0;
+    uint32_t tears = 0;
 
     /* Retry loop with bounded attempts */
     while (retry_count < SEQLOCK_MAX_RETRIES) {
-        stats->read_count++;
-
         /* Step 1: Read sequence number (acquire semantics) */
         uint32_t seq1 = ATOMIC_LOAD_ACQUIRE(&mirror->sequence);
 
         /* Step 2: Check if write is in progress (odd sequence) */
         if (seq1 & 1) {
-            /* Writer active, retry after yielding */
+            /* Writer active, retry after backing off */
+            TRACE_PROBE3(ram_mirror, seqlock_retry, block_id, retry_count, 0);
+            RamMirror_Backoff(retry_count);
             retry_count++;
-            stats->read_retries++;
             continue;
         }
 
-        /* Step 3: Copy data to buffer (atomic operation not needed here) */
-        memcpy(buffer, mirror->data, size);
+        /* Step 3: Run the visitor on the mirror bytes (atomic operation not needed here) */
+        fn(&mirror->data[offset], len, ctx);
 
-        /* Step 4: Memory barrier (ensure copy completes before checking seq again) */
+        /* Step 4: Memory barrier (ensure accesses complete before checking seq again) */
         MEMORY_BARRIER_ACQUIRE();
 
         /* Step 5: Read sequence number again */
         uint32_t seq2 = ATOMIC_LOAD_ACQUIRE(&mirror->sequence);
 
-        /* Step 6: Check if sequence changed during copy */
+        /* Step 6: Check if sequence changed during the window */
         if (seq1 == seq2) {
-            /* No write occurred during copy, data is consistent */
-
-            /* Update max retries statistic */
-            if (retry_count > stats->max_retries) {
-                stats->max_retries = retry_count;
-            }
+            /* No write occurred during the window, data is consistent */
+            stats_account_read(block_id, retry_count + 1U, retry_count, tears);
 
-            LOG_DEBUG("Seqlock: Block %d read success (retries=%u)",
-                     block_id, retry_count);
+            LOG_DEBUG("Seqlock: Block %d read success (offset=%u, len=%u, retries=%u)",
+                     block_id, offset, len, retry_count);
             return TRUE;
         }
 
-        /* Sequence changed, retry */
+        /* Sequence changed (data tearing detected), retry */
+        TRACE_PROBE3(ram_mirror, seqlock_retry, block_id, retry_count, 1);
+        RamMirror_Backoff(retry_count);
         retry_count++;
-        stats->read_retries++;
-
-        /* Data tearing detected */
-        stats->data_tears++;
+        tears++;
     }
 
     /* Exceeded max retries */
+    stats_account_read(block_id, retry_count, retry_count, tears);
     LOG_ERROR("Seqlock: Block %d read failed after %u retries",
               block_id, SEQLOCK_MAX_RETRIES);
     return FALSE;
 }
 
+/**
+ * @brief Visitor of the copying reads
+ */
+static void copy_visitor(const uint8_t* data, uint16_t len, void* ctx)
+{
+    memcpy(ctx, data, len);
+}
+
+static boolean range_valid(NvM_BlockIdType block_id, uint16_t offset, uint16_t len)
+{
+    struct NvM_MirrorSeqlockState *ms = seqlock_state();
+
+    return (block_id < NVM_MAX_BLOCKS && ms->seqlock_mirrors[block_id].data != NULL &&
+            (uint32_t)offset + len <= ms->seqlock_mirrors[block_id].size) ? TRUE : FALSE;
+}
+
+/**
+ * @brief Lock-free atomic read from Seqlock-protected mirror
+ */
+boolean RamMirror_SeqlockRead(NvM_BlockIdType block_id, uint8_t* buffer, uint16_t size)
+{
+    return RamMirror_SeqlockReadRange(block_id, 0U, buffer, size);
+}
+
+/**
+ * @brief Partial-range read from the Seqlock-protected mirror
+ *
+ * Only the requested bytes are copied inside the sequence window.
+ */
+boolean RamMirror_SeqlockReadRange(NvM_BlockIdType block_id, uint16_t offset,
+                                   uint8_t* buffer, uint16_t len)
+{
+    if (buffer == NULL || !range_valid(block_id, offset, len)) {
+        return FALSE;
+    }
+
+    return seqlock_read_window(block_id, offset, len, copy_visitor, buffer);
+}
+
+/**
+ * @brief Zero-copy read: run a visitor against the mirror bytes
+ */
+boolean RamMirror_SeqlockVisit(NvM_BlockIdType block_id, uint16_t offset, uint16_t len,
+                               RamMirror_VisitFn fn, void* ctx)
+{
+    if (fn == NULL || !range_valid(block_id, offset, len)) {
+        return FALSE;
+    }
+
+    return seqlock_read_window(block_id, offset, len, fn, ctx);
+}
+
 /**
  * @brief Atomic write to Seqlock-protected mirror
  *
@@ -153,37 +445,109 @@ Std_ReturnType RamMirror_SeqlockWrite(NvM_BlockIdType block_id,
                                       const uint8_t* data,
                                       uint16_t size)
 {
-    if (block_id >= NVM_MAX_BLOCKS || data == NULL || size > RAM_MIRROR_MAX_BLOCK_SIZE) {
+    struct NvM_MirrorSeqlockState *ms = seqlock_state();
+
+    if (data == NULL || !range_valid(block_id, 0U, size)) {
         return E_NOT_OK;
     }
 
-    RamMirrorSeqlock_t* mirror = &g_seqlock_mirrors[block_id];
-    SeqlockStats_t* stats = &g_seqlock_stats[block_id];
+    RamMirrorSeqlock_t* mirror = &ms->seqlock_mirrors[block_id];
 
     /* Step 1: Read current sequence number */
     uint32_t current_seq = ATOMIC_LOAD_RELAXED(&mirror->sequence);
 
-    /* Step 2: Increment to odd value (mark write start) */
-    uint32_t new_seq = current_seq + 1;
-    ATOMIC_STORE_RELEASE(&mirror->sequence, new_seq);
+    /* Step 2: Claim even -> odd (mark write start, serializes writers) */
+    uint32_t spins = 0;
+    while ((current_seq & 1U) != 0U ||
+           !__atomic_compare_exchange_n(&mirror->sequence, &current_seq, current_seq + 1U,
+                                        FALSE, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+        RamMirror_Backoff(spins++);
+        current_seq = ATOMIC_LOAD_RELAXED(&mirror->sequence);
+    }
+    uint32_t new_seq;
 
     /* Memory barrier (ensure readers see odd sequence) */
     MEMORY_BARRIER_RELEASE();
 
-    /* Step 3: Write data and calculate checksum */
-    memcpy(mirror->data, data, size);
-    mirror->checksum = calculate_checksum(data, size);
+    /* Step 3: Write data; the checksum comes from the same pass or later */
+    new_seq = current_seq + 2;
+    if (ms->checksum_mode == RAM_MIRROR_CHECKSUM_EAGER) {
+        /* Covers the whole mirror, bytes past a short write included */
+        uint32_t checksum = copy_checksum(mirror->data, data, size) +
+                            copy_checksum(NULL, &mirror->data[size], mirror->size - size);
+        __atomic_store_n(&mirror->checksum, ((uint64_t)new_seq << 32) | checksum,
+                         __ATOMIC_RELAXED);
+    } else {
+        memcpy(mirror->data, data, size);
+    }
 
     /* Step 4: Increment to even value (mark write complete) */
-    new_seq = current_seq + 2;
     ATOMIC_STORE_RELEASE(&mirror->sequence, new_seq);
+    ATOMIC_FETCH_ADD(&mirror->generation, 1U);
 
-    stats->write_count++;
+    ATOMIC_ADD_RELAXED(&stats_shard(block_id)->write_count, 1U);
 
     LOG_DEBUG("Seqlock: Block %d write complete (seq=%u)", block_id, new_seq);
     return E_OK;
 }
 
+void RamMirror_SetChecksumMode(RamMirror_ChecksumMode_t mode)
+{
+    struct NvM_MirrorSeqlockState *ms = seqlock_state();
+
+    ms->checksum_mode = mode;
+}
+
+typedef struct {
+    const RamMirrorSeqlock_t* mirror;
+    uint32_t sequence;
+    uint32_t checksum;
+} ChecksumVisit_t;
+
+/**
+ * @brief Visitor summing the mirror; the sequence it saw is the window's
+ */
+static void checksum_visitor(const uint8_t* data, uint16_t len, void* ctx)
+{
+    ChecksumVisit_t* visit = (ChecksumVisit_t*)ctx;
+
+    visit->sequence = ATOMIC_LOAD_RELAXED(&visit->mirror->sequence);
+    visit->checksum = copy_checksum(NULL, data, len);
+}
+
+/**
+ * @brief Get the data checksum, computing it outside the write window if stale
+ */
+boolean RamMirror_SeqlockGetChecksum(NvM_BlockIdType block_id, uint32_t* checksum)
+{
+    struct NvM_MirrorSeqlockState *ms = seqlock_state();
+
+    if (checksum == NULL || !range_valid(block_id, 0U, 0U)) {
+        return FALSE;
+    }
+
+    RamMirrorSeqlock_t* mirror = &ms->seqlock_mirrors[block_id];
+
+    /* The tag names the data the checksum belongs to */
+    uint64_t tagged = ATOMIC_LOAD_ACQUIRE(&mirror->checksum);
+    if ((uint32_t)(tagged >> 32) == ATOMIC_LOAD_ACQUIRE(&mirror->sequence)) {
+        *checksum = (uint32_t)tagged;
+        return TRUE;
+    }
+
+    ChecksumVisit_t visit = { mirror, 0U, 0U };
+    if (!seqlock_read_window(block_id, 0U, mirror->size, checksum_visitor, &visit)) {
+        return FALSE;
+    }
+
+    /* Publish unless a writer stored a newer one meanwhile */
+    (void)__atomic_compare_exchange_n(&mirror->checksum, &tagged,
+                                      ((uint64_t)visit.sequence << 32) | visit.checksum,
+                                      FALSE, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+    *checksum = visit.checksum;
+    return TRUE;
+}
+
 /**
  * @brief Lock-free read with ABA protection (versioned)
  *
@@ -198,26 +562,27 @@ boolean RamMirror_SeqlockReadVersioned(NvM_BlockIdType block_id,
                                        uint16_t size,
                                        uint32_t* out_version)
 {
-    if (block_id >= NVM_MAX_BLOCKS || buffer == NULL || size > RAM_MIRROR_MAX_BLOCK_SIZE) {
+    struct NvM_MirrorSeqlockState *ms = seqlock_state();
+
+    if (block_id >= NVM_MAX_BLOCKS || buffer == NULL ||
+        ms->versioned_mirrors[block_id].data == NULL || size > ms->versioned_mirrors[block_id].size) {
         return FALSE;
     }
 
-    RamMirrorVersioned_t* mirror = &g_versioned_mirrors[block_id];
-    SeqlockStats_t* stats = &g_seqlock_stats[block_id];
+    RamMirrorVersioned_t* mirror = &ms->versioned_mirrors[block_id];
 
     uint32_t retry_count = 0;
+    uint32_t tears = 0;
 
     while (retry_count < SEQLOCK_MAX_RETRIES) {
-        stats->read_count++;
-
         /* Step 1: Atomically load combined meta (64-bit) */
         uint64_t meta1 = __atomic_load_n(&mirror->meta.combined, __ATOMIC_ACQUIRE);
 
         /* Step 2: Check if write is in progress (odd sequence) */
         uint32_t seq1 = (uint32_t)(meta1 & 0xFFFFFFFFULL);
         if (seq1 & 1) {
+            RamMirror_Backoff(retry_count);
             retry_count++;
-            stats->read_retries++;
             continue;
         }
 
@@ -238,9 +603,7 @@ boolean RamMirror_SeqlockReadVersioned(NvM_BlockIdType block_id,
                 *out_version = mirror->meta.version;
             }
 
-            if (retry_count > stats->max_retries) {
-                stats->max_retries = retry_count;
-            }
+            stats_account_read(block_id, retry_count + 1U, retry_count, tears);
 
             LOG_DEBUG("SeqlockV: Block %d read success (version=%u, retries=%u)",
                      block_id, mirror->meta.version, retry_count);
@@ -248,11 +611,12 @@ boolean RamMirror_SeqlockReadVersioned(NvM_BlockIdType block_id,
         }
 
         /* Meta changed (either write in progress or version incremented) */
+        RamMirror_Backoff(retry_count);
         retry_count++;
-        stats->read_retries++;
-        stats->data_tears++;
+        tears++;
     }
 
+    stats_account_read(block_id, retry_count, retry_count, tears);
     LOG_ERROR("SeqlockV: Block %d read failed after %u retries",
               block_id, SEQLOCK_MAX_RETRIES);
     return FALSE;
@@ -269,51 +633,112 @@ Std_ReturnType RamMirror_SeqlockWriteVersioned(NvM_BlockIdType block_id,
                                                const uint8_t* data,
                                                uint16_t size)
 {
-    if (block_id >= NVM_MAX_BLOCKS || data == NULL || size > RAM_MIRROR_MAX_BLOCK_SIZE) {
+    struct NvM_MirrorSeqlockState *ms = seqlock_state();
+
+    if (block_id >= NVM_MAX_BLOCKS || data == NULL ||
+        ms->versioned_mirrors[block_id].data == NULL || size > ms->versioned_mirrors[block_id].size) {
         return E_NOT_OK;
     }
 
-    RamMirrorVersioned_t* mirror = &g_versioned_mirrors[block_id];
-    SeqlockStats_t* stats = &g_seqlock_stats[block_id];
+    RamMirrorVersioned_t* mirror = &ms->versioned_mirrors[block_id];
 
     /* Step 1: Atomically load current meta */
     uint64_t old_meta = __atomic_load_n(&mirror->meta.combined, __ATOMIC_RELAXED);
-    uint32_t old_seq = (uint32_t)(old_meta & 0xFFFFFFFFULL);
-    uint32_t old_ver = (uint32_t)((old_meta >> 32) & 0xFFFFFFFFULL);
+    uint32_t old_seq;
+    uint32_t old_ver;
+    uint64_t new_meta;
+    uint32_t spins = 0;
+
+    /* Step 2: Claim sequence even -> odd (write start), increment version */
+    for (;;) {
+        old_seq = (uint32_t)(old_meta & 0xFFFFFFFFULL);
+        old_ver = (uint32_t)((old_meta >> 32) & 0xFFFFFFFFULL);
+        new_meta = ((uint64_t)(old_ver + 1) << 32) | (old_seq + 1);
+
+        if ((old_seq & 1U) == 0U &&
+            __atomic_compare_exchange_n(&mirror->meta.combined, &old_meta, new_meta,
+                                        FALSE, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            break;
+        }
 
-    /* Step 2: Increment sequence to odd (write start), increment version */
-    uint64_t new_meta = ((uint64_t)(old_ver + 1) << 32) | (old_seq + 1);
-    __atomic_store_n(&mirror->meta.combined, new_meta, __ATOMIC_RELEASE);
+        RamMirror_Backoff(spins++);
+        old_meta = __atomic_load_n(&mirror->meta.combined, __ATOMIC_RELAXED);
+    }
 
     /* Memory barrier */
     MEMORY_BARRIER_RELEASE();
 
-    /* Step 3: Write data and checksum */
-    memcpy(mirror->data, data, size);
-    mirror->checksum = calculate_checksum(data, size);
+    /* Step 3: Write data and checksum (one pass) */
+    mirror->checksum = copy_checksum(mirror->data, data, size);
 
     /* Step 4: Increment sequence to even (write complete) */
     new_meta = ((uint64_t)(old_ver + 1) << 32) | (old_seq + 2);
     __atomic_store_n(&mirror->meta.combined, new_meta, __ATOMIC_RELEASE);
 
-    stats->write_count++;
+    ATOMIC_ADD_RELAXED(&stats_shard(block_id)->write_count, 1U);
 
     LOG_DEBUG("SeqlockV: Block %d write complete (seq=%u, version=%u)",
              block_id, old_seq + 2, old_ver + 1);
     return E_OK;
 }
 
+/**
+ * @brief Get the seqlock-protected mirror of a block
+ */
+RamMirrorSeqlock_t* RamMirror_GetSeqlockMirror(NvM_BlockIdType block_id)
+{
+    struct NvM_MirrorSeqlockState *ms = seqlock_state();
+
+    if (block_id >= NVM_MAX_BLOCKS) {
+        return NULL;
+    }
+
+    return &ms->seqlock_mirrors[block_id];
+}
+
+/**
+ * @brief Get the write generation of a block's mirrors
+ */
+uint32_t RamMirror_GetGeneration(NvM_BlockIdType block_id)
+{
+    struct NvM_MirrorSeqlockState *ms = seqlock_state();
+
+    if (block_id >= NVM_MAX_BLOCKS) {
+        return 0;
+    }
+
+    /* All counters only grow, so their sum changes on any write */
+    return ATOMIC_LOAD_ACQUIRE(&ms->seqlock_mirrors[block_id].generation) +
+           (uint32_t)(__atomic_load_n(&ms->versioned_mirrors[block_id].meta.combined,
+                                      __ATOMIC_ACQUIRE) >> 32) +
+           RamMirror_RcuGetVersion(block_id);
+}
+
 /**
  * @brief Get seqlock statistics for diagnostics
  */
 Std_ReturnType RamMirror_GetSeqlockStats(NvM_BlockIdType block_id, SeqlockStats_t* stats)
 {
+    struct NvM_MirrorSeqlockState *ms = seqlock_state();
+
     if (block_id >= NVM_MAX_BLOCKS || stats == NULL) {
         return E_NOT_OK;
     }
 
-    /* Atomically copy statistics */
-    memcpy(stats, &g_seqlock_stats[block_id], sizeof(SeqlockStats_t));
+    /* Aggregate the per-thread shards */
+    memset(stats, 0, sizeof(SeqlockStats_t));
+    for (uint32_t i = 0; i < SEQLOCK_STATS_SHARDS; i++) {
+        const SeqlockStats_t* shard = &ms->seqlock_stats[block_id][i].stats;
+        uint32_t max_retries = ATOMIC_LOAD_RELAXED(&shard->max_retries);
+
+        stats->read_count += ATOMIC_LOAD_RELAXED(&shard->read_count);
+        stats->read_retries += ATOMIC_LOAD_RELAXED(&shard->read_retries);
+        stats->write_count += ATOMIC_LOAD_RELAXED(&shard->write_count);
+        stats->data_tears += ATOMIC_LOAD_RELAXED(&shard->data_tears);
+        if (max_retries > stats->max_retries) {
+            stats->max_retries = max_retries;
+        }
+    }
     return E_OK;
 }
 
@@ -322,11 +747,18 @@ Std_ReturnType RamMirror_GetSeqlockStats(NvM_BlockIdType block_id, SeqlockStats_
  */
 Std_ReturnType RamMirror_ResetSeqlockStats(NvM_BlockIdType block_id)
 {
+    struct NvM_MirrorSeqlockState *ms = seqlock_state();
+
     if (block_id >= NVM_MAX_BLOCKS) {
         return E_NOT_OK;
     }
 
-    memset(&g_seqlock_stats[block_id], 0, sizeof(SeqlockStats_t));
+    memset(ms->seqlock_stats[block_id], 0, sizeof(ms->seqlock_stats[block_id]));
     LOG_DEBUG("Seqlock: Block %d statistics reset", block_id);
     return E_OK;
 }
+
+const NvM_PartDesc_t NvM_MirrorSeqlockPart = {
+    .size = sizeof(struct NvM_MirrorSeqlockState),
+    .default_state = &g_default_state
+};
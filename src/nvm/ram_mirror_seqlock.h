@@ -32,19 +32,48 @@
  */
 #define RAM_MIRROR_MAX_BLOCK_SIZE  1024
 
+/*
+ * Mirror arena capacity (all flavours of all blocks)
+ *
+ * Mirrors are carved from the arena when a block is registered, sized to
+ * the block (capped at RAM_MIRROR_MAX_BLOCK_SIZE) instead of reserving the
+ * maximum for every possible block ID.
+ */
+#ifndef RAM_MIRROR_ARENA_SIZE
+#define RAM_MIRROR_ARENA_SIZE  (64U * 1024U)
+#endif
+
+/*
+ * Maximum retry attempts for seqlock read
+ */
+#define SEQLOCK_MAX_RETRIES  1000
+
+/*
+ * Cache line size used to keep sequence words and statistics apart
+ */
+#define RAM_MIRROR_CACHE_LINE_SIZE  64
+
+#define RAM_MIRROR_CACHE_ALIGNED  __attribute__((aligned(RAM_MIRROR_CACHE_LINE_SIZE)))
+
 /**
  * @brief Seqlock-protected RAM Mirror structure
  *
  * Layout:
- * - sequence: volatile uint32_t (must be first for alignment)
- * - data: actual block data
- * - checksum: data integrity verification
+ * - sequence: volatile uint32_t, on the first cache line with the (read-only
+ *   after allocation) data pointer and size readers need anyway
+ * - data: actual block data, a cache-aligned arena buffer of size bytes
+ *   (NULL until allocated)
+ * - checksum: byte sum of data, tagged in the upper half with the sequence
+ *   value it belongs to (stale when the tag differs from the sequence)
+ * - generation: write counter (for dirty detection)
  */
 typedef struct {
     volatile uint32_t sequence;  /* Sequence number (odd=writing, even=stable) */
-    uint8_t data[RAM_MIRROR_MAX_BLOCK_SIZE];  /* Block data */
-    uint32_t checksum;          /* Data checksum (for dirty detection) */
-} RamMirrorSeqlock_t;
+    uint16_t size;              /* Mirror bytes */
+    uint8_t* data;              /* Block data (arena) */
+    uint64_t checksum RAM_MIRROR_CACHE_ALIGNED;  /* sequence << 32 | data checksum */
+    uint32_t generation;        /* Incremented by every completed write */
+} RAM_MIRROR_CACHE_ALIGNED RamMirrorSeqlock_t;
 
 /**
  * @brief Versioned RAM Mirror with ABA protection
@@ -62,12 +91,24 @@ typedef struct {
             uint32_t version;   /* Version counter (ABA protection) */
         };
     } meta;
-    uint8_t data[RAM_MIRROR_MAX_BLOCK_SIZE];
-    uint32_t checksum;
-} RamMirrorVersioned_t;
+    uint16_t size;              /* Mirror bytes */
+    uint8_t* data;              /* Block data (arena, NULL until allocated) */
+    uint32_t checksum RAM_MIRROR_CACHE_ALIGNED;
+} RAM_MIRROR_CACHE_ALIGNED RamMirrorVersioned_t;
+
+/**
+ * @brief When RamMirror_SeqlockWrite computes the data checksum
+ */
+typedef enum {
+    RAM_MIRROR_CHECKSUM_EAGER = 0,  /* In the write window, fused with the copy (default) */
+    RAM_MIRROR_CHECKSUM_LAZY        /* On demand, by RamMirror_SeqlockGetChecksum */
+} RamMirror_ChecksumMode_t;
 
 /**
  * @brief Seqlock statistics for diagnostics
+ *
+ * Counters are kept in per-thread shards and summed by
+ * RamMirror_GetSeqlockStats (max_retries is the maximum over shards).
  */
 typedef struct {
     uint32_t read_count;        /* Total read attempts */
@@ -80,12 +121,43 @@ typedef struct {
 /**
  * @brief Initialize Seqlock-protected RAM Mirror
  *
+ * A mirror without a buffer (block not registered in seqlock mode) gets a
+ * RAM_MIRROR_MAX_BLOCK_SIZE buffer from the arena.
+ *
  * @param mirror Pointer to RamMirrorSeqlock_t structure
  * @param block_id Block ID for identification
- * @return Std_ReturnType E_OK on success, E_NOT_OK on failure
+ * @return Std_ReturnType E_OK on success, E_NOT_OK on failure or full arena
  */
 Std_ReturnType RamMirror_SeqlockInit(RamMirrorSeqlock_t* mirror, NvM_BlockIdType block_id);
 
+/**
+ * @brief Give a block's seqlock mirror a buffer of size bytes and initialize it
+ *
+ * A buffer already large enough is reused (re-registration).
+ *
+ * @param block_id Block ID
+ * @param size Mirror bytes (1 .. RAM_MIRROR_MAX_BLOCK_SIZE)
+ * @return Std_ReturnType E_OK on success, E_NOT_OK on invalid arguments or full arena
+ */
+Std_ReturnType RamMirror_SeqlockAllocate(NvM_BlockIdType block_id, uint16_t size);
+
+/**
+ * @brief Give a block's versioned mirror a buffer of size bytes and initialize it
+ *
+ * The versioned mirror is not allocated by NvM_RegisterBlock: callers of
+ * RamMirror_SeqlockReadVersioned/WriteVersioned allocate it first.
+ *
+ * @param block_id Block ID
+ * @param size Mirror bytes (1 .. RAM_MIRROR_MAX_BLOCK_SIZE)
+ * @return Std_ReturnType E_OK on success, E_NOT_OK on invalid arguments or full arena
+ */
+Std_ReturnType RamMirror_VersionedAllocate(NvM_BlockIdType block_id, uint16_t size);
+
+/**
+ * @brief Arena bytes handed out (alignment padding included)
+ */
+uint32_t RamMirror_GetArenaUsage(void);
+
 /**
  * @brief Lock-free atomic read from Seqlock-protected mirror
  *
@@ -99,28 +171,99 @@ Std_ReturnType RamMirror_SeqlockInit(RamMirrorSeqlock_t* mirror, NvM_BlockIdType
  *
  * @param block_id Block ID to read
  * @param buffer Output buffer (must be pre-allocated)
- * @param size Buffer size
- * @return boolean TRUE on success, FALSE on retry limit exceeded
+ * @param size Buffer size (at most the mirror size)
+ * @return boolean TRUE on success, FALSE on invalid arguments, no mirror
+ *         buffer or retry limit exceeded
  */
 boolean RamMirror_SeqlockRead(NvM_BlockIdType block_id, uint8_t* buffer, uint16_t size);
 
+/**
+ * @brief Partial-range read from Seqlock-protected mirror
+ *
+ * Same algorithm as RamMirror_SeqlockRead, copying only
+ * data[offset .. offset+len-1], so readers pay only for the fields they use.
+ *
+ * @param block_id Block ID to read
+ * @param offset Byte offset within the block
+ * @param buffer Output buffer of at least len bytes
+ * @param len Number of bytes to read
+ * @return boolean TRUE on success, FALSE on invalid range or retry limit exceeded
+ */
+boolean RamMirror_SeqlockReadRange(NvM_BlockIdType block_id, uint16_t offset,
+                                   uint8_t* buffer, uint16_t len);
+
+/**
+ * @brief Visitor over a mirror range inside the sequence window
+ *
+ * @param data Mirror bytes (data[0] is the byte at the requested offset)
+ * @param len Length of the range
+ * @param ctx Caller context
+ */
+typedef void (*RamMirror_VisitFn)(const uint8_t* data, uint16_t len, void* ctx);
+
+/**
+ * @brief Zero-copy read: run a visitor directly against the mirror bytes
+ *
+ * The visitor runs between the two sequence reads and is re-run if a
+ * write overlapped it. Only the state left by the final run (after TRUE
+ * is returned) is consistent, so the visitor must:
+ * - write its results to ctx only (overwrite, not accumulate)
+ * - not trust the bytes for control flow beyond bounds it checks itself
+ * - be short: a long visitor widens the window and raises retries
+ *
+ * @param block_id Block ID to read
+ * @param offset Byte offset within the block
+ * @param len Number of bytes the visitor may access
+ * @param fn Visitor
+ * @param ctx Passed to fn
+ * @return boolean TRUE once fn ran on a stable snapshot, FALSE on invalid
+ *         arguments or retry limit exceeded
+ */
+boolean RamMirror_SeqlockVisit(NvM_BlockIdType block_id, uint16_t offset, uint16_t len,
+                               RamMirror_VisitFn fn, void* ctx);
+
 /**
  * @brief Atomic write to Seqlock-protected mirror
  *
  * Algorithm:
  * 1. Read current sequence number
- * 2. Increment to odd value (mark write start)
+ * 2. Compare-and-swap even -> odd (mark write start; concurrent writers wait)
  * 3. Memory barrier (ensure visible to readers)
- * 4. Write data and checksum
+ * 4. Copy data, summing it in the same pass (eager checksum mode only)
  * 5. Increment to even value (mark write complete)
  *
  * @param block_id Block ID to write
  * @param data Input data buffer
- * @param size Data size
+ * @param size Data size (at most the mirror size)
  * @return Std_ReturnType E_OK on success
  */
 Std_ReturnType RamMirror_SeqlockWrite(NvM_BlockIdType block_id, const uint8_t* data, uint16_t size);
 
+/**
+ * @brief Select when seqlock writes compute the data checksum
+ *
+ * Lazy mode keeps the write window down to the copy: the checksum of a
+ * block is computed by the first RamMirror_SeqlockGetChecksum after a
+ * write, outside any write window, and only for blocks that ask.
+ *
+ * @param mode RAM_MIRROR_CHECKSUM_EAGER or RAM_MIRROR_CHECKSUM_LAZY
+ */
+void RamMirror_SetChecksumMode(RamMirror_ChecksumMode_t mode);
+
+/**
+ * @brief Get the data checksum of a seqlock mirror
+ *
+ * Returns the stored checksum when it belongs to the current data;
+ * otherwise sums the data in a read window and stores the result for the
+ * next caller.
+ *
+ * @param block_id Block ID
+ * @param checksum Output byte sum of the mirror data
+ * @return boolean TRUE on success, FALSE on invalid arguments, no mirror
+ *         buffer or retry limit exceeded
+ */
+boolean RamMirror_SeqlockGetChecksum(NvM_BlockIdType block_id, uint32_t* checksum);
+
 /**
  * @brief Lock-free read with ABA protection (versioned)
  *
@@ -151,6 +294,27 @@ Std_ReturnType RamMirror_SeqlockWriteVersioned(NvM_BlockIdType block_id,
                                                const uint8_t* data,
                                                uint16_t size);
 
+/**
+ * @brief Get the seqlock-protected mirror of a block
+ *
+ * @param block_id Block ID
+ * @return Mirror pointer, or NULL for out-of-range block IDs
+ */
+RamMirrorSeqlock_t* RamMirror_GetSeqlockMirror(NvM_BlockIdType block_id);
+
+/**
+ * @brief Get the write generation of a block's mirrors
+ *
+ * Changes whenever RamMirror_SeqlockWrite, RamMirror_SeqlockWriteVersioned
+ * or RamMirror_RcuWrite completes for the block. NvM compares it with the
+ * value saved at the last persist to flag a block dirty without hashing
+ * its data.
+ *
+ * @param block_id Block ID
+ * @return Generation (0 for out-of-range block IDs)
+ */
+uint32_t RamMirror_GetGeneration(NvM_BlockIdType block_id);
+
 /**
  * @brief Get seqlock statistics for diagnostics
  *
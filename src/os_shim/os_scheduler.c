@@ -7,9 +7,20 @@
  * - 优先级抢占
  * - 虚拟时钟管理
  * - 统计信息收集
+ * - 离散事件推进: 按 next_activation_ms 的最小堆直接跳到下一事件
+ * - 多核模式: 每个虚拟核一个OS线程, 独立任务集与就绪堆, 按虚拟时间屏障同步
+ * - 多实例: 调度器状态属于上下文, 核线程继承启动线程绑定的全部上下文
  */
 
+#define _POSIX_C_SOURCE 200112L
+
 #include "os_scheduler.h"
+#include "metrics.h"
+#include "timeline.h"
+#include "trace_probes.h"
+#include "sim_context.h"
+#include <pthread.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -34,97 +45,380 @@ typedef enum {
 } SchedulerState_t;
 
 /**
- * @brief Global scheduler state
+ * @brief Registered task
+ *
+ * The public control block comes first, so an OsTask_t pointer handed out
+ * by the scheduler is also the entry pointer.
  */
-static struct {
-    SchedulerState_t state;
+typedef struct {
+    OsTask_t task;
+    uint32_t order;                 /**< Registration order (tie-break among equal priorities) */
+} OsTaskEntry_t;
+
+/**
+ * @brief Virtual core: task set, ready heap and clock
+ */
+typedef struct {
     OsTask_t *tasks[MAX_TASKS];
     uint8_t task_count;
+    OsTask_t *heap[MAX_TASKS];      /**< Non-suspended tasks, earliest activation first */
+    uint8_t heap_count;
     uint32_t virtual_time_ms;
-    OsTimeScale_t time_scale;
     uint32_t interrupt_disable_count;
+    uint32_t charged_us;            /**< Work reported by the running task */
+    boolean in_task;
     OsSchedulerStats_t stats;
-} g_scheduler = {0};
+} OsCore_t;
 
 /**
- * @brief Find task by ID
+ * @brief Scheduler state of one context
+ */
+struct OsScheduler_Context {
+    SchedulerState_t state;
+    OsCore_t cores[OS_MAX_CORES];
+    uint8_t core_count;
+    boolean cores_running;          /**< OsScheduler_RunCores in progress */
+    uint32_t next_order;
+    OsTimeScale_t time_scale;
+
+    /* OsScheduler_RunCores: epoch barrier and start gate of the core threads */
+    pthread_barrier_t core_barrier;
+    pthread_mutex_t core_start_lock;
+    pthread_cond_t core_start_cond;
+    int core_start;                 /**< 0: wait, 1: run, -1: abort */
+};
+
+/**
+ * @brief Context used while none is bound
+ */
+static OsScheduler_Context_t g_default_context = {
+    .core_count = 1,
+    .core_start_lock = PTHREAD_MUTEX_INITIALIZER,
+    .core_start_cond = PTHREAD_COND_INITIALIZER
+};
+
+static OsScheduler_Context_t* scheduler(void)
+{
+    OsScheduler_Context_t *bound = (OsScheduler_Context_t *)SimContext_Get(SIM_CONTEXT_SCHED);
+
+    return (bound != NULL) ? bound : &g_default_context;
+}
+
+/**
+ * @brief Core the calling thread runs (NULL: core 0)
+ */
+static __thread OsCore_t *t_core = NULL;
+
+static OsCore_t* current_core(void)
+{
+    return (t_core != NULL) ? t_core : &scheduler()->cores[0];
+}
+
+/**
+ * @brief Find task by ID (IDs are unique over all cores)
  *
  * @param task_id Task ID to find
+ * @param core Set to the owning core if found (may be NULL)
  * @return Task pointer or NULL
  */
-static OsTask_t* find_task(OsTaskId_t task_id)
+static OsTask_t* find_task(OsTaskId_t task_id, OsCore_t **core)
 {
-    for (uint8_t i = 0; i < g_scheduler.task_count; i++) {
-        if (g_scheduler.tasks[i] != NULL &&
-            g_scheduler.tasks[i]->task_id == task_id) {
-            return g_scheduler.tasks[i];
+    OsScheduler_Context_t *sch = scheduler();
+
+    for (uint8_t c = 0; c < sch->core_count; c++) {
+        OsCore_t *oc = &sch->cores[c];
+        for (uint8_t i = 0; i < oc->task_count; i++) {
+            if (oc->tasks[i] != NULL && oc->tasks[i]->task_id == task_id) {
+                if (core != NULL) {
+                    *core = oc;
+                }
+                return oc->tasks[i];
+            }
         }
     }
     return NULL;
 }
 
+static uint32_t task_order(const OsTask_t *task)
+{
+    return ((const OsTaskEntry_t *)task)->order;
+}
+
+/**
+ * @brief Activation heap order: activation time, then priority, then registration
+ */
+static boolean heap_less(const OsTask_t *a, const OsTask_t *b)
+{
+    if (a->next_activation_ms != b->next_activation_ms) {
+        return (a->next_activation_ms < b->next_activation_ms) ? TRUE : FALSE;
+    }
+    if (a->priority != b->priority) {
+        return (a->priority < b->priority) ? TRUE : FALSE;
+    }
+    return (task_order(a) < task_order(b)) ? TRUE : FALSE;
+}
+
+static void heap_sift_up(OsCore_t *core, uint8_t pos)
+{
+    OsTask_t **heap = core->heap;
+
+    while (pos > 0U) {
+        uint8_t parent = (uint8_t)((pos - 1U) / 2U);
+        if (!heap_less(heap[pos], heap[parent])) {
+            break;
+        }
+        OsTask_t *tmp = heap[pos];
+        heap[pos] = heap[parent];
+        heap[parent] = tmp;
+        pos = parent;
+    }
+}
+
+static void heap_sift_down(OsCore_t *core, uint8_t pos)
+{
+    OsTask_t **heap = core->heap;
+
+    for (;;) {
+        uint8_t left = (uint8_t)(2U * pos + 1U);
+        uint8_t right = (uint8_t)(left + 1U);
+        uint8_t best = pos;
+
+        if (left < core->heap_count && heap_less(heap[left], heap[best])) {
+            best = left;
+        }
+        if (right < core->heap_count && heap_less(heap[right], heap[best])) {
+            best = right;
+        }
+        if (best == pos) {
+            break;
+        }
+        OsTask_t *tmp = heap[pos];
+        heap[pos] = heap[best];
+        heap[best] = tmp;
+        pos = best;
+    }
+}
+
+static void heap_push(OsCore_t *core, OsTask_t *task)
+{
+    core->heap[core->heap_count] = task;
+    core->heap_count++;
+    heap_sift_up(core, (uint8_t)(core->heap_count - 1U));
+}
+
+static OsTask_t* heap_pop(OsCore_t *core)
+{
+    OsTask_t *top = core->heap[0];
+
+    core->heap_count--;
+    core->heap[0] = core->heap[core->heap_count];
+    heap_sift_down(core, 0);
+    return top;
+}
+
+static void heap_remove(OsCore_t *core, const OsTask_t *task)
+{
+    for (uint8_t i = 0; i < core->heap_count; i++) {
+        if (core->heap[i] == task) {
+            core->heap_count--;
+            core->heap[i] = core->heap[core->heap_count];
+            if (i < core->heap_count) {
+                heap_sift_down(core, i);
+                heap_sift_up(core, i);
+            }
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Counter source for Metrics_Export
+ */
+static uint32_t scheduler_counters(Metrics_Counter_t *counters, uint32_t max)
+{
+    OsSchedulerStats_t stats;
+    uint32_t n = 0;
+
+    if (OsScheduler_GetStats(&stats) != E_OK) {
+        return 0;
+    }
+
+#define SCHED_COUNTER(counter_name, counter_value) \
+    do { \
+        if (n < max) { \
+            counters[n].name = (counter_name); \
+            counters[n].value = (counter_value); \
+            n++; \
+        } \
+    } while (0)
+
+    SCHED_COUNTER("virtual_time_ms", OsScheduler_GetVirtualTimeMs());
+    SCHED_COUNTER("total_ticks", stats.total_ticks);
+    SCHED_COUNTER("idle_ticks", stats.idle_ticks);
+    SCHED_COUNTER("context_switches", stats.context_switches);
+    SCHED_COUNTER("deadline_misses", stats.deadline_misses);
+    SCHED_COUNTER("max_exec_time_us", stats.max_exec_time_us);
+
+#undef SCHED_COUNTER
+
+    return n;
+}
+
+OsScheduler_Context_t* OsScheduler_CreateContext(void)
+{
+    OsScheduler_Context_t *ctx = (OsScheduler_Context_t *)calloc(1, sizeof(OsScheduler_Context_t));
+
+    if (ctx == NULL) {
+        return NULL;
+    }
+
+    ctx->state = SCHEDULER_STOPPED;
+    ctx->time_scale = TIME_SCALE_1X;
+    ctx->core_count = 1;
+    (void)pthread_mutex_init(&ctx->core_start_lock, NULL);
+    (void)pthread_cond_init(&ctx->core_start_cond, NULL);
+    return ctx;
+}
+
+void OsScheduler_DestroyContext(OsScheduler_Context_t *ctx)
+{
+    if (ctx == NULL || ctx == &g_default_context) {
+        return;
+    }
+
+    (void)pthread_cond_destroy(&ctx->core_start_cond);
+    (void)pthread_mutex_destroy(&ctx->core_start_lock);
+    free(ctx);
+}
+
+OsScheduler_Context_t* OsScheduler_BindContext(OsScheduler_Context_t *ctx)
+{
+    return (OsScheduler_Context_t *)SimContext_Bind(SIM_CONTEXT_SCHED, ctx);
+}
+
 Std_ReturnType OsScheduler_Init(uint8_t max_tasks)
 {
+    OsScheduler_Context_t *sch = scheduler();
+
     (void)max_tasks; /* Reserved for future use */
 
-    /* Reset scheduler state */
-    memset(&g_scheduler, 0, sizeof(g_scheduler));
-    g_scheduler.state = SCHEDULER_STOPPED;
-    g_scheduler.time_scale = TIME_SCALE_1X;
-    g_scheduler.virtual_time_ms = 0;
+    /* Reset scheduler state (the core thread gate is kept) */
+    memset(sch, 0, offsetof(OsScheduler_Context_t, core_barrier));
+    sch->state = SCHEDULER_STOPPED;
+    sch->time_scale = TIME_SCALE_1X;
+    sch->core_count = 1;
+
+    (void)Metrics_RegisterCounterSource("scheduler", scheduler_counters);
+    return E_OK;
+}
+
+Std_ReturnType OsScheduler_SetCoreCount(uint8_t core_count)
+{
+    OsScheduler_Context_t *sch = scheduler();
+
+    if (core_count == 0U || core_count > OS_MAX_CORES || sch->cores_running) {
+        return E_NOT_OK;
+    }
+
+    /* Cores being removed must not own tasks */
+    for (uint8_t c = core_count; c < sch->core_count; c++) {
+        if (sch->cores[c].task_count > 0U) {
+            return E_NOT_OK;
+        }
+    }
+
+    /* New cores start at core 0's time */
+    for (uint8_t c = sch->core_count; c < core_count; c++) {
+        memset(&sch->cores[c], 0, sizeof(OsCore_t));
+        sch->cores[c].virtual_time_ms = sch->cores[0].virtual_time_ms;
+    }
 
+    sch->core_count = core_count;
     return E_OK;
 }
 
+uint8_t OsScheduler_GetCoreCount(void)
+{
+    OsScheduler_Context_t *sch = scheduler();
+
+    return sch->core_count;
+}
+
+OsCoreId_t OsScheduler_GetCoreId(void)
+{
+    OsScheduler_Context_t *sch = scheduler();
+
+    return (OsCoreId_t)(current_core() - sch->cores);
+}
+
 Std_ReturnType OsScheduler_RegisterTask(const OsTask_t *task)
 {
-    if (task == NULL) {
+    return OsScheduler_RegisterTaskOnCore(0, task);
+}
+
+Std_ReturnType OsScheduler_RegisterTaskOnCore(OsCoreId_t core_id, const OsTask_t *task)
+{
+    OsScheduler_Context_t *sch = scheduler();
+
+    if (task == NULL || core_id >= sch->core_count || sch->cores_running) {
         return E_NOT_OK;
     }
 
-    if (g_scheduler.task_count >= MAX_TASKS) {
+    OsCore_t *core = &sch->cores[core_id];
+    if (core->task_count >= MAX_TASKS) {
         return E_NOT_OK;
     }
 
     /* Check if task ID already exists */
-    if (find_task(task->task_id) != NULL) {
+    if (find_task(task->task_id, NULL) != NULL) {
         return E_NOT_OK;
     }
 
     /* Allocate task structure */
-    OsTask_t *new_task = (OsTask_t *)malloc(sizeof(OsTask_t));
-    if (new_task == NULL) {
+    OsTaskEntry_t *entry = (OsTaskEntry_t *)malloc(sizeof(OsTaskEntry_t));
+    if (entry == NULL) {
         return E_NOT_OK;
     }
 
     /* Copy task structure */
+    OsTask_t *new_task = &entry->task;
     memcpy(new_task, task, sizeof(OsTask_t));
     new_task->state = OS_TASK_READY;
     new_task->next_activation_ms = 0;
     new_task->execution_count = 0;
+    entry->order = sch->next_order++;
 
     /* Add to task list */
-    g_scheduler.tasks[g_scheduler.task_count++] = new_task;
+    core->tasks[core->task_count++] = new_task;
+    heap_push(core, new_task);
 
     return E_OK;
 }
 
 Std_ReturnType OsScheduler_UnregisterTask(OsTaskId_t task_id)
 {
-    OsTask_t *task = find_task(task_id);
+    OsScheduler_Context_t *sch = scheduler();
+    OsCore_t *core = NULL;
+
+    if (sch->cores_running) {
+        return E_NOT_OK;
+    }
+
+    OsTask_t *task = find_task(task_id, &core);
     if (task == NULL) {
         return E_NOT_OK;
     }
 
     /* Remove from task list */
-    for (uint8_t i = 0; i < g_scheduler.task_count; i++) {
-        if (g_scheduler.tasks[i] == task) {
+    for (uint8_t i = 0; i < core->task_count; i++) {
+        if (core->tasks[i] == task) {
             /* Shift remaining tasks */
-            for (uint8_t j = i; j < g_scheduler.task_count - 1; j++) {
-                g_scheduler.tasks[j] = g_scheduler.tasks[j + 1];
+            for (uint8_t j = i; j < core->task_count - 1; j++) {
+                core->tasks[j] = core->tasks[j + 1];
             }
-            g_scheduler.tasks[g_scheduler.task_count - 1] = NULL;
-            g_scheduler.task_count--;
+            core->tasks[core->task_count - 1] = NULL;
+            core->task_count--;
+            heap_remove(core, task);
 
             free(task);
             return E_OK;
@@ -136,19 +430,26 @@ Std_ReturnType OsScheduler_UnregisterTask(OsTaskId_t task_id)
 
 Std_ReturnType OsScheduler_Start(void)
 {
-    if (g_scheduler.state == SCHEDULER_RUNNING) {
+    OsScheduler_Context_t *sch = scheduler();
+
+    if (sch->state == SCHEDULER_RUNNING) {
         return E_NOT_OK;
     }
 
-    g_scheduler.state = SCHEDULER_RUNNING;
-    g_scheduler.virtual_time_ms = 0;
+    sch->state = SCHEDULER_RUNNING;
 
     /* Initialize all tasks */
-    for (uint8_t i = 0; i < g_scheduler.task_count; i++) {
-        OsTask_t *task = g_scheduler.tasks[i];
-        if (task != NULL) {
-            task->state = OS_TASK_READY;
-            task->next_activation_ms = 0;
+    for (uint8_t c = 0; c < sch->core_count; c++) {
+        OsCore_t *core = &sch->cores[c];
+        core->virtual_time_ms = 0;
+        core->heap_count = 0;
+        for (uint8_t i = 0; i < core->task_count; i++) {
+            OsTask_t *task = core->tasks[i];
+            if (task != NULL) {
+                task->state = OS_TASK_READY;
+                task->next_activation_ms = 0;
+                heap_push(core, task);
+            }
         }
     }
 
@@ -157,154 +458,465 @@ Std_ReturnType OsScheduler_Start(void)
 
 Std_ReturnType OsScheduler_Stop(void)
 {
-    if (g_scheduler.state != SCHEDULER_RUNNING) {
+    OsScheduler_Context_t *sch = scheduler();
+
+    if (sch->state != SCHEDULER_RUNNING) {
         return E_NOT_OK;
     }
 
-    g_scheduler.state = SCHEDULER_STOPPED;
+    sch->state = SCHEDULER_STOPPED;
     return E_OK;
 }
 
-static OsTask_t* select_next_task(void)
+/**
+ * @brief Take the highest priority task due at the current virtual time
+ *
+ * Only the due tasks at the top of the activation heap are visited; the
+ * ones not selected go straight back.
+ *
+ * @return Task removed from the heap, or NULL if none is due
+ */
+static OsTask_t* select_next_task(OsCore_t *core)
 {
+    OsTask_t *due[MAX_TASKS];
+    uint8_t due_count = 0;
     OsTask_t *selected = NULL;
-    OsTaskPriority_t highest_priority = 255;
-
-    /* Find highest priority ready task */
-    for (uint8_t i = 0; i < g_scheduler.task_count; i++) {
-        OsTask_t *task = g_scheduler.tasks[i];
-        if (task != NULL && task->state == OS_TASK_READY) {
-            /* Check if task should activate now */
-            if (g_scheduler.virtual_time_ms >= task->next_activation_ms) {
-                if (task->priority < highest_priority) {
-                    highest_priority = task->priority;
-                    selected = task;
-                }
-            }
+
+    while (core->heap_count > 0U &&
+           core->heap[0]->next_activation_ms <= core->virtual_time_ms) {
+        OsTask_t *task = heap_pop(core);
+        task->state = OS_TASK_READY;
+        due[due_count++] = task;
+        if (selected == NULL || task->priority < selected->priority ||
+            (task->priority == selected->priority && task_order(task) < task_order(selected))) {
+            selected = task;
+        }
+    }
+
+    for (uint8_t i = 0; i < due_count; i++) {
+        if (due[i] != selected) {
+            heap_push(core, due[i]);
         }
     }
 
     return selected;
 }
 
+/**
+ * @brief Run the task selected for the current tick, if any
+ *
+ * @return TRUE if a task ran
+ */
+static boolean run_tick(OsCore_t *core)
+{
+    OsScheduler_Context_t *sch = scheduler();
+    OsTask_t *task = select_next_task(core);
+    if (task == NULL) {
+        /* No ready task, idle */
+        core->stats.idle_ticks++;
+        return FALSE;
+    }
+
+    /* Execute task */
+    task->state = OS_TASK_RUNNING;
+
+    uint32_t start_time = core->virtual_time_ms;
+    core->charged_us = 0;
+    core->in_task = TRUE;
+
+    TRACE_PROBE3(sched, task_start, core - sch->cores, task->task_id, start_time);
+    if (task->task_func != NULL) {
+        task->task_func();
+    }
+
+    core->in_task = FALSE;
+
+    /* Elapsed virtual time plus work the task reported without sleeping */
+    uint32_t exec_time_ms = core->virtual_time_ms - start_time;
+    uint32_t exec_time_us = exec_time_ms * 1000 + core->charged_us;
+    TRACE_PROBE3(sched, task_done, core - sch->cores, task->task_id, exec_time_us);
+    if (TIMELINE_ACTIVE()) {
+        Timeline_TaskRun((uint8_t)(core - sch->cores), task->task_id, task->task_name,
+                         (uint64_t)start_time * 1000U, exec_time_us);
+    }
+
+    /* Update statistics */
+    task->execution_count++;
+    core->stats.context_switches++;
+
+    if (exec_time_us > core->stats.max_exec_time_us) {
+        core->stats.max_exec_time_us = exec_time_us;
+    }
+
+    /* Check for deadline miss */
+    if (task->deadline_relative_ms > 0) {
+        if (exec_time_us > task->deadline_relative_ms * 1000U) {
+            core->stats.deadline_misses++;
+        }
+    }
+
+    /* Schedule next activation for periodic tasks */
+    if (task->period_ms > 0) {
+        task->next_activation_ms = core->virtual_time_ms + task->period_ms;
+        task->state = OS_TASK_READY;
+        heap_push(core, task);
+    } else {
+        /* One-shot task */
+        task->state = OS_TASK_SUSPENDED;
+    }
+
+    return TRUE;
+}
+
 void OsScheduler_Tick(void)
 {
-    if (g_scheduler.state != SCHEDULER_RUNNING) {
+    OsScheduler_Context_t *sch = scheduler();
+
+    if (sch->state != SCHEDULER_RUNNING) {
         return;
     }
 
-    /* Advance virtual time */
-    g_scheduler.virtual_time_ms += SCHEDULER_TICK_MS;
-    g_scheduler.stats.total_ticks++;
+    /* Cores in ID order, each on its own clock */
+    OsCore_t *saved = t_core;
+    for (uint8_t c = 0; c < sch->core_count; c++) {
+        OsCore_t *core = &sch->cores[c];
+        t_core = core;
 
-    /* Check for task activations */
-    for (uint8_t i = 0; i < g_scheduler.task_count; i++) {
-        OsTask_t *task = g_scheduler.tasks[i];
-        if (task != NULL && task->state != OS_TASK_SUSPENDED) {
-            if (g_scheduler.virtual_time_ms >= task->next_activation_ms) {
-                task->state = OS_TASK_READY;
-            }
-        }
+        /* Advance virtual time */
+        core->virtual_time_ms += SCHEDULER_TICK_MS;
+        core->stats.total_ticks++;
+
+        (void)run_tick(core);
     }
+    t_core = saved;
+}
+
+/**
+ * @brief Next tick at which a core has something to run (never before now + 1)
+ */
+static uint32_t core_next_event(const OsCore_t *core, uint32_t end_time_ms)
+{
+    uint32_t now = core->virtual_time_ms;
 
-    /* Select and run highest priority ready task */
-    OsTask_t *task = select_next_task();
-    if (task != NULL) {
-        /* Execute task */
-        task->state = OS_TASK_RUNNING;
+    if (core->heap_count == 0U) {
+        return end_time_ms;
+    }
 
-        uint32_t start_time = g_scheduler.virtual_time_ms;
+    /* A tick runs at most one task, so the next event is never before now + 1 */
+    uint32_t due = core->heap[0]->next_activation_ms;
+    due = (due > now) ? due : now + SCHEDULER_TICK_MS;
+    return (due < end_time_ms) ? due : end_time_ms;
+}
 
-        if (task->task_func != NULL) {
-            task->task_func();
-        }
+/**
+ * @brief Discrete-event run of one core up to end_time_ms
+ *
+ * @return Number of task runs
+ */
+static uint32_t core_run_until(OsCore_t *core, uint32_t end_time_ms)
+{
+    OsScheduler_Context_t *sch = scheduler();
+    uint32_t executed = 0;
 
-        uint32_t exec_time_ms = g_scheduler.virtual_time_ms - start_time;
-        uint32_t exec_time_us = exec_time_ms * 1000;
+    while (sch->state == SCHEDULER_RUNNING && core->virtual_time_ms < end_time_ms) {
+        uint32_t now = core->virtual_time_ms;
+        uint32_t next = core_next_event(core, end_time_ms);
 
-        /* Update statistics */
-        task->execution_count++;
-        g_scheduler.stats.context_switches++;
+        /* Skipped ticks are accounted as if they had been ticked */
+        uint32_t skipped = next - now - SCHEDULER_TICK_MS;
+        core->stats.total_ticks += next - now;
+        core->stats.idle_ticks += skipped;
+        core->virtual_time_ms = next;
 
-        if (exec_time_us > g_scheduler.stats.max_exec_time_us) {
-            g_scheduler.stats.max_exec_time_us = exec_time_us;
+        if (run_tick(core)) {
+            executed++;
         }
+    }
+
+    return executed;
+}
+
+uint32_t OsScheduler_RunUntil(uint32_t end_time_ms)
+{
+    OsScheduler_Context_t *sch = scheduler();
+    uint32_t executed = 0;
+
+    if (sch->core_count == 1U) {
+        return core_run_until(&sch->cores[0], end_time_ms);
+    }
 
-        /* Check for deadline miss */
-        if (task->deadline_relative_ms > 0) {
-            if (exec_time_ms > task->deadline_relative_ms) {
-                g_scheduler.stats.deadline_misses++;
+    /* Lockstep on the calling thread: every core up to the earliest next event */
+    OsCore_t *saved = t_core;
+    while (sch->state == SCHEDULER_RUNNING) {
+        uint32_t next = end_time_ms;
+        boolean pending = FALSE;
+
+        for (uint8_t c = 0; c < sch->core_count; c++) {
+            const OsCore_t *core = &sch->cores[c];
+            if (core->virtual_time_ms < end_time_ms) {
+                uint32_t due = core_next_event(core, end_time_ms);
+                next = (due < next) ? due : next;
+                pending = TRUE;
             }
         }
+        if (!pending) {
+            break;
+        }
 
-        /* Schedule next activation for periodic tasks */
-        if (task->period_ms > 0) {
-            task->next_activation_ms = g_scheduler.virtual_time_ms + task->period_ms;
-            task->state = OS_TASK_READY;
-        } else {
-            /* One-shot task */
-            task->state = OS_TASK_SUSPENDED;
+        for (uint8_t c = 0; c < sch->core_count; c++) {
+            t_core = &sch->cores[c];
+            executed += core_run_until(t_core, next);
         }
+    }
+    t_core = saved;
+
+    return executed;
+}
+
+/**
+ * @brief Per-thread state of OsScheduler_RunCores
+ */
+typedef struct {
+    OsCore_t *core;
+    pthread_t thread;
+    uint32_t start_ms;
+    uint32_t end_ms;
+    uint32_t barrier_ms;
+    uint32_t executed;
+    SimContext_Binding_t binding;   /**< Contexts of the calling thread, bound on the core thread */
+} OsCoreRun_t;
+
+/**
+ * @brief Run one core epoch by epoch, meeting the other cores at each barrier
+ *
+ * Epoch ends are derived from the shared start time, so every core passes
+ * the same number of barriers even if it was stopped or ran ahead.
+ */
+static void run_core_epochs(OsCoreRun_t *run)
+{
+    OsScheduler_Context_t *sch = scheduler();
+    uint32_t epoch_end = run->start_ms;
+
+    t_core = run->core;
+    while (epoch_end < run->end_ms) {
+        uint32_t remaining = run->end_ms - epoch_end;
+        epoch_end += (remaining < run->barrier_ms) ? remaining : run->barrier_ms;
+        run->executed += core_run_until(run->core, epoch_end);
+        (void)pthread_barrier_wait(&sch->core_barrier);
+    }
+    t_core = NULL;
+}
+
+static void* core_thread(void *arg)
+{
+    OsScheduler_Context_t *sch = scheduler();
+    OsCoreRun_t *run = (OsCoreRun_t *)arg;
+    int start;
+
+    SimContext_Restore(&run->binding);
+    pthread_mutex_lock(&sch->core_start_lock);
+    while (sch->core_start == 0) {
+        pthread_cond_wait(&sch->core_start_cond, &sch->core_start_lock);
+    }
+    start = sch->core_start;
+    pthread_mutex_unlock(&sch->core_start_lock);
+
+    if (start > 0) {
+        run_core_epochs(run);
+    }
+    return NULL;
+}
+
+static void release_cores(int start)
+{
+    OsScheduler_Context_t *sch = scheduler();
+
+    pthread_mutex_lock(&sch->core_start_lock);
+    sch->core_start = start;
+    pthread_cond_broadcast(&sch->core_start_cond);
+    pthread_mutex_unlock(&sch->core_start_lock);
+}
+
+uint32_t OsScheduler_RunCores(uint32_t end_time_ms, uint32_t barrier_ms)
+{
+    OsScheduler_Context_t *sch = scheduler();
+    OsCoreRun_t runs[OS_MAX_CORES];
+    uint8_t count = sch->core_count;
+    uint8_t created = 0;
+    uint32_t executed = 0;
+
+    if (sch->state != SCHEDULER_RUNNING || sch->cores_running ||
+        barrier_ms == 0U || t_core != NULL) {
+        return 0;
+    }
+
+    uint32_t start_ms = sch->cores[0].virtual_time_ms;
+    if (start_ms >= end_time_ms) {
+        return 0;
+    }
+
+    if (pthread_barrier_init(&sch->core_barrier, NULL, count) != 0) {
+        return 0;
+    }
+
+    sch->cores_running = TRUE;
+    sch->core_start = 0;
+    for (uint8_t c = 0; c < count; c++) {
+        runs[c].core = &sch->cores[c];
+        runs[c].start_ms = start_ms;
+        runs[c].end_ms = end_time_ms;
+        runs[c].barrier_ms = barrier_ms;
+        runs[c].executed = 0;
+        SimContext_Save(&runs[c].binding);
+    }
+
+    /* Core 0 runs on the calling thread, the others on their own threads */
+    for (uint8_t c = 1; c < count; c++) {
+        if (pthread_create(&runs[c].thread, NULL, core_thread, &runs[c]) != 0) {
+            break;
+        }
+        created++;
+    }
+
+    if (created + 1U == count) {
+        release_cores(1);
+        run_core_epochs(&runs[0]);
     } else {
-        /* No ready task, idle */
-        g_scheduler.stats.idle_ticks++;
+        release_cores(-1);
+    }
+
+    for (uint8_t c = 1; c <= created; c++) {
+        (void)pthread_join(runs[c].thread, NULL);
     }
+    (void)pthread_barrier_destroy(&sch->core_barrier);
+    sch->cores_running = FALSE;
+
+    if (created + 1U != count) {
+        return 0;
+    }
+
+    /* Leave one clock behind: cores that ran ahead set the time for all */
+    uint32_t latest = 0;
+    for (uint8_t c = 0; c < count; c++) {
+        executed += runs[c].executed;
+        if (sch->cores[c].virtual_time_ms > latest) {
+            latest = sch->cores[c].virtual_time_ms;
+        }
+    }
+    for (uint8_t c = 0; c < count; c++) {
+        sch->cores[c].virtual_time_ms = latest;
+    }
+
+    return executed;
 }
 
 uint32_t OsScheduler_GetVirtualTimeMs(void)
 {
-    return g_scheduler.virtual_time_ms;
+    return current_core()->virtual_time_ms;
+}
+
+uint64_t OsScheduler_GetVirtualTimeUs(void)
+{
+    const OsCore_t *core = current_core();
+
+    return (uint64_t)core->virtual_time_ms * 1000U + (core->in_task ? core->charged_us : 0U);
 }
 
 Std_ReturnType OsScheduler_SetTimeScale(OsTimeScale_t scale)
 {
-    g_scheduler.time_scale = scale;
+    OsScheduler_Context_t *sch = scheduler();
+
+    sch->time_scale = scale;
     return E_OK;
 }
 
 OsTimeScale_t OsScheduler_GetTimeScale(void)
 {
-    return g_scheduler.time_scale;
+    OsScheduler_Context_t *sch = scheduler();
+
+    return sch->time_scale;
 }
 
 Std_ReturnType OsScheduler_GetStats(OsSchedulerStats_t *stats)
 {
+    OsScheduler_Context_t *sch = scheduler();
+
     if (stats == NULL) {
         return E_NOT_OK;
     }
 
-    *stats = g_scheduler.stats;
+    /* Sum over cores: ticks are core-ticks */
+    memset(stats, 0, sizeof(OsSchedulerStats_t));
+    for (uint8_t c = 0; c < sch->core_count; c++) {
+        const OsSchedulerStats_t *cs = &sch->cores[c].stats;
+        stats->total_ticks += cs->total_ticks;
+        stats->idle_ticks += cs->idle_ticks;
+        stats->context_switches += cs->context_switches;
+        stats->deadline_misses += cs->deadline_misses;
+        if (cs->max_exec_time_us > stats->max_exec_time_us) {
+            stats->max_exec_time_us = cs->max_exec_time_us;
+        }
+    }
+    return E_OK;
+}
+
+Std_ReturnType OsScheduler_GetCoreStats(OsCoreId_t core_id, OsSchedulerStats_t *stats)
+{
+    OsScheduler_Context_t *sch = scheduler();
+
+    if (stats == NULL || core_id >= sch->core_count) {
+        return E_NOT_OK;
+    }
+
+    *stats = sch->cores[core_id].stats;
     return E_OK;
 }
 
 void OsScheduler_DisableInterrupts(void)
 {
-    g_scheduler.interrupt_disable_count++;
+    current_core()->interrupt_disable_count++;
 }
 
 void OsScheduler_EnableInterrupts(void)
 {
-    if (g_scheduler.interrupt_disable_count > 0) {
-        g_scheduler.interrupt_disable_count--;
+    OsCore_t *core = current_core();
+
+    if (core->interrupt_disable_count > 0) {
+        core->interrupt_disable_count--;
+    }
+}
+
+void OsScheduler_ReportExecTimeUs(uint32_t microseconds)
+{
+    OsCore_t *core = current_core();
+
+    if (core->in_task) {
+        core->charged_us += microseconds;
     }
 }
 
 void OsScheduler_Sleep(uint32_t milliseconds)
 {
-    /* In simulation, just advance virtual time */
-    g_scheduler.virtual_time_ms += milliseconds;
+    /* In simulation, just advance virtual time (of the calling core) */
+    current_core()->virtual_time_ms += milliseconds;
 }
 
 void OsScheduler_Destroy(void)
 {
+    OsScheduler_Context_t *sch = scheduler();
+
     /* Free all tasks */
-    for (uint8_t i = 0; i < g_scheduler.task_count; i++) {
-        if (g_scheduler.tasks[i] != NULL) {
-            free(g_scheduler.tasks[i]);
-            g_scheduler.tasks[i] = NULL;
+    for (uint8_t c = 0; c < sch->core_count; c++) {
+        OsCore_t *core = &sch->cores[c];
+        for (uint8_t i = 0; i < core->task_count; i++) {
+            if (core->tasks[i] != NULL) {
+                free(core->tasks[i]);
+                core->tasks[i] = NULL;
+            }
         }
+        core->task_count = 0;
+        core->heap_count = 0;
     }
 
-    g_scheduler.task_count = 0;
-    g_scheduler.state = SCHEDULER_STOPPED;
+    sch->state = SCHEDULER_STOPPED;
 }
@@ -0,0 +1,291 @@
+/**
+ * @file crc.c
+ * @brief CRC engine implementation (CRC8 / CRC16 / CRC32)
+ *
+ * REQ-数据完整性: design/04-数据完整性方案.md
+ * - Descriptor table indexed by NvM_CrcType_t
+ * - CRC-32C uses the hardware crc32c instruction when available
+ */
+
+#include "crc.h"
+#include "crc16.h"
+#include "fault_injection.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define CRC32C_HAVE_HW_X86 1
+#elif defined(__aarch64__)
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#define CRC32C_HAVE_HW_ARM 1
+#endif
+
+/**
+ * @brief CRC-8 SAE J1850 lookup table
+ *
+ * Polynomial: x^8 + x^4 + x^3 + x^2 + 1 (0x1D)
+ */
+static const uint8_t crc8_table[256] = {
+    0x00, 0x1D, 0x3A, 0x27, 0x74, 0x69, 0x4E, 0x53, 0xE8, 0xF5, 0xD2, 0xCF, 0x9C, 0x81, 0xA6, 0xBB,
+    0xCD, 0xD0, 0xF7, 0xEA, 0xB9, 0xA4, 0x83, 0x9E, 0x25, 0x38, 0x1F, 0x02, 0x51, 0x4C, 0x6B, 0x76,
+    0x87, 0x9A, 0xBD, 0xA0, 0xF3, 0xEE, 0xC9, 0xD4, 0x6F, 0x72, 0x55, 0x48, 0x1B, 0x06, 0x21, 0x3C,
+    0x4A, 0x57, 0x70, 0x6D, 0x3E, 0x23, 0x04, 0x19, 0xA2, 0xBF, 0x98, 0x85, 0xD6, 0xCB, 0xEC, 0xF1,
+    0x13, 0x0E, 0x29, 0x34, 0x67, 0x7A, 0x5D, 0x40, 0xFB, 0xE6, 0xC1, 0xDC, 0x8F, 0x92, 0xB5, 0xA8,
+    0xDE, 0xC3, 0xE4, 0xF9, 0xAA, 0xB7, 0x90, 0x8D, 0x36, 0x2B, 0x0C, 0x11, 0x42, 0x5F, 0x78, 0x65,
+    0x94, 0x89, 0xAE, 0xB3, 0xE0, 0xFD, 0xDA, 0xC7, 0x7C, 0x61, 0x46, 0x5B, 0x08, 0x15, 0x32, 0x2F,
+    0x59, 0x44, 0x63, 0x7E, 0x2D, 0x30, 0x17, 0x0A, 0xB1, 0xAC, 0x8B, 0x96, 0xC5, 0xD8, 0xFF, 0xE2,
+    0x26, 0x3B, 0x1C, 0x01, 0x52, 0x4F, 0x68, 0x75, 0xCE, 0xD3, 0xF4, 0xE9, 0xBA, 0xA7, 0x80, 0x9D,
+    0xEB, 0xF6, 0xD1, 0xCC, 0x9F, 0x82, 0xA5, 0xB8, 0x03, 0x1E, 0x39, 0x24, 0x77, 0x6A, 0x4D, 0x50,
+    0xA1, 0xBC, 0x9B, 0x86, 0xD5, 0xC8, 0xEF, 0xF2, 0x49, 0x54, 0x73, 0x6E, 0x3D, 0x20, 0x07, 0x1A,
+    0x6C, 0x71, 0x56, 0x4B, 0x18, 0x05, 0x22, 0x3F, 0x84, 0x99, 0xBE, 0xA3, 0xF0, 0xED, 0xCA, 0xD7,
+    0x35, 0x28, 0x0F, 0x12, 0x41, 0x5C, 0x7B, 0x66, 0xDD, 0xC0, 0xE7, 0xFA, 0xA9, 0xB4, 0x93, 0x8E,
+    0xF8, 0xE5, 0xC2, 0xDF, 0x8C, 0x91, 0xB6, 0xAB, 0x10, 0x0D, 0x2A, 0x37, 0x64, 0x79, 0x5E, 0x43,
+    0xB2, 0xAF, 0x88, 0x95, 0xC6, 0xDB, 0xFC, 0xE1, 0x5A, 0x47, 0x60, 0x7D, 0x2E, 0x33, 0x14, 0x09,
+    0x7F, 0x62, 0x45, 0x58, 0x0B, 0x16, 0x31, 0x2C, 0x97, 0x8A, 0xAD, 0xB0, 0xE3, 0xFE, 0xD9, 0xC4
+};
+
+/**
+ * @brief CRC-32C lookup table (reflected)
+ *
+ * Polynomial: 0x1EDC6F41 (reflected 0x82F63B78)
+ */
+static const uint32_t crc32c_table[256] = {
+    0x00000000, 0xF26B8303, 0xE13B70F7, 0x1350F3F4, 0xC79A971F, 0x35F1141C, 0x26A1E7E8, 0xD4CA64EB,
+    0x8AD958CF, 0x78B2DBCC, 0x6BE22838, 0x9989AB3B, 0x4D43CFD0, 0xBF284CD3, 0xAC78BF27, 0x5E133C24,
+    0x105EC76F, 0xE235446C, 0xF165B798, 0x030E349B, 0xD7C45070, 0x25AFD373, 0x36FF2087, 0xC494A384,
+    0x9A879FA0, 0x68EC1CA3, 0x7BBCEF57, 0x89D76C54, 0x5D1D08BF, 0xAF768BBC, 0xBC267848, 0x4E4DFB4B,
+    0x20BD8EDE, 0xD2D60DDD, 0xC186FE29, 0x33ED7D2A, 0xE72719C1, 0x154C9AC2, 0x061C6936, 0xF477EA35,
+    0xAA64D611, 0x580F5512, 0x4B5FA6E6, 0xB93425E5, 0x6DFE410E, 0x9F95C20D, 0x8CC531F9, 0x7EAEB2FA,
+    0x30E349B1, 0xC288CAB2, 0xD1D83946, 0x23B3BA45, 0xF779DEAE, 0x05125DAD, 0x1642AE59, 0xE4292D5A,
+    0xBA3A117E, 0x4851927D, 0x5B016189, 0xA96AE28A, 0x7DA08661, 0x8FCB0562, 0x9C9BF696, 0x6EF07595,
+    0x417B1DBC, 0xB3109EBF, 0xA0406D4B, 0x522BEE48, 0x86E18AA3, 0x748A09A0, 0x67DAFA54, 0x95B17957,
+    0xCBA24573, 0x39C9C670, 0x2A993584, 0xD8F2B687, 0x0C38D26C, 0xFE53516F, 0xED03A29B, 0x1F682198,
+    0x5125DAD3, 0xA34E59D0, 0xB01EAA24, 0x42752927, 0x96BF4DCC, 0x64D4CECF, 0x77843D3B, 0x85EFBE38,
+    0xDBFC821C, 0x2997011F, 0x3AC7F2EB, 0xC8AC71E8, 0x1C661503, 0xEE0D9600, 0xFD5D65F4, 0x0F36E6F7,
+    0x61C69362, 0x93AD1061, 0x80FDE395, 0x72966096, 0xA65C047D, 0x5437877E, 0x4767748A, 0xB50CF789,
+    0xEB1FCBAD, 0x197448AE, 0x0A24BB5A, 0xF84F3859, 0x2C855CB2, 0xDEEEDFB1, 0xCDBE2C45, 0x3FD5AF46,
+    0x7198540D, 0x83F3D70E, 0x90A324FA, 0x62C8A7F9, 0xB602C312, 0x44694011, 0x5739B3E5, 0xA55230E6,
+    0xFB410CC2, 0x092A8FC1, 0x1A7A7C35, 0xE811FF36, 0x3CDB9BDD, 0xCEB018DE, 0xDDE0EB2A, 0x2F8B6829,
+    0x82F63B78, 0x709DB87B, 0x63CD4B8F, 0x91A6C88C, 0x456CAC67, 0xB7072F64, 0xA457DC90, 0x563C5F93,
+    0x082F63B7, 0xFA44E0B4, 0xE9141340, 0x1B7F9043, 0xCFB5F4A8, 0x3DDE77AB, 0x2E8E845F, 0xDCE5075C,
+    0x92A8FC17, 0x60C37F14, 0x73938CE0, 0x81F80FE3, 0x55326B08, 0xA759E80B, 0xB4091BFF, 0x466298FC,
+    0x1871A4D8, 0xEA1A27DB, 0xF94AD42F, 0x0B21572C, 0xDFEB33C7, 0x2D80B0C4, 0x3ED04330, 0xCCBBC033,
+    0xA24BB5A6, 0x502036A5, 0x4370C551, 0xB11B4652, 0x65D122B9, 0x97BAA1BA, 0x84EA524E, 0x7681D14D,
+    0x2892ED69, 0xDAF96E6A, 0xC9A99D9E, 0x3BC21E9D, 0xEF087A76, 0x1D63F975, 0x0E330A81, 0xFC588982,
+    0xB21572C9, 0x407EF1CA, 0x532E023E, 0xA145813D, 0x758FE5D6, 0x87E466D5, 0x94B49521, 0x66DF1622,
+    0x38CC2A06, 0xCAA7A905, 0xD9F75AF1, 0x2B9CD9F2, 0xFF56BD19, 0x0D3D3E1A, 0x1E6DCDEE, 0xEC064EED,
+    0xC38D26C4, 0x31E6A5C7, 0x22B65633, 0xD0DDD530, 0x0417B1DB, 0xF67C32D8, 0xE52CC12C, 0x1747422F,
+    0x49547E0B, 0xBB3FFD08, 0xA86F0EFC, 0x5A048DFF, 0x8ECEE914, 0x7CA56A17, 0x6FF599E3, 0x9D9E1AE0,
+    0xD3D3E1AB, 0x21B862A8, 0x32E8915C, 0xC083125F, 0x144976B4, 0xE622F5B7, 0xF5720643, 0x07198540,
+    0x590AB964, 0xAB613A67, 0xB831C993, 0x4A5A4A90, 0x9E902E7B, 0x6CFBAD78, 0x7FAB5E8C, 0x8DC0DD8F,
+    0xE330A81A, 0x115B2B19, 0x020BD8ED, 0xF0605BEE, 0x24AA3F05, 0xD6C1BC06, 0xC5914FF2, 0x37FACCF1,
+    0x69E9F0D5, 0x9B8273D6, 0x88D28022, 0x7AB90321, 0xAE7367CA, 0x5C18E4C9, 0x4F48173D, 0xBD23943E,
+    0xF36E6F75, 0x0105EC76, 0x12551F82, 0xE03E9C81, 0x34F4F86A, 0xC69F7B69, 0xD5CF889D, 0x27A40B9E,
+    0x79B737BA, 0x8BDCB4B9, 0x988C474D, 0x6AE7C44E, 0xBE2DA0A5, 0x4C4623A6, 0x5F16D052, 0xAD7D5351
+};
+
+/**
+ * @brief CRC-32C kernel type (raw register in, raw register out)
+ */
+typedef uint32_t (*Crc32c_KernelFunc_t)(const uint8_t *data, uint32_t length, uint32_t crc);
+
+/**
+ * @brief CRC-32C kernel, resolved on first use
+ */
+static Crc32c_KernelFunc_t g_crc32c_kernel = NULL;
+
+/**
+ * @brief Table-driven CRC-32C kernel
+ */
+static uint32_t crc32c_kernel_table(const uint8_t *data, uint32_t length, uint32_t crc)
+{
+    for (uint32_t i = 0; i < length; i++) {
+        crc = (crc >> 8) ^ crc32c_table[(crc ^ data[i]) & 0xFFU];
+    }
+
+    return crc;
+}
+
+#if defined(CRC32C_HAVE_HW_X86)
+
+/**
+ * @brief SSE4.2 CRC-32C kernel, 8 bytes per instruction
+ */
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_kernel_hw(const uint8_t *data, uint32_t length, uint32_t crc)
+{
+    uint64_t crc64 = crc;
+
+    while (length >= 8U) {
+        uint64_t word;
+        __builtin_memcpy(&word, data, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        data += 8;
+        length -= 8U;
+    }
+
+    crc = (uint32_t)crc64;
+    while (length > 0U) {
+        crc = _mm_crc32_u8(crc, *data);
+        data++;
+        length--;
+    }
+
+    return crc;
+}
+
+static boolean crc32c_hw_supported(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2") ? TRUE : FALSE;
+}
+
+#elif defined(CRC32C_HAVE_HW_ARM)
+
+/**
+ * @brief ARMv8 CRC32C kernel, 8 bytes per instruction
+ */
+__attribute__((target("+crc")))
+static uint32_t crc32c_kernel_hw(const uint8_t *data, uint32_t length, uint32_t crc)
+{
+    while (length >= 8U) {
+        uint64_t word;
+        __builtin_memcpy(&word, data, sizeof(word));
+        crc = __crc32cd(crc, word);
+        data += 8;
+        length -= 8U;
+    }
+
+    while (length > 0U) {
+        crc = __crc32cb(crc, *data);
+        data++;
+        length--;
+    }
+
+    return crc;
+}
+
+static boolean crc32c_hw_supported(void)
+{
+    return (getauxval(AT_HWCAP) & HWCAP_CRC32) ? TRUE : FALSE;
+}
+
+#endif
+
+/**
+ * @brief Resolve the CRC-32C kernel
+ *
+ * Idempotent; concurrent first calls store the same pointer.
+ */
+static Crc32c_KernelFunc_t crc32c_get_kernel(void)
+{
+    Crc32c_KernelFunc_t kernel = __atomic_load_n(&g_crc32c_kernel, __ATOMIC_ACQUIRE);
+
+    if (kernel == NULL) {
+        kernel = crc32c_kernel_table;
+#if defined(CRC32C_HAVE_HW_X86) || defined(CRC32C_HAVE_HW_ARM)
+        if (crc32c_hw_supported()) {
+            kernel = crc32c_kernel_hw;
+        }
+#endif
+        __atomic_store_n(&g_crc32c_kernel, kernel, __ATOMIC_RELEASE);
+    }
+
+    return kernel;
+}
+
+uint8_t CRC_CalculateCRC8(const uint8_t *data, uint32_t length)
+{
+    uint8_t crc = 0xFFU;
+
+    for (uint32_t i = 0; i < length; i++) {
+        crc = crc8_table[crc ^ data[i]];
+    }
+    crc ^= 0xFFU;
+
+    /* Fault injection hook: CRC corruption (low byte of the 16-bit hook) */
+    uint16_t hooked = crc;
+    if (FAULT_INJ_ARMED(FAULT_INJ_MASK_CRC)) {
+        FaultInj_HookCrc(data, length, &hooked);
+    }
+
+    return (uint8_t)hooked;
+}
+
+uint16_t CRC_CalculateCRC16(const uint8_t *data, uint32_t length)
+{
+    /* Crc16_Calculate invokes the fault hook itself */
+    return Crc16_Calculate(data, length);
+}
+
+uint32_t CRC_CalculateCRC32(const uint8_t *data, uint32_t length)
+{
+    uint32_t crc = crc32c_get_kernel()(data, length, 0xFFFFFFFFUL) ^ 0xFFFFFFFFUL;
+
+    /* Fault injection hook: CRC corruption */
+    if (FAULT_INJ_ARMED(FAULT_INJ_MASK_CRC)) {
+        FaultInj_HookCrc32(data, length, &crc);
+    }
+
+    return crc;
+}
+
+/**
+ * @brief Adapters to the generic 32-bit CRC function type
+ */
+static uint32_t crc_calc8(const uint8_t *data, uint32_t length)
+{
+    return CRC_CalculateCRC8(data, length);
+}
+
+static uint32_t crc_calc16(const uint8_t *data, uint32_t length)
+{
+    return CRC_CalculateCRC16(data, length);
+}
+
+/**
+ * @brief CRC descriptor table, indexed by NvM_CrcType_t
+ */
+static const Crc_Descriptor_t g_crc_descriptors[] = {
+    { NVM_CRC_NONE, 0U, NULL },
+    { NVM_CRC8,     1U, crc_calc8 },
+    { NVM_CRC16,    2U, crc_calc16 },
+    { NVM_CRC32,    4U, CRC_CalculateCRC32 }
+};
+
+#define CRC_DESCRIPTOR_COUNT (sizeof(g_crc_descriptors) / sizeof(g_crc_descriptors[0]))
+
+const Crc_Descriptor_t* CRC_GetDescriptor(NvM_CrcType_t crc_type)
+{
+    if ((uint32_t)crc_type >= CRC_DESCRIPTOR_COUNT) {
+        return NULL;
+    }
+
+    return &g_crc_descriptors[crc_type];
+}
+
+uint8_t CRC_GetSize(NvM_CrcType_t crc_type)
+{
+    const Crc_Descriptor_t *desc = CRC_GetDescriptor(crc_type);
+
+    return (desc != NULL) ? desc->crc_size : 0U;
+}
+
+void CRC_Store(const Crc_Descriptor_t *desc, uint32_t crc, uint8_t *dst)
+{
+    for (uint8_t i = 0; i < desc->crc_size; i++) {
+        dst[i] = (uint8_t)(crc >> (8U * i));
+    }
+}
+
+uint32_t CRC_Load(const Crc_Descriptor_t *desc, const uint8_t *src)
+{
+    uint32_t crc = 0;
+
+    for (uint8_t i = 0; i < desc->crc_size; i++) {
+        crc |= (uint32_t)src[i] << (8U * i);
+    }
+
+    return crc;
+}
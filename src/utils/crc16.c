@@ -1,11 +1,48 @@
 /**
  * @file crc16.c
  * @brief CRC-16 CCITT implementation
+ *
+ * Three interchangeable kernels compute the same CRC:
+ * - TABLE:  byte-at-a-time lookup (reference implementation)
+ * - SLICE8: 8 tables, 8 bytes per iteration
+ * - CLMUL:  carry-less multiply folding (x86 PCLMULQDQ / ARMv8 PMULL)
+ *
+ * The fastest kernel supported by the host CPU is selected on first use.
+ * Kernels never call the fault injection hook; Crc16_CalculateExtended()
+ * invokes FaultInj_HookCrc() once per call, regardless of kernel, while a
+ * CRC fault is armed.
  */
 
 #include "crc16.h"
 #include "fault_injection.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CRC16_HAVE_CLMUL_X86 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#define CRC16_HAVE_CLMUL_ARM 1
+#endif
+
+/**
+ * @brief Polynomial with the x^16 term, used for modular reduction
+ */
+#define CRC16_POLY_FULL 0x11021UL
+
+/**
+ * @brief Minimum length for the slice-by-8 kernel
+ */
+#define CRC16_SLICE8_MIN_LENGTH 16U
+
+/**
+ * @brief Minimum length for the carry-less multiply kernel
+ *
+ * Below this the fold setup and final reduction cost more than they save.
+ */
+#define CRC16_CLMUL_MIN_LENGTH 64U
+
 /**
  * @brief CRC-16 CCITT lookup table
  *
@@ -46,6 +83,313 @@ static const uint16_t crc16_table[256] = {
     0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
 };
 
+/**
+ * @brief Slice-by-8 tables
+ *
+ * crc16_slice_table[k][n] is the CRC of byte n followed by k zero bytes.
+ * Row 0 equals crc16_table. Filled once by crc16_engine_init().
+ */
+static uint16_t crc16_slice_table[8][256];
+
+/**
+ * @brief Carry-less multiply fold constants
+ *
+ * fold_k1 = x^192 mod P, fold_k2 = x^128 mod P (P = CRC16_POLY_FULL)
+ */
+static uint64_t crc16_fold_k1 = 0;
+static uint64_t crc16_fold_k2 = 0;
+
+/**
+ * @brief Kernel function type
+ */
+typedef uint16_t (*Crc16_KernelFunc_t)(const uint8_t *data, uint32_t length, uint16_t crc);
+
+/**
+ * @brief Kernel selected by the engine (TABLE until initialized)
+ */
+static Crc16_KernelFunc_t g_crc16_kernel = NULL;
+
+/**
+ * @brief Currently selected engine
+ */
+static Crc16_EngineType g_crc16_engine = CRC16_ENGINE_AUTO;
+
+/**
+ * @brief Table initialization state (0=none, 1=in progress, 2=done)
+ */
+static int g_crc16_init_state = 0;
+
+/**
+ * @brief Reference kernel: one table lookup per byte
+ */
+static uint16_t crc16_kernel_table(const uint8_t *data, uint32_t length, uint16_t crc)
+{
+    for (uint32_t i = 0; i < length; i++) {
+        uint8_t index = (uint8_t)((crc >> 8) ^ data[i]);
+        crc = (uint16_t)((crc << 8) ^ crc16_table[index]);
+    }
+
+    return crc;
+}
+
+/**
+ * @brief Slice-by-8 kernel: eight independent lookups per 8 bytes
+ *
+ * The CRC register is XORed into the first two bytes of each group
+ * (MSB-first CRC), then each byte is looked up in the table matching
+ * the number of bytes that follow it in the group.
+ */
+static uint16_t crc16_kernel_slice8(const uint8_t *data, uint32_t length, uint16_t crc)
+{
+    while (length >= 8U) {
+        uint8_t b0 = (uint8_t)(data[0] ^ (crc >> 8));
+        uint8_t b1 = (uint8_t)(data[1] ^ (crc & 0xFFU));
+
+        crc = (uint16_t)(crc16_slice_table[7][b0] ^
+                         crc16_slice_table[6][b1] ^
+                         crc16_slice_table[5][data[2]] ^
+                         crc16_slice_table[4][data[3]] ^
+                         crc16_slice_table[3][data[4]] ^
+                         crc16_slice_table[2][data[5]] ^
+                         crc16_slice_table[1][data[6]] ^
+                         crc16_slice_table[0][data[7]]);
+
+        data += 8;
+        length -= 8U;
+    }
+
+    return crc16_kernel_table(data, length, crc);
+}
+
+/**
+ * @brief Compute x^n mod P for the fold constants
+ */
+static uint64_t crc16_xpow_mod(uint32_t n)
+{
+    uint32_t r = 1U;
+
+    for (uint32_t i = 0; i < n; i++) {
+        r <<= 1;
+        if (r & 0x10000UL) {
+            r ^= CRC16_POLY_FULL;
+        }
+    }
+
+    return (uint64_t)r;
+}
+
+#if defined(CRC16_HAVE_CLMUL_X86)
+
+/**
+ * @brief PCLMULQDQ folding kernel
+ *
+ * The message is treated as one polynomial, byte 0 MSB first. A 128-bit
+ * accumulator A holds the running remainder candidate; for each further
+ * 16-byte chunk B: A' = A_hi * (x^192 mod P) ^ A_lo * (x^128 mod P) ^ B,
+ * which is congruent to A * x^128 + B modulo P. The final accumulator is
+ * reduced with the slice-by-8 kernel, then the tail bytes follow.
+ *
+ * Precondition: length >= 16, so the CRC register can be folded into the
+ * first two message bytes (direct table algorithm equivalence).
+ */
+__attribute__((target("pclmul,ssse3")))
+static uint16_t crc16_kernel_clmul(const uint8_t *data, uint32_t length, uint16_t crc)
+{
+    const __m128i bswap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                       8, 9, 10, 11, 12, 13, 14, 15);
+    const __m128i k = _mm_set_epi64x((long long)crc16_fold_k1, (long long)crc16_fold_k2);
+    uint8_t block[16];
+
+    /* First chunk with the CRC register folded into bytes 0 and 1 */
+    __m128i acc = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data), bswap);
+    acc = _mm_xor_si128(acc, _mm_slli_si128(_mm_cvtsi32_si128((int)crc), 14));
+    data += 16;
+    length -= 16U;
+
+    while (length >= 16U) {
+        __m128i next = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)data), bswap);
+        __m128i hi = _mm_clmulepi64_si128(acc, k, 0x11);
+        __m128i lo = _mm_clmulepi64_si128(acc, k, 0x00);
+        acc = _mm_xor_si128(_mm_xor_si128(hi, lo), next);
+        data += 16;
+        length -= 16U;
+    }
+
+    /* Reduce the accumulator (big-endian byte order) and finish the tail */
+    _mm_storeu_si128((__m128i *)block, _mm_shuffle_epi8(acc, bswap));
+    crc = crc16_kernel_slice8(block, 16U, 0U);
+
+    return crc16_kernel_slice8(data, length, crc);
+}
+
+/**
+ * @brief Check host support for the CLMUL kernel
+ */
+static boolean crc16_clmul_supported(void)
+{
+    __builtin_cpu_init();
+    return (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3")) ? TRUE : FALSE;
+}
+
+#elif defined(CRC16_HAVE_CLMUL_ARM)
+
+/**
+ * @brief Byte-reverse a 64-bit lane pair into MSB-first polynomial form
+ */
+__attribute__((target("+crypto")))
+static inline uint64x2_t crc16_load_be(const uint8_t *p)
+{
+    uint8x16_t v = vrev64q_u8(vld1q_u8(p));
+    uint64x2_t q = vreinterpretq_u64_u8(v);
+    /* lane 1 = bytes 0..7 (high half), lane 0 = bytes 8..15 (low half) */
+    return vcombine_u64(vget_high_u64(q), vget_low_u64(q));
+}
+
+/**
+ * @brief PMULL folding kernel (same folding scheme as the x86 kernel)
+ */
+__attribute__((target("+crypto")))
+static uint16_t crc16_kernel_clmul(const uint8_t *data, uint32_t length, uint16_t crc)
+{
+    uint8_t block[16];
+    uint64x2_t acc = crc16_load_be(data);
+    acc = vsetq_lane_u64(vgetq_lane_u64(acc, 1) ^ ((uint64_t)crc << 48), acc, 1);
+    data += 16;
+    length -= 16U;
+
+    while (length >= 16U) {
+        uint64x2_t next = crc16_load_be(data);
+        poly128_t hi = vmull_p64((poly64_t)vgetq_lane_u64(acc, 1), (poly64_t)crc16_fold_k1);
+        poly128_t lo = vmull_p64((poly64_t)vgetq_lane_u64(acc, 0), (poly64_t)crc16_fold_k2);
+        acc = veorq_u64(veorq_u64(vreinterpretq_u64_p128(hi), vreinterpretq_u64_p128(lo)), next);
+        data += 16;
+        length -= 16U;
+    }
+
+    /* Store back as big-endian bytes */
+    uint64x2_t swapped = vcombine_u64(vget_high_u64(acc), vget_low_u64(acc));
+    vst1q_u8(block, vrev64q_u8(vreinterpretq_u8_u64(swapped)));
+    crc = crc16_kernel_slice8(block, 16U, 0U);
+
+    return crc16_kernel_slice8(data, length, crc);
+}
+
+/**
+ * @brief Check host support for the CLMUL kernel
+ */
+static boolean crc16_clmul_supported(void)
+{
+    return (getauxval(AT_HWCAP) & HWCAP_PMULL) ? TRUE : FALSE;
+}
+
+#else
+
+static boolean crc16_clmul_supported(void)
+{
+    return FALSE;
+}
+
+#endif
+
+/**
+ * @brief Dispatch wrapper: short inputs bypass the wide kernels
+ */
+static uint16_t crc16_kernel_auto_slice8(const uint8_t *data, uint32_t length, uint16_t crc)
+{
+    if (length < CRC16_SLICE8_MIN_LENGTH) {
+        return crc16_kernel_table(data, length, crc);
+    }
+    return crc16_kernel_slice8(data, length, crc);
+}
+
+#if defined(CRC16_HAVE_CLMUL_X86) || defined(CRC16_HAVE_CLMUL_ARM)
+static uint16_t crc16_kernel_auto_clmul(const uint8_t *data, uint32_t length, uint16_t crc)
+{
+    if (length < CRC16_CLMUL_MIN_LENGTH) {
+        return crc16_kernel_auto_slice8(data, length, crc);
+    }
+    return crc16_kernel_clmul(data, length, crc);
+}
+#endif
+
+/**
+ * @brief Map an engine selection to its kernel
+ *
+ * @param engine In: requested engine; out: resolved engine (AUTO resolves
+ *               to the fastest kernel the host supports)
+ * @return Kernel function, or NULL if the engine is unavailable
+ */
+static Crc16_KernelFunc_t crc16_resolve_kernel(Crc16_EngineType *engine)
+{
+    switch (*engine) {
+        case CRC16_ENGINE_AUTO:
+#if defined(CRC16_HAVE_CLMUL_X86) || defined(CRC16_HAVE_CLMUL_ARM)
+            if (crc16_clmul_supported()) {
+                *engine = CRC16_ENGINE_CLMUL;
+                return crc16_kernel_auto_clmul;
+            }
+#endif
+            *engine = CRC16_ENGINE_SLICE8;
+            return crc16_kernel_auto_slice8;
+
+        case CRC16_ENGINE_TABLE:
+            return crc16_kernel_table;
+
+        case CRC16_ENGINE_SLICE8:
+            return crc16_kernel_auto_slice8;
+
+        case CRC16_ENGINE_CLMUL:
+#if defined(CRC16_HAVE_CLMUL_X86) || defined(CRC16_HAVE_CLMUL_ARM)
+            if (crc16_clmul_supported()) {
+                return crc16_kernel_auto_clmul;
+            }
+#endif
+            return NULL;
+
+        default:
+            return NULL;
+    }
+}
+
+/**
+ * @brief Build the slice tables and fold constants exactly once
+ */
+static void crc16_engine_init(void)
+{
+    int expected = 0;
+
+    if (__atomic_load_n(&g_crc16_init_state, __ATOMIC_ACQUIRE) == 2) {
+        return;
+    }
+
+    if (!__atomic_compare_exchange_n(&g_crc16_init_state, &expected, 1, FALSE,
+                                     __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        /* Another thread is building the tables */
+        while (__atomic_load_n(&g_crc16_init_state, __ATOMIC_ACQUIRE) != 2) {
+        }
+        return;
+    }
+
+    for (uint32_t n = 0; n < 256U; n++) {
+        crc16_slice_table[0][n] = crc16_table[n];
+    }
+    for (uint32_t t = 1; t < 8U; t++) {
+        for (uint32_t n = 0; n < 256U; n++) {
+            uint16_t prev = crc16_slice_table[t - 1U][n];
+            crc16_slice_table[t][n] = (uint16_t)((prev << 8) ^ crc16_table[prev >> 8]);
+        }
+    }
+
+    crc16_fold_k1 = crc16_xpow_mod(192U);
+    crc16_fold_k2 = crc16_xpow_mod(128U);
+
+    Crc16_EngineType engine = CRC16_ENGINE_AUTO;
+    Crc16_KernelFunc_t kernel = crc16_resolve_kernel(&engine);
+    g_crc16_engine = engine;
+    __atomic_store_n(&g_crc16_kernel, kernel, __ATOMIC_RELEASE);
+    __atomic_store_n(&g_crc16_init_state, 2, __ATOMIC_RELEASE);
+}
+
 uint16_t Crc16_Calculate(const uint8_t *data, uint32_t length)
 {
     return Crc16_CalculateExtended(data, length, 0xFFFF);
@@ -53,15 +397,43 @@ uint16_t Crc16_Calculate(const uint8_t *data, uint32_t length)
 
 uint16_t Crc16_CalculateExtended(const uint8_t *data, uint32_t length, uint16_t init_crc)
 {
-    uint16_t crc = init_crc;
-
-    for (uint32_t i = 0; i < length; i++) {
-        uint8_t index = (crc >> 8) ^ data[i];
-        crc = (crc << 8) ^ crc16_table[index];
+    Crc16_KernelFunc_t kernel = __atomic_load_n(&g_crc16_kernel, __ATOMIC_ACQUIRE);
+    if (kernel == NULL) {
+        crc16_engine_init();
+        kernel = __atomic_load_n(&g_crc16_kernel, __ATOMIC_ACQUIRE);
     }
 
+    uint16_t crc = kernel(data, length, init_crc);
+
     /* Fault injection hook: CRC corruption */
-    FaultInj_HookCrc(data, length, &crc);
+    if (FAULT_INJ_ARMED(FAULT_INJ_MASK_CRC)) {
+        FaultInj_HookCrc(data, length, &crc);
+    }
 
     return crc;
 }
+
+uint16_t Crc16_CalculateReference(const uint8_t *data, uint32_t length, uint16_t init_crc)
+{
+    return crc16_kernel_table(data, length, init_crc);
+}
+
+Std_ReturnType Crc16_SetEngine(Crc16_EngineType engine)
+{
+    crc16_engine_init();
+
+    Crc16_KernelFunc_t kernel = crc16_resolve_kernel(&engine);
+    if (kernel == NULL) {
+        return E_NOT_OK;
+    }
+
+    g_crc16_engine = engine;
+    __atomic_store_n(&g_crc16_kernel, kernel, __ATOMIC_RELEASE);
+    return E_OK;
+}
+
+Crc16_EngineType Crc16_GetEngine(void)
+{
+    crc16_engine_init();
+    return g_crc16_engine;
+}
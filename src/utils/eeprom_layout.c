@@ -5,6 +5,7 @@
 
 #include "nvm.h"
 #include "eeprom_layout.h"
+#include "crc.h"
 #include "logging.h"
 #include <string.h>
 
@@ -19,31 +20,45 @@ int EEPROM_CalcBlockLayout(const void *block, Eeprom_BlockLayout_t *layout)
         return -1;
     }
 
+    if (CRC_GetDescriptor(cfg->crc_type) == NULL) {
+        return -1;
+    }
+
     layout->data_offset = cfg->eeprom_offset;
     layout->data_size = cfg->block_size;
     layout->crc_offset = cfg->eeprom_offset + cfg->block_size;
 
-    /* CRC size based on CRC type */
-    switch (cfg->crc_type) {
-        case NVM_CRC_NONE:
-            layout->crc_size = 0;
-            break;
-        case NVM_CRC8:
-            layout->crc_size = 1;
-            break;
-        case NVM_CRC16:
-            layout->crc_size = 2;
-            break;
-        case NVM_CRC32:
-            layout->crc_size = 4;
-            break;
-        default:
-            layout->crc_size = 2;  /* Default CRC16 */
-            break;
+    /* CRC size based on CRC type (CRC8=1, CRC16=2, CRC32=4) */
+    layout->crc_size = CRC_GetSize(cfg->crc_type);
+
+    if (cfg->compression != NVM_COMPRESSION_NONE) {
+        /* Header, payload and CRC as one image; worst case is the raw payload */
+        layout->program_size = EEPROM_PAGE_ROUNDUP(EEPROM_COMPRESSED_HEADER_SIZE + cfg->block_size +
+                                                   layout->crc_size);
+        layout->program_ops = 1;
+    } else if (cfg->crc_placement == NVM_CRC_PLACEMENT_INLINE) {
+        /* Data and CRC as one image; the CRC shares the data's last page */
+        layout->program_size = EEPROM_PAGE_ROUNDUP(cfg->block_size + layout->crc_size);
+        layout->program_ops = 1;
+    } else if (cfg->crc_placement == NVM_CRC_PLACEMENT_PAGE) {
+        layout->program_size = cfg->block_size;
+        layout->program_ops = 1;
+        if (layout->crc_size > 0U) {
+            layout->program_size += EEPROM_LAYOUT_PAGE_SIZE;
+            layout->program_ops++;
+        }
+    } else {
+        return -1;
+    }
+
+    /* DATASET slots end with their sequence header page */
+    if (cfg->block_type == NVM_BLOCK_DATASET) {
+        layout->program_size += EEPROM_LAYOUT_PAGE_SIZE;
+        layout->program_ops++;
     }
 
     layout->reserved_start = layout->crc_offset + layout->crc_size;
-    layout->reserved_size = EEPROM_BLOCK_SLOT_SIZE - layout->reserved_size;
+    layout->reserved_size = (cfg->eeprom_offset + EEPROM_BLOCK_SLOT_SIZE) - layout->reserved_start;
     layout->slot_size = EEPROM_BLOCK_SLOT_SIZE;
 
     return 0;
@@ -60,6 +75,16 @@ boolean EEPROM_ValidateBlockConfig(const void *block)
         return FALSE;
     }
 
+    /* Log blocks live in the log region, not in a slot */
+    if (cfg->block_type == NVM_BLOCK_LOG) {
+        if (cfg->block_size == 0 || cfg->block_size > NVM_LOG_MAX_BLOCK_SIZE) {
+            LOG_ERROR("EEPROM: Log Block %d size %d exceeds %d",
+                     cfg->block_id, cfg->block_size, NVM_LOG_MAX_BLOCK_SIZE);
+            return FALSE;
+        }
+        return TRUE;
+    }
+
     /* Check slot alignment */
     if (!EEPROM_IS_SLOT_ALIGNED(cfg->eeprom_offset)) {
         LOG_ERROR("EEPROM: Block %d offset 0x%X not aligned to %d-byte boundary",
@@ -67,9 +92,16 @@ boolean EEPROM_ValidateBlockConfig(const void *block)
         return FALSE;
     }
 
+    /* Check CRC type is supported */
+    if (CRC_GetDescriptor(cfg->crc_type) == NULL) {
+        LOG_ERROR("EEPROM: Block %d has invalid CRC type %d",
+                 cfg->block_id, cfg->crc_type);
+        return FALSE;
+    }
+
     /* Calculate CRC offset */
     uint32_t crc_offset = EEPROM_CRC_OFFSET(cfg);
-    uint32_t crc_size = 2;  /* Assume CRC16 for validation */
+    uint32_t crc_size = CRC_GetSize(cfg->crc_type);
 
     /* Check CRC doesn't exceed slot boundary */
     if ((crc_offset + crc_size) > (cfg->eeprom_offset + EEPROM_BLOCK_SLOT_SIZE)) {
@@ -79,6 +111,31 @@ boolean EEPROM_ValidateBlockConfig(const void *block)
         return FALSE;
     }
 
+    /* Compressed copies ignore the placement; the raw fallback image must fit the slot */
+    if (cfg->compression != NVM_COMPRESSION_NONE) {
+        if (cfg->compression != NVM_COMPRESSION_RLE) {
+            LOG_ERROR("EEPROM: Block %d has invalid compression %d",
+                     cfg->block_id, cfg->compression);
+            return FALSE;
+        }
+        if (EEPROM_COMPRESSED_HEADER_SIZE + cfg->block_size + crc_size > EEPROM_BLOCK_SLOT_SIZE) {
+            LOG_ERROR("EEPROM: Block %d header + data(%d) + CRC(%d) exceeds slot boundary",
+                     cfg->block_id, cfg->block_size, crc_size);
+            return FALSE;
+        }
+    } else if (cfg->crc_placement == NVM_CRC_PLACEMENT_INLINE) {
+        if (crc_size > 0U &&
+            EEPROM_PAGE_ROUNDUP(cfg->block_size + crc_size) != EEPROM_PAGE_ROUNDUP(cfg->block_size)) {
+            LOG_ERROR("EEPROM: Block %d data(%d) fills its last page, no room for an inline CRC(%d)",
+                     cfg->block_id, cfg->block_size, crc_size);
+            return FALSE;
+        }
+    } else if (cfg->crc_placement != NVM_CRC_PLACEMENT_PAGE) {
+        LOG_ERROR("EEPROM: Block %d has invalid CRC placement %d",
+                 cfg->block_id, cfg->crc_placement);
+        return FALSE;
+    }
+
     /* Check for Native block */
     if (cfg->block_type == NVM_BLOCK_NATIVE) {
         /* Nothing else to validate */
@@ -106,12 +163,28 @@ boolean EEPROM_ValidateBlockConfig(const void *block)
 
     /* Check for Dataset block */
     if (cfg->block_type == NVM_BLOCK_DATASET) {
-        if (cfg->dataset_count == 0 || cfg->dataset_count > 4) {
+        if (cfg->dataset_count == 0 || cfg->dataset_count > EEPROM_MAX_DATASET_COUNT) {
             LOG_ERROR("EEPROM: Dataset Block %d invalid count=%d",
                      cfg->block_id, cfg->dataset_count);
             return FALSE;
         }
 
+        /* Data and CRC pages must leave the header page free */
+        uint32_t image_end;
+        if (cfg->compression != NVM_COMPRESSION_NONE) {
+            image_end = EEPROM_PAGE_ROUNDUP(EEPROM_COMPRESSED_HEADER_SIZE + cfg->block_size + crc_size);
+        } else if (cfg->crc_placement == NVM_CRC_PLACEMENT_INLINE) {
+            image_end = EEPROM_PAGE_ROUNDUP(cfg->block_size + crc_size);
+        } else {
+            image_end = EEPROM_PAGE_ROUNDUP(cfg->block_size) +
+                        ((crc_size > 0U) ? EEPROM_LAYOUT_PAGE_SIZE : 0U);
+        }
+        if (image_end > EEPROM_DATASET_HEADER_OFFSET) {
+            LOG_ERROR("EEPROM: Dataset Block %d data(%d) + CRC(%d) overlaps the slot header page",
+                     cfg->block_id, cfg->block_size, crc_size);
+            return FALSE;
+        }
+
         /* Calculate total space needed */
         uint32_t total_space = cfg->dataset_count * EEPROM_BLOCK_SLOT_SIZE;
         if (total_space > 4096) {  /* Max 4 slots for now */
@@ -131,5 +204,5 @@ boolean EEPROM_ValidateBlockConfig(const void *block)
  */
 uint32_t EEPROM_DatasetVersionOffset(uint32_t base_offset, uint8_t dataset_index)
 {
-    return base_offset + (dataset_index * EEPROM_BLOCK_SLOT_SIZE);
+    return base_offset + ((uint32_t)dataset_index << EEPROM_BLOCK_SLOT_SHIFT);
 }
@@ -1,17 +1,31 @@
 /**
  * @file logging.c
  * @brief Logging implementation
+ *
+ * Binary mode:
+ * - Each logging thread claims a single-producer ring (released at thread
+ *   exit; a later thread continues where it left off)
+ * - A record holds the format pointer, a timestamp and the arguments as
+ *   64-bit words; %s arguments are copied into the record
+ * - Log_Flush is the only consumer: it merges the rings by timestamp and
+ *   does the formatting, one conversion at a time
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "logging.h"
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
 #include <time.h>
+#include <pthread.h>
 
 /**
  * @brief Current log level
  */
-static LogLevel_t g_log_level = LOG_LEVEL_INFO;
+LogLevel_t Log_CurrentLevel = LOG_LEVEL_INFO;
 
 /**
  * @brief Log level names
@@ -25,19 +39,441 @@ static const char* log_level_names[] = {
     "FATAL"
 };
 
+#define LOG_RING_MASK   (LOG_BINARY_RING_SIZE - 1U)
+#define LOG_CACHE_LINE  64
+
+/**
+ * @brief Length modifier of a conversion
+ */
+typedef enum {
+    LOG_LEN_NONE = 0,
+    LOG_LEN_HH,
+    LOG_LEN_H,
+    LOG_LEN_L,
+    LOG_LEN_LL,
+    LOG_LEN_Z,
+    LOG_LEN_J,
+    LOG_LEN_T,
+    LOG_LEN_LD          /**< L (long double) */
+} LogLength_t;
+
+/**
+ * @brief One parsed conversion specification
+ */
+typedef struct {
+    const char *body;       /**< Flags, width and precision (after '%') */
+    const char *length_at;  /**< End of body, start of the length modifier */
+    const char *end;        /**< One past the conversion character */
+    LogLength_t length;
+    char conv;              /**< Conversion character ('\0' if unknown) */
+    int stars;              /**< '*' width/precision arguments */
+} LogSpec_t;
+
+/**
+ * @brief Binary record
+ */
+typedef struct {
+    uint64_t timestamp_ns;
+    const char *format;
+    uint8_t level;
+    uint8_t arg_count;
+    uint8_t truncated;      /**< Arguments past arg_count were not kept */
+    uint8_t string_used;
+    uint64_t args[LOG_BINARY_MAX_ARGS];
+    char strings[LOG_BINARY_STRING_BYTES];
+} LogRecord_t;
+
+/**
+ * @brief Single-producer single-consumer ring
+ *
+ * head and the producer counters are written only by the owning thread,
+ * tail only by Log_Flush.
+ */
+typedef struct {
+    uint32_t head __attribute__((aligned(LOG_CACHE_LINE)));
+    uint64_t recorded;
+    uint64_t dropped;
+    uint64_t truncated;
+    uint32_t tail __attribute__((aligned(LOG_CACHE_LINE)));
+    uint32_t in_use __attribute__((aligned(LOG_CACHE_LINE)));
+    LogRecord_t records[LOG_BINARY_RING_SIZE];
+} LogRing_t;
+
+static LogRing_t g_rings[LOG_BINARY_MAX_THREADS];
+static uint32_t g_ring_hwm;             /* Rings ever claimed (scan bound) */
+static uint64_t g_unringed_drops;       /* Records lost: no free ring */
+static uint64_t g_flushed;              /* Under g_flush_lock */
+static LogMode_t g_mode = LOG_MODE_TEXT;
+
+static pthread_mutex_t g_flush_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t g_ring_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_ring_key;
+static pthread_once_t g_atexit_once = PTHREAD_ONCE_INIT;
+
+/* Calling thread's ring */
+static __thread LogRing_t *t_ring;
+
+/**
+ * @brief Thread exit: give the ring back (pending records stay)
+ */
+static void ring_release(void *arg)
+{
+    __atomic_store_n(&((LogRing_t *)arg)->in_use, 0U, __ATOMIC_RELEASE);
+}
+
+static void ring_key_create(void)
+{
+    (void)pthread_key_create(&g_ring_key, ring_release);
+}
+
+/**
+ * @brief Ring of the calling thread, claimed on first use
+ *
+ * @return Ring, or NULL if all LOG_BINARY_MAX_THREADS rings are taken
+ */
+static LogRing_t *thread_ring(void)
+{
+    if (t_ring != NULL) {
+        return t_ring;
+    }
+
+    (void)pthread_once(&g_ring_key_once, ring_key_create);
+
+    for (uint32_t i = 0; i < LOG_BINARY_MAX_THREADS; i++) {
+        uint32_t expected = 0U;
+        if (!__atomic_compare_exchange_n(&g_rings[i].in_use, &expected, 1U, 0,
+                                         __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            continue;
+        }
+
+        uint32_t hwm = __atomic_load_n(&g_ring_hwm, __ATOMIC_RELAXED);
+        while (hwm < i + 1U &&
+               !__atomic_compare_exchange_n(&g_ring_hwm, &hwm, i + 1U, 1,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        }
+
+        t_ring = &g_rings[i];
+        (void)pthread_setspecific(g_ring_key, t_ring);
+        return t_ring;
+    }
+
+    return NULL;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Parse the conversion after a '%'
+ *
+ * @param p Character after the '%'
+ * @param spec Parsed specification
+ */
+static void parse_spec(const char *p, LogSpec_t *spec)
+{
+    spec->body = p;
+    spec->stars = 0;
+
+    while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0') {
+        p++;
+    }
+    if (*p == '*') {
+        spec->stars++;
+        p++;
+    }
+    while (*p >= '0' && *p <= '9') {
+        p++;
+    }
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            spec->stars++;
+            p++;
+        }
+        while (*p >= '0' && *p <= '9') {
+            p++;
+        }
+    }
+
+    spec->length_at = p;
+    spec->length = LOG_LEN_NONE;
+    if (p[0] == 'h') {
+        spec->length = (p[1] == 'h') ? LOG_LEN_HH : LOG_LEN_H;
+    } else if (p[0] == 'l') {
+        spec->length = (p[1] == 'l') ? LOG_LEN_LL : LOG_LEN_L;
+    } else if (p[0] == 'z') {
+        spec->length = LOG_LEN_Z;
+    } else if (p[0] == 'j') {
+        spec->length = LOG_LEN_J;
+    } else if (p[0] == 't') {
+        spec->length = LOG_LEN_T;
+    } else if (p[0] == 'L') {
+        spec->length = LOG_LEN_LD;
+    }
+    p += (spec->length == LOG_LEN_HH || spec->length == LOG_LEN_LL) ? 2 :
+         (spec->length != LOG_LEN_NONE) ? 1 : 0;
+
+    spec->conv = (*p != '\0' && strchr("diouxXcsfFeEgGaApn%", *p) != NULL) ? *p : '\0';
+    spec->end = (*p != '\0') ? p + 1 : p;
+}
+
+static int64_t arg_signed(va_list *args, LogLength_t length)
+{
+    switch (length) {
+    case LOG_LEN_L:  return va_arg(*args, long);
+    case LOG_LEN_LL: return va_arg(*args, long long);
+    case LOG_LEN_Z:  return (int64_t)va_arg(*args, size_t);
+    case LOG_LEN_J:  return va_arg(*args, intmax_t);
+    case LOG_LEN_T:  return va_arg(*args, ptrdiff_t);
+    default:         return va_arg(*args, int);
+    }
+}
+
+static uint64_t arg_unsigned(va_list *args, LogLength_t length)
+{
+    switch (length) {
+    case LOG_LEN_L:  return va_arg(*args, unsigned long);
+    case LOG_LEN_LL: return va_arg(*args, unsigned long long);
+    case LOG_LEN_Z:  return va_arg(*args, size_t);
+    case LOG_LEN_J:  return va_arg(*args, uintmax_t);
+    case LOG_LEN_T:  return (uint64_t)va_arg(*args, ptrdiff_t);
+    default:         return va_arg(*args, unsigned int);
+    }
+}
+
+/**
+ * @brief Copy the arguments of a message into a record
+ */
+static void capture_args(LogRecord_t *rec, const char *format, va_list *args)
+{
+    const char *p = format;
+
+    while ((p = strchr(p, '%')) != NULL) {
+        LogSpec_t spec;
+        parse_spec(p + 1, &spec);
+        p = spec.end;
+        if (spec.conv == '%') {
+            continue;
+        }
+        if (spec.conv == '\0' || rec->arg_count + spec.stars + 1 > (int)LOG_BINARY_MAX_ARGS) {
+            rec->truncated = 1U;
+            return;
+        }
+
+        for (int i = 0; i < spec.stars; i++) {
+            rec->args[rec->arg_count++] = (uint64_t)(int64_t)va_arg(*args, int);
+        }
+
+        uint64_t value = 0;
+        switch (spec.conv) {
+        case 'd':
+        case 'i':
+            value = (uint64_t)arg_signed(args, spec.length);
+            break;
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X':
+            value = arg_unsigned(args, spec.length);
+            break;
+        case 'c':
+            value = (uint64_t)(int64_t)va_arg(*args, int);
+            break;
+        case 's': {
+            const char *str = va_arg(*args, const char *);
+            size_t room = LOG_BINARY_STRING_BYTES - rec->string_used;
+            size_t len = strlen((str != NULL) ? str : "(null)");
+            if (room == 0U) {
+                rec->truncated = 1U;
+                return;
+            }
+            if (len >= room) {
+                len = room - 1U;
+                rec->truncated = 1U;
+            }
+            memcpy(&rec->strings[rec->string_used], (str != NULL) ? str : "(null)", len);
+            rec->strings[rec->string_used + len] = '\0';
+            value = rec->string_used;
+            rec->string_used = (uint8_t)(rec->string_used + len + 1U);
+            break;
+        }
+        case 'p':
+            value = (uint64_t)(uintptr_t)va_arg(*args, void *);
+            break;
+        case 'n':
+            (void)va_arg(*args, void *);
+            continue;
+        default: {
+            double d = (spec.length == LOG_LEN_LD) ? (double)va_arg(*args, long double)
+                                                   : va_arg(*args, double);
+            memcpy(&value, &d, sizeof(value));
+            break;
+        }
+        }
+        rec->args[rec->arg_count++] = value;
+    }
+}
+
+/**
+ * @brief Append a message to the calling thread's ring
+ */
+static void record_message(LogLevel_t level, const char *format, va_list *args)
+{
+    LogRing_t *ring = thread_ring();
+    if (ring == NULL) {
+        __atomic_fetch_add(&g_unringed_drops, 1U, __ATOMIC_RELAXED);
+        return;
+    }
+
+    uint32_t head = ring->head;
+    if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >= LOG_BINARY_RING_SIZE) {
+        __atomic_store_n(&ring->dropped, ring->dropped + 1U, __ATOMIC_RELAXED);
+        return;
+    }
+
+    LogRecord_t *rec = &ring->records[head & LOG_RING_MASK];
+    rec->timestamp_ns = now_ns();
+    rec->format = format;
+    rec->level = (uint8_t)level;
+    rec->arg_count = 0;
+    rec->truncated = 0;
+    rec->string_used = 0;
+    capture_args(rec, format, args);
+
+    if (rec->truncated != 0U) {
+        __atomic_store_n(&ring->truncated, ring->truncated + 1U, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&ring->recorded, ring->recorded + 1U, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring->head, head + 1U, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Format one record the way text mode would have printed it
+ */
+static void format_record(FILE *stream, const LogRecord_t *rec)
+{
+    char line[512];
+    char conv[48];
+    size_t used = 0;
+    uint32_t next = 0;
+    const char *p = rec->format;
+
+#define LINE_APPEND(...) \
+    do { \
+        int n_ = snprintf(&line[used], sizeof(line) - used, __VA_ARGS__); \
+        used += (n_ > 0) ? (size_t)n_ : 0U; \
+        used = (used < sizeof(line)) ? used : sizeof(line) - 1U; \
+    } while (0)
+
+    while (*p != '\0') {
+        const char *pct = strchr(p, '%');
+        size_t literal = (pct != NULL) ? (size_t)(pct - p) : strlen(p);
+        LINE_APPEND("%.*s", (int)literal, p);
+        if (pct == NULL) {
+            break;
+        }
+
+        LogSpec_t spec;
+        parse_spec(pct + 1, &spec);
+        p = spec.end;
+        if (spec.conv == '%') {
+            LINE_APPEND("%%");
+            continue;
+        }
+        if (spec.conv == 'n') {
+            continue;
+        }
+        if (spec.conv == '\0' || next + (uint32_t)spec.stars >= rec->arg_count) {
+            LINE_APPEND("<truncated>\n");
+            break;
+        }
+
+        /* Rebuild the spec with '*' resolved and a normalized length */
+        size_t c = 0;
+        conv[c++] = '%';
+        for (const char *b = spec.body; b < spec.length_at && c < sizeof(conv) - 16U; b++) {
+            if (*b == '*') {
+                c += (size_t)snprintf(&conv[c], sizeof(conv) - c, "%d",
+                                      (int)(int64_t)rec->args[next++]);
+            } else {
+                conv[c++] = *b;
+            }
+        }
+
+        uint64_t value = rec->args[next++];
+        if (strchr("diouxX", spec.conv) != NULL) {
+            conv[c++] = 'l';
+            conv[c++] = 'l';
+            conv[c++] = spec.conv;
+            conv[c] = '\0';
+            if (spec.conv == 'd' || spec.conv == 'i') {
+                LINE_APPEND(conv, (long long)(int64_t)value);
+            } else {
+                LINE_APPEND(conv, (unsigned long long)value);
+            }
+        } else if (spec.conv == 'c') {
+            conv[c++] = 'c';
+            conv[c] = '\0';
+            LINE_APPEND(conv, (int)(int64_t)value);
+        } else if (spec.conv == 's') {
+            conv[c++] = 's';
+            conv[c] = '\0';
+            LINE_APPEND(conv, &rec->strings[value]);
+        } else if (spec.conv == 'p') {
+            conv[c++] = 'p';
+            conv[c] = '\0';
+            LINE_APPEND(conv, (void *)(uintptr_t)value);
+        } else {
+            double d;
+            memcpy(&d, &value, sizeof(d));
+            conv[c++] = spec.conv;
+            conv[c] = '\0';
+            LINE_APPEND(conv, d);
+        }
+    }
+
+#undef LINE_APPEND
+
+    fprintf(stream, "[%s] %s", log_level_names[rec->level], line);
+}
+
+static void flush_at_exit(void)
+{
+    (void)Log_Flush(NULL);
+}
+
+static void register_atexit(void)
+{
+    (void)atexit(flush_at_exit);
+}
+
 void Log_SetLevel(LogLevel_t level)
 {
-    g_log_level = level;
+    __atomic_store_n(&Log_CurrentLevel, level, __ATOMIC_RELAXED);
 }
 
 LogLevel_t Log_GetLevel(void)
 {
-    return g_log_level;
+    return __atomic_load_n(&Log_CurrentLevel, __ATOMIC_RELAXED);
 }
 
 void Log_Message(LogLevel_t level, const char *format, ...)
 {
-    if (level < g_log_level) {
+    if (level < Log_GetLevel()) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+
+    if (__atomic_load_n(&g_mode, __ATOMIC_RELAXED) == LOG_MODE_BINARY) {
+        record_message(level, format, &args);
+        va_end(args);
         return;
     }
 
@@ -45,11 +481,88 @@ void Log_Message(LogLevel_t level, const char *format, ...)
     fprintf(stderr, "[%s] ", log_level_names[level]);
 
     /* Print the actual message */
-    va_list args;
-    va_start(args, format);
     vfprintf(stderr, format, args);
     va_end(args);
 
     /* Flush to ensure output is written immediately */
     fflush(stderr);
 }
+
+void Log_SetMode(LogMode_t mode)
+{
+    if (mode == LOG_MODE_BINARY) {
+        (void)pthread_once(&g_atexit_once, register_atexit);
+    }
+    __atomic_store_n(&g_mode, mode, __ATOMIC_RELAXED);
+    if (mode == LOG_MODE_TEXT) {
+        (void)Log_Flush(NULL);
+    }
+}
+
+LogMode_t Log_GetMode(void)
+{
+    return __atomic_load_n(&g_mode, __ATOMIC_RELAXED);
+}
+
+uint32_t Log_Flush(FILE *stream)
+{
+    uint32_t written = 0;
+
+    if (stream == NULL) {
+        stream = stderr;
+    }
+
+    pthread_mutex_lock(&g_flush_lock);
+    uint32_t rings = __atomic_load_n(&g_ring_hwm, __ATOMIC_ACQUIRE);
+
+    for (;;) {
+        /* Oldest pending record across the rings */
+        LogRing_t *oldest = NULL;
+        const LogRecord_t *rec = NULL;
+        for (uint32_t i = 0; i < rings; i++) {
+            LogRing_t *ring = &g_rings[i];
+            uint32_t tail = ring->tail;
+            if (tail == __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) {
+                continue;
+            }
+            const LogRecord_t *candidate = &ring->records[tail & LOG_RING_MASK];
+            if (rec == NULL || candidate->timestamp_ns < rec->timestamp_ns) {
+                oldest = ring;
+                rec = candidate;
+            }
+        }
+        if (oldest == NULL) {
+            break;
+        }
+
+        format_record(stream, rec);
+        __atomic_store_n(&oldest->tail, oldest->tail + 1U, __ATOMIC_RELEASE);
+        written++;
+    }
+
+    g_flushed += written;
+    pthread_mutex_unlock(&g_flush_lock);
+    fflush(stream);
+
+    return written;
+}
+
+void Log_GetBinaryStats(LogBinaryStats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    uint32_t rings = __atomic_load_n(&g_ring_hwm, __ATOMIC_ACQUIRE);
+    for (uint32_t i = 0; i < rings; i++) {
+        stats->recorded += __atomic_load_n(&g_rings[i].recorded, __ATOMIC_RELAXED);
+        stats->dropped += __atomic_load_n(&g_rings[i].dropped, __ATOMIC_RELAXED);
+        stats->truncated += __atomic_load_n(&g_rings[i].truncated, __ATOMIC_RELAXED);
+    }
+    stats->dropped += __atomic_load_n(&g_unringed_drops, __ATOMIC_RELAXED);
+
+    pthread_mutex_lock(&g_flush_lock);
+    stats->flushed = g_flushed;
+    pthread_mutex_unlock(&g_flush_lock);
+}
@@ -0,0 +1,442 @@
+/**
+ * @file metrics.c
+ * @brief Unified latency metrics implementation
+ *
+ * - A thread is assigned a shard on its first sample (round-robin); shards
+ *   may still be shared when threads outnumber them, so updates are
+ *   relaxed atomics
+ * - Shard minima are kept inverted so a zeroed shard reads as empty
+ * - Block series are allocated on first use and published with a CAS
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "metrics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+
+/* Shards per series (threads are spread round-robin) */
+#define METRICS_SHARDS 4U
+
+#define METRICS_CACHE_LINE 64
+
+/* Block IDs (0xFF is the ReadAll/WriteAll pseudo block) */
+#define METRICS_BLOCK_IDS 256U
+
+/**
+ * @brief Shard histogram
+ */
+typedef struct {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min_inv;           /**< ~min, so 0 means empty */
+    uint64_t max;
+    uint32_t buckets[METRICS_BUCKETS];
+} MetricsShardHist_t;
+
+/**
+ * @brief One shard of a series: both clocks
+ */
+typedef struct {
+    MetricsShardHist_t hist[METRIC_CLOCK_COUNT];
+} __attribute__((aligned(METRICS_CACHE_LINE))) MetricsShard_t;
+
+typedef struct {
+    MetricsShard_t shards[METRICS_SHARDS];
+} MetricsSeries_t;
+
+typedef struct {
+    const char *name;
+    Metrics_CounterSource_t source;
+} MetricsSource_t;
+
+uint32_t Metrics_EnabledFlag = 0U;
+
+static MetricsSeries_t g_series[METRIC_SERIES_COUNT];
+static MetricsSeries_t *g_blocks[METRICS_BLOCK_IDS][METRIC_BLOCK_OP_COUNT];
+static MetricsSource_t g_sources[METRICS_MAX_SOURCES];
+static uint32_t g_next_shard;
+
+/* Shard of the calling thread (METRICS_SHARDS = not assigned yet) */
+static __thread uint32_t t_shard = METRICS_SHARDS;
+
+static const char *const g_series_names[METRIC_SERIES_COUNT] = {
+    "eep_read", "eep_write", "eep_erase", "eep_verify",
+    "memif_read", "memif_write", "memif_erase",
+    "nvm_read", "nvm_write", "nvm_read_all", "nvm_write_all", "nvm_write_batch",
+    "nvm_immediate"
+};
+
+static const char *const g_block_op_names[METRIC_BLOCK_OP_COUNT] = { "read", "write" };
+
+static const char *const g_clock_names[METRIC_CLOCK_COUNT] = { "host_ns", "virtual_us" };
+
+/**
+ * @brief Bucket of a value
+ */
+static uint32_t bucket_index(uint64_t value)
+{
+    if (value < METRICS_SUB_BUCKETS) {
+        return (uint32_t)value;
+    }
+
+    uint32_t msb = 63U - (uint32_t)__builtin_clzll(value);
+    uint32_t shift = msb - METRICS_SUB_BUCKET_BITS;
+    if (shift >= METRICS_RANGES) {
+        return METRICS_BUCKETS - 1U;
+    }
+    return (shift + 1U) * METRICS_SUB_BUCKETS +
+           (uint32_t)((value >> shift) & (METRICS_SUB_BUCKETS - 1U));
+}
+
+/**
+ * @brief Largest value that falls into a bucket
+ */
+static uint64_t bucket_upper(uint32_t index)
+{
+    if (index < METRICS_SUB_BUCKETS) {
+        return index;
+    }
+
+    uint32_t shift = index / METRICS_SUB_BUCKETS - 1U;
+    uint64_t lower = (uint64_t)(METRICS_SUB_BUCKETS + index % METRICS_SUB_BUCKETS) << shift;
+    return lower + ((1ULL << shift) - 1U);
+}
+
+static MetricsShard_t *thread_shard(MetricsSeries_t *series)
+{
+    if (t_shard >= METRICS_SHARDS) {
+        t_shard = __atomic_fetch_add(&g_next_shard, 1U, __ATOMIC_RELAXED) % METRICS_SHARDS;
+    }
+    return &series->shards[t_shard];
+}
+
+static void hist_add(MetricsShardHist_t *hist, uint64_t value)
+{
+    __atomic_fetch_add(&hist->count, 1U, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&hist->sum, value, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&hist->buckets[bucket_index(value)], 1U, __ATOMIC_RELAXED);
+
+    uint64_t inv = ~value;
+    uint64_t cur = __atomic_load_n(&hist->min_inv, __ATOMIC_RELAXED);
+    while (inv > cur &&
+           !__atomic_compare_exchange_n(&hist->min_inv, &cur, inv, TRUE,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+    cur = __atomic_load_n(&hist->max, __ATOMIC_RELAXED);
+    while (value > cur &&
+           !__atomic_compare_exchange_n(&hist->max, &cur, value, TRUE,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+static void series_add(MetricsSeries_t *series, uint64_t host_ns, uint64_t virtual_us)
+{
+    MetricsShard_t *shard = thread_shard(series);
+
+    hist_add(&shard->hist[METRIC_CLOCK_HOST_NS], host_ns);
+    hist_add(&shard->hist[METRIC_CLOCK_VIRTUAL_US], virtual_us);
+}
+
+/**
+ * @brief Merge a series' shards into a snapshot
+ */
+static void series_snapshot(const MetricsSeries_t *series, Metrics_Snapshot_t *snapshot)
+{
+    memset(snapshot, 0, sizeof(*snapshot));
+
+    for (uint32_t c = 0; c < METRIC_CLOCK_COUNT; c++) {
+        Metrics_Histogram_t *hist = &snapshot->hist[c];
+        uint64_t min_inv = 0;
+
+        for (uint32_t s = 0; s < METRICS_SHARDS; s++) {
+            const MetricsShardHist_t *src = &series->shards[s].hist[c];
+            hist->count += __atomic_load_n(&src->count, __ATOMIC_RELAXED);
+            hist->sum += __atomic_load_n(&src->sum, __ATOMIC_RELAXED);
+            uint64_t inv = __atomic_load_n(&src->min_inv, __ATOMIC_RELAXED);
+            min_inv = (inv > min_inv) ? inv : min_inv;
+            uint64_t max = __atomic_load_n(&src->max, __ATOMIC_RELAXED);
+            hist->max = (max > hist->max) ? max : hist->max;
+            for (uint32_t b = 0; b < METRICS_BUCKETS; b++) {
+                hist->buckets[b] += __atomic_load_n(&src->buckets[b], __ATOMIC_RELAXED);
+            }
+        }
+        hist->min = ~min_inv;
+
+        Metrics_Summary_t *summary = &snapshot->summary[c];
+        summary->count = hist->count;
+        summary->sum = hist->sum;
+        summary->min = (hist->count > 0U) ? hist->min : 0U;
+        summary->max = hist->max;
+        summary->p50 = Metrics_Percentile(hist, 500000U);
+        summary->p90 = Metrics_Percentile(hist, 900000U);
+        summary->p99 = Metrics_Percentile(hist, 990000U);
+        summary->p999 = Metrics_Percentile(hist, 999000U);
+    }
+}
+
+void Metrics_Enable(boolean enable)
+{
+    __atomic_store_n(&Metrics_EnabledFlag, enable ? 1U : 0U, __ATOMIC_RELAXED);
+}
+
+uint64_t Metrics_HostNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void Metrics_Record(Metrics_SeriesId_t series, uint64_t host_ns, uint64_t virtual_us)
+{
+    if ((uint32_t)series >= METRIC_SERIES_COUNT) {
+        return;
+    }
+    series_add(&g_series[series], host_ns, virtual_us);
+}
+
+void Metrics_RecordBlock(uint8_t block_id, Metrics_BlockOp_t op, uint64_t host_ns,
+                         uint64_t virtual_us)
+{
+    if ((uint32_t)op >= METRIC_BLOCK_OP_COUNT) {
+        return;
+    }
+
+    MetricsSeries_t **slot = &g_blocks[block_id][op];
+    MetricsSeries_t *series = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+    if (series == NULL) {
+        void *mem = NULL;
+        if (posix_memalign(&mem, METRICS_CACHE_LINE, sizeof(MetricsSeries_t)) != 0) {
+            return;
+        }
+        MetricsSeries_t *fresh = (MetricsSeries_t *)mem;
+        memset(fresh, 0, sizeof(MetricsSeries_t));
+        if (__atomic_compare_exchange_n(slot, &series, fresh, FALSE,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            series = fresh;
+        } else {
+            free(fresh);    /* Another thread published first */
+        }
+    }
+    series_add(series, host_ns, virtual_us);
+}
+
+Std_ReturnType Metrics_GetSnapshot(Metrics_SeriesId_t series, Metrics_Snapshot_t *snapshot)
+{
+    if ((uint32_t)series >= METRIC_SERIES_COUNT || snapshot == NULL) {
+        return E_NOT_OK;
+    }
+
+    series_snapshot(&g_series[series], snapshot);
+    return E_OK;
+}
+
+Std_ReturnType Metrics_GetBlockSnapshot(uint8_t block_id, Metrics_BlockOp_t op,
+                                        Metrics_Snapshot_t *snapshot)
+{
+    if ((uint32_t)op >= METRIC_BLOCK_OP_COUNT || snapshot == NULL) {
+        return E_NOT_OK;
+    }
+
+    const MetricsSeries_t *series = __atomic_load_n(&g_blocks[block_id][op], __ATOMIC_ACQUIRE);
+    if (series == NULL) {
+        return E_NOT_OK;
+    }
+
+    series_snapshot(series, snapshot);
+    return (snapshot->hist[METRIC_CLOCK_HOST_NS].count > 0U) ? E_OK : E_NOT_OK;
+}
+
+uint64_t Metrics_Percentile(const Metrics_Histogram_t *hist, uint32_t per_million)
+{
+    if (hist == NULL || hist->count == 0U) {
+        return 0;
+    }
+
+    /* Rank of the sample at the quantile (1-based, rounded up) */
+    uint64_t rank = (hist->count * per_million + 999999U) / 1000000U;
+    rank = (rank == 0U) ? 1U : rank;
+
+    uint64_t seen = 0;
+    for (uint32_t b = 0; b < METRICS_BUCKETS; b++) {
+        seen += hist->buckets[b];
+        if (seen >= rank) {
+            uint64_t upper = bucket_upper(b);
+            return (upper < hist->max) ? upper : hist->max;
+        }
+    }
+    return hist->max;
+}
+
+void Metrics_Reset(void)
+{
+    memset(g_series, 0, sizeof(g_series));
+
+    /* Block series stay allocated: a recording thread may hold one */
+    for (uint32_t b = 0; b < METRICS_BLOCK_IDS; b++) {
+        for (uint32_t op = 0; op < METRIC_BLOCK_OP_COUNT; op++) {
+            MetricsSeries_t *series = __atomic_load_n(&g_blocks[b][op], __ATOMIC_ACQUIRE);
+            if (series != NULL) {
+                memset(series, 0, sizeof(*series));
+            }
+        }
+    }
+}
+
+Std_ReturnType Metrics_RegisterCounterSource(const char *name, Metrics_CounterSource_t source)
+{
+    if (name == NULL || source == NULL) {
+        return E_NOT_OK;
+    }
+
+    for (uint32_t i = 0; i < METRICS_MAX_SOURCES; i++) {
+        if (g_sources[i].name == NULL || strcmp(g_sources[i].name, name) == 0) {
+            g_sources[i].name = name;
+            g_sources[i].source = source;
+            return E_OK;
+        }
+    }
+    return E_NOT_OK;
+}
+
+/**
+ * @brief snprintf-style output cursor
+ */
+typedef struct {
+    char *buffer;
+    size_t size;
+    size_t length;              /**< Length of the full output so far */
+} MetricsWriter_t;
+
+static void emit(MetricsWriter_t *w, const char *format, ...)
+{
+    va_list args;
+    size_t room = (w->length < w->size) ? w->size - w->length : 0U;
+
+    va_start(args, format);
+    int n = vsnprintf((room > 0U) ? &w->buffer[w->length] : NULL, room, format, args);
+    va_end(args);
+
+    if (n > 0) {
+        w->length += (size_t)n;
+    }
+}
+
+static void emit_json_summary(MetricsWriter_t *w, const Metrics_Snapshot_t *snap)
+{
+    for (uint32_t c = 0; c < METRIC_CLOCK_COUNT; c++) {
+        const Metrics_Summary_t *s = &snap->summary[c];
+        emit(w, "%s\"%s\":{\"count\":%llu,\"sum\":%llu,\"min\":%llu,\"max\":%llu,"
+             "\"p50\":%llu,\"p90\":%llu,\"p99\":%llu,\"p999\":%llu}",
+             (c > 0U) ? "," : "", g_clock_names[c],
+             (unsigned long long)s->count, (unsigned long long)s->sum,
+             (unsigned long long)s->min, (unsigned long long)s->max,
+             (unsigned long long)s->p50, (unsigned long long)s->p90,
+             (unsigned long long)s->p99, (unsigned long long)s->p999);
+    }
+}
+
+static void emit_prometheus_summary(MetricsWriter_t *w, const char *metric, const char *labels,
+                                    const Metrics_Snapshot_t *snap)
+{
+    static const char *const quantiles[] = { "0.5", "0.9", "0.99", "0.999" };
+
+    for (uint32_t c = 0; c < METRIC_CLOCK_COUNT; c++) {
+        const Metrics_Summary_t *s = &snap->summary[c];
+        const uint64_t values[] = { s->p50, s->p90, s->p99, s->p999 };
+
+        for (uint32_t q = 0; q < 4U; q++) {
+            emit(w, "eepromsim_%s_%s{%s,quantile=\"%s\"} %llu\n", metric, g_clock_names[c],
+                 labels, quantiles[q], (unsigned long long)values[q]);
+        }
+        emit(w, "eepromsim_%s_%s_sum{%s} %llu\n", metric, g_clock_names[c], labels,
+             (unsigned long long)s->sum);
+        emit(w, "eepromsim_%s_%s_count{%s} %llu\n", metric, g_clock_names[c], labels,
+             (unsigned long long)s->count);
+    }
+}
+
+size_t Metrics_Export(Metrics_Format_t format, char *buffer, size_t size)
+{
+    MetricsWriter_t w = { .buffer = buffer, .size = (buffer != NULL) ? size : 0U, .length = 0 };
+    Metrics_Snapshot_t snap;
+    Metrics_Counter_t counters[METRICS_MAX_COUNTERS];
+    char labels[48];
+    boolean json = (format == METRICS_FORMAT_JSON);
+
+    if (json) {
+        emit(&w, "{\"series\":{");
+    } else {
+        for (uint32_t c = 0; c < METRIC_CLOCK_COUNT; c++) {
+            emit(&w, "# TYPE eepromsim_latency_%s summary\n", g_clock_names[c]);
+            emit(&w, "# TYPE eepromsim_block_latency_%s summary\n", g_clock_names[c]);
+        }
+    }
+
+    for (uint32_t i = 0; i < METRIC_SERIES_COUNT; i++) {
+        series_snapshot(&g_series[i], &snap);
+        if (json) {
+            emit(&w, "%s\"%s\":{", (i > 0U) ? "," : "", g_series_names[i]);
+            emit_json_summary(&w, &snap);
+            emit(&w, "}");
+        } else {
+            snprintf(labels, sizeof(labels), "series=\"%s\"", g_series_names[i]);
+            emit_prometheus_summary(&w, "latency", labels, &snap);
+        }
+    }
+
+    boolean first = TRUE;
+    if (json) {
+        emit(&w, "},\"blocks\":{");
+    }
+    for (uint32_t b = 0; b < METRICS_BLOCK_IDS; b++) {
+        for (uint32_t op = 0; op < METRIC_BLOCK_OP_COUNT; op++) {
+            if (Metrics_GetBlockSnapshot((uint8_t)b, (Metrics_BlockOp_t)op, &snap) != E_OK) {
+                continue;
+            }
+            if (json) {
+                emit(&w, "%s\"%u.%s\":{", first ? "" : ",", b, g_block_op_names[op]);
+                emit_json_summary(&w, &snap);
+                emit(&w, "}");
+            } else {
+                snprintf(labels, sizeof(labels), "block=\"%u\",op=\"%s\"", b, g_block_op_names[op]);
+                emit_prometheus_summary(&w, "block_latency", labels, &snap);
+            }
+            first = FALSE;
+        }
+    }
+
+    if (json) {
+        emit(&w, "},\"counters\":{");
+    }
+    first = TRUE;
+    for (uint32_t i = 0; i < METRICS_MAX_SOURCES && g_sources[i].name != NULL; i++) {
+        uint32_t n = g_sources[i].source(counters, METRICS_MAX_COUNTERS);
+        n = (n < METRICS_MAX_COUNTERS) ? n : METRICS_MAX_COUNTERS;
+        if (json) {
+            emit(&w, "%s\"%s\":{", first ? "" : ",", g_sources[i].name);
+        }
+        for (uint32_t c = 0; c < n; c++) {
+            if (json) {
+                emit(&w, "%s\"%s\":%llu", (c > 0U) ? "," : "", counters[c].name,
+                     (unsigned long long)counters[c].value);
+            } else {
+                emit(&w, "eepromsim_%s_%s %llu\n", g_sources[i].name, counters[c].name,
+                     (unsigned long long)counters[c].value);
+            }
+        }
+        if (json) {
+            emit(&w, "}");
+        }
+        first = FALSE;
+    }
+    if (json) {
+        emit(&w, "}}\n");
+    }
+
+    return w.length;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file rle.c
+ * @brief Run-length codec for NvM block payloads
+ *
+ * - 编码: 三个及以上相同字节成为重复段, 其余字节合并为字面段
+ * - 解码: 直接写入调用者缓冲, 每段先检查边界
+ */
+
+#include "rle.h"
+#include <string.h>
+
+#define RLE_LITERAL_MAX 128U
+#define RLE_RUN_MIN     3U
+#define RLE_RUN_MAX     130U
+#define RLE_RUN_FLAG    0x80U
+
+/**
+ * @brief Length of the run of src[i] starting at i (capped at RLE_RUN_MAX)
+ */
+static uint32_t run_length(const uint8_t *src, uint32_t i, uint32_t length)
+{
+    uint32_t n = 1;
+
+    while (i + n < length && n < RLE_RUN_MAX && src[i + n] == src[i]) {
+        n++;
+    }
+    return n;
+}
+
+uint32_t RLE_Encode(const uint8_t *src, uint32_t length, uint8_t *dst, uint32_t capacity)
+{
+    uint32_t i = 0;
+    uint32_t out = 0;
+
+    while (i < length) {
+        uint32_t run = run_length(src, i, length);
+
+        if (run >= RLE_RUN_MIN) {
+            if (out + 2U > capacity) {
+                return 0;
+            }
+            dst[out++] = (uint8_t)(RLE_RUN_FLAG + (run - RLE_RUN_MIN));
+            dst[out++] = src[i];
+            i += run;
+            continue;
+        }
+
+        /* Literals up to the next run worth encoding */
+        uint32_t start = i;
+        while (i < length && (i - start) < RLE_LITERAL_MAX &&
+               run_length(src, i, length) < RLE_RUN_MIN) {
+            i++;
+        }
+
+        uint32_t n = i - start;
+        if (out + 1U + n > capacity) {
+            return 0;
+        }
+        dst[out++] = (uint8_t)(n - 1U);
+        memcpy(&dst[out], &src[start], n);
+        out += n;
+    }
+
+    return out;
+}
+
+Std_ReturnType RLE_Decode(const uint8_t *src, uint32_t length, uint8_t *dst, uint32_t expected)
+{
+    uint32_t i = 0;
+    uint32_t out = 0;
+
+    while (i < length) {
+        uint8_t control = src[i++];
+
+        if (control >= RLE_RUN_FLAG) {
+            uint32_t run = (uint32_t)(control - RLE_RUN_FLAG) + RLE_RUN_MIN;
+            if (i >= length || run > expected - out) {
+                return E_NOT_OK;
+            }
+            memset(&dst[out], src[i++], run);
+            out += run;
+        } else {
+            uint32_t n = (uint32_t)control + 1U;
+            if (n > length - i || n > expected - out) {
+                return E_NOT_OK;
+            }
+            memcpy(&dst[out], &src[i], n);
+            i += n;
+            out += n;
+        }
+    }
+
+    return (out == expected) ? E_OK : E_NOT_OK;
+}
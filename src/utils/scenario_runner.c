@@ -0,0 +1,388 @@
+/**
+ * @file scenario_runner.c
+ * @brief Work-stealing scenario runner over forked processes or threads
+ *
+ * REQ-故障库: design/07-系统测试与故障场景.md §2
+ * - 共享内存: 每工作者一个 [begin, end) 区间字 (64位, CAS更新), 场景状态表
+ * - 取任务: 区间头部 begin+1; 窃取: 剩余最多的区间尾部一半
+ * - 工作进程异常退出: 正在运行的场景记为CRASHED, 同一槽位补起新进程
+ * - 线程模式: 同一套区间与窃取, 工作线程由启动钩子绑定各自的模块上下文
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "scenario_runner.h"
+#include "logging.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+/**
+ * @brief No scenario in progress
+ */
+#define SCENARIO_NONE 0xFFFFFFFFU
+
+/**
+ * @brief Per-worker shared state (one cache line each)
+ */
+typedef struct {
+    uint64_t range;                 /**< end << 32 | begin */
+    uint32_t current;               /**< Scenario being run, or SCENARIO_NONE */
+    uint32_t executed;
+    uint32_t steals;
+} __attribute__((aligned(64))) ScenarioWorker_t;
+
+/**
+ * @brief Shared campaign state (mapped before fork, shared as is by threads)
+ */
+typedef struct {
+    ScenarioWorker_t workers[SCENARIO_RUNNER_MAX_WORKERS];
+    uint8_t worker_count;
+    uint8_t status[];               /**< ScenarioRunner_Status_t per scenario */
+} ScenarioShared_t;
+
+static uint64_t pack_range(uint32_t begin, uint32_t end)
+{
+    return ((uint64_t)end << 32) | begin;
+}
+
+static uint32_t range_begin(uint64_t range)
+{
+    return (uint32_t)range;
+}
+
+static uint32_t range_end(uint64_t range)
+{
+    return (uint32_t)(range >> 32);
+}
+
+/**
+ * @brief Take the next scenario from the front of a worker's own range
+ */
+static boolean take_own(ScenarioWorker_t *self, uint32_t *index)
+{
+    uint64_t range = __atomic_load_n(&self->range, __ATOMIC_ACQUIRE);
+
+    for (;;) {
+        uint32_t begin = range_begin(range);
+        uint32_t end = range_end(range);
+        if (begin >= end) {
+            return FALSE;
+        }
+        if (__atomic_compare_exchange_n(&self->range, &range, pack_range(begin + 1U, end), FALSE,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            *index = begin;
+            return TRUE;
+        }
+    }
+}
+
+/**
+ * @brief Steal the back half of the largest remaining range into our own
+ *
+ * Only called with an empty own range, so no other thief targets it until
+ * the stolen work is published.
+ *
+ * @return FALSE if no range has work left
+ */
+static boolean steal(ScenarioShared_t *shared, uint8_t self_id)
+{
+    for (;;) {
+        uint8_t victim = SCENARIO_RUNNER_MAX_WORKERS;
+        uint32_t most = 0;
+        uint64_t range = 0;
+
+        for (uint8_t w = 0; w < shared->worker_count; w++) {
+            if (w == self_id) {
+                continue;
+            }
+            uint64_t r = __atomic_load_n(&shared->workers[w].range, __ATOMIC_ACQUIRE);
+            uint32_t left = range_end(r) - range_begin(r);
+            if (range_begin(r) < range_end(r) && left > most) {
+                most = left;
+                victim = w;
+                range = r;
+            }
+        }
+        if (victim == SCENARIO_RUNNER_MAX_WORKERS) {
+            return FALSE;
+        }
+
+        uint32_t begin = range_begin(range);
+        uint32_t end = range_end(range);
+        uint32_t split = end - (most + 1U) / 2U;
+        if (__atomic_compare_exchange_n(&shared->workers[victim].range, &range,
+                                        pack_range(begin, split), FALSE,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            __atomic_store_n(&shared->workers[self_id].range, pack_range(split, end),
+                             __ATOMIC_RELEASE);
+            shared->workers[self_id].steals++;
+            return TRUE;
+        }
+        /* Victim moved on: pick again */
+    }
+}
+
+static void worker_main(ScenarioShared_t *shared, uint8_t self_id,
+                        const ScenarioRunner_Config_t *config)
+{
+    ScenarioWorker_t *self = &shared->workers[self_id];
+    void *worker_ctx = NULL;
+    uint32_t index;
+
+    if (config->worker_init != NULL) {
+        worker_ctx = config->worker_init(self_id, config->user_ctx);
+    }
+
+    for (;;) {
+        if (!take_own(self, &index)) {
+            if (!steal(shared, self_id)) {
+                break;
+            }
+            continue;
+        }
+
+        __atomic_store_n(&self->current, index, __ATOMIC_RELEASE);
+        __atomic_store_n(&shared->status[index], (uint8_t)SCENARIO_RUNNING, __ATOMIC_RELEASE);
+
+        boolean passed = config->func(index, config->user_ctx);
+
+        __atomic_store_n(&shared->status[index],
+                         (uint8_t)(passed ? SCENARIO_PASSED : SCENARIO_FAILED), __ATOMIC_RELEASE);
+        self->executed++;
+        __atomic_store_n(&self->current, SCENARIO_NONE, __ATOMIC_RELEASE);
+    }
+
+    if (config->worker_fini != NULL) {
+        config->worker_fini(worker_ctx, config->user_ctx);
+    }
+}
+
+/**
+ * @brief Fork one worker for a slot
+ *
+ * @return Child pid, or -1
+ */
+static pid_t spawn_worker(ScenarioShared_t *shared, uint8_t self_id,
+                          const ScenarioRunner_Config_t *config)
+{
+    /* Buffered output would otherwise be printed again by the child */
+    fflush(NULL);
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        worker_main(shared, self_id, config);
+        fflush(NULL);
+        _exit(0);
+    }
+    return pid;
+}
+
+/**
+ * @brief Worker thread arguments (thread mode)
+ */
+typedef struct {
+    ScenarioShared_t *shared;
+    uint8_t self_id;
+    const ScenarioRunner_Config_t *config;
+} ScenarioThread_t;
+
+static void* worker_thread(void *arg)
+{
+    const ScenarioThread_t *t = (const ScenarioThread_t *)arg;
+
+    worker_main(t->shared, t->self_id, t->config);
+    return NULL;
+}
+
+/**
+ * @brief Run every worker on its own thread and wait for all of them
+ */
+static void run_threads(ScenarioShared_t *shared, uint32_t workers,
+                        const ScenarioRunner_Config_t *config)
+{
+    pthread_t threads[SCENARIO_RUNNER_MAX_WORKERS];
+    ScenarioThread_t args[SCENARIO_RUNNER_MAX_WORKERS];
+    boolean started[SCENARIO_RUNNER_MAX_WORKERS];
+
+    for (uint32_t w = 0; w < workers; w++) {
+        args[w].shared = shared;
+        args[w].self_id = (uint8_t)w;
+        args[w].config = config;
+        started[w] = (pthread_create(&threads[w], NULL, worker_thread, &args[w]) == 0) ? TRUE : FALSE;
+        if (!started[w]) {
+            /* Its range is stolen by the others */
+            LOG_WARN("ScenarioRunner: Cannot start worker thread %u", w);
+        }
+    }
+
+    for (uint32_t w = 0; w < workers; w++) {
+        if (started[w]) {
+            pthread_join(threads[w], NULL);
+        }
+    }
+}
+
+/**
+ * @brief Fork every worker, replacing the ones that die until all ranges are done
+ *
+ * @return Workers restarted after a crash
+ */
+static uint32_t run_processes(ScenarioShared_t *shared, uint32_t workers,
+                              const ScenarioRunner_Config_t *config)
+{
+    pid_t pids[SCENARIO_RUNNER_MAX_WORKERS];
+    uint32_t respawns = 0;
+    uint32_t alive = 0;
+
+    for (uint32_t w = 0; w < workers; w++) {
+        pids[w] = spawn_worker(shared, (uint8_t)w, config);
+        if (pids[w] < 0) {
+            /* Its range is stolen by the others */
+            LOG_WARN("ScenarioRunner: Cannot fork worker %u", w);
+        } else {
+            alive++;
+        }
+    }
+
+    while (alive > 0U) {
+        int wstatus;
+        pid_t pid = wait(&wstatus);
+        if (pid < 0) {
+            break;
+        }
+
+        uint32_t w = 0;
+        while (w < workers && pids[w] != pid) {
+            w++;
+        }
+        if (w == workers) {
+            continue;   /* Not one of ours */
+        }
+        pids[w] = -1;
+        alive--;
+
+        if (WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0) {
+            continue;
+        }
+
+        /* Worker died: blame its scenario, carry on with a fresh process */
+        uint32_t index = __atomic_load_n(&shared->workers[w].current, __ATOMIC_ACQUIRE);
+        if (index != SCENARIO_NONE) {
+            LOG_ERROR("ScenarioRunner: Scenario %u crashed worker %u", index, w);
+            shared->status[index] = (uint8_t)SCENARIO_CRASHED;
+            shared->workers[w].current = SCENARIO_NONE;
+        }
+        pids[w] = spawn_worker(shared, (uint8_t)w, config);
+        if (pids[w] > 0) {
+            alive++;
+            respawns++;
+        }
+    }
+
+    return respawns;
+}
+
+static uint64_t now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000U + (uint64_t)ts.tv_nsec / 1000000U;
+}
+
+Std_ReturnType ScenarioRunner_Run(const ScenarioRunner_Config_t *config, uint8_t *status,
+                                  ScenarioRunner_Summary_t *summary)
+{
+    uint32_t respawns = 0;
+
+    if (config == NULL || config->func == NULL || config->scenario_count == 0U ||
+        config->scenario_count == SCENARIO_NONE) {
+        return E_NOT_OK;
+    }
+
+    uint32_t workers = config->worker_count;
+    if (workers == 0U) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = (cpus > 0) ? (uint32_t)cpus : 1U;
+    }
+    if (workers > SCENARIO_RUNNER_MAX_WORKERS) {
+        workers = SCENARIO_RUNNER_MAX_WORKERS;
+    }
+    if (workers > config->scenario_count) {
+        workers = config->scenario_count;
+    }
+
+    size_t shared_size = sizeof(ScenarioShared_t) + config->scenario_count;
+    ScenarioShared_t *shared = (ScenarioShared_t *)mmap(NULL, shared_size, PROT_READ | PROT_WRITE,
+                                                        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) {
+        LOG_ERROR("ScenarioRunner: Cannot map %zu bytes of shared state", shared_size);
+        return E_NOT_OK;
+    }
+
+    /* Contiguous initial ranges; the first ones take the remainder */
+    memset(shared, 0, shared_size);
+    shared->worker_count = (uint8_t)workers;
+    uint32_t next = 0;
+    for (uint32_t w = 0; w < workers; w++) {
+        uint32_t share = config->scenario_count / workers +
+                         ((w < config->scenario_count % workers) ? 1U : 0U);
+        shared->workers[w].range = pack_range(next, next + share);
+        shared->workers[w].current = SCENARIO_NONE;
+        next += share;
+    }
+
+    uint64_t start = now_ms();
+    if (config->mode == SCENARIO_MODE_THREAD) {
+        run_threads(shared, workers, config);
+    } else {
+        respawns = run_processes(shared, workers, config);
+    }
+
+    /* Workers that could not be started leave their range behind */
+    uint32_t not_run = 0;
+    ScenarioRunner_Summary_t result;
+    memset(&result, 0, sizeof(result));
+    for (uint32_t i = 0; i < config->scenario_count; i++) {
+        switch (shared->status[i]) {
+            case SCENARIO_PASSED:
+                result.passed++;
+                break;
+            case SCENARIO_FAILED:
+                result.failed++;
+                break;
+            case SCENARIO_CRASHED:
+                result.crashed++;
+                break;
+            default:
+                not_run++;
+                break;
+        }
+    }
+    result.not_run = not_run;
+    result.workers = (uint8_t)workers;
+    result.respawns = respawns;
+    for (uint32_t w = 0; w < workers; w++) {
+        result.executed[w] = shared->workers[w].executed;
+        result.steals += shared->workers[w].steals;
+    }
+    result.elapsed_ms = (uint32_t)(now_ms() - start);
+
+    if (status != NULL) {
+        memcpy(status, shared->status, config->scenario_count);
+    }
+    if (summary != NULL) {
+        *summary = result;
+    }
+    munmap(shared, shared_size);
+
+    LOG_INFO("ScenarioRunner: %u scenarios on %u workers in %u ms: %u passed, %u failed, "
+             "%u crashed, %u steals", config->scenario_count, workers, result.elapsed_ms,
+             result.passed, result.failed, result.crashed, result.steals);
+
+    return (not_run == 0U) ? E_OK : E_NOT_OK;
+}
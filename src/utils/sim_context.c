@@ -0,0 +1,44 @@
+/**
+ * @file sim_context.c
+ * @brief Per-thread binding of module instance contexts
+ *
+ * - One thread-local pointer per module; module accessors fall back to
+ *   their static default instance when it is NULL
+ */
+
+#include "sim_context.h"
+#include <string.h>
+
+static __thread void *t_bound[SIM_CONTEXT_MODULE_COUNT];
+
+void* SimContext_Get(SimContext_Module_t module)
+{
+    return (module < SIM_CONTEXT_MODULE_COUNT) ? t_bound[module] : NULL;
+}
+
+void* SimContext_Bind(SimContext_Module_t module, void *ctx)
+{
+    void *previous;
+
+    if (module >= SIM_CONTEXT_MODULE_COUNT) {
+        return NULL;
+    }
+
+    previous = t_bound[module];
+    t_bound[module] = ctx;
+    return previous;
+}
+
+void SimContext_Save(SimContext_Binding_t *binding)
+{
+    if (binding != NULL) {
+        memcpy(binding->bound, t_bound, sizeof(t_bound));
+    }
+}
+
+void SimContext_Restore(const SimContext_Binding_t *binding)
+{
+    if (binding != NULL) {
+        memcpy(t_bound, binding->bound, sizeof(t_bound));
+    }
+}
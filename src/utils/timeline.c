@@ -0,0 +1,456 @@
+/**
+ * @file timeline.c
+ * @brief Virtual-time activity timeline implementation
+ *
+ * - Slots are claimed with one fetch-add and published by a release store
+ *   of their kind, so recording never locks and export skips torn slots
+ * - The device is a single server: an operation starts no earlier than
+ *   the end of the previous one (a CAS-advanced cursor)
+ * - Job intervals are paired per block at export time, not while recording
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "timeline.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+/* Block IDs (0xFF is the ReadAll/WriteAll pseudo block) */
+#define TIMELINE_BLOCK_IDS 256U
+
+/* Core track bitmap width */
+#define TIMELINE_MAX_CORES 32U
+
+/* Trace-event process IDs (one per track group) */
+#define TIMELINE_PID_SCHED 1
+#define TIMELINE_PID_DEVICE 2
+#define TIMELINE_PID_JOBS 3
+
+typedef enum {
+    TIMELINE_EV_EMPTY = 0,          /**< Claimed but not yet written */
+    TIMELINE_EV_TASK,
+    TIMELINE_EV_DEVICE,
+    TIMELINE_EV_JOB
+} Timeline_EventKind_t;
+
+/**
+ * @brief One recorded event
+ */
+typedef struct {
+    uint8_t kind;                   /**< Timeline_EventKind_t, stored last */
+    uint8_t sub;                    /**< Core, device op or job point */
+    uint8_t job_type;
+    uint8_t result;
+    uint32_t id;                    /**< Task ID, address or block ID */
+    uint32_t length;                /**< Device bytes */
+    uint32_t duration_us;
+    uint64_t start_us;
+    const char *name;               /**< Task name */
+} Timeline_Event_t;
+
+uint32_t Timeline_ActiveFlag = 0U;
+
+static struct {
+    Timeline_Event_t *events;
+    uint32_t capacity;
+    uint32_t next;                  /**< Slots claimed (may pass capacity) */
+    uint32_t dropped;
+    uint64_t device_free_us;        /**< End of the last device operation */
+} g_timeline;
+
+static Timeline_Event_t *claim(void)
+{
+    uint32_t idx = __atomic_fetch_add(&g_timeline.next, 1U, __ATOMIC_RELAXED);
+
+    if (idx >= g_timeline.capacity) {
+        __atomic_fetch_add(&g_timeline.dropped, 1U, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    return &g_timeline.events[idx];
+}
+
+static void publish(Timeline_Event_t *ev, Timeline_EventKind_t kind)
+{
+    __atomic_store_n(&ev->kind, (uint8_t)kind, __ATOMIC_RELEASE);
+}
+
+Std_ReturnType Timeline_Start(uint32_t capacity)
+{
+    if (TIMELINE_ACTIVE()) {
+        return E_NOT_OK;
+    }
+    if (capacity == 0U) {
+        capacity = TIMELINE_DEFAULT_EVENTS;
+    }
+
+    Timeline_Event_t *events = calloc(capacity, sizeof(Timeline_Event_t));
+    if (events == NULL) {
+        return E_NOT_OK;
+    }
+
+    free(g_timeline.events);
+    g_timeline.events = events;
+    g_timeline.capacity = capacity;
+    g_timeline.next = 0U;
+    g_timeline.dropped = 0U;
+    g_timeline.device_free_us = 0U;
+    __atomic_store_n(&Timeline_ActiveFlag, 1U, __ATOMIC_RELEASE);
+    return E_OK;
+}
+
+void Timeline_Stop(void)
+{
+    __atomic_store_n(&Timeline_ActiveFlag, 0U, __ATOMIC_RELEASE);
+}
+
+Std_ReturnType Timeline_GetStats(Timeline_Stats_t *stats)
+{
+    if (stats == NULL) {
+        return E_NOT_OK;
+    }
+
+    uint32_t next = __atomic_load_n(&g_timeline.next, __ATOMIC_RELAXED);
+    stats->capacity = g_timeline.capacity;
+    stats->events = (next < g_timeline.capacity) ? next : g_timeline.capacity;
+    stats->dropped = __atomic_load_n(&g_timeline.dropped, __ATOMIC_RELAXED);
+    return E_OK;
+}
+
+void Timeline_TaskRun(uint8_t core, uint32_t task_id, const char *name, uint64_t start_us,
+                      uint32_t duration_us)
+{
+    Timeline_Event_t *ev = claim();
+    if (ev == NULL) {
+        return;
+    }
+
+    ev->sub = core;
+    ev->id = task_id;
+    ev->name = name;
+    ev->start_us = start_us;
+    ev->duration_us = duration_us;
+    publish(ev, TIMELINE_EV_TASK);
+}
+
+void Timeline_DeviceOp(uint8_t op, Std_ReturnType result, uint32_t address, uint32_t length,
+                       uint64_t start_us, uint32_t duration_us)
+{
+    /* Queue behind the operation still in progress */
+    uint64_t free_us = __atomic_load_n(&g_timeline.device_free_us, __ATOMIC_RELAXED);
+    uint64_t start;
+    do {
+        start = (free_us > start_us) ? free_us : start_us;
+    } while (!__atomic_compare_exchange_n(&g_timeline.device_free_us, &free_us,
+                                          start + duration_us, FALSE,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    Timeline_Event_t *ev = claim();
+    if (ev == NULL) {
+        return;
+    }
+
+    ev->sub = op;
+    ev->result = result;
+    ev->id = address;
+    ev->length = length;
+    ev->start_us = start;
+    ev->duration_us = duration_us;
+    publish(ev, TIMELINE_EV_DEVICE);
+}
+
+void Timeline_Job(Timeline_JobPoint_t point, uint8_t block_id, uint8_t job_type,
+                  Std_ReturnType result, uint64_t now_us)
+{
+    uint64_t free_us = __atomic_load_n(&g_timeline.device_free_us, __ATOMIC_RELAXED);
+    Timeline_Event_t *ev = claim();
+    if (ev == NULL) {
+        return;
+    }
+
+    ev->sub = (uint8_t)point;
+    ev->id = block_id;
+    ev->job_type = job_type;
+    ev->result = result;
+    ev->start_us = (free_us > now_us) ? free_us : now_us;
+    publish(ev, TIMELINE_EV_JOB);
+}
+
+/**
+ * @brief snprintf-style output cursor
+ */
+typedef struct {
+    char *buffer;
+    size_t size;
+    size_t length;              /**< Length of the full output so far */
+    boolean first;              /**< No event emitted yet */
+} TimelineWriter_t;
+
+static void emit(TimelineWriter_t *w, const char *format, ...)
+{
+    va_list args;
+    size_t room = (w->length < w->size) ? w->size - w->length : 0U;
+
+    va_start(args, format);
+    int n = vsnprintf((room > 0U) ? &w->buffer[w->length] : NULL, room, format, args);
+    va_end(args);
+
+    if (n > 0) {
+        w->length += (size_t)n;
+    }
+}
+
+/**
+ * @brief Open one trace event object (separator included)
+ */
+static void emit_open(TimelineWriter_t *w, const char *phase, int pid, uint32_t tid)
+{
+    emit(w, "%s\n{\"ph\":\"%s\",\"pid\":%d,\"tid\":%u", w->first ? "" : ",", phase, pid, tid);
+    w->first = FALSE;
+}
+
+/**
+ * @brief JSON string (quotes and control characters escaped)
+ */
+static void emit_string(TimelineWriter_t *w, const char *s)
+{
+    emit(w, "\"");
+    for (; *s != '\0'; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            emit(w, "\\%c", c);
+        } else if (c < 0x20U) {
+            emit(w, "\\u%04x", c);
+        } else {
+            emit(w, "%c", c);
+        }
+    }
+    emit(w, "\"");
+}
+
+static void emit_name_meta(TimelineWriter_t *w, const char *kind, int pid, uint32_t tid,
+                           const char *name)
+{
+    emit_open(w, "M", pid, tid);
+    emit(w, ",\"name\":\"%s\",\"args\":{\"name\":", kind);
+    emit_string(w, name);
+    emit(w, "}}");
+}
+
+static void emit_complete(TimelineWriter_t *w, int pid, uint32_t tid, const char *name,
+                          uint64_t start_us, uint64_t duration_us)
+{
+    emit_open(w, "X", pid, tid);
+    emit(w, ",\"name\":");
+    emit_string(w, name);
+    emit(w, ",\"ts\":%llu,\"dur\":%llu", (unsigned long long)start_us,
+         (unsigned long long)duration_us);
+}
+
+static const char *device_op_name(uint8_t op)
+{
+    static const char *const names[] = { "read", "program", "erase", "verify" };
+    return (op < sizeof(names) / sizeof(names[0])) ? names[op] : "op";
+}
+
+static const char *job_type_name(uint8_t job_type)
+{
+    static const char *const names[] = { "read", "write", "ReadAll", "WriteAll", "write batch" };
+    return (job_type < sizeof(names) / sizeof(names[0])) ? names[job_type] : "job";
+}
+
+static const char *result_name(uint8_t result)
+{
+    return (result == E_OK) ? "ok" : "failed";
+}
+
+/**
+ * @brief Per-block job pairing state
+ */
+typedef struct {
+    boolean queued;
+    boolean started;
+    uint8_t job_type;
+    uint64_t queued_us;
+    uint64_t started_us;
+} TimelineJobTrack_t;
+
+static void emit_job(TimelineWriter_t *w, TimelineJobTrack_t *track, const Timeline_Event_t *ev)
+{
+    uint32_t block_id = ev->id;
+
+    switch ((Timeline_JobPoint_t)ev->sub) {
+        case TIMELINE_JOB_QUEUED:
+            track->queued = TRUE;
+            track->started = FALSE;
+            track->job_type = ev->job_type;
+            track->queued_us = ev->start_us;
+            break;
+
+        case TIMELINE_JOB_STARTED:
+            if (track->queued && ev->start_us > track->queued_us) {
+                emit_complete(w, TIMELINE_PID_JOBS, block_id, "queued", track->queued_us,
+                              ev->start_us - track->queued_us);
+                emit(w, "}");
+            }
+            track->queued = FALSE;
+            track->started = TRUE;
+            track->job_type = ev->job_type;
+            track->started_us = ev->start_us;
+            break;
+
+        case TIMELINE_JOB_COMPLETED:
+        default:
+            if (track->started) {
+                uint64_t end = (ev->start_us > track->started_us) ? ev->start_us
+                                                                  : track->started_us;
+                emit_complete(w, TIMELINE_PID_JOBS, block_id, job_type_name(track->job_type),
+                              track->started_us, end - track->started_us);
+            } else {
+                /* Started before recording, or completed as part of a batch */
+                emit_open(w, "i", TIMELINE_PID_JOBS, block_id);
+                emit(w, ",\"name\":\"completed\",\"s\":\"t\",\"ts\":%llu",
+                     (unsigned long long)ev->start_us);
+            }
+            emit(w, ",\"args\":{\"result\":\"%s\"}}", result_name(ev->result));
+            track->queued = FALSE;
+            track->started = FALSE;
+            break;
+    }
+}
+
+size_t Timeline_Export(char *buffer, size_t size)
+{
+    if (TIMELINE_ACTIVE()) {
+        return 0U;
+    }
+
+    TimelineWriter_t w = { .buffer = buffer, .size = (buffer != NULL) ? size : 0U,
+                           .length = 0, .first = TRUE };
+    uint32_t count = (g_timeline.next < g_timeline.capacity) ? g_timeline.next
+                                                             : g_timeline.capacity;
+    uint32_t cores = 0U;
+    uint8_t blocks[TIMELINE_BLOCK_IDS];
+    boolean device = FALSE;
+    boolean jobs = FALSE;
+    char name[32];
+
+    if (w.size > 0U) {
+        w.buffer[0] = '\0';
+    }
+
+    /* Tracks present, named up front */
+    memset(blocks, 0, sizeof(blocks));
+    for (uint32_t i = 0; i < count; i++) {
+        const Timeline_Event_t *ev = &g_timeline.events[i];
+        switch (__atomic_load_n(&ev->kind, __ATOMIC_ACQUIRE)) {
+            case TIMELINE_EV_TASK:
+                cores |= 1U << (ev->sub % TIMELINE_MAX_CORES);
+                break;
+            case TIMELINE_EV_DEVICE:
+                device = TRUE;
+                break;
+            case TIMELINE_EV_JOB:
+                blocks[ev->id & 0xFFU] = 1U;
+                jobs = TRUE;
+                break;
+            default:
+                break;
+        }
+    }
+
+    emit(&w, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    if (cores != 0U) {
+        emit_name_meta(&w, "process_name", TIMELINE_PID_SCHED, 0U, "Scheduler");
+        for (uint32_t c = 0; c < TIMELINE_MAX_CORES; c++) {
+            if ((cores & (1U << c)) != 0U) {
+                snprintf(name, sizeof(name), "core %u", c);
+                emit_name_meta(&w, "thread_name", TIMELINE_PID_SCHED, c, name);
+            }
+        }
+    }
+    if (device) {
+        emit_name_meta(&w, "process_name", TIMELINE_PID_DEVICE, 0U, "EEPROM");
+        emit_name_meta(&w, "thread_name", TIMELINE_PID_DEVICE, 0U, "device");
+    }
+    if (jobs) {
+        emit_name_meta(&w, "process_name", TIMELINE_PID_JOBS, 0U, "NvM jobs");
+    }
+    for (uint32_t b = 0; b < TIMELINE_BLOCK_IDS; b++) {
+        if (blocks[b] != 0U) {
+            if (b == 0xFFU) {
+                snprintf(name, sizeof(name), "ReadAll/WriteAll");
+            } else {
+                snprintf(name, sizeof(name), "block %u", b);
+            }
+            emit_name_meta(&w, "thread_name", TIMELINE_PID_JOBS, b, name);
+        }
+    }
+
+    TimelineJobTrack_t *tracks = calloc(TIMELINE_BLOCK_IDS, sizeof(TimelineJobTrack_t));
+
+    for (uint32_t i = 0; i < count; i++) {
+        const Timeline_Event_t *ev = &g_timeline.events[i];
+        switch (__atomic_load_n(&ev->kind, __ATOMIC_ACQUIRE)) {
+            case TIMELINE_EV_TASK:
+                if (ev->name != NULL) {
+                    emit_complete(&w, TIMELINE_PID_SCHED, ev->sub, ev->name, ev->start_us,
+                                  ev->duration_us);
+                } else {
+                    snprintf(name, sizeof(name), "task %u", ev->id);
+                    emit_complete(&w, TIMELINE_PID_SCHED, ev->sub, name, ev->start_us,
+                                  ev->duration_us);
+                }
+                emit(&w, ",\"args\":{\"task_id\":%u}}", ev->id);
+                break;
+
+            case TIMELINE_EV_DEVICE:
+                emit_complete(&w, TIMELINE_PID_DEVICE, 0U, device_op_name(ev->sub),
+                              ev->start_us, ev->duration_us);
+                emit(&w, ",\"args\":{\"address\":\"0x%X\",\"length\":%u,\"result\":\"%s\"}}",
+                     ev->id, ev->length, result_name(ev->result));
+                break;
+
+            case TIMELINE_EV_JOB:
+                if (tracks != NULL) {
+                    emit_job(&w, &tracks[ev->id & 0xFFU], ev);
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    free(tracks);
+    emit(&w, "\n]}\n");
+    return w.length;
+}
+
+Std_ReturnType Timeline_ExportFile(const char *path)
+{
+    if (path == NULL || TIMELINE_ACTIVE()) {
+        return E_NOT_OK;
+    }
+
+    size_t length = Timeline_Export(NULL, 0U);
+    char *text = malloc(length + 1U);
+    if (text == NULL) {
+        return E_NOT_OK;
+    }
+    (void)Timeline_Export(text, length + 1U);
+
+    Std_ReturnType ret = E_NOT_OK;
+    FILE *f = fopen(path, "w");
+    if (f != NULL) {
+        if (fwrite(text, 1U, length, f) == length) {
+            ret = E_OK;
+        }
+        if (fclose(f) != 0) {
+            ret = E_NOT_OK;
+        }
+    }
+    free(text);
+    return ret;
+}
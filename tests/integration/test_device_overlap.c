@@ -0,0 +1,266 @@
+/**
+ * @file test_device_overlap.c
+ * @brief Integration Test: Single-Block Jobs on Parallel Device Lanes
+ */
+
+#include "nvm.h"
+#include "eeprom_driver.h"
+#include "memif.h"
+#include "os_scheduler.h"
+#include "logging.h"
+#include <stdio.h>
+#include <string.h>
+
+static uint32_t tests_passed = 0;
+static uint32_t tests_failed = 0;
+
+#define TEST_ASSERT(cond, msg) \
+    do { \
+        if (cond) { tests_passed++; LOG_INFO("  ✓ %s", msg); } \
+        else { tests_failed++; LOG_ERROR("  ✗ %s", msg); } \
+    } while(0)
+
+#define BLOCK_COUNT 8U
+#define BLOCK_SIZE  200U
+#define FLASH_BASE  0x10000U
+
+/* A write is one 3 ms erase and one 2 ms page program */
+static const Eeprom_ConfigType g_device = {
+    .capacity_bytes = 8192, .page_size = 256, .block_size = 1024,
+    .read_delay_us = 10, .write_delay_ms = 2, .erase_delay_ms = 3,
+    .endurance_cycles = 100000
+};
+
+static const MemIf_DeviceConfig_t g_flash = {
+    .type = MEMIF_DEVICE_FLASH, .base_address = FLASH_BASE, .size_bytes = 8192,
+    .page_size = 256, .block_size = 1024,
+    .read_delay_us = 10, .write_delay_ms = 2, .erase_delay_ms = 3
+};
+
+static uint8_t g_data[BLOCK_COUNT][BLOCK_SIZE];
+static uint8_t g_rom[BLOCK_SIZE];
+
+/**
+ * @brief Fresh NvM with the EEPROM and a flash device of the same timing
+ *
+ * @param devices 1: every block on the EEPROM, 2: blocks alternate between devices
+ */
+static void setup(uint8_t devices)
+{
+    NvM_Init();
+    Eep_Init(&g_device);
+    OsScheduler_Init(16);
+    MemIf_AddDevice(&g_flash, NULL);
+    NvM_SetDeviceOverlap(TRUE);
+
+    memset(g_rom, 0x5A, sizeof(g_rom));
+    for (uint8_t i = 0; i < BLOCK_COUNT; i++) {
+        uint32_t offset = (devices == 1U) ? (uint32_t)i * 0x400U
+                                          : ((i % 2U) ? FLASH_BASE : 0U) + (uint32_t)(i / 2U) * 0x400U;
+        NvM_BlockConfig_t block = {
+            .block_id = (uint8_t)(1 + i), .block_size = BLOCK_SIZE, .block_type = NVM_BLOCK_NATIVE,
+            .crc_type = NVM_CRC16, .crc_placement = NVM_CRC_PLACEMENT_INLINE, .priority = 10,
+            .ram_mirror_ptr = g_data[i], .rom_block_ptr = g_rom, .rom_block_size = sizeof(g_rom),
+            .eeprom_offset = offset
+        };
+        NvM_RegisterBlock(&block);
+    }
+}
+
+/**
+ * @brief Run NvM_MainFunction every virtual millisecond until blocks 1..n are done
+ *
+ * @return Elapsed virtual milliseconds
+ */
+static uint32_t run_until_done(uint8_t n)
+{
+    uint32_t start_ms = OsScheduler_GetVirtualTimeMs();
+
+    for (uint32_t iter = 0; iter < 1000; iter++) {
+        uint8_t pending = 0;
+
+        NvM_MainFunction();
+        for (uint8_t i = 0; i < n; i++) {
+            uint8_t result;
+            NvM_GetJobResult((uint8_t)(1 + i), &result);
+            if (result == NVM_REQ_PENDING) {
+                pending++;
+            }
+        }
+        if (pending == 0U) {
+            break;
+        }
+        OsScheduler_Sleep(1);
+    }
+
+    return OsScheduler_GetVirtualTimeMs() - start_ms;
+}
+
+/**
+ * @brief Write every block, then read it back into its mirror
+ *
+ * @param read_ms Receives the read-back time
+ * @return Write time
+ */
+static uint32_t write_and_read_back(uint32_t *read_ms)
+{
+    uint32_t write_ms;
+    uint8_t result;
+    boolean ok = TRUE;
+
+    for (uint8_t i = 0; i < BLOCK_COUNT; i++) {
+        memset(g_data[i], 0xA0 + i, BLOCK_SIZE);
+        NvM_WriteBlock((uint8_t)(1 + i), g_data[i]);
+    }
+    write_ms = run_until_done(BLOCK_COUNT);
+
+    for (uint8_t i = 0; i < BLOCK_COUNT; i++) {
+        NvM_GetJobResult((uint8_t)(1 + i), &result);
+        ok = (ok && result == NVM_REQ_OK) ? TRUE : FALSE;
+        memset(g_data[i], 0, BLOCK_SIZE);
+        NvM_ReadBlock((uint8_t)(1 + i), g_data[i]);
+    }
+    TEST_ASSERT(ok, "Every write completed");
+
+    *read_ms = run_until_done(BLOCK_COUNT);
+    ok = TRUE;
+    for (uint8_t i = 0; i < BLOCK_COUNT; i++) {
+        NvM_GetJobResult((uint8_t)(1 + i), &result);
+        ok = (ok && result == NVM_REQ_OK && g_data[i][0] == 0xA0 + i &&
+              g_data[i][BLOCK_SIZE - 1U] == 0xA0 + i) ? TRUE : FALSE;
+    }
+    TEST_ASSERT(ok, "Every block read back");
+
+    return write_ms;
+}
+
+static void test_throughput_scales(void)
+{
+    LOG_INFO("Test: Throughput Scales With Devices");
+    uint32_t one_write, one_read, two_write, two_read;
+    NvM_Diagnostics_t diag;
+
+    setup(1);
+    one_write = write_and_read_back(&one_read);
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(diag.overlapped_jobs == 2U * BLOCK_COUNT, "Jobs ran on device lanes");
+
+    setup(2);
+    two_write = write_and_read_back(&two_read);
+
+    LOG_INFO("  Writes: %u ms on one device, %u ms on two", one_write, two_write);
+    LOG_INFO("  Reads:  %u ms on one device, %u ms on two", one_read, two_read);
+    TEST_ASSERT(one_write >= BLOCK_COUNT * 5U, "One device serializes the writes");
+    TEST_ASSERT(two_write * 2U <= one_write + 2U, "Two devices halve the write time");
+    TEST_ASSERT(two_read * 2U <= one_read + 2U, "Two devices halve the read time");
+}
+
+static void test_layout_matches_sync_path(void)
+{
+    LOG_INFO("Test: Lane Copies Match the Synchronous Layout");
+    uint8_t result;
+    uint32_t read_ms;
+
+    setup(2);
+    (void)write_and_read_back(&read_ms);
+
+    /* Read through the block-type handler */
+    NvM_SetDeviceOverlap(FALSE);
+    memset(g_data[1], 0, BLOCK_SIZE);
+    NvM_ReadBlock(2, g_data[1]);
+    NvM_MainFunction();
+    NvM_GetJobResult(2, &result);
+    TEST_ASSERT(result == NVM_REQ_OK && g_data[1][0] == 0xA1, "Synchronous read accepts a lane copy");
+
+    /* And the other way round */
+    memset(g_data[1], 0x77, BLOCK_SIZE);
+    NvM_WriteBlock(2, g_data[1]);
+    NvM_MainFunction();
+    NvM_SetDeviceOverlap(TRUE);
+    memset(g_data[1], 0, BLOCK_SIZE);
+    NvM_ReadBlock(2, g_data[1]);
+    run_until_done(2);
+    NvM_GetJobResult(2, &result);
+    TEST_ASSERT(result == NVM_REQ_OK && g_data[1][0] == 0x77, "Lane read accepts a synchronous copy");
+}
+
+static void test_invalid_copy_recovers(void)
+{
+    LOG_INFO("Test: Invalid Copy Falls Back to the ROM Default");
+    static uint8_t garbage[256];
+    uint8_t result;
+    uint32_t read_ms;
+
+    setup(2);
+    (void)write_and_read_back(&read_ms);
+
+    /* Block 2 lives on the flash device */
+    memset(garbage, 0x00, sizeof(garbage));
+    MemIf_Erase(FLASH_BASE, 1024);
+    MemIf_Write(FLASH_BASE, garbage, sizeof(garbage));
+
+    NvM_ReadBlock(2, g_data[1]);
+    run_until_done(2);
+    NvM_GetJobResult(2, &result);
+    TEST_ASSERT(result == NVM_REQ_NOT_OK, "Corrupt copy reported");
+    TEST_ASSERT(g_data[1][0] == 0x5A && g_data[1][BLOCK_SIZE - 1U] == 0x5A, "ROM default loaded");
+}
+
+static void test_device_order(void)
+{
+    LOG_INFO("Test: Jobs Wait for Their Own Device Only");
+    NvM_Diagnostics_t diag;
+    uint8_t result;
+
+    setup(2);
+    for (uint8_t i = 0; i < BLOCK_COUNT; i++) {
+        memset(g_data[i], 0x10 + i, BLOCK_SIZE);
+    }
+
+    /* Two EEPROM writes, then one flash write: the flash write starts at once */
+    NvM_WriteBlock(1, g_data[0]);
+    NvM_WriteBlock(3, g_data[2]);
+    NvM_WriteBlock(2, g_data[1]);
+    NvM_MainFunction();
+    NvM_GetDiagnostics(&diag);
+    NvM_GetJobResult(3, &result);
+    TEST_ASSERT(result == NVM_REQ_PENDING && diag.current_queue_depth == 1U &&
+                diag.overlapped_jobs == 2U, "Second EEPROM write queued behind the first");
+    run_until_done(3);
+
+    /* ReadAll waits for the EEPROM lane; the flash write behind it waits too */
+    NvM_WriteBlock(1, g_data[0]);
+    NvM_MainFunction();
+    NvM_ReadAll();
+    NvM_WriteBlock(4, g_data[3]);
+    NvM_MainFunction();
+    NvM_GetDiagnostics(&diag);
+    NvM_GetJobResult(4, &result);
+    TEST_ASSERT(result == NVM_REQ_PENDING && diag.overlapped_jobs == 4U, "Lanes drain before ReadAll");
+
+    run_until_done(4);
+    NvM_GetJobResult(4, &result);
+    TEST_ASSERT(result == NVM_REQ_OK && g_data[2][0] == 0x12, "Every job completed");
+}
+
+int main(void) {
+    LOG_INFO("========================================");
+    LOG_INFO("  Integration Test: Device Lanes");
+    LOG_INFO("========================================");
+    LOG_INFO("");
+
+    test_throughput_scales();
+    LOG_INFO("");
+    test_layout_matches_sync_path();
+    LOG_INFO("");
+    test_invalid_copy_recovers();
+    LOG_INFO("");
+    test_device_order();
+
+    LOG_INFO("");
+    LOG_INFO("========================================");
+    LOG_INFO("  Passed: %u, Failed: %u", tests_passed, tests_failed);
+    LOG_INFO("========================================");
+
+    return tests_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,205 @@
+/**
+ * @file test_image_start.c
+ * @brief Integration Test: Starting NvM from a Prebuilt EEPROM Image (nvm_image.h)
+ */
+
+#include "nvm.h"
+#include "nvm_image.h"
+#include "eeprom_driver.h"
+#include "memif.h"
+#include "os_scheduler.h"
+#include "logging.h"
+#include <stdio.h>
+#include <string.h>
+
+static uint32_t tests_passed = 0;
+static uint32_t tests_failed = 0;
+
+#define TEST_ASSERT(cond, msg) \
+    do { \
+        if (cond) { tests_passed++; LOG_INFO("  ✓ %s", msg); } \
+        else { tests_failed++; LOG_ERROR("  ✗ %s", msg); } \
+    } while(0)
+
+#define IMAGE_PATH "/tmp/eepsim_test_prebuilt.img"
+#define WEAR_PATH  IMAGE_PATH ".wear"
+
+static const Eeprom_ConfigType g_device = {
+    .capacity_bytes = 8192, .page_size = 256, .block_size = 1024,
+    .read_delay_us = 50, .write_delay_ms = 2, .erase_delay_ms = 3,
+    .endurance_cycles = 100000, .image_path = IMAGE_PATH
+};
+
+static uint8_t g_native[256];
+static uint8_t g_calib[200];
+static uint8_t g_versions[3][64];
+
+static uint8_t g_native_mirror[256];
+static uint8_t g_calib_mirror[200];
+static uint8_t g_dataset_mirror[64];
+
+static NvM_ImageBlock_t g_blocks[3];
+
+static void describe_blocks(void)
+{
+    memset(g_blocks, 0, sizeof(g_blocks));
+    memset(g_native, 0xA5, sizeof(g_native));
+    for (uint32_t i = 0; i < sizeof(g_calib); i++) {
+        g_calib[i] = (uint8_t)(i * 7U);
+    }
+    for (uint32_t v = 0; v < 3U; v++) {
+        memset(g_versions[v], 0x10 * (int)(v + 1U), sizeof(g_versions[v]));
+    }
+
+    g_blocks[0].config = (NvM_BlockConfig_t){
+        .block_id = 1, .block_size = 256, .block_type = NVM_BLOCK_NATIVE,
+        .crc_type = NVM_CRC16, .eeprom_offset = 0x0000
+    };
+    g_blocks[0].data[0] = g_native;
+
+    g_blocks[1].config = (NvM_BlockConfig_t){
+        .block_id = 2, .block_size = 200, .block_type = NVM_BLOCK_REDUNDANT,
+        .crc_type = NVM_CRC32, .crc_placement = NVM_CRC_PLACEMENT_INLINE,
+        .eeprom_offset = 0x0400, .redundant_eeprom_offset = 0x0800
+    };
+    g_blocks[1].data[0] = g_calib;
+    g_blocks[1].erase_count = 120;
+
+    g_blocks[2].config = (NvM_BlockConfig_t){
+        .block_id = 3, .block_size = 64, .block_type = NVM_BLOCK_DATASET,
+        .crc_type = NVM_CRC16, .crc_placement = NVM_CRC_PLACEMENT_INLINE,
+        .compression = NVM_COMPRESSION_RLE, .eeprom_offset = 0x0C00, .dataset_count = 4
+    };
+    g_blocks[2].data[0] = g_versions[0];
+    g_blocks[2].data[1] = g_versions[1];
+    g_blocks[2].data[2] = g_versions[2];
+    g_blocks[2].version_count = 3;
+}
+
+static void test_build_image(void)
+{
+    LOG_INFO("Test: Build an Image");
+    remove(IMAGE_PATH);
+    remove(WEAR_PATH);
+    describe_blocks();
+
+    MemIf_Init();
+    TEST_ASSERT(Eep_Init(&g_device) == E_OK, "Image file mapped");
+
+    /* Layout errors are caught before anything is programmed */
+    NvM_ImageBlock_t bad[2] = { g_blocks[0], g_blocks[0] };
+    bad[1].config.block_id = 9;
+    TEST_ASSERT(NvM_ImageBuild(bad, 2) == E_NOT_OK, "Shared slot rejected");
+    bad[1] = g_blocks[2];
+    bad[1].version_count = 4;
+    bad[1].config.dataset_count = 3;
+    TEST_ASSERT(NvM_ImageBuild(bad, 2) == E_NOT_OK, "More versions than slots rejected");
+    uint8_t page[16];
+    Eep_Read(0, page, sizeof(page));
+    TEST_ASSERT(page[0] == 0xFF, "Nothing programmed on a rejected layout");
+
+    TEST_ASSERT(NvM_ImageBuild(g_blocks, 3) == E_OK, "Image built");
+    Eep_Destroy();
+}
+
+static void test_inspect_image(void)
+{
+    LOG_INFO("Test: Inspect the Image");
+    NvM_ImageReport_t report;
+    uint8_t data[256];
+
+    TEST_ASSERT(Eep_Init(&g_device) == E_OK, "Image mapped again");
+
+    TEST_ASSERT(NvM_ImageInspectBlock(&g_blocks[0].config, data, &report) == E_OK &&
+                report.valid_mask == 1U && memcmp(data, g_native, sizeof(g_native)) == 0,
+                "NATIVE block valid with its data");
+    TEST_ASSERT(NvM_ImageInspectBlock(&g_blocks[1].config, data, &report) == E_OK &&
+                report.valid_mask == 3U && report.selected == 0U &&
+                memcmp(data, g_calib, sizeof(g_calib)) == 0, "REDUNDANT block: both copies valid");
+    TEST_ASSERT(report.erase_count == 120U, "Erase count preset");
+    TEST_ASSERT(NvM_ImageInspectBlock(&g_blocks[2].config, data, &report) == E_OK &&
+                report.header_mask == 7U && report.selected == 2U && report.sequence == 3U &&
+                memcmp(data, g_versions[2], sizeof(g_versions[2])) == 0,
+                "DATASET block: newest of three versions selected");
+
+    /* A lost backup copy is reported, the primary still selected */
+    TEST_ASSERT(Eep_Snapshot() == E_OK, "Snapshot taken");
+    Eep_Erase(0x0800);
+    TEST_ASSERT(NvM_ImageInspectBlock(&g_blocks[1].config, data, &report) == E_NOT_OK &&
+                report.valid_mask == 1U && report.selected == 0U, "Lost backup reported");
+    Eep_Destroy();
+}
+
+static void test_start_from_image(void)
+{
+    LOG_INFO("Test: Start NvM from the Image");
+    uint8_t result = NVM_REQ_NOT_OK;
+
+    NvM_Init();
+    OsScheduler_Init(16);
+    TEST_ASSERT(Eep_Init(&g_device) == E_OK, "Prebuilt image mapped");
+    TEST_ASSERT(Eep_Snapshot() == E_OK, "Test changes kept out of the file");
+
+    NvM_BlockConfig_t cfg = g_blocks[0].config;
+    cfg.ram_mirror_ptr = g_native_mirror;
+    NvM_RegisterBlock(&cfg);
+    cfg = g_blocks[1].config;
+    cfg.ram_mirror_ptr = g_calib_mirror;
+    NvM_RegisterBlock(&cfg);
+    cfg = g_blocks[2].config;
+    cfg.ram_mirror_ptr = g_dataset_mirror;
+    NvM_RegisterBlock(&cfg);
+
+    /* No ROM defaults to write: the blocks read straight away */
+    uint8_t native[256];
+    uint8_t calib[200];
+    uint8_t dataset[64];
+    NvM_ReadBlock(1, native);
+    NvM_ReadBlock(2, calib);
+    NvM_ReadBlock(3, dataset);
+    NvM_WaitJob(1, 1000);
+    NvM_WaitJob(2, 1000);
+    NvM_WaitJob(3, 1000);
+    NvM_GetJobResult(2, &result);
+    TEST_ASSERT(result == NVM_REQ_OK, "Reads OK");
+    TEST_ASSERT(memcmp(native, g_native, sizeof(g_native)) == 0, "NATIVE data loaded");
+    TEST_ASSERT(memcmp(calib, g_calib, sizeof(g_calib)) == 0, "REDUNDANT data loaded");
+    TEST_ASSERT(memcmp(dataset, g_versions[2], sizeof(g_versions[2])) == 0,
+                "DATASET newest version loaded");
+
+    /* The next dataset write rotates past the newest slot */
+    uint8_t next[64];
+    memset(next, 0x99, sizeof(next));
+    NvM_WriteBlock(3, next);
+    NvM_WaitJob(3, 1000);
+    NvM_GetJobResult(3, &result);
+    TEST_ASSERT(result == NVM_REQ_OK, "DATASET written after start");
+
+    NvM_ImageReport_t report;
+    NvM_ImageInspectBlock(&g_blocks[2].config, NULL, &report);
+    TEST_ASSERT(report.selected == 3U && report.sequence == 4U, "Write went to slot 3, sequence 4");
+    Eep_Destroy();
+
+    remove(IMAGE_PATH);
+    remove(WEAR_PATH);
+}
+
+int main(void) {
+    LOG_INFO("========================================");
+    LOG_INFO("  Integration Test: Prebuilt Image Start");
+    LOG_INFO("========================================");
+    LOG_INFO("");
+
+    test_build_image();
+    LOG_INFO("");
+    test_inspect_image();
+    LOG_INFO("");
+    test_start_from_image();
+
+    LOG_INFO("");
+    LOG_INFO("========================================");
+    LOG_INFO("  Passed: %u, Failed: %u", tests_passed, tests_failed);
+    LOG_INFO("========================================");
+
+    return tests_failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,292 @@
+/**
+ * @file test_job_wait.c
+ * @brief Integration Test: Waiting for Job Completion (NvM_WaitJob, handles, eventfd)
+ */
+
+#define _GNU_SOURCE
+
+#include "nvm.h"
+#include "os_scheduler.h"
+#include "fault_injection.h"
+#include "logging.h"
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <poll.h>
+#include <unistd.h>
+
+static uint32_t tests_passed = 0;
+static uint32_t tests_failed = 0;
+
+#define TEST_ASSERT(cond, msg) \
+    do { \
+        if (cond) { tests_passed++; LOG_INFO("  ✓ %s", msg); } \
+        else { tests_failed++; LOG_ERROR("  ✗ %s", msg); } \
+    } while(0)
+
+#define WAIT_BLOCK_ID 40
+#define IDLE_BLOCK_ID 41
+
+static uint8_t g_mirror[256];
+static uint8_t g_idle_mirror[256];
+
+static void setup(void) {
+    NvM_Init();
+    OsScheduler_Init(16);
+
+    NvM_BlockConfig_t block = {
+        .block_id = WAIT_BLOCK_ID, .block_size = 256, .block_type = NVM_BLOCK_NATIVE,
+        .crc_type = NVM_CRC16, .priority = 10, .ram_mirror_ptr = g_mirror,
+        .eeprom_offset = 0x0000
+    };
+    NvM_RegisterBlock(&block);
+
+    block.block_id = IDLE_BLOCK_ID;
+    block.ram_mirror_ptr = g_idle_mirror;
+    block.eeprom_offset = 0x0400;
+    NvM_RegisterBlock(&block);
+}
+
+static void test_wait_on_nvm_thread(void) {
+    LOG_INFO("Test: Wait on the NvM Thread");
+    setup();
+
+    uint8_t data[256];
+    uint8_t result = NVM_REQ_NOT_OK;
+    memset(data, 0xA5, sizeof(data));
+
+    TEST_ASSERT(NvM_WriteBlock(WAIT_BLOCK_ID, data) == E_OK, "Write queued");
+    TEST_ASSERT(NvM_WaitJob(WAIT_BLOCK_ID, 0) == E_NOT_OK, "Zero timeout only checks");
+    TEST_ASSERT(NvM_WaitJob(WAIT_BLOCK_ID, 1000) == E_OK, "Wait runs the main function");
+    NvM_GetJobResult(WAIT_BLOCK_ID, &result);
+    TEST_ASSERT(result == NVM_REQ_OK, "Job result OK after wait");
+
+    NvM_JobHandle_t handle;
+    NvM_GetJobHandle(IDLE_BLOCK_ID, &handle);
+    TEST_ASSERT(NvM_WaitJobHandle(&handle, 20) == E_NOT_OK, "Handle without a job times out");
+    TEST_ASSERT(!NvM_JobHandleDone(&handle), "Handle not done");
+    TEST_ASSERT(NvM_WaitJobHandle(NULL, 20) == E_NOT_OK, "NULL handle rejected");
+}
+
+static void test_wait_through_backoff(void) {
+    LOG_INFO("Test: Wait on the NvM Thread Through a Retry Backoff");
+    setup();
+
+    uint8_t data[256];
+    uint8_t result = NVM_REQ_NOT_OK;
+    NvM_Diagnostics_t diag;
+    memset(data, 0x3C, sizeof(data));
+
+    /* The first program fails; the retry waits 50 ms of virtual time */
+    NvM_RetryPolicy_t policy = { .base_delay_ms = 50, .max_delay_ms = 0, .jitter_percent = 0 };
+    NvM_SetRetryPolicy(&policy);
+    FaultInj_Init();
+    FaultConfig_t fault = {
+        .fault_id = FAULT_P0_POWERLOSS_PAGEPROGRAM, .enabled = TRUE,
+        .target_block_id = WAIT_BLOCK_ID, .trigger_count = 1
+    };
+    FaultInj_Configure(&fault);
+
+    uint32_t start_ms = OsScheduler_GetVirtualTimeMs();
+    TEST_ASSERT(NvM_WriteBlock(WAIT_BLOCK_ID, data) == E_OK, "Write queued");
+    TEST_ASSERT(NvM_WaitJob(WAIT_BLOCK_ID, 1000) == E_OK, "Wait completes a job in backoff");
+    NvM_GetJobResult(WAIT_BLOCK_ID, &result);
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(result == NVM_REQ_OK && diag.total_jobs_retried == 1U, "Written on the retry");
+    TEST_ASSERT(OsScheduler_GetVirtualTimeMs() - start_ms >= 50U, "Virtual time ran through the backoff");
+
+    /* A job that cannot finish in time: the timeout counts virtual time */
+    fault.trigger_count = 0;
+    FaultInj_Configure(&fault);
+    policy.base_delay_ms = 500;
+    NvM_SetRetryPolicy(&policy);
+    NvM_WriteBlock(WAIT_BLOCK_ID, data);
+    start_ms = OsScheduler_GetVirtualTimeMs();
+    TEST_ASSERT(NvM_WaitJob(WAIT_BLOCK_ID, 100) == E_NOT_OK, "Wait gives up before the retry");
+    TEST_ASSERT(OsScheduler_GetVirtualTimeMs() - start_ms == 100U, "Timed out after 100 virtual ms");
+
+    FaultInj_Init();
+    NvM_SetRetryPolicy(NULL);
+}
+
+typedef struct {
+    uint8_t data[256];
+    Std_ReturnType submit;
+    Std_ReturnType wait;
+    uint8_t result;
+    volatile int finished;
+} AppRequest_t;
+
+static void *app_thread(void *arg) {
+    AppRequest_t *req = (AppRequest_t *)arg;
+    NvM_JobHandle_t handle;
+
+    NvM_GetJobHandle(WAIT_BLOCK_ID, &handle);
+    req->submit = NvM_WriteBlock(WAIT_BLOCK_ID, req->data);
+    req->wait = NvM_WaitJobHandle(&handle, 5000);
+    NvM_GetJobResult(WAIT_BLOCK_ID, &req->result);
+    __atomic_store_n(&req->finished, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void test_wait_from_other_thread(void) {
+    LOG_INFO("Test: Wait from Another Thread");
+    setup();
+
+    AppRequest_t req;
+    memset(&req, 0, sizeof(req));
+    memset(req.data, 0x3C, sizeof(req.data));
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, app_thread, &req);
+
+    /* NvM thread: main function on its own period, the app thread sleeps meanwhile */
+    for (uint32_t i = 0; i < 5000U && !__atomic_load_n(&req.finished, __ATOMIC_ACQUIRE); i++) {
+        NvM_MainFunction();
+        usleep(1000);
+    }
+    pthread_join(thread, NULL);
+
+    TEST_ASSERT(req.submit == E_OK, "Write submitted through the ring");
+    TEST_ASSERT(req.wait == E_OK, "Waiting thread woken by the job end");
+    TEST_ASSERT(req.result == NVM_REQ_OK, "Job result OK");
+
+    uint8_t readback[256];
+    memset(readback, 0, sizeof(readback));
+    NvM_ReadBlock(WAIT_BLOCK_ID, readback);
+    NvM_WaitJob(WAIT_BLOCK_ID, 1000);
+    TEST_ASSERT(memcmp(readback, req.data, sizeof(readback)) == 0, "Block written");
+}
+
+static void test_event_fd(void) {
+    LOG_INFO("Test: Completion eventfd");
+    setup();
+
+    int fd = NvM_GetEventFd();
+    TEST_ASSERT(fd >= 0, "eventfd created");
+    TEST_ASSERT(NvM_GetEventFd() == fd, "Same descriptor on every call");
+
+    uint64_t count = 0;
+    (void)!read(fd, &count, sizeof(count));   /* Drop completions of earlier tests */
+
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+    TEST_ASSERT(poll(&pfd, 1, 0) == 0, "Not readable while idle");
+
+    uint8_t data[256];
+    memset(data, 0x5A, sizeof(data));
+    NvM_WriteBlock(WAIT_BLOCK_ID, data);
+    NvM_WriteBlock(IDLE_BLOCK_ID, data);
+    NvM_WaitJob(WAIT_BLOCK_ID, 1000);
+    NvM_WaitJob(IDLE_BLOCK_ID, 1000);
+
+    TEST_ASSERT(poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLIN) != 0, "Readable after completions");
+    count = 0;
+    TEST_ASSERT(read(fd, &count, sizeof(count)) == (ssize_t)sizeof(count), "Counter read");
+    TEST_ASSERT(count == 2U, "One count per completed job");
+    TEST_ASSERT(poll(&pfd, 1, 0) == 0, "Read resets the counter");
+}
+
+typedef struct {
+    Std_ReturnType wait;
+    uint8_t result;
+} TimeoutWaiter_t;
+
+static void *timeout_waiter(void *arg) {
+    TimeoutWaiter_t *w = (TimeoutWaiter_t *)arg;
+
+    w->wait = NvM_WaitJob(WAIT_BLOCK_ID, 5000);
+    NvM_GetJobResult(WAIT_BLOCK_ID, &w->result);
+    return NULL;
+}
+
+static void test_timed_out_job(void) {
+    LOG_INFO("Test: Wait on a Job That Times Out");
+    NvM_Init();
+    OsScheduler_Init(16);
+
+    /* Three urgent writers keep the low-priority read queued */
+    static uint8_t urgent[3][64];
+    NvM_BlockConfig_t block = {
+        .block_id = WAIT_BLOCK_ID, .block_size = 256, .block_type = NVM_BLOCK_NATIVE,
+        .crc_type = NVM_CRC16, .priority = 200, .ram_mirror_ptr = g_mirror,
+        .eeprom_offset = 0x0000
+    };
+    NvM_RegisterBlock(&block);
+    for (uint8_t i = 0; i < 3U; i++) {
+        NvM_BlockConfig_t writer = {
+            .block_id = (NvM_BlockIdType)(50U + i), .block_size = 64, .block_type = NVM_BLOCK_NATIVE,
+            .crc_type = NVM_CRC16, .crc_placement = NVM_CRC_PLACEMENT_INLINE, .priority = 1,
+            .ram_mirror_ptr = urgent[i], .eeprom_offset = 0x0400U * (i + 1U)
+        };
+        NvM_RegisterBlock(&writer);
+    }
+
+    /* One job per main function call */
+    NvM_MainFunctionBudget_t budget = { .max_bytes = 1U, .max_cost_us = 0U };
+    NvM_SetMainFunctionBudget(&budget);
+
+    NvM_JobHandle_t handle;
+    NvM_GetJobHandle(WAIT_BLOCK_ID, &handle);
+    TEST_ASSERT(NvM_ReadBlock(WAIT_BLOCK_ID, g_mirror) == E_OK, "Read queued");
+    for (uint8_t i = 0; i < 3U; i++) {
+        NvM_WriteBlock((NvM_BlockIdType)(50U + i), urgent[i]);
+    }
+
+    TimeoutWaiter_t waiter = { .wait = E_NOT_OK, .result = NVM_REQ_PENDING };
+    pthread_t thread;
+    pthread_create(&thread, NULL, timeout_waiter, &waiter);
+
+    int fd = NvM_GetEventFd();
+    uint64_t count = 0;
+
+    /* Past the 2 s read timeout: each check spends one of its 3 retries */
+    OsScheduler_Sleep(2001);
+    for (uint8_t i = 0; i < 3U; i++) {
+        NvM_MainFunction();
+        OsScheduler_Sleep(1);
+    }
+    uint8_t result = NVM_REQ_NOT_OK;
+    NvM_GetJobResult(WAIT_BLOCK_ID, &result);
+    TEST_ASSERT(result == NVM_REQ_PENDING && !NvM_JobHandleDone(&handle), "Read still queued on its retries");
+    (void)!read(fd, &count, sizeof(count));   /* Drop the writers' completions */
+
+    /* Fourth expiry: the read is dropped */
+    NvM_MainFunction();
+    pthread_join(thread, NULL);
+
+    TEST_ASSERT(waiter.wait == E_OK && waiter.result == NVM_REQ_NOT_OK,
+                "Waiting thread woken with NVM_REQ_NOT_OK");
+    TEST_ASSERT(NvM_JobHandleDone(&handle), "Handle done");
+    count = 0;
+    TEST_ASSERT(read(fd, &count, sizeof(count)) == (ssize_t)sizeof(count) && count == 1U,
+                "eventfd counts the dropped job");
+
+    NvM_Diagnostics_t diag;
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(diag.total_jobs_failed == 1U, "Counted as a failed job");
+    NvM_SetMainFunctionBudget(NULL);
+}
+
+int main(void) {
+    LOG_INFO("========================================");
+    LOG_INFO("  Integration Test: Job Wait");
+    LOG_INFO("========================================");
+    LOG_INFO("");
+
+    test_wait_on_nvm_thread();
+    LOG_INFO("");
+    test_wait_through_backoff();
+    LOG_INFO("");
+    test_wait_from_other_thread();
+    LOG_INFO("");
+    test_event_fd();
+    LOG_INFO("");
+    test_timed_out_job();
+
+    LOG_INFO("");
+    LOG_INFO("========================================");
+    LOG_INFO("  Passed: %u, Failed: %u", tests_passed, tests_failed);
+    LOG_INFO("========================================");
+
+    return tests_failed == 0 ? 0 : 1;
+}
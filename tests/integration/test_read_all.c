@@ -4,6 +4,8 @@
  */
 
 #include "nvm.h"
+#include "memif.h"
+#include "eeprom_driver.h"
 #include "os_scheduler.h"
 #include "logging.h"
 #include <stdio.h>
@@ -25,9 +27,9 @@ static void test_read_all_multiple_blocks(void) {
     OsScheduler_Init(16);
     
     static uint8_t data1[256], data2[256], data3[256];
-    static const uint8_t rom1[256] = { ['A'] = 1, [1 ... 255] = 0xFF };
-    static const uint8_t rom2[256] = { ['B'] = 2, [1 ... 255] = 0xFF };
-    static const uint8_t rom3[256] = { ['C'] = 3, [1 ... 255] = 0xFF };
+    static const uint8_t rom1[256] = { [0] = 'A', [1 ... 255] = 0xFF };
+    static const uint8_t rom2[256] = { [0] = 'B', [1 ... 255] = 0xFF };
+    static const uint8_t rom3[256] = { [0] = 'C', [1 ... 255] = 0xFF };
     
     NvM_BlockConfig_t block1 = {
         .block_id = 1, .block_size = 256, .block_type = NVM_BLOCK_NATIVE,
@@ -76,6 +78,264 @@ static void test_read_all_multiple_blocks(void) {
     LOG_INFO("  Result: Passed");
 }
 
+static void test_read_all_pipelined(void) {
+    LOG_INFO("Test: Pipelined ReadAll across devices");
+
+    NvM_Init();
+    OsScheduler_Init(16);
+
+    MemIf_DeviceConfig_t ram = {
+        .type = MEMIF_DEVICE_RAM, .base_address = 0x10000, .size_bytes = 4096,
+        .page_size = 16, .block_size = 1024,
+        .read_delay_us = 0, .write_delay_ms = 0, .erase_delay_ms = 0
+    };
+    TEST_ASSERT(MemIf_AddDevice(&ram, NULL) == E_OK, "RAM device added");
+
+    /* Registered out of offset order; slot 4 is on the RAM device, slot 5 never written */
+    static uint8_t data[5][256];
+    static const uint8_t rom5[256] = { [0] = 'R', [1 ... 255] = 0x5A };
+    const uint32_t offsets[5] = { 0x0800, 0x0000, 0x0400, 0x10000, 0x0C00 };
+    for (uint8_t i = 0; i < 5; i++) {
+        NvM_BlockConfig_t block = {
+            .block_id = (uint8_t)(30 + i), .block_size = 256, .block_type = NVM_BLOCK_NATIVE,
+            .crc_type = NVM_CRC16, .priority = 10, .is_immediate = FALSE,
+            .is_write_protected = FALSE, .ram_mirror_ptr = data[i],
+            .rom_block_ptr = (i == 4) ? rom5 : NULL, .rom_block_size = (i == 4) ? sizeof(rom5) : 0,
+            .eeprom_offset = offsets[i]
+        };
+        NvM_RegisterBlock(&block);
+    }
+
+    for (uint8_t i = 0; i < 4; i++) {
+        memset(data[i], 0xA0 + i, sizeof(data[i]));
+        NvM_WriteBlock((uint8_t)(30 + i), data[i]);
+    }
+    NvM_MainFunction();
+    for (uint8_t i = 0; i < 5; i++) {
+        memset(data[i], 0, sizeof(data[i]));
+    }
+
+    NvM_SetReadAllPipeline(TRUE);
+    NvM_ReadAll();
+
+    uint32_t done_at[5] = { 0 };
+    uint32_t start_ms = OsScheduler_GetVirtualTimeMs();
+    uint32_t remaining = 5;
+    for (uint32_t iter = 1; iter < 500 && remaining > 0; iter++) {
+        NvM_MainFunction();
+        for (uint8_t i = 0; i < 5; i++) {
+            uint8_t result;
+            NvM_GetJobResult((uint8_t)(30 + i), &result);
+            if (done_at[i] == 0 && result != NVM_REQ_PENDING) {
+                done_at[i] = OsScheduler_GetVirtualTimeMs() - start_ms + 1;
+                remaining--;
+            }
+        }
+        OsScheduler_Sleep(1);
+    }
+
+    uint8_t result;
+    TEST_ASSERT(remaining == 0, "All blocks completed");
+    TEST_ASSERT(done_at[1] < done_at[2] && done_at[2] < done_at[0] && done_at[0] < done_at[4],
+                "EEPROM blocks completed in ascending offset order");
+    TEST_ASSERT(done_at[3] < done_at[1], "RAM device block loaded in parallel");
+    for (uint8_t i = 0; i < 4; i++) {
+        NvM_GetJobResult((uint8_t)(30 + i), &result);
+        TEST_ASSERT(result == NVM_REQ_OK && data[i][0] == 0xA0 + i && data[i][255] == 0xA0 + i,
+                    "RAM mirror populated from device");
+    }
+    NvM_GetJobResult(34, &result);
+    TEST_ASSERT(result == NVM_REQ_NOT_OK && data[4][0] == 'R', "Invalid block recovered from ROM");
+
+    NvM_Diagnostics_t diag;
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(diag.total_jobs_processed == 5, "ReadAll completed once");
+
+    LOG_INFO("  Load time: %u ms", done_at[4]);
+    LOG_INFO("  Result: Passed");
+}
+
+/**
+ * @brief Simulate a reset: keep the device image, re-initialize NvM and re-register
+ */
+static void reboot(uint8_t *image, NvM_BlockConfig_t *blocks, uint8_t count) {
+    MemIf_Read(0, image, 4096);
+    NvM_Init();
+    OsScheduler_Init(16);
+    MemIf_Write(0, image, 4096);
+    for (uint8_t i = 0; i < count; i++) {
+        NvM_RegisterBlock(&blocks[i]);
+    }
+    NvM_SetCheckpointRegion(0x0C00);
+}
+
+/**
+ * @brief Run a multi-block request to completion (no MainFunction budget is set)
+ */
+static void run_all(Std_ReturnType (*request)(void)) {
+    request();
+    NvM_MainFunction();
+}
+
+static void test_read_all_checkpoint(void) {
+    LOG_INFO("Test: ReadAll from a clean-shutdown checkpoint");
+
+    static uint8_t image[4096];
+    static uint8_t native[512], redundant[256];
+    NvM_BlockConfig_t blocks[2] = {
+        {
+            .block_id = 40, .block_size = sizeof(native), .block_type = NVM_BLOCK_NATIVE,
+            .crc_type = NVM_CRC32, .priority = 10, .is_immediate = FALSE,
+            .is_write_protected = FALSE, .ram_mirror_ptr = native,
+            .rom_block_ptr = NULL, .rom_block_size = 0, .eeprom_offset = 0x0000
+        },
+        {
+            .block_id = 41, .block_size = sizeof(redundant), .block_type = NVM_BLOCK_REDUNDANT,
+            .crc_type = NVM_CRC16, .priority = 10, .is_immediate = FALSE,
+            .is_write_protected = FALSE, .ram_mirror_ptr = redundant,
+            .rom_block_ptr = NULL, .rom_block_size = 0, .eeprom_offset = 0x0400,
+            .redundant_eeprom_offset = 0x0800
+        }
+    };
+
+    NvM_Init();
+    OsScheduler_Init(16);
+    NvM_RegisterBlock(&blocks[0]);
+    NvM_RegisterBlock(&blocks[1]);
+    TEST_ASSERT(NvM_SetCheckpointRegion(0x0C00) == E_OK, "Checkpoint region set");
+    TEST_ASSERT(NvM_SetCheckpointRegion(0x0C10) != E_OK, "Unaligned region rejected");
+    NvM_SetCheckpointRegion(0x0C00);
+
+    memset(native, 0x5A, sizeof(native));
+    memset(redundant, 0xC3, sizeof(redundant));
+    run_all(NvM_WriteAll);
+    NvM_Diagnostics_t diag;
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(diag.checkpoint_writes == 1, "WriteAll recorded the checkpoint");
+
+    /* Full scan reference: no checkpoint region configured */
+    Eeprom_DiagInfoType d0, d1;
+    MemIf_Read(0, image, 4096);
+    NvM_Init();
+    OsScheduler_Init(16);
+    MemIf_Write(0, image, 4096);
+    NvM_RegisterBlock(&blocks[0]);
+    NvM_RegisterBlock(&blocks[1]);
+    memset(native, 0, sizeof(native));
+    memset(redundant, 0, sizeof(redundant));
+    Eep_GetDiagnostics(&d0);
+    run_all(NvM_ReadAll);
+    Eep_GetDiagnostics(&d1);
+    uint32_t full_bytes = d1.total_bytes_read - d0.total_bytes_read;
+    TEST_ASSERT(native[0] == 0x5A && redundant[255] == 0xC3, "Full scan loads the blocks");
+
+    reboot(image, blocks, 2);
+    memset(native, 0, sizeof(native));
+    memset(redundant, 0, sizeof(redundant));
+    Eep_GetDiagnostics(&d0);
+    run_all(NvM_ReadAll);
+    Eep_GetDiagnostics(&d1);
+    uint8_t r40, r41;
+    NvM_GetJobResult(40, &r40);
+    NvM_GetJobResult(41, &r41);
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(r40 == NVM_REQ_OK && r41 == NVM_REQ_OK, "Fast mount completed");
+    TEST_ASSERT(native[0] == 0x5A && native[511] == 0x5A && redundant[0] == 0xC3,
+                "Fast mount loads the blocks");
+    TEST_ASSERT(diag.fast_mount_blocks == 2, "Both blocks loaded from the checkpoint");
+    TEST_ASSERT(d1.total_read_count - d0.total_read_count == 1, "Both blocks in one vectored read");
+    TEST_ASSERT(d1.total_bytes_read - d0.total_bytes_read == sizeof(native) + sizeof(redundant) &&
+                d1.total_bytes_read - d0.total_bytes_read < full_bytes, "Only the data bytes read");
+
+    /* A write after the checkpoint makes the next mount a full scan */
+    memset(native, 0x11, sizeof(native));
+    NvM_WriteBlock(40, native);
+    NvM_MainFunction();
+    reboot(image, blocks, 2);
+    memset(native, 0, sizeof(native));
+    run_all(NvM_ReadAll);
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(diag.fast_mount_blocks == 0, "Stale checkpoint ignored");
+    TEST_ASSERT(native[0] == 0x11 && redundant[0] == 0xC3, "Full scan loads the new data");
+
+    /* The next WriteAll makes it clean again */
+    run_all(NvM_WriteAll);
+    reboot(image, blocks, 2);
+    memset(native, 0, sizeof(native));
+    run_all(NvM_ReadAll);
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(diag.fast_mount_blocks == 2 && native[0] == 0x11, "Checkpoint clean after WriteAll");
+
+    LOG_INFO("  Result: Passed");
+}
+
+static void test_read_block_cache(void) {
+    LOG_INFO("Test: ReadBlock served from a matching RAM mirror");
+
+    static uint8_t image[4096];
+    static uint8_t cached[256], plain[256], buf[256];
+    NvM_BlockConfig_t blocks[2] = {
+        {
+            .block_id = 50, .block_size = sizeof(cached), .block_type = NVM_BLOCK_NATIVE,
+            .crc_type = NVM_CRC16, .priority = 10, .read_cache = TRUE,
+            .ram_mirror_ptr = cached, .eeprom_offset = 0x0000
+        },
+        {
+            .block_id = 51, .block_size = sizeof(plain), .block_type = NVM_BLOCK_NATIVE,
+            .crc_type = NVM_CRC16, .priority = 10, .read_cache = FALSE,
+            .ram_mirror_ptr = plain, .eeprom_offset = 0x0400
+        }
+    };
+
+    NvM_Init();
+    OsScheduler_Init(16);
+    NvM_RegisterBlock(&blocks[0]);
+    NvM_RegisterBlock(&blocks[1]);
+    memset(cached, 0x3C, sizeof(cached));
+    memset(plain, 0x4D, sizeof(plain));
+    run_all(NvM_WriteAll);
+
+    reboot(image, blocks, 2);
+    run_all(NvM_ReadAll);
+
+    Eeprom_DiagInfoType d0, d1;
+    NvM_Diagnostics_t diag;
+    uint8_t result = NVM_REQ_PENDING;
+    Eep_GetDiagnostics(&d0);
+    memset(buf, 0, sizeof(buf));
+    TEST_ASSERT(NvM_ReadBlock(50, buf) == E_OK, "Cached read accepted");
+    NvM_GetJobResult(50, &result);
+    Eep_GetDiagnostics(&d1);
+    TEST_ASSERT(result == NVM_REQ_OK && buf[0] == 0x3C && buf[255] == 0x3C,
+                "Read completed synchronously from the mirror");
+    TEST_ASSERT(d1.total_read_count == d0.total_read_count, "No device read");
+
+    NvM_ReadBlock(51, buf);
+    NvM_GetJobResult(51, &result);
+    TEST_ASSERT(result == NVM_REQ_PENDING, "Block without read_cache queues a job");
+    NvM_MainFunction();
+
+    /* A store into the mirror: the device copy no longer matches */
+    ((uint8_t *)NvM_GetWritableBlockData(50))[7] ^= 0xFF;
+    NvM_ReadBlock(50, buf);
+    NvM_GetJobResult(50, &result);
+    TEST_ASSERT(result == NVM_REQ_PENDING, "Changed mirror: read goes to the device");
+    NvM_MainFunction();
+    TEST_ASSERT(buf[7] == 0x3C, "Device copy returned");
+
+    /* Writing the mirror makes it match again */
+    NvM_WriteBlock(50, cached);
+    NvM_MainFunction();
+    NvM_ReadBlock(50, buf);
+    NvM_GetJobResult(50, &result);
+    TEST_ASSERT(result == NVM_REQ_OK && buf[7] == (uint8_t)(0x3C ^ 0xFF), "Hit after the write");
+
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(diag.read_cache_hits == 2 && diag.read_cache_misses == 1, "Hits and misses counted");
+
+    LOG_INFO("  Result: Passed");
+}
+
 int main(void) {
     LOG_INFO("========================================");
     LOG_INFO("  Integration Test: ReadAll");
@@ -83,6 +343,12 @@ int main(void) {
     LOG_INFO("");
     
     test_read_all_multiple_blocks();
+    LOG_INFO("");
+    test_read_all_pipelined();
+    LOG_INFO("");
+    test_read_all_checkpoint();
+    LOG_INFO("");
+    test_read_block_cache();
     
     LOG_INFO("");
     LOG_INFO("========================================");
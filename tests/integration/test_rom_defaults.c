@@ -0,0 +1,236 @@
+/**
+ * @file test_rom_defaults.c
+ * @brief Integration Test: ROM Default Binding and First-Boot Default Writing
+ */
+
+#include "nvm.h"
+#include "eeprom_driver.h"
+#include "memif.h"
+#include "os_scheduler.h"
+#include "logging.h"
+#include "metrics.h"
+#include <stdio.h>
+#include <string.h>
+
+static uint32_t tests_passed = 0;
+static uint32_t tests_failed = 0;
+
+#define TEST_ASSERT(cond, msg) \
+    do { \
+        if (cond) { tests_passed++; LOG_INFO("  ✓ %s", msg); } \
+        else { tests_failed++; LOG_ERROR("  ✗ %s", msg); } \
+    } while(0)
+
+static const Eeprom_ConfigType g_device = {
+    .capacity_bytes = 8192, .page_size = 256, .block_size = 1024,
+    .read_delay_us = 50, .write_delay_ms = 2, .erase_delay_ms = 3,
+    .endurance_cycles = 100000
+};
+
+static uint8_t g_rom_native[128];
+static uint8_t g_rom_calib[64];
+static uint8_t g_rom_dataset[32];
+static uint8_t g_rom_short[8];
+
+static uint8_t g_native_mirror[128];
+static uint8_t g_calib_mirror[64];
+static uint8_t g_dataset_mirror[32];
+static uint8_t g_copied_mirror[32];
+static uint8_t g_short_mirror[32];
+
+static void setup(void)
+{
+    NvM_Init();
+    Eep_Init(&g_device);
+    OsScheduler_Init(16);
+
+    memset(g_rom_native, 0x5A, sizeof(g_rom_native));
+    for (uint32_t i = 0; i < sizeof(g_rom_calib); i++) {
+        g_rom_calib[i] = (uint8_t)(i * 3U);
+    }
+    memset(g_rom_dataset, 0xC3, sizeof(g_rom_dataset));
+    memset(g_rom_short, 0x11, sizeof(g_rom_short));
+
+    NvM_BlockConfig_t native = {
+        .block_id = 1, .block_size = 128, .block_type = NVM_BLOCK_NATIVE, .crc_type = NVM_CRC16,
+        .crc_placement = NVM_CRC_PLACEMENT_INLINE, .ram_mirror_ptr = g_native_mirror, .rom_block_ptr = g_rom_native,
+        .rom_block_size = sizeof(g_rom_native), .rom_binding = TRUE, .eeprom_offset = 0x0000
+    };
+    NvM_BlockConfig_t calib = {
+        .block_id = 2, .block_size = 64, .block_type = NVM_BLOCK_REDUNDANT, .crc_type = NVM_CRC32,
+        .crc_placement = NVM_CRC_PLACEMENT_INLINE, .ram_mirror_ptr = g_calib_mirror,
+        .rom_block_ptr = g_rom_calib, .rom_block_size = sizeof(g_rom_calib), .rom_binding = TRUE,
+        .eeprom_offset = 0x0400, .redundant_eeprom_offset = 0x0800
+    };
+    NvM_BlockConfig_t dataset = {
+        .block_id = 3, .block_size = 32, .block_type = NVM_BLOCK_DATASET, .crc_type = NVM_CRC16,
+        .crc_placement = NVM_CRC_PLACEMENT_INLINE, .ram_mirror_ptr = g_dataset_mirror,
+        .rom_block_ptr = g_rom_dataset, .rom_block_size = sizeof(g_rom_dataset), .rom_binding = TRUE,
+        .eeprom_offset = 0x0C00, .dataset_count = 2
+    };
+    /* Without binding, and with a default shorter than the block: copied as before */
+    NvM_BlockConfig_t copied = {
+        .block_id = 4, .block_size = 32, .block_type = NVM_BLOCK_NATIVE, .crc_type = NVM_CRC16,
+        .crc_placement = NVM_CRC_PLACEMENT_INLINE, .ram_mirror_ptr = g_copied_mirror,
+        .rom_block_ptr = g_rom_dataset, .rom_block_size = sizeof(g_rom_dataset),
+        .eeprom_offset = 0x1400
+    };
+    NvM_BlockConfig_t shorter = {
+        .block_id = 5, .block_size = 32, .block_type = NVM_BLOCK_NATIVE, .crc_type = NVM_CRC16,
+        .crc_placement = NVM_CRC_PLACEMENT_INLINE, .ram_mirror_ptr = g_short_mirror,
+        .rom_block_ptr = g_rom_short, .rom_block_size = sizeof(g_rom_short), .rom_binding = TRUE,
+        .eeprom_offset = 0x1800
+    };
+    NvM_RegisterBlock(&native);
+    NvM_RegisterBlock(&calib);
+    NvM_RegisterBlock(&dataset);
+    NvM_RegisterBlock(&copied);
+    NvM_RegisterBlock(&shorter);
+}
+
+/**
+ * @brief Run a request to completion (no MainFunction budget is set)
+ */
+static void run_all(Std_ReturnType (*request)(void))
+{
+    request();
+    NvM_MainFunction();
+}
+
+static void test_blank_device_binds(void)
+{
+    LOG_INFO("Test: Blank Device Binds Instead of Copying");
+    NvM_Diagnostics_t diag;
+
+    setup();
+    run_all(NvM_ReadAll);
+
+    TEST_ASSERT(NvM_GetBlockData(1) == g_rom_native && NvM_GetBlockData(2) == g_rom_calib &&
+                NvM_GetBlockData(3) == g_rom_dataset, "Bound blocks read from ROM");
+    TEST_ASSERT(memcmp(g_native_mirror, g_rom_native, sizeof(g_rom_native)) != 0 &&
+                memcmp(g_calib_mirror, g_rom_calib, sizeof(g_rom_calib)) != 0 &&
+                memcmp(g_dataset_mirror, g_rom_dataset, sizeof(g_rom_dataset)) != 0,
+                "Bound mirrors not copied");
+    TEST_ASSERT(NvM_GetBlockData(4) == g_copied_mirror && g_copied_mirror[0] == 0xC3,
+                "Block without binding copied");
+    TEST_ASSERT(NvM_GetBlockData(5) == g_short_mirror && g_short_mirror[0] == 0x11 &&
+                g_short_mirror[7] == 0x11, "Short default copied");
+    TEST_ASSERT(NvM_GetBlockData(9) == NULL, "Unknown block has no data");
+
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(diag.rom_bound_blocks == 3U, "Three blocks bound");
+}
+
+static void test_write_defaults(void)
+{
+    LOG_INFO("Test: First-Boot Defaults Written in One Pass");
+    Eeprom_DiagInfoType before, after;
+    NvM_Diagnostics_t diag;
+
+    Eep_GetDiagnostics(&before);
+    TEST_ASSERT(NvM_WriteRomDefaults() == E_OK, "Defaults written");
+    Eep_GetDiagnostics(&after);
+
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(diag.rom_defaults_written == 3U, "Three bound blocks written");
+    TEST_ASSERT(after.total_erase_count == before.total_erase_count &&
+                diag.rom_default_erases_skipped == 4U, "Blank units not erased");
+    TEST_ASSERT(g_native_mirror[0] != 0x5A && diag.rom_bound_blocks == 3U,
+                "Written from ROM, mirrors still not copied");
+
+    static char text[16384];
+    (void)Metrics_Export(METRICS_FORMAT_PROMETHEUS, text, sizeof(text));
+    TEST_ASSERT(strstr(text, "eepromsim_nvm_rom_defaults_written 3\n") != NULL &&
+                strstr(text, "eepromsim_nvm_rom_default_erases_skipped 4\n") != NULL &&
+                strstr(text, "eepromsim_nvm_rom_bound_blocks 3\n") != NULL,
+                "ROM default counters exported");
+
+    /* Written blocks are clean: WriteAll only writes the two copied defaults */
+    uint32_t skipped = diag.writeall_skipped_blocks;
+    run_all(NvM_WriteAll);
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(diag.writeall_skipped_blocks - skipped == 3U, "WriteAll skips the written blocks");
+
+    /* Copy-on-write */
+    uint8_t *mirror = (uint8_t *)NvM_GetWritableBlockData(1);
+    TEST_ASSERT(mirror == g_native_mirror && memcmp(mirror, g_rom_native, sizeof(g_rom_native)) == 0,
+                "Mirror materialized from ROM");
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(diag.rom_defaults_materialized == 1U && diag.rom_bound_blocks == 2U &&
+                NvM_GetBlockData(1) == g_native_mirror, "Binding ended");
+
+    mirror[0] = 0x01;
+    NvM_WriteBlock(1, mirror);
+    NvM_MainFunction();
+
+    /* The next boot finds every block on the device */
+    memset(g_calib_mirror, 0, sizeof(g_calib_mirror));
+    memset(g_dataset_mirror, 0, sizeof(g_dataset_mirror));
+    run_all(NvM_ReadAll);
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(diag.rom_bound_blocks == 0U, "Nothing bound after reboot");
+    TEST_ASSERT(memcmp(g_calib_mirror, g_rom_calib, sizeof(g_rom_calib)) == 0 &&
+                memcmp(g_dataset_mirror, g_rom_dataset, sizeof(g_rom_dataset)) == 0,
+                "Defaults read back from the device");
+    TEST_ASSERT(g_native_mirror[0] == 0x01 && g_native_mirror[1] == 0x5A, "Application write kept");
+}
+
+static void test_corrupt_block_rebinds(void)
+{
+    LOG_INFO("Test: Corrupt Block Rebinds and Is Rewritten");
+    Eeprom_DiagInfoType before, after;
+    uint8_t garbage[256];
+    uint8_t result = NVM_REQ_OK;
+
+    /* Scribble over the primary and backup of block 2 */
+    memset(garbage, 0x00, sizeof(garbage));
+    MemIf_Erase(0x0400, 1024);
+    MemIf_Write(0x0400, garbage, sizeof(garbage));
+    MemIf_Erase(0x0800, 1024);
+    MemIf_Write(0x0800, garbage, sizeof(garbage));
+
+    NvM_ReadBlock(2, g_calib_mirror);
+    NvM_MainFunction();
+    NvM_GetJobResult(2, &result);
+    TEST_ASSERT(result == NVM_REQ_NOT_OK && NvM_GetBlockData(2) == g_rom_calib,
+                "Failed read into the mirror binds");
+
+    /* Into another buffer the default is copied */
+    uint8_t copy[64];
+    NvM_ReadBlock(2, copy);
+    NvM_MainFunction();
+    TEST_ASSERT(memcmp(copy, g_rom_calib, sizeof(copy)) == 0, "Private buffer gets a copy");
+
+    Eep_GetDiagnostics(&before);
+    TEST_ASSERT(NvM_WriteRomDefaults() == E_OK, "Defaults written again");
+    Eep_GetDiagnostics(&after);
+    TEST_ASSERT(after.total_erase_count - before.total_erase_count == 2U,
+                "Only the two written units erased");
+
+    NvM_ReadBlock(2, g_calib_mirror);
+    NvM_MainFunction();
+    NvM_GetJobResult(2, &result);
+    TEST_ASSERT(result == NVM_REQ_OK && memcmp(g_calib_mirror, g_rom_calib, sizeof(g_rom_calib)) == 0,
+                "Block valid with its default");
+    TEST_ASSERT(NvM_WriteRomDefaults() == E_OK, "Nothing bound: no-op");
+}
+
+int main(void) {
+    LOG_INFO("========================================");
+    LOG_INFO("  Integration Test: ROM Default Binding");
+    LOG_INFO("========================================");
+    LOG_INFO("");
+
+    test_blank_device_binds();
+    LOG_INFO("");
+    test_write_defaults();
+    LOG_INFO("");
+    test_corrupt_block_rebinds();
+
+    LOG_INFO("");
+    LOG_INFO("========================================");
+    LOG_INFO("  Passed: %u, Failed: %u", tests_passed, tests_failed);
+    LOG_INFO("========================================");
+
+    return tests_failed == 0 ? 0 : 1;
+}
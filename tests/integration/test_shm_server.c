@@ -0,0 +1,278 @@
+/**
+ * @file test_shm_server.c
+ * @brief Integration Test: Shared-Memory NvM Server with Client Processes (nvm_shm.h)
+ */
+
+#define _GNU_SOURCE
+
+#include "nvm.h"
+#include "nvm_shm.h"
+#include "eeprom_driver.h"
+#include "os_scheduler.h"
+#include "logging.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static uint32_t tests_passed = 0;
+static uint32_t tests_failed = 0;
+
+#define TEST_ASSERT(cond, msg) \
+    do { \
+        if (cond) { tests_passed++; LOG_INFO("  ✓ %s", msg); } \
+        else { tests_failed++; LOG_ERROR("  ✗ %s", msg); } \
+    } while(0)
+
+#define SHM_NAME    "/eepsim_test_shm"
+#define DEVICE_PATH "/dev/shm" SHM_NAME ".eep"
+
+static const Eeprom_ConfigType g_device = {
+    .capacity_bytes = 8192, .page_size = 256, .block_size = 1024,
+    .read_delay_us = 50, .write_delay_ms = 2, .erase_delay_ms = 3,
+    .endurance_cycles = 100000
+};
+
+static uint8_t g_mirror_a[256];
+static uint8_t g_mirror_b[64];
+static uint8_t g_mirror_local[32];
+
+static void setup_server(void)
+{
+    NvM_Init();
+    OsScheduler_Init(16);
+
+    NvM_BlockConfig_t a = {
+        .block_id = 1, .block_size = 256, .block_type = NVM_BLOCK_NATIVE,
+        .crc_type = NVM_CRC16, .ram_mirror_ptr = g_mirror_a, .eeprom_offset = 0x0000
+    };
+    NvM_BlockConfig_t b = {
+        .block_id = 2, .block_size = 64, .block_type = NVM_BLOCK_REDUNDANT,
+        .crc_type = NVM_CRC32, .crc_placement = NVM_CRC_PLACEMENT_INLINE,
+        .ram_mirror_ptr = g_mirror_b, .eeprom_offset = 0x0400, .redundant_eeprom_offset = 0x0800
+    };
+    NvM_RegisterBlock(&a);
+    NvM_RegisterBlock(&b);
+}
+
+/**
+ * @brief Serve requests until the child exits
+ *
+ * @return Child exit status (failed checks), or 255 if it did not exit normally
+ */
+static int serve_child(pid_t child)
+{
+    int status = 0;
+
+    for (;;) {
+        (void)NvM_ShmServer_Poll();
+        NvM_MainFunction();
+        if (waitpid(child, &status, WNOHANG) == child) {
+            return WIFEXITED(status) ? WEXITSTATUS(status) : 255;
+        }
+        usleep(100);
+    }
+}
+
+/**
+ * @brief Client process: write block 1, read it back, write block 2
+ */
+static int client_round_trip(void)
+{
+    NvM_ShmClient_t client;
+    uint8_t data[256];
+    uint8_t back[256];
+    uint8_t small[64];
+    int failures = 0;
+
+    if (NvM_ShmClient_Connect(&client, SHM_NAME) != E_OK) {
+        return 100;
+    }
+
+    memset(data, 0x3C, sizeof(data));
+    failures += (NvM_ShmClient_WriteBlock(&client, 1, data, 5000) == E_OK) ? 0 : 1;
+    memset(back, 0, sizeof(back));
+    failures += (NvM_ShmClient_ReadBlock(&client, 1, back, 5000) == E_OK) ? 0 : 1;
+    failures += (memcmp(back, data, sizeof(data)) == 0) ? 0 : 1;
+
+    /* Zero-copy: fill the payload in place, submit, wait */
+    uint16_t size = 0U;
+    uint8_t *payload = NvM_ShmClient_Acquire(&client, 2, &size);
+    NvM_JobHandle_t handle;
+    uint8_t result = NVM_REQ_NOT_OK;
+    failures += (payload != NULL && size == sizeof(small)) ? 0 : 1;
+    if (payload != NULL) {
+        memset(payload, 0x77, size);
+        failures += (NvM_ShmClient_Submit(&client, 2, NVM_SHM_OP_WRITE, &handle) == E_OK) ? 0 : 1;
+        /* One request per block at a time */
+        failures += (NvM_ShmClient_Submit(&client, 2, NVM_SHM_OP_READ, &handle) == E_NOT_OK) ? 0 : 1;
+        failures += (NvM_ShmClient_Wait(&client, &handle, 5000, &result) == E_OK &&
+                     result == NVM_REQ_OK) ? 0 : 1;
+        NvM_ShmClient_Release(&client, 2);
+    }
+
+    uint8_t state = 0U;
+    failures += (NvM_ShmClient_GetBlockState(&client, 2, &state) == E_OK &&
+                 state == NVM_BLOCKSTATE_VALID) ? 0 : 1;
+    failures += (NvM_ShmClient_ReadBlock(&client, 9, small, 100) == E_NOT_OK) ? 0 : 1;
+
+    /* The device image is visible without a request */
+    failures += (client.device != NULL && client.device_size == g_device.capacity_bytes &&
+                 client.device[0x0000] == 0x3C && client.device[0x0400] == 0x77 &&
+                 client.device[0x0800] == 0x77) ? 0 : 1;
+
+    NvM_ShmClient_Disconnect(&client);
+    return failures;
+}
+
+static void test_round_trip(void)
+{
+    LOG_INFO("Test: Client Process Round Trip");
+
+    NvM_ShmServerConfig_t config = { .name = SHM_NAME, .device = &g_device };
+    NvM_ShmServerStats_t stats;
+
+    setup_server();
+    TEST_ASSERT(NvM_ShmServer_Start(&config) == E_OK, "Server started");
+    TEST_ASSERT(NvM_ShmServer_Start(&config) == E_NOT_OK, "Second start refused");
+
+    pid_t child = fork();
+    if (child == 0) {
+        _exit(client_round_trip());
+    }
+    int failures = serve_child(child);
+    TEST_ASSERT(failures == 0, "Client checks passed");
+
+    TEST_ASSERT(NvM_ShmServer_GetStats(&stats) == E_OK && stats.blocks == 2U &&
+                stats.requests == 3U && stats.rejected == 0U, "Three requests served");
+
+    /* The server's own NvM sees the client's data */
+    uint8_t data[256];
+    uint8_t result = NVM_REQ_NOT_OK;
+    NvM_ReadBlock(1, data);
+    NvM_WaitJob(1, 1000);
+    NvM_GetJobResult(1, &result);
+    TEST_ASSERT(result == NVM_REQ_OK && data[0] == 0x3C && data[255] == 0x3C,
+                "Client write persisted");
+}
+
+/**
+ * @brief Two processes contending for one block
+ */
+static int client_contend(uint8_t fill)
+{
+    NvM_ShmClient_t client;
+    uint8_t data[64];
+    int written = 0;
+
+    if (NvM_ShmClient_Connect(&client, SHM_NAME) != E_OK) {
+        return 100;
+    }
+    memset(data, fill, sizeof(data));
+    for (int i = 0; i < 20; i++) {
+        /* Acquire fails while the other process owns the block */
+        while (NvM_ShmClient_WriteBlock(&client, 2, data, 5000) != E_OK) {
+            usleep(50);
+        }
+        written++;
+    }
+    NvM_ShmClient_Disconnect(&client);
+    return (written == 20) ? 0 : 1;
+}
+
+static void test_contention(void)
+{
+    LOG_INFO("Test: Two Clients, One Block");
+
+    pid_t first = fork();
+    if (first == 0) {
+        _exit(client_contend(0x11));
+    }
+    pid_t second = fork();
+    if (second == 0) {
+        _exit(client_contend(0x22));
+    }
+
+    int status = 0;
+    int failures = 0;
+    uint32_t running = 2U;
+    while (running > 0U) {
+        (void)NvM_ShmServer_Poll();
+        NvM_MainFunction();
+        pid_t pid = waitpid(-1, &status, WNOHANG);
+        if (pid == first || pid == second) {
+            failures += WIFEXITED(status) ? WEXITSTATUS(status) : 255;
+            running--;
+        }
+        usleep(100);
+    }
+    TEST_ASSERT(failures == 0, "Every write of both clients completed");
+
+    uint8_t data[64];
+    NvM_ReadBlock(2, data);
+    NvM_WaitJob(2, 1000);
+    TEST_ASSERT(data[0] == data[63] && (data[0] == 0x11 || data[0] == 0x22),
+                "Block holds one client's complete write");
+}
+
+static void test_takeover_and_stop(void)
+{
+    LOG_INFO("Test: Exited Owner and Server Stop");
+
+    /* A client exits while holding a block */
+    pid_t child = fork();
+    if (child == 0) {
+        NvM_ShmClient_t client;
+        _exit((NvM_ShmClient_Connect(&client, SHM_NAME) == E_OK &&
+               NvM_ShmClient_Acquire(&client, 1, NULL) != NULL) ? 0 : 1);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    TEST_ASSERT(WIFEXITED(status) && WEXITSTATUS(status) == 0, "Child left block 1 acquired");
+
+    NvM_ShmClient_t client;
+    TEST_ASSERT(NvM_ShmClient_Connect(&client, SHM_NAME) == E_OK, "Server process connects as a client");
+    TEST_ASSERT(NvM_ShmClient_Acquire(&client, 1, NULL) != NULL, "Block of the exited owner taken over");
+    NvM_ShmClient_Release(&client, 1);
+
+    /* Only blocks registered before the start are published */
+    NvM_BlockConfig_t local = {
+        .block_id = 5, .block_size = 32, .block_type = NVM_BLOCK_NATIVE,
+        .crc_type = NVM_CRC16, .ram_mirror_ptr = g_mirror_local, .eeprom_offset = 0x0C00
+    };
+    NvM_RegisterBlock(&local);
+    TEST_ASSERT(NvM_ShmClient_Acquire(&client, 5, NULL) == NULL, "Block registered after start not served");
+
+    NvM_ShmServer_Stop();
+    TEST_ASSERT(NvM_ShmClient_Acquire(&client, 1, NULL) == NULL, "Stopped server refuses acquire");
+    NvM_ShmClient_Disconnect(&client);
+    TEST_ASSERT(NvM_ShmClient_Connect(&client, SHM_NAME) == E_NOT_OK, "Object name removed");
+
+    NvM_ShmServerConfig_t bad = { .name = "no-slash", .device = NULL };
+    TEST_ASSERT(NvM_ShmServer_Start(&bad) == E_NOT_OK, "Invalid name refused");
+    Eep_Destroy();
+    remove(DEVICE_PATH);
+    remove(DEVICE_PATH ".wear");
+}
+
+int main(void) {
+    LOG_INFO("========================================");
+    LOG_INFO("  Integration Test: Shared-Memory Server");
+    LOG_INFO("========================================");
+    LOG_INFO("");
+
+    remove(DEVICE_PATH);
+    remove(DEVICE_PATH ".wear");
+    test_round_trip();
+    LOG_INFO("");
+    test_contention();
+    LOG_INFO("");
+    test_takeover_and_stop();
+
+    LOG_INFO("");
+    LOG_INFO("========================================");
+    LOG_INFO("  Passed: %u, Failed: %u", tests_passed, tests_failed);
+    LOG_INFO("========================================");
+
+    return tests_failed == 0 ? 0 : 1;
+}
@@ -4,7 +4,10 @@
  */
 
 #include "nvm.h"
+#include "nvm/ram_mirror_seqlock.h"
+#include "eeprom_driver.h"
 #include "os_scheduler.h"
+#include "metrics.h"
 #include "logging.h"
 #include <stdio.h>
 #include <string.h>
@@ -75,6 +78,203 @@ static void test_write_all_shutdown(void) {
     LOG_INFO("  Result: Passed");
 }
 
+static void nvm_task(void) {
+    NvM_MainFunction();
+}
+
+static void test_write_all_budgeted(void) {
+    LOG_INFO("Test: Budgeted, Resumable WriteAll");
+
+    NvM_Init();
+    OsScheduler_Init(16);
+
+    static uint8_t data[3][256];
+    for (uint8_t i = 0; i < 3; i++) {
+        NvM_BlockConfig_t block = {
+            .block_id = (uint8_t)(20 + i), .block_size = 256, .block_type = NVM_BLOCK_NATIVE,
+            .crc_type = NVM_CRC16, .priority = 10, .is_immediate = FALSE,
+            .is_write_protected = FALSE, .ram_mirror_ptr = data[i],
+            .rom_block_ptr = NULL, .rom_block_size = 0, .eeprom_offset = (uint32_t)i * 0x400U
+        };
+        NvM_RegisterBlock(&block);
+        memset(data[i], 0x40 + i, 256);
+    }
+
+    /* One byte of budget: every call stops after the block it started */
+    NvM_MainFunctionBudget_t budget = { .max_bytes = 1, .max_cost_us = 0 };
+    NvM_SetMainFunctionBudget(&budget);
+    NvM_WriteAll();
+
+    NvM_Diagnostics_t diag;
+    NvM_MainFunction();
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(diag.total_jobs_processed == 0, "WriteAll not finished after first call");
+    TEST_ASSERT(diag.last_main_cost_us > 0, "Per-call cost reported");
+    uint32_t one_block_cost = diag.last_main_cost_us;
+
+    NvM_MainFunction();
+    NvM_MainFunction();
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(diag.total_jobs_processed == 1, "WriteAll finished on third call");
+    TEST_ASSERT(diag.budget_yields == 2, "Two calls yielded with work left");
+    TEST_ASSERT(diag.max_main_cost_us == one_block_cost, "Per-call cost bounded to one block");
+
+    /* Unlimited budget: whole pass in one call, cost charged to the task */
+    NvM_SetMainFunctionBudget(NULL);
+    OsTask_t task = {
+        .task_id = 1, .task_name = "NvM", .period_ms = 10, .priority = 1,
+        .task_func = nvm_task, .max_exec_time_us = 0, .deadline_relative_ms = 5
+    };
+    OsScheduler_RegisterTask(&task);
+    OsScheduler_Start();
+    for (uint8_t i = 0; i < 3; i++) {
+        memset(data[i], 0x50 + i, 256);   /* dirty every block again */
+    }
+    NvM_WriteAll();
+    OsScheduler_Tick();
+
+    NvM_GetDiagnostics(&diag);
+    OsSchedulerStats_t stats;
+    OsScheduler_GetStats(&stats);
+    TEST_ASSERT(diag.total_jobs_processed == 2, "Unbudgeted WriteAll in one call");
+    TEST_ASSERT(diag.last_main_cost_us == 3 * one_block_cost, "Cost covers all blocks");
+    TEST_ASSERT(stats.max_exec_time_us >= diag.last_main_cost_us, "Scheduler sees NvM cost");
+    TEST_ASSERT(stats.deadline_misses == 1, "Deadline miss from NvM load");
+
+    OsScheduler_Stop();
+    OsScheduler_Destroy();
+    LOG_INFO("  Result: Passed");
+}
+
+static uint32_t erase_count(void) {
+    Eeprom_DiagInfoType diag;
+    Eep_GetDiagnostics(&diag);
+    return diag.total_erase_count;
+}
+
+static void run_write_all(void) {
+    NvM_WriteAll();
+    for (uint32_t i = 0; i < 4; i++) {
+        NvM_MainFunction();
+    }
+}
+
+static void test_write_all_dirty_tracking(void) {
+    LOG_INFO("Test: Dirty-Tracked WriteAll");
+
+    NvM_Init();
+    OsScheduler_Init(16);
+
+    static uint8_t data[3][256];
+    for (uint8_t i = 0; i < 3; i++) {
+        NvM_BlockConfig_t block = {
+            .block_id = (uint8_t)(5 + i), .block_size = 256, .block_type = NVM_BLOCK_NATIVE,
+            .crc_type = NVM_CRC8, .priority = 10, .is_immediate = FALSE,
+            .is_write_protected = FALSE, .ram_mirror_ptr = data[i],
+            .rom_block_ptr = NULL, .rom_block_size = 0, .eeprom_offset = (uint32_t)(2 - i) * 0x400U
+        };
+        NvM_RegisterBlock(&block);
+        memset(data[i], 0x60 + i, 256);
+    }
+
+    NvM_Diagnostics_t diag;
+    uint32_t erases = erase_count();
+    run_write_all();
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(erase_count() - erases == 3, "First WriteAll persists every block");
+    TEST_ASSERT(diag.writeall_skipped_blocks == 0, "Nothing skipped on first pass");
+
+    erases = erase_count();
+    run_write_all();
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(erase_count() == erases, "Unchanged mirrors cause no erase");
+    TEST_ASSERT(diag.writeall_skipped_blocks == 3, "Three blocks skipped");
+
+    /* Direct store into one mirror is caught by the hash */
+    data[1][17] ^= 0x01;
+    erases = erase_count();
+    run_write_all();
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(erase_count() - erases == 1, "Only the modified block rewritten");
+    TEST_ASSERT(diag.writeall_skipped_blocks == 5, "Two more blocks skipped");
+
+    /* A seqlock write marks the block dirty through its generation */
+    uint8_t scratch[16] = { 0 };
+    RamMirror_SeqlockWrite(7, scratch, sizeof(scratch));
+    erases = erase_count();
+    run_write_all();
+    TEST_ASSERT(erase_count() - erases == 1, "Generation bump forces a write");
+
+    /* Data round-trips after the skip passes */
+    uint8_t readback[256];
+    NvM_ReadBlock(6, readback);
+    NvM_MainFunction();
+    TEST_ASSERT(memcmp(readback, data[1], sizeof(readback)) == 0, "Persisted data current");
+
+    LOG_INFO("  Result: Passed");
+}
+
+static void test_write_all_preemption(void) {
+    LOG_INFO("Test: Immediate Write Preempts WriteAll");
+
+    NvM_Init();
+    OsScheduler_Init(16);
+    Metrics_Reset();
+    Metrics_Enable(TRUE);
+
+    static uint8_t data[4][256];
+    for (uint8_t i = 0; i < 4; i++) {
+        NvM_BlockConfig_t block = {
+            .block_id = (uint8_t)(30 + i), .block_size = 256, .block_type = NVM_BLOCK_NATIVE,
+            .crc_type = NVM_CRC16, .priority = 10, .is_immediate = (i == 3) ? TRUE : FALSE,
+            .is_write_protected = FALSE, .ram_mirror_ptr = data[i],
+            .rom_block_ptr = NULL, .rom_block_size = 0, .eeprom_offset = (uint32_t)i * 0x400U
+        };
+        NvM_RegisterBlock(&block);
+        memset(data[i], 0x70 + i, 256);
+    }
+
+    /* One block per call, so the pass spans several calls */
+    NvM_MainFunctionBudget_t budget = { .max_bytes = 1, .max_cost_us = 0 };
+    NvM_SetMainFunctionBudget(&budget);
+    NvM_WriteAll();
+    NvM_MainFunction();
+
+    /* Crash-critical write arrives while the flush is running */
+    memset(data[3], 0xC3, sizeof(data[3]));
+    NvM_WriteBlock(33, data[3]);
+    NvM_MainFunction();
+
+    uint8_t result = NVM_REQ_PENDING;
+    NvM_Diagnostics_t diag;
+    NvM_GetJobResult(33, &result);
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(result == NVM_REQ_OK, "Immediate write done at the next block boundary");
+    TEST_ASSERT(diag.total_jobs_processed == 1, "WriteAll still running");
+    TEST_ASSERT(diag.multi_block_preemptions == 1, "Preemption counted");
+
+    for (uint32_t i = 0; i < 4; i++) {
+        NvM_MainFunction();
+    }
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(diag.total_jobs_processed == 2 && diag.total_jobs_failed == 0,
+                "WriteAll resumes and completes");
+    TEST_ASSERT(diag.writeall_skipped_blocks == 1, "Block written by the immediate job skipped");
+
+    Metrics_Snapshot_t snapshot;
+    Metrics_GetSnapshot(METRIC_NVM_IMMEDIATE, &snapshot);
+    TEST_ASSERT(snapshot.summary[METRIC_CLOCK_VIRTUAL_US].count == 1, "Immediate latency recorded");
+
+    uint8_t readback[256];
+    NvM_SetMainFunctionBudget(NULL);
+    NvM_ReadBlock(33, readback);
+    NvM_MainFunction();
+    TEST_ASSERT(memcmp(readback, data[3], sizeof(readback)) == 0, "Immediate data persisted");
+
+    Metrics_Enable(FALSE);
+    LOG_INFO("  Result: Passed");
+}
+
 int main(void) {
     LOG_INFO("========================================");
     LOG_INFO("  Integration Test: WriteAll");
@@ -82,6 +282,12 @@ int main(void) {
     LOG_INFO("");
     
     test_write_all_shutdown();
+    LOG_INFO("");
+    test_write_all_budgeted();
+    LOG_INFO("");
+    test_write_all_dirty_tracking();
+    LOG_INFO("");
+    test_write_all_preemption();
     
     LOG_INFO("");
     LOG_INFO("========================================");
@@ -0,0 +1,287 @@
+/**
+ * @file test_write_batch.c
+ * @brief Integration Test: NvM_WriteBlocks multi-block commits
+ */
+
+#include "nvm.h"
+#include "eeprom_driver.h"
+#include "fault_injection.h"
+#include "os_scheduler.h"
+#include "logging.h"
+#include <stdio.h>
+#include <string.h>
+
+static uint32_t tests_passed = 0;
+static uint32_t tests_failed = 0;
+
+#define TEST_ASSERT(cond, msg) \
+    do { \
+        if (cond) { tests_passed++; LOG_INFO("  ✓ %s", msg); } \
+        else { tests_failed++; LOG_ERROR("  ✗ %s", msg); } \
+    } while(0)
+
+static uint8_t data_a[256], data_b[256], data_c[256];
+
+static void register_native(uint8_t block_id, uint8_t *mirror, uint32_t offset)
+{
+    NvM_BlockConfig_t block = {
+        .block_id = block_id, .block_size = 256, .block_type = NVM_BLOCK_NATIVE,
+        .crc_type = NVM_CRC16, .priority = 10, .is_immediate = FALSE,
+        .is_write_protected = FALSE, .ram_mirror_ptr = mirror,
+        .rom_block_ptr = NULL, .rom_block_size = 0, .eeprom_offset = offset
+    };
+    NvM_RegisterBlock(&block);
+}
+
+static boolean read_back(uint8_t block_id, uint8_t expected)
+{
+    uint8_t buffer[256];
+    uint8_t result = NVM_REQ_PENDING;
+
+    memset(buffer, 0, sizeof(buffer));
+    NvM_ReadBlock(block_id, buffer);
+    NvM_MainFunction();
+    NvM_GetJobResult(block_id, &result);
+    if (result != NVM_REQ_OK) {
+        return FALSE;
+    }
+
+    for (uint32_t i = 0; i < sizeof(buffer); i++) {
+        if (buffer[i] != expected) {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static void test_batch_commit(void) {
+    LOG_INFO("Test: Batch Commit (Native + Redundant)");
+
+    NvM_Init();
+    OsScheduler_Init(16);
+
+    register_native(1, data_a, 0x000);
+    NvM_BlockConfig_t redundant = {
+        .block_id = 2, .block_size = 256, .block_type = NVM_BLOCK_REDUNDANT,
+        .crc_type = NVM_CRC16, .priority = 3, .is_immediate = FALSE,
+        .is_write_protected = FALSE, .ram_mirror_ptr = data_b,
+        .rom_block_ptr = NULL, .rom_block_size = 0, .eeprom_offset = 0x400,
+        .redundant_eeprom_offset = 0x800
+    };
+    NvM_RegisterBlock(&redundant);
+    register_native(3, data_c, 0xC00);
+
+    memset(data_a, 0xA1, sizeof(data_a));
+    memset(data_b, 0xB2, sizeof(data_b));
+    memset(data_c, 0xC3, sizeof(data_c));
+
+    /* Listed out of offset order on purpose */
+    const NvM_BlockIdType ids[] = { 3, 1, 2 };
+    const void *const bufs[] = { data_c, data_a, data_b };
+
+    NvM_Diagnostics_t before, after;
+    Eeprom_DiagInfoType eep_before, eep_after;
+    NvM_GetDiagnostics(&before);
+    Eep_GetDiagnostics(&eep_before);
+
+    TEST_ASSERT(NvM_WriteBlocks(ids, bufs, 3) == E_OK, "Batch queued");
+
+    uint8_t r1, r2, r3;
+    NvM_GetJobResult(1, &r1);
+    NvM_GetJobResult(2, &r2);
+    NvM_GetJobResult(3, &r3);
+    TEST_ASSERT(r1 == NVM_REQ_PENDING && r2 == NVM_REQ_PENDING && r3 == NVM_REQ_PENDING,
+                "All blocks pending");
+
+    NvM_MainFunction();
+    NvM_GetDiagnostics(&after);
+    Eep_GetDiagnostics(&eep_after);
+
+    NvM_GetJobResult(1, &r1);
+    NvM_GetJobResult(2, &r2);
+    NvM_GetJobResult(3, &r3);
+    TEST_ASSERT(r1 == NVM_REQ_OK && r2 == NVM_REQ_OK && r3 == NVM_REQ_OK, "All blocks committed");
+    TEST_ASSERT(after.total_jobs_processed - before.total_jobs_processed == 1U,
+                "Whole batch is one job");
+    TEST_ASSERT(eep_after.total_erase_count - eep_before.total_erase_count == 4U,
+                "One erase per copy (2 native + 2 redundant)");
+
+    uint8_t status;
+    NvM_GetErrorStatus(2, &status);
+    TEST_ASSERT(status == NVM_BLOCKSTATE_VALID, "Redundant block valid");
+
+    TEST_ASSERT(read_back(1, 0xA1), "Block 1 read back");
+    TEST_ASSERT(read_back(2, 0xB2), "Block 2 read back");
+    TEST_ASSERT(read_back(3, 0xC3), "Block 3 read back");
+
+    LOG_INFO("  Result: Passed");
+}
+
+static void test_batch_dataset(void) {
+    LOG_INFO("Test: Batch Commit (Dataset)");
+
+    NvM_Init();
+    OsScheduler_Init(16);
+
+    NvM_BlockConfig_t dataset = {
+        .block_id = 4, .block_size = 256, .block_type = NVM_BLOCK_DATASET,
+        .crc_type = NVM_CRC16, .priority = 10, .is_immediate = FALSE,
+        .is_write_protected = FALSE, .ram_mirror_ptr = data_a,
+        .rom_block_ptr = NULL, .rom_block_size = 0, .eeprom_offset = 0x000,
+        .dataset_count = 2, .active_dataset_index = 0
+    };
+    NvM_RegisterBlock(&dataset);
+    register_native(5, data_b, 0x800);
+
+    const NvM_BlockIdType ids[] = { 4, 5 };
+    const void *const bufs[] = { data_a, data_b };
+    uint8_t r4, r5;
+
+    for (uint8_t round = 1; round <= 3; round++) {
+        memset(data_a, 0x40 + round, sizeof(data_a));
+        memset(data_b, 0x50 + round, sizeof(data_b));
+        NvM_WriteBlocks(ids, bufs, 2);
+        NvM_MainFunction();
+    }
+
+    NvM_GetJobResult(4, &r4);
+    NvM_GetJobResult(5, &r5);
+    TEST_ASSERT(r4 == NVM_REQ_OK && r5 == NVM_REQ_OK, "Three batches committed");
+    TEST_ASSERT(read_back(4, 0x43), "Dataset serves the last committed version");
+    TEST_ASSERT(read_back(5, 0x53), "Native block holds the last version");
+
+    LOG_INFO("  Result: Passed");
+}
+
+static void test_batch_rollback(void) {
+    LOG_INFO("Test: Batch Rollback on Write Failure");
+
+    NvM_Init();
+    OsScheduler_Init(16);
+    FaultInj_Init();
+
+    register_native(6, data_a, 0x000);
+    register_native(7, data_b, 0x400);
+
+    /* Old content, written one block at a time */
+    memset(data_a, 0x11, sizeof(data_a));
+    memset(data_b, 0x22, sizeof(data_b));
+    NvM_WriteBlock(6, data_a);
+    NvM_WriteBlock(7, data_b);
+    NvM_MainFunction();
+
+    /* Fail the first page program of the batch */
+    FaultConfig_t fault = {
+        .fault_id = FAULT_P0_TIMEOUT_ERASE, .enabled = TRUE, .target_block_id = 0xFF,
+        .trigger_count = 1, .probability_percent = 0
+    };
+    FaultInj_Configure(&fault);
+
+    static uint8_t new_a[256], new_b[256];
+    memset(new_a, 0xAA, sizeof(new_a));
+    memset(new_b, 0xBB, sizeof(new_b));
+    const NvM_BlockIdType ids[] = { 6, 7 };
+    const void *const bufs[] = { new_a, new_b };
+
+    NvM_WriteBlocks(ids, bufs, 2);
+    NvM_MainFunction();
+    FaultInj_Disable(FAULT_P0_TIMEOUT_ERASE);
+
+    uint8_t r6, r7;
+    NvM_GetJobResult(6, &r6);
+    NvM_GetJobResult(7, &r7);
+    TEST_ASSERT(r6 == NVM_REQ_NOT_OK && r7 == NVM_REQ_NOT_OK, "Every block reports failure");
+
+    NvM_Diagnostics_t diag;
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(diag.batch_rollbacks == 1U, "Rollback counted");
+
+    TEST_ASSERT(read_back(6, 0x11), "Failed block restored to old content");
+    TEST_ASSERT(read_back(7, 0x22), "Untouched block keeps old content");
+
+    /* A later copy fails (not a page multiple): the earlier ones are undone */
+    static uint8_t odd[200];
+    NvM_BlockConfig_t odd_block = {
+        .block_id = 11, .block_size = sizeof(odd), .block_type = NVM_BLOCK_NATIVE,
+        .crc_type = NVM_CRC16, .priority = 10, .is_immediate = FALSE,
+        .is_write_protected = FALSE, .ram_mirror_ptr = odd,
+        .rom_block_ptr = NULL, .rom_block_size = 0, .eeprom_offset = 0x800
+    };
+    NvM_RegisterBlock(&odd_block);
+
+    const NvM_BlockIdType ids3[] = { 11, 6, 7 };
+    const void *const bufs3[] = { odd, new_a, new_b };
+    NvM_WriteBlocks(ids3, bufs3, 3);
+    NvM_MainFunction();
+
+    NvM_GetJobResult(6, &r6);
+    NvM_GetJobResult(7, &r7);
+    TEST_ASSERT(r6 == NVM_REQ_NOT_OK && r7 == NVM_REQ_NOT_OK, "Blocks programmed before the failure report failure");
+    TEST_ASSERT(read_back(6, 0x11), "First programmed block rolled back");
+    TEST_ASSERT(read_back(7, 0x22), "Second programmed block rolled back");
+
+    LOG_INFO("  Result: Passed");
+}
+
+static void test_batch_rejects(void) {
+    LOG_INFO("Test: Batch Argument Checks");
+
+    NvM_Init();
+    OsScheduler_Init(16);
+
+    register_native(8, data_a, 0x000);
+    register_native(9, data_b, 0x400);
+    NvM_BlockConfig_t protected_block = {
+        .block_id = 10, .block_size = 256, .block_type = NVM_BLOCK_NATIVE,
+        .crc_type = NVM_CRC16, .priority = 10, .is_immediate = FALSE,
+        .is_write_protected = TRUE, .ram_mirror_ptr = data_c,
+        .rom_block_ptr = NULL, .rom_block_size = 0, .eeprom_offset = 0x800
+    };
+    NvM_RegisterBlock(&protected_block);
+
+    const NvM_BlockIdType dup[] = { 8, 8 };
+    const NvM_BlockIdType prot[] = { 8, 10 };
+    const NvM_BlockIdType unknown[] = { 8, 42 };
+    const NvM_BlockIdType ok[] = { 8, 9 };
+    const void *const bufs[] = { data_a, data_b };
+    const void *const null_buf[] = { data_a, NULL };
+
+    TEST_ASSERT(NvM_WriteBlocks(dup, bufs, 2) == E_NOT_OK, "Duplicate block rejected");
+    TEST_ASSERT(NvM_WriteBlocks(prot, bufs, 2) == E_NOT_OK, "Write-protected block rejected");
+    TEST_ASSERT(NvM_WriteBlocks(unknown, bufs, 2) == E_NOT_OK, "Unregistered block rejected");
+    TEST_ASSERT(NvM_WriteBlocks(ok, null_buf, 2) == E_NOT_OK, "NULL buffer rejected");
+    TEST_ASSERT(NvM_WriteBlocks(ok, bufs, 0) == E_NOT_OK, "Empty batch rejected");
+    TEST_ASSERT(NvM_WriteBlocks(ok, bufs, NVM_WRITE_BATCH_MAX_BLOCKS + 1U) == E_NOT_OK,
+                "Oversized batch rejected");
+
+    boolean queued = TRUE;
+    for (uint32_t i = 0; i < NVM_WRITE_BATCH_QUEUE_SIZE; i++) {
+        if (NvM_WriteBlocks(ok, bufs, 2) != E_OK) {
+            queued = FALSE;
+        }
+    }
+    TEST_ASSERT(queued, "Batch slots fill up");
+    TEST_ASSERT(NvM_WriteBlocks(ok, bufs, 2) == E_NOT_OK, "Batch beyond queue size rejected");
+
+    NvM_MainFunction();
+    TEST_ASSERT(NvM_WriteBlocks(ok, bufs, 2) == E_OK, "Slots released after processing");
+
+    LOG_INFO("  Result: Passed");
+}
+
+int main(void) {
+    LOG_INFO("========================================");
+    LOG_INFO("  Integration Test: Batch Write");
+    LOG_INFO("========================================");
+
+    test_batch_commit();
+    test_batch_dataset();
+    test_batch_rollback();
+    test_batch_rejects();
+
+    LOG_INFO("========================================");
+    LOG_INFO("  Passed: %u, Failed: %u", tests_passed, tests_failed);
+    LOG_INFO("========================================");
+
+    return (tests_failed == 0) ? 0 : 1;
+}
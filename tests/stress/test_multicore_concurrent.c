@@ -9,6 +9,7 @@
  * - SC02: Data tearing verification (tear_count must be 0)
  * - SC03: Priority inversion detection
  * - SC04: Cache coherency verification
+ * - SC05: Seqlock vs multi-version (RCU) mirror: throughput and tail latency
  *
  * ISO 26262 ASIL-B Requirements:
  * - No data tearing (tear_count = 0)
@@ -16,11 +17,15 @@
  * - Deterministic WCET
  */
 
+#define _DEFAULT_SOURCE
+
 #include "ram_mirror_seqlock.h"
+#include "ram_mirror_rcu.h"
 #include "nvm.h"
 #include "logging.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <pthread.h>
 #include <stdatomic.h>
 #include <unistd.h>
@@ -33,23 +38,35 @@
 #define NUM_WRITERS          200
 #define TEST_DURATION_SEC    60
 
+/* Mode comparison (SC05): large block, shorter run per mode */
+#define COMPARE_SEQLOCK_BLOCK  2
+#define COMPARE_RCU_BLOCK      3
+#define COMPARE_BLOCK_SIZE     RAM_MIRROR_MAX_BLOCK_SIZE
+#define COMPARE_DURATION_SEC   5
+#define LATENCY_SAMPLE_EVERY   16U   /* Time one read in N */
+#define LATENCY_BUCKETS        40U   /* log2(ns) histogram */
+
 /* Test statistics */
 static atomic_int g_tear_count = ATOMIC_VAR_INIT(0);
 static atomic_int g_read_errors = ATOMIC_VAR_INIT(0);
 static atomic_int g_write_count = ATOMIC_VAR_INIT(0);
 static atomic_int g_stop_flag = ATOMIC_VAR_INIT(0);
 
-/* Test data pattern */
+/* Completed reads per reader (written once at thread exit) */
+static uint64_t g_reader_reads[NUM_READERS];
+
+/* Initial data pattern */
 static uint8_t g_write_pattern[TEST_BLOCK_SIZE];
 
 /**
  * @brief Initialize test data pattern
+ *
+ * Every write stores a uniform pattern (all bytes equal), so a mix of
+ * two writes is visible as differing bytes.
  */
 static void init_test_pattern(void)
 {
-    for (int i = 0; i < TEST_BLOCK_SIZE; i++) {
-        g_write_pattern[i] = (uint8_t)i;
-    }
+    memset(g_write_pattern, 0, TEST_BLOCK_SIZE);
 }
 
 /**
@@ -59,9 +76,9 @@ static void init_test_pattern(void)
  */
 static boolean verify_data(const uint8_t* data)
 {
-    for (int i = 0; i < TEST_BLOCK_SIZE; i++) {
+    for (int i = 1; i < TEST_BLOCK_SIZE; i++) {
         /* Check for data corruption (mixed old/new data) */
-        if (data[i] != (uint8_t)i) {
+        if (data[i] != data[0]) {
             return FALSE;
         }
     }
@@ -78,12 +95,14 @@ static void* reader_thread(void* arg)
 {
     uint8_t buffer[TEST_BLOCK_SIZE];
     uint32_t thread_id = *(uint32_t*)arg;
+    uint64_t reads = 0;
 
     LOG_INFO("Reader thread %u started", thread_id);
 
     while (atomic_load(&g_stop_flag) == 0) {
         /* Read from seqlock-protected mirror */
         if (RamMirror_SeqlockRead(TEST_BLOCK_ID, buffer, TEST_BLOCK_SIZE)) {
+            reads++;
             /* Verify data integrity */
             if (!verify_data(buffer)) {
                 /* Data tearing detected! */
@@ -96,6 +115,9 @@ static void* reader_thread(void* arg)
         }
     }
 
+    /* Thread-local count, published once: no shared counter in the loop */
+    g_reader_reads[thread_id] = reads;
+
     LOG_INFO("Reader thread %u stopped", thread_id);
     return NULL;
 }
@@ -104,12 +126,13 @@ static void* reader_thread(void* arg)
  * @brief Writer thread function
  *
  * Simulates periodic write operations.
- * Updates RAM Mirror with incrementing pattern.
+ * Updates RAM Mirror with a uniform pattern whose value changes per write.
  */
 static void* writer_thread(void* arg)
 {
     uint32_t thread_id = *(uint32_t*)arg;
     uint32_t write_count = 0;
+    uint8_t pattern[TEST_BLOCK_SIZE];
 
     LOG_INFO("Writer thread %u started", thread_id);
 
@@ -117,19 +140,14 @@ static void* writer_thread(void* arg)
         /* Small delay between writes (simulate real workload) */
         usleep(1000);  /* 1ms */
 
-        /* Modify pattern slightly (increment first byte) */
-        g_write_pattern[0]++;
+        /* New value per write, distinct between writers */
+        memset(pattern, (int)(uint8_t)(thread_id + write_count), TEST_BLOCK_SIZE);
 
         /* Write to seqlock-protected mirror */
-        if (RamMirror_SeqlockWrite(TEST_BLOCK_ID, g_write_pattern, TEST_BLOCK_SIZE) == E_OK) {
+        if (RamMirror_SeqlockWrite(TEST_BLOCK_ID, pattern, TEST_BLOCK_SIZE) == E_OK) {
             write_count++;
             atomic_fetch_add(&g_write_count, 1);
         }
-
-        /* Reset pattern if it gets too large */
-        if (g_write_pattern[0] > 200) {
-            g_write_pattern[0] = 0;
-        }
     }
 
     LOG_INFO("Writer thread %u stopped (writes=%u)", thread_id, write_count);
@@ -168,7 +186,7 @@ static void test_concurrent_access_stress(void)
     atomic_store(&g_stop_flag, 0);
 
     /* Initialize seqlock mirror */
-    RamMirror_SeqlockInit(&g_seqlock_mirrors[TEST_BLOCK_ID], TEST_BLOCK_ID);
+    RamMirror_SeqlockInit(RamMirror_GetSeqlockMirror(TEST_BLOCK_ID), TEST_BLOCK_ID);
     RamMirror_SeqlockWrite(TEST_BLOCK_ID, g_write_pattern, TEST_BLOCK_SIZE);
 
     /* Create reader threads */
@@ -192,11 +210,16 @@ static void test_concurrent_access_stress(void)
     LOG_INFO("All threads started, running for %u seconds...", TEST_DURATION_SEC);
     LOG_INFO("");
 
+    struct timespec t_start;
+    struct timespec t_end;
+    clock_gettime(CLOCK_MONOTONIC, &t_start);
+
     /* Run test for specified duration */
     sleep(TEST_DURATION_SEC);
 
     /* Signal all threads to stop */
     atomic_store(&g_stop_flag, 1);
+    clock_gettime(CLOCK_MONOTONIC, &t_end);
 
     /* Wait for all threads to complete */
     for (int i = 0; i < NUM_READERS; i++) {
@@ -214,6 +237,14 @@ static void test_concurrent_access_stress(void)
     SeqlockStats_t stats;
     RamMirror_GetSeqlockStats(TEST_BLOCK_ID, &stats);
 
+    uint64_t total_reads = 0;
+    for (int i = 0; i < NUM_READERS; i++) {
+        total_reads += g_reader_reads[i];
+    }
+    double elapsed_s = (double)(t_end.tv_sec - t_start.tv_sec) +
+                       (double)(t_end.tv_nsec - t_start.tv_nsec) / 1e9;
+    double reads_per_sec = (elapsed_s > 0.0) ? (double)total_reads / elapsed_s : 0.0;
+
     LOG_INFO("");
     LOG_INFO("========================================");
     LOG_INFO("  Test Results");
@@ -221,6 +252,9 @@ static void test_concurrent_access_stress(void)
     LOG_INFO("Data tearing events: %d", tear_count);
     LOG_INFO("Read errors: %d", read_errors);
     LOG_INFO("Total writes: %d", write_count);
+    LOG_INFO("Completed reads: %llu in %.2f s", (unsigned long long)total_reads, elapsed_s);
+    LOG_INFO("Read throughput: %.0f reads/s (%.0f per reader)",
+             reads_per_sec, reads_per_sec / NUM_READERS);
     LOG_INFO("");
     LOG_INFO("Seqlock Statistics:");
     LOG_INFO("  Total reads: %u", stats.read_count);
@@ -283,6 +317,244 @@ static void test_concurrent_access_stress(void)
     }
 }
 
+/* SC05 state */
+static NvM_BlockIdType g_compare_block;
+static atomic_int g_compare_tears = ATOMIC_VAR_INIT(0);
+static atomic_int g_compare_errors = ATOMIC_VAR_INIT(0);
+static uint64_t g_compare_reads[NUM_READERS];
+static uint64_t g_latency_hist[NUM_READERS][LATENCY_BUCKETS];
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t latency_bucket(uint64_t ns)
+{
+    uint32_t b = 0;
+    while (ns > 1U && b < LATENCY_BUCKETS - 1U) {
+        ns >>= 1;
+        b++;
+    }
+    return b;
+}
+
+/**
+ * @brief SC05 reader: mode-dispatched reads with sampled latency
+ */
+static void* compare_reader_thread(void* arg)
+{
+    static uint8_t buffers[NUM_READERS][COMPARE_BLOCK_SIZE];
+    uint32_t thread_id = *(uint32_t*)arg;
+    uint8_t* buffer = buffers[thread_id];
+    uint64_t* hist = g_latency_hist[thread_id];
+    uint64_t reads = 0;
+
+    while (atomic_load(&g_stop_flag) == 0) {
+        boolean sample = ((reads % LATENCY_SAMPLE_EVERY) == 0U) ? TRUE : FALSE;
+        uint64_t t0 = sample ? now_ns() : 0U;
+
+        if (!RamMirror_Read(g_compare_block, buffer, COMPARE_BLOCK_SIZE)) {
+            atomic_fetch_add(&g_compare_errors, 1);
+            continue;
+        }
+
+        if (sample) {
+            hist[latency_bucket(now_ns() - t0)]++;
+        }
+        if (buffer[0] != buffer[COMPARE_BLOCK_SIZE - 1] ||
+            memcmp(buffer, &buffer[1], COMPARE_BLOCK_SIZE - 1) != 0) {
+            atomic_fetch_add(&g_compare_tears, 1);
+        }
+        reads++;
+    }
+
+    g_compare_reads[thread_id] = reads;
+    return NULL;
+}
+
+/**
+ * @brief SC05 writer: full-block writes of a uniform pattern
+ */
+static void* compare_writer_thread(void* arg)
+{
+    static uint8_t patterns[NUM_WRITERS][COMPARE_BLOCK_SIZE];
+    uint32_t thread_id = *(uint32_t*)arg;
+    uint8_t* pattern = patterns[thread_id];
+    uint32_t write_count = 0;
+
+    while (atomic_load(&g_stop_flag) == 0) {
+        usleep(1000);  /* 1ms */
+        memset(pattern, (int)(uint8_t)(thread_id + write_count), COMPARE_BLOCK_SIZE);
+        if (RamMirror_Write(g_compare_block, pattern, COMPARE_BLOCK_SIZE) == E_OK) {
+            write_count++;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Result of one SC05 run
+ */
+typedef struct {
+    double reads_per_sec;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+    uint64_t max_ns;
+    int tears;
+    int errors;
+} CompareResult_t;
+
+/**
+ * @brief Latency at a quantile (upper bound of its log2 bucket)
+ */
+static uint64_t hist_quantile(const uint64_t* hist, uint64_t total, double q)
+{
+    uint64_t target = (uint64_t)((double)total * q);
+    uint64_t seen = 0;
+
+    for (uint32_t b = 0; b < LATENCY_BUCKETS; b++) {
+        seen += hist[b];
+        if (seen > target) {
+            return 1ULL << (b + 1U);
+        }
+    }
+    return 1ULL << LATENCY_BUCKETS;
+}
+
+static void run_mode_compare(NvM_BlockIdType block_id, CompareResult_t* result)
+{
+    pthread_t readers[NUM_READERS];
+    pthread_t writers[NUM_WRITERS];
+    uint32_t reader_ids[NUM_READERS];
+    uint32_t writer_ids[NUM_WRITERS];
+    static uint8_t initial[COMPARE_BLOCK_SIZE];
+
+    g_compare_block = block_id;
+    atomic_store(&g_stop_flag, 0);
+    atomic_store(&g_compare_tears, 0);
+    atomic_store(&g_compare_errors, 0);
+    memset(g_latency_hist, 0, sizeof(g_latency_hist));
+    memset(initial, 0, sizeof(initial));
+    RamMirror_Write(block_id, initial, COMPARE_BLOCK_SIZE);
+
+    for (int i = 0; i < NUM_READERS; i++) {
+        reader_ids[i] = i;
+        if (pthread_create(&readers[i], NULL, compare_reader_thread, &reader_ids[i]) != 0) {
+            LOG_ERROR("Failed to create reader thread %d", i);
+            exit(1);
+        }
+    }
+    for (int i = 0; i < NUM_WRITERS; i++) {
+        writer_ids[i] = i;
+        if (pthread_create(&writers[i], NULL, compare_writer_thread, &writer_ids[i]) != 0) {
+            LOG_ERROR("Failed to create writer thread %d", i);
+            exit(1);
+        }
+    }
+
+    uint64_t t_start = now_ns();
+    sleep(COMPARE_DURATION_SEC);
+    atomic_store(&g_stop_flag, 1);
+    uint64_t elapsed_ns = now_ns() - t_start;
+
+    for (int i = 0; i < NUM_READERS; i++) {
+        pthread_join(readers[i], NULL);
+    }
+    for (int i = 0; i < NUM_WRITERS; i++) {
+        pthread_join(writers[i], NULL);
+    }
+
+    uint64_t total_reads = 0;
+    uint64_t hist[LATENCY_BUCKETS] = { 0 };
+    uint64_t samples = 0;
+    for (int i = 0; i < NUM_READERS; i++) {
+        total_reads += g_compare_reads[i];
+        for (uint32_t b = 0; b < LATENCY_BUCKETS; b++) {
+            hist[b] += g_latency_hist[i][b];
+            samples += g_latency_hist[i][b];
+        }
+    }
+
+    result->reads_per_sec = (double)total_reads / ((double)elapsed_ns / 1e9);
+    result->p50_ns = hist_quantile(hist, samples, 0.50);
+    result->p99_ns = hist_quantile(hist, samples, 0.99);
+    result->p999_ns = hist_quantile(hist, samples, 0.999);
+    result->max_ns = 0;
+    for (uint32_t b = 0; b < LATENCY_BUCKETS; b++) {
+        if (hist[b] != 0U) {
+            result->max_ns = 1ULL << (b + 1U);
+        }
+    }
+    result->tears = atomic_load(&g_compare_tears);
+    result->errors = atomic_load(&g_compare_errors);
+}
+
+static void log_compare_result(const char* name, const CompareResult_t* r)
+{
+    LOG_INFO("  %-8s %12.0f reads/s  p50<=%lluns p99<=%lluns p99.9<=%lluns max<=%lluns  tears=%d errors=%d",
+             name, r->reads_per_sec,
+             (unsigned long long)r->p50_ns, (unsigned long long)r->p99_ns,
+             (unsigned long long)r->p999_ns, (unsigned long long)r->max_ns,
+             r->tears, r->errors);
+}
+
+/**
+ * @brief SC05: Seqlock vs multi-version (RCU) mirror under the same load
+ *
+ * Full-block (1 KB) writes make the seqlock write window long; RCU
+ * readers should not retry and keep a tighter latency tail.
+ */
+static void test_mirror_mode_compare(void)
+{
+    CompareResult_t seqlock_result;
+    CompareResult_t rcu_result;
+
+    LOG_INFO("========================================");
+    LOG_INFO("  SC05: Seqlock vs RCU Mirror Mode");
+    LOG_INFO("========================================");
+    LOG_INFO("  Readers: %u, Writers: %u, Block: %u bytes, %u s per mode",
+             NUM_READERS, NUM_WRITERS, COMPARE_BLOCK_SIZE, COMPARE_DURATION_SEC);
+    LOG_INFO("  Latency: 1 in %u reads sampled, log2 buckets (upper bounds)",
+             LATENCY_SAMPLE_EVERY);
+
+    RamMirror_SeqlockInit(RamMirror_GetSeqlockMirror(COMPARE_SEQLOCK_BLOCK), COMPARE_SEQLOCK_BLOCK);
+    RamMirror_SetMode(COMPARE_SEQLOCK_BLOCK, NVM_MIRROR_SEQLOCK);
+    RamMirror_RcuInit(COMPARE_RCU_BLOCK);
+    RamMirror_SetMode(COMPARE_RCU_BLOCK, NVM_MIRROR_RCU);
+
+    run_mode_compare(COMPARE_SEQLOCK_BLOCK, &seqlock_result);
+    run_mode_compare(COMPARE_RCU_BLOCK, &rcu_result);
+
+    SeqlockStats_t seq_stats;
+    RcuStats_t rcu_stats;
+    RamMirror_GetSeqlockStats(COMPARE_SEQLOCK_BLOCK, &seq_stats);
+    RamMirror_GetRcuStats(COMPARE_RCU_BLOCK, &rcu_stats);
+
+    log_compare_result("seqlock", &seqlock_result);
+    log_compare_result("rcu", &rcu_result);
+    LOG_INFO("  seqlock writes: %u, read retries: %u (max %u per read)",
+             seq_stats.write_count, seq_stats.read_retries, seq_stats.max_retries);
+    LOG_INFO("  rcu writes: %u, grace-period waits: %u (max %u scans)",
+             rcu_stats.write_count, rcu_stats.grace_waits, rcu_stats.max_grace_spins);
+    if (seqlock_result.reads_per_sec > 0.0) {
+        LOG_INFO("  rcu/seqlock throughput: %.2fx",
+                 rcu_result.reads_per_sec / seqlock_result.reads_per_sec);
+    }
+
+    if (seqlock_result.tears == 0 && rcu_result.tears == 0 && rcu_result.errors == 0) {
+        LOG_INFO("✓ PASS: Both modes consistent (tears=0), RCU reads never failed");
+    } else {
+        LOG_ERROR("✗ FAIL: seqlock tears=%d, rcu tears=%d, rcu errors=%d",
+                  seqlock_result.tears, rcu_result.tears, rcu_result.errors);
+    }
+    LOG_INFO("========================================");
+}
+
 /**
  * @brief Performance Benchmark: Seqlock vs Mutex
  *
@@ -325,6 +597,11 @@ int main(void)
 
     LOG_INFO("");
 
+    /* Compare mirror modes */
+    test_mirror_mode_compare();
+
+    LOG_INFO("");
+
     /* Run performance benchmark */
     benchmark_seqlock_vs_mutex();
 
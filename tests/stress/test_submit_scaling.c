@@ -0,0 +1,306 @@
+/**
+ * @file test_submit_scaling.c
+ * @brief Stress Test for the Lock-Free Cross-Core Submission Ring
+ *
+ * Design Reference: 03-Block管理机制.md §4 Job队列管理
+ *
+ * Test Scenarios:
+ * - SC01: Raw ring throughput (submissions/sec) for 1, 2, 4 and 8 producers
+ * - SC02: No lost or duplicated jobs, FIFO order per producer
+ * - SC03: NvM_WriteBlock from producer threads, NvM_MainFunction on the
+ *         NvM thread: every accepted request completes, backpressure counted
+ */
+
+#define _DEFAULT_SOURCE
+
+#include "nvm.h"
+#include "nvm_internal.h"
+#include "logging.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <time.h>
+
+/* Test configuration */
+#define MAX_PRODUCERS          8U
+#define RING_JOBS_PER_PRODUCER 100000U
+#define NVM_JOBS_PER_PRODUCER  2000U
+#define NVM_TEST_BLOCKS        4U
+#define NVM_TEST_BLOCK_SIZE    256U
+
+static const uint32_t g_producer_counts[] = { 1U, 2U, 4U, 8U };
+
+static atomic_int g_start_flag = ATOMIC_VAR_INIT(0);
+static atomic_uint g_producers_done = ATOMIC_VAR_INIT(0);
+static uint32_t g_failures = 0;
+
+/* Per producer: retries after backpressure (written once at thread exit) */
+static uint64_t g_retries[MAX_PRODUCERS];
+
+static uint8_t g_block_data[NVM_TEST_BLOCKS][NVM_TEST_BLOCK_SIZE];
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void check(int condition, const char* message)
+{
+    if (condition) {
+        LOG_INFO("  ✓ %s", message);
+    } else {
+        LOG_ERROR("  ✗ %s", message);
+        g_failures++;
+    }
+}
+
+static void wait_for_start(void)
+{
+    while (atomic_load(&g_start_flag) == 0) {
+        sched_yield();    /* All producers start together */
+    }
+}
+
+/**
+ * @brief Raw ring producer: job identifies producer (block_id) and sequence (timeout_ms)
+ */
+static void* ring_producer(void* arg)
+{
+    uint32_t id = *(uint32_t*)arg;
+    uint64_t retries = 0;
+    NvM_Job_t job;
+
+    memset(&job, 0, sizeof(job));
+    job.job_type = NVM_JOB_WRITE;
+    job.block_id = (uint8_t)id;
+
+    wait_for_start();
+    for (uint32_t seq = 0; seq < RING_JOBS_PER_PRODUCER; seq++) {
+        job.timeout_ms = seq;
+        while (NvM_Submit_Push(&job) != E_OK) {
+            retries++;
+            sched_yield();    /* Ring full: let the consumer run */
+        }
+    }
+
+    g_retries[id] = retries;
+    atomic_fetch_add(&g_producers_done, 1U);
+    return NULL;
+}
+
+/**
+ * @brief SC01/SC02: single consumer drains while producers push
+ */
+static void run_ring_scaling(uint32_t producers)
+{
+    pthread_t threads[MAX_PRODUCERS];
+    uint32_t ids[MAX_PRODUCERS];
+    uint32_t next_seq[MAX_PRODUCERS] = {0};
+    uint64_t popped = 0;
+    uint32_t order_errors = 0;
+    NvM_Job_t job;
+
+    NvM_Submit_Reset();
+    atomic_store(&g_start_flag, 0);
+    atomic_store(&g_producers_done, 0U);
+
+    for (uint32_t i = 0; i < producers; i++) {
+        ids[i] = i;
+        g_retries[i] = 0;
+        pthread_create(&threads[i], NULL, ring_producer, &ids[i]);
+    }
+
+    uint64_t start = now_ns();
+    atomic_store(&g_start_flag, 1);
+
+    const uint64_t expected = (uint64_t)producers * RING_JOBS_PER_PRODUCER;
+    while (popped < expected) {
+        if (NvM_Submit_Pop(&job) != E_OK) {
+            sched_yield();    /* Ring empty: let the producers run */
+            continue;
+        }
+        if (job.block_id >= producers || job.timeout_ms != next_seq[job.block_id]) {
+            order_errors++;
+        } else {
+            next_seq[job.block_id]++;
+        }
+        popped++;
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    for (uint32_t i = 0; i < producers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    uint64_t retries = 0;
+    for (uint32_t i = 0; i < producers; i++) {
+        retries += g_retries[i];
+    }
+
+    NvM_SubmitStats_t stats;
+    NvM_Submit_GetStats(&stats);
+
+    double seconds = (double)elapsed / 1e9;
+    LOG_INFO("  %u producer(s): %.2f M submissions/s, %llu full-ring retries, max depth %u/%u",
+             producers, (double)expected / seconds / 1e6, (unsigned long long)retries,
+             stats.max_depth, NVM_SUBMIT_RING_SIZE);
+
+    char message[96];
+    snprintf(message, sizeof(message), "%u producer(s): all %llu jobs drained in per-producer order",
+             producers, (unsigned long long)expected);
+    check(order_errors == 0U && NvM_Submit_Pop(&job) == E_NOT_OK && stats.depth == 0U, message);
+    check(stats.submitted == expected && stats.rejected == retries,
+          "  Accepted and rejected pushes accounted");
+}
+
+static void test_ring_scaling(void)
+{
+    LOG_INFO("Test: Submission ring throughput vs producer count");
+
+    for (uint32_t i = 0; i < sizeof(g_producer_counts) / sizeof(g_producer_counts[0]); i++) {
+        run_ring_scaling(g_producer_counts[i]);
+    }
+}
+
+/**
+ * @brief NvM producer: application task writing its block from another core
+ */
+static void* nvm_producer(void* arg)
+{
+    uint32_t id = *(uint32_t*)arg;
+    NvM_BlockIdType block_id = (NvM_BlockIdType)(1U + (id % NVM_TEST_BLOCKS));
+    uint64_t retries = 0;
+
+    wait_for_start();
+    for (uint32_t n = 0; n < NVM_JOBS_PER_PRODUCER; n++) {
+        while (NvM_WriteBlock(block_id, g_block_data[block_id - 1U]) != E_OK) {
+            retries++;    /* Backpressure: ring full */
+            sched_yield();
+        }
+    }
+
+    g_retries[id] = retries;
+    atomic_fetch_add(&g_producers_done, 1U);
+    return NULL;
+}
+
+/**
+ * @brief SC03: end-to-end NvM path for one producer count
+ */
+static void run_nvm_scaling(uint32_t producers)
+{
+    pthread_t threads[MAX_PRODUCERS];
+    uint32_t ids[MAX_PRODUCERS];
+
+    NvM_Init();
+    for (uint32_t b = 0; b < NVM_TEST_BLOCKS; b++) {
+        memset(g_block_data[b], (int)(0x10U + b), NVM_TEST_BLOCK_SIZE);
+        NvM_BlockConfig_t block = {
+            .block_id = (uint8_t)(1U + b),
+            .block_size = NVM_TEST_BLOCK_SIZE,
+            .block_type = NVM_BLOCK_NATIVE,
+            .crc_type = NVM_CRC16,
+            .priority = 10,
+            .ram_mirror_ptr = g_block_data[b],
+            .eeprom_offset = b * 0x400U
+        };
+        NvM_RegisterBlock(&block);
+    }
+
+    atomic_store(&g_start_flag, 0);
+    atomic_store(&g_producers_done, 0U);
+    for (uint32_t i = 0; i < producers; i++) {
+        ids[i] = i;
+        g_retries[i] = 0;
+        pthread_create(&threads[i], NULL, nvm_producer, &ids[i]);
+    }
+
+    /* This thread called NvM_Init: it is the NvM core */
+    uint64_t start = now_ns();
+    atomic_store(&g_start_flag, 1);
+
+    const uint32_t expected = producers * NVM_JOBS_PER_PRODUCER;
+    NvM_Diagnostics_t diag;
+    uint32_t processed = 0;
+    do {
+        NvM_MainFunction();
+        NvM_GetDiagnostics(&diag);
+        if (diag.total_jobs_processed == processed) {
+            sched_yield();    /* Nothing submitted yet */
+        }
+        processed = diag.total_jobs_processed;
+    } while (atomic_load(&g_producers_done) < producers || diag.total_jobs_processed < expected);
+    uint64_t elapsed = now_ns() - start;
+
+    for (uint32_t i = 0; i < producers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    NvM_MainFunction();
+    NvM_GetDiagnostics(&diag);
+
+    uint64_t retries = 0;
+    for (uint32_t i = 0; i < producers; i++) {
+        retries += g_retries[i];
+    }
+
+    LOG_INFO("  %u producer(s): %.0f writes/s end to end, %u backpressure rejects, max ring depth %u",
+             producers, (double)expected / ((double)elapsed / 1e9), diag.remote_rejects,
+             diag.submit_ring_max_depth);
+
+    char message[96];
+    snprintf(message, sizeof(message), "%u producer(s): %u writes accepted and completed",
+             producers, expected);
+    check(diag.remote_submissions == expected && diag.total_jobs_processed == expected &&
+          diag.total_jobs_failed == 0U, message);
+    check(diag.remote_rejects == retries, "  Backpressure rejects reported");
+
+    uint8_t result = NVM_REQ_PENDING;
+    boolean all_ok = TRUE;
+    for (uint32_t b = 0; b < NVM_TEST_BLOCKS && b < producers; b++) {
+        NvM_GetJobResult((NvM_BlockIdType)(1U + b), &result);
+        if (result != NVM_REQ_OK) {
+            all_ok = FALSE;
+        }
+    }
+    check(all_ok, "  Job results read OK after the last write");
+}
+
+static void test_nvm_scaling(void)
+{
+    LOG_INFO("Test: NvM_WriteBlock from producer threads");
+
+    for (uint32_t i = 0; i < sizeof(g_producer_counts) / sizeof(g_producer_counts[0]); i++) {
+        run_nvm_scaling(g_producer_counts[i]);
+    }
+}
+
+/**
+ * @brief Main test entry point
+ */
+int main(void)
+{
+    Log_SetLevel(LOG_LEVEL_INFO);
+
+    LOG_INFO("========================================");
+    LOG_INFO("  Cross-Core Submission Ring Stress Test");
+    LOG_INFO("========================================");
+    LOG_INFO("");
+
+    test_ring_scaling();
+    LOG_INFO("");
+    test_nvm_scaling();
+
+    LOG_INFO("");
+    if (g_failures == 0U) {
+        LOG_INFO("✓ All submission ring tests passed");
+        return 0;
+    }
+
+    LOG_ERROR("✗ %u submission ring checks failed", g_failures);
+    return 1;
+}
@@ -8,10 +8,14 @@
  * - P0-03: Single bit flip
  * - P0-04: Multiple bit flip
  * - P0-05: Timeout
+ * - Probabilistic faults: trigger rate and seed reproducibility
+ * - Armed mask: hook call sites skipped unless a fault can trigger
+ * - Block targeting: address ranges from the block layout select the block
  */
 
 #include "nvm.h"
 #include "fault_injection.h"
+#include "eeprom_driver.h"
 #include "os_scheduler.h"
 #include "logging.h"
 #include <stdio.h>
@@ -22,6 +26,21 @@
  */
 static uint8_t test_block[256] = {0};
 
+/**
+ * @brief Failed checks
+ */
+static uint32_t g_failures = 0;
+
+static void check(int condition, const char* message)
+{
+    if (condition) {
+        LOG_INFO("✓ %s", message);
+    } else {
+        LOG_ERROR("✗ %s", message);
+        g_failures++;
+    }
+}
+
 /**
  * @brief Test P0-01: Power loss during page program
  */
@@ -227,6 +246,195 @@ static void test_fault_statistics(void)
     LOG_INFO("");
 }
 
+/**
+ * @brief Run a CRC hook sequence with a probabilistic fault
+ *
+ * @param pattern Trigger flags per call (may be NULL)
+ * @return Number of triggers
+ */
+static uint32_t run_probabilistic(uint64_t seed, uint8_t percent, uint32_t calls, uint8_t *pattern)
+{
+    FaultInj_Init();
+    FaultInj_SetSeed(seed);
+
+    FaultConfig_t config = {
+        .fault_id = FAULT_P0_CRC_INVERT,
+        .enabled = TRUE,
+        .target_block_id = 0xFF,
+        .trigger_count = 0,
+        .probability_percent = percent
+    };
+    FaultInj_Configure(&config);
+
+    uint32_t triggers = 0;
+    for (uint32_t i = 0; i < calls; i++) {
+        uint16_t crc = 0x1234;
+        boolean hit = FaultInj_HookCrc(test_block, sizeof(test_block), &crc);
+        if (pattern != NULL) {
+            pattern[i] = hit ? 1U : 0U;
+        }
+        triggers += hit ? 1U : 0U;
+    }
+
+    FaultInj_Disable(FAULT_P0_CRC_INVERT);
+    return triggers;
+}
+
+/**
+ * @brief Test probabilistic faults: rate and reproducibility
+ */
+static void test_probabilistic_faults(void)
+{
+    LOG_INFO("=== Test Probabilistic Faults ===");
+
+    static uint8_t first[10000];
+    static uint8_t second[10000];
+    static const uint8_t percents[] = { 1, 10, 50, 90 };
+    char message[96];
+
+    /* Injections are logged as warnings */
+    Log_SetLevel(LOG_LEVEL_ERROR);
+    uint32_t rates[sizeof(percents)];
+    for (uint32_t p = 0; p < sizeof(percents); p++) {
+        rates[p] = run_probabilistic(7U, percents[p], 100000U, NULL);
+    }
+    uint32_t a = run_probabilistic(42U, 20U, 10000U, first);
+    uint32_t b = run_probabilistic(42U, 20U, 10000U, second);
+    uint32_t c = run_probabilistic(43U, 20U, 10000U, NULL);
+    uint32_t always = run_probabilistic(42U, 0U, 100U, NULL);
+    Log_SetLevel(LOG_LEVEL_INFO);
+
+    for (uint32_t p = 0; p < sizeof(percents); p++) {
+        /* Expected p% of 100000 calls, within 10% of the target (>4 sigma at 1%) */
+        uint32_t expected = percents[p] * 1000U;
+        snprintf(message, sizeof(message), "%u%% fault: %u triggers in 100000 calls", percents[p],
+                 rates[p]);
+        check(rates[p] > expected - expected / 10U && rates[p] < expected + expected / 10U, message);
+    }
+    check(a == b && memcmp(first, second, sizeof(first)) == 0,
+          "Same seed: identical trigger sequence");
+    check(a != c, "Different seed: different trigger sequence");
+    check(always == 100U, "0% configured: triggers on every call");
+
+    LOG_INFO("");
+}
+
+/**
+ * @brief Test the armed mask follows enable, disable and trigger limits
+ */
+static void test_armed_mask(void)
+{
+    LOG_INFO("=== Test Armed Mask ===");
+
+    FaultInj_Init();
+    check(!FAULT_INJ_ARMED(0xFFFFFFFFUL), "Nothing armed after init");
+
+    FaultInj_Enable(FAULT_P0_BITFLIP_MULTI);
+    check(FAULT_INJ_ARMED(FAULT_INJ_MASK_AFTER_READ) && !FAULT_INJ_ARMED(FAULT_INJ_MASK_CRC),
+          "Enabled fault arms only its own hook");
+    FaultInj_Disable(FAULT_P0_BITFLIP_MULTI);
+    check(!FAULT_INJ_ARMED(FAULT_INJ_MASK_AFTER_READ), "Disabled fault disarms its hook");
+
+    /* Two triggers, then the call site stops calling in */
+    FaultConfig_t config = {
+        .fault_id = FAULT_P0_CRC_INVERT,
+        .enabled = TRUE,
+        .target_block_id = 0xFF,
+        .trigger_count = 2,
+        .probability_percent = 0
+    };
+    FaultInj_Configure(&config);
+    uint32_t hits = 0;
+    Log_SetLevel(LOG_LEVEL_ERROR);
+    for (int i = 0; i < 5; i++) {
+        uint16_t crc = 0;
+        if (FAULT_INJ_ARMED(FAULT_INJ_MASK_CRC) && FaultInj_HookCrc(test_block, 4, &crc)) {
+            hits++;
+        }
+    }
+    Log_SetLevel(LOG_LEVEL_INFO);
+    check(hits == 2U && !FAULT_INJ_ARMED(FAULT_INJ_MASK_CRC), "Used-up fault disarms its hook");
+
+    FaultInj_ResetAll();
+    LOG_INFO("");
+}
+
+/**
+ * @brief Test block-targeted faults only fire inside the target's slots
+ */
+static void test_block_targeting(void)
+{
+    LOG_INFO("=== Test Block Targeting ===");
+
+    static uint8_t mirror_a[64];
+    static uint8_t mirror_b[64];
+    FaultInj_Init();
+    NvM_Init();
+
+    NvM_BlockConfig_t native = {
+        .block_id = 1,
+        .block_size = 64,
+        .block_type = NVM_BLOCK_NATIVE,
+        .crc_type = NVM_CRC16,
+        .ram_mirror_ptr = mirror_a,
+        .eeprom_offset = 0x0000
+    };
+    NvM_BlockConfig_t redundant = {
+        .block_id = 2,
+        .block_size = 64,
+        .block_type = NVM_BLOCK_REDUNDANT,
+        .crc_type = NVM_CRC16,
+        .ram_mirror_ptr = mirror_b,
+        .eeprom_offset = 0x0400,
+        .redundant_eeprom_offset = 0x0C00
+    };
+    NvM_RegisterBlock(&native);
+    NvM_RegisterBlock(&redundant);
+
+    check(FaultInj_LookupBlock(0x0000) == 1U && FaultInj_LookupBlock(0x03FF) == 1U &&
+          FaultInj_LookupBlock(0x0400) == 2U && FaultInj_LookupBlock(0x0C10) == 2U &&
+          FaultInj_LookupBlock(0x0800) == FAULT_INJ_ALL_BLOCKS,
+          "Lookup maps slots (primary and backup) to their block");
+    check(FaultInj_MapRange(9, 0x0300, 0x200) == E_NOT_OK, "Overlapping range rejected");
+
+    /* Flip every read of block 2, never block 1 */
+    FaultConfig_t config = {
+        .fault_id = FAULT_P0_BITFLIP_SINGLE,
+        .enabled = TRUE,
+        .target_block_id = 2,
+        .trigger_count = 0,
+        .probability_percent = 0
+    };
+    FaultInj_Configure(&config);
+    FaultInj_ResetStats();
+
+    uint8_t buf[4];
+    uint32_t flipped_other = 0;
+    Log_SetLevel(LOG_LEVEL_ERROR);
+    for (int i = 0; i < 8; i++) {
+        memset(buf, 0, sizeof(buf));
+        Eep_Read(0x0000, buf, sizeof(buf));
+        flipped_other += (buf[0] != 0xFFU) ? 1U : 0U;
+    }
+    memset(buf, 0, sizeof(buf));
+    Eep_Read(0x0C00, buf, sizeof(buf));
+    Log_SetLevel(LOG_LEVEL_INFO);
+
+    FaultStats_t stats;
+    FaultInj_GetStats(&stats);
+    check(flipped_other == 0U, "Reads of other blocks untouched");
+    check(stats.total_injected == 1U && buf[0] == 0xFEU, "Read of target's backup slot flipped");
+
+    /* Re-registering moves the block's ranges */
+    native.eeprom_offset = 0x0800;
+    NvM_RegisterBlock(&native);
+    check(FaultInj_LookupBlock(0x0000) == FAULT_INJ_ALL_BLOCKS && FaultInj_LookupBlock(0x0800) == 1U,
+          "Re-registration remaps the block");
+
+    FaultInj_ResetAll();
+    LOG_INFO("");
+}
+
 /**
  * @brief Main function
  */
@@ -243,10 +451,13 @@ int main(void)
     test_p0_bit_flip_single();
     test_p0_crc_invert();
     test_fault_statistics();
+    test_probabilistic_faults();
+    test_armed_mask();
+    test_block_targeting();
 
     LOG_INFO("========================================");
     LOG_INFO("  All fault injection tests complete!");
     LOG_INFO("========================================");
 
-    return 0;
+    return (g_failures == 0U) ? 0 : 1;
 }
@@ -18,8 +18,10 @@
 
 #include "nvm.h"
 #include "crc.h"
+#include "os_scheduler.h"
 #include "logging.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <assert.h>
@@ -154,6 +156,53 @@ static void test_crc32_known_vectors(void)
     LOG_INFO("  Result: Passed");
 }
 
+/**
+ * @brief Test catalogue check values ("123456789")
+ */
+static void test_crc_check_values(void)
+{
+    LOG_INFO("");
+    LOG_INFO("Test: CRC Check Values");
+
+    const uint8_t check[] = "123456789";
+
+    TEST_ASSERT_EQ(CRC_CalculateCRC8(check, 9), 0x4B, "CRC8 SAE-J1850 check value");
+    TEST_ASSERT_EQ(CRC_CalculateCRC16(check, 9), 0x29B1, "CRC16-CCITT check value");
+    TEST_ASSERT_EQ(CRC_CalculateCRC32(check, 9), 0xE3069283U, "CRC32C check value");
+
+    /* Hardware and table CRC32C paths must agree on unaligned tails */
+    static uint8_t buf[1031];
+    for (uint32_t i = 0; i < sizeof(buf); i++) {
+        buf[i] = (uint8_t)(i * 131U + 7U);
+    }
+    boolean consistent = TRUE;
+    for (uint32_t off = 0; off < 8; off++) {
+        uint32_t a = CRC_CalculateCRC32(&buf[off], 1000);
+        uint32_t b = CRC_CalculateCRC32(&buf[off], 1000);
+        const Crc_Descriptor_t *d = CRC_GetDescriptor(NVM_CRC32);
+        if (a != b || d == NULL || d->calculate(&buf[off], 1000) != a) {
+            consistent = FALSE;
+        }
+    }
+    TEST_ASSERT(consistent, "CRC32 descriptor matches direct API");
+
+    /* Descriptor table */
+    TEST_ASSERT_EQ(CRC_GetSize(NVM_CRC_NONE), 0, "NONE size 0");
+    TEST_ASSERT_EQ(CRC_GetSize(NVM_CRC8), 1, "CRC8 size 1");
+    TEST_ASSERT_EQ(CRC_GetSize(NVM_CRC16), 2, "CRC16 size 2");
+    TEST_ASSERT_EQ(CRC_GetSize(NVM_CRC32), 4, "CRC32 size 4");
+    TEST_ASSERT(CRC_GetDescriptor((NvM_CrcType_t)7) == NULL, "Unknown CRC type rejected");
+
+    /* Little-endian store/load round trip */
+    uint8_t raw[CRC_MAX_SIZE] = {0};
+    const Crc_Descriptor_t *d32 = CRC_GetDescriptor(NVM_CRC32);
+    CRC_Store(d32, 0xE3069283U, raw);
+    TEST_ASSERT(raw[0] == 0x83 && raw[3] == 0xE3, "CRC32 stored little-endian");
+    TEST_ASSERT_EQ(CRC_Load(d32, raw), 0xE3069283U, "CRC32 load round trip");
+
+    LOG_INFO("  Result: Passed");
+}
+
 /**
  * @brief Test CRC error detection (single-bit flip)
  */
@@ -254,7 +303,8 @@ static void test_crc_strength_comparison(void)
     LOG_INFO("");
     LOG_INFO("  Testing 1000 random patterns for collisions...");
 
-    srand((unsigned int)time(NULL));
+    /* Fixed seed: the counts below are expectations, not guarantees */
+    srand(12345U);
 
     for (int i = 0; i < 1000; i++) {
         /* Generate random pattern */
@@ -287,10 +337,13 @@ static void test_crc_strength_comparison(void)
     LOG_INFO("    CRC32: %u / 999 (%.2f%%)",
              crc32_collisions, crc32_collisions * 100.0 / 999);
 
-    TEST_ASSERT(crc8_collisions > crc16_collisions,
-               "CRC16 has fewer collisions than CRC8");
-    TEST_ASSERT(crc16_collisions > crc32_collisions,
-               "CRC32 has fewer collisions than CRC16");
+    /* Expected 999/256 ~ 3.9 for CRC8, 0.015 for CRC16, ~0 for CRC32: with
+     * so few samples the wider CRCs tie at zero, so compare with <= */
+    TEST_ASSERT(crc16_collisions <= crc8_collisions,
+               "CRC16 has no more collisions than CRC8");
+    TEST_ASSERT(crc32_collisions <= crc16_collisions,
+               "CRC32 has no more collisions than CRC16");
+    TEST_ASSERT(crc32_collisions == 0U, "No CRC32 collisions");
 
     LOG_INFO("  Result: Passed");
 }
@@ -403,6 +456,68 @@ static void test_crc_nvm_integration(void)
     LOG_INFO("  Result: Passed");
 }
 
+/**
+ * @brief Test CRC8 and CRC32 protected blocks through NvM
+ */
+static void test_crc_nvm_per_block_type(void)
+{
+    LOG_INFO("");
+    LOG_INFO("Test: Per-Block CRC Type Through NvM");
+
+    NvM_Init();
+    OsScheduler_Init(16);
+
+    static uint8_t data8[256];
+    static uint8_t data32[256];
+    NvM_BlockConfig_t block8 = {
+        .block_id = 2, .block_size = 256, .block_type = NVM_BLOCK_NATIVE,
+        .crc_type = NVM_CRC8, .priority = 10, .is_immediate = FALSE,
+        .is_write_protected = FALSE, .ram_mirror_ptr = data8,
+        .rom_block_ptr = NULL, .rom_block_size = 0, .eeprom_offset = 0x0400
+    };
+    NvM_BlockConfig_t block32 = {
+        .block_id = 3, .block_size = 256, .block_type = NVM_BLOCK_NATIVE,
+        .crc_type = NVM_CRC32, .priority = 10, .is_immediate = FALSE,
+        .is_write_protected = FALSE, .ram_mirror_ptr = data32,
+        .rom_block_ptr = NULL, .rom_block_size = 0, .eeprom_offset = 0x0800
+    };
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block8), E_OK, "CRC8 block registered");
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block32), E_OK, "CRC32 block registered");
+
+    memset(data8, 0x5A, sizeof(data8));
+    memset(data32, 0xC3, sizeof(data32));
+    NvM_WriteBlock(2, data8);
+    NvM_WriteBlock(3, data32);
+
+    uint8_t r8 = NVM_REQ_PENDING;
+    uint8_t r32 = NVM_REQ_PENDING;
+    for (uint32_t i = 0; i < 100 && (r8 == NVM_REQ_PENDING || r32 == NVM_REQ_PENDING); i++) {
+        NvM_MainFunction();
+        NvM_GetJobResult(2, &r8);
+        NvM_GetJobResult(3, &r32);
+    }
+    TEST_ASSERT_EQ(r8, NVM_REQ_OK, "CRC8 block write OK");
+    TEST_ASSERT_EQ(r32, NVM_REQ_OK, "CRC32 block write OK");
+
+    memset(data8, 0, sizeof(data8));
+    memset(data32, 0, sizeof(data32));
+    NvM_ReadBlock(2, data8);
+    NvM_ReadBlock(3, data32);
+    r8 = NVM_REQ_PENDING;
+    r32 = NVM_REQ_PENDING;
+    for (uint32_t i = 0; i < 100 && (r8 == NVM_REQ_PENDING || r32 == NVM_REQ_PENDING); i++) {
+        NvM_MainFunction();
+        NvM_GetJobResult(2, &r8);
+        NvM_GetJobResult(3, &r32);
+    }
+    TEST_ASSERT_EQ(r8, NVM_REQ_OK, "CRC8 block read OK");
+    TEST_ASSERT_EQ(r32, NVM_REQ_OK, "CRC32 block read OK");
+    TEST_ASSERT(data8[0] == 0x5A && data8[255] == 0x5A, "CRC8 block data intact");
+    TEST_ASSERT(data32[0] == 0xC3 && data32[255] == 0xC3, "CRC32 block data intact");
+
+    LOG_INFO("  Result: Passed");
+}
+
 /**
  * @brief Run all CRC tests
  */
@@ -417,11 +532,13 @@ int main(void)
     test_crc8_known_vectors();
     test_crc16_known_vectors();
     test_crc32_known_vectors();
+    test_crc_check_values();
     test_crc_error_detection_single_bit();
     test_crc_error_detection_multi_bit();
     test_crc_strength_comparison();
     test_crc_performance();
     test_crc_nvm_integration();
+    test_crc_nvm_per_block_type();
 
     /* Print summary */
     LOG_INFO("");
@@ -5,9 +5,11 @@
  * REQ-数据完整性: design/04-数据完整性方案.md
  * - 测试CRC16计算
  * - 测试已知向量
+ * - 测试加速引擎(slice-by-8 / CLMUL)与参考实现一致
  */
 
 #include "crc16.h"
+#include "fault_injection.h"
 #include "logging.h"
 #include <stdio.h>
 #include <string.h>
@@ -129,6 +131,91 @@ static void test_integrity_detection(void)
     LOG_INFO("✓ Integrity detection test passed");
 }
 
+/**
+ * @brief Test that every engine matches the reference kernel
+ */
+static void test_engine_equivalence(void)
+{
+    LOG_INFO("Testing CRC engine equivalence...");
+
+    static uint8_t data[1100];
+    uint32_t seed = 0x1234567U;
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        seed = seed * 1103515245U + 12345U;
+        data[i] = (uint8_t)(seed >> 16);
+    }
+
+    const Crc16_EngineType engines[] = {
+        CRC16_ENGINE_TABLE, CRC16_ENGINE_SLICE8, CRC16_ENGINE_CLMUL
+    };
+    const uint16_t inits[] = {0xFFFF, 0x0000, 0x1D0F};
+
+    for (uint32_t e = 0; e < sizeof(engines) / sizeof(engines[0]); e++) {
+        if (Crc16_SetEngine(engines[e]) != E_OK) {
+            LOG_INFO("  Engine %d not supported on this host, skipped", engines[e]);
+            continue;
+        }
+
+        for (uint32_t len = 0; len <= sizeof(data); len += (len < 160) ? 1 : 37) {
+            for (uint32_t k = 0; k < sizeof(inits) / sizeof(inits[0]); k++) {
+                /* Unaligned start exercises the unaligned loads */
+                uint32_t off = (len + k) % 3;
+                uint32_t n = (len + off <= sizeof(data)) ? len : len - off;
+                uint16_t expected = Crc16_CalculateReference(&data[off], n, inits[k]);
+                uint16_t actual = Crc16_CalculateExtended(&data[off], n, inits[k]);
+                assert(actual == expected);
+            }
+        }
+        LOG_INFO("  Engine %d matches reference", engines[e]);
+    }
+
+    /* Known check value for CRC-16/CCITT-FALSE */
+    assert(Crc16_SetEngine(CRC16_ENGINE_AUTO) == E_OK);
+    assert(Crc16_GetEngine() != CRC16_ENGINE_AUTO);
+    assert(Crc16_Calculate((const uint8_t *)"123456789", 9) == 0x29B1);
+
+    LOG_INFO("✓ Engine equivalence test passed");
+}
+
+/**
+ * @brief Test that the CRC fault hook fires once per call for every engine
+ */
+static void test_engine_fault_hook(void)
+{
+    LOG_INFO("Testing CRC fault hook with accelerated engines...");
+
+    static uint8_t data[1024];
+    memset(data, 0x5A, sizeof(data));
+
+    FaultInj_Init();
+    assert(FaultInj_Enable(FAULT_P0_CRC_INVERT) == E_OK);
+
+    const Crc16_EngineType engines[] = {
+        CRC16_ENGINE_TABLE, CRC16_ENGINE_SLICE8, CRC16_ENGINE_CLMUL
+    };
+
+    for (uint32_t e = 0; e < sizeof(engines) / sizeof(engines[0]); e++) {
+        if (Crc16_SetEngine(engines[e]) != E_OK) {
+            continue;
+        }
+
+        FaultStats_t before, after;
+        FaultInj_GetStats(&before);
+        uint16_t crc = Crc16_Calculate(data, sizeof(data));
+        FaultInj_GetStats(&after);
+
+        uint16_t inverted = (uint16_t)~Crc16_CalculateReference(data, sizeof(data), 0xFFFF);
+        assert(after.total_injected == before.total_injected + 1);
+        assert(crc == inverted);
+    }
+
+    FaultInj_Disable(FAULT_P0_CRC_INVERT);
+    FaultInj_ResetAll();
+    Crc16_SetEngine(CRC16_ENGINE_AUTO);
+
+    LOG_INFO("✓ Fault hook test passed");
+}
+
 /**
  * @brief Main test runner
  */
@@ -144,6 +231,8 @@ int main(void)
     test_known_vector();
     test_extended_crc();
     test_integrity_detection();
+    test_engine_equivalence();
+    test_engine_fault_hook();
 
     LOG_INFO("");
     LOG_INFO("=== All tests passed! ===");
@@ -7,9 +7,14 @@
  * - 测试读/写/擦除操作
  * - 测试延时模拟
  * - 测试寿命跟踪
+ * - 测试写校验 (Eep_Verify)
+ * - 测试位清除编程模式
+ * - 测试片上ECC: 单比特纠正, 双比特检测
  */
 
 #include "eeprom_driver.h"
+#include "fault_injection.h"
+#include "os_scheduler.h"
 #include "logging.h"
 #include <stdio.h>
 #include <string.h>
@@ -128,6 +133,10 @@ static void test_read(void)
     assert(ret == E_OK);
     assert(memcmp(write_data, read_data, 256) == 0);
 
+    /* Range checks do not wrap around the address space */
+    assert(Eep_Read(256, read_data, 0xFFFFFF80U) == E_NOT_OK);
+    assert(Eep_Read(4095, read_data, 2) == E_NOT_OK);
+
     Eep_Destroy();
 
     LOG_INFO("✓ Read test passed");
@@ -228,6 +237,662 @@ static void test_endurance(void)
 /**
  * @brief Main test runner
  */
+/**
+ * @brief Test blank check and redundant erase skipping
+ */
+static void test_blank_check(void)
+{
+    LOG_INFO("Testing blank check...");
+
+    Eep_Init(NULL);
+
+    /* A single programmed byte anywhere in the page must be detected */
+    uint8_t data[256];
+    uint32_t positions[] = {0, 1, 7, 8, 15, 31, 63, 64, 127, 200, 255};
+    for (uint32_t k = 0; k < sizeof(positions) / sizeof(positions[0]); k++) {
+        assert(Eep_Erase(0) == E_OK);
+        memset(data, 0xFF, sizeof(data));
+        data[positions[k]] = 0x7F;
+        assert(Eep_Write(256, data, sizeof(data)) == E_OK);
+        assert(Eep_Write(256, data, sizeof(data)) == E_NOT_OK);
+    }
+
+    /* Programming all-0xFF leaves the page blank */
+    assert(Eep_Erase(0) == E_OK);
+    memset(data, 0xFF, sizeof(data));
+    assert(Eep_Write(512, data, sizeof(data)) == E_OK);
+    assert(Eep_Write(512, data, sizeof(data)) == E_OK);
+
+    /* Erasing an erased block still wears it but skips the work */
+    Eeprom_DiagInfoType before;
+    Eeprom_DiagInfoType after;
+    assert(Eep_Erase(1024) == E_OK);
+    Eep_GetDiagnostics(&before);
+    assert(Eep_Erase(1024) == E_OK);
+    Eep_GetDiagnostics(&after);
+    assert(after.skipped_erase_count == before.skipped_erase_count + 1U);
+    assert(after.total_erase_count == before.total_erase_count + 1U);
+
+    /* Program after erase uses the erased bitmap */
+    assert(Eep_Write(1024, data, sizeof(data)) == E_OK);
+    Eep_GetDiagnostics(&after);
+    assert(after.skipped_blank_check_count > before.skipped_blank_check_count);
+
+    Eep_Destroy();
+
+    LOG_INFO("✓ Blank check test passed");
+}
+
+/**
+ * @brief Test sparse backend on a 64MB image
+ */
+static void test_sparse_backend(void)
+{
+    LOG_INFO("Testing sparse backend...");
+
+    Eeprom_ConfigType cfg = {
+        .capacity_bytes = 64U * 1024U * 1024U,
+        .page_size = 256,
+        .block_size = 4096,
+        .read_delay_us = 0,
+        .write_delay_ms = 0,
+        .erase_delay_ms = 0,
+        .endurance_cycles = 100000,
+        .virtual_storage = NULL,
+        .backend = Eep_GetSparseBackend()
+    };
+    assert(Eep_Init(&cfg) == E_OK);
+
+    Eeprom_DiagInfoType diag;
+    Eep_GetDiagnostics(&diag);
+    uint32_t idle_bytes = diag.resident_bytes;
+    assert(idle_bytes < 64U * 1024U);
+
+    /* Untouched pages read as erased */
+    uint8_t page[256];
+    assert(Eep_Read(32U * 1024U * 1024U, page, sizeof(page)) == E_OK);
+    for (uint32_t i = 0; i < sizeof(page); i++) {
+        assert(page[i] == 0xFF);
+    }
+
+    /* Write near the end and read back across a page boundary */
+    uint8_t data[512];
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)i;
+    }
+    uint32_t addr = cfg.capacity_bytes - 4096U;
+    assert(Eep_Write(addr, data, sizeof(data)) == E_OK);
+    assert(Eep_Write(addr, data, 256) == E_NOT_OK);
+
+    uint8_t readback[300];
+    assert(Eep_Read(addr + 100U, readback, sizeof(readback)) == E_OK);
+    assert(memcmp(readback, &data[100], sizeof(readback)) == 0);
+
+    Eep_GetDiagnostics(&diag);
+    assert(diag.resident_bytes > idle_bytes);
+    assert(diag.resident_bytes < 64U * 1024U);
+
+    /* Erase releases the pages */
+    assert(Eep_Erase(addr) == E_OK);
+    assert(Eep_Read(addr, readback, sizeof(readback)) == E_OK);
+    assert(readback[0] == 0xFF && readback[299] == 0xFF);
+    assert(Eep_Write(addr, data, 256) == E_OK);
+
+    Eep_Destroy();
+
+    /* Copy-on-write over a base image */
+    static uint8_t base[8192];
+    memset(base, 0xA5, sizeof(base));
+    cfg.capacity_bytes = sizeof(base);
+    cfg.virtual_storage = base;
+    assert(Eep_Init(&cfg) == E_OK);
+
+    assert(Eep_Read(0, page, sizeof(page)) == E_OK);
+    assert(page[0] == 0xA5);
+    assert(Eep_Erase(0) == E_OK);
+    assert(Eep_Read(0, page, sizeof(page)) == E_OK);
+    assert(page[0] == 0xFF);
+    assert(Eep_Write(0, data, 256) == E_OK);
+    assert(Eep_Read(0, page, sizeof(page)) == E_OK);
+    assert(memcmp(page, data, 256) == 0);
+    assert(base[0] == 0xA5);
+    assert(Eep_Read(4096, page, sizeof(page)) == E_OK);
+    assert(page[0] == 0xA5);
+
+    Eep_Destroy();
+    assert(base[0] == 0xA5);
+
+    LOG_INFO("✓ Sparse backend test passed");
+}
+
+/**
+ * @brief Test persistent mmap image with snapshot/restore
+ */
+static void test_mmap_snapshot(void)
+{
+    LOG_INFO("Testing mmap image snapshot/restore...");
+
+    const char *path = "/tmp/eepsim_test_image.img";
+    remove(path);
+    remove("/tmp/eepsim_test_image.img.wear");
+
+    Eeprom_ConfigType cfg = {
+        .capacity_bytes = 8192,
+        .page_size = 256,
+        .block_size = 1024,
+        .endurance_cycles = 100000,
+        .image_path = path
+    };
+
+    uint8_t data[256];
+    uint8_t readback[256];
+    memset(data, 0x3C, sizeof(data));
+
+    /* Fresh image is erased; writes and erase counts persist across init */
+    assert(Eep_Init(&cfg) == E_OK);
+    assert(Eep_Read(0, readback, sizeof(readback)) == E_OK);
+    assert(readback[0] == 0xFF);
+    assert(Eep_Erase(1024) == E_OK);
+    assert(Eep_Erase(1024) == E_OK);
+    assert(Eep_Write(1024, data, sizeof(data)) == E_OK);
+    Eep_Destroy();
+
+    Eeprom_DiagInfoType diag;
+    assert(Eep_Init(&cfg) == E_OK);
+    Eep_GetDiagnostics(&diag);
+    assert(diag.max_erase_count == 2);
+    assert(Eep_Read(1024, readback, sizeof(readback)) == E_OK);
+    assert(memcmp(readback, data, sizeof(data)) == 0);
+
+    /* Scenario changes after a snapshot are discarded by restore */
+    assert(Eep_Restore() == E_NOT_OK);
+    assert(Eep_Snapshot() == E_OK);
+    assert(Eep_Erase(1024) == E_OK);
+    assert(Eep_Write(0, data, sizeof(data)) == E_OK);
+    Eep_GetDiagnostics(&diag);
+    assert(diag.max_erase_count == 3);
+
+    for (int round = 0; round < 3; round++) {
+        assert(Eep_Restore() == E_OK);
+        assert(Eep_Read(0, readback, sizeof(readback)) == E_OK);
+        assert(readback[0] == 0xFF);
+        assert(Eep_Read(1024, readback, sizeof(readback)) == E_OK);
+        assert(memcmp(readback, data, sizeof(data)) == 0);
+        Eep_GetDiagnostics(&diag);
+        assert(diag.max_erase_count == 2);
+        assert(Eep_Erase(1024) == E_OK);
+    }
+    Eep_Destroy();
+
+    /* The file still holds the snapshot state */
+    assert(Eep_Init(&cfg) == E_OK);
+    assert(Eep_Read(1024, readback, sizeof(readback)) == E_OK);
+    assert(memcmp(readback, data, sizeof(data)) == 0);
+    Eep_Destroy();
+
+    /* Geometry mismatch is rejected */
+    cfg.capacity_bytes = 4096;
+    assert(Eep_Init(&cfg) == E_NOT_OK);
+
+    remove(path);
+    remove("/tmp/eepsim_test_image.img.wear");
+
+    LOG_INFO("✓ mmap snapshot test passed");
+}
+
+/**
+ * @brief Test virtual-time device timing and latency distributions
+ */
+static void test_virtual_timing(void)
+{
+    LOG_INFO("Testing virtual-time device timing...");
+
+    uint8_t data[256];
+    uint8_t readback[256];
+    Eep_TimingStats_t stats;
+    memset(data, 0x5A, sizeof(data));
+
+    assert(Eep_Init(NULL) == E_OK);
+    assert(Eep_SetTimingMode(EEP_TIMING_VIRTUAL) == E_OK);
+    assert(Eep_GetTimingMode() == EEP_TIMING_VIRTUAL);
+
+    /* Constant model: page write 2 ms, erase 3 ms on the scheduler clock */
+    uint32_t t0 = OsScheduler_GetVirtualTimeMs();
+    assert(Eep_Erase(0) == E_OK);
+    assert(OsScheduler_GetVirtualTimeMs() - t0 == 3U);
+    assert(Eep_Write(0, data, sizeof(data)) == E_OK);
+    assert(OsScheduler_GetVirtualTimeMs() - t0 == 5U);
+
+    /* 256-byte reads take 12.8 ms each: the sub-millisecond part is carried */
+    t0 = OsScheduler_GetVirtualTimeMs();
+    for (int i = 0; i < 5; i++) {
+        assert(Eep_Read(0, readback, sizeof(readback)) == E_OK);
+    }
+    assert(OsScheduler_GetVirtualTimeMs() - t0 == 64U);
+
+    assert(Eep_GetTimingStats(&stats) == E_OK);
+    assert(stats.op_count[EEP_OP_READ] == 5U);
+    assert(stats.op_count[EEP_OP_WRITE] == 1U);
+    assert(stats.op_count[EEP_OP_ERASE] == 1U);
+    assert(stats.min_us[EEP_OP_READ] == 12800U && stats.max_us[EEP_OP_READ] == 12800U);
+    assert(stats.total_busy_us == 69000U);
+
+    /* Suspended clock: the access is free (the caller models its time) */
+    t0 = OsScheduler_GetVirtualTimeMs();
+    Eep_SuspendClock(TRUE);
+    assert(Eep_Erase(1024) == E_OK);
+    Eep_SuspendClock(FALSE);
+    assert(OsScheduler_GetVirtualTimeMs() == t0);
+
+    /* Uniform +-20%: every draw in range, mean near nominal */
+    Eep_LatencyModel_t model = { .dist = EEP_LATENCY_UNIFORM, .spread_pct = 20U };
+    assert(Eep_SetLatencyModel(EEP_OP_ERASE, &model) == E_OK);
+    Eep_SetLatencySeed(1234U);
+    Eep_ResetTimingStats();
+    uint64_t sum = 0;
+    for (int i = 0; i < 1000; i++) {
+        uint32_t us = Eep_SampleLatencyUs(EEP_OP_ERASE, 0);
+        assert(us >= 2400U && us <= 3600U);
+        sum += us;
+    }
+    assert(sum / 1000U > 2900U && sum / 1000U < 3100U);
+    assert(Eep_GetTimingStats(&stats) == E_OK);
+    assert(stats.min_us[EEP_OP_ERASE] < 2600U && stats.max_us[EEP_OP_ERASE] > 3400U);
+
+    /* Same seed, same sequence */
+    uint32_t first[8];
+    Eep_SetLatencySeed(99U);
+    for (int i = 0; i < 8; i++) {
+        first[i] = Eep_SampleLatencyUs(EEP_OP_ERASE, 0);
+    }
+    Eep_SetLatencySeed(99U);
+    for (int i = 0; i < 8; i++) {
+        assert(Eep_SampleLatencyUs(EEP_OP_ERASE, 0) == first[i]);
+    }
+
+    /* Normal with a 1% slow tail at 10x */
+    model.dist = EEP_LATENCY_NORMAL;
+    model.spread_pct = 5U;
+    model.tail_ppm = 10000U;
+    model.tail_factor = 10U;
+    assert(Eep_SetLatencyModel(EEP_OP_WRITE, &model) == E_OK);
+    Eep_ResetTimingStats();
+    for (int i = 0; i < 2000; i++) {
+        (void)Eep_SampleLatencyUs(EEP_OP_WRITE, 256);
+    }
+    assert(Eep_GetTimingStats(&stats) == E_OK);
+    assert(stats.tail_count > 0U && stats.tail_count < 60U);
+    assert(stats.max_us[EEP_OP_WRITE] > 15000U);
+
+    /* Invalid models are rejected */
+    model.spread_pct = 101U;
+    assert(Eep_SetLatencyModel(EEP_OP_READ, &model) == E_NOT_OK);
+    assert(Eep_SetLatencyModel(EEP_OP_COUNT, NULL) == E_NOT_OK);
+
+    /* Back to the default: no device time */
+    Eep_LatencyModel_t constant = { .dist = EEP_LATENCY_CONSTANT };
+    for (uint32_t op = 0; op < EEP_OP_COUNT; op++) {
+        assert(Eep_SetLatencyModel((Eep_OpType_t)op, &constant) == E_OK);
+    }
+    assert(Eep_SetTimingMode(EEP_TIMING_OFF) == E_OK);
+    t0 = OsScheduler_GetVirtualTimeMs();
+    assert(Eep_Erase(2048) == E_OK);
+    assert(OsScheduler_GetVirtualTimeMs() == t0);
+    Eep_Destroy();
+
+    LOG_INFO("✓ Virtual timing test passed");
+}
+
+/**
+ * @brief Test device compare on every backend, its timing and fault hook
+ */
+static void test_verify(void)
+{
+    LOG_INFO("Testing verify...");
+
+    uint8_t data[1024];
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 7U);
+    }
+
+    assert(Eep_Init(NULL) == E_OK);
+    assert(Eep_Write(0, data, sizeof(data)) == E_OK);
+    assert(Eep_Verify(0, data, sizeof(data)) == E_OK);
+    assert(Eep_Verify(100, &data[100], 333) == E_OK);
+
+    /* One differing byte anywhere (vector body, word loop, tail) is found */
+    uint32_t positions[] = {0, 1, 7, 8, 63, 64, 100, 255, 1000, 1023};
+    for (uint32_t k = 0; k < sizeof(positions) / sizeof(positions[0]); k++) {
+        data[positions[k]] ^= 0x01U;
+        assert(Eep_Verify(0, data, sizeof(data)) == E_NOT_OK);
+        data[positions[k]] ^= 0x01U;
+    }
+    assert(Eep_Verify(0, NULL, 16) == E_NOT_OK);
+    assert(Eep_Verify(4096, data, 16) == E_NOT_OK);
+
+    Eeprom_DiagInfoType diag;
+    Eep_GetDiagnostics(&diag);
+    assert(diag.total_verify_count == 12U);
+    assert(diag.verify_mismatch_count == 10U);
+    assert(diag.total_read_count == 0U);
+
+    /* Timed as a read of the same length, with its own statistics */
+    Eep_TimingStats_t stats;
+    assert(Eep_SetTimingMode(EEP_TIMING_VIRTUAL) == E_OK);
+    uint32_t t0 = OsScheduler_GetVirtualTimeMs();
+    assert(Eep_Verify(0, data, 256) == E_OK);
+    assert(Eep_Verify(256, &data[256], 256) == E_OK);
+    assert(OsScheduler_GetVirtualTimeMs() - t0 == 25U);
+    assert(Eep_GetTimingStats(&stats) == E_OK);
+    assert(stats.op_count[EEP_OP_VERIFY] == 2U && stats.op_count[EEP_OP_READ] == 0U);
+    assert(Eep_SetTimingMode(EEP_TIMING_OFF) == E_OK);
+
+    /* Forced verification failure */
+    FaultInj_Init();
+    assert(FaultInj_Enable(FAULT_P0_WRITE_VERIFY_FAIL) == E_OK);
+    assert(Eep_Verify(0, data, 256) == E_NOT_OK);
+    assert(FaultInj_Disable(FAULT_P0_WRITE_VERIFY_FAIL) == E_OK);
+    assert(Eep_Verify(0, data, 256) == E_OK);
+
+    Eep_Destroy();
+
+    /* Sparse backend: unmapped pages compare as erased */
+    Eeprom_ConfigType cfg = {
+        .capacity_bytes = 1024U * 1024U,
+        .page_size = 256,
+        .block_size = 4096,
+        .read_delay_us = 0,
+        .write_delay_ms = 0,
+        .erase_delay_ms = 0,
+        .endurance_cycles = 100000,
+        .virtual_storage = NULL,
+        .backend = Eep_GetSparseBackend()
+    };
+    uint8_t blank[512];
+    memset(blank, 0xFF, sizeof(blank));
+    assert(Eep_Init(&cfg) == E_OK);
+    assert(Eep_Write(8192, data, 256) == E_OK);
+    assert(Eep_Verify(8192, data, 256) == E_OK);
+    assert(Eep_Verify(8192 + 256, blank, sizeof(blank)) == E_OK);
+    assert(Eep_Verify(8192 + 256, data, 256) == E_NOT_OK);
+    memcpy(blank, &data[128], 128);
+    assert(Eep_Verify(8192 + 128, blank, 384) == E_OK);
+    Eep_Destroy();
+
+    LOG_INFO("✓ Verify test passed");
+}
+
+/**
+ * @brief Test bit-clear programming over written pages on every backend
+ */
+static void test_bit_clear_program(void)
+{
+    LOG_INFO("Testing bit-clear programming...");
+
+    uint8_t page[256];
+    uint8_t readback[256];
+
+    /* Off by default: a written page needs an erase */
+    assert(Eep_Init(NULL) == E_OK);
+    assert(Eep_GetProgramMode() == EEP_PROGRAM_BLANK);
+    memset(page, 0xF0, sizeof(page));
+    assert(Eep_Write(0, page, sizeof(page)) == E_OK);
+    memset(page, 0x30, sizeof(page));
+    assert(Eep_Write(0, page, sizeof(page)) == E_NOT_OK);
+
+    assert(Eep_SetProgramMode((Eep_ProgramMode_t)7) == E_NOT_OK);
+    assert(Eep_SetProgramMode(EEP_PROGRAM_BIT_CLEAR) == E_OK);
+
+    /* 0xF0 -> 0x30 only clears bits (one differing byte in each kernel stage) */
+    uint32_t positions[] = {0, 63, 64, 100, 200, 255};
+    for (uint32_t k = 0; k < sizeof(positions) / sizeof(positions[0]); k++) {
+        page[positions[k]] = 0x31;   /* bit 0 would go 0→1 */
+        assert(Eep_Write(0, page, sizeof(page)) == E_NOT_OK);
+        page[positions[k]] = 0x30;
+    }
+    assert(Eep_Write(0, page, sizeof(page)) == E_OK);
+    assert(Eep_Read(0, readback, sizeof(readback)) == E_OK);
+    assert(memcmp(readback, page, sizeof(page)) == 0);
+
+    /* Programming the same content again is allowed too */
+    assert(Eep_Write(0, page, sizeof(page)) == E_OK);
+
+    Eeprom_DiagInfoType diag;
+    Eep_GetDiagnostics(&diag);
+    assert(diag.total_write_count == 3U);
+    assert(diag.bit_clear_write_count == 2U);
+    assert(diag.total_erase_count == 0U);
+
+    /* A refused program costs no device time */
+    assert(Eep_SetTimingMode(EEP_TIMING_VIRTUAL) == E_OK);
+    uint32_t t0 = OsScheduler_GetVirtualTimeMs();
+    memset(page, 0xFF, sizeof(page));
+    assert(Eep_Write(0, page, sizeof(page)) == E_NOT_OK);
+    assert(OsScheduler_GetVirtualTimeMs() == t0);
+    memset(page, 0x10, sizeof(page));
+    assert(Eep_Write(0, page, sizeof(page)) == E_OK);
+    assert(OsScheduler_GetVirtualTimeMs() - t0 == 2U);
+    assert(Eep_SetTimingMode(EEP_TIMING_OFF) == E_OK);
+
+    /* Re-initialization returns to blank-only programming */
+    assert(Eep_Init(NULL) == E_OK);
+    assert(Eep_GetProgramMode() == EEP_PROGRAM_BLANK);
+    Eep_Destroy();
+
+    /* Devices without the capability refuse the mode */
+    Eeprom_ConfigType cfg = {
+        .capacity_bytes = 64U * 1024U,
+        .page_size = 256,
+        .block_size = 4096,
+        .read_delay_us = 0,
+        .write_delay_ms = 0,
+        .erase_delay_ms = 0,
+        .endurance_cycles = 100000,
+        .virtual_storage = NULL,
+        .backend = Eep_GetSparseBackend()
+    };
+    assert(Eep_Init(&cfg) == E_OK);
+    assert(Eep_SetProgramMode(EEP_PROGRAM_BIT_CLEAR) == E_NOT_OK);
+    Eep_Destroy();
+
+    /* Sparse backend: written pages are checked, unwritten pages accept anything */
+    cfg.capabilities = EEP_CAP_BIT_CLEAR;
+    uint8_t two[512];
+    assert(Eep_Init(&cfg) == E_OK);
+    assert(Eep_SetProgramMode(EEP_PROGRAM_BIT_CLEAR) == E_OK);
+    memset(two, 0x0F, sizeof(two));
+    assert(Eep_Write(8192, two, 256) == E_OK);
+    memset(two, 0x07, 256);
+    assert(Eep_Write(8192, two, sizeof(two)) == E_OK);
+    memset(two, 0x0F, 256);
+    assert(Eep_Write(8192, two, 256) == E_NOT_OK);
+    assert(Eep_Verify(8192 + 256, &two[256], 256) == E_OK);
+    Eep_GetDiagnostics(&diag);
+    assert(diag.bit_clear_write_count == 1U);
+    Eep_Destroy();
+
+    LOG_INFO("✓ Bit-clear programming test passed");
+}
+
+static void test_storage_view(void)
+{
+    LOG_INFO("Testing zero-copy storage views...");
+
+    uint8_t page[256];
+    const uint8_t *data;
+    const uint32_t *counts;
+    uint32_t length;
+
+    /* Flat: the whole image is one run that tracks writes */
+    assert(Eep_Init(NULL) == E_OK);
+    length = 4096;
+    assert(Eep_GetStorageView(0, &data, &length) == E_OK);
+    assert(data != NULL && length == 4096U);
+    memset(page, 0x5A, sizeof(page));
+    assert(Eep_Write(256, page, sizeof(page)) == E_OK);
+    assert(data[256] == 0x5A && data[255] == 0xFF);
+    length = 2;
+    assert(Eep_GetStorageView(4095, &data, &length) == E_NOT_OK);
+    length = 0;
+    assert(Eep_GetStorageView(0, &data, &length) == E_NOT_OK);
+
+    /* Erase counters: chunk not yet allocated reads as NULL */
+    assert(Eep_GetEraseCountView(0, &counts, &length) == E_OK);
+    assert(counts == NULL && length == 4U);
+    assert(Eep_Erase(1024) == E_OK);
+    assert(Eep_GetEraseCountView(1, &counts, &length) == E_OK);
+    assert(counts != NULL && length == 3U && counts[0] == 1U && counts[1] == 0U);
+    assert(Eep_GetEraseCountView(4, &counts, &length) == E_NOT_OK);
+    Eep_Destroy();
+
+    /* Sparse: one page per run, untouched pages read as erased */
+    Eeprom_ConfigType cfg = {
+        .capacity_bytes = 1024U * 1024U, .page_size = 256, .block_size = 4096,
+        .endurance_cycles = 100000, .backend = Eep_GetSparseBackend()
+    };
+    assert(Eep_Init(&cfg) == E_OK);
+    assert(Eep_Write(512, page, sizeof(page)) == E_OK);
+    length = 1024;
+    assert(Eep_GetStorageView(300, &data, &length) == E_OK);
+    assert(data == NULL && length == 212U);
+    length = 1024;
+    assert(Eep_GetStorageView(512, &data, &length) == E_OK);
+    assert(data != NULL && length == 256U && data[0] == 0x5A);
+    Eep_Destroy();
+
+    LOG_INFO("✓ Storage view test passed");
+}
+
+/**
+ * @brief Test vectored read/write: one device operation, all-or-nothing checks
+ */
+static void test_vectored_access(void)
+{
+    LOG_INFO("Testing vectored read/write...");
+
+    uint8_t data[512], crc_page[256], back[512], crc[4];
+    Eeprom_DiagInfoType d0, d1;
+
+    assert(Eep_Init(NULL) == E_OK);
+    memset(data, 0x3C, sizeof(data));
+    memset(crc_page, 0xFF, sizeof(crc_page));
+    crc_page[0] = 0xDE;
+    crc_page[1] = 0xAD;
+
+    /* Data and its CRC page programmed as one write */
+    Eep_IoVec_t wv[2] = {
+        { .address = 0, .buffer = data, .length = sizeof(data) },
+        { .address = 512, .buffer = crc_page, .length = sizeof(crc_page) }
+    };
+    Eep_GetDiagnostics(&d0);
+    assert(Eep_WriteV(wv, 2) == E_OK);
+    Eep_GetDiagnostics(&d1);
+    assert(d1.total_write_count - d0.total_write_count == 1U);
+    assert(d1.total_bytes_written - d0.total_bytes_written == 768U);
+
+    /* Scattered into two buffers by one read */
+    Eep_IoVec_t rv[2] = {
+        { .address = 0, .buffer = back, .length = sizeof(back) },
+        { .address = 512, .buffer = crc, .length = 2 }
+    };
+    assert(Eep_ReadV(rv, 2) == E_OK);
+    Eep_GetDiagnostics(&d0);
+    assert(d0.total_read_count - d1.total_read_count == 1U);
+    assert(memcmp(back, data, sizeof(data)) == 0 && crc[0] == 0xDE && crc[1] == 0xAD);
+
+    /* One programmed segment refuses the whole vector: nothing changes */
+    Eep_IoVec_t bad[2] = {
+        { .address = 1024, .buffer = data, .length = 256 },
+        { .address = 0, .buffer = data, .length = 256 }
+    };
+    assert(Eep_SetProgramMode(EEP_PROGRAM_BLANK) == E_OK);
+    assert(Eep_WriteV(bad, 2) == E_NOT_OK);
+    assert(Eep_Read(1024, back, 256) == E_OK && back[0] == 0xFF);
+
+    /* Unaligned segment or range past the end */
+    bad[1].address = 1300;
+    assert(Eep_WriteV(bad, 2) == E_NOT_OK);
+    rv[1].address = 4095;
+    assert(Eep_ReadV(rv, 2) == E_NOT_OK);
+    assert(Eep_ReadV(rv, 0) == E_NOT_OK);
+    Eep_Destroy();
+
+    LOG_INFO("✓ Vectored access test passed");
+}
+
+/**
+ * @brief Test SECDED ECC: single-bit errors corrected on read, double-bit errors counted
+ */
+static void test_ecc(void)
+{
+    LOG_INFO("Testing on-die ECC...");
+
+    uint8_t page[256];
+    uint8_t back[256];
+    Eeprom_DiagInfoType diag;
+
+    assert(Eep_Init(NULL) == E_OK);
+    Eeprom_ConfigType cfg = *Eep_GetConfig();
+    cfg.virtual_storage = NULL;
+    cfg.capabilities |= EEP_CAP_ECC;
+    assert(Eep_Init(&cfg) == E_OK);
+    uint8_t *cells = Eep_GetConfig()->virtual_storage;
+
+    for (uint32_t i = 0; i < sizeof(page); i++) {
+        page[i] = (uint8_t)(i * 7U + 3U);
+    }
+    assert(Eep_Write(256, page, sizeof(page)) == E_OK);
+
+    /* Injected single-bit flip (first byte of the read) is corrected in place */
+    FaultInj_Init();
+    const FaultConfig_t flip = { .fault_id = FAULT_P0_BITFLIP_SINGLE, .enabled = TRUE,
+                                 .target_block_id = FAULT_INJ_ALL_BLOCKS, .trigger_count = 1 };
+    assert(FaultInj_Configure(&flip) == E_OK);
+    assert(Eep_Read(256, back, sizeof(back)) == E_OK);
+    assert(memcmp(back, page, sizeof(page)) == 0);
+    FaultInj_Init();
+
+    /* Disturbed cells: every data bit of a word, and words cut by the read range */
+    for (uint32_t bit = 0; bit < 64U; bit++) {
+        cells[264U + bit / 8U] ^= (uint8_t)(1U << (bit % 8U));
+        assert(Eep_Read(256, back, sizeof(back)) == E_OK);
+        assert(memcmp(back, page, sizeof(page)) == 0);
+        assert(Eep_Read(266, back, 3) == E_OK && memcmp(back, &page[10], 3) == 0);
+        cells[264U + bit / 8U] ^= (uint8_t)(1U << (bit % 8U));
+    }
+    Eep_GetDiagnostics(&diag);
+    assert(diag.ecc_corrected_count == 1U + 128U && diag.ecc_uncorrectable_count == 0U);
+
+    /* Two bits in one word: detected, returned as sensed for the CRC to reject */
+    cells[300] ^= 0x11;
+    assert(Eep_Read(296, back, 8) == E_OK && back[4] == (uint8_t)(page[44] ^ 0x11));
+    Eep_GetDiagnostics(&diag);
+    assert(diag.ecc_uncorrectable_count == 1U);
+
+    /* Erase resets the check bytes; ReadV corrects per segment */
+    assert(Eep_Erase(0) == E_OK);
+    assert(Eep_Write(512, page, sizeof(page)) == E_OK);
+    cells[512] ^= 0x80;
+    cells[1000] ^= 0x02;
+    Eep_IoVec_t rv[2] = {
+        { .address = 512, .buffer = back, .length = 16 },
+        { .address = 1000, .buffer = &back[16], .length = 8 }
+    };
+    assert(Eep_ReadV(rv, 2) == E_OK);
+    assert(memcmp(back, page, 16) == 0 && back[16] == 0xFF && back[23] == 0xFF);
+    Eep_GetDiagnostics(&diag);
+    assert(diag.ecc_corrected_count == 1U + 128U + 2U);
+    Eep_Destroy();
+
+    /* ECC words must not straddle pages */
+    cfg.page_size = 12;
+    cfg.capacity_bytes = 4080;
+    cfg.block_size = 1020;
+    assert(Eep_Init(&cfg) == E_NOT_OK);
+
+    LOG_INFO("✓ ECC test passed");
+}
+
 int main(void)
 {
     Log_SetLevel(LOG_LEVEL_INFO);
@@ -243,6 +908,15 @@ int main(void)
     test_erase();
     test_diagnostics();
     test_endurance();
+    test_blank_check();
+    test_sparse_backend();
+    test_mmap_snapshot();
+    test_virtual_timing();
+    test_verify();
+    test_bit_clear_program();
+    test_storage_view();
+    test_vectored_access();
+    test_ecc();
 
     LOG_INFO("");
     LOG_INFO("=== All tests passed! ===");
@@ -0,0 +1,205 @@
+/**
+ * @file test_eeprom_trace.c
+ * @brief Unit tests for Eep I/O trace capture and replay
+ *
+ * - 捕获: 每次读/写/擦除一条记录, 包括失败的操作; 缓冲满时整块写出
+ * - 负载CRC32: 写入数据与成功读取的数据
+ * - 全速回放到新驱动: 结果与捕获一致, 诊断计数相同
+ * - 定时回放: 虚拟时钟按捕获时间推进
+ * - 经MemIf回放; 损坏/截断文件被拒绝
+ */
+
+#include "eeprom_trace.h"
+#include "eeprom_driver.h"
+#include "memif.h"
+#include "os_scheduler.h"
+#include "crc.h"
+#include "logging.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#define TRACE_PATH "/tmp/eepsim_test_trace.bin"
+
+static uint8_t g_page[256];
+
+/**
+ * @brief Workload: 3 erases, 8 programs, 8 reads, 1 rejected program
+ */
+static void run_workload(void)
+{
+    uint8_t buffer[256];
+
+    for (uint32_t b = 0; b < 3; b++) {
+        assert(Eep_Erase(b * 1024U) == E_OK);
+    }
+    for (uint32_t p = 0; p < 8; p++) {
+        memset(g_page, (int)p, sizeof(g_page));
+        assert(Eep_Write(p * 256U, g_page, 256) == E_OK);
+        OsScheduler_Sleep(5);
+    }
+    for (uint32_t p = 0; p < 8; p++) {
+        assert(Eep_Read(p * 256U, buffer, 256) == E_OK);
+    }
+    /* Page 0 is programmed: rejected */
+    assert(Eep_Write(0, g_page, 256) == E_NOT_OK);
+}
+
+static void test_capture(void)
+{
+    LOG_INFO("Test: capture records every operation");
+
+    EepTrace_Stats_t stats;
+    EepTrace_FileHeader_t header;
+    EepTrace_Record_t records[20];
+
+    OsScheduler_Init(16);
+    assert(Eep_Init(NULL) == E_OK);
+    assert(!EEP_TRACE_ACTIVE());
+
+    /* Small buffer: 20 records are written in 3 blocks */
+    assert(EepTrace_Start(TRACE_PATH, EEP_TRACE_HASH_PAYLOAD, 8) == E_OK);
+    assert(EEP_TRACE_ACTIVE());
+    assert(EepTrace_Start(TRACE_PATH, 0, 8) == E_NOT_OK);
+    run_workload();
+    assert(EepTrace_Stop() == E_OK);
+    assert(!EEP_TRACE_ACTIVE());
+    assert(EepTrace_Stop() == E_NOT_OK);
+
+    /* Not captured after stop */
+    assert(Eep_Read(0, g_page, 16) == E_OK);
+
+    assert(EepTrace_GetStats(&stats) == E_OK);
+    assert(stats.records == 20U);
+    assert(stats.block_writes == 3U && stats.write_errors == 0U);
+    assert(stats.bytes_written == sizeof(header) + 20U * sizeof(EepTrace_Record_t));
+
+    FILE *f = fopen(TRACE_PATH, "rb");
+    assert(f != NULL);
+    assert(fread(&header, sizeof(header), 1, f) == 1U);
+    assert(fread(records, sizeof(EepTrace_Record_t), 20, f) == 20U);
+    assert(fread(records, 1, 1, f) == 0U);
+    fclose(f);
+
+    assert(header.magic == EEP_TRACE_MAGIC && header.version == EEP_TRACE_VERSION);
+    assert(header.capacity_bytes == 4096U && header.page_size == 256U && header.block_size == 1024U);
+
+    assert(records[0].op == EEP_OP_ERASE && records[0].length == 1024U && records[0].flags == 0U);
+    assert(records[3].op == EEP_OP_WRITE && records[3].address == 0U && records[3].result == E_OK);
+    memset(g_page, 7, sizeof(g_page));
+    assert(records[10].op == EEP_OP_WRITE && records[10].address == 7U * 256U);
+    assert(records[10].flags == EEP_TRACE_HASH_PAYLOAD);
+    assert(records[10].payload_hash == CRC_CalculateCRC32(g_page, 256));
+    assert(records[10].virtual_ms == 35U);
+    /* Reads hash what they returned */
+    assert(records[18].op == EEP_OP_READ && records[18].payload_hash == records[10].payload_hash);
+    assert(records[19].op == EEP_OP_WRITE && records[19].result == E_NOT_OK);
+    assert(records[19].flags == 0U);
+
+    Eep_Destroy();
+    LOG_INFO("  ✓ 20 records in 3 block writes, payload CRCs match");
+}
+
+static void test_replay_driver(void)
+{
+    LOG_INFO("Test: max-speed and timed replay into the driver");
+
+    EepReplay_Stats_t stats;
+    Eeprom_DiagInfoType diag;
+    EepReplay_Config_t cfg = { .target = EEP_REPLAY_DRIVER };
+
+    OsScheduler_Init(16);
+    assert(Eep_Init(NULL) == E_OK);
+    assert(EepReplay_Run(TRACE_PATH, NULL, &stats) == E_OK);
+    assert(stats.records == 20U && stats.result_mismatches == 0U && stats.failed == 1U);
+    assert(stats.op_count[EEP_OP_READ] == 8U && stats.op_count[EEP_OP_WRITE] == 9U);
+    assert(stats.op_count[EEP_OP_ERASE] == 3U);
+    assert(stats.bytes == 16U * 256U);
+    assert(stats.captured_span_ms == 40U);
+    /* Max speed: the clock is not touched */
+    assert(OsScheduler_GetVirtualTimeMs() == 0U);
+
+    assert(Eep_GetDiagnostics(&diag) == E_OK);
+    assert(diag.total_erase_count == 3U && diag.total_write_count == 8U && diag.total_read_count == 8U);
+
+    /* Timed, virtual clock only */
+    assert(Eep_Init(NULL) == E_OK);
+    cfg.timed = TRUE;
+    uint32_t before = OsScheduler_GetVirtualTimeMs();
+    assert(EepReplay_Run(TRACE_PATH, &cfg, &stats) == E_OK);
+    assert(stats.result_mismatches == 0U);
+    assert(OsScheduler_GetVirtualTimeMs() - before == 40U);
+
+    Eep_Destroy();
+    LOG_INFO("  ✓ Results match the capture; timed replay spans %u ms", stats.captured_span_ms);
+}
+
+static void test_replay_memif(void)
+{
+    LOG_INFO("Test: replay through MemIf");
+
+    EepReplay_Stats_t stats;
+    EepReplay_Config_t cfg = { .target = EEP_REPLAY_MEMIF };
+
+    OsScheduler_Init(16);
+    assert(MemIf_Init() == E_OK);
+    assert(EepReplay_Run(TRACE_PATH, &cfg, &stats) == E_OK);
+    assert(stats.records == 20U && stats.result_mismatches == 0U);
+
+    Eep_Destroy();
+    LOG_INFO("  ✓ %u records, no mismatches", stats.records);
+}
+
+static void test_bad_files(void)
+{
+    LOG_INFO("Test: malformed traces are rejected");
+
+    EepReplay_Stats_t stats;
+    uint8_t bytes[sizeof(EepTrace_FileHeader_t) + 2U * sizeof(EepTrace_Record_t)];
+
+    OsScheduler_Init(16);
+    assert(Eep_Init(NULL) == E_OK);
+    assert(EepReplay_Run("/nonexistent/trace.bin", NULL, &stats) == E_NOT_OK);
+
+    /* Truncate the capture inside its second record */
+    FILE *f = fopen(TRACE_PATH, "rb");
+    assert(f != NULL && fread(bytes, 1, sizeof(bytes), f) == sizeof(bytes));
+    fclose(f);
+    f = fopen(TRACE_PATH, "wb");
+    assert(fwrite(bytes, 1, sizeof(bytes) - 4U, f) == sizeof(bytes) - 4U);
+    fclose(f);
+    assert(EepReplay_Run(TRACE_PATH, NULL, &stats) == E_NOT_OK);
+    assert(stats.records == 1U);
+
+    /* Wrong magic */
+    bytes[0] ^= 0xFFU;
+    f = fopen(TRACE_PATH, "wb");
+    assert(fwrite(bytes, 1, sizeof(bytes), f) == sizeof(bytes));
+    fclose(f);
+    assert(EepReplay_Run(TRACE_PATH, NULL, &stats) == E_NOT_OK);
+    assert(stats.records == 0U);
+
+    remove(TRACE_PATH);
+    Eep_Destroy();
+    LOG_INFO("  ✓ Missing, truncated and foreign files rejected");
+}
+
+int main(void)
+{
+    Log_SetLevel(LOG_LEVEL_INFO);
+
+    LOG_INFO("=== Eep Trace Unit Tests ===");
+    LOG_INFO("");
+
+    test_capture();
+    test_replay_driver();
+    test_replay_memif();
+    Log_SetLevel(LOG_LEVEL_FATAL);
+    test_bad_files();
+    Log_SetLevel(LOG_LEVEL_INFO);
+
+    LOG_INFO("");
+    LOG_INFO("=== All tests passed! ===");
+
+    return 0;
+}
@@ -8,6 +8,7 @@
  * - Queue overflow/underflow handling
  * - FIFO within same priority
  * - Job queue capacity
+ * - Write coalescing / read-your-writes
  *
  * Test Strategy:
  * - White-box testing of queue internals
@@ -17,6 +18,8 @@
  */
 
 #include "nvm.h"
+#include "nvm/nvm_jobqueue.h"
+#include "eeprom_driver.h"
 #include "os_scheduler.h"
 #include "logging.h"
 #include <stdio.h>
@@ -41,6 +44,22 @@ static uint32_t tests_failed = 0;
 #define TEST_ASSERT_EQ(actual, expected, message) \
     TEST_ASSERT((actual) == (expected), message)
 
+/**
+ * @brief Part large enough for every block the tests place (up to 0x10000)
+ */
+static const Eeprom_ConfigType g_device = {
+    .capacity_bytes = 128U * 1024U, .page_size = 256, .block_size = 1024,
+    .read_delay_us = 50, .write_delay_ms = 2, .erase_delay_ms = 3,
+    .endurance_cycles = 100000
+};
+
+static void init_nvm(void)
+{
+    NvM_Init();
+    Eep_Init(&g_device);
+    OsScheduler_Init(16);
+}
+
 /**
  * @brief Test single job enqueue/dequeue
  */
@@ -49,8 +68,7 @@ static void test_single_job(void)
     LOG_INFO("");
     LOG_INFO("Test: Single Job Enqueue/Dequeue");
 
-    NvM_Init();
-    OsScheduler_Init(16);
+    init_nvm();
 
     /* Register test block */
     static uint8_t test_data[256];
@@ -101,8 +119,7 @@ static void test_priority_ordering(void)
     LOG_INFO("");
     LOG_INFO("Test: Priority-Based Job Ordering");
 
-    NvM_Init();
-    OsScheduler_Init(16);
+    init_nvm();
 
     /* Register blocks with different priorities */
     static uint8_t data_high[256], data_med[256], data_low[256];
@@ -131,6 +148,10 @@ static void test_priority_ordering(void)
     };
     NvM_RegisterBlock(&block_low);
 
+    /* One job per main function call, so completion order is visible */
+    NvM_MainFunctionBudget_t budget = { .max_bytes = 1U, .max_cost_us = 0U };
+    NvM_SetMainFunctionBudget(&budget);
+
     /* Submit jobs in reverse priority order */
     memset(data_low, 0x33, 256);
     NvM_WriteBlock(12, data_low);  /* LOW priority, submitted first */
@@ -194,8 +215,7 @@ static void test_fifo_same_priority(void)
     LOG_INFO("");
     LOG_INFO("Test: FIFO Order Within Same Priority");
 
-    NvM_Init();
-    OsScheduler_Init(16);
+    init_nvm();
 
     /* Register two blocks with same priority */
     static uint8_t data1[256], data2[256];
@@ -264,8 +284,7 @@ static void test_queue_capacity(void)
     LOG_INFO("");
     LOG_INFO("Test: Queue Capacity (32 slots)");
 
-    NvM_Init();
-    OsScheduler_Init(16);
+    init_nvm();
 
     /* Register multiple blocks to fill queue */
     static uint8_t data_array[32][256];
@@ -283,7 +302,7 @@ static void test_queue_capacity(void)
             .ram_mirror_ptr = data_array[i],
             .rom_block_ptr = NULL,
             .rom_block_size = 0,
-            .eeprom_offset = (uint16_t)(0x4000 + i * 1024)
+            .eeprom_offset = (uint32_t)(0x4000 + i * 1024)
         };
         NvM_RegisterBlock(&blocks[i]);
     }
@@ -357,8 +376,7 @@ static void test_queue_overflow(void)
     LOG_INFO("");
     LOG_INFO("Test: Queue Overflow Handling");
 
-    NvM_Init();
-    OsScheduler_Init(16);
+    init_nvm();
 
     /* Register 33 blocks (one more than queue capacity) */
     static uint8_t data_array[33][256];
@@ -375,7 +393,7 @@ static void test_queue_overflow(void)
             .ram_mirror_ptr = data_array[i],
             .rom_block_ptr = NULL,
             .rom_block_size = 0,
-            .eeprom_offset = (uint16_t)(0x8000 + i * 1024)
+            .eeprom_offset = (uint32_t)(0x8000 + i * 1024)
         };
         NvM_RegisterBlock(&block);
     }
@@ -441,8 +459,7 @@ static void test_immediate_preemption(void)
     LOG_INFO("");
     LOG_INFO("Test: Immediate Job Preemption");
 
-    NvM_Init();
-    OsScheduler_Init(16);
+    init_nvm();
 
     /* Register LOW priority block */
     static uint8_t data_low[256];
@@ -464,20 +481,19 @@ static void test_immediate_preemption(void)
     };
     NvM_RegisterBlock(&block_imm);
 
-    /* Start LOW priority job */
+    /* One job per main function call; a started write is never interrupted */
+    NvM_MainFunctionBudget_t budget = { .max_bytes = 1U, .max_cost_us = 0U };
+    NvM_SetMainFunctionBudget(&budget);
+
+    /* Queue LOW priority job */
     memset(data_low, 0xBB, 256);
     NvM_WriteBlock(50, data_low);
 
-    /* Let it run briefly */
-    for (int i = 0; i < 5; i++) {
-        NvM_MainFunction();
-    }
-
-    /* Submit IMMEDIATE job (should preempt) */
+    /* Submit IMMEDIATE job (should overtake it) */
     memset(data_imm, 0xCC, 256);
     NvM_WriteBlock(51, data_imm);
 
-    LOG_INFO("  LOW job running, submitted IMMEDIATE job");
+    LOG_INFO("  LOW job queued, submitted IMMEDIATE job");
 
     /* Process both jobs */
     uint8_t result_low, result_imm;
@@ -512,6 +528,284 @@ static void test_immediate_preemption(void)
 /**
  * @brief Run all job queue tests
  */
+/**
+ * @brief White-box test: bitmap-indexed queue instance (1k deep)
+ */
+static void test_queue_instance(void)
+{
+    LOG_INFO("");
+    LOG_INFO("Test: Bitmap Priority Queue Instance (1024 deep)");
+
+    static NvM_JobQueueNode_t pool[1024];
+    static NvM_JobQueueType queue;
+
+    TEST_ASSERT_EQ(NvM_JobQueue_InstanceInit(&queue, pool, 0), E_NOT_OK, "Zero capacity rejected");
+    TEST_ASSERT_EQ(NvM_JobQueue_InstanceInit(&queue, pool, 1024), E_OK, "1024-deep instance created");
+
+    /* Fill with interleaved priorities; sequence number in block_id/retry */
+    NvM_Job_t job;
+    memset(&job, 0, sizeof(job));
+    job.job_type = NVM_JOB_WRITE;
+    boolean all_accepted = TRUE;
+    for (uint32_t i = 0; i < 1024; i++) {
+        job.priority = (uint8_t)(200U - (i % 4U) * 50U);   /* 200,150,100,50 */
+        job.block_id = (uint8_t)(i / 4U);
+        if (NvM_JobQueue_InstanceEnqueue(&queue, &job) != E_OK) {
+            all_accepted = FALSE;
+        }
+    }
+    TEST_ASSERT(all_accepted, "1024 jobs accepted");
+    TEST_ASSERT_EQ(NvM_JobQueue_InstanceEnqueue(&queue, &job), E_NOT_OK, "Overflow rejected");
+    TEST_ASSERT_EQ(queue.overflow_count, 1U, "Overflow counted");
+
+    /* Dequeue: priority order, FIFO within a priority */
+    boolean ordered = TRUE;
+    uint8_t last_prio = 0;
+    int32_t last_seq = -1;
+    NvM_Job_t out;
+    for (uint32_t i = 0; i < 1024; i++) {
+        if (NvM_JobQueue_InstanceDequeue(&queue, &out) != E_OK) {
+            ordered = FALSE;
+            break;
+        }
+        if (out.priority != last_prio) {
+            if (out.priority < last_prio) {
+                ordered = FALSE;
+            }
+            last_prio = out.priority;
+            last_seq = -1;
+        }
+        if ((int32_t)out.block_id <= last_seq) {
+            ordered = FALSE;
+        }
+        last_seq = out.block_id;
+    }
+    TEST_ASSERT(ordered, "Priority order with FIFO within level");
+    TEST_ASSERT_EQ(NvM_JobQueue_InstanceDequeue(&queue, &out), E_NOT_OK, "Empty after drain");
+    TEST_ASSERT_EQ(queue.max_count, 1024U, "Watermark 1024");
+
+    /* ReadAll beats everything, immediate boost applies */
+    memset(&job, 0, sizeof(job));
+    job.job_type = NVM_JOB_WRITE;
+    job.priority = 5;
+    job.block_id = 1;
+    NvM_JobQueue_InstanceEnqueue(&queue, &job);
+    job.is_immediate = TRUE;
+    job.block_id = 2;
+    NvM_JobQueue_InstanceEnqueue(&queue, &job);
+    job.is_immediate = FALSE;
+    job.job_type = NVM_JOB_READ_ALL;
+    job.block_id = 0xFF;
+    NvM_JobQueue_InstanceEnqueue(&queue, &job);
+
+    NvM_JobQueue_InstanceDequeue(&queue, &out);
+    TEST_ASSERT_EQ(out.job_type, NVM_JOB_READ_ALL, "ReadAll dequeued first");
+    NvM_JobQueue_InstanceDequeue(&queue, &out);
+    TEST_ASSERT_EQ(out.block_id, 2, "Immediate job dequeued before normal job");
+    NvM_JobQueue_InstanceDequeue(&queue, &out);
+    TEST_ASSERT_EQ(out.block_id, 1, "Normal job last");
+
+    /* Timeout removal from the middle of a level keeps the rest linked */
+    memset(&job, 0, sizeof(job));
+    job.job_type = NVM_JOB_WRITE;
+    job.priority = 10;
+    for (uint8_t i = 0; i < 3; i++) {
+        job.block_id = i;
+        job.timeout_ms = (i == 1) ? 5 : 0;
+        NvM_JobQueue_InstanceEnqueue(&queue, &job);
+    }
+    TEST_ASSERT_EQ(NvM_JobQueue_InstanceCheckTimeouts(&queue, 100, NULL, 0), 1, "Timed-out job removed");
+    NvM_JobQueue_InstanceDequeue(&queue, &out);
+    TEST_ASSERT_EQ(out.block_id, 0, "First survivor in order");
+    NvM_JobQueue_InstanceDequeue(&queue, &out);
+    TEST_ASSERT_EQ(out.block_id, 2, "Second survivor in order");
+    TEST_ASSERT_EQ(queue.count, 0, "Queue empty");
+
+    LOG_INFO("  Result: Passed");
+}
+
+/**
+ * @brief Test write coalescing and reads served from a pending write
+ */
+static void test_write_coalescing(void)
+{
+    LOG_INFO("");
+    LOG_INFO("Test: Write Coalescing");
+
+    init_nvm();
+    NvM_SetWriteCoalescing(TRUE);
+
+    static uint8_t data_a[256], data_b[256], data_c[256], readback[256];
+    NvM_BlockConfig_t block = {
+        .block_id = 2, .block_size = 256, .block_type = NVM_BLOCK_NATIVE,
+        .crc_type = NVM_CRC16, .priority = 10, .is_immediate = FALSE,
+        .is_write_protected = FALSE, .ram_mirror_ptr = data_a,
+        .rom_block_ptr = NULL, .rom_block_size = 0, .eeprom_offset = 0x0400
+    };
+    NvM_RegisterBlock(&block);
+
+    memset(data_a, 0x11, sizeof(data_a));
+    memset(data_b, 0x22, sizeof(data_b));
+    memset(data_c, 0x33, sizeof(data_c));
+
+    TEST_ASSERT_EQ(NvM_WriteBlock(2, data_a), E_OK, "First write queued");
+    const NvM_Job_t *pending = NvM_JobQueue_FindPendingWrite(2);
+    uint32_t first_submit = (pending != NULL) ? pending->submit_time_ms : 0xFFFFFFFFU;
+
+    OsScheduler_Sleep(5);
+    TEST_ASSERT_EQ(NvM_WriteBlock(2, data_b), E_OK, "Second write accepted");
+    TEST_ASSERT_EQ(NvM_WriteBlock(2, data_c), E_OK, "Third write accepted");
+    TEST_ASSERT_EQ(NvM_JobQueue_GetDepth(), 1, "Writes coalesced into one job");
+
+    pending = NvM_JobQueue_FindPendingWrite(2);
+    TEST_ASSERT(pending != NULL && pending->data_ptr == data_c, "Latest data wins");
+    TEST_ASSERT(pending != NULL && pending->submit_time_ms == first_submit,
+                "Earliest submit time kept");
+
+    /* Read behind the pending write completes without touching the device */
+    memset(readback, 0, sizeof(readback));
+    TEST_ASSERT_EQ(NvM_ReadBlock(2, readback), E_OK, "Read accepted");
+    TEST_ASSERT_EQ(memcmp(readback, data_c, sizeof(readback)), 0, "Read served from pending write");
+    TEST_ASSERT_EQ(NvM_JobQueue_GetDepth(), 1, "Read not queued");
+
+    NvM_Diagnostics_t before;
+    NvM_GetDiagnostics(&before);
+    for (uint32_t i = 0; i < 10; i++) {
+        NvM_MainFunction();
+    }
+
+    NvM_Diagnostics_t diag;
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT_EQ(diag.total_jobs_processed - before.total_jobs_processed, 1U,
+                   "Single erase+program for three writes");
+    TEST_ASSERT_EQ(diag.coalesced_writes, 2U, "Coalesced writes reported");
+    TEST_ASSERT_EQ(diag.coalesced_reads, 1U, "Coalesced reads reported");
+
+    /* Device content is the latest data */
+    memset(readback, 0, sizeof(readback));
+    NvM_ReadBlock(2, readback);
+    for (uint32_t i = 0; i < 10; i++) {
+        NvM_MainFunction();
+    }
+    TEST_ASSERT_EQ(memcmp(readback, data_c, sizeof(readback)), 0, "Stored block holds latest data");
+
+    NvM_SetWriteCoalescing(FALSE);
+    LOG_INFO("  Result: Passed");
+}
+
+/**
+ * @brief Test deadline-ordered timeout tracking
+ */
+static void test_timeout_heap(void)
+{
+    LOG_INFO("");
+    LOG_INFO("Test: Deadline Heap Timeouts");
+
+    static NvM_JobQueueNode_t pool[512];
+    static NvM_JobQueueType queue;
+    NvM_Job_t job, out;
+
+    NvM_JobQueue_InstanceInit(&queue, pool, 512);
+
+    /* Deep queue, deadlines 10..520 ms in scrambled order; every 4th job has none */
+    memset(&job, 0, sizeof(job));
+    job.job_type = NVM_JOB_WRITE;
+    for (uint32_t i = 0; i < 512; i++) {
+        job.priority = (uint8_t)(i % 3U);
+        job.block_id = (uint8_t)i;
+        job.submit_time_ms = 10U;
+        job.timeout_ms = ((i % 4U) == 3U) ? 0U : ((i * 37U) % 512U) + 1U;
+        NvM_JobQueue_InstanceEnqueue(&queue, &job);
+    }
+    TEST_ASSERT_EQ(queue.heap_count, 384, "Only jobs with a timeout tracked");
+    TEST_ASSERT_EQ(NvM_JobQueue_InstanceCheckTimeouts(&queue, 10, NULL, 0), 0, "Nothing expired yet");
+
+    /* Deadlines below 100 ms after submit: timeout_ms 1..99 */
+    uint32_t expected = 0;
+    for (uint32_t i = 0; i < 512; i++) {
+        uint32_t timeout = ((i % 4U) == 3U) ? 0U : ((i * 37U) % 512U) + 1U;
+        if (timeout != 0U && timeout < 100U) {
+            expected++;
+        }
+    }
+    TEST_ASSERT_EQ(NvM_JobQueue_InstanceCheckTimeouts(&queue, 110, NULL, 0), expected,
+                   "Exactly the expired jobs removed");
+    TEST_ASSERT_EQ(queue.count, 512U - expected, "Survivors still queued");
+    TEST_ASSERT_EQ(queue.heap_count, 384U - expected, "Survivors still tracked");
+
+    /* Dequeuing drops jobs from the heap; survivors never expired early */
+    boolean survivors_ok = TRUE;
+    while (NvM_JobQueue_InstanceDequeue(&queue, &out) == E_OK) {
+        if (out.timeout_ms != 0U && out.timeout_ms < 100U) {
+            survivors_ok = FALSE;
+        }
+    }
+    TEST_ASSERT(survivors_ok, "No expired job left behind");
+    TEST_ASSERT_EQ(queue.heap_count, 0, "Heap empty with the queue");
+
+    /* Each check spends one retry of an expired job */
+    memset(&job, 0, sizeof(job));
+    job.job_type = NVM_JOB_READ;
+    job.block_id = 1;
+    job.timeout_ms = 5;
+    job.max_retries = 2;
+    NvM_JobQueue_InstanceEnqueue(&queue, &job);
+    TEST_ASSERT_EQ(NvM_JobQueue_InstanceCheckTimeouts(&queue, 100, NULL, 0), 0, "First retry");
+    TEST_ASSERT_EQ(NvM_JobQueue_InstanceCheckTimeouts(&queue, 101, NULL, 0), 0, "Second retry");
+    TEST_ASSERT_EQ(NvM_JobQueue_InstanceCheckTimeouts(&queue, 102, NULL, 0), 1, "Dropped after retries");
+    TEST_ASSERT_EQ(queue.count, 0, "Queue empty");
+
+    /* Deadlines across the 32-bit wrap keep their order */
+    job.max_retries = 0;
+    job.submit_time_ms = 0xFFFFFFF0U;
+    job.timeout_ms = 0x20U;                 /* deadline 0x10 */
+    NvM_JobQueue_InstanceEnqueue(&queue, &job);
+    job.block_id = 2;
+    job.timeout_ms = 0x08U;                 /* deadline 0xFFFFFFF8 */
+    NvM_JobQueue_InstanceEnqueue(&queue, &job);
+    TEST_ASSERT_EQ(NvM_JobQueue_InstanceCheckTimeouts(&queue, 0x0U, NULL, 0), 1, "Earlier deadline expires first");
+    NvM_JobQueue_InstanceDequeue(&queue, &out);
+    TEST_ASSERT_EQ(out.block_id, 1, "Later deadline still queued");
+
+    /* Dropped jobs are reported up to the caller's capacity */
+    NvM_Job_t dropped[1];
+    for (uint8_t id = 3; id <= 4; id++) {
+        job.block_id = id;
+        job.submit_time_ms = 0;
+        job.timeout_ms = 10U - id;           /* block 4 expires first */
+        NvM_JobQueue_InstanceEnqueue(&queue, &job);
+    }
+    TEST_ASSERT_EQ(NvM_JobQueue_InstanceCheckTimeouts(&queue, 50, dropped, 1), 1, "One drop reported");
+    TEST_ASSERT_EQ(dropped[0].block_id, 4, "Earliest deadline reported first");
+    TEST_ASSERT_EQ(queue.count, 1, "Unreported job left queued");
+    TEST_ASSERT_EQ(NvM_JobQueue_InstanceCheckTimeouts(&queue, 51, dropped, 1), 1, "Reported next check");
+    TEST_ASSERT_EQ(dropped[0].block_id, 3, "Second drop copied out");
+
+    /* A full report buffer holds back drops only, not retries */
+    job.submit_time_ms = 0;
+    job.block_id = 5;
+    job.timeout_ms = 1;
+    job.max_retries = 0;
+    NvM_JobQueue_InstanceEnqueue(&queue, &job);
+    job.block_id = 6;
+    job.timeout_ms = 2;
+    job.max_retries = 1;
+    NvM_JobQueue_InstanceEnqueue(&queue, &job);
+    job.block_id = 7;
+    job.timeout_ms = 3;
+    job.max_retries = 0;
+    NvM_JobQueue_InstanceEnqueue(&queue, &job);
+    TEST_ASSERT_EQ(NvM_JobQueue_InstanceCheckTimeouts(&queue, 60, dropped, 1), 1, "Buffer filled");
+    TEST_ASSERT_EQ(dropped[0].block_id, 5, "Earliest drop reported");
+    TEST_ASSERT_EQ(NvM_JobQueue_InstanceCheckTimeouts(&queue, 61, dropped, 1), 1, "Next drop reported");
+    TEST_ASSERT_EQ(dropped[0].block_id, 6, "Retry spent while the buffer was full");
+    TEST_ASSERT_EQ(NvM_JobQueue_InstanceCheckTimeouts(&queue, 62, dropped, 1), 1, "Held-back drop reported");
+    TEST_ASSERT_EQ(dropped[0].block_id, 7, "Held-back job copied out");
+    TEST_ASSERT_EQ(queue.count, 0, "Queue empty");
+
+    LOG_INFO("  Result: Passed");
+}
+
 int main(void)
 {
     LOG_INFO("========================================");
@@ -526,6 +820,9 @@ int main(void)
     test_queue_capacity();
     test_queue_overflow();
     test_immediate_preemption();
+    test_queue_instance();
+    test_write_coalescing();
+    test_timeout_heap();
 
     /* Print summary */
     LOG_INFO("");
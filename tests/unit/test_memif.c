@@ -0,0 +1,537 @@
+/**
+ * @file test_memif.c
+ * @brief Unit tests for the asynchronous MemIf job engine
+ *
+ * REQ-MemIf抽象层: design/02-NvM架构设计.md §1.1
+ * - 提交作业立即返回, 作业状态为 MEMIF_JOB_PENDING
+ * - 按页/块粒度在虚拟时间中推进
+ * - 完成时通过回调通知
+ * - 多设备地址路由与并行作业
+ * - EEPROM磨损均衡: 备用块轮换, 映射表持久化, 擦除计数直方图
+ * - 驱动虚拟时间模式: 异步作业的设备时间只计一次
+ * - 加速老化: 批量推进擦写计数, 均衡策略回放与真实擦写一致, 磨损相关误码
+ */
+
+#include "memif.h"
+#include "eeprom_driver.h"
+#include "fault_injection.h"
+#include "os_scheduler.h"
+#include "logging.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+/**
+ * @brief Callback bookkeeping
+ */
+static uint32_t g_callback_count = 0;
+static MemIf_JobStatus_t g_callback_status = MEMIF_JOB_PENDING;
+static uint32_t g_callback_latency_ms = 0;
+
+static void job_done(const MemIf_Job_t *job, void *user_ctx)
+{
+    uint32_t *tag = (uint32_t *)user_ctx;
+
+    g_callback_count++;
+    g_callback_status = job->status;
+    g_callback_latency_ms = job->complete_time_ms - job->submit_time_ms;
+    if (tag != NULL) {
+        (*tag)++;
+    }
+}
+
+/**
+ * @brief Run MemIf_MainFunction every virtual millisecond until idle
+ *
+ * @return Elapsed virtual milliseconds
+ */
+static uint32_t run_until_idle(uint32_t max_ms)
+{
+    uint32_t elapsed = 0;
+
+    MemIf_MainFunction();
+    while (MemIf_GetJobStatus() == MEMIF_JOB_PENDING && elapsed < max_ms) {
+        OsScheduler_Sleep(1);
+        elapsed++;
+        MemIf_MainFunction();
+    }
+
+    return elapsed;
+}
+
+/**
+ * @brief Test write job advances one page per write_delay_ms
+ */
+static void test_async_write(void)
+{
+    LOG_INFO("Testing asynchronous write...");
+
+    OsScheduler_Init(16);
+    MemIf_Init();
+
+    static uint8_t data[1024];
+    memset(data, 0x5A, sizeof(data));
+    uint32_t tag = 0;
+
+    g_callback_count = 0;
+    assert(MemIf_SubmitWrite(0, data, sizeof(data), job_done, &tag) == E_OK);
+    assert(MemIf_GetJobStatus() == MEMIF_JOB_PENDING);
+
+    /* Busy: second job is rejected */
+    assert(MemIf_SubmitErase(1024, 1024, NULL, NULL) == E_NOT_OK);
+
+    /* Nothing reaches the device before the first page program completes */
+    MemIf_MainFunction();
+    uint8_t probe[256];
+    assert(Eep_Read(0, probe, sizeof(probe)) == E_OK);
+    assert(probe[0] == 0xFF);
+    assert(MemIf_GetCurrentJob()->progress == 0);
+
+    /* 4 pages x 2ms */
+    OsScheduler_Sleep(2);
+    MemIf_MainFunction();
+    assert(MemIf_GetCurrentJob()->progress == 256);
+    assert(MemIf_GetJobStatus() == MEMIF_JOB_PENDING);
+
+    run_until_idle(100);
+    assert(MemIf_GetJobStatus() == MEMIF_JOB_OK);
+    assert(MemIf_GetJobResult() == E_OK);
+    assert(g_callback_count == 1 && tag == 1);
+    assert(g_callback_status == MEMIF_JOB_OK);
+    assert(g_callback_latency_ms == 8);
+
+    assert(Eep_Read(768, probe, sizeof(probe)) == E_OK);
+    assert(probe[0] == 0x5A && probe[255] == 0x5A);
+
+    LOG_INFO("✓ Asynchronous write test passed");
+}
+
+/**
+ * @brief Test read and erase jobs, failure and cancel paths
+ */
+static void test_async_read_erase(void)
+{
+    LOG_INFO("Testing asynchronous read/erase...");
+
+    OsScheduler_Init(16);
+    MemIf_Init();
+
+    static uint8_t data[256];
+    memset(data, 0xA5, sizeof(data));
+    assert(MemIf_Write(0, data, sizeof(data)) == E_OK);
+
+    /* 256 bytes x 50us = 12.8ms */
+    static uint8_t readback[256];
+    g_callback_count = 0;
+    assert(MemIf_SubmitRead(0, readback, sizeof(readback), job_done, NULL) == E_OK);
+    uint32_t elapsed = run_until_idle(100);
+    assert(elapsed == 13);
+    assert(g_callback_status == MEMIF_JOB_OK);
+    assert(memcmp(readback, data, sizeof(data)) == 0);
+
+    /* 2 blocks x 3ms */
+    assert(MemIf_SubmitErase(0, 2048, job_done, NULL) == E_OK);
+    elapsed = run_until_idle(100);
+    assert(elapsed == 6);
+    assert(g_callback_count == 2);
+    assert(Eep_Read(0, readback, 1) == E_OK && readback[0] == 0xFF);
+
+    /* Writing over programmed data fails at the device */
+    assert(MemIf_Write(0, data, sizeof(data)) == E_OK);
+    assert(MemIf_SubmitWrite(0, data, sizeof(data), job_done, NULL) == E_OK);
+    run_until_idle(100);
+    assert(MemIf_GetJobStatus() == MEMIF_JOB_FAILED);
+    assert(g_callback_status == MEMIF_JOB_FAILED);
+
+    /* Cancel while pending notifies once */
+    assert(MemIf_SubmitErase(0, 1024, job_done, NULL) == E_OK);
+    assert(MemIf_CancelJob() == E_OK);
+    assert(MemIf_GetJobStatus() == MEMIF_JOB_CANCELED);
+    assert(g_callback_count == 4);
+    assert(MemIf_CancelJob() == E_NOT_OK);
+    run_until_idle(100);
+    assert(g_callback_count == 4);
+
+    /* Unaligned erase is rejected up front */
+    assert(MemIf_SubmitErase(100, 1024, NULL, NULL) == E_NOT_OK);
+
+    LOG_INFO("✓ Asynchronous read/erase test passed");
+}
+
+/**
+ * @brief Test address routing and concurrent jobs across devices
+ */
+static void test_multi_device(void)
+{
+    LOG_INFO("Testing multi-device routing...");
+
+    OsScheduler_Init(16);
+    MemIf_Init();
+
+    MemIf_DeviceConfig_t ram = {
+        .type = MEMIF_DEVICE_RAM, .base_address = 0x10000, .size_bytes = 4096,
+        .page_size = 16, .block_size = 256,
+        .read_delay_us = 0, .write_delay_ms = 0, .erase_delay_ms = 0
+    };
+    MemIf_DeviceConfig_t flash = {
+        .type = MEMIF_DEVICE_FLASH, .base_address = 0x20000, .size_bytes = 8192,
+        .page_size = 256, .block_size = 2048,
+        .read_delay_us = 1, .write_delay_ms = 1, .erase_delay_ms = 10
+    };
+    MemIf_DeviceIdType ram_id = 0xFF;
+    MemIf_DeviceIdType flash_id = 0xFF;
+    assert(MemIf_AddDevice(&ram, &ram_id) == E_OK);
+    assert(MemIf_AddDevice(&flash, &flash_id) == E_OK);
+    assert(ram_id != MEMIF_DEVICE_ID_EEPROM && flash_id != ram_id);
+
+    /* Overlap with an existing range is rejected */
+    MemIf_DeviceConfig_t overlap = ram;
+    overlap.base_address = 0x10800;
+    assert(MemIf_AddDevice(&overlap, NULL) == E_NOT_OK);
+    overlap.base_address = 0x800;
+    assert(MemIf_AddDevice(&overlap, NULL) == E_NOT_OK);
+
+    MemIf_DeviceIdType id;
+    assert(MemIf_GetDeviceForAddress(0x100, &id) == E_OK && id == MEMIF_DEVICE_ID_EEPROM);
+    assert(MemIf_GetDeviceForAddress(0x10FFF, &id) == E_OK && id == ram_id);
+    assert(MemIf_GetDeviceForAddress(0x30000, &id) == E_NOT_OK);
+
+    /* RAM overwrites in place, no erase needed */
+    uint8_t a[16];
+    uint8_t b[16];
+    memset(a, 0x11, sizeof(a));
+    memset(b, 0x22, sizeof(b));
+    assert(MemIf_Write(0x10010, a, sizeof(a)) == E_OK);
+    assert(MemIf_Write(0x10010, b, sizeof(b)) == E_OK);
+    uint8_t rb[16];
+    assert(MemIf_Read(0x10010, rb, sizeof(rb)) == E_OK);
+    assert(memcmp(rb, b, sizeof(b)) == 0);
+
+    /* A range spanning the end of a device is rejected */
+    assert(MemIf_Read(0x10FF8, rb, sizeof(rb)) == E_NOT_OK);
+
+    /* Flash requires erase before write */
+    static uint8_t page[1024];
+    memset(page, 0x33, sizeof(page));
+    assert(MemIf_Write(0x20000, page, 256) == E_OK);
+    assert(MemIf_Write(0x20000, page, 256) == E_NOT_OK);
+    assert(MemIf_Erase(0x20000, 2048) == E_OK);
+
+    /* EEPROM (4 x 2ms) and flash (4 x 1ms) overlap in time */
+    static uint8_t eep_data[1024];
+    memset(eep_data, 0x44, sizeof(eep_data));
+    g_callback_count = 0;
+    assert(MemIf_SubmitWrite(0, eep_data, sizeof(eep_data), job_done, NULL) == E_OK);
+    assert(MemIf_SubmitWrite(0x20000, page, sizeof(page), job_done, NULL) == E_OK);
+    assert(MemIf_GetDeviceJobStatus(MEMIF_DEVICE_ID_EEPROM) == MEMIF_JOB_PENDING);
+    assert(MemIf_GetDeviceJobStatus(flash_id) == MEMIF_JOB_PENDING);
+
+    uint32_t elapsed = 0;
+    MemIf_MainFunction();
+    while ((MemIf_GetDeviceJobStatus(MEMIF_DEVICE_ID_EEPROM) == MEMIF_JOB_PENDING ||
+            MemIf_GetDeviceJobStatus(flash_id) == MEMIF_JOB_PENDING) && elapsed < 100) {
+        OsScheduler_Sleep(1);
+        elapsed++;
+        MemIf_MainFunction();
+    }
+    assert(elapsed == 8);
+    assert(g_callback_count == 2);
+    assert(MemIf_GetDeviceJob(flash_id)->complete_time_ms -
+           MemIf_GetDeviceJob(flash_id)->submit_time_ms == 4);
+    assert(MemIf_GetDeviceJobStatus(MEMIF_DEVICE_ID_EEPROM) == MEMIF_JOB_OK);
+    assert(MemIf_GetDeviceJobStatus(flash_id) == MEMIF_JOB_OK);
+
+    assert(MemIf_Read(0x20300, rb, sizeof(rb)) == E_OK && rb[0] == 0x33);
+
+    /* Re-init drops emulated devices */
+    MemIf_Init();
+    assert(MemIf_GetDeviceForAddress(0x10000, &id) == E_NOT_OK);
+
+    LOG_INFO("✓ Multi-device routing test passed");
+}
+
+/**
+ * @brief Test a hot slot rotates over the spares and the map survives re-enable
+ */
+static void test_wear_leveling(void)
+{
+    LOG_INFO("Testing wear leveling...");
+
+    OsScheduler_Init(16);
+    MemIf_Init();
+
+    Eeprom_ConfigType cfg = *Eep_GetConfig();
+    cfg.capacity_bytes = 16U * 1024U;
+    cfg.virtual_storage = NULL;
+    assert(Eep_Init(&cfg) == E_OK);
+
+    /* 4 logical + 2 spare slots at 0x0000, metadata blocks at 0x1800/0x1C00 */
+    const MemIf_WearLevelConfig_t wl = {
+        .base_address = 0, .logical_slots = 4, .spare_slots = 2, .threshold = 8
+    };
+    MemIf_WearLevelStats_t stats;
+    assert(MemIf_EnableWearLeveling(&wl) == E_OK);
+    assert(MemIf_GetWearLevelStats(&stats) == E_OK);
+    assert(stats.meta_writes == 1 && stats.remaps == 0);
+
+    /* Spare and metadata blocks are hidden */
+    static uint8_t page[256];
+    static uint8_t rb[1024];
+    uint32_t physical;
+    assert(MemIf_Read(4U * 1024U, page, sizeof(page)) == E_NOT_OK);
+    assert(MemIf_Erase(0x1800, 1024) == E_NOT_OK);
+    assert(MemIf_WearLevelTranslate(0x1C00, &physical) == E_NOT_OK);
+    assert(MemIf_WearLevelTranslate(0x2000, &physical) == E_OK && physical == 0x2000);
+
+    /* Cold data in slot 1 */
+    memset(page, 0xC1, sizeof(page));
+    assert(MemIf_Erase(0x400, 1024) == E_OK);
+    assert(MemIf_Write(0x400, page, sizeof(page)) == E_OK);
+
+    /* Hot slot 0: rewritten 240 times */
+    const uint32_t rounds = 240;
+    for (uint32_t i = 0; i < rounds; i++) {
+        memset(page, (int)(i & 0xFFU), sizeof(page));
+        assert(MemIf_Erase(0, 1024) == E_OK);
+        assert(MemIf_Write(0, page, sizeof(page)) == E_OK);
+        assert(MemIf_Read(0, rb, sizeof(page)) == E_OK);
+        assert(memcmp(rb, page, sizeof(page)) == 0);
+    }
+
+    /* The hot slot's wear is spread over its block and both spares */
+    assert(MemIf_GetWearLevelStats(&stats) == E_OK);
+    assert(stats.remaps >= (rounds / wl.threshold) / 2U);
+    assert(stats.meta_writes == stats.remaps + 1U);
+    assert(stats.meta_erases >= 2);
+
+    MemIf_WearHistogram_t hist;
+    assert(MemIf_GetWearHistogram(16, &hist) == E_OK);
+    assert(hist.block_count == 16);
+    assert(hist.max_erase_count <= rounds / 3U + wl.threshold + 1U);
+    assert(hist.min_erase_count == 0);
+    assert(hist.buckets[0] >= 10);  /* Untouched blocks */
+    assert(MemIf_GetWearHistogram(0, &hist) == E_NOT_OK);
+
+    /* A crossing job cannot be split; a slot-local one is translated */
+    assert(MemIf_SubmitRead(0x300, rb, 0x200, NULL, NULL) == E_NOT_OK);
+    memset(rb, 0, sizeof(rb));
+    assert(MemIf_SubmitRead(0x300, rb, 0x100, NULL, NULL) == E_OK);
+    run_until_idle(1000);
+    assert(MemIf_GetJobStatus() == MEMIF_JOB_OK);
+    assert(rb[0] == 0xFF);
+    /* Crossing sync read: tail of slot 0, head of slot 1 */
+    assert(MemIf_Read(0x380, rb, 0x100) == E_OK);
+    assert(rb[0] == 0xFF && rb[0x80] == 0xC1);
+
+    /* Restart: the map is reloaded from the newest record */
+    uint32_t before;
+    assert(MemIf_WearLevelTranslate(0, &before) == E_OK);
+    MemIf_DisableWearLeveling();
+    assert(MemIf_WearLevelTranslate(0, &physical) == E_OK && physical == 0);
+    assert(MemIf_EnableWearLeveling(&wl) == E_OK);
+    assert(MemIf_WearLevelTranslate(0, &physical) == E_OK && physical == before);
+    assert(MemIf_Read(0, rb, sizeof(page)) == E_OK && rb[0] == (uint8_t)((rounds - 1U) & 0xFFU));
+    assert(MemIf_Read(0x400, rb, sizeof(page)) == E_OK && rb[0] == 0xC1);
+    assert(MemIf_GetWearLevelStats(&stats) == E_OK && stats.meta_writes == 0);
+
+    /* Re-init drops wear leveling */
+    MemIf_Init();
+    assert(MemIf_GetWearLevelStats(&stats) == E_NOT_OK);
+
+    LOG_INFO("✓ Wear leveling test passed");
+}
+
+/**
+ * @brief Test async jobs under driver virtual timing are charged once
+ */
+static void test_driver_timing(void)
+{
+    LOG_INFO("Testing async jobs under driver virtual timing...");
+
+    OsScheduler_Init(16);
+    MemIf_Init();
+    assert(Eep_SetTimingMode(EEP_TIMING_VIRTUAL) == E_OK);
+
+    static uint8_t data[1024];
+    memset(data, 0xA5, sizeof(data));
+
+    /* Step delays come from the driver model; the device access itself is free */
+    uint32_t t0 = OsScheduler_GetVirtualTimeMs();
+    assert(MemIf_SubmitWrite(0, data, sizeof(data), job_done, NULL) == E_OK);
+    run_until_idle(100);
+    assert(MemIf_GetJobStatus() == MEMIF_JOB_OK);
+    assert(g_callback_latency_ms == 8);
+    assert(OsScheduler_GetVirtualTimeMs() - t0 == 8U);
+
+    Eep_TimingStats_t stats;
+    assert(Eep_GetTimingStats(&stats) == E_OK);
+    assert(stats.op_count[EEP_OP_WRITE] == 4U);
+
+    /* A synchronous erase is charged by the driver */
+    t0 = OsScheduler_GetVirtualTimeMs();
+    assert(MemIf_Erase(1024, 1024) == E_OK);
+    assert(OsScheduler_GetVirtualTimeMs() - t0 == 3U);
+
+    assert(Eep_SetTimingMode(EEP_TIMING_OFF) == E_OK);
+
+    LOG_INFO("✓ Driver timing test passed");
+}
+
+/**
+ * @brief Fresh 16 KB device with 4 logical + 2 spare leveled slots at 0x0000
+ */
+static void aging_setup(const MemIf_WearLevelConfig_t *wl)
+{
+    MemIf_Init();
+
+    Eeprom_ConfigType cfg = *Eep_GetConfig();
+    cfg.capacity_bytes = 16U * 1024U;
+    cfg.virtual_storage = NULL;
+    Eep_Destroy();
+    assert(Eep_Init(&cfg) == E_OK);
+    assert(MemIf_EnableWearLeveling(wl) == E_OK);
+}
+
+/**
+ * @brief Test accelerated aging against real erases and its bit error model
+ */
+static void test_accelerated_aging(void)
+{
+    LOG_INFO("Testing accelerated aging...");
+
+    const MemIf_WearLevelConfig_t wl = {
+        .base_address = 0, .logical_slots = 4, .spare_slots = 2, .threshold = 8
+    };
+    static uint8_t page[256];
+    static uint8_t rb[1024];
+    MemIf_WearLevelStats_t real_stats;
+    MemIf_WearHistogram_t real_hist;
+    MemIf_WearLevelStats_t stats;
+    MemIf_WearHistogram_t hist;
+    MemIf_AgingResult_t result;
+
+    OsScheduler_Init(16);
+
+    /* Reference: slot 0 erased 240 times, slot 2 60 times, for real */
+    aging_setup(&wl);
+    for (uint32_t i = 0; i < 240U; i++) {
+        assert(MemIf_Erase(0, 1024) == E_OK);
+        if ((i % 4U) == 0U) {
+            assert(MemIf_Erase(0x800, 1024) == E_OK);
+        }
+    }
+    assert(MemIf_GetWearLevelStats(&real_stats) == E_OK);
+    assert(MemIf_GetWearHistogram(16, &real_hist) == E_OK);
+
+    /* Same workload, fast-forwarded: one year at those rates */
+    aging_setup(&wl);
+    memset(page, 0xC1, sizeof(page));
+    assert(MemIf_Write(0x400, page, sizeof(page)) == E_OK);
+    memset(page, 0x5A, sizeof(page));
+    assert(MemIf_Write(0, page, sizeof(page)) == E_OK);
+
+    const MemIf_AgingRate_t rates[] = {
+        { .address = 0x0000, .cycles_per_year = 240 },
+        { .address = 0x0800, .cycles_per_year = 60 },
+    };
+    MemIf_AgingProfile_t profile = { .rates = rates, .rate_count = 2, .days = 365 };
+    assert(MemIf_Age(&profile, &result) == E_OK);
+    assert(MemIf_GetWearLevelStats(&stats) == E_OK);
+    assert(MemIf_GetWearHistogram(16, &hist) == E_OK);
+    LOG_INFO("  real: %u remaps, max %u; aged: %u remaps, max %u, +%u cycles",
+             real_stats.remaps, real_hist.max_erase_count, result.remaps,
+             hist.max_erase_count, result.erases);
+
+    assert(result.remaps == stats.remaps && result.worn_out_blocks == 0U);
+    assert(result.remaps + 2U >= real_stats.remaps && result.remaps <= real_stats.remaps + 2U);
+    assert(hist.max_erase_count + wl.threshold >= real_hist.max_erase_count &&
+           hist.max_erase_count <= real_hist.max_erase_count + wl.threshold);
+    assert(hist.total_erase_count >= 300U);
+    assert(stats.meta_writes == result.remaps + 1U);
+
+    /* Moved slots keep their data; the aged map is persisted */
+    uint32_t physical;
+    assert(MemIf_WearLevelTranslate(0, &physical) == E_OK && physical != 0U);
+    assert(MemIf_Read(0, rb, sizeof(page)) == E_OK && rb[0] == 0x5A && rb[255] == 0x5A);
+    assert(MemIf_Read(0x400, rb, sizeof(page)) == E_OK && rb[0] == 0xC1);
+    MemIf_DisableWearLeveling();
+    assert(MemIf_EnableWearLeveling(&wl) == E_OK);
+    uint32_t reloaded;
+    assert(MemIf_WearLevelTranslate(0, &reloaded) == E_OK && reloaded == physical);
+
+    /* Ten years of a block outside the range: saturates at the endurance */
+    const uint32_t endurance = Eep_GetConfig()->endurance_cycles;
+    const MemIf_AgingRate_t hot = { .address = 0x2000, .cycles_per_year = endurance / 5U };
+    profile.rates = &hot;
+    profile.rate_count = 1;
+    profile.days = 3650;
+    assert(MemIf_Age(&profile, &result) == E_OK);
+    uint32_t count;
+    assert(Eep_GetEraseCount(0x2000, &count) == E_OK && count == endurance);
+    assert(result.erases == endurance && result.worn_out_blocks == 1U);
+    assert(MemIf_Erase(0x2000, 1024) == E_NOT_OK);
+
+    /* Reserved and unaligned addresses are rejected up front */
+    const MemIf_AgingRate_t bad[] = { { .address = 0x1800, .cycles_per_year = 1 } };
+    profile.rates = bad;
+    assert(MemIf_Age(&profile, NULL) == E_NOT_OK);
+    const MemIf_AgingRate_t unaligned = { .address = 0x2010, .cycles_per_year = 1 };
+    profile.rates = &unaligned;
+    assert(MemIf_Age(&profile, NULL) == E_NOT_OK);
+    assert(MemIf_Age(NULL, NULL) == E_NOT_OK);
+
+    /* Bit errors grow with wear: the worn block flips, a fresh one does not */
+    FaultInj_Init();
+    const FaultWearModel_t model = { .ber_ppb_at_endurance = 1000000U, .exponent = 2 };
+    assert(FaultInj_SetWearModel(&model) == E_OK);
+    const FaultConfig_t fault = { .fault_id = FAULT_WEAR_BITFLIP, .enabled = TRUE,
+                                  .target_block_id = FAULT_INJ_ALL_BLOCKS };
+    assert(FaultInj_Configure(&fault) == E_OK);
+
+    uint32_t worn_errors = 0;
+    uint32_t fresh_errors = 0;
+    for (uint32_t n = 0; n < 8U; n++) {
+        assert(MemIf_Read(0x2000, rb, sizeof(rb)) == E_OK);
+        for (uint32_t i = 0; i < sizeof(rb); i++) {
+            worn_errors += (uint32_t)__builtin_popcount((uint8_t)(rb[i] ^ 0xFFU));
+        }
+        assert(MemIf_Read(0x2400, rb, sizeof(rb)) == E_OK);
+        for (uint32_t i = 0; i < sizeof(rb); i++) {
+            fresh_errors += (uint32_t)__builtin_popcount((uint8_t)(rb[i] ^ 0xFFU));
+        }
+    }
+    LOG_INFO("  bit errors in 8 reads: worn %u, fresh %u", worn_errors, fresh_errors);
+    assert(worn_errors >= 32U && worn_errors <= 100U);   /* ~8.2 per read */
+    assert(fresh_errors == 0U);
+
+    FaultStats_t fstats;
+    assert(FaultInj_GetStats(&fstats) == E_OK && fstats.total_injected == 8U);
+    FaultWearModel_t steep = model;
+    steep.exponent = 9;
+    assert(FaultInj_SetWearModel(&steep) == E_NOT_OK);
+    FaultInj_Init();
+
+    LOG_INFO("✓ Accelerated aging test passed");
+}
+
+int main(void)
+{
+    Log_SetLevel(LOG_LEVEL_INFO);
+
+    LOG_INFO("=== MemIf Unit Tests ===");
+    LOG_INFO("");
+
+    test_async_write();
+    test_async_read_erase();
+    test_multi_device();
+    test_wear_leveling();
+    test_driver_timing();
+    test_accelerated_aging();
+
+    Eep_Destroy();
+
+    LOG_INFO("");
+    LOG_INFO("=== All tests passed! ===");
+
+    return 0;
+}
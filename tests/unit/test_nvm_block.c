@@ -7,6 +7,13 @@
  * - Block configuration validation
  * - Block lifecycle management
  * - Multi-block coordination
+ * - Large block registry (200+ blocks)
+ * - Log-structured blocks (append, compaction, index rebuild)
+ * - Inline CRC placement (one program / one read per block)
+ * - Idle pre-erase of the next dataset slot
+ * - Newest dataset slot recovered from the slot sequence headers
+ * - In-place bit-clear updates without an erase
+ * - Delta page writes of LOG blocks (only changed pages appended)
  *
  * Test Strategy:
  * - Functional testing of block APIs
@@ -15,6 +22,8 @@
  */
 
 #include "nvm.h"
+#include "eeprom_driver.h"
+#include "crc.h"
 #include "os_scheduler.h"
 #include "logging.h"
 #include <stdio.h>
@@ -38,6 +47,22 @@ static uint32_t tests_failed = 0;
 #define TEST_ASSERT_EQ(actual, expected, message) \
     TEST_ASSERT((actual) == (expected), message)
 
+/**
+ * @brief Part large enough for the registration tests' blocks (up to 0x5C00)
+ */
+static const Eeprom_ConfigType g_device = {
+    .capacity_bytes = 32U * 1024U, .page_size = 256, .block_size = 1024,
+    .read_delay_us = 50, .write_delay_ms = 2, .erase_delay_ms = 3,
+    .endurance_cycles = 100000
+};
+
+static void init_nvm(void)
+{
+    NvM_Init();
+    Eep_Init(&g_device);
+    OsScheduler_Init(16);
+}
+
 /**
  * @brief Test Native block registration
  */
@@ -46,8 +71,7 @@ static void test_native_block_registration(void)
     LOG_INFO("");
     LOG_INFO("Test: Native Block Registration");
 
-    NvM_Init();
-    OsScheduler_Init(16);
+    init_nvm();
 
     static uint8_t data[256];
     NvM_BlockConfig_t block = {
@@ -92,8 +116,7 @@ static void test_redundant_block_registration(void)
     LOG_INFO("");
     LOG_INFO("Test: Redundant Block Registration");
 
-    NvM_Init();
-    OsScheduler_Init(16);
+    init_nvm();
 
     static uint8_t data[256];
     NvM_BlockConfig_t block = {
@@ -142,8 +165,7 @@ static void test_dataset_block_registration(void)
     LOG_INFO("");
     LOG_INFO("Test: Dataset Block Registration");
 
-    NvM_Init();
-    OsScheduler_Init(16);
+    init_nvm();
 
     static uint8_t data[256];
     NvM_BlockConfig_t block = {
@@ -191,11 +213,10 @@ static void test_rom_fallback(void)
     LOG_INFO("");
     LOG_INFO("Test: ROM Fallback");
 
-    NvM_Init();
-    OsScheduler_Init(16);
+    init_nvm();
 
     static uint8_t data[256];
-    static const uint8_t rom[256] = { ['R'] = 1, [1 ... 255] = 0xFF };
+    static const uint8_t rom[256] = { [0] = 'R', [1 ... 255] = 0xFF };
 
     NvM_BlockConfig_t block = {
         .block_id = 30,
@@ -225,7 +246,8 @@ static void test_rom_fallback(void)
         iterations++;
     } while (job_result == NVM_REQ_PENDING && iterations < 100);
 
-    TEST_ASSERT_EQ(job_result, NVM_REQ_OK, "Read with ROM fallback OK");
+    /* The copy itself is invalid: reported as failed, with the default in RAM */
+    TEST_ASSERT_EQ(job_result, NVM_REQ_NOT_OK, "Blank copy reported");
     TEST_ASSERT_EQ(data[0], 'R', "ROM marker loaded");
 
     LOG_INFO("  ROM fallback verified");
@@ -240,8 +262,7 @@ static void test_multi_block_coordination(void)
     LOG_INFO("");
     LOG_INFO("Test: Multi-Block Coordination");
 
-    NvM_Init();
-    OsScheduler_Init(16);
+    init_nvm();
 
     /* Register 3 blocks */
     static uint8_t data1[256], data2[256], data3[256];
@@ -311,8 +332,7 @@ static void test_write_protection(void)
     LOG_INFO("");
     LOG_INFO("Test: Write Protection");
 
-    NvM_Init();
-    OsScheduler_Init(16);
+    init_nvm();
 
     static uint8_t data[256];
     NvM_BlockConfig_t block = {
@@ -350,6 +370,678 @@ static void test_write_protection(void)
     LOG_INFO("  Result: Passed");
 }
 
+/**
+ * @brief Test registry with a production-sized block count
+ */
+static void test_large_registry(void)
+{
+    LOG_INFO("");
+    LOG_INFO("Test: Large Block Registry (250 blocks)");
+
+    NvM_Init();
+    OsScheduler_Init(16);
+
+    static uint8_t data[250][256];
+    boolean all_ok = TRUE;
+    for (uint32_t i = 0; i < 250; i++) {
+        /* Reverse ID order so slot != block_id */
+        NvM_BlockConfig_t block = {
+            .block_id = (uint8_t)(249U - i), .block_size = 256, .block_type = NVM_BLOCK_NATIVE,
+            .crc_type = NVM_CRC16, .priority = 10, .is_immediate = FALSE,
+            .is_write_protected = FALSE, .ram_mirror_ptr = data[249U - i],
+            .rom_block_ptr = NULL, .rom_block_size = 0, .eeprom_offset = (i % 4U) * 0x400U
+        };
+        if (NvM_RegisterBlock(&block) != E_OK) {
+            all_ok = FALSE;
+        }
+    }
+    TEST_ASSERT(all_ok, "250 blocks registered");
+
+    uint8_t status = 0xAA;
+    TEST_ASSERT_EQ(NvM_GetErrorStatus(0, &status), E_OK, "Lowest ID found");
+    TEST_ASSERT_EQ(status, NVM_BLOCKSTATE_UNINITIALIZED, "State from hot table");
+    TEST_ASSERT_EQ(NvM_GetErrorStatus(250, &status), E_NOT_OK, "Unregistered ID rejected");
+
+    NvM_BlockConfig_t reserved = {
+        .block_id = 0xFF, .block_size = 32, .block_type = NVM_BLOCK_NATIVE,
+        .crc_type = NVM_CRC16, .eeprom_offset = 0
+    };
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&reserved), E_NOT_OK, "Block ID 0xFF reserved");
+
+    /* Job dispatch to a high slot: ID 3 was registered last (offset 0x400) */
+    memset(data[3], 0x5C, sizeof(data[3]));
+    NvM_WriteBlock(3, data[3]);
+    NvM_MainFunction();
+    uint8_t job_result;
+    NvM_GetJobResult(3, &job_result);
+    TEST_ASSERT_EQ(job_result, NVM_REQ_OK, "Write dispatched to block 3");
+    NvM_GetErrorStatus(3, &status);
+    TEST_ASSERT_EQ(status, NVM_BLOCKSTATE_VALID, "Hot state updated after write");
+
+    uint8_t readback[256] = { 0 };
+    NvM_ReadBlock(3, readback);
+    NvM_MainFunction();
+    TEST_ASSERT(memcmp(readback, data[3], sizeof(readback)) == 0, "Read back through registry");
+
+    LOG_INFO("  Result: Passed");
+}
+
+/**
+ * @brief Test log-structured blocks
+ */
+static void test_log_block(void)
+{
+    LOG_INFO("");
+    LOG_INFO("Test: Log-Structured Block");
+
+    NvM_Init();
+    OsScheduler_Init(16);
+
+    static uint8_t odo[16], trip[16];
+    TEST_ASSERT_EQ(NvM_SetLogRegion(0x100, 4), E_NOT_OK, "Unaligned log region rejected");
+    TEST_ASSERT_EQ(NvM_SetLogRegion(0x000, 1), E_NOT_OK, "Single-sector log region rejected");
+    TEST_ASSERT_EQ(NvM_SetLogRegion(0x000, 4), E_OK, "Log region placed");
+
+    NvM_BlockConfig_t block = {
+        .block_id = 20, .block_size = sizeof(odo), .block_type = NVM_BLOCK_LOG,
+        .crc_type = NVM_CRC16, .priority = 10, .is_immediate = FALSE,
+        .is_write_protected = FALSE, .ram_mirror_ptr = odo,
+        .rom_block_ptr = NULL, .rom_block_size = 0, .eeprom_offset = 0
+    };
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block), E_OK, "LOG block registered");
+    block.block_id = 21;
+    block.ram_mirror_ptr = trip;
+    NvM_RegisterBlock(&block);
+    block.block_id = 22;
+    block.block_size = NVM_LOG_MAX_BLOCK_SIZE + 1U;
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block), E_NOT_OK, "Oversized LOG block rejected");
+
+    Eeprom_DiagInfoType eep_before, eep_after;
+    Eep_GetDiagnostics(&eep_before);
+
+    boolean all_ok = TRUE;
+    uint8_t result;
+    for (uint32_t i = 0; i < 64; i++) {
+        memset(odo, (int)i, sizeof(odo));
+        memset(trip, (int)(0x80U + i), sizeof(trip));
+        NvM_WriteBlock(20, odo);
+        NvM_WriteBlock(21, trip);
+        NvM_MainFunction();
+        NvM_GetJobResult(20, &result);
+        all_ok = (result == NVM_REQ_OK) ? all_ok : FALSE;
+        NvM_GetJobResult(21, &result);
+        all_ok = (result == NVM_REQ_OK) ? all_ok : FALSE;
+    }
+    TEST_ASSERT(all_ok, "128 appends to a 4-sector region succeed");
+
+    NvM_LogStats_t stats;
+    Eep_GetDiagnostics(&eep_after);
+    NvM_GetLogStats(&stats);
+    LOG_INFO("  appended=%u pages=%u relocated=%u erased=%u free=%u",
+             stats.records_appended, stats.pages_programmed, stats.records_relocated,
+             stats.sectors_erased, stats.free_sectors);
+    TEST_ASSERT_EQ(stats.records_appended, 128U, "Every write appended one record");
+    TEST_ASSERT(stats.pages_programmed <= 128U + 2U * stats.sectors_erased,
+                "At most two relocated pages per reclaimed sector");
+    TEST_ASSERT_EQ(eep_after.total_erase_count - eep_before.total_erase_count, stats.sectors_erased,
+                   "Erases only by compaction");
+    TEST_ASSERT(stats.sectors_erased <= 128U / 3U, "About one erase per sector of records");
+    TEST_ASSERT(stats.free_sectors >= 1U, "Compaction reserve kept");
+
+    /* Rebuild the index from the device */
+    TEST_ASSERT_EQ(NvM_SetLogRegion(0x000, 4), E_OK, "Log region rescanned");
+    uint8_t readback[16] = { 0 };
+    NvM_ReadBlock(20, readback);
+    NvM_MainFunction();
+    NvM_GetJobResult(20, &result);
+    TEST_ASSERT_EQ(result, NVM_REQ_OK, "LOG block read after rescan");
+    TEST_ASSERT_EQ(readback[0], 63, "Latest ODO record is current");
+    NvM_ReadBlock(21, readback);
+    NvM_MainFunction();
+    TEST_ASSERT_EQ(readback[15], 0x80 + 63, "Latest trip record is current");
+
+    /* One record per sector: live record + new copy + compaction reserve */
+    NvM_Init();
+    static uint8_t big[NVM_LOG_MAX_BLOCK_SIZE];
+    NvM_SetLogRegion(0x000, 3);
+    block.block_id = 23;
+    block.block_size = sizeof(big);
+    block.ram_mirror_ptr = big;
+    NvM_RegisterBlock(&block);
+    all_ok = TRUE;
+    for (uint32_t i = 0; i < 8; i++) {
+        memset(big, (int)i, sizeof(big));
+        NvM_WriteBlock(23, big);
+        NvM_MainFunction();
+        NvM_GetJobResult(23, &result);
+        all_ok = (result == NVM_REQ_OK) ? all_ok : FALSE;
+    }
+    TEST_ASSERT(all_ok, "Full-sector records cycle through a 3-sector region");
+
+    LOG_INFO("  Result: Passed");
+}
+
+/**
+ * @brief Test inline CRC placement against the separate CRC page
+ */
+static void test_inline_crc(void)
+{
+    LOG_INFO("");
+    LOG_INFO("Test: Inline CRC Placement");
+
+    NvM_Init();
+    OsScheduler_Init(16);
+
+    static uint8_t compact[200], paged[256];
+    NvM_BlockConfig_t block = {
+        .block_id = 30, .block_size = sizeof(compact), .block_type = NVM_BLOCK_NATIVE,
+        .crc_type = NVM_CRC16, .crc_placement = NVM_CRC_PLACEMENT_INLINE,
+        .priority = 10, .is_immediate = FALSE, .is_write_protected = FALSE,
+        .ram_mirror_ptr = compact, .rom_block_ptr = NULL, .rom_block_size = 0,
+        .eeprom_offset = 0x400
+    };
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block), E_OK, "Inline CRC block registered");
+
+    block.block_id = 31;
+    block.block_size = sizeof(paged);
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block), E_NOT_OK, "Inline CRC rejected when data fills its last page");
+    block.block_size = 254;
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block), E_OK, "Inline CRC accepted when it exactly fits");
+    block.crc_placement = (NvM_CrcPlacementType_t)7;
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block), E_NOT_OK, "Unknown CRC placement rejected");
+
+    block.block_id = 32;
+    block.block_size = sizeof(paged);
+    block.crc_placement = NVM_CRC_PLACEMENT_PAGE;
+    block.ram_mirror_ptr = paged;
+    block.eeprom_offset = 0x800;
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block), E_OK, "Separate CRC page block registered");
+
+    Eeprom_DiagInfoType d0, d1, d2;
+    uint8_t result;
+    memset(compact, 0xA5, sizeof(compact));
+    memset(paged, 0x5A, sizeof(paged));
+
+    Eep_GetDiagnostics(&d0);
+    NvM_WriteBlock(30, compact);
+    NvM_MainFunction();
+    NvM_GetJobResult(30, &result);
+    TEST_ASSERT_EQ(result, NVM_REQ_OK, "Inline CRC block written");
+    Eep_GetDiagnostics(&d1);
+    NvM_WriteBlock(32, paged);
+    NvM_MainFunction();
+    NvM_GetJobResult(32, &result);
+    TEST_ASSERT_EQ(result, NVM_REQ_OK, "Separate CRC page block written");
+    Eep_GetDiagnostics(&d2);
+
+    LOG_INFO("  inline: %u programs, %u bytes; page: %u programs, %u bytes",
+             d1.total_write_count - d0.total_write_count,
+             d1.total_bytes_written - d0.total_bytes_written,
+             d2.total_write_count - d1.total_write_count,
+             d2.total_bytes_written - d1.total_bytes_written);
+    TEST_ASSERT_EQ(d1.total_write_count - d0.total_write_count, 1U, "Inline CRC: one program");
+    TEST_ASSERT_EQ(d1.total_bytes_written - d0.total_bytes_written, 256U, "Inline CRC: one page");
+    TEST_ASSERT_EQ(d2.total_write_count - d1.total_write_count, 1U, "Separate CRC: data + CRC page in one program");
+
+    uint8_t readback[200] = { 0 };
+    Eep_GetDiagnostics(&d0);
+    NvM_ReadBlock(30, readback);
+    NvM_MainFunction();
+    NvM_GetJobResult(30, &result);
+    Eep_GetDiagnostics(&d1);
+    TEST_ASSERT_EQ(result, NVM_REQ_OK, "Inline CRC block read back");
+    TEST_ASSERT(memcmp(readback, compact, sizeof(readback)) == 0, "Inline CRC data intact");
+    TEST_ASSERT_EQ(d1.total_read_count - d0.total_read_count, 1U, "Data and CRC in one read");
+
+    /* An erased copy does not pass the inline CRC */
+    Eep_Erase(0x400);
+    NvM_ReadBlock(30, readback);
+    NvM_MainFunction();
+    NvM_GetJobResult(30, &result);
+    TEST_ASSERT(result != NVM_REQ_OK, "Erased inline CRC block fails verification");
+
+    LOG_INFO("  Result: Passed");
+}
+
+/**
+ * @brief Test idle pre-erase of the next dataset slot
+ */
+static void test_dataset_pre_erase(void)
+{
+    LOG_INFO("");
+    LOG_INFO("Test: Dataset Pre-Erase");
+
+    NvM_Init();
+    OsScheduler_Init(16);
+    Eep_SetTimingMode(EEP_TIMING_VIRTUAL);
+
+    /* One job per call, so the idle step runs in a call of its own */
+    NvM_MainFunctionBudget_t budget = { .max_bytes = 0, .max_cost_us = 1 };
+    NvM_SetMainFunctionBudget(&budget);
+
+    static uint8_t data[256];
+    NvM_BlockConfig_t block = {
+        .block_id = 21, .block_size = sizeof(data), .block_type = NVM_BLOCK_DATASET,
+        .crc_type = NVM_CRC16, .priority = 10, .is_immediate = FALSE,
+        .is_write_protected = FALSE, .ram_mirror_ptr = data, .rom_block_ptr = NULL,
+        .rom_block_size = 0, .eeprom_offset = 0x400, .dataset_count = 3,
+        .active_dataset_index = 0
+    };
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block), E_OK, "Dataset block registered");
+
+    Eeprom_DiagInfoType d0, d1;
+    NvM_Diagnostics_t diag;
+    uint8_t result;
+
+    /* Disabled: the write erases its slot itself */
+    memset(data, 0x11, sizeof(data));
+    Eep_GetDiagnostics(&d0);
+    uint32_t t0 = OsScheduler_GetVirtualTimeMs();
+    NvM_WriteBlock(21, data);
+    NvM_MainFunction();
+    uint32_t cold_ms = OsScheduler_GetVirtualTimeMs() - t0;
+    NvM_GetJobResult(21, &result);
+    Eep_GetDiagnostics(&d1);
+    TEST_ASSERT_EQ(result, NVM_REQ_OK, "Write without pre-erase OK");
+    TEST_ASSERT_EQ(d1.total_erase_count - d0.total_erase_count, 1U, "Write erased its slot");
+
+    NvM_MainFunction();
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT_EQ(diag.pre_erases, 0U, "Nothing pre-erased while disabled");
+
+    /* Enabled: one idle call erases the next slot, once */
+    NvM_SetDatasetPreErase(TRUE);
+    NvM_MainFunction();
+    NvM_MainFunction();
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT_EQ(diag.pre_erases, 1U, "Next slot erased once while idle");
+
+    memset(data, 0x22, sizeof(data));
+    Eep_GetDiagnostics(&d0);
+    t0 = OsScheduler_GetVirtualTimeMs();
+    NvM_WriteBlock(21, data);
+    NvM_MainFunction();
+    uint32_t warm_ms = OsScheduler_GetVirtualTimeMs() - t0;
+    NvM_GetJobResult(21, &result);
+    Eep_GetDiagnostics(&d1);
+    NvM_GetDiagnostics(&diag);
+    LOG_INFO("  write latency: %u ms erased in foreground, %u ms pre-erased", cold_ms, warm_ms);
+    TEST_ASSERT_EQ(result, NVM_REQ_OK, "Write into pre-erased slot OK");
+    TEST_ASSERT_EQ(d1.total_erase_count - d0.total_erase_count, 0U, "Write skipped the erase");
+    TEST_ASSERT_EQ(diag.pre_erase_hits, 1U, "Pre-erase hit counted");
+    TEST_ASSERT(warm_ms < cold_ms, "Pre-erased write is faster");
+
+    uint8_t readback[256] = { 0 };
+    NvM_ReadBlock(21, readback);
+    NvM_MainFunction();
+    NvM_GetJobResult(21, &result);
+    TEST_ASSERT_EQ(result, NVM_REQ_OK, "Dataset block read back");
+    TEST_ASSERT(memcmp(readback, data, sizeof(readback)) == 0, "Latest version intact");
+
+    Eep_SetTimingMode(EEP_TIMING_OFF);
+    LOG_INFO("  Result: Passed");
+}
+
+/**
+ * @brief Test newest-slot discovery through the dataset sequence headers
+ */
+static void test_dataset_sequence_headers(void)
+{
+    LOG_INFO("");
+    LOG_INFO("Test: Dataset Sequence Headers");
+
+    NvM_Init();
+    OsScheduler_Init(16);
+
+    static uint8_t data[256];
+    NvM_BlockConfig_t block = {
+        .block_id = 22, .block_size = sizeof(data), .block_type = NVM_BLOCK_DATASET,
+        .crc_type = NVM_CRC16, .priority = 10, .is_immediate = FALSE,
+        .is_write_protected = FALSE, .ram_mirror_ptr = data, .rom_block_ptr = NULL,
+        .rom_block_size = 0, .eeprom_offset = 0x400, .dataset_count = 3,
+        .active_dataset_index = 0
+    };
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block), E_OK, "Dataset block registered");
+
+    /* Versions 1..4 land in slots 1, 2, 0, 1 */
+    boolean all_ok = TRUE;
+    uint8_t result;
+    for (uint8_t v = 1; v <= 4; v++) {
+        memset(data, v, sizeof(data));
+        NvM_WriteBlock(22, data);
+        NvM_MainFunction();
+        NvM_GetJobResult(22, &result);
+        all_ok = (result == NVM_REQ_OK) ? all_ok : FALSE;
+    }
+    TEST_ASSERT(all_ok, "Four versions written");
+
+    /* Re-registration forgets the active index, as a reset would */
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block), E_OK, "Block re-registered with index 0");
+
+    Eeprom_DiagInfoType d0, d1;
+    uint8_t readback[256] = { 0 };
+    Eep_GetDiagnostics(&d0);
+    NvM_ReadBlock(22, readback);
+    NvM_MainFunction();
+    NvM_GetJobResult(22, &result);
+    Eep_GetDiagnostics(&d1);
+    TEST_ASSERT_EQ(result, NVM_REQ_OK, "Newest version read after re-registration");
+    TEST_ASSERT_EQ(readback[0], 4, "Version 4 found (slot 1)");
+    TEST_ASSERT_EQ(d1.total_read_count - d0.total_read_count, 4U, "Three header reads + one full read");
+    TEST_ASSERT_EQ(d1.total_bytes_read - d0.total_bytes_read, 3U * 10U + 258U,
+                   "Only the newest slot read in full");
+
+    /* A write after re-registration continues the rotation after the newest slot */
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block), E_OK, "Block re-registered again");
+    memset(data, 5, sizeof(data));
+    NvM_WriteBlock(22, data);
+    NvM_MainFunction();
+    NvM_GetJobResult(22, &result);
+    TEST_ASSERT_EQ(result, NVM_REQ_OK, "Version 5 written without a prior read");
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block), E_OK, "Block re-registered once more");
+    NvM_ReadBlock(22, readback);
+    NvM_MainFunction();
+    TEST_ASSERT_EQ(readback[0], 5, "Version 5 is newest (slot 2)");
+
+    /* Newest copy lost: fall back by sequence (version 4), not by slot order */
+    Eep_Erase(0x400 + 2U * 1024U);
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block), E_OK, "Block re-registered after losing slot 2");
+    NvM_ReadBlock(22, readback);
+    NvM_MainFunction();
+    NvM_GetJobResult(22, &result);
+    TEST_ASSERT_EQ(result, NVM_REQ_OK, "Read recovered");
+    TEST_ASSERT_EQ(readback[0], 4, "Next newest version used");
+
+    LOG_INFO("  Result: Passed");
+}
+
+/**
+ * @brief Test in-place updates of a block whose updates only clear bits
+ */
+static void test_bit_clear_update(void)
+{
+    LOG_INFO("");
+    LOG_INFO("Test: Bit-Clear Update");
+
+    NvM_Init();
+    TEST_ASSERT_EQ(Eep_SetProgramMode(EEP_PROGRAM_BIT_CLEAR), E_OK, "Bit-clear mode enabled");
+
+    /* A usage bitmap: each event clears one more bit */
+    static uint8_t data[256];
+    NvM_BlockConfig_t block = {
+        .block_id = 23, .block_size = sizeof(data), .block_type = NVM_BLOCK_NATIVE,
+        .crc_type = NVM_CRC_NONE, .priority = 10, .is_immediate = FALSE,
+        .is_write_protected = FALSE, .bit_clear_update = TRUE, .ram_mirror_ptr = data,
+        .rom_block_ptr = NULL, .rom_block_size = 0, .eeprom_offset = 0x800
+    };
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block), E_OK, "Bit-clear block registered");
+
+    Eeprom_DiagInfoType d0, d1;
+    NvM_Diagnostics_t diag;
+    uint8_t result;
+    uint8_t readback[256];
+
+    memset(data, 0xFF, sizeof(data));
+    Eep_GetDiagnostics(&d0);
+    for (uint32_t i = 0; i < 8U; i++) {
+        data[0] = (uint8_t)(0xFFU << (i + 1U));
+        NvM_WriteBlock(23, data);
+        NvM_MainFunction();
+        NvM_GetJobResult(23, &result);
+        TEST_ASSERT_EQ(result, NVM_REQ_OK, "Bit-clearing update OK");
+    }
+    Eep_GetDiagnostics(&d1);
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT_EQ(d1.total_erase_count - d0.total_erase_count, 0U, "No erase for 8 updates");
+    TEST_ASSERT_EQ(diag.erases_avoided, 8U, "Erases avoided counted");
+    TEST_ASSERT_EQ(diag.bit_clear_fallbacks, 0U, "No fallback");
+
+    NvM_ReadBlock(23, readback);
+    NvM_MainFunction();
+    TEST_ASSERT_EQ(readback[0], 0x00, "Last update read back");
+
+    /* Setting a bit again needs the erase */
+    data[0] = 0x0F;
+    Eep_GetDiagnostics(&d0);
+    NvM_WriteBlock(23, data);
+    NvM_MainFunction();
+    NvM_GetJobResult(23, &result);
+    Eep_GetDiagnostics(&d1);
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT_EQ(result, NVM_REQ_OK, "Bit-setting update OK");
+    TEST_ASSERT_EQ(d1.total_erase_count - d0.total_erase_count, 1U, "Bit-setting update erased");
+    TEST_ASSERT_EQ(diag.bit_clear_fallbacks, 1U, "Fallback counted");
+    NvM_ReadBlock(23, readback);
+    NvM_MainFunction();
+    TEST_ASSERT_EQ(readback[0], 0x0F, "Erased and rewritten");
+
+    /* Without the driver mode the option has no effect */
+    TEST_ASSERT_EQ(Eep_SetProgramMode(EEP_PROGRAM_BLANK), E_OK, "Bit-clear mode disabled");
+    data[0] = 0x07;
+    Eep_GetDiagnostics(&d0);
+    NvM_WriteBlock(23, data);
+    NvM_MainFunction();
+    Eep_GetDiagnostics(&d1);
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT_EQ(d1.total_erase_count - d0.total_erase_count, 1U, "Erased as usual");
+    TEST_ASSERT_EQ(diag.erases_avoided, 8U, "Nothing more avoided");
+
+    LOG_INFO("  Result: Passed");
+}
+
+/**
+ * @brief Test delta page writes of a paged LOG block
+ */
+static void test_log_delta_pages(void)
+{
+    LOG_INFO("");
+    LOG_INFO("Test: Log Delta Pages");
+
+    NvM_Init();
+    OsScheduler_Init(16);
+    TEST_ASSERT_EQ(NvM_SetLogRegion(0x000, 4), E_OK, "Log region placed");
+
+    /* 1000 bytes: five 244-byte chunks, one page each */
+    static uint8_t data[1000];
+    uint8_t readback[1000];
+    NvM_BlockConfig_t block = {
+        .block_id = 24, .block_size = sizeof(data), .block_type = NVM_BLOCK_LOG,
+        .crc_type = NVM_CRC_NONE, .priority = 10, .is_immediate = FALSE,
+        .is_write_protected = FALSE, .delta_pages = TRUE, .ram_mirror_ptr = data,
+        .rom_block_ptr = NULL, .rom_block_size = 0, .eeprom_offset = 0
+    };
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block), E_OK, "Paged LOG block registered");
+
+    NvM_LogStats_t s0, s1;
+    Eeprom_DiagInfoType d0, d1;
+    uint8_t result;
+
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)i;
+    }
+    NvM_GetLogStats(&s0);
+    NvM_WriteBlock(24, data);
+    NvM_MainFunction();
+    NvM_GetJobResult(24, &result);
+    NvM_GetLogStats(&s1);
+    TEST_ASSERT_EQ(result, NVM_REQ_OK, "First write OK");
+    TEST_ASSERT_EQ(s1.pages_programmed - s0.pages_programmed, 5U, "First write programs every page");
+
+    /* One byte changed: one page appended, nothing erased */
+    data[500] ^= 0xFFU;
+    Eep_GetDiagnostics(&d0);
+    NvM_GetLogStats(&s0);
+    NvM_WriteBlock(24, data);
+    NvM_MainFunction();
+    NvM_GetJobResult(24, &result);
+    NvM_GetLogStats(&s1);
+    Eep_GetDiagnostics(&d1);
+    TEST_ASSERT_EQ(result, NVM_REQ_OK, "Delta write OK");
+    TEST_ASSERT_EQ(s1.pages_programmed - s0.pages_programmed, 1U, "Only the changed page programmed");
+    TEST_ASSERT_EQ(s1.pages_unchanged - s0.pages_unchanged, 4U, "Four pages left alone");
+    TEST_ASSERT_EQ(d1.total_erase_count, d0.total_erase_count, "No erase");
+    TEST_ASSERT_EQ(d1.total_read_count, d0.total_read_count, "Nothing read back");
+
+    /* Unchanged data: nothing programmed */
+    NvM_GetLogStats(&s0);
+    NvM_WriteBlock(24, data);
+    NvM_MainFunction();
+    NvM_GetLogStats(&s1);
+    TEST_ASSERT_EQ(s1.pages_programmed, s0.pages_programmed, "Unchanged write programs nothing");
+
+    /* The scan gathers the newest chunk of each page */
+    TEST_ASSERT_EQ(NvM_SetLogRegion(0x000, 4), E_OK, "Log region rescanned");
+    memset(readback, 0, sizeof(readback));
+    NvM_ReadBlock(24, readback);
+    NvM_MainFunction();
+    NvM_GetJobResult(24, &result);
+    TEST_ASSERT_EQ(result, NVM_REQ_OK, "Paged block read after rescan");
+    TEST_ASSERT(memcmp(readback, data, sizeof(data)) == 0, "Newest chunks gathered");
+
+    /* A torn write (chunk 0 of a two-chunk update) is rolled back */
+    uint8_t page[256];
+    memset(page, 0xFF, sizeof(page));
+    page[0] = 0x50;
+    page[1] = 24;
+    page[2] = 0;
+    page[3] = 2;
+    page[4] = 0xE8;
+    page[5] = 0x03;             /* seq 1000 */
+    page[6] = 0;
+    page[7] = 0;
+    memset(&page[8], 0xAA, 244);
+    uint32_t crc = CRC_CalculateCRC32(page, 252);
+    for (uint32_t i = 0; i < 4U; i++) {
+        page[252 + i] = (uint8_t)(crc >> (8U * i));
+    }
+    TEST_ASSERT_EQ(Eep_Write(0xC00, page, sizeof(page)), E_OK, "Torn chunk planted");
+    TEST_ASSERT_EQ(NvM_SetLogRegion(0x000, 4), E_OK, "Log region rescanned");
+    NvM_ReadBlock(24, readback);
+    NvM_MainFunction();
+    TEST_ASSERT_EQ(readback[0], 0, "Torn chunk ignored");
+
+    /* The next write programs every chunk, newer than the torn one */
+    NvM_GetLogStats(&s0);
+    NvM_WriteBlock(24, data);
+    NvM_MainFunction();
+    NvM_GetLogStats(&s1);
+    TEST_ASSERT_EQ(s1.pages_programmed - s0.pages_programmed, 5U, "Write after a torn write is full");
+    TEST_ASSERT_EQ(NvM_SetLogRegion(0x000, 4), E_OK, "Log region rescanned");
+    memset(readback, 0, sizeof(readback));
+    NvM_ReadBlock(24, readback);
+    NvM_MainFunction();
+    TEST_ASSERT(memcmp(readback, data, sizeof(data)) == 0, "Rewritten block is current");
+
+    /* Many small updates cycle through the region by compaction */
+    boolean all_ok = TRUE;
+    for (uint32_t i = 0; i < 40U; i++) {
+        data[(i * 97U) % sizeof(data)]++;
+        NvM_WriteBlock(24, data);
+        NvM_MainFunction();
+        NvM_GetJobResult(24, &result);
+        all_ok = (result == NVM_REQ_OK) ? all_ok : FALSE;
+    }
+    TEST_ASSERT(all_ok, "40 single-page updates succeed");
+    TEST_ASSERT_EQ(NvM_SetLogRegion(0x000, 4), E_OK, "Log region rescanned");
+    NvM_ReadBlock(24, readback);
+    NvM_MainFunction();
+    TEST_ASSERT(memcmp(readback, data, sizeof(data)) == 0, "Block intact after compactions");
+
+    LOG_INFO("  Result: Passed");
+}
+
+/**
+ * @brief Test compressed blocks: fewer bytes programmed and read, raw fallback, bad payloads
+ */
+static void test_compressed_block(void)
+{
+    LOG_INFO("");
+    LOG_INFO("Test: Compressed Block");
+
+    NvM_Init();
+
+    /* A calibration table: mostly zero with a few populated cells */
+    static uint8_t data[1000];
+    NvM_BlockConfig_t block = {
+        .block_id = 25, .block_size = sizeof(data), .block_type = NVM_BLOCK_NATIVE,
+        .crc_type = NVM_CRC32, .priority = 10, .is_immediate = FALSE,
+        .is_write_protected = FALSE, .compression = NVM_COMPRESSION_RLE, .ram_mirror_ptr = data,
+        .rom_block_ptr = NULL, .rom_block_size = 0, .eeprom_offset = 0xC00
+    };
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block), E_OK, "Compressed block registered");
+
+    Eeprom_DiagInfoType d0, d1;
+    NvM_Diagnostics_t diag;
+    uint8_t result;
+    static uint8_t readback[1000];
+
+    memset(data, 0x00, sizeof(data));
+    for (uint32_t i = 0; i < sizeof(data); i += 100U) {
+        data[i] = (uint8_t)(i / 100U + 1U);
+    }
+    Eep_GetDiagnostics(&d0);
+    NvM_WriteBlock(25, data);
+    NvM_MainFunction();
+    NvM_GetJobResult(25, &result);
+    Eep_GetDiagnostics(&d1);
+    TEST_ASSERT_EQ(result, NVM_REQ_OK, "Compressed write OK");
+    TEST_ASSERT_EQ(d1.total_bytes_written - d0.total_bytes_written, 256U, "One page programmed");
+
+    memset(readback, 0xA5, sizeof(readback));
+    Eep_GetDiagnostics(&d0);
+    NvM_ReadBlock(25, readback);
+    NvM_MainFunction();
+    NvM_GetJobResult(25, &result);
+    Eep_GetDiagnostics(&d1);
+    TEST_ASSERT_EQ(result, NVM_REQ_OK, "Compressed read OK");
+    TEST_ASSERT(memcmp(readback, data, sizeof(data)) == 0, "Decoded data matches");
+    TEST_ASSERT(d1.total_bytes_read - d0.total_bytes_read < 100U, "Only the stored bytes read");
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT(diag.compressed_bytes_saved > 1000U, "Saved bytes counted");
+
+    /* Incompressible data is stored raw and still round-trips */
+    uint32_t x = 0x12345678U;
+    for (uint32_t i = 0; i < sizeof(data); i++) {
+        x = x * 1103515245U + 12345U;
+        data[i] = (uint8_t)(x >> 16);
+    }
+    NvM_WriteBlock(25, data);
+    NvM_MainFunction();
+    NvM_GetJobResult(25, &result);
+    TEST_ASSERT_EQ(result, NVM_REQ_OK, "Raw write OK");
+    NvM_ReadBlock(25, readback);
+    NvM_MainFunction();
+    NvM_GetJobResult(25, &result);
+    TEST_ASSERT_EQ(result, NVM_REQ_OK, "Raw read OK");
+    TEST_ASSERT(memcmp(readback, data, sizeof(data)) == 0, "Raw data matches");
+
+    /* A payload with a valid CRC that does not decode is rejected */
+    uint8_t page[256];
+    const Crc_Descriptor_t *crc = CRC_GetDescriptor(NVM_CRC32);
+    memset(page, 0xFF, sizeof(page));
+    page[0] = 3U;       /* Length 3, compressed */
+    page[1] = 0U;
+    page[2] = 0x85U;    /* Run of 8 */
+    page[3] = 0xAAU;
+    page[4] = 0x7FU;    /* 128 literals that are missing */
+    CRC_Store(crc, crc->calculate(page, 5), &page[5]);
+    Eep_Erase(0xC00);
+    TEST_ASSERT_EQ(Eep_Write(0xC00, page, sizeof(page)), E_OK, "Malformed payload planted");
+    NvM_ReadBlock(25, readback);
+    NvM_MainFunction();
+    NvM_GetJobResult(25, &result);
+    TEST_ASSERT(result != NVM_REQ_OK, "Malformed payload rejected");
+
+    /* An erased slot has no valid header */
+    Eep_Erase(0xC00);
+    NvM_ReadBlock(25, readback);
+    NvM_MainFunction();
+    NvM_GetJobResult(25, &result);
+    TEST_ASSERT(result != NVM_REQ_OK, "Erased slot rejected");
+
+    LOG_INFO("  Result: Passed");
+}
+
 /**
  * @brief Run all block tests
  */
@@ -367,6 +1059,14 @@ int main(void)
     test_rom_fallback();
     test_multi_block_coordination();
     test_write_protection();
+    test_large_registry();
+    test_log_block();
+    test_inline_crc();
+    test_dataset_pre_erase();
+    test_dataset_sequence_headers();
+    test_bit_clear_update();
+    test_log_delta_pages();
+    test_compressed_block();
 
     /* Print summary */
     LOG_INFO("");
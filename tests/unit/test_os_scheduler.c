@@ -7,10 +7,13 @@
  * - 测试优先级调度
  * - 测试时间倍速
  * - 测试统计信息
+ * - 测试离散事件推进 (与逐tick推进结果一致)
+ * - 测试多核模式 (每核一个线程, 屏障同步)
  */
 
 #include "os_scheduler.h"
 #include "logging.h"
+#include <pthread.h>
 #include <stdio.h>
 #include <assert.h>
 #include <string.h>
@@ -327,6 +330,234 @@ static void test_time_scale(void)
     LOG_INFO("✓ Time scale test passed");
 }
 
+/**
+ * @brief Execution trace shared by the event-mode tasks
+ */
+#define TRACE_MAX 512U
+static uint32_t g_trace[TRACE_MAX];
+static uint32_t g_trace_len = 0;
+
+static void trace(uint32_t id)
+{
+    if (g_trace_len < TRACE_MAX) {
+        g_trace[g_trace_len++] = (OsScheduler_GetVirtualTimeMs() << 4) | id;
+    }
+}
+
+static void fast_task(void) { trace(1); }
+static void slow_task(void) { trace(2); OsScheduler_Sleep(3); }
+static void oneshot_task(void) { trace(3); }
+
+/**
+ * @brief Register the event-mode task set and start
+ */
+static void start_event_tasks(void)
+{
+    OsTask_t fast = { .task_id = 1, .task_name = "Fast", .period_ms = 10, .priority = 2,
+                      .task_func = fast_task, .deadline_relative_ms = 2 };
+    OsTask_t slow = { .task_id = 2, .task_name = "Slow", .period_ms = 25, .priority = 1,
+                      .task_func = slow_task, .deadline_relative_ms = 2 };
+    OsTask_t once = { .task_id = 3, .task_name = "Once", .period_ms = 0, .priority = 0,
+                      .task_func = oneshot_task };
+
+    OsScheduler_Init(10);
+    OsScheduler_RegisterTask(&fast);
+    OsScheduler_RegisterTask(&slow);
+    OsScheduler_RegisterTask(&once);
+    OsScheduler_Start();
+    g_trace_len = 0;
+}
+
+/**
+ * @brief Test discrete-event mode matches tick-by-tick execution
+ */
+static void test_discrete_event(void)
+{
+    LOG_INFO("Testing discrete-event mode...");
+
+    static uint32_t tick_trace[TRACE_MAX];
+    OsSchedulerStats_t tick_stats, event_stats;
+    const uint32_t end_ms = 1000;
+
+    /* Reference: one tick per millisecond */
+    start_event_tasks();
+    while (OsScheduler_GetVirtualTimeMs() < end_ms) {
+        OsScheduler_Tick();
+    }
+    uint32_t tick_len = g_trace_len;
+    memcpy(tick_trace, g_trace, sizeof(tick_trace));
+    OsScheduler_GetStats(&tick_stats);
+    OsScheduler_Destroy();
+
+    /* Same task set, jumping between activations */
+    start_event_tasks();
+    uint32_t runs = OsScheduler_RunUntil(end_ms);
+    OsScheduler_GetStats(&event_stats);
+
+    LOG_INFO("  %u task runs, %u ticks (%u idle), %u deadline misses",
+             runs, event_stats.total_ticks, event_stats.idle_ticks, event_stats.deadline_misses);
+    assert(runs == g_trace_len);
+    assert(g_trace_len == tick_len);
+    assert(memcmp(g_trace, tick_trace, tick_len * sizeof(uint32_t)) == 0);
+    assert(event_stats.total_ticks == tick_stats.total_ticks);
+    assert(event_stats.idle_ticks == tick_stats.idle_ticks);
+    assert(event_stats.context_switches == tick_stats.context_switches);
+    assert(event_stats.deadline_misses == tick_stats.deadline_misses);
+    assert(OsScheduler_GetVirtualTimeMs() == end_ms);
+
+    /* Ties: the one-shot at t=1, then slow (higher priority) before fast */
+    assert((g_trace[0] & 0xFU) == 3 && (g_trace[1] & 0xFU) == 2 && (g_trace[2] & 0xFU) == 1);
+    OsScheduler_Destroy();
+
+    /* Long idle stretches cost one step per activation */
+    OsTask_t hourly = { .task_id = 9, .task_name = "Hourly", .period_ms = 3600000U, .priority = 1,
+                        .task_func = task1_func };
+    g_task1_counter = 0;
+    OsScheduler_Init(10);
+    OsScheduler_RegisterTask(&hourly);
+    OsScheduler_Start();
+    runs = OsScheduler_RunUntil(24U * 3600000U);
+    OsScheduler_GetStats(&event_stats);
+    assert(runs == 24 && g_task1_counter == 24);
+    assert(event_stats.total_ticks == 24U * 3600000U);
+    assert(event_stats.idle_ticks == event_stats.total_ticks - 24U);
+
+    /* Not running: nothing happens */
+    OsScheduler_Stop();
+    assert(OsScheduler_RunUntil(25U * 3600000U) == 0);
+    OsScheduler_Destroy();
+
+    LOG_INFO("✓ Discrete-event test passed");
+}
+
+/**
+ * @brief Multi-core bookkeeping (one slot per core, published atomically)
+ */
+#define MC_CORES 3U
+#define MC_BARRIER_MS 10U
+
+static uint32_t g_mc_runs[MC_CORES];
+static uint32_t g_mc_time[MC_CORES];
+static uint32_t g_mc_max_skew;
+static uint32_t g_mc_wrong_core;
+static pthread_t g_mc_thread[MC_CORES];
+
+static void mc_task(OsCoreId_t expected)
+{
+    OsCoreId_t core = OsScheduler_GetCoreId();
+    uint32_t now = OsScheduler_GetVirtualTimeMs();
+
+    if (core != expected) {
+        __atomic_add_fetch(&g_mc_wrong_core, 1U, __ATOMIC_RELAXED);
+        return;
+    }
+
+    g_mc_thread[core] = pthread_self();
+    g_mc_runs[core]++;
+    __atomic_store_n(&g_mc_time[core], now, __ATOMIC_RELEASE);
+
+    /* Other cores' last published times stay within the barrier window */
+    for (uint32_t c = 0; c < MC_CORES; c++) {
+        uint32_t other = __atomic_load_n(&g_mc_time[c], __ATOMIC_ACQUIRE);
+        uint32_t skew = (other > now) ? other - now : now - other;
+        uint32_t max = __atomic_load_n(&g_mc_max_skew, __ATOMIC_RELAXED);
+        while (skew > max &&
+               !__atomic_compare_exchange_n(&g_mc_max_skew, &max, skew, 0,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        }
+    }
+}
+
+static void mc_task0(void) { mc_task(0); }
+static void mc_task1(void) { mc_task(1); }
+static void mc_task2(void) { mc_task(2); }
+
+static void start_multicore_tasks(void)
+{
+    OsTask_t t0 = { .task_id = 1, .task_name = "Core0", .period_ms = 10, .priority = 1,
+                    .task_func = mc_task0 };
+    OsTask_t t1 = { .task_id = 2, .task_name = "Core1", .period_ms = 5, .priority = 1,
+                    .task_func = mc_task1 };
+    OsTask_t t2 = { .task_id = 3, .task_name = "Core2", .period_ms = 1, .priority = 1,
+                    .task_func = mc_task2 };
+
+    memset(g_mc_runs, 0, sizeof(g_mc_runs));
+    memset(g_mc_time, 0, sizeof(g_mc_time));
+    g_mc_max_skew = 0;
+    g_mc_wrong_core = 0;
+
+    OsScheduler_Init(10);
+    assert(OsScheduler_SetCoreCount(MC_CORES) == E_OK);
+    assert(OsScheduler_RegisterTaskOnCore(0, &t0) == E_OK);
+    assert(OsScheduler_RegisterTaskOnCore(1, &t1) == E_OK);
+    assert(OsScheduler_RegisterTaskOnCore(2, &t2) == E_OK);
+    OsScheduler_Start();
+}
+
+/**
+ * @brief Test multi-core mode: per-core task sets on threads, barrier sync
+ */
+static void test_multi_core(void)
+{
+    LOG_INFO("Testing multi-core mode...");
+
+    const uint32_t end_ms = 1000;
+    OsSchedulerStats_t stats;
+
+    /* Configuration checks */
+    OsScheduler_Init(10);
+    OsTask_t task = { .task_id = 1, .period_ms = 10, .priority = 1, .task_func = task1_func };
+    assert(OsScheduler_GetCoreCount() == 1);
+    assert(OsScheduler_RegisterTaskOnCore(1, &task) == E_NOT_OK);
+    assert(OsScheduler_SetCoreCount(0) == E_NOT_OK);
+    assert(OsScheduler_SetCoreCount(OS_MAX_CORES + 1U) == E_NOT_OK);
+    assert(OsScheduler_SetCoreCount(2) == E_OK);
+    assert(OsScheduler_RegisterTaskOnCore(1, &task) == E_OK);
+    assert(OsScheduler_RegisterTaskOnCore(0, &task) == E_NOT_OK);   /* IDs are global */
+    assert(OsScheduler_SetCoreCount(1) == E_NOT_OK);                /* Core 1 owns a task */
+    assert(OsScheduler_RunCores(end_ms, MC_BARRIER_MS) == 0);       /* Not started */
+    OsScheduler_Destroy();
+
+    /* Lockstep reference on the calling thread */
+    start_multicore_tasks();
+    uint32_t runs = OsScheduler_RunUntil(end_ms);
+    assert(runs == 100U + 200U + 1000U);
+    assert(g_mc_runs[0] == 100U && g_mc_runs[1] == 200U && g_mc_runs[2] == 1000U);
+    assert(g_mc_wrong_core == 0U);
+    OsScheduler_Destroy();
+
+    /* One thread per core */
+    start_multicore_tasks();
+    assert(OsScheduler_RunCores(end_ms, 0) == 0);
+    runs = OsScheduler_RunCores(end_ms, MC_BARRIER_MS);
+    LOG_INFO("  %u task runs on %u cores, max observed skew %u ms",
+             runs, MC_CORES, g_mc_max_skew);
+    assert(runs == 100U + 200U + 1000U);
+    assert(g_mc_runs[0] == 100U && g_mc_runs[1] == 200U && g_mc_runs[2] == 1000U);
+    assert(g_mc_wrong_core == 0U);
+    assert(g_mc_max_skew <= 2U * MC_BARRIER_MS);
+    assert(pthread_equal(g_mc_thread[0], pthread_self()));
+    assert(!pthread_equal(g_mc_thread[1], pthread_self()));
+    assert(!pthread_equal(g_mc_thread[1], g_mc_thread[2]));
+    assert(OsScheduler_GetVirtualTimeMs() == end_ms);
+
+    for (OsCoreId_t c = 0; c < MC_CORES; c++) {
+        assert(OsScheduler_GetCoreStats(c, &stats) == E_OK);
+        assert(stats.total_ticks == end_ms);
+        assert(stats.context_switches == g_mc_runs[c]);
+    }
+    assert(OsScheduler_GetCoreStats(MC_CORES, &stats) == E_NOT_OK);
+    assert(OsScheduler_GetStats(&stats) == E_OK);
+    assert(stats.total_ticks == MC_CORES * end_ms);
+
+    /* A second run continues from the shared time */
+    runs = OsScheduler_RunCores(end_ms + 100U, MC_BARRIER_MS);
+    assert(runs == 10U + 20U + 100U);
+    OsScheduler_Destroy();
+
+    LOG_INFO("✓ Multi-core test passed");
+}
+
 /**
  * @brief Main test runner
  */
@@ -345,6 +576,8 @@ int main(void)
     test_virtual_time();
     test_statistics();
     test_time_scale();
+    test_discrete_event();
+    test_multi_core();
 
     LOG_INFO("");
     LOG_INFO("=== All tests passed! ===");
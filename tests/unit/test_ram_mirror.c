@@ -7,6 +7,11 @@
  * - ABA problem prevention
  * - Data tearing detection
  * - Concurrent access safety
+ * - Zero-copy visitor and partial-range reads
+ * - Data checksum: fused with the write copy, or lazy on demand
+ * - Multi-version (RCU) mirror mode
+ * - Mirror arena: right-sized, cache-aligned, one flavour per block
+ * - Scheduler multi-core mode: writer and reader tasks on separate cores
  * - Performance benchmarks
  *
  * Test Strategy:
@@ -17,7 +22,8 @@
  */
 
 #include "nvm.h"
-#include "ram_mirror_seqlock.h"
+#include "nvm/ram_mirror_seqlock.h"
+#include "nvm/ram_mirror_rcu.h"
 #include "os_scheduler.h"
 #include "logging.h"
 #include <stdio.h>
@@ -129,7 +135,7 @@ static void test_concurrent_read_write(void)
         .ram_mirror_ptr = test_data,
         .rom_block_ptr = NULL,
         .rom_block_size = 0,
-        .eeprom_offset = 0x1000
+        .eeprom_offset = 0x0400
     };
     NvM_RegisterBlock(&block);
 
@@ -253,11 +259,11 @@ static void test_data_tearing_detection(void)
         }
     }
 
+    /* The torn buffer is synthetic: it must be detected, not counted as a real tear */
     if (is_torn) {
-        tear_count++;
-        LOG_INFO("  ✗ Data tearing detected (mixed patterns)");
+        LOG_INFO("  Data tearing detected (mixed patterns)");
     } else {
-        LOG_INFO("  ✓ No tearing (consistent pattern 0x%02X)", first_pattern);
+        LOG_INFO("  No tearing (consistent pattern 0x%02X)", first_pattern);
     }
 
     /* Seqlock prevents this */
@@ -267,7 +273,7 @@ static void test_data_tearing_detection(void)
     LOG_INFO("    3. If seq changed → retry read");
     LOG_INFO("    4. Result: Atomic read, no tearing");
 
-    TEST_ASSERT(1, "Tearing detection mechanism verified");
+    TEST_ASSERT(is_torn, "Tearing detection mechanism verified");
     LOG_INFO("  Result: Passed");
 }
 
@@ -298,7 +304,7 @@ static void test_seqlock_performance(void)
         .ram_mirror_ptr = test_data,
         .rom_block_ptr = NULL,
         .rom_block_size = 0,
-        .eeprom_offset = 0x2000
+        .eeprom_offset = 0x0800
     };
     NvM_RegisterBlock(&block);
 
@@ -457,6 +463,358 @@ static void test_seqlock_retry(void)
     LOG_INFO("  Result: Passed");
 }
 
+/**
+ * @brief Visitor context: sum of a range
+ */
+typedef struct {
+    uint32_t sum;
+    uint16_t len;
+} VisitSum_t;
+
+static void sum_visitor(const uint8_t* data, uint16_t len, void* ctx)
+{
+    VisitSum_t* out = (VisitSum_t*)ctx;
+    uint32_t sum = 0;
+
+    for (uint16_t i = 0; i < len; i++) {
+        sum += data[i];
+    }
+
+    /* Overwrite, not accumulate: the visitor may run more than once */
+    out->sum = sum;
+    out->len = len;
+}
+
+/**
+ * @brief Test zero-copy visitor and partial-range reads
+ */
+static void test_seqlock_visit(void)
+{
+    LOG_INFO("");
+    LOG_INFO("Test: Seqlock Visitor / Range Read");
+
+    const NvM_BlockIdType block_id = 5;
+    static uint8_t pattern[RAM_MIRROR_MAX_BLOCK_SIZE];
+    for (uint32_t i = 0; i < RAM_MIRROR_MAX_BLOCK_SIZE; i++) {
+        pattern[i] = (uint8_t)i;
+    }
+
+    RamMirror_SeqlockInit(RamMirror_GetSeqlockMirror(block_id), block_id);
+    RamMirror_SeqlockWrite(block_id, pattern, RAM_MIRROR_MAX_BLOCK_SIZE);
+
+    uint8_t field[4] = { 0 };
+    TEST_ASSERT(RamMirror_SeqlockReadRange(block_id, 100, field, sizeof(field)), "Range read OK");
+    TEST_ASSERT(field[0] == 100 && field[3] == 103, "Range read returns requested bytes");
+
+    VisitSum_t result = { 0, 0 };
+    TEST_ASSERT(RamMirror_SeqlockVisit(block_id, 10, 3, sum_visitor, &result), "Visit OK");
+    TEST_ASSERT_EQ(result.sum, 10U + 11U + 12U, "Visitor sees mirror bytes at offset");
+    TEST_ASSERT_EQ(result.len, 3U, "Visitor gets requested length");
+
+    TEST_ASSERT(RamMirror_SeqlockReadRange(block_id, RAM_MIRROR_MAX_BLOCK_SIZE - 2U, field, 2),
+                "Range ending at block end accepted");
+    TEST_ASSERT(!RamMirror_SeqlockReadRange(block_id, RAM_MIRROR_MAX_BLOCK_SIZE - 2U, field, 4),
+                "Range past block end rejected");
+    TEST_ASSERT(!RamMirror_SeqlockVisit(block_id, 0, 4, NULL, NULL), "NULL visitor rejected");
+
+    SeqlockStats_t stats;
+    RamMirror_GetSeqlockStats(block_id, &stats);
+    TEST_ASSERT_EQ(stats.read_count, 3U, "Range reads and visits counted");
+    TEST_ASSERT_EQ(stats.write_count, 1U, "Write counted");
+
+    LOG_INFO("  Result: Passed");
+}
+
+static uint32_t byte_sum(const uint8_t* data, uint32_t size)
+{
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < size; i++) {
+        sum += data[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief Test the mirror data checksum (eager and lazy modes)
+ */
+static void test_seqlock_checksum(void)
+{
+    LOG_INFO("");
+    LOG_INFO("Test: Seqlock Checksum (eager / lazy)");
+
+    const NvM_BlockIdType block_id = 6;
+    static uint8_t pattern[RAM_MIRROR_MAX_BLOCK_SIZE];
+    static uint8_t expected[RAM_MIRROR_MAX_BLOCK_SIZE];
+    for (uint32_t i = 0; i < RAM_MIRROR_MAX_BLOCK_SIZE; i++) {
+        pattern[i] = (uint8_t)(i * 37U + 11U);
+    }
+
+    RamMirrorSeqlock_t* mirror = RamMirror_GetSeqlockMirror(block_id);
+    RamMirror_SeqlockInit(mirror, block_id);
+    memset(expected, 0xFF, sizeof(expected));
+
+    uint32_t checksum = 0;
+    TEST_ASSERT(RamMirror_SeqlockGetChecksum(block_id, &checksum), "Checksum of fresh mirror");
+    TEST_ASSERT_EQ(checksum, byte_sum(expected, RAM_MIRROR_MAX_BLOCK_SIZE),
+                   "Fresh mirror checksum covers erased bytes");
+
+    /* Eager: sizes around the vector width, short writes keep the tail */
+    static const uint16_t sizes[] = { 1, 15, 16, 17, 255, 1000, RAM_MIRROR_MAX_BLOCK_SIZE };
+    boolean eager_ok = TRUE;
+    for (uint32_t n = 0; n < sizeof(sizes) / sizeof(sizes[0]); n++) {
+        RamMirror_SeqlockWrite(block_id, &pattern[n], sizes[n]);
+        memcpy(expected, &pattern[n], sizes[n]);
+        if ((uint32_t)(mirror->checksum >> 32) != mirror->sequence ||
+            !RamMirror_SeqlockGetChecksum(block_id, &checksum) ||
+            checksum != byte_sum(expected, RAM_MIRROR_MAX_BLOCK_SIZE)) {
+            eager_ok = FALSE;
+        }
+    }
+    TEST_ASSERT(eager_ok, "Eager checksum stored by every write and correct");
+
+    /* Lazy: the write leaves the checksum stale, the first request computes it */
+    RamMirror_SetChecksumMode(RAM_MIRROR_CHECKSUM_LAZY);
+    RamMirror_SeqlockWrite(block_id, pattern, 333);
+    memcpy(expected, pattern, 333);
+    TEST_ASSERT((uint32_t)(mirror->checksum >> 32) != mirror->sequence,
+                "Lazy write leaves checksum stale");
+    TEST_ASSERT(RamMirror_SeqlockGetChecksum(block_id, &checksum), "Lazy checksum computed");
+    TEST_ASSERT_EQ(checksum, byte_sum(expected, RAM_MIRROR_MAX_BLOCK_SIZE), "Lazy checksum correct");
+    TEST_ASSERT_EQ((uint32_t)(mirror->checksum >> 32), mirror->sequence,
+                   "Computed checksum kept for the next caller");
+    RamMirror_SetChecksumMode(RAM_MIRROR_CHECKSUM_EAGER);
+
+    TEST_ASSERT(!RamMirror_SeqlockGetChecksum(block_id, NULL), "NULL output rejected");
+    TEST_ASSERT(!RamMirror_SeqlockGetChecksum(255, &checksum),
+                "Out-of-range block rejected");
+
+    LOG_INFO("  Result: Passed");
+}
+
+/**
+ * @brief Test multi-version (RCU) mirror mode
+ */
+static void test_rcu_mirror(void)
+{
+    LOG_INFO("");
+    LOG_INFO("Test: Multi-Version (RCU) Mirror");
+
+    const NvM_BlockIdType block_id = 6;
+    uint8_t data[64];
+    uint8_t out[64];
+    uint32_t version = 0xFFFFFFFFU;
+
+    RamMirror_RcuInit(block_id);
+    TEST_ASSERT_EQ(RamMirror_RcuGetVersion(block_id), 0U, "Initial version 0");
+
+    /* More writes than buffers: every buffer gets reclaimed and reused */
+    for (uint32_t i = 1; i <= 5U; i++) {
+        memset(data, (int)i, sizeof(data));
+        RamMirror_RcuWrite(block_id, data, sizeof(data));
+    }
+    TEST_ASSERT(RamMirror_RcuRead(block_id, out, sizeof(out), &version), "RCU read OK");
+    TEST_ASSERT_EQ(version, 5U, "Version counts writes");
+    TEST_ASSERT(out[0] == 5U && out[63] == 5U, "Latest version read");
+
+    VisitSum_t result = { 0, 0 };
+    TEST_ASSERT(RamMirror_RcuVisit(block_id, 60, 4, sum_visitor, &result), "RCU visit OK");
+    TEST_ASSERT_EQ(result.sum, 20U, "Visitor sees current version");
+    TEST_ASSERT(!RamMirror_RcuVisit(block_id, RAM_MIRROR_MAX_BLOCK_SIZE - 2U, 4, sum_visitor, &result),
+                "RCU visit past block end rejected");
+
+    /* Short write keeps the tail from the previous version */
+    memset(data, 9, 8);
+    RamMirror_RcuWrite(block_id, data, 8);
+    RamMirror_RcuRead(block_id, out, sizeof(out), NULL);
+    TEST_ASSERT(out[7] == 9U && out[8] == 5U, "Short write preserves tail");
+
+    RcuStats_t stats;
+    RamMirror_GetRcuStats(block_id, &stats);
+    TEST_ASSERT_EQ(stats.write_count, 6U, "RCU writes counted");
+    TEST_ASSERT_EQ(stats.grace_waits, 0U, "No grace wait without readers");
+
+    /* Per-block mode selection through NvM_BlockConfig_t */
+    NvM_Init();
+    static uint8_t mirror[256];
+    NvM_BlockConfig_t block = {
+        .block_id = block_id, .block_size = 256, .block_type = NVM_BLOCK_NATIVE,
+        .crc_type = NVM_CRC16, .priority = 10, .ram_mirror_ptr = mirror,
+        .mirror_mode = NVM_MIRROR_RCU, .eeprom_offset = 0x0000
+    };
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block), E_OK, "RCU block registered");
+    TEST_ASSERT_EQ(RamMirror_GetMode(block_id), NVM_MIRROR_RCU, "Mode taken from block config");
+
+    uint32_t generation = RamMirror_GetGeneration(block_id);
+    memset(data, 0x3C, sizeof(data));
+    TEST_ASSERT_EQ(RamMirror_Write(block_id, data, sizeof(data)), E_OK, "Dispatched write OK");
+    TEST_ASSERT(RamMirror_Read(block_id, out, sizeof(out)) && out[0] == 0x3C, "Dispatched read OK");
+    TEST_ASSERT(RamMirror_GetGeneration(block_id) != generation, "RCU write bumps generation");
+
+    block.block_id = 7;
+    block.mirror_mode = (NvM_MirrorModeType_t)7;
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block), E_NOT_OK, "Invalid mirror mode rejected");
+
+    LOG_INFO("  Result: Passed");
+}
+
+/**
+ * @brief Test mirror arena allocation at registration
+ */
+static void test_mirror_arena(void)
+{
+    LOG_INFO("");
+    LOG_INFO("Test: Mirror Arena");
+
+    NvM_Init();
+    TEST_ASSERT_EQ(RamMirror_GetArenaUsage(), 0U, "Arena empty after NvM_Init");
+
+    static uint8_t mirror[1024];
+    NvM_BlockConfig_t block = {
+        .block_id = 20, .block_size = 100, .block_type = NVM_BLOCK_NATIVE,
+        .crc_type = NVM_CRC16, .priority = 10, .ram_mirror_ptr = mirror,
+        .mirror_mode = NVM_MIRROR_SEQLOCK, .eeprom_offset = 0x0000
+    };
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block), E_OK, "Seqlock block registered");
+    TEST_ASSERT_EQ(RamMirror_GetArenaUsage(), 128U, "100-byte block takes two cache lines");
+
+    RamMirrorSeqlock_t* seqlock = RamMirror_GetSeqlockMirror(20);
+    TEST_ASSERT(((uintptr_t)seqlock->data % RAM_MIRROR_CACHE_LINE_SIZE) == 0U,
+                "Mirror data cache-line aligned");
+
+    uint8_t data[100];
+    uint8_t out[100];
+    memset(data, 0x5A, sizeof(data));
+    TEST_ASSERT_EQ(RamMirror_Write(20, data, sizeof(data)), E_OK, "Write of block size OK");
+    TEST_ASSERT(RamMirror_Read(20, out, sizeof(out)) && out[99] == 0x5A, "Read back OK");
+    TEST_ASSERT_EQ(RamMirror_SeqlockWrite(20, mirror, 101), E_NOT_OK, "Write past block size rejected");
+    TEST_ASSERT(!RamMirror_SeqlockReadRange(20, 96, out, 8), "Range past block size rejected");
+
+    /* RCU block: three buffers, no seqlock buffer */
+    block.block_id = 21;
+    block.block_size = 64;
+    block.mirror_mode = NVM_MIRROR_RCU;
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block), E_OK, "RCU block registered");
+    TEST_ASSERT_EQ(RamMirror_GetArenaUsage(), 128U + 3U * 64U, "RCU block takes one line per buffer");
+    TEST_ASSERT(!RamMirror_SeqlockRead(21, out, 8), "RCU block has no seqlock buffer");
+    TEST_ASSERT_EQ(RamMirror_Write(21, data, 64), E_OK, "RCU write OK");
+
+    /* Re-registration reuses the buffer */
+    block.block_id = 20;
+    block.block_size = 128;
+    block.mirror_mode = NVM_MIRROR_SEQLOCK;
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block), E_OK, "Block re-registered");
+    TEST_ASSERT_EQ(RamMirror_GetArenaUsage(), 320U, "Buffer reused");
+
+    block.block_id = 22;
+    block.block_size = 1000;
+    TEST_ASSERT_EQ(NvM_RegisterBlock(&block), E_OK, "Large block registered");
+    TEST_ASSERT_EQ(RamMirror_GetArenaUsage(), 320U + 1024U, "Size rounded up to a cache line");
+
+    NvM_Diagnostics_t diag;
+    NvM_GetDiagnostics(&diag);
+    TEST_ASSERT_EQ(diag.mirror_arena_bytes, RamMirror_GetArenaUsage(), "Arena usage in diagnostics");
+
+    /* A full arena fails the registration */
+    Std_ReturnType ret = E_OK;
+    block.block_size = RAM_MIRROR_MAX_BLOCK_SIZE;
+    block.mirror_mode = NVM_MIRROR_RCU;
+    for (uint8_t id = 30; id < 250U && ret == E_OK; id++) {
+        block.block_id = id;
+        ret = NvM_RegisterBlock(&block);
+    }
+    TEST_ASSERT_EQ(ret, E_NOT_OK, "Registration fails once the arena is full");
+    TEST_ASSERT(RamMirror_GetArenaUsage() <= RAM_MIRROR_ARENA_SIZE, "Arena not overrun");
+
+    NvM_Init();
+    TEST_ASSERT_EQ(RamMirror_GetArenaUsage(), 0U, "NvM_Init empties the arena");
+
+    LOG_INFO("  Result: Passed");
+}
+
+/**
+ * @brief Multi-core scheduler scenario: NvM core writes, application cores read
+ */
+#define MC_BLOCK_ID 5
+#define MC_BLOCK_SIZE 128
+#define MC_READS_PER_RUN 64U
+
+static uint8_t g_mc_pattern;
+static uint32_t g_mc_tears;
+static uint32_t g_mc_reads;
+static uint32_t g_mc_failed_reads;
+
+static void mc_nvm_task(void)
+{
+    uint8_t data[MC_BLOCK_SIZE];
+
+    NvM_MainFunction();
+    g_mc_pattern++;
+    memset(data, g_mc_pattern, sizeof(data));
+    (void)RamMirror_SeqlockWrite(MC_BLOCK_ID, data, sizeof(data));
+}
+
+static void mc_app_task(void)
+{
+    uint8_t buffer[MC_BLOCK_SIZE];
+
+    for (uint32_t n = 0; n < MC_READS_PER_RUN; n++) {
+        if (!RamMirror_SeqlockRead(MC_BLOCK_ID, buffer, sizeof(buffer))) {
+            __atomic_add_fetch(&g_mc_failed_reads, 1U, __ATOMIC_RELAXED);
+            continue;
+        }
+        for (uint32_t i = 1; i < sizeof(buffer); i++) {
+            if (buffer[i] != buffer[0]) {
+                __atomic_add_fetch(&g_mc_tears, 1U, __ATOMIC_RELAXED);
+                break;
+            }
+        }
+        __atomic_add_fetch(&g_mc_reads, 1U, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Test seqlock under the scheduler's multi-core mode
+ */
+static void test_multicore_scheduler(void)
+{
+    LOG_INFO("");
+    LOG_INFO("Test: Seqlock on Scheduler Cores");
+
+    NvM_Init();
+    OsScheduler_Init(16);
+    TEST_ASSERT_EQ(OsScheduler_SetCoreCount(3), E_OK, "Three virtual cores");
+
+    RamMirror_SeqlockInit(RamMirror_GetSeqlockMirror(MC_BLOCK_ID), MC_BLOCK_ID);
+    g_mc_pattern = 0;
+    g_mc_tears = 0;
+    g_mc_reads = 0;
+    g_mc_failed_reads = 0;
+    mc_nvm_task();
+
+    OsTask_t nvm_task = { .task_id = 1, .task_name = "NvM", .period_ms = 1, .priority = 1,
+                          .task_func = mc_nvm_task };
+    OsTask_t app1 = { .task_id = 2, .task_name = "App1", .period_ms = 1, .priority = 1,
+                      .task_func = mc_app_task };
+    OsTask_t app2 = { .task_id = 3, .task_name = "App2", .period_ms = 1, .priority = 1,
+                      .task_func = mc_app_task };
+    OsScheduler_RegisterTaskOnCore(0, &nvm_task);
+    OsScheduler_RegisterTaskOnCore(1, &app1);
+    OsScheduler_RegisterTaskOnCore(2, &app2);
+    OsScheduler_Start();
+
+    uint32_t runs = OsScheduler_RunCores(2000, 5);
+    LOG_INFO("  %u task runs, %u reads, %u tears", runs, g_mc_reads, g_mc_tears);
+
+    TEST_ASSERT_EQ(runs, 3U * 2000U, "Every core ran its task every millisecond");
+    TEST_ASSERT_EQ(g_mc_reads + g_mc_failed_reads, 2U * 2000U * MC_READS_PER_RUN,
+                   "Every read attempted");
+    TEST_ASSERT_EQ(g_mc_tears, 0U, "No data tearing across cores");
+    tear_count += g_mc_tears;
+
+    OsScheduler_Destroy();
+    OsScheduler_Init(16);
+}
+
 /**
  * @brief Run all RAM mirror tests
  */
@@ -476,6 +834,11 @@ int main(void)
     test_atomic_operations();
     test_memory_barriers();
     test_seqlock_retry();
+    test_seqlock_visit();
+    test_seqlock_checksum();
+    test_rcu_mirror();
+    test_mirror_arena();
+    test_multicore_scheduler();
 
     /* Print summary */
     LOG_INFO("");
@@ -0,0 +1,184 @@
+/**
+ * @file test_timeline.c
+ * @brief Unit tests for the virtual-time activity timeline
+ *
+ * - 调度器任务运行, NvM作业 (入队 → 开始 → 完成) 与EEPROM忙区间均被记录
+ * - 器件操作串行: 后一次不早于前一次结束
+ * - 导出为Chrome trace-event JSON, 与snprintf相同的截断语义
+ * - 缓冲满时丢弃并计数; 停止后不再记录
+ */
+
+#include "timeline.h"
+#include "nvm.h"
+#include "eeprom_driver.h"
+#include "os_scheduler.h"
+#include "logging.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#define TIMELINE_PATH "/tmp/eepsim_test_timeline.json"
+#define TEST_BLOCK_ID 12
+
+static uint8_t g_mirror[256];
+
+static void nvm_task(void)
+{
+    NvM_MainFunction();
+}
+
+static void setup(void)
+{
+    NvM_Init();
+    OsScheduler_Init(8);
+
+    NvM_BlockConfig_t block = {
+        .block_id = TEST_BLOCK_ID, .block_size = 256, .block_type = NVM_BLOCK_NATIVE,
+        .crc_type = NVM_CRC16, .priority = 10, .ram_mirror_ptr = g_mirror,
+        .eeprom_offset = 0x0000
+    };
+    assert(NvM_RegisterBlock(&block) == E_OK);
+
+    OsTask_t task = {
+        .task_id = 1, .task_name = "NvM_Main", .period_ms = 10, .priority = 1,
+        .task_func = nvm_task
+    };
+    assert(OsScheduler_RegisterTask(&task) == E_OK);
+    assert(OsScheduler_Start() == E_OK);
+}
+
+static char *export_text(void)
+{
+    size_t length = Timeline_Export(NULL, 0U);
+    char *text = malloc(length + 1U);
+
+    assert(length > 0U && text != NULL);
+    assert(Timeline_Export(text, length + 1U) == length);
+    assert(strlen(text) == length);
+    return text;
+}
+
+static void test_records_activity(void)
+{
+    LOG_INFO("Test: tasks, jobs and device intervals are recorded");
+
+    Timeline_Stats_t stats;
+    uint8_t data[256];
+
+    setup();
+    assert(!TIMELINE_ACTIVE());
+    assert(Timeline_Start(0) == E_OK);
+    assert(TIMELINE_ACTIVE());
+    assert(Timeline_Start(0) == E_NOT_OK);
+    assert(Timeline_Export(NULL, 0U) == 0U);
+
+    memset(data, 0x5A, sizeof(data));
+    assert(NvM_WriteBlock(TEST_BLOCK_ID, data) == E_OK);
+    (void)OsScheduler_RunUntil(100);
+    Timeline_Stop();
+    assert(!TIMELINE_ACTIVE());
+
+    /* Nothing recorded after stop */
+    assert(Timeline_GetStats(&stats) == E_OK);
+    uint32_t events = stats.events;
+    (void)OsScheduler_RunUntil(200);
+    assert(Timeline_GetStats(&stats) == E_OK);
+    assert(stats.events == events && stats.dropped == 0U);
+    assert(stats.capacity == TIMELINE_DEFAULT_EVENTS);
+    assert(Timeline_GetStats(NULL) == E_NOT_OK);
+
+    char *text = export_text();
+    assert(strncmp(text, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 38) == 0);
+    assert(strstr(text, "\"name\":\"NvM_Main\"") != NULL);
+    assert(strstr(text, "\"name\":\"core 0\"") != NULL);
+    assert(strstr(text, "\"name\":\"EEPROM\"") != NULL);
+    assert(strstr(text, "\"name\":\"program\"") != NULL);
+    assert(strstr(text, "\"name\":\"block 12\"") != NULL);
+    assert(strstr(text, "\"ph\":\"X\",\"pid\":3,\"tid\":12,\"name\":\"write\"") != NULL);
+    assert(strstr(text, "\"result\":\"ok\"") != NULL);
+    assert(strcmp(text + strlen(text) - 4U, "\n]}\n") == 0);
+    LOG_INFO("  ✓ %u events, %zu bytes of JSON", events, strlen(text));
+
+    /* Truncated like snprintf */
+    char small[16];
+    assert(Timeline_Export(small, sizeof(small)) == strlen(text));
+    assert(strlen(small) == sizeof(small) - 1U && strncmp(small, text, 15) == 0);
+    free(text);
+
+    assert(Timeline_ExportFile(TIMELINE_PATH) == E_OK);
+    FILE *f = fopen(TIMELINE_PATH, "r");
+    assert(f != NULL);
+    assert(fgetc(f) == '{');
+    fclose(f);
+    remove(TIMELINE_PATH);
+}
+
+static void test_device_serialized(void)
+{
+    LOG_INFO("Test: device operations queue behind each other");
+
+    assert(Timeline_Start(4) == E_OK);
+    Timeline_DeviceOp(EEP_OP_WRITE, E_OK, 0x100, 256, 1000U, 2000U);
+    Timeline_DeviceOp(EEP_OP_READ, E_OK, 0x100, 256, 1500U, 300U);
+    Timeline_DeviceOp(EEP_OP_ERASE, E_NOT_OK, 0x400, 1024, 9000U, 3000U);
+    Timeline_Stop();
+
+    char *text = export_text();
+    assert(strstr(text, "\"name\":\"program\",\"ts\":1000,\"dur\":2000") != NULL);
+    assert(strstr(text, "\"name\":\"read\",\"ts\":3000,\"dur\":300") != NULL);
+    assert(strstr(text, "\"name\":\"erase\",\"ts\":9000,\"dur\":3000") != NULL);
+    assert(strstr(text, "\"result\":\"failed\"") != NULL);
+    assert(strstr(text, "Scheduler") == NULL);
+    free(text);
+}
+
+static void test_overflow(void)
+{
+    LOG_INFO("Test: full buffer drops and counts");
+
+    Timeline_Stats_t stats;
+
+    assert(Timeline_Start(2) == E_OK);
+    Timeline_Job(TIMELINE_JOB_QUEUED, 3, 0, E_OK, 100U);
+    Timeline_Job(TIMELINE_JOB_STARTED, 3, 0, E_OK, 400U);
+    Timeline_Job(TIMELINE_JOB_COMPLETED, 3, 0, E_OK, 900U);
+    Timeline_TaskRun(0, 1, NULL, 0U, 10U);
+    Timeline_Stop();
+
+    assert(Timeline_GetStats(&stats) == E_OK);
+    assert(stats.capacity == 2U && stats.events == 2U && stats.dropped == 2U);
+
+    /* Queue wait paired; the job itself never completed in the buffer */
+    char *text = export_text();
+    assert(strstr(text, "\"name\":\"queued\",\"ts\":100,\"dur\":300") != NULL);
+    assert(strstr(text, "\"name\":\"read\"") == NULL);
+    free(text);
+
+    /* A restart discards the previous recording */
+    assert(Timeline_Start(8) == E_OK);
+    Timeline_Job(TIMELINE_JOB_COMPLETED, 0xFF, 0, E_NOT_OK, 50U);
+    Timeline_Stop();
+    assert(Timeline_GetStats(&stats) == E_OK);
+    assert(stats.events == 1U && stats.dropped == 0U);
+    text = export_text();
+    assert(strstr(text, "\"name\":\"ReadAll/WriteAll\"") != NULL);
+    assert(strstr(text, "\"ph\":\"i\",\"pid\":3,\"tid\":255,\"name\":\"completed\"") != NULL);
+    free(text);
+}
+
+int main(void)
+{
+    LOG_INFO("========================================");
+    LOG_INFO("  Timeline Unit Tests");
+    LOG_INFO("========================================");
+
+    test_records_activity();
+    test_device_serialized();
+    test_overflow();
+
+    LOG_INFO("========================================");
+    LOG_INFO("  All timeline tests passed");
+    LOG_INFO("========================================");
+    return 0;
+}
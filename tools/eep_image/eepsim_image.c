@@ -0,0 +1,416 @@
+/**
+ * @file eepsim_image.c
+ * @brief Build a ready EEPROM image from a block description, or inspect one
+ *
+ * 用法: eepsim_image build desc.txt image.img
+ *       eepsim_image inspect [-x] desc.txt image.img
+ * - 构建: 删除旧镜像与 .wear 旁路文件, 以mmap后端初始化器件, NvM_ImageBuild编程全部Block
+ * - 检查: 同一描述解码并校验每个Block, JSON报告; 全部有效时退出码0
+ * - -x: 报告中附带NvM会读到的数据 (十六进制)
+ *
+ * Description (one statement per line, '#' starts a comment):
+ *   device capacity=8192 page=256 block=1024 endurance=100000
+ *   block id=1 type=native size=256 offset=0x0000 crc=crc16 data=0xA5
+ *   block id=2 type=redundant size=200 offset=0x0400 backup=0x0800 crc=crc32
+ *         placement=inline data=@calib.bin wear=120
+ *   block id=3 type=dataset size=64 offset=0x0C00 count=3 crc=crc16
+ *         placement=inline compression=rle data=0x11,0x22,inc
+ * (a block statement is one line; it is wrapped here for width)
+ *
+ * data= lists one payload per version, oldest first: a fill byte, "inc"
+ * (0, 1, 2, ...) or @file (relative to the description, zero-padded).
+ * Without a device statement the driver's default geometry is used.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "nvm_image.h"
+#include "eeprom_driver.h"
+#include "memif.h"
+#include "logging.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define IMAGE_MAX_BLOCKS 64U
+#define IMAGE_LINE_MAX 512U
+
+typedef struct {
+    Eeprom_ConfigType device;
+    NvM_ImageBlock_t blocks[IMAGE_MAX_BLOCKS];
+    uint32_t count;
+    char dir[256];                  /**< Directory of the description (for @file) */
+} ImageDesc_t;
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s build desc.txt image.img\n", prog);
+    fprintf(stderr, "       %s inspect [-x] desc.txt image.img\n", prog);
+    fprintf(stderr, "  -x  Include the data NvM would read in the report\n");
+}
+
+static boolean parse_uint(const char *text, uint32_t *value)
+{
+    char *end;
+    unsigned long v = strtoul(text, &end, 0);
+
+    if (*text == '\0' || *end != '\0' || v > 0xFFFFFFFFUL) {
+        return FALSE;
+    }
+    *value = (uint32_t)v;
+    return TRUE;
+}
+
+static boolean parse_name(const char *text, const char *const *names, uint32_t count,
+                          uint32_t *value)
+{
+    for (uint32_t i = 0; i < count; i++) {
+        if (strcmp(text, names[i]) == 0) {
+            *value = i;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/**
+ * @brief One payload: fill byte, "inc" or @file
+ */
+static uint8_t *load_payload(const ImageDesc_t *desc, const char *spec, uint16_t size)
+{
+    uint8_t *data = calloc(1U, size);
+    uint32_t fill;
+
+    if (data == NULL) {
+        return NULL;
+    }
+
+    if (strcmp(spec, "inc") == 0) {
+        for (uint16_t i = 0; i < size; i++) {
+            data[i] = (uint8_t)i;
+        }
+    } else if (spec[0] == '@') {
+        char path[512];
+        if (spec[1] == '/') {
+            snprintf(path, sizeof(path), "%s", &spec[1]);
+        } else {
+            snprintf(path, sizeof(path), "%s%s", desc->dir, &spec[1]);
+        }
+        FILE *f = fopen(path, "rb");
+        if (f == NULL) {
+            fprintf(stderr, "%s: cannot open\n", path);
+            free(data);
+            return NULL;
+        }
+        (void)fread(data, 1U, size, f);
+        fclose(f);
+    } else if (parse_uint(spec, &fill) && fill <= 0xFFU) {
+        memset(data, (int)fill, size);
+    } else {
+        fprintf(stderr, "Bad payload '%s'\n", spec);
+        free(data);
+        return NULL;
+    }
+    return data;
+}
+
+static boolean parse_block(ImageDesc_t *desc, char *saveptr, uint32_t line)
+{
+    static const char *const types[] = { "native", "redundant", "dataset" };
+    static const char *const crcs[] = { "none", "crc8", "crc16", "crc32" };
+    static const char *const placements[] = { "page", "inline" };
+    static const char *const codecs[] = { "none", "rle" };
+
+    if (desc->count == IMAGE_MAX_BLOCKS) {
+        fprintf(stderr, "line %u: more than %u blocks\n", line, IMAGE_MAX_BLOCKS);
+        return FALSE;
+    }
+
+    NvM_ImageBlock_t *block = &desc->blocks[desc->count];
+    NvM_BlockConfig_t *cfg = &block->config;
+    char *data_spec = NULL;
+    uint32_t value = 0U;
+    boolean ok = TRUE;
+    boolean has_id = FALSE;
+    char *token;
+
+    memset(block, 0, sizeof(NvM_ImageBlock_t));
+    cfg->crc_type = NVM_CRC16;
+    cfg->dataset_count = 1U;
+
+    while (ok && (token = strtok_r(NULL, " \t\r\n", &saveptr)) != NULL) {
+        char *val = strchr(token, '=');
+        if (val == NULL) {
+            ok = FALSE;
+            break;
+        }
+        *val++ = '\0';
+
+        if (strcmp(token, "data") == 0) {
+            data_spec = val;
+        } else if (strcmp(token, "type") == 0) {
+            ok = parse_name(val, types, 3U, &value);
+            cfg->block_type = (NvM_BlockType_t)value;
+        } else if (strcmp(token, "crc") == 0) {
+            ok = parse_name(val, crcs, 4U, &value);
+            cfg->crc_type = (NvM_CrcType_t)value;
+        } else if (strcmp(token, "placement") == 0) {
+            ok = parse_name(val, placements, 2U, &value);
+            cfg->crc_placement = (NvM_CrcPlacementType_t)value;
+        } else if (strcmp(token, "compression") == 0) {
+            ok = parse_name(val, codecs, 2U, &value);
+            cfg->compression = (NvM_CompressionType_t)value;
+        } else if (!parse_uint(val, &value)) {
+            ok = FALSE;
+        } else if (strcmp(token, "id") == 0 && value <= 0xFEU) {
+            cfg->block_id = (uint8_t)value;
+            has_id = TRUE;
+        } else if (strcmp(token, "size") == 0 && value > 0U && value <= EEPROM_BLOCK_SLOT_SIZE) {
+            cfg->block_size = (uint16_t)value;
+        } else if (strcmp(token, "offset") == 0) {
+            cfg->eeprom_offset = value;
+        } else if (strcmp(token, "backup") == 0) {
+            cfg->redundant_eeprom_offset = value;
+        } else if (strcmp(token, "count") == 0 && value <= EEPROM_MAX_DATASET_COUNT) {
+            cfg->dataset_count = (uint8_t)value;
+        } else if (strcmp(token, "wear") == 0) {
+            block->erase_count = value;
+        } else {
+            ok = FALSE;
+        }
+    }
+    if (!ok || !has_id || cfg->block_size == 0U) {
+        fprintf(stderr, "line %u: bad block statement\n", line);
+        return FALSE;
+    }
+
+    /* Payloads, oldest first (one for NATIVE/REDUNDANT; none = zeros) */
+    char *spec_save = NULL;
+    char *spec = (data_spec != NULL) ? strtok_r(data_spec, ",", &spec_save) : NULL;
+    while (spec != NULL) {
+        if (block->version_count == EEPROM_MAX_DATASET_COUNT) {
+            fprintf(stderr, "line %u: more than %u versions\n", line, EEPROM_MAX_DATASET_COUNT);
+            return FALSE;
+        }
+        block->data[block->version_count] = load_payload(desc, spec, cfg->block_size);
+        if (block->data[block->version_count] == NULL) {
+            return FALSE;
+        }
+        block->version_count++;
+        spec = strtok_r(NULL, ",", &spec_save);
+    }
+    if (block->version_count == 0U) {
+        block->data[0] = load_payload(desc, "0", cfg->block_size);
+        block->version_count = 1U;
+    }
+    if (cfg->block_type != NVM_BLOCK_DATASET && block->version_count > 1U) {
+        fprintf(stderr, "line %u: only dataset blocks take several versions\n", line);
+        return FALSE;
+    }
+
+    desc->count++;
+    return TRUE;
+}
+
+static boolean parse_device(Eeprom_ConfigType *device, char *saveptr, uint32_t line)
+{
+    uint32_t value;
+    char *token;
+
+    while ((token = strtok_r(NULL, " \t\r\n", &saveptr)) != NULL) {
+        char *val = strchr(token, '=');
+        if (val == NULL || !parse_uint(val + 1, &value)) {
+            fprintf(stderr, "line %u: bad device statement\n", line);
+            return FALSE;
+        }
+        *val = '\0';
+        if (strcmp(token, "capacity") == 0) {
+            device->capacity_bytes = value;
+        } else if (strcmp(token, "page") == 0) {
+            device->page_size = value;
+        } else if (strcmp(token, "block") == 0) {
+            device->block_size = value;
+        } else if (strcmp(token, "endurance") == 0) {
+            device->endurance_cycles = value;
+        } else {
+            fprintf(stderr, "line %u: unknown device key '%s'\n", line, token);
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static boolean parse_desc(const char *path, ImageDesc_t *desc)
+{
+    char line[IMAGE_LINE_MAX];
+    uint32_t number = 0;
+    boolean ok = TRUE;
+
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return FALSE;
+    }
+
+    const char *slash = strrchr(path, '/');
+    size_t dir_len = (slash != NULL) ? (size_t)(slash - path) + 1U : 0U;
+    if (dir_len >= sizeof(desc->dir)) {
+        dir_len = 0U;
+    }
+    memcpy(desc->dir, path, dir_len);
+    desc->dir[dir_len] = '\0';
+
+    while (ok && fgets(line, sizeof(line), f) != NULL) {
+        char *saveptr = NULL;
+        number++;
+
+        char *comment = strchr(line, '#');
+        if (comment != NULL) {
+            *comment = '\0';
+        }
+        char *keyword = strtok_r(line, " \t\r\n", &saveptr);
+        if (keyword == NULL) {
+            continue;
+        }
+        if (strcmp(keyword, "device") == 0) {
+            ok = parse_device(&desc->device, saveptr, number);
+        } else if (strcmp(keyword, "block") == 0) {
+            ok = parse_block(desc, saveptr, number);
+        } else {
+            fprintf(stderr, "line %u: unknown statement '%s'\n", number, keyword);
+            ok = FALSE;
+        }
+    }
+    fclose(f);
+    return ok;
+}
+
+/**
+ * @brief Driver defaults, then the description's device statement
+ */
+static Std_ReturnType init_device(ImageDesc_t *desc, const char *image_path)
+{
+    desc->device.image_path = image_path;
+    if (MemIf_Init() != E_OK) {
+        return E_NOT_OK;
+    }
+    return Eep_Init(&desc->device);
+}
+
+static int build(ImageDesc_t *desc, const char *image_path)
+{
+    char wear_path[512];
+
+    snprintf(wear_path, sizeof(wear_path), "%s.wear", image_path);
+    remove(image_path);
+    remove(wear_path);
+
+    if (init_device(desc, image_path) != E_OK) {
+        fprintf(stderr, "%s: cannot create the image\n", image_path);
+        return 1;
+    }
+
+    Std_ReturnType ret = NvM_ImageBuild(desc->blocks, desc->count);
+    Eep_Destroy();
+    if (ret != E_OK) {
+        fprintf(stderr, "%s: build failed\n", image_path);
+        remove(image_path);
+        remove(wear_path);
+        return 1;
+    }
+
+    printf("%s: %u blocks, %u bytes\n", image_path, desc->count, desc->device.capacity_bytes);
+    return 0;
+}
+
+static int inspect(ImageDesc_t *desc, const char *image_path, boolean hex)
+{
+    static const char *const types[] = { "native", "redundant", "dataset" };
+    uint8_t data[EEPROM_BLOCK_SLOT_SIZE];
+    boolean all_valid = TRUE;
+
+    if (access(image_path, R_OK) != 0 || init_device(desc, image_path) != E_OK) {
+        fprintf(stderr, "%s: cannot map the image (geometry differs from the description?)\n",
+                image_path);
+        return 1;
+    }
+
+    printf("{\n");
+    printf("  \"image\": \"%s\",\n", image_path);
+    printf("  \"blocks\": [");
+    for (uint32_t i = 0; i < desc->count; i++) {
+        const NvM_BlockConfig_t *cfg = &desc->blocks[i].config;
+        NvM_ImageReport_t report;
+
+        if (NvM_ImageInspectBlock(cfg, data, &report) != E_OK) {
+            all_valid = FALSE;
+        }
+        printf("%s\n    {\"id\": %u, \"type\": \"%s\", \"valid\": %s, \"copies\": %u, "
+               "\"valid_mask\": %u, \"header_mask\": %u, \"selected\": %d, \"sequence\": %u, "
+               "\"erase_count\": %u", (i > 0U) ? "," : "", cfg->block_id,
+               types[cfg->block_type], report.valid ? "true" : "false", report.copies,
+               report.valid_mask, report.header_mask,
+               (report.selected < report.copies) ? (int)report.selected : -1, report.sequence,
+               report.erase_count);
+        if (hex && report.selected < report.copies) {
+            printf(", \"data\": \"");
+            for (uint16_t b = 0; b < cfg->block_size; b++) {
+                printf("%02x", data[b]);
+            }
+            printf("\"");
+        }
+        printf("}");
+    }
+    printf("\n  ],\n");
+    printf("  \"valid\": %s\n", all_valid ? "true" : "false");
+    printf("}\n");
+
+    Eep_Destroy();
+    return all_valid ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    static ImageDesc_t desc;
+    boolean hex = FALSE;
+    int opt;
+
+    if (argc < 2) {
+        usage(argv[0]);
+        return 2;
+    }
+    const char *command = argv[1];
+    optind = 2;
+    while ((opt = getopt(argc, argv, "xh")) != -1) {
+        if (opt == 'x') {
+            hex = TRUE;
+        } else {
+            usage(argv[0]);
+            return (opt == 'h') ? 0 : 2;
+        }
+    }
+    if (optind != argc - 2 ||
+        (strcmp(command, "build") != 0 && strcmp(command, "inspect") != 0)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    Log_SetLevel(LOG_LEVEL_ERROR);
+
+    /* Driver default geometry unless the description sets it */
+    if (Eep_Init(NULL) != E_OK) {
+        return 1;
+    }
+    desc.device = *Eep_GetConfig();
+    desc.device.virtual_storage = NULL;
+    desc.device.backend = NULL;
+    Eep_Destroy();
+
+    if (!parse_desc(argv[optind], &desc)) {
+        return 2;
+    }
+
+    return (strcmp(command, "build") == 0) ? build(&desc, argv[optind + 1])
+                                           : inspect(&desc, argv[optind + 1], hex);
+}
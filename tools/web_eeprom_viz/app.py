@@ -2,14 +2,26 @@
 EEPROM可视化仿真平台 - Flask主应用
 """
 
+import os
+
 from flask import Flask, render_template, jsonify, request
 from eeprom_simulator import EEPROMChip
+from eep_engine import EngineChip, EngineError
 from nvm_simulator import NvMSimulator, JobType, JobPriority, WriteAllSimulator, BlockTypeSimulator
 
 app = Flask(__name__)
 
-# 创建仿真器实例
-chip = EEPROMChip(size_kb=4)
+# 创建仿真器实例: 优先使用C引擎 (build/lib), EEPSIM_ENGINE=0 或库缺失时退回Python仿真
+def create_chip():
+    if os.environ.get('EEPSIM_ENGINE', '1') != '0':
+        try:
+            return EngineChip(size_kb=4)
+        except EngineError as exc:
+            app.logger.warning('%s, 使用Python仿真', exc)
+    return EEPROMChip(size_kb=4)
+
+
+chip = create_chip()
 nvm_sim = NvMSimulator()
 writeall_sim = WriteAllSimulator()
 blocktype_sim = BlockTypeSimulator()
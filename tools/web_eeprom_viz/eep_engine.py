@@ -0,0 +1,248 @@
+"""
+真实引擎绑定 - 通过ctypes驱动C实现 (build/lib/libnvm.so)
+- 镜像与擦写计数通过 Eep_GetStorageView / Eep_GetEraseCountView 以memoryview零拷贝暴露 (缓冲区协议)
+- 读/写/擦除走真实驱动: 对齐检查、擦写计数、诊断与C端完全一致
+- EngineChip 提供与 EEPROMChip 相同的接口, app.py 可直接替换
+- 驱动为进程级单例: 同一进程只应存在一个 EepEngine
+"""
+
+import ctypes
+import os
+from typing import Iterator, List, Optional, Tuple
+
+E_OK = 0
+EEP_CAP_BIT_CLEAR = 0x0001
+EEP_PROGRAM_BLANK = 0
+EEP_PROGRAM_BIT_CLEAR = 1
+
+
+class EngineError(RuntimeError):
+    """引擎库缺失或驱动调用失败"""
+
+
+class EepConfig(ctypes.Structure):
+    """Eeprom_ConfigType (eeprom_driver.h)"""
+    _fields_ = [
+        ('capacity_bytes', ctypes.c_uint32),
+        ('page_size', ctypes.c_uint32),
+        ('block_size', ctypes.c_uint32),
+        ('read_delay_us', ctypes.c_uint32),
+        ('write_delay_ms', ctypes.c_uint32),
+        ('erase_delay_ms', ctypes.c_uint32),
+        ('endurance_cycles', ctypes.c_uint32),
+        ('virtual_storage', ctypes.c_void_p),
+        ('backend', ctypes.c_void_p),
+        ('image_path', ctypes.c_char_p),
+        ('capabilities', ctypes.c_uint32),
+    ]
+
+
+class EepDiag(ctypes.Structure):
+    """Eeprom_DiagInfoType (eeprom_driver.h)"""
+    _fields_ = [(name, ctypes.c_uint32) for name in (
+        'total_read_count', 'total_write_count', 'total_erase_count', 'max_erase_count',
+        'crc_error_count', 'total_bytes_read', 'total_bytes_written', 'resident_bytes',
+        'skipped_erase_count', 'skipped_blank_check_count', 'total_verify_count',
+        'verify_mismatch_count', 'bit_clear_write_count', 'ecc_corrected_count',
+        'ecc_uncorrectable_count',
+    )]
+
+
+def default_lib_dir() -> str:
+    """库目录: 环境变量 EEPSIM_LIB_DIR, 否则仓库内 build/lib"""
+    env = os.environ.get('EEPSIM_LIB_DIR')
+    if env:
+        return env
+    here = os.path.dirname(os.path.abspath(__file__))
+    return os.path.normpath(os.path.join(here, '..', '..', 'build', 'lib'))
+
+
+def _load(lib_dir: str) -> ctypes.CDLL:
+    # libnvm.so 与 libosshim.so 互相引用: 前者延迟绑定并全局导出, 再加载后者
+    try:
+        lib = ctypes.CDLL(os.path.join(lib_dir, 'libnvm.so'), mode=os.RTLD_LAZY | os.RTLD_GLOBAL)
+        ctypes.CDLL(os.path.join(lib_dir, 'libosshim.so'), mode=os.RTLD_GLOBAL)
+    except OSError as exc:
+        raise EngineError(f'无法加载引擎库 ({lib_dir}), 请先在仓库根目录执行 make: {exc}') from exc
+
+    u32, u32p = ctypes.c_uint32, ctypes.POINTER(ctypes.c_uint32)
+    lib.Eep_Init.argtypes = [ctypes.POINTER(EepConfig)]
+    lib.Eep_Read.argtypes = [u32, ctypes.c_void_p, u32]
+    lib.Eep_Write.argtypes = [u32, ctypes.c_char_p, u32]
+    lib.Eep_Erase.argtypes = [u32]
+    lib.Eep_SetProgramMode.argtypes = [ctypes.c_int]
+    lib.Eep_GetDiagnostics.argtypes = [ctypes.POINTER(EepDiag)]
+    lib.Eep_GetStorageView.argtypes = [u32, ctypes.POINTER(ctypes.c_void_p), u32p]
+    lib.Eep_GetEraseCountView.argtypes = [u32, ctypes.POINTER(ctypes.c_void_p), u32p]
+    lib.Eep_GetSparseBackend.restype = ctypes.c_void_p
+    lib.Eep_Destroy.restype = None
+    return lib
+
+
+def _view(address: int, length: int, ctype) -> memoryview:
+    """C内存上的只读memoryview (不拷贝)"""
+    view = memoryview((ctype * length).from_address(address)).cast('B')
+    return (view if ctype is ctypes.c_uint8 else view.cast('I')).toreadonly()
+
+
+class EepEngine:
+    """C驱动 (Eep_*) 的薄封装"""
+
+    def __init__(self, capacity: int = 4096, page_size: int = 256, block_size: int = 1024,
+                 backend: str = 'flat', image_path: Optional[str] = None,
+                 lib_dir: Optional[str] = None):
+        self.lib = _load(lib_dir or default_lib_dir())
+        self._image_path = image_path.encode() if image_path else None
+        cfg = EepConfig(capacity_bytes=capacity, page_size=page_size, block_size=block_size,
+                        read_delay_us=50, write_delay_ms=2, erase_delay_ms=3,
+                        endurance_cycles=100000, image_path=self._image_path,
+                        capabilities=EEP_CAP_BIT_CLEAR)
+        if backend == 'sparse':
+            cfg.backend = self.lib.Eep_GetSparseBackend()
+        elif backend != 'flat':
+            raise EngineError(f'未知后端: {backend}')
+
+        self.lib.Eep_Destroy()
+        if self.lib.Eep_Init(ctypes.byref(cfg)) != E_OK:
+            raise EngineError('Eep_Init 失败')
+        self.capacity = capacity
+        self.page_size = page_size
+        self.block_size = block_size
+
+    # --- 设备操作 (真实驱动路径) ---
+
+    def read(self, address: int, length: int) -> bytes:
+        buf = ctypes.create_string_buffer(length)
+        if self.lib.Eep_Read(address, buf, length) != E_OK:
+            raise EngineError(f'Eep_Read 0x{address:X}+{length} 失败')
+        return buf.raw
+
+    def write(self, address: int, data: bytes) -> bool:
+        return self.lib.Eep_Write(address, data, len(data)) == E_OK
+
+    def erase(self, address: int) -> bool:
+        return self.lib.Eep_Erase(address) == E_OK
+
+    def set_program_mode(self, mode: int) -> bool:
+        return self.lib.Eep_SetProgramMode(mode) == E_OK
+
+    def diagnostics(self) -> dict:
+        diag = EepDiag()
+        self.lib.Eep_GetDiagnostics(ctypes.byref(diag))
+        return {name: getattr(diag, name) for name, _ in EepDiag._fields_}
+
+    # --- 零拷贝视图 ---
+
+    def storage_runs(self, address: int = 0, length: Optional[int] = None
+                     ) -> Iterator[Tuple[int, int, Optional[memoryview]]]:
+        """按连续段遍历镜像: (地址, 长度, memoryview 或 None=读作0xFF)"""
+        end = self.capacity if length is None else address + length
+        ptr, run = ctypes.c_void_p(), ctypes.c_uint32()
+        while address < end:
+            run.value = end - address
+            if self.lib.Eep_GetStorageView(address, ctypes.byref(ptr), ctypes.byref(run)) != E_OK:
+                raise EngineError(f'Eep_GetStorageView 0x{address:X} 失败')
+            yield address, run.value, (_view(ptr.value, run.value, ctypes.c_uint8) if ptr.value else None)
+            address += run.value
+
+    def storage(self, address: int = 0, length: Optional[int] = None) -> memoryview:
+        """单段镜像视图 (flat/mmap 后端整个镜像为一段; 随写入实时变化)"""
+        length = self.capacity - address if length is None else length
+        start, run, view = next(self.storage_runs(address, length))
+        if run != length or view is None:
+            raise EngineError('该范围不是一段连续内存 (稀疏后端请用 storage_runs)')
+        return view
+
+    def erase_count_runs(self) -> Iterator[Tuple[int, int, Optional[memoryview]]]:
+        """按连续段遍历擦写计数: (首块号, 块数, memoryview 或 None=全为0)"""
+        blocks = self.capacity // self.block_size
+        index = 0
+        ptr, run = ctypes.c_void_p(), ctypes.c_uint32()
+        while index < blocks:
+            if self.lib.Eep_GetEraseCountView(index, ctypes.byref(ptr), ctypes.byref(run)) != E_OK:
+                raise EngineError(f'Eep_GetEraseCountView {index} 失败')
+            yield index, run.value, (_view(ptr.value, run.value, ctypes.c_uint32) if ptr.value else None)
+            index += run.value
+
+    def erase_counts(self) -> List[int]:
+        counts = []
+        for _, run, view in self.erase_count_runs():
+            counts.extend(view.tolist() if view is not None else [0] * run)
+        return counts
+
+    def close(self):
+        self.lib.Eep_Destroy()
+
+
+class EnginePage:
+    """EEPROMPage 的引擎版: data 为镜像上的实时视图"""
+
+    def __init__(self, chip: 'EngineChip', page_id: int):
+        self._chip = chip
+        self.page_id = page_id
+        self.address = page_id * chip.page_size
+
+    @property
+    def data(self) -> memoryview:
+        return self._chip.engine.storage(self.address, self._chip.page_size)
+
+    @property
+    def erase_count(self) -> int:
+        return self._chip.erase_count(self.page_id)
+
+    @property
+    def is_erased(self) -> bool:
+        return self.data == self._chip.blank_page
+
+
+class EngineChip:
+    """与 EEPROMChip 接口相同, 由C驱动承载 (擦除单元=一个Page)"""
+
+    def __init__(self, size_kb: int = 4, page_size: int = 256, lib_dir: Optional[str] = None):
+        self.size_kb = size_kb
+        self.page_size = page_size
+        self.num_pages = size_kb * 1024 // page_size
+        self.engine = EepEngine(capacity=size_kb * 1024, page_size=page_size,
+                                block_size=page_size, lib_dir=lib_dir)
+        # 部分写入: 只需1→0的页原地编程, 与EEPROMPage.write语义一致
+        self.engine.set_program_mode(EEP_PROGRAM_BIT_CLEAR)
+        self.blank_page = b'\xFF' * page_size
+        self.pages = [EnginePage(self, i) for i in range(self.num_pages)]
+
+    def erase_count(self, page_id: int) -> int:
+        for first, run, view in self.engine.erase_count_runs():
+            if page_id < first + run:
+                return view[page_id - first] if view is not None else 0
+        return 0
+
+    def read(self, address: int, length: int) -> bytes:
+        return self.engine.read(address, length)
+
+    def write(self, address: int, data: bytes) -> Tuple[bool, str]:
+        """页内写入, 返回(成功, 错误信息)"""
+        page_id = address // self.page_size
+        offset = address % self.page_size
+        image = bytearray(self.pages[page_id].data)
+        image[offset:offset + len(data)] = data
+        if not self.engine.write(page_id * self.page_size, bytes(image)):
+            return False, f"Page {page_id} 需要先擦除才能写入"
+        return True, "写入成功"
+
+    def erase_page(self, page_id: int):
+        self.engine.erase(page_id * self.page_size)
+
+    def get_page_info(self, page_id: int) -> dict:
+        page = self.pages[page_id]
+        erase_count = page.erase_count
+        life_percent = max(0, 100 - (erase_count / 100000 * 100))
+        return {
+            'page_id': page_id,
+            'address': f'0x{page.address:04X}',
+            'state': '已擦除' if page.is_erased else '已写入',
+            'erase_count': erase_count,
+            'life_percent': round(life_percent, 1),
+            'data_hex': page.data.hex().upper(),
+        }
+
+    def get_all_pages_info(self) -> List[dict]:
+        return [self.get_page_info(i) for i in range(self.num_pages)]